@@ -19,6 +19,9 @@
 // timeout
 #define TB_DEMO_TIMEOUT  (-1)
 
+// the bench rounds: zero-copy and copy
+#define TB_DEMO_BENCH_ROUNDS    (2)
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * globals
  */
@@ -26,15 +29,108 @@
 // the file path
 static tb_char_t    g_filepath[TB_PATH_MAXN];
 
+// is bench mode?
+static tb_bool_t    g_bench = tb_false;
+
+// use zero-copy transfer for bench?
+static tb_bool_t    g_zcopy = tb_false;
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * implementation
  */
+static tb_hong_t tb_demo_stream_copy(tb_stream_ref_t istream, tb_stream_ref_t ostream)
+{
+    // copy it with the user buffer
+    tb_byte_t data[TB_STREAM_BLOCK_MAXN];
+    tb_hize_t save = 0;
+    while (1)
+    {
+        tb_long_t real = tb_stream_read(istream, data, sizeof(data));
+        if (real > 0)
+        {
+            if (!tb_stream_bwrit(ostream, data, real)) break;
+            save += real;
+        }
+        else if (!real)
+        {
+            tb_long_t wait = tb_stream_wait(istream, TB_STREAM_WAIT_READ, TB_DEMO_TIMEOUT);
+            tb_check_break(wait > 0);
+        }
+        else break;
+    }
+    return tb_stream_sync(ostream, tb_true)? save : -1;
+}
+static tb_hong_t tb_demo_stream_transfer(tb_stream_ref_t istream, tb_stream_ref_t ostream)
+{
+    // open streams
+    if (!tb_stream_open(istream) || !tb_stream_open(ostream)) return -1;
+
+    // transfer it, it will use sendfile or splice for file => sock, sock => file
+    return g_zcopy? tb_transfer(istream, ostream, 0, tb_null, tb_null) : tb_demo_stream_copy(istream, ostream);
+}
+static tb_void_t tb_demo_coroutine_bench_send(tb_socket_ref_t sock)
+{
+    // init streams
+    tb_stream_ref_t istream = tb_stream_init_from_file(g_filepath, TB_FILE_MODE_RO);
+    tb_stream_ref_t ostream = tb_stream_init_from_sock_ref(sock, TB_SOCKET_TYPE_TCP, tb_false);
+
+    // send file
+    tb_hong_t send = (istream && ostream)? tb_demo_stream_transfer(istream, ostream) : -1;
+
+    // trace
+    tb_trace_i("[%p]: send: %lld bytes", sock, send);
+
+    // exit streams
+    if (istream) tb_stream_exit(istream);
+    if (ostream) tb_stream_exit(ostream);
+}
+static tb_void_t tb_demo_coroutine_bench_recv(tb_cpointer_t priv)
+{
+    // the output file path
+    tb_char_t path[TB_PATH_MAXN];
+    tb_size_t size = tb_directory_temporary(path, sizeof(path));
+    tb_assert_and_check_return(size && size < sizeof(path));
+    tb_strlcpy(path + size, "/file_server.bench", sizeof(path) - size);
+
+    // recv file with zero-copy and copy
+    tb_size_t i = 0;
+    for (i = 0; i < TB_DEMO_BENCH_ROUNDS; i++)
+    {
+        // init streams
+        g_zcopy = !i;
+        tb_stream_ref_t istream = tb_stream_init_from_sock("127.0.0.1", TB_DEMO_PORT, TB_SOCKET_TYPE_TCP, tb_false);
+        tb_stream_ref_t ostream = tb_stream_init_from_file(path, TB_FILE_MODE_RW | TB_FILE_MODE_CREAT | TB_FILE_MODE_TRUNC);
+
+        // recv file
+        tb_hong_t time = tb_mclock();
+        tb_hong_t recv = (istream && ostream)? tb_demo_stream_transfer(istream, ostream) : -1;
+        time = tb_mclock() - time;
+
+        // trace
+        tb_trace_i("%s: recv: %lld bytes %lld ms, %lld MB/s", g_zcopy? "zcopy" : "copy", recv, time, (recv > 0 && time > 0)? (recv * 1000 / time) >> 20 : 0);
+
+        // exit streams
+        if (istream) tb_stream_exit(istream);
+        if (ostream) tb_stream_exit(ostream);
+    }
+
+    // remove the output file
+    tb_file_remove(path);
+}
 static tb_void_t tb_demo_coroutine_client(tb_cpointer_t priv)
 {
     // check
     tb_socket_ref_t sock = (tb_socket_ref_t)priv;
     tb_assert_and_check_return(sock);
 
+    // bench it with streams
+    if (g_bench)
+    {
+        tb_demo_coroutine_bench_send(sock);
+        tb_socket_exit(sock);
+        return ;
+    }
+
     // trace
     tb_trace_d("[%p]: sending %s ..", sock, g_filepath);
 
@@ -112,6 +208,9 @@ static tb_void_t tb_demo_coroutine_listen(tb_cpointer_t priv)
             {
                 if (!tb_coroutine_start(tb_null, tb_demo_coroutine_client, client, 0)) break;
                 count++;
+
+                // all bench clients have been accepted?
+                if (g_bench && count == TB_DEMO_BENCH_ROUNDS) break;
             }
             else if (tb_socket_wait(sock, TB_SOCKET_EVENT_ACPT, -1) <= 0) break;
         }
@@ -131,8 +230,8 @@ static tb_void_t tb_demo_coroutine_listen(tb_cpointer_t priv)
  */
 tb_int_t tb_demo_coroutine_file_server_main(tb_int_t argc, tb_char_t** argv)
 {
-    // check
-    tb_assert_and_check_return_val(argc == 2 && argv[1], -1);
+    // check, file_server file [bench]
+    tb_assert_and_check_return_val(argc >= 2 && argv[1], -1);
 
     // the file path
     tb_char_t const* filepath = argv[1];
@@ -141,6 +240,9 @@ tb_int_t tb_demo_coroutine_file_server_main(tb_int_t argc, tb_char_t** argv)
     // save the file path
     tb_strlcpy(g_filepath, filepath, sizeof(g_filepath));
 
+    // bench the zero-copy transfer? it receives the file from itself
+    g_bench = (argc > 2 && !tb_strcmp(argv[2], "bench"))? tb_true : tb_false;
+
     // init scheduler
     tb_co_scheduler_ref_t scheduler = tb_co_scheduler_init();
     if (scheduler)
@@ -148,6 +250,9 @@ tb_int_t tb_demo_coroutine_file_server_main(tb_int_t argc, tb_char_t** argv)
         // start listening
         tb_coroutine_start(scheduler, tb_demo_coroutine_listen, tb_null, 0);
 
+        // start receiving for bench
+        if (g_bench) tb_coroutine_start(scheduler, tb_demo_coroutine_bench_recv, tb_null, 0);
+
         // run scheduler
         tb_co_scheduler_loop(scheduler, tb_true);
 
@@ -44,6 +44,9 @@ typedef struct __tb_demo_http_session_t
     // the file
     tb_file_ref_t   file;
 
+    // the response chain
+    tb_buffer_chain_ref_t chain;
+
     // the data buffer
     tb_byte_t       data[8192];
 
@@ -89,6 +92,10 @@ static tb_bool_t tb_demo_http_session_init(tb_demo_http_session_ref_t session, t
     session->method         = TB_HTTP_METHOD_GET;
     session->content_size   = 0;
 
+    // init the response chain
+    session->chain          = tb_buffer_chain_init();
+    tb_assert_and_check_return_val(session->chain, tb_false);
+
     // ok
     return tb_true;
 }
@@ -104,24 +111,29 @@ static tb_void_t tb_demo_http_session_exit(tb_demo_http_session_ref_t session)
     // exit file
     if (session->file) tb_file_exit(session->file);
     session->file = tb_null;
+
+    // exit the response chain
+    if (session->chain) tb_buffer_chain_exit(session->chain);
+    session->chain = tb_null;
 }
-static tb_bool_t tb_demo_http_session_data_send(tb_socket_ref_t sock, tb_byte_t* data, tb_size_t size)
+static tb_bool_t tb_demo_http_session_chain_send(tb_socket_ref_t sock, tb_buffer_chain_ref_t chain)
 {
     // check
-    tb_assert_and_check_return_val(sock && data && size, tb_false);
+    tb_assert_and_check_return_val(sock && chain, tb_false);
 
-    // send data
-    tb_size_t send = 0;
-    tb_long_t wait = 0;
-    while (send < size)
+    // send all slices by sendv
+    tb_iovec_t list[8];
+    tb_long_t  wait = 0;
+    while (tb_buffer_chain_size(chain))
     {
         // send it
-        tb_long_t real = tb_socket_send(sock, data + send, size - send);
+        tb_size_t count = tb_buffer_chain_peek(chain, list, tb_arrayn(list));
+        tb_long_t real = tb_socket_sendv(sock, list, count);
 
         // has data?
         if (real > 0)
         {
-            send += real;
+            tb_buffer_chain_skip(chain, real);
             wait = 0;
         }
         // no data? wait it
@@ -136,7 +148,7 @@ static tb_bool_t tb_demo_http_session_data_send(tb_socket_ref_t sock, tb_byte_t*
     }
 
     // ok?
-    return send == size;
+    return !tb_buffer_chain_size(chain);
 }
 static tb_bool_t tb_demo_http_session_file_send(tb_socket_ref_t sock, tb_file_ref_t file)
 {
@@ -199,6 +211,7 @@ static tb_bool_t tb_demo_http_session_resp_send(tb_demo_http_session_ref_t sessi
     tb_assert_and_check_return_val(session && session->sock, tb_false);
 
     // make the response header
+    tb_size_t body = cstr? tb_strlen(cstr) : 0;
     tb_long_t size = tb_snprintf(   (tb_char_t*)session->data
                                 ,   sizeof(session->data)
                                 ,   "HTTP/1.1 %lu %s\r\n"
@@ -207,20 +220,21 @@ static tb_bool_t tb_demo_http_session_resp_send(tb_demo_http_session_ref_t sessi
                                     "Content-Length: %llu\r\n"
                                     "Connection: %s\r\n"
                                     "\r\n"
-                                    "%s"
                                 ,   session->code
                                 ,   tb_demo_http_session_code_cstr(session->code)
                                 ,   TB_VERSION_SHORT_STRING
-                                ,   session->file? tb_file_size(session->file) : (cstr? tb_strlen(cstr) : 0)
-                                ,   session->keep_alive? "keep-alive" : "close"
-                                ,   cstr? cstr : "");
+                                ,   session->file? tb_file_size(session->file) : (tb_hize_t)body
+                                ,   session->keep_alive? "keep-alive" : "close");
     tb_assert_and_check_return_val(size > 0, tb_false);
 
     // end
     session->data[size] = 0;
 
-    // send the response header
-    if (!tb_demo_http_session_data_send(session->sock, session->data, size)) return tb_false;
+    // send the response header and body by one call without copying them
+    tb_buffer_chain_clear(session->chain);
+    tb_buffer_chain_append(session->chain, session->data, size);
+    if (body) tb_buffer_chain_append(session->chain, (tb_byte_t const*)cstr, body);
+    if (!tb_demo_http_session_chain_send(session->sock, session->chain)) return tb_false;
 
     // send the response file if exists
     if (session->file && !tb_demo_http_session_file_send(session->sock, session->file)) return tb_false;
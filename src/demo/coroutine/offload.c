@@ -0,0 +1,158 @@
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * trace
+ */
+#define TB_TRACE_MODULE_NAME            "offload"
+#define TB_TRACE_MODULE_DEBUG           (1)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "../demo.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the readers count
+#define TB_DEMO_READER_COUNT    (16)
+
+// the read block size
+#define TB_DEMO_BLOCK_SIZE      (256 * 1024)
+
+// the ping count
+#define TB_DEMO_PING_COUNT      (1000)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * globals
+ */
+
+// the file path
+static tb_char_t    g_filepath[TB_PATH_MAXN];
+
+// use the blocking file io directly?
+static tb_bool_t    g_blocking = tb_false;
+
+// the read bytes
+static tb_hize_t    g_readed = 0;
+
+// the alive readers count
+static tb_size_t    g_readers = 0;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+static tb_void_t tb_demo_coroutine_reader(tb_cpointer_t priv)
+{
+    // init file
+    tb_file_ref_t file = tb_file_init(g_filepath, TB_FILE_MODE_RO);
+    tb_assert_and_check_return(file);
+
+    // read the whole file with the disk reads
+    tb_byte_t*  data = tb_malloc_bytes(TB_DEMO_BLOCK_SIZE);
+    tb_hize_t   size = tb_file_size(file);
+    tb_hize_t   offset = 0;
+    while (data && offset < size)
+    {
+        tb_long_t real = g_blocking? tb_file_pread(file, data, TB_DEMO_BLOCK_SIZE, offset) : tb_co_file_pread(file, data, TB_DEMO_BLOCK_SIZE, offset);
+        tb_check_break(real > 0);
+
+        offset += real;
+        g_readed += real;
+    }
+
+    // exit data
+    if (data) tb_free(data);
+
+    // exit file
+    tb_file_exit(file);
+    g_readers--;
+}
+static tb_void_t tb_demo_coroutine_echo(tb_cpointer_t priv)
+{
+    // echo the ping data with the socket io
+    tb_socket_ref_t sock = (tb_socket_ref_t)priv;
+    tb_byte_t       data = 0;
+    while (tb_socket_brecv(sock, &data, 1))
+    {
+        if (!tb_socket_bsend(sock, &data, 1)) break;
+    }
+}
+static tb_void_t tb_demo_coroutine_ping(tb_cpointer_t priv)
+{
+    // ping it with the socket io and compute the latency of the scheduler
+    tb_socket_ref_t sock = (tb_socket_ref_t)priv;
+    tb_byte_t       data = 'p';
+    tb_size_t       count = 0;
+    tb_hong_t       total = 0;
+    tb_hong_t       maxt = 0;
+    while (count < TB_DEMO_PING_COUNT && g_readers)
+    {
+        tb_hong_t time = tb_uclock();
+        if (!tb_socket_bsend(sock, &data, 1) || !tb_socket_brecv(sock, &data, 1)) break;
+        time = tb_uclock() - time;
+
+        total += time;
+        if (time > maxt) maxt = time;
+        count++;
+
+        // wait some time
+        tb_msleep(1);
+    }
+
+    // trace
+    tb_trace_i("ping: %lu, average: %lld us, max: %lld us", count, count? total / count : 0, maxt);
+
+    // exit socket
+    tb_socket_exit(sock);
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */
+tb_int_t tb_demo_coroutine_offload_main(tb_int_t argc, tb_char_t** argv)
+{
+    // check
+    tb_assert_and_check_return_val(argc >= 2 && argv[1], -1);
+
+    // save the file path
+    tb_strlcpy(g_filepath, argv[1], sizeof(g_filepath));
+
+    // use the blocking file io? e.g. demo coroutine_offload file --blocking
+    g_blocking = argc > 2 && !tb_strcmp(argv[2], "--blocking");
+
+    // init socket pair
+    tb_socket_ref_t pair[2] = {tb_null, tb_null};
+    if (!tb_socket_pair(TB_SOCKET_TYPE_TCP, pair)) return -1;
+
+    // init scheduler
+    tb_co_scheduler_ref_t scheduler = tb_co_scheduler_init();
+    if (scheduler)
+    {
+        // start readers
+        tb_size_t i = 0;
+        for (i = 0; i < TB_DEMO_READER_COUNT; i++)
+        {
+            if (tb_coroutine_start(scheduler, tb_demo_coroutine_reader, tb_null, 0))
+                g_readers++;
+        }
+
+        // start ping and echo
+        tb_coroutine_start(scheduler, tb_demo_coroutine_echo, pair[1], 0);
+        tb_coroutine_start(scheduler, tb_demo_coroutine_ping, pair[0], 0);
+
+        // run scheduler
+        tb_hong_t time = tb_mclock();
+        tb_co_scheduler_loop(scheduler, tb_true);
+        time = tb_mclock() - time;
+
+        // trace
+        tb_trace_i("%s: read %llu bytes, %lld ms, %llu MB/s", g_blocking? "blocking" : "offload", g_readed, time, time? (g_readed * 1000 / time) >> 20 : 0);
+
+        // exit scheduler
+        tb_co_scheduler_exit(scheduler);
+    }
+
+    // exit socket
+    if (pair[1]) tb_socket_exit(pair[1]);
+    return 0;
+}
@@ -0,0 +1,99 @@
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "../demo.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * globals
+ */
+
+// the shared value
+static tb_size_t    g_value = 0;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+static tb_void_t tb_demo_coroutine_rwlock_reader(tb_cpointer_t priv)
+{
+    // check
+    tb_co_rwlock_ref_t lock = (tb_co_rwlock_ref_t)priv;
+    tb_assert_and_check_return(lock);
+
+    // loop
+    tb_size_t count = 5;
+    while (count--)
+    {
+        // enter lock for reading, all readers can enter it at the same time
+        tb_co_rwlock_enter_read(lock);
+
+        // trace
+        tb_trace_i("[coroutine: %p]: read: %lu", tb_coroutine_self(), g_value);
+
+        // wait some time
+        tb_msleep(200);
+
+        // leave lock
+        tb_co_rwlock_leave_read(lock);
+
+        // wait some time
+        tb_msleep(100);
+    }
+}
+static tb_void_t tb_demo_coroutine_rwlock_writer(tb_cpointer_t priv)
+{
+    // check
+    tb_co_rwlock_ref_t lock = (tb_co_rwlock_ref_t)priv;
+    tb_assert_and_check_return(lock);
+
+    // loop
+    tb_size_t count = 3;
+    while (count--)
+    {
+        // enter lock for writing, it will wait all current readers
+        tb_co_rwlock_enter_write(lock);
+
+        // trace
+        tb_trace_i("[coroutine: %p]: write: %lu => %lu", tb_coroutine_self(), g_value, g_value + 1);
+
+        // wait some time
+        g_value++;
+        tb_msleep(300);
+
+        // leave lock
+        tb_co_rwlock_leave_write(lock);
+
+        // wait some time
+        tb_msleep(400);
+    }
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */
+tb_int_t tb_demo_coroutine_rwlock_main(tb_int_t argc, tb_char_t** argv)
+{
+    // init scheduler
+    tb_co_scheduler_ref_t scheduler = tb_co_scheduler_init();
+    if (scheduler)
+    {
+        // init lock
+        tb_co_rwlock_ref_t lock = tb_co_rwlock_init();
+        tb_assert(lock);
+
+        // start coroutines
+        tb_coroutine_start(scheduler, tb_demo_coroutine_rwlock_reader, lock, 0);
+        tb_coroutine_start(scheduler, tb_demo_coroutine_rwlock_reader, lock, 0);
+        tb_coroutine_start(scheduler, tb_demo_coroutine_rwlock_reader, lock, 0);
+        tb_coroutine_start(scheduler, tb_demo_coroutine_rwlock_writer, lock, 0);
+
+        // run scheduler
+        tb_co_scheduler_loop(scheduler, tb_true);
+
+        // exit lock
+        tb_co_rwlock_exit(lock);
+
+        // exit scheduler
+        tb_co_scheduler_exit(scheduler);
+    }
+    return 0;
+}
@@ -0,0 +1,221 @@
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "../demo.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the pass count
+#define COUNT       (1000000)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * globals
+ */
+
+// the socket pair
+static tb_socket_ref_t  g_pair[2] = {tb_null, tb_null};
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+static tb_void_t tb_demo_coroutine_select_test_send(tb_cpointer_t priv)
+{
+    // check
+    tb_co_channel_ref_t channel = (tb_co_channel_ref_t)priv;
+
+    // send data with some delays
+    tb_size_t count = 10;
+    while (count--)
+    {
+        tb_msleep(10);
+        tb_co_channel_send(channel, (tb_cpointer_t)(count + 1));
+    }
+
+    // send end
+    tb_co_channel_send(channel, tb_null);
+}
+static tb_void_t tb_demo_coroutine_select_test_writ(tb_cpointer_t priv)
+{
+    // write data to socket with some delays
+    tb_byte_t data = 'a';
+    tb_size_t count = 5;
+    while (count--)
+    {
+        tb_msleep(30);
+        if (!tb_socket_bsend(g_pair[1], &data, 1)) break;
+        data++;
+    }
+}
+static tb_void_t tb_demo_coroutine_select_test_recv(tb_cpointer_t priv)
+{
+    // check
+    tb_co_channel_ref_t channel = (tb_co_channel_ref_t)priv;
+
+    // select channel, socket and timeout
+    tb_bool_t           end = tb_false;
+    tb_size_t           timeout = 0;
+    tb_co_select_case_t cases[3];
+    while (timeout < 3)
+    {
+        // init cases
+        tb_size_t count = 0;
+        if (!end) tb_co_select_case_recv(&cases[count++], channel);
+        tb_co_select_case_wait_sock(&cases[count++], g_pair[0], TB_POLLER_EVENT_RECV);
+        tb_co_select_case_timeout(&cases[count++], 50);
+
+        // select it
+        tb_long_t ready = tb_co_select(cases, count);
+        tb_assert_and_check_break(ready >= 0);
+
+        // done it
+        tb_co_select_case_ref_t item = &cases[ready];
+        switch (item->type)
+        {
+        case TB_CO_SELECT_CASE_RECV:
+            {
+                // trace
+                tb_trace_i("[coroutine: %p]: recv: %lu", tb_coroutine_self(), (tb_size_t)item->data);
+                if (!item->data) end = tb_true;
+                timeout = 0;
+            }
+            break;
+        case TB_CO_SELECT_CASE_WAIT:
+            {
+                // read data
+                tb_byte_t data[16];
+                tb_long_t real = tb_socket_recv(g_pair[0], data, sizeof(data));
+
+                // trace
+                tb_trace_i("[coroutine: %p]: read: %ld bytes, events: %lu", tb_coroutine_self(), real, item->events);
+                timeout = 0;
+            }
+            break;
+        case TB_CO_SELECT_CASE_TIMEOUT:
+            {
+                // trace
+                tb_trace_i("[coroutine: %p]: timeout", tb_coroutine_self());
+                timeout++;
+            }
+            break;
+        default:
+            break;
+        }
+    }
+}
+static tb_void_t tb_demo_coroutine_select_test(tb_size_t size)
+{
+    // trace
+    tb_trace_i("test: %lu", size);
+
+    // init scheduler
+    tb_co_scheduler_ref_t scheduler = tb_co_scheduler_init();
+    if (scheduler)
+    {
+        // init channel
+        tb_co_channel_ref_t channel = tb_co_channel_init(size, tb_null, 0);
+        tb_assert(channel);
+
+        // start coroutines
+        tb_coroutine_start(scheduler, tb_demo_coroutine_select_test_send, channel, 0);
+        tb_coroutine_start(scheduler, tb_demo_coroutine_select_test_writ, tb_null, 0);
+        tb_coroutine_start(scheduler, tb_demo_coroutine_select_test_recv, channel, 0);
+
+        // run scheduler
+        tb_co_scheduler_loop(scheduler, tb_true);
+
+        // exit channel
+        tb_co_channel_exit(channel);
+
+        // exit scheduler
+        tb_co_scheduler_exit(scheduler);
+    }
+}
+static tb_void_t tb_demo_coroutine_select_perf_send(tb_cpointer_t priv)
+{
+    // check
+    tb_co_channel_ref_t channel = (tb_co_channel_ref_t)priv;
+
+    // loop
+    tb_size_t count = COUNT;
+    while (count--) tb_co_channel_send(channel, (tb_cpointer_t)count);
+}
+static tb_void_t tb_demo_coroutine_select_perf_recv(tb_cpointer_t priv)
+{
+    // check
+    tb_co_channel_ref_t* channels = (tb_co_channel_ref_t*)priv;
+
+    // select two channels
+    tb_size_t           count = COUNT << 1;
+    tb_co_select_case_t cases[2];
+    while (count--)
+    {
+        tb_co_select_case_recv(&cases[0], channels[0]);
+        tb_co_select_case_recv(&cases[1], channels[1]);
+        if (tb_co_select(cases, 2) < 0) break;
+    }
+}
+static tb_void_t tb_demo_coroutine_select_perf(tb_size_t size)
+{
+    // trace
+    tb_trace_i("perf: %lu", size);
+
+    // init scheduler
+    tb_co_scheduler_ref_t scheduler = tb_co_scheduler_init();
+    if (scheduler)
+    {
+        // init channels
+        tb_co_channel_ref_t channels[2];
+        channels[0] = tb_co_channel_init(size, tb_null, 0);
+        channels[1] = tb_co_channel_init(size, tb_null, 0);
+        tb_assert(channels[0] && channels[1]);
+
+        // start coroutine
+        tb_coroutine_start(scheduler, tb_demo_coroutine_select_perf_send, channels[0], 0);
+        tb_coroutine_start(scheduler, tb_demo_coroutine_select_perf_send, channels[1], 0);
+        tb_coroutine_start(scheduler, tb_demo_coroutine_select_perf_recv, channels, 0);
+
+        // init the start time
+        tb_hong_t startime = tb_mclock();
+
+        // run scheduler
+        tb_co_scheduler_loop(scheduler, tb_true);
+
+        // computing time
+        tb_hong_t duration = tb_mclock() - startime;
+
+        // exit channels
+        tb_co_channel_exit(channels[0]);
+        tb_co_channel_exit(channels[1]);
+
+        // trace
+        tb_trace_i("%d passes in %lld ms, %lld passes per second", COUNT << 1, duration, (((tb_hong_t)1000 * (COUNT << 1)) / (duration + 1)));
+
+        // exit scheduler
+        tb_co_scheduler_exit(scheduler);
+    }
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */
+tb_int_t tb_demo_coroutine_select_main(tb_int_t argc, tb_char_t** argv)
+{
+    // init socket pair
+    if (!tb_socket_pair(TB_SOCKET_TYPE_TCP, g_pair)) return -1;
+
+    // test
+    tb_demo_coroutine_select_test(0);
+    tb_demo_coroutine_select_test(5);
+
+    // perf
+    tb_demo_coroutine_select_perf(0);
+    tb_demo_coroutine_select_perf(1);
+    tb_demo_coroutine_select_perf(10);
+
+    // exit socket pair
+    tb_socket_exit(g_pair[0]);
+    tb_socket_exit(g_pair[1]);
+    return 0;
+}
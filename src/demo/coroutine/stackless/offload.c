@@ -0,0 +1,152 @@
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "../../demo.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the read block size
+#define TB_DEMO_LO_OFFLOAD_BLOCK        (1 << 16)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the offload local type
+typedef struct __tb_demo_lo_offload_t
+{
+    // the file
+    tb_file_ref_t   file;
+
+    // the offset
+    tb_hize_t       offset;
+
+    // the read size
+    tb_hize_t       read;
+
+    // the time
+    tb_hong_t       time;
+
+    // the running readers
+    tb_size_t*      running;
+
+    // the data
+    tb_byte_t       data[TB_DEMO_LO_OFFLOAD_BLOCK];
+
+}tb_demo_lo_offload_t, *tb_demo_lo_offload_ref_t;
+
+// the ticker local type
+typedef struct __tb_demo_lo_ticker_t
+{
+    // the ticks
+    tb_size_t       ticks;
+
+    // the running readers
+    tb_size_t*      running;
+
+}tb_demo_lo_ticker_t, *tb_demo_lo_ticker_ref_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+static tb_long_t tb_demo_lo_offload_read(tb_cpointer_t priv)
+{
+    // read the next block in the helper thread
+    tb_demo_lo_offload_ref_t local = (tb_demo_lo_offload_ref_t)priv;
+    return tb_file_pread(local->file, local->data, sizeof(local->data), local->offset);
+}
+static tb_void_t tb_demo_lo_coroutine_offload_func(tb_lo_coroutine_ref_t coroutine, tb_cpointer_t priv)
+{
+    // the local
+    tb_demo_lo_offload_ref_t local = (tb_demo_lo_offload_ref_t)priv;
+
+    // enter coroutine
+    tb_lo_coroutine_enter(coroutine)
+    {
+        // read the whole file without blocking the scheduler thread
+        local->time = tb_mclock();
+        while (1)
+        {
+            // read it in the helper thread pool
+            tb_lo_coroutine_wait_task(tb_demo_lo_offload_read, local);
+            tb_check_break(tb_lo_coroutine_task_result() > 0);
+
+            // update the offset
+            local->offset += tb_lo_coroutine_task_result();
+            local->read += tb_lo_coroutine_task_result();
+        }
+
+        // trace
+        tb_trace_i("[coroutine: %p]: read: %llu bytes, %lld ms", coroutine, local->read, tb_mclock() - local->time);
+        (*local->running)--;
+    }
+}
+static tb_void_t tb_demo_lo_coroutine_ticker_func(tb_lo_coroutine_ref_t coroutine, tb_cpointer_t priv)
+{
+    // the local
+    tb_demo_lo_ticker_ref_t local = (tb_demo_lo_ticker_ref_t)priv;
+
+    // enter coroutine
+    tb_lo_coroutine_enter(coroutine)
+    {
+        // the scheduler is still running other coroutines when the files are being read
+        while (*local->running)
+        {
+            tb_lo_coroutine_sleep(1);
+            local->ticks++;
+        }
+
+        // trace
+        tb_trace_i("[ticker]: %lu ticks", local->ticks);
+    }
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */
+tb_int_t tb_demo_lo_coroutine_offload_main(tb_int_t argc, tb_char_t** argv)
+{
+    // check
+    tb_assert_and_check_return_val(argc == 2, -1);
+
+    // init scheduler
+    tb_lo_scheduler_ref_t scheduler = tb_lo_scheduler_init();
+    if (scheduler)
+    {
+        // start readers
+        tb_size_t                   i = 0;
+        tb_size_t                   running = 4;
+        tb_demo_lo_offload_ref_t    readers[4] = {tb_null};
+        for (i = 0; i < tb_arrayn(readers); i++)
+        {
+            readers[i] = tb_malloc0_type(tb_demo_lo_offload_t);
+            if (readers[i])
+            {
+                readers[i]->file    = tb_file_init(argv[1], TB_FILE_MODE_RO);
+                readers[i]->running = &running;
+            }
+            if (readers[i] && readers[i]->file) tb_lo_coroutine_start(scheduler, tb_demo_lo_coroutine_offload_func, readers[i], tb_null);
+            else running--;
+        }
+
+        // start ticker
+        tb_demo_lo_ticker_t ticker = {0, &running};
+        tb_lo_coroutine_start(scheduler, tb_demo_lo_coroutine_ticker_func, &ticker, tb_null);
+
+        // run scheduler
+        tb_lo_scheduler_loop(scheduler, tb_true);
+
+        // exit scheduler
+        tb_lo_scheduler_exit(scheduler);
+
+        // exit readers
+        for (i = 0; i < tb_arrayn(readers); i++)
+        {
+            if (readers[i] && readers[i]->file) tb_file_exit(readers[i]->file);
+            if (readers[i]) tb_free(readers[i]);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,78 @@
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "../demo.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+static tb_void_t tb_demo_coroutine_trace_yield(tb_cpointer_t priv)
+{
+    // yield some times
+    tb_size_t count = (tb_size_t)priv;
+    while (count--) tb_coroutine_yield();
+}
+static tb_void_t tb_demo_coroutine_trace_sleep(tb_cpointer_t priv)
+{
+    // sleep some times
+    tb_size_t count = (tb_size_t)priv;
+    while (count--) tb_msleep(10);
+}
+static tb_void_t tb_demo_coroutine_trace_busy(tb_cpointer_t priv)
+{
+    // run too long without yielding, we can find it from the trace
+    tb_size_t count = (tb_size_t)priv;
+    while (count--)
+    {
+        tb_hong_t time = tb_mclock();
+        while (tb_mclock() < time + 20) ;
+        tb_msleep(10);
+    }
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */
+tb_int_t tb_demo_coroutine_trace_main(tb_int_t argc, tb_char_t** argv)
+{
+    // init scheduler
+    tb_co_scheduler_ref_t scheduler = tb_co_scheduler_init();
+    if (scheduler)
+    {
+        // enable the switch trace
+        tb_co_scheduler_trace(scheduler, 4096);
+
+        // start coroutines
+        tb_coroutine_start(scheduler, tb_demo_coroutine_trace_yield, (tb_cpointer_t)100, 0);
+        tb_coroutine_start(scheduler, tb_demo_coroutine_trace_yield, (tb_cpointer_t)100, 0);
+        tb_coroutine_start(scheduler, tb_demo_coroutine_trace_sleep, (tb_cpointer_t)10, 0);
+        tb_coroutine_start(scheduler, tb_demo_coroutine_trace_busy, (tb_cpointer_t)3, 0);
+
+        // run scheduler
+        tb_co_scheduler_loop(scheduler, tb_true);
+
+        // dump statistics
+        tb_co_scheduler_stats_t stats;
+        if (tb_co_scheduler_stats(scheduler, &stats))
+        {
+            tb_trace_i("ready: %lu, suspend: %lu", stats.ready, stats.suspend);
+            tb_trace_i("switches: %llu, wakeups: %llu, events: %llu, timers: %llu", stats.switches, stats.wakeups, stats.events, stats.timers);
+            tb_trace_i("running: %lld us, polling: %lld us", stats.running_time, stats.polling_time);
+        }
+
+        // dump the chrome trace json, e.g. demo coroutine_trace /tmp/trace.json
+        if (argc > 1 && argv[1])
+        {
+            tb_stream_ref_t stream = tb_stream_init_from_file(argv[1], TB_FILE_MODE_RW | TB_FILE_MODE_CREAT | TB_FILE_MODE_TRUNC);
+            if (stream)
+            {
+                if (tb_stream_open(stream)) tb_co_scheduler_trace_dump(scheduler, stream);
+                tb_stream_exit(stream);
+            }
+        }
+
+        // exit scheduler
+        tb_co_scheduler_exit(scheduler);
+    }
+    return 0;
+}
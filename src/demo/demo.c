@@ -120,7 +120,10 @@ static tb_demo_t g_demo[] =
 ,   TB_DEMO_MAIN_ITEM(stream_null)
 ,   TB_DEMO_MAIN_ITEM(stream_cache)
 ,   TB_DEMO_MAIN_ITEM(stream_charset)
+,   TB_DEMO_MAIN_ITEM(stream_mmap)
+,   TB_DEMO_MAIN_ITEM(stream_file)
 ,   TB_DEMO_MAIN_ITEM(stream_zip)
+,   TB_DEMO_MAIN_ITEM(stream_lz4)
 
     // string
 ,   TB_DEMO_MAIN_ITEM(string_string)
@@ -136,6 +139,8 @@ static tb_demo_t g_demo[] =
 ,   TB_DEMO_MAIN_ITEM(memory_memops)
 ,   TB_DEMO_MAIN_ITEM(memory_buffer)
 ,   TB_DEMO_MAIN_ITEM(memory_queue_buffer)
+,   TB_DEMO_MAIN_ITEM(memory_buffer_chain)
+,   TB_DEMO_MAIN_ITEM(memory_epoch)
 ,   TB_DEMO_MAIN_ITEM(memory_static_buffer)
 ,   TB_DEMO_MAIN_ITEM(memory_impl_static_fixed_pool)
 
@@ -167,6 +172,7 @@ static tb_demo_t g_demo[] =
 ,   TB_DEMO_MAIN_ITEM(platform_process)
 ,   TB_DEMO_MAIN_ITEM(platform_ifaddrs)
 ,   TB_DEMO_MAIN_ITEM(platform_filelock)
+,   TB_DEMO_MAIN_ITEM(platform_futexlock)
 ,   TB_DEMO_MAIN_ITEM(platform_addrinfo)
 ,   TB_DEMO_MAIN_ITEM(platform_hostname)
 ,   TB_DEMO_MAIN_ITEM(platform_backtrace)
@@ -179,14 +185,20 @@ static tb_demo_t g_demo[] =
 ,   TB_DEMO_MAIN_ITEM(platform_lock)
 ,   TB_DEMO_MAIN_ITEM(platform_timer)
 ,   TB_DEMO_MAIN_ITEM(platform_ltimer)
+,   TB_DEMO_MAIN_ITEM(platform_htimer)
 ,   TB_DEMO_MAIN_ITEM(platform_event)
 ,   TB_DEMO_MAIN_ITEM(platform_semaphore)
+,   TB_DEMO_MAIN_ITEM(platform_rwlock)
+,   TB_DEMO_MAIN_ITEM(platform_percpu_counter)
 ,   TB_DEMO_MAIN_ITEM(platform_thread)
 ,   TB_DEMO_MAIN_ITEM(platform_thread_pool)
+,   TB_DEMO_MAIN_ITEM(platform_thread_pool_perf)
+,   TB_DEMO_MAIN_ITEM(platform_future)
 ,   TB_DEMO_MAIN_ITEM(platform_thread_local)
 ,   TB_DEMO_MAIN_ITEM(platform_poller_pipe)
 ,   TB_DEMO_MAIN_ITEM(platform_poller_client)
 ,   TB_DEMO_MAIN_ITEM(platform_poller_server)
+,   TB_DEMO_MAIN_ITEM(platform_poller_latency)
 ,   TB_DEMO_MAIN_ITEM(platform_poller_process)
 ,   TB_DEMO_MAIN_ITEM(platform_poller_fwatcher)
 #ifdef TB_CONFIG_MODULE_HAVE_COROUTINE
@@ -219,6 +231,7 @@ static tb_demo_t g_demo[] =
 ,   TB_DEMO_MAIN_ITEM(coroutine_dns)
 ,   TB_DEMO_MAIN_ITEM(coroutine_nest)
 ,   TB_DEMO_MAIN_ITEM(coroutine_lock)
+,   TB_DEMO_MAIN_ITEM(coroutine_rwlock)
 ,   TB_DEMO_MAIN_ITEM(coroutine_ping)
 ,   TB_DEMO_MAIN_ITEM(coroutine_pipe)
 ,   TB_DEMO_MAIN_ITEM(coroutine_sleep)
@@ -238,6 +251,9 @@ static tb_demo_t g_demo[] =
 ,   TB_DEMO_MAIN_ITEM(coroutine_file_client)
 ,   TB_DEMO_MAIN_ITEM(coroutine_http_server)
 ,   TB_DEMO_MAIN_ITEM(coroutine_spider)
+,   TB_DEMO_MAIN_ITEM(coroutine_offload)
+,   TB_DEMO_MAIN_ITEM(coroutine_select)
+,   TB_DEMO_MAIN_ITEM(coroutine_trace)
 
     // stackless coroutine
 ,   TB_DEMO_MAIN_ITEM(lo_coroutine_nest)
@@ -251,6 +267,7 @@ static tb_demo_t g_demo[] =
 ,   TB_DEMO_MAIN_ITEM(lo_coroutine_file_server)
 ,   TB_DEMO_MAIN_ITEM(lo_coroutine_file_client)
 ,   TB_DEMO_MAIN_ITEM(lo_coroutine_http_server)
+,   TB_DEMO_MAIN_ITEM(lo_coroutine_offload)
 #endif
 
 };
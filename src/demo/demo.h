@@ -110,9 +110,12 @@ TB_DEMO_MAIN_DECL(stream_async_transfer);
 TB_DEMO_MAIN_DECL(stream_async_stream);
 TB_DEMO_MAIN_DECL(stream);
 TB_DEMO_MAIN_DECL(stream_zip);
+TB_DEMO_MAIN_DECL(stream_lz4);
 TB_DEMO_MAIN_DECL(stream_null);
 TB_DEMO_MAIN_DECL(stream_cache);
 TB_DEMO_MAIN_DECL(stream_charset);
+TB_DEMO_MAIN_DECL(stream_mmap);
+TB_DEMO_MAIN_DECL(stream_file);
 TB_DEMO_MAIN_DECL(stream_async_stream_zip);
 TB_DEMO_MAIN_DECL(stream_async_stream_null);
 TB_DEMO_MAIN_DECL(stream_async_stream_cache);
@@ -132,6 +135,8 @@ TB_DEMO_MAIN_DECL(memory_default_allocator);
 TB_DEMO_MAIN_DECL(memory_memops);
 TB_DEMO_MAIN_DECL(memory_buffer);
 TB_DEMO_MAIN_DECL(memory_queue_buffer);
+TB_DEMO_MAIN_DECL(memory_buffer_chain);
+TB_DEMO_MAIN_DECL(memory_epoch);
 TB_DEMO_MAIN_DECL(memory_static_buffer);
 TB_DEMO_MAIN_DECL(memory_impl_static_fixed_pool);
 
@@ -160,6 +165,7 @@ TB_DEMO_MAIN_DECL(platform_event);
 TB_DEMO_MAIN_DECL(platform_utils);
 TB_DEMO_MAIN_DECL(platform_timer);
 TB_DEMO_MAIN_DECL(platform_ltimer);
+TB_DEMO_MAIN_DECL(platform_htimer);
 TB_DEMO_MAIN_DECL(platform_atomic);
 TB_DEMO_MAIN_DECL(platform_atomic32);
 TB_DEMO_MAIN_DECL(platform_atomic64);
@@ -167,6 +173,7 @@ TB_DEMO_MAIN_DECL(platform_stdfile);
 TB_DEMO_MAIN_DECL(platform_process);
 TB_DEMO_MAIN_DECL(platform_ifaddrs);
 TB_DEMO_MAIN_DECL(platform_filelock);
+TB_DEMO_MAIN_DECL(platform_futexlock);
 TB_DEMO_MAIN_DECL(platform_addrinfo);
 TB_DEMO_MAIN_DECL(platform_hostname);
 TB_DEMO_MAIN_DECL(platform_pipe_pair);
@@ -175,14 +182,19 @@ TB_DEMO_MAIN_DECL(platform_backtrace);
 TB_DEMO_MAIN_DECL(platform_directory);
 TB_DEMO_MAIN_DECL(platform_exception);
 TB_DEMO_MAIN_DECL(platform_semaphore);
+TB_DEMO_MAIN_DECL(platform_rwlock);
+TB_DEMO_MAIN_DECL(platform_percpu_counter);
 TB_DEMO_MAIN_DECL(platform_cache_time);
 TB_DEMO_MAIN_DECL(platform_environment);
 TB_DEMO_MAIN_DECL(platform_thread);
 TB_DEMO_MAIN_DECL(platform_thread_pool);
+TB_DEMO_MAIN_DECL(platform_thread_pool_perf);
+TB_DEMO_MAIN_DECL(platform_future);
 TB_DEMO_MAIN_DECL(platform_thread_local);
 TB_DEMO_MAIN_DECL(platform_poller_pipe);
 TB_DEMO_MAIN_DECL(platform_poller_client);
 TB_DEMO_MAIN_DECL(platform_poller_server);
+TB_DEMO_MAIN_DECL(platform_poller_latency);
 TB_DEMO_MAIN_DECL(platform_poller_process);
 TB_DEMO_MAIN_DECL(platform_poller_fwatcher);
 TB_DEMO_MAIN_DECL(platform_context);
@@ -210,6 +222,7 @@ TB_DEMO_MAIN_DECL(algorithm_sort);
 TB_DEMO_MAIN_DECL(coroutine_dns);
 TB_DEMO_MAIN_DECL(coroutine_nest);
 TB_DEMO_MAIN_DECL(coroutine_lock);
+TB_DEMO_MAIN_DECL(coroutine_rwlock);
 TB_DEMO_MAIN_DECL(coroutine_ping);
 TB_DEMO_MAIN_DECL(coroutine_sleep);
 TB_DEMO_MAIN_DECL(coroutine_spider);
@@ -229,6 +242,9 @@ TB_DEMO_MAIN_DECL(coroutine_unix_echo_server);
 TB_DEMO_MAIN_DECL(coroutine_file_client);
 TB_DEMO_MAIN_DECL(coroutine_file_server);
 TB_DEMO_MAIN_DECL(coroutine_http_server);
+TB_DEMO_MAIN_DECL(coroutine_offload);
+TB_DEMO_MAIN_DECL(coroutine_select);
+TB_DEMO_MAIN_DECL(coroutine_trace);
 
 // stackless coroutine
 TB_DEMO_MAIN_DECL(lo_coroutine_nest);
@@ -242,6 +258,7 @@ TB_DEMO_MAIN_DECL(lo_coroutine_echo_client);
 TB_DEMO_MAIN_DECL(lo_coroutine_file_server);
 TB_DEMO_MAIN_DECL(lo_coroutine_file_client);
 TB_DEMO_MAIN_DECL(lo_coroutine_http_server);
+TB_DEMO_MAIN_DECL(lo_coroutine_offload);
 
 __tb_extern_c_leave__
 
@@ -0,0 +1,80 @@
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "../demo.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+static tb_void_t tb_demo_buffer_chain_dump(tb_char_t const* name, tb_buffer_chain_ref_t chain)
+{
+    // peek all slices
+    tb_iovec_t  list[16];
+    tb_char_t   data[256];
+    tb_size_t   size = 0;
+    tb_size_t   count = tb_buffer_chain_peek(chain, list, tb_arrayn(list));
+    tb_size_t   i = 0;
+    for (i = 0; i < count && size + list[i].size < sizeof(data); i++)
+    {
+        tb_memcpy(data + size, list[i].data, list[i].size);
+        size += list[i].size;
+    }
+    data[size] = '\0';
+
+    // trace
+    tb_trace_i("%s: size: %lu, count: %lu, data: %s", name, tb_buffer_chain_size(chain), tb_buffer_chain_count(chain), data);
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */
+tb_int_t tb_demo_memory_buffer_chain_main(tb_int_t argc, tb_char_t** argv)
+{
+    // init chain
+    tb_buffer_chain_ref_t chain = tb_buffer_chain_init();
+    if (chain)
+    {
+        // append and prepend the borrowed, copied and owned data
+        tb_buffer_chain_append(chain, (tb_byte_t const*)"hello", 5);
+        tb_buffer_chain_append_copy(chain, (tb_byte_t const*)" ", 1);
+        tb_buffer_chain_append_copy(chain, (tb_byte_t const*)"world", 5);
+        tb_byte_t* owned = (tb_byte_t*)tb_strdup("!!!");
+        if (owned) tb_buffer_chain_append_owned(chain, owned, 3);
+        tb_buffer_chain_prepend_copy(chain, (tb_byte_t const*)"[", 1);
+        tb_buffer_chain_append(chain, (tb_byte_t const*)"]", 1);
+        tb_demo_buffer_chain_dump("chain", chain);
+
+        // split it, the copied block will be shared
+        tb_buffer_chain_ref_t tail = tb_buffer_chain_split(chain, 8);
+        if (tail)
+        {
+            tb_demo_buffer_chain_dump("head", chain);
+            tb_demo_buffer_chain_dump("tail", tail);
+
+            // append the shared slices
+            tb_buffer_chain_append_chain(chain, tail);
+            tb_buffer_chain_exit(tail);
+            tb_demo_buffer_chain_dump("join", chain);
+        }
+
+        // skip the head data
+        tb_buffer_chain_skip(chain, 3);
+        tb_demo_buffer_chain_dump("skip", chain);
+
+        // writ it to the file stream by writev
+        if (argv[1])
+        {
+            tb_stream_ref_t stream = tb_stream_init_from_file(argv[1], TB_FILE_MODE_RW | TB_FILE_MODE_CREAT | TB_FILE_MODE_TRUNC);
+            if (stream && tb_stream_open(stream))
+            {
+                tb_bool_t ok = tb_stream_bwrit(stream, (tb_byte_t const*)"cached: ", 8) && tb_stream_bwrit_chain(stream, chain) && tb_stream_sync(stream, tb_true);
+                tb_trace_i("writ: %s, size: %lld, left: %lu", ok? "ok" : "failed", tb_stream_size(stream), tb_buffer_chain_size(chain));
+            }
+            if (stream) tb_stream_exit(stream);
+        }
+
+        // exit chain
+        tb_buffer_chain_exit(chain);
+    }
+    return 0;
+}
@@ -0,0 +1,168 @@
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "../demo.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the reader threads count
+#define TB_DEMO_READER_COUNT    (4)
+
+// the read count of each reader thread
+#define TB_DEMO_READ_COUNT      (1000000)
+
+// the node magic
+#define TB_DEMO_NODE_MAGIC      (0xdeadbeef)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the shared node type
+typedef struct __tb_demo_node_t
+{
+    // the magic, it will be cleared after freeing it
+    tb_size_t               magic;
+
+    // the value
+    tb_size_t               value;
+
+}tb_demo_node_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * globals
+ */
+
+// use hazard pointers?
+static tb_bool_t            g_hazard = tb_false;
+
+// the shared node
+static tb_atomic_t          g_shared = 0;
+
+// the freed nodes count
+static tb_atomic_t          g_freed = 0;
+
+// the broken reads count
+static tb_atomic_t          g_broken = 0;
+
+// is stopped?
+static tb_atomic32_t        g_stop = 0;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+static tb_demo_node_t* tb_demo_node_init(tb_size_t value)
+{
+    tb_demo_node_t* node = tb_malloc0_type(tb_demo_node_t);
+    if (node)
+    {
+        node->magic = TB_DEMO_NODE_MAGIC;
+        node->value = value;
+    }
+    return node;
+}
+static tb_void_t tb_demo_node_free(tb_pointer_t data, tb_cpointer_t priv)
+{
+    // poison it to detect the use-after-free
+    ((tb_demo_node_t*)data)->magic = 0;
+    tb_free(data);
+    tb_atomic_fetch_and_add(&g_freed, 1);
+}
+static tb_int_t tb_demo_reader(tb_cpointer_t priv)
+{
+    tb_size_t n = TB_DEMO_READ_COUNT;
+    while (n--)
+    {
+        if (g_hazard)
+        {
+            tb_demo_node_t* node = (tb_demo_node_t*)tb_hazard_protect(0, &g_shared);
+            if (node && node->magic != TB_DEMO_NODE_MAGIC) tb_atomic_fetch_and_add(&g_broken, 1);
+            tb_hazard_clear(0);
+        }
+        else
+        {
+            tb_epoch_enter();
+            tb_demo_node_t* node = (tb_demo_node_t*)tb_atomic_get(&g_shared);
+            if (node && node->magic != TB_DEMO_NODE_MAGIC) tb_atomic_fetch_and_add(&g_broken, 1);
+            tb_epoch_leave();
+        }
+    }
+    return 0;
+}
+static tb_int_t tb_demo_writer(tb_cpointer_t priv)
+{
+    tb_size_t value = 0;
+    while (!tb_atomic32_get(&g_stop))
+    {
+        // replace the shared node
+        tb_demo_node_t* node = tb_demo_node_init(++value);
+        tb_demo_node_t* prev = (tb_demo_node_t*)tb_atomic_fetch_and_set(&g_shared, (tb_long_t)node);
+
+        // retire the previous node
+        if (prev)
+        {
+            if (g_hazard) tb_hazard_retire_func(prev, tb_demo_node_free, tb_null);
+            else tb_epoch_retire_func(prev, tb_demo_node_free, tb_null);
+        }
+        tb_sched_yield();
+    }
+
+    // free all retired nodes
+    if (g_hazard) tb_hazard_reclaim();
+    else tb_epoch_synchronize();
+    tb_trace_i("writer: %lu nodes", value);
+    return 0;
+}
+static tb_void_t tb_demo_bench(tb_bool_t hazard)
+{
+    // init
+    g_hazard = hazard;
+    tb_atomic_set(&g_shared, (tb_long_t)tb_demo_node_init(0));
+    tb_atomic_set(&g_freed, 0);
+    tb_atomic_set(&g_broken, 0);
+    tb_atomic32_set(&g_stop, 0);
+
+    // init threads
+    tb_size_t       i = 0;
+    tb_thread_ref_t readers[TB_DEMO_READER_COUNT] = {0};
+    tb_hong_t       time = tb_mclock();
+    tb_thread_ref_t writer = tb_thread_init(tb_null, tb_demo_writer, tb_null, 0);
+    for (i = 0; i < TB_DEMO_READER_COUNT; i++)
+        readers[i] = tb_thread_init(tb_null, tb_demo_reader, tb_null, 0);
+
+    // wait threads
+    for (i = 0; i < TB_DEMO_READER_COUNT; i++)
+    {
+        if (readers[i])
+        {
+            tb_thread_wait(readers[i], -1, tb_null);
+            tb_thread_exit(readers[i]);
+        }
+    }
+    time = tb_mclock() - time;
+    tb_atomic32_set(&g_stop, 1);
+    if (writer)
+    {
+        tb_thread_wait(writer, -1, tb_null);
+        tb_thread_exit(writer);
+    }
+
+    // free the last node
+    tb_demo_node_t* node = (tb_demo_node_t*)tb_atomic_fetch_and_set(&g_shared, 0);
+    if (node) tb_demo_node_free(node, tb_null);
+
+    // trace
+    tb_trace_i("%s: %lld ms, freed: %ld, broken: %ld", hazard? "hazard" : "epoch", time, tb_atomic_get(&g_freed), tb_atomic_get(&g_broken));
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */
+tb_int_t tb_demo_memory_epoch_main(tb_int_t argc, tb_char_t** argv)
+{
+    tb_demo_bench(tb_false);
+    tb_demo_bench(tb_true);
+    return 0;
+}
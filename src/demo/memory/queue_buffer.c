@@ -3,6 +3,57 @@
  */
 #include "../demo.h"
 
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the bench buffer maxn
+#define TB_DEMO_BENCH_MAXN      (256 * 1024)
+
+// the bench data size
+#define TB_DEMO_BENCH_SIZE      (1024 * 1024 * 1024)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+static tb_void_t tb_demo_queue_buffer_bench(tb_bool_t mirror)
+{
+    // init buffer
+    tb_queue_buffer_t b;
+    tb_queue_buffer_init(&b, TB_DEMO_BENCH_MAXN);
+    if (mirror && !tb_queue_buffer_mirror(&b, tb_true))
+    {
+        tb_trace_i("bench: mirror: not supported");
+        tb_queue_buffer_exit(&b);
+        return ;
+    }
+
+    // write the odd-sized chunks and read the most of them, it likes the stream cache
+    tb_byte_t   data[65536 + 4096];
+    tb_long_t   writ = 0;
+    tb_long_t   read = 0;
+    tb_size_t   seed = 0;
+    tb_hize_t   total = 0;
+    tb_hong_t   time = tb_mclock();
+    tb_memset(data, 0, sizeof(data));
+    while (total < TB_DEMO_BENCH_SIZE)
+    {
+        writ = tb_queue_buffer_writ(&b, data, 61440 + (seed % 4096));
+        read = tb_queue_buffer_read(&b, data, 60000 + (seed % 1000));
+        if (writ < 0 || read < 0) break;
+
+        total += read;
+        seed += data[0] + 1;
+    }
+    time = tb_mclock() - time;
+
+    // trace
+    tb_trace_i("bench: %s: maxn: %lu, %llu MB/s, seed: %lu", mirror? "mirror" : "plain", tb_queue_buffer_maxn(&b), time? (total * 1000 / time) >> 20 : 0, seed);
+
+    // exit buffer
+    tb_queue_buffer_exit(&b);
+}
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * main
  */
@@ -20,5 +71,25 @@ tb_int_t tb_demo_memory_queue_buffer_main(tb_int_t argc, tb_char_t** argv)
 
     tb_queue_buffer_exit(&b);
 
+    // the mirrored buffer, the data wraps around the end without moving
+    tb_queue_buffer_init(&b, 1024);
+    if (tb_queue_buffer_mirror(&b, tb_true))
+    {
+        tb_size_t i = 0;
+        tb_queue_buffer_writ(&b, (tb_byte_t const*)"hello world", 12);
+        for (i = 0; i < 1000; i++)
+        {
+            tb_queue_buffer_writ(&b, (tb_byte_t const*)"hello world", 12);
+            tb_queue_buffer_skip(&b, 12);
+        }
+        tb_size_t   size = 0;
+        tb_byte_t*  head = tb_queue_buffer_pull_init(&b, &size);
+        tb_trace_i("mirror: maxn: %lu, size: %lu, offset: %lu, tail: %s", tb_queue_buffer_maxn(&b), size, head - tb_queue_buffer_data(&b), head + size - 12);
+    }
+    tb_queue_buffer_exit(&b);
+
+    // bench
+    tb_demo_queue_buffer_bench(tb_false);
+    tb_demo_queue_buffer_bench(tb_true);
     return 0;
 }
@@ -26,8 +26,10 @@ tb_int_t tb_demo_other_charset_main(tb_int_t argc, tb_char_t** argv)
             if (idata && odata && tb_stream_bread(istream, idata, (tb_size_t)isize))
             {
                 // conv
+                tb_hong_t time = tb_mclock();
                 osize = tb_charset_conv_data(tb_charset_type(argv[3]), tb_charset_type(argv[4]), idata, (tb_size_t)isize, odata, osize);
-                tb_trace_i("conv: %ld bytes", osize);
+                time = tb_mclock() - time;
+                tb_trace_i("conv: %ld bytes, %lld ms", osize, time);
 
                 // save
                 if (osize > 0) tb_stream_bwrit(ostream, odata, osize);
@@ -3,6 +3,26 @@
  */
 #include "../demo.h"
 
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the clock calls count for bench
+#define TB_DEMO_CLOCK_COUNT     (10000000)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+static tb_void_t tb_demo_clock_bench(tb_char_t const* name, tb_hong_t (*clock)(tb_noarg_t))
+{
+    tb_size_t n = TB_DEMO_CLOCK_COUNT;
+    tb_hong_t sum = 0;
+    tb_hong_t time = tb_tsc_clock();
+    while (n--) sum ^= clock();
+    time = tb_tsc_clock() - time;
+    tb_trace_i("%s: %lld ns/call, sum: %lld", name, time / TB_DEMO_CLOCK_COUNT, sum);
+}
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * main
  */
@@ -13,5 +33,18 @@ tb_int_t tb_demo_platform_cache_time_main(tb_int_t argc, tb_char_t** argv)
     tb_trace_i("%lld %lld", tb_cache_time_spak(), tb_cache_time_mclock());
     tb_sleep(1);
     tb_trace_i("%lld %lld", tb_cache_time_spak(), tb_cache_time_mclock());
+
+    // the tsc clock and the coarse clock
+    tb_trace_i("tsc: frequency: %lld, invariant: %d", tb_tsc_frequency(), tb_tsc_invariant());
+    tb_trace_i("tsc: %lld ns, coarse: %lld ms", tb_tsc_clock(), tb_cache_time_coarse());
+    tb_msleep(100);
+    tb_trace_i("tsc: %lld ns, coarse: %lld ms", tb_tsc_clock(), tb_cache_time_coarse());
+
+    // bench them
+    tb_demo_clock_bench("uclock", tb_uclock);
+    tb_demo_clock_bench("tsc_clock", tb_tsc_clock);
+    tb_demo_clock_bench("tsc_ticks", tb_tsc_ticks);
+    tb_demo_clock_bench("cache_time_mclock", tb_cache_time_mclock);
+    tb_demo_clock_bench("cache_time_coarse", tb_cache_time_coarse);
     return 0;
 }
@@ -0,0 +1,160 @@
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "../demo.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the threads maxn
+#define TB_DEMO_THREAD_MAXN     (256)
+
+// the total lock count of all threads
+#define TB_DEMO_LOCK_COUNT      (4000000)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the lock type
+typedef enum __tb_demo_lock_type_e
+{
+    TB_DEMO_LOCK_TYPE_SPINLOCK  = 0
+,   TB_DEMO_LOCK_TYPE_FUTEXLOCK = 1
+,   TB_DEMO_LOCK_TYPE_MUTEX     = 2
+
+}tb_demo_lock_type_e;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * globals
+ */
+
+// the lock type
+static tb_size_t        g_type = TB_DEMO_LOCK_TYPE_SPINLOCK;
+
+// the spinlock
+static tb_spinlock_t    g_spinlock = TB_SPINLOCK_INIT;
+
+// the futex lock
+static tb_futexlock_t   g_futexlock = TB_FUTEXLOCK_INIT;
+
+// the mutex
+static tb_mutex_ref_t   g_mutex = tb_null;
+
+// the loop count of each thread
+static tb_size_t        g_loop = 0;
+
+// the shared value
+static tb_size_t        g_value = 0;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+static tb_int_t tb_demo_lock_loop(tb_cpointer_t priv)
+{
+    // loop
+    tb_size_t n = g_loop;
+    while (n--)
+    {
+        // enter
+        switch (g_type)
+        {
+        case TB_DEMO_LOCK_TYPE_SPINLOCK:    tb_spinlock_enter(&g_spinlock);     break;
+        case TB_DEMO_LOCK_TYPE_FUTEXLOCK:   tb_futexlock_enter(&g_futexlock);   break;
+        default:                            tb_mutex_enter(g_mutex);            break;
+        }
+
+        // the short critical section
+        __tb_volatile__ tb_size_t i = 32;
+        while (i--) g_value++;
+
+        // leave
+        switch (g_type)
+        {
+        case TB_DEMO_LOCK_TYPE_SPINLOCK:    tb_spinlock_leave(&g_spinlock);     break;
+        case TB_DEMO_LOCK_TYPE_FUTEXLOCK:   tb_futexlock_leave(&g_futexlock);   break;
+        default:                            tb_mutex_leave(g_mutex);            break;
+        }
+
+        // do some work outside the lock
+        i = 32;
+        while (i--) ;
+    }
+    return 0;
+}
+static tb_void_t tb_demo_lock_bench(tb_size_t type, tb_size_t count)
+{
+    // init
+    g_type  = type;
+    g_value = 0;
+    g_loop  = TB_DEMO_LOCK_COUNT / count;
+
+    // init threads
+    tb_size_t       i = 0;
+    tb_thread_ref_t threads[TB_DEMO_THREAD_MAXN] = {0};
+    tb_hong_t       time = tb_mclock();
+    for (i = 0; i < count; i++)
+    {
+        threads[i] = tb_thread_init(tb_null, tb_demo_lock_loop, tb_null, 0);
+        tb_assert_and_check_break(threads[i]);
+    }
+
+    // wait threads
+    for (i = 0; i < count; i++)
+    {
+        if (threads[i])
+        {
+            tb_thread_wait(threads[i], -1, tb_null);
+            tb_thread_exit(threads[i]);
+        }
+    }
+    time = tb_mclock() - time;
+
+    // trace
+    static tb_char_t const* s_names[] = {"spinlock", "futexlock", "mutex"};
+    tb_trace_i("%s: threads: %lu, value: %lu, %lld ms", s_names[type], count, g_value, time);
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */
+tb_int_t tb_demo_platform_futexlock_main(tb_int_t argc, tb_char_t** argv)
+{
+    // init mutex
+    g_mutex = tb_mutex_init();
+    if (g_mutex)
+    {
+        // register locks
+        tb_lock_profiler_register(tb_lock_profiler(), (tb_pointer_t)&g_spinlock, "demo_spinlock");
+        tb_lock_profiler_register(tb_lock_profiler(), (tb_pointer_t)&g_futexlock, "demo_futexlock");
+        tb_lock_profiler_register(tb_lock_profiler(), (tb_pointer_t)g_mutex, "demo_mutex");
+
+#ifdef TB_LOCK_PROFILER_ENABLE
+        // sample all contentions
+        tb_lock_profiler_sample(tb_lock_profiler(), 1);
+#endif
+
+        // bench them with 1x, 2x and 4x threads of the cpu count
+        tb_size_t ncpu = tb_cpu_count();
+        tb_size_t factor = 1;
+        for (factor = 1; factor <= 4; factor <<= 1)
+        {
+            tb_size_t count = tb_min(ncpu * factor, TB_DEMO_THREAD_MAXN);
+            tb_demo_lock_bench(TB_DEMO_LOCK_TYPE_SPINLOCK, count);
+            tb_demo_lock_bench(TB_DEMO_LOCK_TYPE_FUTEXLOCK, count);
+            tb_demo_lock_bench(TB_DEMO_LOCK_TYPE_MUTEX, count);
+        }
+
+#ifdef TB_LOCK_PROFILER_ENABLE
+        // dump the collapsed contention stacks, the histograms will be dumped after exiting tbox
+        if (argc > 1) tb_lock_profiler_dump_stacks(tb_lock_profiler(), argv[1]);
+        tb_lock_profiler_sample(tb_lock_profiler(), TB_LOCK_PROFILER_SAMPLE_RATE);
+#endif
+
+        // exit mutex
+        tb_mutex_exit(g_mutex);
+        g_mutex = tb_null;
+    }
+    return 0;
+}
@@ -0,0 +1,200 @@
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "../demo.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the chained tasks count for perf
+#ifdef __tb_small__
+#   define TB_DEMO_CHAIN_COUNT      (10000)
+#else
+#   define TB_DEMO_CHAIN_COUNT      (100000)
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * globals
+ */
+
+// the finished tasks count
+static tb_atomic_t      g_count = 0;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+static tb_cpointer_t tb_demo_future_value(tb_thread_pool_worker_ref_t worker, tb_cpointer_t priv)
+{
+    return priv;
+}
+static tb_cpointer_t tb_demo_future_sleep(tb_thread_pool_worker_ref_t worker, tb_cpointer_t priv)
+{
+    tb_msleep((tb_long_t)priv);
+    return priv;
+}
+static tb_cpointer_t tb_demo_future_add(tb_thread_pool_worker_ref_t worker, tb_future_ref_t future, tb_cpointer_t priv)
+{
+    return (tb_cpointer_t)((tb_size_t)tb_future_get(future) + (tb_size_t)priv);
+}
+static tb_void_t tb_demo_future_test()
+{
+    // then
+    tb_future_ref_t value = tb_future_async(tb_null, tb_demo_future_value, (tb_cpointer_t)40);
+    tb_future_ref_t then = tb_future_then(value, tb_demo_future_add, (tb_cpointer_t)2);
+    if (tb_future_wait(then, -1) > 0) tb_trace_i("then: %lu", (tb_size_t)tb_future_get(then));
+    tb_future_exit(then);
+    tb_future_exit(value);
+
+    // when_all
+    tb_size_t       i = 0;
+    tb_size_t       sum = 0;
+    tb_future_ref_t futures[4];
+    for (i = 0; i < tb_arrayn(futures); i++) futures[i] = tb_future_async(tb_null, tb_demo_future_sleep, (tb_cpointer_t)(i * 10));
+    tb_future_ref_t all = tb_future_when_all(futures, tb_arrayn(futures));
+    if (tb_future_wait(all, -1) > 0)
+    {
+        for (i = 0; i < tb_arrayn(futures); i++) sum += (tb_size_t)tb_future_get(futures[i]);
+        tb_trace_i("when_all: %lu", sum);
+    }
+    tb_future_exit(all);
+    for (i = 0; i < tb_arrayn(futures); i++) tb_future_exit(futures[i]);
+
+    // when_any
+    futures[0] = tb_future_async(tb_null, tb_demo_future_sleep, (tb_cpointer_t)500);
+    futures[1] = tb_future_async(tb_null, tb_demo_future_sleep, (tb_cpointer_t)10);
+    tb_future_ref_t any = tb_future_when_any(futures, 2);
+    if (tb_future_wait(any, -1) > 0) tb_trace_i("when_any: %lu", (tb_size_t)tb_future_get(any));
+    tb_future_exit(any);
+    tb_future_exit(futures[0]);
+    tb_future_exit(futures[1]);
+
+    // cancel
+    tb_future_ref_t promise = tb_future_init(tb_null);
+    then = tb_future_then(promise, tb_demo_future_add, (tb_cpointer_t)1);
+    tb_trace_i("timeout: %ld", tb_future_wait(then, 10));
+    tb_future_cancel(promise);
+    tb_trace_i("cancel: %ld, state: %s", tb_future_wait(then, -1), tb_state_cstr(tb_future_state(then)));
+    tb_future_exit(then);
+    tb_future_exit(promise);
+
+    // release an unfinished promise, the continuation will be canceled and nothing will be leaked
+    promise = tb_future_init(tb_null);
+    then = tb_future_then(promise, tb_demo_future_add, (tb_cpointer_t)1);
+    tb_future_exit(promise);
+    tb_trace_i("release: %ld, state: %s", tb_future_wait(then, -1), tb_state_cstr(tb_future_state(then)));
+    tb_future_exit(then);
+}
+static tb_void_t tb_demo_task_graph_done(tb_thread_pool_worker_ref_t worker, tb_cpointer_t priv)
+{
+    // trace
+    tb_trace_i("graph: %s, worker: %p, thread: %lu", (tb_char_t const*)priv, worker, tb_thread_self());
+}
+static tb_void_t tb_demo_task_graph_test()
+{
+    // init graph
+    tb_task_graph_ref_t graph = tb_task_graph_init(tb_null);
+    if (graph)
+    {
+        // parse -> transform1, transform2 -> compress -> write
+        tb_task_graph_node_ref_t parse      = tb_task_graph_node(graph, "parse", tb_demo_task_graph_done, "parse");
+        tb_task_graph_node_ref_t transform1 = tb_task_graph_node(graph, "transform1", tb_demo_task_graph_done, "transform1");
+        tb_task_graph_node_ref_t transform2 = tb_task_graph_node(graph, "transform2", tb_demo_task_graph_done, "transform2");
+        tb_task_graph_node_ref_t compress   = tb_task_graph_node(graph, "compress", tb_demo_task_graph_done, "compress");
+        tb_task_graph_node_ref_t write      = tb_task_graph_node(graph, "write", tb_demo_task_graph_done, "write");
+        tb_task_graph_depend(graph, transform1, parse);
+        tb_task_graph_depend(graph, transform2, parse);
+        tb_task_graph_depend(graph, compress, transform1);
+        tb_task_graph_depend(graph, compress, transform2);
+        tb_task_graph_depend(graph, write, compress);
+
+        // run it twice
+        tb_size_t i = 0;
+        for (i = 0; i < 2; i++)
+        {
+            if (tb_task_graph_run(graph))
+                tb_trace_i("graph: wait: %ld", tb_task_graph_wait(graph, -1));
+        }
+
+        // we cannot run it if it has a cycle
+        tb_task_graph_depend(graph, parse, write);
+        tb_trace_i("graph: cycle: %d", tb_task_graph_run(graph));
+
+        // exit graph
+        tb_task_graph_exit(graph);
+    }
+}
+static tb_void_t tb_demo_task_graph_perf_done(tb_thread_pool_worker_ref_t worker, tb_cpointer_t priv)
+{
+    tb_atomic_fetch_and_add_explicit(&g_count, 1, TB_ATOMIC_RELAXED);
+}
+static tb_cpointer_t tb_demo_future_perf_then(tb_thread_pool_worker_ref_t worker, tb_future_ref_t future, tb_cpointer_t priv)
+{
+    return (tb_cpointer_t)((tb_size_t)tb_future_get(future) + 1);
+}
+static tb_void_t tb_demo_future_perf()
+{
+    // chain the futures
+    tb_size_t       i = 0;
+    tb_hong_t       time = tb_mclock();
+    tb_future_ref_t promise = tb_future_init(tb_null);
+    tb_future_ref_t future = promise;
+    for (i = 0; i < TB_DEMO_CHAIN_COUNT && future; i++)
+    {
+        tb_future_ref_t then = tb_future_then(future, tb_demo_future_perf_then, tb_null);
+        if (future != promise) tb_future_exit(future);
+        future = then;
+    }
+    if (future)
+    {
+        tb_future_set(promise, tb_null);
+        tb_future_wait(future, -1);
+        tb_trace_i("future: then x %d: %lu, %lld ms", TB_DEMO_CHAIN_COUNT, (tb_size_t)tb_future_get(future), tb_mclock() - time);
+        tb_future_exit(future);
+    }
+    tb_future_exit(promise);
+}
+static tb_void_t tb_demo_task_graph_perf()
+{
+    // init graph
+    tb_task_graph_ref_t graph = tb_task_graph_init(tb_null);
+    if (graph)
+    {
+        // make a chain and a fanout
+        tb_size_t                   i = 0;
+        tb_task_graph_node_ref_t    root = tb_task_graph_node(graph, tb_null, tb_demo_task_graph_perf_done, tb_null);
+        tb_task_graph_node_ref_t    prev = root;
+        tb_task_graph_node_ref_t    sink = tb_task_graph_node(graph, tb_null, tb_demo_task_graph_perf_done, tb_null);
+        for (i = 0; i < TB_DEMO_CHAIN_COUNT; i++)
+        {
+            tb_task_graph_node_ref_t chain = tb_task_graph_node(graph, tb_null, tb_demo_task_graph_perf_done, tb_null);
+            tb_task_graph_node_ref_t fanout = tb_task_graph_node(graph, tb_null, tb_demo_task_graph_perf_done, tb_null);
+            tb_task_graph_depend(graph, chain, prev);
+            tb_task_graph_depend(graph, fanout, root);
+            tb_task_graph_depend(graph, sink, fanout);
+            prev = chain;
+        }
+        tb_task_graph_depend(graph, sink, prev);
+
+        // run it
+        tb_atomic_set(&g_count, 0);
+        tb_hong_t time = tb_mclock();
+        if (tb_task_graph_run(graph) && tb_task_graph_wait(graph, -1) > 0)
+            tb_trace_i("graph: %ld nodes, %lld ms", tb_atomic_get(&g_count), tb_mclock() - time);
+
+        // exit graph
+        tb_task_graph_exit(graph);
+    }
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */
+tb_int_t tb_demo_platform_future_main(tb_int_t argc, tb_char_t** argv)
+{
+    tb_demo_future_test();
+    tb_demo_task_graph_test();
+    tb_demo_future_perf();
+    tb_demo_task_graph_perf();
+    return 0;
+}
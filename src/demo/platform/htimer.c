@@ -0,0 +1,203 @@
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "../demo.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the tasks count for perf, the heap of tb_timer is limited to 64K items for the small mode
+#ifdef __tb_small__
+#   define TB_DEMO_TASK_COUNT   (10000)
+#else
+#   define TB_DEMO_TASK_COUNT   (500000)
+#endif
+
+// the re-arming rounds for perf
+#define TB_DEMO_TASK_ROUNDS     (4)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * globals
+ */
+
+// the start time
+static tb_hong_t    g_start = 0;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+static tb_void_t tb_demo_htimer_task_func(tb_bool_t killed, tb_cpointer_t priv)
+{
+    // trace
+    tb_trace_i("task[%s]: %lld ms, killed: %d", (tb_char_t const*)priv, tb_mclock() - g_start, killed);
+}
+static tb_void_t tb_demo_htimer_perf_func(tb_bool_t killed, tb_cpointer_t priv)
+{
+}
+static tb_void_t tb_demo_htimer_test()
+{
+    // init timer with 10ms tick
+    tb_htimer_ref_t timer = tb_htimer_init(16, 10, tb_false);
+    if (timer)
+    {
+        // add tasks
+        g_start = tb_mclock();
+        tb_htimer_task_post(timer, 100, tb_true, tb_demo_htimer_task_func, "every");
+        tb_htimer_task_post(timer, 5000, tb_false, tb_demo_htimer_task_func, "cascade");
+        tb_htimer_task_ref_t one = tb_htimer_task_init(timer, 300, tb_false, tb_demo_htimer_task_func, "one");
+        tb_htimer_task_ref_t far = tb_htimer_task_init(timer, 3600000, tb_false, tb_demo_htimer_task_func, "far");
+        tb_htimer_task_ref_t canceled = tb_htimer_task_init(timer, 200, tb_false, tb_demo_htimer_task_func, "canceled");
+
+        // cancel it
+        if (canceled) tb_htimer_task_exit(timer, canceled);
+
+        // spak timer in the current thread
+        tb_bool_t killed = tb_false;
+        while (tb_mclock() - g_start < 5500)
+        {
+            // wait it
+            tb_size_t delay = tb_htimer_delay(timer);
+            tb_msleep(tb_min(delay, 1000));
+
+            // spak it
+            if (!tb_htimer_spak(timer)) break;
+
+            // kill the far task
+            if (!killed && tb_mclock() - g_start > 1000)
+            {
+                if (far) tb_htimer_task_kill(timer, far);
+                killed = tb_true;
+            }
+        }
+
+        // exit tasks
+        if (one) tb_htimer_task_exit(timer, one);
+        if (far) tb_htimer_task_exit(timer, far);
+
+        // exit timer
+        tb_htimer_exit(timer);
+    }
+}
+static tb_void_t tb_demo_htimer_perf_timer(tb_cpointer_t* tasks)
+{
+    // init timer
+    tb_timer_ref_t timer = tb_timer_init(4096, tb_true);
+    if (timer)
+    {
+        // re-arm all tasks, e.g. the socket read timeouts
+        tb_size_t i = 0;
+        tb_size_t n = 0;
+        tb_hong_t t = tb_mclock();
+        for (n = 0; n < TB_DEMO_TASK_ROUNDS; n++)
+        {
+            for (i = 0; i < TB_DEMO_TASK_COUNT; i++)
+            {
+                if (tasks[i]) tb_timer_task_exit(timer, (tb_timer_task_ref_t)tasks[i]);
+                tasks[i] = tb_timer_task_init(timer, 1000 + tb_random_range(0, 59000), tb_false, tb_demo_htimer_perf_func, tb_null);
+            }
+        }
+
+        // cancel all tasks
+        for (i = 0; i < TB_DEMO_TASK_COUNT; i++)
+        {
+            if (tasks[i]) tb_timer_task_exit(timer, (tb_timer_task_ref_t)tasks[i]);
+            tasks[i] = tb_null;
+        }
+        t = tb_mclock() - t;
+
+        // trace
+        tb_trace_i("timer: %d tasks x %d rounds: %lld ms", TB_DEMO_TASK_COUNT, TB_DEMO_TASK_ROUNDS, t);
+
+        // exit timer
+        tb_timer_exit(timer);
+    }
+}
+static tb_void_t tb_demo_htimer_perf_ltimer(tb_cpointer_t* tasks)
+{
+    // init timer
+    tb_ltimer_ref_t timer = tb_ltimer_init(4096, TB_LTIMER_TICK_S, tb_true);
+    if (timer)
+    {
+        // re-arm all tasks, e.g. the socket read timeouts
+        tb_size_t i = 0;
+        tb_size_t n = 0;
+        tb_hong_t t = tb_mclock();
+        for (n = 0; n < TB_DEMO_TASK_ROUNDS; n++)
+        {
+            for (i = 0; i < TB_DEMO_TASK_COUNT; i++)
+            {
+                if (tasks[i]) tb_ltimer_task_exit(timer, (tb_ltimer_task_ref_t)tasks[i]);
+                tasks[i] = tb_ltimer_task_init(timer, 1000 + tb_random_range(0, 59000), tb_false, tb_demo_htimer_perf_func, tb_null);
+            }
+        }
+
+        // cancel all tasks
+        for (i = 0; i < TB_DEMO_TASK_COUNT; i++)
+        {
+            if (tasks[i]) tb_ltimer_task_exit(timer, (tb_ltimer_task_ref_t)tasks[i]);
+            tasks[i] = tb_null;
+        }
+        t = tb_mclock() - t;
+
+        // trace
+        tb_trace_i("ltimer: %d tasks x %d rounds: %lld ms", TB_DEMO_TASK_COUNT, TB_DEMO_TASK_ROUNDS, t);
+
+        // exit timer
+        tb_ltimer_exit(timer);
+    }
+}
+static tb_void_t tb_demo_htimer_perf_htimer(tb_cpointer_t* tasks)
+{
+    // init timer
+    tb_htimer_ref_t timer = tb_htimer_init(4096, 1, tb_true);
+    if (timer)
+    {
+        // re-arm all tasks, e.g. the socket read timeouts
+        tb_size_t i = 0;
+        tb_size_t n = 0;
+        tb_hong_t t = tb_mclock();
+        for (n = 0; n < TB_DEMO_TASK_ROUNDS; n++)
+        {
+            for (i = 0; i < TB_DEMO_TASK_COUNT; i++)
+            {
+                if (tasks[i]) tb_htimer_task_exit(timer, (tb_htimer_task_ref_t)tasks[i]);
+                tasks[i] = tb_htimer_task_init(timer, 1000 + tb_random_range(0, 59000), tb_false, tb_demo_htimer_perf_func, tb_null);
+            }
+        }
+
+        // cancel all tasks
+        for (i = 0; i < TB_DEMO_TASK_COUNT; i++)
+        {
+            if (tasks[i]) tb_htimer_task_exit(timer, (tb_htimer_task_ref_t)tasks[i]);
+            tasks[i] = tb_null;
+        }
+        t = tb_mclock() - t;
+
+        // trace
+        tb_trace_i("htimer: %d tasks x %d rounds: %lld ms", TB_DEMO_TASK_COUNT, TB_DEMO_TASK_ROUNDS, t);
+
+        // exit timer
+        tb_htimer_exit(timer);
+    }
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */
+tb_int_t tb_demo_platform_htimer_main(tb_int_t argc, tb_char_t** argv)
+{
+    // test
+    tb_demo_htimer_test();
+
+    // perf
+    tb_cpointer_t* tasks = tb_nalloc0_type(TB_DEMO_TASK_COUNT, tb_cpointer_t);
+    if (tasks)
+    {
+        tb_demo_htimer_perf_timer(tasks);
+        tb_demo_htimer_perf_ltimer(tasks);
+        tb_demo_htimer_perf_htimer(tasks);
+        tb_free((tb_pointer_t)tasks);
+    }
+    return 0;
+}
@@ -0,0 +1,109 @@
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "../demo.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the threads maxn
+#define TB_DEMO_THREAD_MAXN     (64)
+
+// the total add count of all threads
+#define TB_DEMO_ADD_COUNT       (64000000)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * globals
+ */
+
+// use the per-cpu counter?
+static tb_bool_t            g_percpu = tb_false;
+
+// the atomic counter
+static tb_atomic_t          g_atomic = 0;
+
+// the per-cpu counter
+static tb_percpu_counter_t  g_counter;
+
+// the add count of each thread
+static tb_size_t            g_loop = 0;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+static tb_int_t tb_demo_counter_adder(tb_cpointer_t priv)
+{
+    tb_size_t n = g_loop;
+    if (g_percpu)
+    {
+        while (n--) tb_percpu_counter_add(&g_counter, 1);
+    }
+    else
+    {
+        while (n--) tb_atomic_fetch_and_add_explicit(&g_atomic, 1, TB_ATOMIC_RELAXED);
+    }
+    return 0;
+}
+static tb_void_t tb_demo_counter_bench(tb_bool_t percpu, tb_size_t count)
+{
+    // init
+    g_percpu = percpu;
+    g_loop   = TB_DEMO_ADD_COUNT / count;
+    tb_atomic_set(&g_atomic, 0);
+    tb_percpu_counter_set(&g_counter, 0);
+
+    // init the adder threads
+    tb_size_t       i = 0;
+    tb_thread_ref_t adders[TB_DEMO_THREAD_MAXN] = {0};
+    tb_hong_t       time = tb_mclock();
+    for (i = 0; i < count; i++)
+    {
+        adders[i] = tb_thread_init(tb_null, tb_demo_counter_adder, tb_null, 0);
+        tb_assert_and_check_break(adders[i]);
+    }
+
+    // wait the adder threads
+    for (i = 0; i < count; i++)
+    {
+        if (adders[i])
+        {
+            tb_thread_wait(adders[i], -1, tb_null);
+            tb_thread_exit(adders[i]);
+        }
+    }
+    time = tb_mclock() - time;
+
+    // trace
+    if (percpu)
+    {
+        tb_trace_i("percpu: threads: %lu, %lld ms, %lld adds/s, approx: %lld, sum: %lld", count, time
+            , ((tb_hong_t)g_loop * count * 1000) / tb_max(time, 1), tb_percpu_counter_get(&g_counter), tb_percpu_counter_sum(&g_counter));
+    }
+    else
+    {
+        tb_trace_i("atomic: threads: %lu, %lld ms, %lld adds/s, sum: %ld", count, time
+            , ((tb_hong_t)g_loop * count * 1000) / tb_max(time, 1), tb_atomic_get(&g_atomic));
+    }
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */
+tb_int_t tb_demo_platform_percpu_counter_main(tb_int_t argc, tb_char_t** argv)
+{
+    // init counter
+    tb_percpu_counter_init(&g_counter, 0, 0);
+
+    // bench the add scaling from 1 to 64 threads
+    tb_size_t count = 1;
+    for (count = 1; count <= TB_DEMO_THREAD_MAXN; count <<= 1)
+    {
+        tb_demo_counter_bench(tb_false, count);
+        tb_demo_counter_bench(tb_true, count);
+    }
+
+    // exit counter
+    tb_percpu_counter_exit(&g_counter);
+    return 0;
+}
@@ -0,0 +1,150 @@
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "../demo.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the ping count
+#define TB_DEMO_COUNT       (20000)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * globals
+ */
+
+// the socket pair
+static tb_socket_ref_t  g_pair[2] = {tb_null, tb_null};
+
+// the round-trip times (us)
+static tb_long_t        g_rtts[TB_DEMO_COUNT];
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+static tb_bool_t tb_demo_poller_echo(tb_socket_ref_t sock, tb_long_t events)
+{
+    // the connection has been closed?
+    tb_check_return_val(!(events & TB_POLLER_EVENT_EOF), tb_false);
+
+    // echo all received data
+    tb_byte_t data[256];
+    while (1)
+    {
+        tb_long_t real = tb_socket_recv(sock, data, sizeof(data));
+        if (real > 0)
+        {
+            if (!tb_socket_bsend(sock, data, real)) return tb_false;
+        }
+        else return !real;
+    }
+    return tb_true;
+}
+static tb_void_t tb_demo_poller_event(tb_poller_ref_t poller, tb_poller_object_ref_t object, tb_long_t events, tb_cpointer_t priv)
+{
+    // echo it, stop the poller if the connection has been closed
+    if (!tb_demo_poller_echo(object->ref.sock, events)) tb_poller_kill(poller);
+}
+static tb_void_t tb_demo_poller_events(tb_poller_ref_t poller, tb_poller_event_ref_t events, tb_size_t count)
+{
+    // handle all events, we can also prefetch the private data of all events first here
+    tb_size_t i = 0;
+    for (i = 0; i < count; i++)
+    {
+        if (!tb_demo_poller_echo(events[i].object.ref.sock, events[i].events))
+            tb_poller_kill(poller);
+    }
+}
+static tb_int_t tb_demo_poller_loop(tb_cpointer_t priv)
+{
+    // get the mode
+    tb_size_t mode = (tb_size_t)priv;
+
+    // init poller
+    tb_poller_ref_t poller = tb_poller_init(tb_null);
+    if (poller)
+    {
+        // enable busy-polling
+        if (mode & 0xffff) tb_poller_busypoll(poller, mode & 0xffff);
+
+        // insert the echo socket
+        if (tb_poller_insert_sock(poller, g_pair[1], TB_POLLER_EVENT_RECV | TB_POLLER_EVENT_CLEAR, tb_null))
+        {
+            // wait events
+            if (mode & 0x10000)
+            {
+                while (tb_poller_wait_batch(poller, tb_demo_poller_events, -1) >= 0) ;
+            }
+            else
+            {
+                while (tb_poller_wait(poller, tb_demo_poller_event, -1) >= 0) ;
+            }
+        }
+
+        // exit poller
+        tb_poller_exit(poller);
+    }
+    return 0;
+}
+static tb_void_t tb_demo_poller_latency(tb_size_t busypoll, tb_bool_t batch)
+{
+    // init socket pair
+    if (!tb_socket_pair(TB_SOCKET_TYPE_TCP, g_pair)) return ;
+
+    // init the echo thread
+    tb_size_t       mode = busypoll | (batch? 0x10000 : 0);
+    tb_thread_ref_t thread = tb_thread_init(tb_null, tb_demo_poller_loop, (tb_cpointer_t)mode, 0);
+    if (thread)
+    {
+        // ping-pong
+        tb_size_t i = 0;
+        tb_byte_t data = 'p';
+        for (i = 0; i < TB_DEMO_COUNT; i++)
+        {
+            tb_hong_t time = tb_uclock();
+            if (!tb_socket_bsend(g_pair[0], &data, 1)) break;
+            if (!tb_socket_brecv(g_pair[0], &data, 1)) break;
+            g_rtts[i] = (tb_long_t)(tb_uclock() - time);
+        }
+
+        // close the connection to stop the echo thread
+        tb_socket_exit(g_pair[0]);
+        g_pair[0] = tb_null;
+
+        // wait the echo thread
+        tb_thread_wait(thread, -1, tb_null);
+        tb_thread_exit(thread);
+
+        // compute the percentiles
+        if (i)
+        {
+            tb_array_iterator_t array_iterator;
+            tb_sort_all(tb_array_iterator_init_long(&array_iterator, g_rtts, i), tb_null);
+            tb_trace_i("busypoll: %lu us, batch: %d, count: %lu, p50: %ld us, p99: %ld us, max: %ld us"
+                , busypoll, batch, i, g_rtts[i >> 1], g_rtts[(i * 99) / 100], g_rtts[i - 1]);
+        }
+    }
+
+    // exit socket pair
+    if (g_pair[0]) tb_socket_exit(g_pair[0]);
+    if (g_pair[1]) tb_socket_exit(g_pair[1]);
+    g_pair[0] = tb_null;
+    g_pair[1] = tb_null;
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */
+tb_int_t tb_demo_platform_poller_latency_main(tb_int_t argc, tb_char_t** argv)
+{
+    // the busy-polling time (us), e.g. demo poller_latency 50
+    tb_size_t busypoll = argc > 1 && argv[1]? tb_atoi(argv[1]) : 50;
+
+    // measure the round-trip latency
+    tb_demo_poller_latency(0, tb_false);
+    tb_demo_poller_latency(0, tb_true);
+    tb_demo_poller_latency(busypoll, tb_false);
+    tb_demo_poller_latency(busypoll, tb_true);
+    return 0;
+}
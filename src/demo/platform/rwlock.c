@@ -0,0 +1,226 @@
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "../demo.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the reader threads maxn
+#define TB_DEMO_THREAD_MAXN     (64)
+
+// the total read count of all reader threads
+#define TB_DEMO_READ_COUNT      (8000000)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the lock type
+typedef enum __tb_demo_lock_type_e
+{
+    TB_DEMO_LOCK_TYPE_MUTEX     = 0
+,   TB_DEMO_LOCK_TYPE_RWLOCK    = 1
+,   TB_DEMO_LOCK_TYPE_SEQLOCK   = 2
+
+}tb_demo_lock_type_e;
+
+// the shared snapshot type
+typedef struct __tb_demo_snapshot_t
+{
+    tb_size_t           a;
+    tb_size_t           b;
+    tb_size_t           c;
+    tb_size_t           d;
+
+}tb_demo_snapshot_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * globals
+ */
+
+// the lock type
+static tb_size_t            g_type = TB_DEMO_LOCK_TYPE_MUTEX;
+
+// the mutex
+static tb_mutex_ref_t       g_mutex = tb_null;
+
+// the rwlock
+static tb_rwlock_ref_t      g_rwlock = tb_null;
+
+// the seqlock
+static tb_seqlock_t         g_seqlock = TB_SEQLOCK_INIT;
+
+// the shared snapshot
+static tb_demo_snapshot_t   g_snapshot = {0};
+
+// the read count of each thread
+static tb_size_t            g_loop = 0;
+
+// the broken snapshots count
+static tb_atomic_t          g_broken = 0;
+
+// is stopped?
+static tb_atomic32_t        g_stop = 0;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+static tb_void_t tb_demo_lock_read(tb_demo_snapshot_t* snapshot)
+{
+    switch (g_type)
+    {
+    case TB_DEMO_LOCK_TYPE_MUTEX:
+        tb_mutex_enter(g_mutex);
+        *snapshot = g_snapshot;
+        tb_mutex_leave(g_mutex);
+        break;
+    case TB_DEMO_LOCK_TYPE_RWLOCK:
+        tb_rwlock_enter_read(g_rwlock);
+        *snapshot = g_snapshot;
+        tb_rwlock_leave_read(g_rwlock);
+        break;
+    default:
+        {
+            tb_size_t seq;
+            do
+            {
+                seq = tb_seqlock_read_begin(&g_seqlock);
+                *snapshot = g_snapshot;
+
+            } while (tb_seqlock_read_retry(&g_seqlock, seq));
+        }
+        break;
+    }
+}
+static tb_void_t tb_demo_lock_write()
+{
+    switch (g_type)
+    {
+    case TB_DEMO_LOCK_TYPE_MUTEX:
+        tb_mutex_enter(g_mutex);
+        break;
+    case TB_DEMO_LOCK_TYPE_RWLOCK:
+        tb_rwlock_enter_write(g_rwlock);
+        break;
+    default:
+        tb_seqlock_write_enter(&g_seqlock);
+        break;
+    }
+
+    // update the snapshot
+    g_snapshot.a++;
+    g_snapshot.b = g_snapshot.a + 1;
+    g_snapshot.c = g_snapshot.a + 2;
+    g_snapshot.d = g_snapshot.a + 3;
+
+    switch (g_type)
+    {
+    case TB_DEMO_LOCK_TYPE_MUTEX:
+        tb_mutex_leave(g_mutex);
+        break;
+    case TB_DEMO_LOCK_TYPE_RWLOCK:
+        tb_rwlock_leave_write(g_rwlock);
+        break;
+    default:
+        tb_seqlock_write_leave(&g_seqlock);
+        break;
+    }
+}
+static tb_int_t tb_demo_lock_reader(tb_cpointer_t priv)
+{
+    // read the snapshot and check it
+    tb_size_t           n = g_loop;
+    tb_demo_snapshot_t  snapshot;
+    while (n--)
+    {
+        tb_demo_lock_read(&snapshot);
+        if (snapshot.b != snapshot.a + 1 || snapshot.d != snapshot.a + 3)
+            tb_atomic_fetch_and_add(&g_broken, 1);
+    }
+    return 0;
+}
+static tb_int_t tb_demo_lock_writer(tb_cpointer_t priv)
+{
+    // update the snapshot every 1ms
+    while (!tb_atomic32_get(&g_stop))
+    {
+        tb_demo_lock_write();
+        tb_msleep(1);
+    }
+    return 0;
+}
+static tb_void_t tb_demo_lock_bench(tb_size_t type, tb_size_t count)
+{
+    // init
+    g_type  = type;
+    g_loop  = TB_DEMO_READ_COUNT / count;
+    tb_atomic_set(&g_broken, 0);
+    tb_atomic32_set(&g_stop, 0);
+
+    // init the writer thread
+    tb_thread_ref_t writer = tb_thread_init(tb_null, tb_demo_lock_writer, tb_null, 0);
+
+    // init the reader threads
+    tb_size_t       i = 0;
+    tb_thread_ref_t readers[TB_DEMO_THREAD_MAXN] = {0};
+    tb_hong_t       time = tb_mclock();
+    for (i = 0; i < count; i++)
+    {
+        readers[i] = tb_thread_init(tb_null, tb_demo_lock_reader, tb_null, 0);
+        tb_assert_and_check_break(readers[i]);
+    }
+
+    // wait the reader threads
+    for (i = 0; i < count; i++)
+    {
+        if (readers[i])
+        {
+            tb_thread_wait(readers[i], -1, tb_null);
+            tb_thread_exit(readers[i]);
+        }
+    }
+    time = tb_mclock() - time;
+
+    // exit the writer thread
+    tb_atomic32_set(&g_stop, 1);
+    if (writer)
+    {
+        tb_thread_wait(writer, -1, tb_null);
+        tb_thread_exit(writer);
+    }
+
+    // trace
+    static tb_char_t const* s_names[] = {"mutex", "rwlock", "seqlock"};
+    tb_trace_i("%s: readers: %lu, %lld ms, %lld reads/s, broken: %ld", s_names[type], count, time
+        , ((tb_hong_t)g_loop * count * 1000) / tb_max(time, 1), tb_atomic_get(&g_broken));
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */
+tb_int_t tb_demo_platform_rwlock_main(tb_int_t argc, tb_char_t** argv)
+{
+    // init locks
+    g_mutex     = tb_mutex_init();
+    g_rwlock    = tb_rwlock_init();
+    if (g_mutex && g_rwlock)
+    {
+        // bench the read scaling from 1 to 64 reader threads with one writer thread
+        tb_size_t count = 1;
+        for (count = 1; count <= TB_DEMO_THREAD_MAXN; count <<= 1)
+        {
+            tb_demo_lock_bench(TB_DEMO_LOCK_TYPE_MUTEX, count);
+            tb_demo_lock_bench(TB_DEMO_LOCK_TYPE_RWLOCK, count);
+            tb_demo_lock_bench(TB_DEMO_LOCK_TYPE_SEQLOCK, count);
+        }
+    }
+
+    // exit locks
+    if (g_mutex) tb_mutex_exit(g_mutex);
+    if (g_rwlock) tb_rwlock_exit(g_rwlock);
+    g_mutex     = tb_null;
+    g_rwlock    = tb_null;
+    return 0;
+}
@@ -0,0 +1,223 @@
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "../demo.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the tasks count
+#define TB_DEMO_TASK_COUNT      (10000000)
+
+// the posted tasks count at once
+#define TB_DEMO_TASK_BATCH      (1024)
+
+// the fanout of the spawned tasks
+#define TB_DEMO_TASK_FANOUT     (10)
+
+// the depth of the spawned tasks, 11111111 tasks
+#define TB_DEMO_TASK_DEPTH      (7)
+
+// the tasks count for measuring the wake-up latency of the idle workers
+#define TB_DEMO_TASK_LATENCY    (1000)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * globals
+ */
+
+// the thread pool
+static tb_thread_pool_ref_t     g_pool = tb_null;
+
+// the finished tasks count
+static tb_atomic_t              g_count = 0;
+
+// the urgent task time
+static tb_atomic64_t            g_urgent_time = 0;
+
+// the finished tasks count before running the urgent task
+static tb_atomic_t              g_urgent_count = 0;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+static tb_void_t tb_demo_task_done(tb_thread_pool_worker_ref_t worker, tb_cpointer_t priv)
+{
+    tb_atomic_fetch_and_add_explicit(&g_count, 1, TB_ATOMIC_RELAXED);
+}
+static tb_void_t tb_demo_task_spawn(tb_thread_pool_worker_ref_t worker, tb_cpointer_t priv)
+{
+    // spawn the child tasks from the worker, they will be pushed to the local deque
+    tb_size_t depth = (tb_size_t)priv;
+    if (depth)
+    {
+        tb_size_t i = 0;
+        for (i = 0; i < TB_DEMO_TASK_FANOUT; i++)
+            tb_thread_pool_task_post(g_pool, tb_null, tb_demo_task_spawn, tb_null, (tb_cpointer_t)(depth - 1), tb_false);
+    }
+    tb_atomic_fetch_and_add_explicit(&g_count, 1, TB_ATOMIC_RELAXED);
+}
+static tb_void_t tb_demo_task_urgent(tb_thread_pool_worker_ref_t worker, tb_cpointer_t priv)
+{
+    tb_atomic64_set(&g_urgent_time, tb_uclock());
+    tb_atomic_set(&g_urgent_count, tb_atomic_get(&g_count));
+}
+static tb_void_t tb_demo_task_latency(tb_thread_pool_worker_ref_t worker, tb_cpointer_t priv)
+{
+    tb_atomic64_set(&g_urgent_time, tb_tsc_clock());
+}
+static tb_void_t tb_demo_task_wait(tb_size_t count)
+{
+    while ((tb_size_t)tb_atomic_get(&g_count) < count) tb_msleep(1);
+}
+static tb_void_t tb_demo_thread_pool_post()
+{
+    // init tasks
+    tb_size_t i = 0;
+    tb_thread_pool_task_t tasks[TB_DEMO_TASK_BATCH];
+    tb_memset(tasks, 0, sizeof(tasks));
+    for (i = 0; i < TB_DEMO_TASK_BATCH; i++) tasks[i].done = tb_demo_task_done;
+
+    // post tasks from the external thread, they will be posted to the injection queue
+    tb_atomic_set(&g_count, 0);
+    tb_hong_t time = tb_mclock();
+    tb_size_t post = 0;
+    while (post < TB_DEMO_TASK_COUNT)
+    {
+        tb_size_t size = tb_min(TB_DEMO_TASK_COUNT - post, TB_DEMO_TASK_BATCH);
+        tb_size_t real = tb_thread_pool_task_post_list(g_pool, tasks, size);
+        if (real < size) tb_sched_yield();
+        post += real;
+    }
+    tb_demo_task_wait(TB_DEMO_TASK_COUNT);
+    time = tb_mclock() - time;
+
+    // trace
+    tb_trace_i("post: %d tasks, workers: %lu, %lld ms, %lld tasks/s", TB_DEMO_TASK_COUNT, tb_thread_pool_worker_size(g_pool), time, ((tb_hong_t)TB_DEMO_TASK_COUNT * 1000) / tb_max(time, 1));
+}
+static tb_void_t tb_demo_thread_pool_spawn()
+{
+    // the total tasks count
+    tb_size_t i = 0;
+    tb_size_t n = 1;
+    tb_size_t total = 0;
+    for (i = 0; i <= TB_DEMO_TASK_DEPTH; i++, n *= TB_DEMO_TASK_FANOUT) total += n;
+
+    // spawn tasks from the workers
+    tb_atomic_set(&g_count, 0);
+    tb_hong_t time = tb_mclock();
+    tb_thread_pool_task_post(g_pool, tb_null, tb_demo_task_spawn, tb_null, (tb_cpointer_t)TB_DEMO_TASK_DEPTH, tb_false);
+    tb_demo_task_wait(total);
+    time = tb_mclock() - time;
+
+    // trace
+    tb_trace_i("spawn: %lu tasks, workers: %lu, %lld ms, %lld tasks/s", total, tb_thread_pool_worker_size(g_pool), time, ((tb_hong_t)total * 1000) / tb_max(time, 1));
+}
+static tb_void_t tb_demo_thread_pool_urgent()
+{
+    // post some waiting tasks first
+    tb_size_t i = 0;
+    tb_size_t count = 100000;
+    tb_atomic_set(&g_count, 0);
+    for (i = 0; i < count; i++)
+        tb_thread_pool_task_post(g_pool, tb_null, tb_demo_task_done, tb_null, tb_null, tb_false);
+
+    // post the urgent task, it should be done before most of the waiting tasks
+    tb_long_t done = tb_atomic_get(&g_count);
+    tb_hong_t time = tb_uclock();
+    tb_thread_pool_task_post(g_pool, tb_null, tb_demo_task_urgent, tb_null, tb_null, tb_true);
+    tb_demo_task_wait(count);
+    while (!tb_atomic64_get(&g_urgent_time)) tb_msleep(1);
+
+    // trace
+    tb_trace_i("urgent: %lld us, waiting: %ld, done before it: %ld", tb_atomic64_get(&g_urgent_time) - time, (tb_long_t)count - done, (tb_long_t)tb_atomic_get(&g_urgent_count) - done);
+}
+static tb_void_t tb_demo_thread_pool_latency()
+{
+    // wait all workers to be idle, and post one task each time
+    tb_size_t i = 0;
+    tb_hong_t post = 0;
+    tb_hong_t wake = 0;
+    for (i = 0; i < TB_DEMO_TASK_LATENCY; i++)
+    {
+        tb_msleep(1);
+        tb_atomic64_set(&g_urgent_time, 0);
+        tb_hong_t time = tb_tsc_clock();
+        tb_thread_pool_task_post(g_pool, tb_null, tb_demo_task_latency, tb_null, tb_null, tb_false);
+        post += tb_tsc_clock() - time;
+        while (!tb_atomic64_get(&g_urgent_time)) tb_sched_yield();
+        wake += tb_atomic64_get(&g_urgent_time) - time;
+    }
+
+    // trace
+    tb_trace_i("latency: %d tasks, post: %lld ns, wake: %lld ns", TB_DEMO_TASK_LATENCY, post / TB_DEMO_TASK_LATENCY, wake / TB_DEMO_TASK_LATENCY);
+}
+static tb_void_t tb_demo_thread_pool_group(tb_size_t worker_maxn)
+{
+    // the latency group on the first cpu
+    tb_thread_pool_group_option_t groups[1];
+    tb_memset(groups, 0, sizeof(groups));
+    groups[0].name          = "latency";
+    groups[0].worker_maxn   = 1;
+    TB_CPUSET_SET(0, &groups[0].cpuset);
+
+    // init thread pool with the numa groups and the latency group
+    tb_thread_pool_option_t option;
+    tb_memset(&option, 0, sizeof(option));
+    option.worker_maxn      = worker_maxn;
+    option.numa             = tb_true;
+    option.groups           = groups;
+    option.groups_count     = tb_arrayn(groups);
+    g_pool = tb_thread_pool_init_ext(&option);
+    if (g_pool)
+    {
+        // post some batch tasks to the default group first
+        tb_size_t i = 0;
+        tb_size_t count = 100000;
+        tb_atomic_set(&g_count, 0);
+        tb_atomic64_set(&g_urgent_time, 0);
+        for (i = 0; i < count; i++)
+            tb_thread_pool_task_post(g_pool, tb_null, tb_demo_task_done, tb_null, tb_null, tb_false);
+
+        // post the latency task to the latency group, it need not wait for the batch tasks
+        tb_long_t done = tb_atomic_get(&g_count);
+        tb_hong_t time = tb_uclock();
+        tb_thread_pool_task_post_group(g_pool, tb_thread_pool_group(g_pool, "latency"), tb_null, tb_demo_task_urgent, tb_null, tb_null, tb_false);
+        tb_demo_task_wait(count);
+        while (!tb_atomic64_get(&g_urgent_time)) tb_msleep(1);
+
+        // trace
+        tb_trace_i("group: %lld us, numa: %lu, waiting: %ld, done before it: %ld", tb_atomic64_get(&g_urgent_time) - time, tb_cpu_numa_count(), (tb_long_t)count - done, (tb_long_t)tb_atomic_get(&g_urgent_count) - done);
+
+        // exit thread pool
+        tb_thread_pool_exit(g_pool);
+        g_pool = tb_null;
+    }
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */
+tb_int_t tb_demo_platform_thread_pool_perf_main(tb_int_t argc, tb_char_t** argv)
+{
+    // the workers count, e.g. demo platform_thread_pool_perf 64
+    tb_size_t worker_maxn = argc > 1 && argv[1]? tb_atoi(argv[1]) : 0;
+
+    // init thread pool
+    g_pool = tb_thread_pool_init(worker_maxn, 0);
+    if (g_pool)
+    {
+        tb_demo_thread_pool_post();
+        tb_demo_thread_pool_spawn();
+        tb_demo_thread_pool_urgent();
+        tb_demo_thread_pool_latency();
+
+        // exit thread pool
+        tb_thread_pool_exit(g_pool);
+        g_pool = tb_null;
+    }
+
+    // run the latency tasks in the separate worker group
+    tb_demo_thread_pool_group(worker_maxn);
+    return 0;
+}
@@ -0,0 +1,117 @@
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "../../demo.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+static tb_void_t tb_demo_stream_file_copy(tb_char_t const* name, tb_char_t const* ipath, tb_char_t const* opath, tb_size_t mode, tb_size_t readahead, tb_size_t writebehind)
+{
+    // init streams
+    tb_stream_ref_t istream = tb_stream_init_from_file(ipath, TB_FILE_MODE_RO | mode);
+    tb_stream_ref_t ostream = tb_stream_init_from_file(opath, TB_FILE_MODE_WO | TB_FILE_MODE_CREAT | TB_FILE_MODE_TRUNC | mode);
+    if (istream && ostream)
+    {
+        // enable the read-ahead and write-behind blocks
+        if (readahead) tb_stream_ctrl(istream, TB_STREAM_CTRL_FILE_SET_READAHEAD, readahead);
+        if (writebehind) tb_stream_ctrl(ostream, TB_STREAM_CTRL_FILE_SET_WRITEBEHIND, writebehind);
+
+        // transfer it
+        tb_hong_t time = tb_mclock();
+        tb_hong_t save = tb_transfer(istream, ostream, 0, tb_null, tb_null);
+        tb_stream_clos(ostream);
+        time = tb_max(tb_mclock() - time, 1);
+
+        // trace
+        tb_trace_i("%s: save: %lld bytes, %lld ms, %lld MB/s", name, save, time, ((save * 1000) / time) >> 20);
+    }
+
+    // exit streams
+    if (istream) tb_stream_exit(istream);
+    if (ostream) tb_stream_exit(ostream);
+}
+static tb_bool_t tb_demo_stream_file_writ(tb_stream_ref_t stream, tb_byte_t const* data, tb_size_t size)
+{
+    // writ it with the random pieces
+    while (size)
+    {
+        tb_size_t need = (tb_size_t)tb_random_range(1, 100000);
+        need = tb_min(need, size);
+        if (!tb_stream_bwrit(stream, data, need)) return tb_false;
+        data += need;
+        size -= need;
+    }
+    return tb_true;
+}
+static tb_void_t tb_demo_stream_file_verify(tb_char_t const* name, tb_char_t const* path, tb_size_t mode)
+{
+    // make data
+    tb_size_t   size = 8 << 20;
+    tb_byte_t*  data = tb_malloc_bytes(size);
+    tb_byte_t*  read = tb_malloc_bytes(size);
+    tb_assert_and_check_return(data && read);
+    tb_size_t i = 0;
+    for (i = 0; i < size; i++) data[i] = (tb_byte_t)tb_random_value();
+
+    // init stream
+    tb_bool_t       ok = tb_false;
+    tb_stream_ref_t stream = tb_stream_init_from_file(path, TB_FILE_MODE_WO | TB_FILE_MODE_CREAT | TB_FILE_MODE_TRUNC | mode);
+    if (stream && tb_stream_ctrl(stream, TB_STREAM_CTRL_FILE_SET_WRITEBEHIND, 8) && tb_stream_open(stream))
+    {
+        /* writ it from the unaligned offsets with the blocks in flight,
+         * and extend the file from the unaligned offsets after syncing the first byte
+         */
+        tb_size_t head = (size >> 1) + 1234;
+        ok = tb_stream_bwrit(stream, data, 1) && tb_stream_sync(stream, tb_false) && tb_demo_stream_file_writ(stream, data + 1, head - 1);
+        for (i = 0; ok && i < 16; i++)
+        {
+            tb_size_t offset = (tb_size_t)tb_random_range(1, head);
+            tb_size_t need = (tb_size_t)tb_random_range(1, 3 << 20);
+            need = tb_min(need, head - offset);
+            ok = tb_stream_seek(stream, offset) && tb_demo_stream_file_writ(stream, data + offset, need);
+        }
+        if (ok) ok = tb_stream_seek(stream, head) && tb_demo_stream_file_writ(stream, data + head, size - head);
+        if (!tb_stream_clos(stream)) ok = tb_false;
+    }
+    if (stream) tb_stream_exit(stream);
+
+    // verify the file contents
+    tb_file_ref_t file = ok? tb_file_init(path, TB_FILE_MODE_RO) : tb_null;
+    if (file)
+    {
+        ok = tb_file_size(file) == size && tb_file_read(file, read, size) == (tb_long_t)size && !tb_memcmp(data, read, size);
+        tb_file_exit(file);
+    }
+
+    // trace
+    tb_trace_i("%s: verify: %lu bytes, ok: %d", name, size, ok);
+
+    // exit data
+    tb_free(data);
+    tb_free(read);
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */
+tb_int_t tb_demo_stream_file_main(tb_int_t argc, tb_char_t** argv)
+{
+    // check
+    tb_assert_and_check_return_val(argc == 3 && argv[1] && argv[2], -1);
+
+    // copy the large file with the blocking reads and writes, the read-ahead and the write-behind
+    tb_demo_stream_file_copy("sync", argv[1], argv[2], 0, 0, 0);
+    tb_demo_stream_file_copy("readahead", argv[1], argv[2], 0, 8, 0);
+    tb_demo_stream_file_copy("writebehind", argv[1], argv[2], 0, 0, 8);
+    tb_demo_stream_file_copy("both", argv[1], argv[2], 0, 8, 8);
+
+    // copy it without the page cache
+    tb_demo_stream_file_copy("direct", argv[1], argv[2], TB_FILE_MODE_DIRECT, 0, 0);
+    tb_demo_stream_file_copy("direct_both", argv[1], argv[2], TB_FILE_MODE_DIRECT, 8, 8);
+
+    // writ the blocks from the unaligned offsets and verify the file contents
+    tb_demo_stream_file_verify("writebehind", argv[2], 0);
+    tb_demo_stream_file_verify("direct_writebehind", argv[2], TB_FILE_MODE_DIRECT);
+    return 0;
+}
@@ -0,0 +1,247 @@
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "../../demo.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the fuzz count
+#define TB_DEMO_LZ4_FUZZ_COUNT      (200)
+
+// the bench size
+#define TB_DEMO_LZ4_BENCH_SIZE      (32 << 20)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+#ifdef TB_CONFIG_MODULE_HAVE_ZIP
+static tb_long_t tb_demo_lz4_spak(tb_size_t algo, tb_size_t action, tb_byte_t* idata, tb_size_t isize, tb_byte_t* odata, tb_size_t omaxn, tb_bool_t chunked)
+{
+    // init zip
+    tb_zip_ref_t zip = tb_zip_init(algo, action);
+    tb_assert_and_check_return_val(zip, -1);
+
+    // spak it with the random input and output chunks
+    tb_size_t ipos = 0;
+    tb_size_t opos = 0;
+    tb_long_t ok = -1;
+    while (1)
+    {
+        // the input and output chunks
+        tb_size_t in = isize - ipos;
+        tb_size_t on = omaxn - opos;
+        if (chunked)
+        {
+            tb_size_t ichunk = (tb_size_t)tb_random_range(0, 70000);
+            tb_size_t ochunk = (tb_size_t)tb_random_range(1, 70000);
+            in = tb_min(in, ichunk);
+            on = tb_min(on, ochunk);
+        }
+        if (!on) break;
+
+        // spak it
+        tb_static_stream_t ist;
+        tb_static_stream_t ost;
+        tb_static_stream_init(&ist, idata + ipos, in);
+        tb_static_stream_init(&ost, odata + opos, on);
+        tb_long_t real = tb_zip_spak(zip, &ist, &ost, ipos + in == isize? -1 : 0);
+
+        // update it
+        ipos += tb_static_stream_offset(&ist);
+        if (real > 0) opos += real;
+        else if (real < 0 || (!real && ipos == isize && !in))
+        {
+            // end or no more progress, e.g. the gzip inflater will not return -1 if the output data is ended with the input data
+            ok = opos;
+            break;
+        }
+    }
+
+    // exit zip
+    tb_zip_exit(zip);
+    return ok;
+}
+static tb_void_t tb_demo_lz4_make(tb_byte_t* data, tb_size_t size, tb_size_t mode)
+{
+    // the words
+    static tb_char_t const* s_words[] = {"tbox", "stream", "filter", "zip", "lz4", "block", "the ", "data", "\n", " ", "coroutine", "thread"};
+
+    tb_size_t i = 0;
+    switch (mode)
+    {
+    case 0:
+        // random data
+        for (i = 0; i < size; i++) data[i] = (tb_byte_t)tb_random_value();
+        break;
+    case 1:
+        // runs
+        while (i < size)
+        {
+            tb_size_t   n = (tb_size_t)tb_random_range(1, 300);
+            tb_byte_t   b = (tb_byte_t)tb_random_range(0, 4);
+            n = tb_min(n, size - i);
+            tb_memset(data + i, b, n);
+            i += n;
+        }
+        break;
+    default:
+        // text
+        while (i < size)
+        {
+            tb_char_t const*    word = s_words[tb_random_range(0, tb_arrayn(s_words))];
+            tb_size_t           n = tb_min(tb_strlen(word), size - i);
+            tb_memcpy(data + i, word, n);
+            i += n;
+        }
+        break;
+    }
+}
+static tb_void_t tb_demo_lz4_fuzz(tb_noarg_t)
+{
+    // the buffers
+    tb_size_t   maxn = 300000;
+    tb_byte_t*  idata = tb_malloc_bytes(maxn);
+    tb_byte_t*  zdata = tb_malloc_bytes(maxn * 2);
+    tb_byte_t*  odata = tb_malloc_bytes(maxn);
+    tb_assert_and_check_return(idata && zdata && odata);
+
+    // fuzz it
+    tb_size_t i = 0;
+    tb_size_t failed = 0;
+    for (i = 0; i < TB_DEMO_LZ4_FUZZ_COUNT; i++)
+    {
+        // make data
+        tb_size_t size = (tb_size_t)tb_random_range(0, (i & 7)? maxn : 32);
+        tb_demo_lz4_make(idata, size, i % 3);
+
+        // deflate and inflate it
+        tb_size_t algo = (i & 1)? TB_ZIP_ALGO_LZ4HC : TB_ZIP_ALGO_LZ4;
+        tb_long_t zsize = tb_demo_lz4_spak(algo, TB_ZIP_ACTION_DEFLATE, idata, size, zdata, maxn * 2, tb_true);
+        tb_long_t osize = zsize >= 0? tb_demo_lz4_spak(algo, TB_ZIP_ACTION_INFLATE, zdata, zsize, odata, maxn, tb_true) : -1;
+
+        // ok?
+        if (osize != (tb_long_t)size || (size && tb_memcmp(idata, odata, size)))
+        {
+            tb_trace_e("fuzz[%lu]: failed, algo: %lu, size: %lu, zsize: %ld, osize: %ld", i, algo, size, zsize, osize);
+            failed++;
+        }
+    }
+
+    // trace
+    tb_trace_i("fuzz: %lu rounds, failed: %lu", (tb_size_t)TB_DEMO_LZ4_FUZZ_COUNT, failed);
+
+    // exit buffers
+    tb_free(idata);
+    tb_free(zdata);
+    tb_free(odata);
+}
+static tb_void_t tb_demo_lz4_linked(tb_noarg_t)
+{
+    // the buffers
+    tb_size_t   size = 6 << 20;
+    tb_size_t   maxn = size + (size >> 4);
+    tb_byte_t*  idata = tb_malloc_bytes(size);
+    tb_byte_t*  zdata = tb_malloc_bytes(maxn);
+    tb_byte_t*  odata = tb_malloc_bytes(maxn);
+    tb_assert_and_check_return(idata && zdata && odata);
+
+    // deflate it, the independent 64K blocks are also valid linked blocks
+    tb_demo_lz4_make(idata, size, 2);
+    tb_long_t zsize = tb_demo_lz4_spak(TB_ZIP_ALGO_LZ4, TB_ZIP_ACTION_DEFLATE, idata, size, zdata, maxn, tb_false);
+
+    /* mark the frame as the linked 4M blocks with the content checksum, e.g. lz4 -B7 -BD,
+     * and inflate it in one call, the output buffer will be grown after parsing the frame header
+     */
+    tb_long_t osize = -1;
+    if (zsize > 7 && zdata[4] == 0x64 && zdata[5] == 0x40)
+    {
+        zdata[4] = 0x44;
+        zdata[5] = 0x70;
+        zdata[6] = 0x1d;
+        osize = tb_demo_lz4_spak(TB_ZIP_ALGO_LZ4, TB_ZIP_ACTION_INFLATE, zdata, zsize, odata, maxn, tb_false);
+    }
+
+    // trace
+    tb_trace_i("linked: 4M blocks, size: %lu, zsize: %ld, ok: %d", size, zsize, osize == (tb_long_t)size && !tb_memcmp(idata, odata, size));
+
+    // exit buffers
+    tb_free(idata);
+    tb_free(zdata);
+    tb_free(odata);
+}
+static tb_void_t tb_demo_lz4_bench(tb_char_t const* name, tb_size_t algo, tb_byte_t* idata, tb_size_t isize, tb_byte_t* zdata, tb_byte_t* odata, tb_size_t maxn)
+{
+    // deflate it
+    tb_hong_t time = tb_mclock();
+    tb_long_t zsize = tb_demo_lz4_spak(algo, TB_ZIP_ACTION_DEFLATE, idata, isize, zdata, maxn, tb_false);
+    tb_hong_t dtime = tb_max(tb_mclock() - time, 1);
+    tb_assert_and_check_return(zsize > 0);
+
+    // inflate it
+    time = tb_mclock();
+    tb_long_t osize = tb_demo_lz4_spak(algo, TB_ZIP_ACTION_INFLATE, zdata, zsize, odata, maxn, tb_false);
+    tb_hong_t itime = tb_max(tb_mclock() - time, 1);
+
+    // trace
+    tb_trace_i("%s: ratio: %ld%%, deflate: %lld MB/s, inflate: %lld MB/s, ok: %d", name
+        , (zsize * 100) / isize, ((tb_hong_t)isize * 1000 / dtime) >> 20, ((tb_hong_t)isize * 1000 / itime) >> 20
+        , osize == (tb_long_t)isize && !tb_memcmp(idata, odata, isize));
+}
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */
+#ifdef TB_CONFIG_MODULE_HAVE_ZIP
+tb_int_t tb_demo_stream_lz4_main(tb_int_t argc, tb_char_t** argv)
+{
+    // deflate or inflate the file with the lz4 frame format, e.g. lz4 infile outfile [-d]
+    if (argc > 2)
+    {
+        tb_bool_t       inflate = argc > 3 && !tb_strcmp(argv[3], "-d");
+        tb_stream_ref_t istream = tb_stream_init_from_url(argv[1]);
+        tb_stream_ref_t fstream = istream? tb_stream_init_filter_from_zip(istream, TB_ZIP_ALGO_LZ4, inflate? TB_ZIP_ACTION_INFLATE : TB_ZIP_ACTION_DEFLATE) : tb_null;
+        if (fstream)
+        {
+            tb_hong_t save = tb_transfer_to_url(fstream, argv[2], 0, tb_null, tb_null);
+            tb_trace_i("save: %lld bytes, size: %lld bytes", save, tb_stream_size(istream));
+        }
+        if (fstream) tb_stream_exit(fstream);
+        if (istream) tb_stream_exit(istream);
+        return 0;
+    }
+
+    // fuzz the round trip
+    tb_demo_lz4_fuzz();
+
+    // inflate the linked large blocks
+    tb_demo_lz4_linked();
+
+    // bench it
+    tb_size_t   size = TB_DEMO_LZ4_BENCH_SIZE;
+    tb_size_t   maxn = size + (size >> 4);
+    tb_byte_t*  idata = tb_malloc_bytes(size);
+    tb_byte_t*  zdata = tb_malloc_bytes(maxn);
+    tb_byte_t*  odata = tb_malloc_bytes(maxn);
+    if (idata && zdata && odata)
+    {
+        tb_demo_lz4_make(idata, size, 2);
+        tb_demo_lz4_bench("lz4", TB_ZIP_ALGO_LZ4, idata, size, zdata, odata, maxn);
+        tb_demo_lz4_bench("lz4hc", TB_ZIP_ALGO_LZ4HC, idata, size, zdata, odata, maxn);
+#ifdef TB_CONFIG_PACKAGE_HAVE_ZLIB
+        tb_demo_lz4_bench("gzip", TB_ZIP_ALGO_GZIP, idata, size, zdata, odata, maxn);
+#endif
+    }
+    if (idata) tb_free(idata);
+    if (zdata) tb_free(zdata);
+    if (odata) tb_free(odata);
+    return 0;
+}
+#else
+tb_int_t tb_demo_stream_lz4_main(tb_int_t argc, tb_char_t** argv)
+{
+    return 0;
+}
+#endif
@@ -0,0 +1,51 @@
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "../../demo.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+static tb_void_t tb_demo_stream_mmap_peek(tb_char_t const* name, tb_stream_ref_t stream)
+{
+    // check
+    tb_assert_and_check_return(stream);
+
+    // peek all data and compute the checksum
+    tb_hong_t   time = tb_mclock();
+    tb_hize_t   size = 0;
+    tb_size_t   sum = 0;
+    tb_byte_t*  data = tb_null;
+    if (tb_stream_open(stream))
+    {
+        tb_long_t real = 0;
+        while ((real = tb_stream_peek(stream, &data, TB_STREAM_BLOCK_MAXN)) > 0)
+        {
+            tb_long_t i = 0;
+            for (i = 0; i < real; i++) sum += data[i];
+            if (!tb_stream_skip(stream, real)) break;
+            size += real;
+        }
+    }
+    time = tb_mclock() - time;
+
+    // trace
+    tb_trace_i("%s: peek: %llu bytes, sum: %lu, %lld ms", name, size, sum, time);
+
+    // exit stream
+    tb_stream_exit(stream);
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */
+tb_int_t tb_demo_stream_mmap_main(tb_int_t argc, tb_char_t** argv)
+{
+    // check
+    tb_assert_and_check_return_val(argc == 2 && argv[1], -1);
+
+    // peek file with the stream cache and the mapped file
+    tb_demo_stream_mmap_peek("file", tb_stream_init_from_file(argv[1], TB_FILE_MODE_RO));
+    tb_demo_stream_mmap_peek("mmap", tb_stream_init_from_mmap(argv[1], TB_FILE_MMAP_ADVICE_SEQUENTIAL));
+    return 0;
+}
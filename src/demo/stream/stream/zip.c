@@ -3,12 +3,53 @@
  */
 #include "../../demo.h"
 
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+#ifdef TB_CONFIG_MODULE_HAVE_ZIP
+static tb_void_t tb_demo_stream_zip_bench(tb_char_t const* iurl, tb_char_t const* ourl, tb_size_t parallel)
+{
+    // init stream
+    tb_stream_ref_t istream = tb_stream_init_from_url(iurl);
+    tb_stream_ref_t ostream = tb_stream_init_from_file(ourl, TB_FILE_MODE_RW | TB_FILE_MODE_CREAT | TB_FILE_MODE_TRUNC);
+    tb_stream_ref_t fstream = istream? tb_stream_init_filter_from_zip(istream, TB_ZIP_ALGO_GZIP, TB_ZIP_ACTION_DEFLATE) : tb_null;
+    if (istream && ostream && fstream)
+    {
+        // deflate blocks in parallel?
+        tb_filter_ref_t filter = tb_null;
+        if (parallel && tb_stream_ctrl(fstream, TB_STREAM_CTRL_FLTR_GET_FILTER, &filter) && filter)
+            tb_filter_ctrl(filter, TB_FILTER_CTRL_ZIP_SET_PARALLEL, parallel);
+
+        // deflate it
+        tb_hong_t time = tb_mclock();
+        tb_hong_t save = tb_transfer(fstream, ostream, 0, tb_null, tb_null);
+        time = tb_mclock() - time;
+
+        // trace
+        tb_trace_i("%s: save: %lld bytes, size: %lld bytes, time: %lld ms", parallel? "parallel" : "serial", save, tb_stream_size(istream), time);
+    }
+
+    // exit stream
+    if (fstream) tb_stream_exit(fstream);
+    if (istream) tb_stream_exit(istream);
+    if (ostream) tb_stream_exit(ostream);
+}
+#endif
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * main
  */
 #ifdef TB_CONFIG_MODULE_HAVE_ZIP
 tb_int_t tb_demo_stream_zip_main(tb_int_t argc, tb_char_t** argv)
 {
+    // bench the serial and parallel gzip deflate, e.g. zip infile outfile 131072
+    if (argc > 3)
+    {
+        tb_demo_stream_zip_bench(argv[1], argv[2], 0);
+        tb_demo_stream_zip_bench(argv[1], argv[2], tb_atoi(argv[3]));
+        return 0;
+    }
+
     // init istream
     tb_stream_ref_t istream = tb_stream_init_from_url(argv[1]);
 
@@ -31,25 +31,32 @@ target "demo"
     add_files "platform/file.c"
     add_files "platform/filelock.c"
     add_files "platform/fwatcher.c"
+    add_files "platform/future.c"
+    add_files "platform/futexlock.c"
     add_files "platform/hostname.c"
+    add_files "platform/htimer.c"
     add_files "platform/ifaddrs.c"
     add_files "platform/lock.c"
     add_files "platform/ltimer.c"
     add_files "platform/named_pipe.c"
     add_files "platform/path.c"
+    add_files "platform/percpu_counter.c"
     add_files "platform/pipe_pair.c"
     add_files "platform/poller_client.c"
     add_files "platform/poller_fwatcher.c"
+    add_files "platform/poller_latency.c"
     add_files "platform/poller_pipe.c"
     add_files "platform/poller_process.c"
     add_files "platform/poller_server.c"
     add_files "platform/process.c"
+    add_files "platform/rwlock.c"
     add_files "platform/sched.c"
     add_files "platform/semaphore.c"
     add_files "platform/stdfile.c"
     add_files "platform/thread.c"
     add_files "platform/thread_local.c"
     add_files "platform/thread_pool.c"
+    add_files "platform/thread_pool_perf.c"
     add_files "platform/timer.c"
     add_files "platform/utils.c"
     add_files "container/*.c"
@@ -12,8 +12,14 @@ tb_int_t tb_demo_xml_reader_main(tb_int_t argc, tb_char_t** argv)
     tb_xml_reader_ref_t reader = tb_xml_reader_init();
     if (reader)
     {
+        // init stream, we map the local file to read it without copying
+        tb_stream_ref_t stream = tb_null;
+        if (tb_url_protocol_probe(argv[1]) == TB_URL_PROTOCOL_FILE)
+            stream = tb_stream_init_from_mmap(argv[1], TB_FILE_MMAP_ADVICE_SEQUENTIAL);
+        if (!stream) stream = tb_stream_init_from_url(argv[1]);
+
         // open reader
-        if (tb_xml_reader_open(reader, tb_stream_init_from_url(argv[1]), tb_true))
+        if (tb_xml_reader_open(reader, stream, tb_true))
         {
             // goto
             tb_bool_t ok = tb_true;
@@ -0,0 +1,385 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        utf.c
+ * @ingroup     charset
+ *
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "charset.h"
+#include "../utils/bits.h"
+#ifdef TB_ARCH_SSE2
+#   include <emmintrin.h>
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+
+/* get the utf8 character
+ *
+ * we decode it in the same way as tb_charset_utf8_get(), so the result is always the same as the generic conversion,
+ * but the long, invalid and incomplete characters will be left to the generic conversion.
+ *
+ * @return      the character size or 0
+ */
+static __tb_inline__ tb_size_t tb_charset_utf_utf8_get(tb_byte_t const* p, tb_byte_t const* e, tb_uint32_t* ch)
+{
+    tb_byte_t c = p[0];
+    if (!(c & 0x80))
+    {
+        *ch = c;
+        return 1;
+    }
+    else if ((c & 0xe0) == 0xc0 && e - p > 1)
+    {
+        *ch = ((((tb_uint32_t)(c & 0x1f)) << 6) | (p[1] & 0x3f));
+        return 2;
+    }
+    else if ((c & 0xf0) == 0xe0 && e - p > 2)
+    {
+        *ch = ((((tb_uint32_t)(c & 0x0f)) << 12) | (((tb_uint32_t)(p[1] & 0x3f)) << 6) | (p[2] & 0x3f));
+        return 3;
+    }
+    else if ((c & 0xf8) == 0xf0 && e - p > 3)
+    {
+        *ch = ((((tb_uint32_t)(c & 0x07)) << 18) | (((tb_uint32_t)(p[1] & 0x3f)) << 12) | (((tb_uint32_t)(p[2] & 0x3f)) << 6) | (p[3] & 0x3f));
+        return 4;
+    }
+    return 0;
+}
+
+/* set the utf8 character, it is the same as tb_charset_utf8_set() for the character <= 0x1fffff
+ *
+ * @return      the character size or 0 if no enough space
+ */
+static __tb_inline__ tb_size_t tb_charset_utf_utf8_set(tb_byte_t* q, tb_byte_t const* e, tb_uint32_t ch)
+{
+    tb_size_t n = e - q;
+    if (ch <= 0x7f)
+    {
+        tb_check_return_val(n, 0);
+        q[0] = (tb_byte_t)ch;
+        return 1;
+    }
+    else if (ch <= 0x7ff)
+    {
+        tb_check_return_val(n > 1, 0);
+        q[0] = (tb_byte_t)(((ch >> 6) & 0x1f) | 0xc0);
+        q[1] = (tb_byte_t)((ch & 0x3f) | 0x80);
+        return 2;
+    }
+    else if (ch <= 0xffff)
+    {
+        tb_check_return_val(n > 2, 0);
+        q[0] = (tb_byte_t)(((ch >> 12) & 0x0f) | 0xe0);
+        q[1] = (tb_byte_t)(((ch >> 6) & 0x3f) | 0x80);
+        q[2] = (tb_byte_t)((ch & 0x3f) | 0x80);
+        return 3;
+    }
+    else
+    {
+        tb_check_return_val(n > 3, 0);
+        q[0] = (tb_byte_t)(((ch >> 18) & 0x07) | 0xf0);
+        q[1] = (tb_byte_t)(((ch >> 12) & 0x3f) | 0x80);
+        q[2] = (tb_byte_t)(((ch >> 6) & 0x3f) | 0x80);
+        q[3] = (tb_byte_t)((ch & 0x3f) | 0x80);
+        return 4;
+    }
+}
+static tb_void_t tb_charset_utf_utf8_to_utf16(tb_byte_t const** pp, tb_byte_t const* pe, tb_byte_t** pq, tb_byte_t const* qe, tb_bool_t be)
+{
+    tb_uint32_t         ch;
+    tb_byte_t const*    p = *pp;
+    tb_byte_t*          q = *pq;
+    while (p < pe)
+    {
+#ifdef TB_ARCH_SSE2
+        // convert 16 ascii characters at once
+        if (pe - p >= 16 && qe - q >= 32)
+        {
+            __m128i v = _mm_loadu_si128((__m128i const*)p);
+            if (!_mm_movemask_epi8(v))
+            {
+                __m128i z = _mm_setzero_si128();
+                _mm_storeu_si128((__m128i*)q, be? _mm_unpacklo_epi8(z, v) : _mm_unpacklo_epi8(v, z));
+                _mm_storeu_si128((__m128i*)(q + 16), be? _mm_unpackhi_epi8(z, v) : _mm_unpackhi_epi8(v, z));
+                p += 16;
+                q += 32;
+                continue;
+            }
+        }
+#else
+        // convert 4 ascii characters at once
+        if (pe - p >= 4 && qe - q >= 8 && !(tb_bits_get_u32_ne(p) & 0x80808080))
+        {
+            tb_size_t i = 0;
+            for (i = 0; i < 4; i++, q += 2)
+            {
+                if (be) tb_bits_set_u16_be(q, p[i]);
+                else tb_bits_set_u16_le(q, p[i]);
+            }
+            p += 4;
+            continue;
+        }
+#endif
+
+        // get character
+        tb_size_t n = tb_charset_utf_utf8_get(p, pe, &ch);
+        tb_check_break(n);
+
+        // set character
+        if (ch <= 0xffff || ch > 0x10ffff)
+        {
+            tb_check_break(qe - q > 1);
+            if (ch > 0xffff) ch = 0xfffd;
+            if (be) tb_bits_set_u16_be(q, ch);
+            else tb_bits_set_u16_le(q, ch);
+            q += 2;
+        }
+        else
+        {
+            tb_check_break(qe - q > 3);
+            ch -= 0x10000;
+            if (be)
+            {
+                tb_bits_set_u16_be(q, (ch >> 10) + 0xd800);
+                tb_bits_set_u16_be(q + 2, (ch & 0x3ff) + 0xdc00);
+            }
+            else
+            {
+                tb_bits_set_u16_le(q, (ch >> 10) + 0xd800);
+                tb_bits_set_u16_le(q + 2, (ch & 0x3ff) + 0xdc00);
+            }
+            q += 4;
+        }
+        p += n;
+    }
+    *pp = p;
+    *pq = q;
+}
+static tb_void_t tb_charset_utf_utf8_to_utf32(tb_byte_t const** pp, tb_byte_t const* pe, tb_byte_t** pq, tb_byte_t const* qe, tb_bool_t be)
+{
+    tb_uint32_t         ch;
+    tb_byte_t const*    p = *pp;
+    tb_byte_t*          q = *pq;
+    while (p < pe)
+    {
+#ifdef TB_ARCH_SSE2
+        // convert 16 ascii characters at once
+        if (pe - p >= 16 && qe - q >= 64)
+        {
+            __m128i v = _mm_loadu_si128((__m128i const*)p);
+            if (!_mm_movemask_epi8(v))
+            {
+                __m128i z = _mm_setzero_si128();
+                if (be)
+                {
+                    __m128i l = _mm_unpacklo_epi8(z, v);
+                    __m128i h = _mm_unpackhi_epi8(z, v);
+                    _mm_storeu_si128((__m128i*)q, _mm_unpacklo_epi16(z, l));
+                    _mm_storeu_si128((__m128i*)(q + 16), _mm_unpackhi_epi16(z, l));
+                    _mm_storeu_si128((__m128i*)(q + 32), _mm_unpacklo_epi16(z, h));
+                    _mm_storeu_si128((__m128i*)(q + 48), _mm_unpackhi_epi16(z, h));
+                }
+                else
+                {
+                    __m128i l = _mm_unpacklo_epi8(v, z);
+                    __m128i h = _mm_unpackhi_epi8(v, z);
+                    _mm_storeu_si128((__m128i*)q, _mm_unpacklo_epi16(l, z));
+                    _mm_storeu_si128((__m128i*)(q + 16), _mm_unpackhi_epi16(l, z));
+                    _mm_storeu_si128((__m128i*)(q + 32), _mm_unpacklo_epi16(h, z));
+                    _mm_storeu_si128((__m128i*)(q + 48), _mm_unpackhi_epi16(h, z));
+                }
+                p += 16;
+                q += 64;
+                continue;
+            }
+        }
+#else
+        // convert 4 ascii characters at once
+        if (pe - p >= 4 && qe - q >= 16 && !(tb_bits_get_u32_ne(p) & 0x80808080))
+        {
+            tb_size_t i = 0;
+            for (i = 0; i < 4; i++, q += 4)
+            {
+                if (be) tb_bits_set_u32_be(q, p[i]);
+                else tb_bits_set_u32_le(q, p[i]);
+            }
+            p += 4;
+            continue;
+        }
+#endif
+
+        // get character
+        tb_size_t n = tb_charset_utf_utf8_get(p, pe, &ch);
+        tb_check_break(n && qe - q > 3);
+
+        // set character
+        if (be) tb_bits_set_u32_be(q, ch);
+        else tb_bits_set_u32_le(q, ch);
+        q += 4;
+        p += n;
+    }
+    *pp = p;
+    *pq = q;
+}
+static tb_void_t tb_charset_utf_utf16_to_utf8(tb_byte_t const** pp, tb_byte_t const* pe, tb_byte_t** pq, tb_byte_t const* qe, tb_bool_t be)
+{
+    tb_byte_t const*    p = *pp;
+    tb_byte_t*          q = *pq;
+    while (pe - p > 1)
+    {
+#ifdef TB_ARCH_SSE2
+        // convert 16 ascii characters at once
+        if (pe - p >= 32 && qe - q >= 16)
+        {
+            // the ascii character is 0x00XX, we only need check the masked bits of the native 16-bits lanes
+            __m128i z = _mm_setzero_si128();
+            __m128i m = _mm_set1_epi16(be? (tb_int16_t)0x80ff : (tb_int16_t)0xff80);
+            __m128i l = _mm_loadu_si128((__m128i const*)p);
+            __m128i h = _mm_loadu_si128((__m128i const*)(p + 16));
+            if (_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(_mm_or_si128(l, h), m), z)) == 0xffff)
+            {
+                if (be)
+                {
+                    l = _mm_srli_epi16(l, 8);
+                    h = _mm_srli_epi16(h, 8);
+                }
+                _mm_storeu_si128((__m128i*)q, _mm_packus_epi16(l, h));
+                p += 32;
+                q += 16;
+                continue;
+            }
+        }
+#endif
+
+        // get character
+        tb_size_t   n = 2;
+        tb_uint32_t ch = be? tb_bits_get_u16_be(p) : tb_bits_get_u16_le(p);
+        if (ch >= 0xd800 && ch <= 0xdbff)
+        {
+            // the incomplete surrogate pair? convert it using the generic way
+            tb_check_break(pe - p > 3);
+
+            // the next character
+            tb_uint32_t c2 = be? tb_bits_get_u16_be(p + 2) : tb_bits_get_u16_le(p + 2);
+            if (c2 >= 0xdc00 && c2 <= 0xdfff)
+            {
+                ch = ((ch - 0xd800) << 10) + (c2 - 0xdc00) + 0x10000;
+                n = 4;
+            }
+        }
+
+        // set character
+        tb_size_t m = tb_charset_utf_utf8_set(q, qe, ch);
+        tb_check_break(m);
+        q += m;
+        p += n;
+    }
+    *pp = p;
+    *pq = q;
+}
+static tb_void_t tb_charset_utf_utf32_to_utf8(tb_byte_t const** pp, tb_byte_t const* pe, tb_byte_t** pq, tb_byte_t const* qe, tb_bool_t be)
+{
+    tb_byte_t const*    p = *pp;
+    tb_byte_t*          q = *pq;
+    while (pe - p > 3)
+    {
+#ifdef TB_ARCH_SSE2
+        // convert 16 ascii characters at once
+        if (pe - p >= 64 && qe - q >= 16)
+        {
+            // the ascii character is 0x000000XX, we only need check the masked bits of the native 32-bits lanes
+            __m128i z = _mm_setzero_si128();
+            __m128i m = _mm_set1_epi32(be? (tb_int32_t)0x80ffffff : (tb_int32_t)0xffffff80);
+            __m128i a = _mm_loadu_si128((__m128i const*)p);
+            __m128i b = _mm_loadu_si128((__m128i const*)(p + 16));
+            __m128i c = _mm_loadu_si128((__m128i const*)(p + 32));
+            __m128i d = _mm_loadu_si128((__m128i const*)(p + 48));
+            if (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(_mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d)), m), z)) == 0xffff)
+            {
+                if (be)
+                {
+                    a = _mm_srli_epi32(a, 24);
+                    b = _mm_srli_epi32(b, 24);
+                    c = _mm_srli_epi32(c, 24);
+                    d = _mm_srli_epi32(d, 24);
+                }
+                _mm_storeu_si128((__m128i*)q, _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d)));
+                p += 64;
+                q += 16;
+                continue;
+            }
+        }
+#endif
+
+        // get character, the too large character will be left to the generic conversion
+        tb_uint32_t ch = be? tb_bits_get_u32_be(p) : tb_bits_get_u32_le(p);
+        tb_check_break(ch <= 0x1fffff);
+
+        // set character
+        tb_size_t m = tb_charset_utf_utf8_set(q, qe, ch);
+        tb_check_break(m);
+        q += m;
+        p += 4;
+    }
+    *pp = p;
+    *pq = q;
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+tb_long_t tb_charset_utf_conv(tb_size_t ftype, tb_size_t ttype, tb_static_stream_ref_t fst, tb_static_stream_ref_t tst);
+tb_long_t tb_charset_utf_conv(tb_size_t ftype, tb_size_t ttype, tb_static_stream_ref_t fst, tb_static_stream_ref_t tst)
+{
+    // the from and to streams
+    tb_byte_t const*    p = tb_static_stream_pos(fst);
+    tb_byte_t const*    pe = p + tb_static_stream_left(fst);
+    tb_byte_t*          q = (tb_byte_t*)tb_static_stream_pos(tst);
+    tb_byte_t const*    qe = q + tb_static_stream_left(tst);
+    tb_byte_t const*    pb = p;
+    tb_byte_t*          qb = q;
+
+    // big endian?
+    tb_bool_t fbe = !(ftype & TB_CHARSET_TYPE_LE)? tb_true : tb_false;
+    tb_bool_t tbe = !(ttype & TB_CHARSET_TYPE_LE)? tb_true : tb_false;
+
+    // convert it
+    ftype = TB_CHARSET_TYPE(ftype);
+    ttype = TB_CHARSET_TYPE(ttype);
+    if (ftype == TB_CHARSET_TYPE_UTF8 && ttype == TB_CHARSET_TYPE_UTF16)
+        tb_charset_utf_utf8_to_utf16(&p, pe, &q, qe, tbe);
+    else if (ftype == TB_CHARSET_TYPE_UTF8 && (ttype == TB_CHARSET_TYPE_UTF32 || ttype == TB_CHARSET_TYPE_UCS4))
+        tb_charset_utf_utf8_to_utf32(&p, pe, &q, qe, tbe);
+    else if (ftype == TB_CHARSET_TYPE_UTF16 && ttype == TB_CHARSET_TYPE_UTF8)
+        tb_charset_utf_utf16_to_utf8(&p, pe, &q, qe, fbe);
+    else if ((ftype == TB_CHARSET_TYPE_UTF32 || ftype == TB_CHARSET_TYPE_UCS4) && ttype == TB_CHARSET_TYPE_UTF8)
+        tb_charset_utf_utf32_to_utf8(&p, pe, &q, qe, fbe);
+    else return -1;
+
+    // update the streams
+    if (p > pb) tb_static_stream_skip(fst, p - pb);
+    if (q > qb) tb_static_stream_skip(tst, q - qb);
+
+    // ok
+    return q - qb;
+}
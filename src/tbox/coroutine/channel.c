@@ -74,99 +74,99 @@ typedef struct __tb_co_channel_t
     tb_cpointer_t                   priv;
 
     // the waiting send coroutines
-    tb_single_list_entry_head_t     waiting_send;
+    tb_list_entry_head_t            waiting_send;
 
     // the waiting recv coroutines
-    tb_single_list_entry_head_t     waiting_recv;
+    tb_list_entry_head_t            waiting_recv;
 
 }tb_co_channel_t;
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * private implementation
  */
-static tb_bool_t tb_co_channel_send_resume(tb_co_channel_t* channel, tb_pointer_t* pdata)
+static tb_co_channel_waiter_t* tb_co_channel_waiter_pop(tb_list_entry_head_ref_t waiting)
 {
     // check
-    tb_assert(channel);
+    tb_assert(waiting);
 
-    // resume the first waiting send coroutine and recv data
-    tb_bool_t ok = tb_false;
-    if (tb_single_list_entry_size(&channel->waiting_send))
+    // get the first available waiter
+    tb_list_entry_ref_t entry = tb_list_entry_head(waiting);
+    tb_list_entry_ref_t tail  = tb_list_entry_tail(waiting);
+    while (entry != tail)
     {
-        // get the next entry from head
-        tb_single_list_entry_ref_t entry = tb_single_list_entry_head(&channel->waiting_send);
-        tb_assert(entry);
-
-        // remove it from the waiting send coroutines
-        tb_single_list_entry_remove_head(&channel->waiting_send);
-
-        // get the waiting send coroutine
-        tb_coroutine_ref_t waiting = (tb_coroutine_ref_t)tb_single_list_entry(&channel->waiting_send, entry);
-
-        // resume this coroutine and recv data
-        tb_pointer_t data = tb_coroutine_resume(waiting, tb_null);
-
-        // save data
-        if (pdata) *pdata = data;
-
-        // ok
-        ok = tb_true;
+        // get the waiter
+        tb_co_channel_waiter_t* waiter = (tb_co_channel_waiter_t*)tb_list_entry(waiting, entry);
+        entry = tb_list_entry_next(entry);
+
+        /* skip the selecting coroutine if it has been woken up by other cases,
+         * it will remove this waiter by itself
+         */
+        if (waiter->select && waiter->select->ready >= 0) continue;
+
+        // remove it from the waiting list
+        tb_list_entry_remove(waiting, &waiter->entry);
+        waiter->waiting = 0;
+        return waiter;
     }
-
-    // ok?
-    return ok;
+    return tb_null;
 }
-static tb_void_t tb_co_channel_recv_resume(tb_co_channel_t* channel)
+static tb_void_t tb_co_channel_waiter_wake(tb_co_channel_waiter_t* waiter)
 {
     // check
-    tb_assert(channel);
+    tb_assert(waiter && waiter->coroutine);
 
-    // resume the first waiting recv coroutine
-    if (tb_single_list_entry_size(&channel->waiting_recv))
-    {
-        // get the next entry from head
-        tb_single_list_entry_ref_t entry = tb_single_list_entry_head(&channel->waiting_recv);
-        tb_assert(entry);
-
-        // remove it from the waiting recv coroutines
-        tb_single_list_entry_remove_head(&channel->waiting_recv);
-
-        // get the waiting recv coroutine
-        tb_coroutine_ref_t waiting = (tb_coroutine_ref_t)tb_single_list_entry(&channel->waiting_recv, entry);
-
-        // resume this coroutine
-        tb_coroutine_resume(waiting, tb_null);
-    }
+    // wake up the selecting coroutine or resume the waiting coroutine
+    if (waiter->select) tb_co_select_wake(waiter->select, waiter->index);
+    else tb_coroutine_resume((tb_coroutine_ref_t)waiter->coroutine, tb_null);
 }
-static tb_void_t tb_co_channel_send_suspend(tb_co_channel_t* channel, tb_cpointer_t data)
+static tb_void_t tb_co_channel_waiter_suspend(tb_co_channel_t* channel, tb_co_channel_waiter_t* waiter, tb_bool_t is_send, tb_cpointer_t data)
 {
     // check
-    tb_assert(channel);
+    tb_assert(channel && waiter);
 
     // get the running coroutine
     tb_coroutine_t* running = (tb_coroutine_t*)tb_coroutine_self();
     tb_assert(running);
 
-    // save this coroutine to the waiting send coroutines
-    tb_single_list_entry_insert_tail(&channel->waiting_send, &running->rs.single_entry);
+    // init waiter
+    waiter->coroutine   = running;
+    waiter->select      = tb_null;
+    waiter->index       = 0;
+    waiter->data        = data;
+    waiter->is_send     = is_send? 1 : 0;
+    waiter->waiting     = 1;
+    waiter->passed      = 0;
 
-    // send data and wait it
-    tb_coroutine_suspend(data);
+    // save it to the waiting send/recv list
+    tb_list_entry_insert_tail(is_send? &channel->waiting_send : &channel->waiting_recv, &waiter->entry);
+
+    // wait it
+    tb_coroutine_suspend(tb_null);
+
+    // remove it from the waiting list if it has been not woken up by channel (e.g. the scheduler has been stopped)
+    if (waiter->waiting)
+    {
+        tb_list_entry_remove(is_send? &channel->waiting_send : &channel->waiting_recv, &waiter->entry);
+        waiter->waiting = 0;
+    }
 }
-static tb_void_t tb_co_channel_recv_suspend(tb_co_channel_t* channel)
+static tb_void_t tb_co_channel_send_resume(tb_co_channel_t* channel)
 {
     // check
     tb_assert(channel);
 
-    // get the running coroutine
-    tb_coroutine_t* running = (tb_coroutine_t*)tb_coroutine_self();
-    tb_assert(running);
-
-    // save this coroutine to the waiting recv coroutines
-    tb_single_list_entry_insert_tail(&channel->waiting_recv, &running->rs.single_entry);
+    // resume the first waiting send coroutine
+    tb_co_channel_waiter_t* waiter = tb_co_channel_waiter_pop(&channel->waiting_send);
+    if (waiter) tb_co_channel_waiter_wake(waiter);
+}
+static tb_void_t tb_co_channel_recv_resume(tb_co_channel_t* channel)
+{
+    // check
+    tb_assert(channel);
 
-    // wait data
-    tb_coroutine_suspend(tb_null);
+    // resume the first waiting recv coroutine
+    tb_co_channel_waiter_t* waiter = tb_co_channel_waiter_pop(&channel->waiting_recv);
+    if (waiter) tb_co_channel_waiter_wake(waiter);
 }
 static tb_void_t tb_co_channel_send_buffer(tb_co_channel_t* channel, tb_cpointer_t data)
 {
@@ -174,6 +174,7 @@ static tb_void_t tb_co_channel_send_buffer(tb_co_channel_t* channel, tb_cpointer
     tb_assert_and_check_return(channel && channel->queue.data);
 
     // done
+    tb_co_channel_waiter_t waiter;
     do
     {
         // put data into queue if be not full
@@ -200,7 +201,7 @@ static tb_void_t tb_co_channel_send_buffer(tb_co_channel_t* channel, tb_cpointer
             tb_trace_d("send[%p]: wait ..", tb_coroutine_self());
 
             // wait send
-            tb_co_channel_send_suspend(channel, tb_null);
+            tb_co_channel_waiter_suspend(channel, &waiter, tb_true, tb_null);
 
             // trace
             tb_trace_d("send[%p]: wait ok", tb_coroutine_self());
@@ -217,7 +218,8 @@ static tb_pointer_t tb_co_channel_recv_buffer(tb_co_channel_t* channel)
     tb_assert_and_check_return_val(channel && channel->queue.data, tb_null);
 
     // done
-    tb_pointer_t data = tb_null;
+    tb_pointer_t            data = tb_null;
+    tb_co_channel_waiter_t  waiter;
     do
     {
         // recv data from channel if be not null
@@ -234,7 +236,7 @@ static tb_pointer_t tb_co_channel_recv_buffer(tb_co_channel_t* channel)
             tb_trace_d("recv[%p]: get data(%p)", tb_coroutine_self(), data);
 
             // notify to send data
-            tb_co_channel_send_resume(channel, tb_null);
+            tb_co_channel_send_resume(channel);
 
             // recv ok
             break;
@@ -246,7 +248,7 @@ static tb_pointer_t tb_co_channel_recv_buffer(tb_co_channel_t* channel)
             tb_trace_d("recv[%p]: wait ..", tb_coroutine_self());
 
             // wait recv
-            tb_co_channel_recv_suspend(channel);
+            tb_co_channel_waiter_suspend(channel, &waiter, tb_false, tb_null);
 
             // trace
             tb_trace_d("recv[%p]: wait ok", tb_coroutine_self());
@@ -305,7 +307,7 @@ static tb_bool_t tb_co_channel_recv_buffer_try(tb_co_channel_t* channel, tb_poin
         tb_trace_d("recv[%p]: get data(%p)", tb_coroutine_self(), *pdata);
 
         // notify to send data
-        tb_co_channel_send_resume(channel, tb_null);
+        tb_co_channel_send_resume(channel);
 
         // recv ok
         return tb_true;
@@ -314,43 +316,79 @@ static tb_bool_t tb_co_channel_recv_buffer_try(tb_co_channel_t* channel, tb_poin
     // failed
     return tb_false;
 }
+static tb_bool_t tb_co_channel_send_buffer0_try(tb_co_channel_t* channel, tb_cpointer_t data)
+{
+    // check
+    tb_assert(channel);
+
+    // pass data to the first waiting recv coroutine directly
+    tb_co_channel_waiter_t* waiter = tb_co_channel_waiter_pop(&channel->waiting_recv);
+    if (waiter)
+    {
+        // trace
+        tb_trace_d("send[%p]: pass data(%p) to %p", tb_coroutine_self(), data, waiter->coroutine);
+
+        // pass data
+        waiter->data    = data;
+        waiter->passed  = 1;
+
+        // resume the recv coroutine
+        tb_co_channel_waiter_wake(waiter);
+        return tb_true;
+    }
+
+    // failed
+    return tb_false;
+}
+static tb_bool_t tb_co_channel_recv_buffer0_try(tb_co_channel_t* channel, tb_pointer_t* pdata)
+{
+    // check
+    tb_assert(channel && pdata);
+
+    // recv data from the first waiting send coroutine directly
+    tb_co_channel_waiter_t* waiter = tb_co_channel_waiter_pop(&channel->waiting_send);
+    if (waiter)
+    {
+        // trace
+        tb_trace_d("recv[%p]: get data(%p) from %p", tb_coroutine_self(), waiter->data, waiter->coroutine);
+
+        // get data
+        *pdata = (tb_pointer_t)waiter->data;
+        waiter->passed = 1;
+
+        // resume the send coroutine
+        tb_co_channel_waiter_wake(waiter);
+        return tb_true;
+    }
+
+    // failed
+    return tb_false;
+}
 static tb_void_t tb_co_channel_send_buffer0(tb_co_channel_t* channel, tb_cpointer_t data)
 {
     // check
     tb_assert(channel);
 
-    // resume one waiting recv coroutine
-    tb_co_channel_recv_resume(channel);
+    // pass data to the waiting recv coroutine directly
+    tb_check_return(!tb_co_channel_send_buffer0_try(channel, data));
 
     // send data and wait it
-    tb_co_channel_send_suspend(channel, data);
+    tb_co_channel_waiter_t waiter;
+    tb_co_channel_waiter_suspend(channel, &waiter, tb_true, data);
 }
 static tb_pointer_t tb_co_channel_recv_buffer0(tb_co_channel_t* channel)
 {
     // check
     tb_assert(channel);
 
-    // done
+    // recv data from the waiting send coroutine directly
     tb_pointer_t data = tb_null;
-    do
-    {
-        // resume the first waiting send coroutine and recv data
-        if (tb_co_channel_send_resume(channel, &data))
-        {
-            // recv ok
-            break;
-        }
-        // no data?
-        else
-        {
-            // wait data
-            tb_co_channel_recv_suspend(channel);
-        }
+    if (tb_co_channel_recv_buffer0_try(channel, &data)) return data;
 
-    } while (1);
-
-    // ok?
-    return data;
+    // wait data
+    tb_co_channel_waiter_t waiter;
+    tb_co_channel_waiter_suspend(channel, &waiter, tb_false, tb_null);
+    return (tb_pointer_t)waiter.data;
 }
 
 /* //////////////////////////////////////////////////////////////////////////////////////
@@ -368,10 +406,10 @@ tb_co_channel_ref_t tb_co_channel_init(tb_size_t size, tb_co_channel_free_func_t
         tb_assert_and_check_break(channel);
 
         // init waiting send coroutines
-        tb_single_list_entry_init(&channel->waiting_send, tb_coroutine_t, rs.single_entry, tb_null);
+        tb_list_entry_init(&channel->waiting_send, tb_co_channel_waiter_t, entry, tb_null);
 
         // init waiting recv coroutines
-        tb_single_list_entry_init(&channel->waiting_recv, tb_coroutine_t, rs.single_entry, tb_null);
+        tb_list_entry_init(&channel->waiting_recv, tb_co_channel_waiter_t, entry, tb_null);
 
         // init free function and data
         channel->free = free;
@@ -433,12 +471,12 @@ tb_void_t tb_co_channel_exit(tb_co_channel_ref_t self)
     channel->queue.size = 0;
 
     // check waiting coroutines
-    tb_assert(!tb_single_list_entry_size(&channel->waiting_send));
-    tb_assert(!tb_single_list_entry_size(&channel->waiting_recv));
+    tb_assert(!tb_list_entry_size(&channel->waiting_send));
+    tb_assert(!tb_list_entry_size(&channel->waiting_recv));
 
     // exit waiting coroutines
-    tb_single_list_entry_exit(&channel->waiting_send);
-    tb_single_list_entry_exit(&channel->waiting_recv);
+    tb_list_entry_exit(&channel->waiting_send);
+    tb_list_entry_exit(&channel->waiting_recv);
 
     // exit the channel
     tb_free(channel);
@@ -469,7 +507,7 @@ tb_bool_t tb_co_channel_send_try(tb_co_channel_ref_t self, tb_cpointer_t data)
     tb_assert_and_check_return_val(channel, tb_false);
 
     // try sending it
-    return channel->queue.data? tb_co_channel_send_buffer_try(channel, data) : tb_false;
+    return channel->queue.data? tb_co_channel_send_buffer_try(channel, data) : tb_co_channel_send_buffer0_try(channel, data);
 }
 tb_bool_t tb_co_channel_recv_try(tb_co_channel_ref_t self, tb_pointer_t* pdata)
 {
@@ -478,6 +516,29 @@ tb_bool_t tb_co_channel_recv_try(tb_co_channel_ref_t self, tb_pointer_t* pdata)
     tb_assert_and_check_return_val(channel && pdata, tb_false);
 
     // try recving it
-    return channel->queue.data? tb_co_channel_recv_buffer_try(channel, pdata) : tb_false;
+    return channel->queue.data? tb_co_channel_recv_buffer_try(channel, pdata) : tb_co_channel_recv_buffer0_try(channel, pdata);
+}
+tb_void_t tb_co_channel_select_wait(tb_co_channel_ref_t self, tb_co_channel_waiter_t* waiter)
+{
+    // check
+    tb_co_channel_t* channel = (tb_co_channel_t*)self;
+    tb_assert_and_check_return(channel && waiter && waiter->select && !waiter->waiting);
+
+    // save it to the waiting send/recv list
+    tb_list_entry_insert_tail(waiter->is_send? &channel->waiting_send : &channel->waiting_recv, &waiter->entry);
+    waiter->waiting = 1;
+}
+tb_void_t tb_co_channel_select_cancel(tb_co_channel_ref_t self, tb_co_channel_waiter_t* waiter)
+{
+    // check
+    tb_co_channel_t* channel = (tb_co_channel_t*)self;
+    tb_assert_and_check_return(channel && waiter);
+
+    // remove it from the waiting send/recv list if it has been not woken up
+    if (waiter->waiting)
+    {
+        tb_list_entry_remove(waiter->is_send? &channel->waiting_send : &channel->waiting_recv, &waiter->entry);
+        waiter->waiting = 0;
+    }
 }
 
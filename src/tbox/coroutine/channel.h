@@ -71,6 +71,9 @@ tb_void_t               tb_co_channel_exit(tb_co_channel_ref_t channel);
  *
  * the current coroutine will be suspend if this channel is full
  *
+ * for the unbuffered channel, it passes data to the waiting recv coroutine directly and returns at once,
+ * otherwise it will be suspend until the data is received
+ *
  * @param channel       the channel
  * @param data          the channel data
  */
@@ -80,15 +83,19 @@ tb_void_t               tb_co_channel_send(tb_co_channel_ref_t channel, tb_cpoin
  *
  * the current coroutine will be suspend if no data
  *
+ * for the unbuffered channel, it gets data from the waiting send coroutine directly and wakes it up
+ *
  * @param channel       the channel
  *
  * @return              the channel data
  */
 tb_pointer_t            tb_co_channel_recv(tb_co_channel_ref_t channel);
 
-/*! try sending data into channel only with buffer
+/*! try sending data into channel
  *
- * the current coroutine will be suspend if this channel is full
+ * it will not suspend the current coroutine, and it will pass data to the waiting recv coroutine directly if no buffer
+ *
+ * @note it only fails for the unbuffered channel if there is no waiting recv coroutine, it always failed before
  *
  * @param channel       the channel
  * @param data          the channel data
@@ -97,9 +104,11 @@ tb_pointer_t            tb_co_channel_recv(tb_co_channel_ref_t channel);
  */
 tb_bool_t               tb_co_channel_send_try(tb_co_channel_ref_t channel, tb_cpointer_t data);
 
-/*! try recving data from channel only with buffer
+/*! try recving data from channel
  *
- * the current coroutine will be suspend if no data
+ * it will not suspend the current coroutine, and it will get data from the waiting send coroutine directly if no buffer
+ *
+ * @note it only fails for the unbuffered channel if there is no waiting send coroutine, it always failed before
  *
  * @param channel       the channel
  * @param pdata         the channel data pointer
@@ -100,6 +100,17 @@ tb_long_t tb_coroutine_waitfs(tb_poller_object_ref_t object, tb_fwatcher_event_t
     // wait fwatcher event
     return scheduler? tb_co_scheduler_wait_fwatcher(scheduler, object, pevent, timeout) : -1;
 }
+tb_long_t tb_coroutine_waittask(tb_coroutine_task_func_t func, tb_cpointer_t priv)
+{
+    // check
+    tb_assert_and_check_return_val(func, -1);
+
+    // get current scheduler
+    tb_co_scheduler_t* scheduler = (tb_co_scheduler_t*)tb_co_scheduler_self();
+
+    // wait task, or run it directly if we are not in coroutine
+    return scheduler? tb_co_scheduler_wait_task(scheduler, func, priv) : func(priv);
+}
 tb_coroutine_ref_t tb_coroutine_self()
 {
     // get coroutine
@@ -26,7 +26,10 @@
  * includes
  */
 #include "lock.h"
+#include "rwlock.h"
 #include "channel.h"
+#include "offload.h"
+#include "select.h"
 #include "semaphore.h"
 #include "scheduler.h"
 #include "../platform/poller.h"
@@ -48,6 +51,9 @@ typedef __tb_typeref__(coroutine);
 /// the coroutine function type
 typedef tb_void_t       (*tb_coroutine_func_t)(tb_cpointer_t priv);
 
+/// the coroutine blocking task function type, it will be called in the helper thread pool
+typedef tb_long_t       (*tb_coroutine_task_func_t)(tb_cpointer_t priv);
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * interfaces
  */
@@ -124,6 +130,20 @@ tb_long_t               tb_coroutine_waitproc(tb_poller_object_ref_t object, tb_
  */
 tb_long_t               tb_coroutine_waitfs(tb_poller_object_ref_t object, tb_fwatcher_event_t* pevent, tb_long_t timeout);
 
+/*! run the blocking task in the helper thread pool and wait it
+ *
+ * only the current coroutine will be suspended, other coroutines are still running
+ * in the scheduler thread until this task has been finished.
+ *
+ * @note the task cannot be canceled after it has been started, so we do not support timeout
+ *
+ * @param func          the blocking task function
+ * @param priv          the user private data as the argument of function
+ *
+ * @return              the return value of the task function, -1: failed
+ */
+tb_long_t               tb_coroutine_waittask(tb_coroutine_task_func_t func, tb_cpointer_t priv);
+
 /*! get the current coroutine
  *
  * @return              the current coroutine
@@ -63,7 +63,7 @@ typedef struct __tb_coroutine_rs_wait_t
     // the waited poller object
     tb_poller_object_t              object;
 
-    // the timer task pointer for ltimer or timer
+    // the timer task pointer
     tb_cpointer_t                   task;
 
     // the object event, (process status or fwatcher event)
@@ -75,8 +75,8 @@ typedef struct __tb_coroutine_rs_wait_t
     // waiting process?
     tb_uint16_t                     object_waiting  : 1;
 
-    // is ltimer?
-    tb_uint16_t                     is_ltimer     : 1;
+    // the select if be selecting multiple objects
+    tb_cpointer_t                   select;
 
 }tb_coroutine_rs_wait_t;
 
@@ -28,6 +28,7 @@
 #include "coroutine.h"
 #include "scheduler.h"
 #include "scheduler_io.h"
+#include "select.h"
 #include "stackless/stackless.h"
 
 #endif
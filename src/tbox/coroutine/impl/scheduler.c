@@ -335,6 +335,19 @@ tb_pointer_t tb_co_scheduler_sleep(tb_co_scheduler_t* scheduler, tb_long_t inter
     // sleep it
     return tb_co_scheduler_io_sleep(scheduler->scheduler_io, interval);
 }
+tb_void_t tb_co_scheduler_trace_save(tb_co_scheduler_t* scheduler, tb_cpointer_t coroutine)
+{
+    // check
+    tb_co_scheduler_trace_t* trace = scheduler->trace;
+    tb_assert(trace && trace->entries && trace->maxn);
+
+    // save this switch event, the oldest event will be overwritten if be full
+    tb_co_scheduler_trace_entry_t* entry = &trace->entries[trace->tail];
+    entry->time         = tb_co_scheduler_clock();
+    entry->coroutine    = coroutine;
+    trace->tail = (trace->tail + 1) % trace->maxn;
+    if (trace->size < trace->maxn) trace->size++;
+}
 tb_void_t tb_co_scheduler_switch(tb_co_scheduler_t* scheduler, tb_coroutine_t* coroutine)
 {
     // check
@@ -350,6 +363,10 @@ tb_void_t tb_co_scheduler_switch(tb_co_scheduler_t* scheduler, tb_coroutine_t* c
     // trace
     tb_trace_d("switch to coroutine(%p) from coroutine(%p)", coroutine, running);
 
+    // update statistics
+    scheduler->stats.switches++;
+    if (scheduler->trace) tb_co_scheduler_trace_save(scheduler, coroutine);
+
     // jump to the given coroutine
     tb_context_from_t from = tb_context_jump(coroutine->context, running);
 
@@ -410,3 +427,18 @@ tb_long_t tb_co_scheduler_wait_fwatcher(tb_co_scheduler_t* scheduler, tb_poller_
     // wait it
     return tb_co_scheduler_io_wait_fwatcher(scheduler->scheduler_io, object, pevent, timeout);
 }
+tb_long_t tb_co_scheduler_wait_task(tb_co_scheduler_t* scheduler, tb_coroutine_task_func_t func, tb_cpointer_t priv)
+{
+    // check
+    tb_assert(scheduler && scheduler->running && func);
+    tb_assert(scheduler->running == (tb_coroutine_t*)tb_coroutine_self());
+
+    // have been stopped? return it directly
+    tb_check_return_val(!scheduler->stopped, -1);
+
+    // need io scheduler
+    if (!tb_co_scheduler_io_need(scheduler)) return -1;
+
+    // wait it
+    return tb_co_scheduler_io_wait_task(scheduler->scheduler_io, func, priv);
+}
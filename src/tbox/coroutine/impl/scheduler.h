@@ -56,6 +56,34 @@ __tb_extern_c_enter__
 // the io scheduler type
 struct __tb_co_scheduler_io_t;
 
+// the switch trace entry type
+typedef struct __tb_co_scheduler_trace_entry_t
+{
+    // the switch time (us)
+    tb_hong_t                       time;
+
+    // the switched coroutine, it is null if be switched to poller
+    tb_cpointer_t                   coroutine;
+
+}tb_co_scheduler_trace_entry_t;
+
+// the switch trace type, it is a ring buffer
+typedef struct __tb_co_scheduler_trace_t
+{
+    // the entries
+    tb_co_scheduler_trace_entry_t*  entries;
+
+    // the maximum count
+    tb_size_t                       maxn;
+
+    // the entries count
+    tb_size_t                       size;
+
+    // the next entry index
+    tb_size_t                       tail;
+
+}tb_co_scheduler_trace_t;
+
 // the scheduler type
 typedef struct __tb_co_scheduler_t
 {
@@ -88,8 +116,36 @@ typedef struct __tb_co_scheduler_t
     // the suspend coroutines
     tb_list_entry_head_t            coroutines_suspend;
 
+    // the statistics
+    tb_co_scheduler_stats_t         stats;
+
+    // the start time of loop (us)
+    tb_hong_t                       time_start;
+
+    // the stop time of loop (us)
+    tb_hong_t                       time_stop;
+
+    // the switch trace, it is null if be disabled
+    tb_co_scheduler_trace_t*        trace;
+
 }tb_co_scheduler_t;
 
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * inline implementation
+ */
+
+/* the clock (us) of the scheduler statistics and trace
+ *
+ * it reads the calibrated cpu cycle counter instead of gettimeofday() if possible,
+ * because it will be called for each poller wakeup and each switch if trace is enabled
+ *
+ * @return                  the now us-clock
+ */
+static __tb_inline__ tb_hong_t tb_co_scheduler_clock(tb_noarg_t)
+{
+    return tb_tsc_clock() / 1000;
+}
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * interfaces
  */
@@ -147,6 +203,13 @@ tb_void_t                   tb_co_scheduler_finish(tb_co_scheduler_t* scheduler)
  */
 tb_pointer_t                tb_co_scheduler_sleep(tb_co_scheduler_t* scheduler, tb_long_t interval);
 
+/* save the switch event to trace
+ *
+ * @param scheduler         the scheduler
+ * @param coroutine         the switched coroutine, it is null if be switched to poller
+ */
+tb_void_t                   tb_co_scheduler_trace_save(tb_co_scheduler_t* scheduler, tb_cpointer_t coroutine);
+
 /* switch to the given coroutine
  *
  * @param scheduler         the scheduler
@@ -187,6 +250,16 @@ tb_long_t                   tb_co_scheduler_wait_proc(tb_co_scheduler_t* schedul
  */
 tb_long_t                   tb_co_scheduler_wait_fwatcher(tb_co_scheduler_t* scheduler, tb_poller_object_ref_t object, tb_fwatcher_event_t* pevent, tb_long_t timeout);
 
+/* wait the blocking task in the helper thread pool
+ *
+ * @param scheduler         the scheduler
+ * @param func              the task function
+ * @param priv              the user private data as the argument of function
+ *
+ * @return                  the return value of the task function, -1: failed
+ */
+tb_long_t                   tb_co_scheduler_wait_task(tb_co_scheduler_t* scheduler, tb_coroutine_task_func_t func, tb_cpointer_t priv);
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * extern
  */
@@ -31,20 +31,21 @@
  */
 #include "scheduler_io.h"
 #include "coroutine.h"
+#include "select.h"
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * macros
  */
 
-// the ltimer grow
+// the timer grow
 #ifdef __tb_small__
-#   define TB_SCHEDULER_IO_LTIMER_GROW      (64)
+#   define TB_SCHEDULER_IO_TIMER_GROW       (64)
 #else
-#   define TB_SCHEDULER_IO_LTIMER_GROW      (4096)
+#   define TB_SCHEDULER_IO_TIMER_GROW       (4096)
 #endif
 
-// the timer grow
-#define TB_SCHEDULER_IO_TIMER_GROW          (TB_SCHEDULER_IO_LTIMER_GROW >> 4)
+// the timer tick (ms)
+#define TB_SCHEDULER_IO_TIMER_TICK          (1)
 
 // the poller object data grow
 #ifdef __tb_small__
@@ -53,9 +54,117 @@
 #   define TB_SCHEDULER_IO_POLLERDATA_GROW    (4096)
 #endif
 
+// the helper thread pool worker maxn for the blocking tasks
+#ifdef __tb_small__
+#   define TB_SCHEDULER_IO_TASK_WORKER_MAXN   (4)
+#else
+#   define TB_SCHEDULER_IO_TASK_WORKER_MAXN   (16)
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the blocking task type, it is placed in the stack of the waiting coroutine
+typedef struct __tb_co_scheduler_io_task_t
+{
+    // the list entry for the finished tasks
+    tb_single_list_entry_t      entry;
+
+    // the io scheduler
+    tb_co_scheduler_io_ref_t    scheduler_io;
+
+    // the waiting coroutine
+    tb_coroutine_t*             coroutine;
+
+    // the task function
+    tb_coroutine_task_func_t    func;
+
+    // the user private data
+    tb_cpointer_t               priv;
+
+    // the result
+    tb_long_t                   result;
+
+}tb_co_scheduler_io_task_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * instance implementation
+ */
+static tb_handle_t tb_co_scheduler_io_pool_instance_init(tb_cpointer_t* ppriv)
+{
+    // init a bounded thread pool, we need not so many workers for the blocking file and dns operations
+    return (tb_handle_t)tb_thread_pool_init(tb_min(tb_cpu_count() << 1, TB_SCHEDULER_IO_TASK_WORKER_MAXN), 0);
+}
+static tb_void_t tb_co_scheduler_io_pool_instance_exit(tb_handle_t pool, tb_cpointer_t priv)
+{
+    tb_thread_pool_exit((tb_thread_pool_ref_t)pool);
+}
+static tb_void_t tb_co_scheduler_io_pool_instance_kill(tb_handle_t pool, tb_cpointer_t priv)
+{
+    tb_thread_pool_kill((tb_thread_pool_ref_t)pool);
+}
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * private implementation
  */
+static tb_void_t tb_co_scheduler_io_task_done(tb_thread_pool_worker_ref_t worker, tb_cpointer_t priv)
+{
+    // check
+    tb_co_scheduler_io_task_t* task = (tb_co_scheduler_io_task_t*)priv;
+    tb_assert_and_check_return(task && task->func && task->scheduler_io);
+
+    // do the blocking task in the worker thread
+    task->result = task->func(task->priv);
+
+    /* post it to the finished tasks and notify the io scheduler
+     *
+     * @note we need spak poller in the lock, because the io scheduler may be exited after we leave it
+     */
+    tb_co_scheduler_io_ref_t scheduler_io = task->scheduler_io;
+    tb_spinlock_enter(&scheduler_io->tasks_lock);
+    tb_bool_t notify = !tb_single_list_entry_size(&scheduler_io->tasks_done);
+    tb_single_list_entry_insert_tail(&scheduler_io->tasks_done, &task->entry);
+    if (notify && scheduler_io->poller) tb_poller_spak(scheduler_io->poller);
+    if (scheduler_io->tasks_exiting) tb_event_post(scheduler_io->tasks_event);
+    tb_spinlock_leave(&scheduler_io->tasks_lock);
+}
+static tb_co_scheduler_io_task_t* tb_co_scheduler_io_task_pop(tb_co_scheduler_io_ref_t scheduler_io)
+{
+    // pop the next finished task
+    tb_co_scheduler_io_task_t* task = tb_null;
+    tb_spinlock_enter(&scheduler_io->tasks_lock);
+    if (tb_single_list_entry_size(&scheduler_io->tasks_done))
+    {
+        task = (tb_co_scheduler_io_task_t*)tb_single_list_entry(&scheduler_io->tasks_done, tb_single_list_entry_head(&scheduler_io->tasks_done));
+        tb_single_list_entry_remove_head(&scheduler_io->tasks_done);
+    }
+    tb_spinlock_leave(&scheduler_io->tasks_lock);
+
+    // update the pending tasks count
+    if (task)
+    {
+        tb_assert(scheduler_io->tasks_pending);
+        scheduler_io->tasks_pending--;
+    }
+    return task;
+}
+static tb_void_t tb_co_scheduler_io_task_spak(tb_co_scheduler_io_ref_t scheduler_io)
+{
+    // no pending tasks?
+    tb_check_return(scheduler_io->tasks_pending);
+
+    // resume all coroutines of the finished tasks
+    tb_co_scheduler_io_task_t* task = tb_null;
+    while ((task = tb_co_scheduler_io_task_pop(scheduler_io)))
+    {
+        // trace
+        tb_trace_d("coroutine(%p): task finished, result: %ld", task->coroutine, task->result);
+
+        // resume the waiting coroutine
+        tb_co_scheduler_resume(scheduler_io->scheduler, task->coroutine, tb_null);
+    }
+}
 static tb_void_t tb_co_scheduler_io_resume(tb_co_scheduler_t* scheduler, tb_coroutine_t* coroutine, tb_size_t events)
 {
     // exists the timer task? remove it
@@ -67,8 +176,7 @@ static tb_void_t tb_co_scheduler_io_resume(tb_co_scheduler_t* scheduler, tb_coro
         tb_assert(scheduler_io && scheduler_io->poller);
 
         // remove the timer task
-        if (coroutine->rs.wait.is_ltimer) tb_ltimer_task_exit(scheduler_io->ltimer, (tb_ltimer_task_ref_t)task);
-        else tb_timer_task_exit(scheduler_io->timer, (tb_timer_task_ref_t)task);
+        tb_htimer_task_exit(scheduler_io->timer, (tb_htimer_task_ref_t)task);
         coroutine->rs.wait.task = tb_null;
     }
 
@@ -91,6 +199,9 @@ static tb_void_t tb_co_scheduler_io_timeout(tb_bool_t killed, tb_cpointer_t priv
     // resume the waited coroutine if timer task has been not canceled
     if (!killed)
     {
+        // update statistics
+        scheduler->stats.timers++;
+
         // reset the waited coroutines in the poller object data
         tb_size_t object_type = coroutine->rs.wait.object.type;
         if (object_type == TB_POLLER_OBJECT_PROC || object_type == TB_POLLER_OBJECT_FWATCHER)
@@ -112,12 +223,69 @@ static tb_void_t tb_co_scheduler_io_timeout(tb_bool_t killed, tb_cpointer_t priv
         tb_co_scheduler_io_resume(scheduler, coroutine, TB_POLLER_EVENT_NONE);
     }
 }
+static tb_void_t tb_co_scheduler_io_select_timer(tb_bool_t killed, tb_cpointer_t priv)
+{
+    // check
+    tb_co_select_t* select = (tb_co_select_t*)priv;
+    tb_assert(select && select->timeout >= 0);
+
+    // trace
+    tb_trace_d("coroutine(%p): select timer %s", select->coroutine, killed? "killed" : "timeout");
+
+    // wake up the selecting coroutine with the timeout case if timer task has been not canceled
+    if (!killed)
+    {
+        ((tb_co_scheduler_t*)tb_coroutine_scheduler(select->coroutine))->stats.timers++;
+        tb_co_select_wake(select, (tb_size_t)select->timeout);
+    }
+}
+static tb_void_t tb_co_scheduler_io_select_events(tb_coroutine_t* coroutine, tb_poller_object_ref_t object, tb_size_t events)
+{
+    // check
+    tb_co_select_t* select = (tb_co_select_t*)coroutine->rs.wait.select;
+    tb_assert(select && select->cases);
+
+    // find the ready case of this object
+    tb_size_t i = 0;
+    tb_size_t n = select->count;
+    for (i = 0; i < n; i++)
+    {
+        tb_co_select_case_ref_t item = &select->cases[i];
+        if (    item->type == TB_CO_SELECT_CASE_WAIT
+            &&  item->object.ref.ptr == object->ref.ptr
+            &&  ((events & TB_POLLER_EVENT_ERROR) || (item->events & events)))
+        {
+            // save the triggered events
+            item->events = events;
+
+            // wake up the selecting coroutine
+            tb_co_select_wake(select, i);
+            break;
+        }
+    }
+}
+static tb_void_t tb_co_scheduler_io_events_resume(tb_co_scheduler_io_ref_t scheduler_io, tb_coroutine_t* coroutine, tb_poller_object_ref_t object, tb_size_t events)
+{
+    // is selecting coroutine? wake up it with the ready case
+    if (coroutine->rs.wait.select) tb_co_scheduler_io_select_events(coroutine, object, events);
+    // resume the waiting coroutine
+    else tb_co_scheduler_io_resume(scheduler_io->scheduler, coroutine, events);
+}
+static tb_bool_t tb_co_scheduler_io_is_waiting(tb_coroutine_t* coroutine)
+{
+    // the selecting coroutine may have been woken up by other cases
+    tb_co_select_t* select = (tb_co_select_t*)coroutine->rs.wait.select;
+    return !select || select->ready < 0;
+}
 static tb_void_t tb_co_scheduler_io_events(tb_poller_ref_t poller, tb_poller_object_ref_t object, tb_long_t events, tb_cpointer_t priv)
 {
     // check
     tb_co_scheduler_io_ref_t scheduler_io = (tb_co_scheduler_io_ref_t)tb_poller_priv(poller);
     tb_assert(scheduler_io && scheduler_io->scheduler && object);
 
+    // update statistics
+    scheduler_io->scheduler->stats.events++;
+
     // is process/fwatcher object?
     if (object->type == TB_POLLER_OBJECT_PROC || object->type == TB_POLLER_OBJECT_FWATCHER)
     {
@@ -157,6 +325,18 @@ static tb_void_t tb_co_scheduler_io_events(tb_poller_ref_t poller, tb_poller_obj
     tb_coroutine_t* co_recv = (events & TB_POLLER_EVENT_RECV)? pollerdata->co_recv : tb_null;
     tb_coroutine_t* co_send = (events & TB_POLLER_EVENT_SEND)? pollerdata->co_send : tb_null;
 
+    // the selecting coroutines have been woken up by other cases? cache this events for them
+    if (co_recv && !tb_co_scheduler_io_is_waiting(co_recv))
+    {
+        pollerdata->co_recv = tb_null;
+        co_recv = tb_null;
+    }
+    if (co_send && !tb_co_scheduler_io_is_waiting(co_send))
+    {
+        pollerdata->co_send = tb_null;
+        co_send = tb_null;
+    }
+
     // trace
     tb_trace_d("object: %p, trigger events %lu, co_recv(%p), co_send(%p)", object->ref.ptr, events, co_recv, co_send);
 
@@ -165,20 +345,20 @@ static tb_void_t tb_co_scheduler_io_events(tb_poller_ref_t poller, tb_poller_obj
     {
         pollerdata->co_recv = tb_null;
         pollerdata->co_send = tb_null;
-        tb_co_scheduler_io_resume(scheduler_io->scheduler, co_recv, events);
+        tb_co_scheduler_io_events_resume(scheduler_io, co_recv, object, events);
     }
     else
     {
         if (co_recv)
         {
             pollerdata->co_recv = tb_null;
-            tb_co_scheduler_io_resume(scheduler_io->scheduler, co_recv, events & ~TB_POLLER_EVENT_SEND);
+            tb_co_scheduler_io_events_resume(scheduler_io, co_recv, object, events & ~TB_POLLER_EVENT_SEND);
             events &= ~TB_POLLER_EVENT_RECV;
         }
         if (co_send)
         {
             pollerdata->co_send = tb_null;
-            tb_co_scheduler_io_resume(scheduler_io->scheduler, co_send, events & ~TB_POLLER_EVENT_RECV);
+            tb_co_scheduler_io_events_resume(scheduler_io, co_send, object, events & ~TB_POLLER_EVENT_RECV);
             events &= ~TB_POLLER_EVENT_SEND;
         }
 
@@ -194,28 +374,112 @@ static tb_void_t tb_co_scheduler_io_events(tb_poller_ref_t poller, tb_poller_obj
         }
     }
 }
+static tb_long_t tb_co_scheduler_io_insert(tb_co_scheduler_io_ref_t scheduler_io, tb_coroutine_t* coroutine, tb_poller_object_ref_t object, tb_size_t events, tb_co_pollerdata_io_ref_t* ppollerdata)
+{
+    // check
+    tb_assert(ppollerdata);
+    *ppollerdata = tb_null;
+
+    // get the poller
+    tb_poller_ref_t poller = scheduler_io->poller;
+    tb_assert(poller);
+
+    // get and allocate a poller object data
+    tb_co_pollerdata_io_ref_t pollerdata = (tb_co_pollerdata_io_ref_t)tb_pollerdata_get(&scheduler_io->pollerdata, object);
+    if (!pollerdata)
+    {
+        tb_assert(scheduler_io->pollerdata_pool);
+        pollerdata = (tb_co_pollerdata_io_ref_t)tb_fixed_pool_malloc0(scheduler_io->pollerdata_pool);
+        tb_pollerdata_set(&scheduler_io->pollerdata, object, pollerdata);
+    }
+    tb_assert_and_check_return_val(pollerdata, -1);
+
+    // enable edge-trigger mode if be supported
+    if (tb_poller_support(poller, TB_POLLER_EVENT_CLEAR))
+        events |= TB_POLLER_EVENT_CLEAR;
+
+    // get the previous poller object events
+    tb_size_t events_wait = events;
+    if (pollerdata->poller_events_wait)
+    {
+        // return the cached events directly if the waiting events exists cache
+        tb_size_t events_prev_wait = pollerdata->poller_events_wait;
+        tb_size_t events_prev_save = pollerdata->poller_events_save;
+        if (events_prev_save && (events_prev_wait & events))
+        {
+            // check error?
+            if (events_prev_save & TB_POLLER_EVENT_ERROR)
+            {
+                pollerdata->poller_events_save = 0;
+                return -1;
+            }
+
+            // clear cache events
+            pollerdata->poller_events_save = (tb_uint16_t)(events_prev_save & ~events);
+
+            // return the cached events
+            return events_prev_save & events;
+        }
+
+        // modify the wait events and reserve the pending events in other coroutine
+        events_wait = events_prev_wait;
+        if ((events_wait & TB_POLLER_EVENT_RECV) && !pollerdata->co_recv) events_wait &= ~TB_POLLER_EVENT_RECV;
+        if ((events_wait & TB_POLLER_EVENT_SEND) && !pollerdata->co_send) events_wait &= ~TB_POLLER_EVENT_SEND;
+        events_wait |= events;
+
+        // modify poller object from poller for waiting events if the waiting events has been changed
+        if ((events_prev_wait & events_wait) != events_wait)
+        {
+            // trace
+            tb_trace_d("modify poller object: %p events: %lx", object->ref.ptr, events_wait);
+
+            // may be wait recv/send at same time
+            if (!tb_poller_modify(poller, object, events_wait | TB_POLLER_EVENT_NOEXTRA, tb_null))
+            {
+                // trace
+                tb_trace_e("failed to modify object(%p) to poller on coroutine(%p)!", object->ref.ptr, coroutine);
+                return -1;
+            }
+        }
+    }
+    else
+    {
+        // trace
+        tb_trace_d("insert poller object: %p events: %lx", object->ref.ptr, events_wait);
+
+        // insert poller object to poller for waiting events
+        if (!tb_poller_insert(poller, object, events_wait | TB_POLLER_EVENT_NOEXTRA, tb_null))
+        {
+            // trace
+            tb_trace_e("failed to insert object(%p) to poller on coroutine(%p)!", object->ref.ptr, coroutine);
+            return -1;
+        }
+    }
+
+    // save waiting events
+    pollerdata->poller_events_wait = (tb_uint16_t)events_wait;
+    pollerdata->poller_events_save = 0;
+
+    // save the poller object data
+    *ppollerdata = pollerdata;
+    return 0;
+}
 static tb_bool_t tb_co_scheduler_io_timer_spak(tb_co_scheduler_io_ref_t scheduler_io)
 {
     // check
-    tb_assert(scheduler_io && scheduler_io->timer && scheduler_io->ltimer);
+    tb_assert(scheduler_io && scheduler_io->timer);
 
     // spak ctime
     tb_cache_time_spak();
 
     // spak timer
-    if (!tb_timer_spak(scheduler_io->timer)) return tb_false;
-
-    // spak ltimer
-    if (!tb_ltimer_spak(scheduler_io->ltimer)) return tb_false;
-
-    // pk
-    return tb_true;
+    return tb_htimer_spak(scheduler_io->timer);
 }
 static tb_void_t tb_co_scheduler_io_loop(tb_cpointer_t priv)
 {
     // check
     tb_co_scheduler_io_ref_t scheduler_io = (tb_co_scheduler_io_ref_t)priv;
-    tb_assert_and_check_return(scheduler_io && scheduler_io->timer && scheduler_io->ltimer);
+    tb_assert_and_check_return(scheduler_io && scheduler_io->timer);
 
     // the scheduler
     tb_co_scheduler_t* scheduler = scheduler_io->scheduler;
@@ -239,24 +503,33 @@ static tb_void_t tb_co_scheduler_io_loop(tb_cpointer_t priv)
         tb_check_break(tb_co_scheduler_suspend_count(scheduler));
 
         // the delay
-        tb_size_t delay = tb_timer_delay(scheduler_io->timer);
-
-        // the ldelay
-        tb_size_t ldelay = tb_ltimer_delay(scheduler_io->ltimer);
+        tb_size_t delay = tb_htimer_delay(scheduler_io->timer);
 
         // trace
-        tb_trace_d("loop: wait %lu ms, %lu pending coroutines ..", tb_min(delay, ldelay), tb_co_scheduler_suspend_count(scheduler));
+        tb_trace_d("loop: wait %lu ms, %lu pending coroutines ..", delay, tb_co_scheduler_suspend_count(scheduler));
+
+        // switch to poller
+        tb_hong_t time = tb_co_scheduler_clock();
+        if (scheduler->trace) tb_co_scheduler_trace_save(scheduler, tb_null);
 
         // no more ready coroutines? wait io events and timers
-        if (tb_poller_wait(poller, tb_co_scheduler_io_events, tb_min(delay, ldelay)) < 0)
+        if (tb_poller_wait(poller, tb_co_scheduler_io_events, delay) < 0)
         {
             tb_trace_e("loop: wait poller failed!");
             break;
         }
 
+        // update the poller statistics and switch back to the io loop coroutine
+        scheduler->stats.wakeups++;
+        scheduler->stats.polling_time += tb_co_scheduler_clock() - time;
+        if (scheduler->trace) tb_co_scheduler_trace_save(scheduler, scheduler->running);
+
         // trace
         tb_trace_d("loop: wait ok, left %lu pending coroutines ..", tb_co_scheduler_suspend_count(scheduler));
 
+        // resume the coroutines of the finished blocking tasks
+        tb_co_scheduler_io_task_spak(scheduler_io);
+
         // spak timer
         if (!tb_co_scheduler_io_timer_spak(scheduler_io)) break;
     }
@@ -280,13 +553,9 @@ tb_co_scheduler_io_ref_t tb_co_scheduler_io_init(tb_co_scheduler_t* scheduler)
         scheduler_io->scheduler = (tb_co_scheduler_t*)scheduler;
 
         // init timer and using cache time
-        scheduler_io->timer = tb_timer_init(TB_SCHEDULER_IO_TIMER_GROW, tb_true);
+        scheduler_io->timer = tb_htimer_init(TB_SCHEDULER_IO_TIMER_GROW, TB_SCHEDULER_IO_TIMER_TICK, tb_true);
         tb_assert_and_check_break(scheduler_io->timer);
 
-        // init ltimer and using cache time
-        scheduler_io->ltimer = tb_ltimer_init(TB_SCHEDULER_IO_LTIMER_GROW, TB_LTIMER_TICK_S, tb_true);
-        tb_assert_and_check_break(scheduler_io->ltimer);
-
         // init poller
         scheduler_io->poller = tb_poller_init(scheduler_io);
         tb_assert_and_check_break(scheduler_io->poller);
@@ -301,6 +570,12 @@ tb_co_scheduler_io_ref_t tb_co_scheduler_io_init(tb_co_scheduler_t* scheduler)
         // init poller object data
         tb_pollerdata_init(&scheduler_io->pollerdata);
 
+        // init the finished blocking tasks
+        if (!tb_spinlock_init(&scheduler_io->tasks_lock)) break;
+        tb_single_list_entry_init(&scheduler_io->tasks_done, tb_co_scheduler_io_task_t, entry, tb_null);
+        scheduler_io->tasks_event = tb_event_init();
+        tb_assert_and_check_break(scheduler_io->tasks_event);
+
         // start the io loop coroutine
         if (!tb_co_scheduler_start(scheduler_io->scheduler, tb_co_scheduler_io_loop, scheduler_io, 0)) break;
 
@@ -325,6 +600,32 @@ tb_void_t tb_co_scheduler_io_exit(tb_co_scheduler_io_ref_t scheduler_io)
     // check
     tb_assert_and_check_return(scheduler_io);
 
+    /* wait all pending blocking tasks
+     *
+     * the task data is placed in the stack of the waiting coroutine,
+     * so we need wait them before exiting coroutines
+     */
+    if (scheduler_io->tasks_pending)
+    {
+        // notify us if the pending tasks are finished
+        tb_spinlock_enter(&scheduler_io->tasks_lock);
+        scheduler_io->tasks_exiting = tb_true;
+        tb_spinlock_leave(&scheduler_io->tasks_lock);
+
+        // wait them
+        while (scheduler_io->tasks_pending)
+        {
+            if (!tb_co_scheduler_io_task_pop(scheduler_io))
+                tb_event_wait(scheduler_io->tasks_event, -1);
+        }
+    }
+
+    // exit the finished blocking tasks
+    tb_single_list_entry_exit(&scheduler_io->tasks_done);
+    tb_spinlock_exit(&scheduler_io->tasks_lock);
+    if (scheduler_io->tasks_event) tb_event_exit(scheduler_io->tasks_event);
+    scheduler_io->tasks_event = tb_null;
+
     // exit poller object data
     tb_pollerdata_exit(&scheduler_io->pollerdata);
 
@@ -337,13 +638,9 @@ tb_void_t tb_co_scheduler_io_exit(tb_co_scheduler_io_ref_t scheduler_io)
     scheduler_io->poller = tb_null;
 
     // exit timer
-    if (scheduler_io->timer) tb_timer_exit(scheduler_io->timer);
+    if (scheduler_io->timer) tb_htimer_exit(scheduler_io->timer);
     scheduler_io->timer = tb_null;
 
-    // exit ltimer
-    if (scheduler_io->ltimer) tb_ltimer_exit(scheduler_io->ltimer);
-    scheduler_io->ltimer = tb_null;
-
     // clear scheduler
     scheduler_io->scheduler = tb_null;
 
@@ -374,10 +671,7 @@ tb_void_t tb_co_scheduler_io_kill(tb_co_scheduler_io_ref_t scheduler_io)
     tb_trace_d("kill: ..");
 
     // kill timer
-    if (scheduler_io->timer) tb_timer_kill(scheduler_io->timer);
-
-    // kill ltimer
-    if (scheduler_io->ltimer) tb_ltimer_kill(scheduler_io->ltimer);
+    if (scheduler_io->timer) tb_htimer_kill(scheduler_io->timer);
 
     // kill poller
     if (scheduler_io->poller) tb_poller_kill(scheduler_io->poller);
@@ -402,21 +696,7 @@ tb_pointer_t tb_co_scheduler_io_sleep(tb_co_scheduler_io_ref_t scheduler_io, tb_
     coroutine->rs.wait.object.type = TB_POLLER_OBJECT_NONE;
 
     // infinity?
-    if (interval > 0)
-    {
-        // high-precision interval?
-        if (interval % 1000)
-        {
-            // post task to timer
-            tb_timer_task_post(scheduler_io->timer, interval, tb_false, tb_co_scheduler_io_timeout, coroutine);
-        }
-        // low-precision interval?
-        else
-        {
-            // post task to ltimer (faster)
-            tb_ltimer_task_post(scheduler_io->ltimer, interval, tb_false, tb_co_scheduler_io_timeout, coroutine);
-        }
-    }
+    if (interval > 0) tb_htimer_task_post(scheduler_io->timer, interval, tb_false, tb_co_scheduler_io_timeout, coroutine);
 
     // suspend it
     return tb_co_scheduler_suspend(scheduler_io->scheduler, tb_null);
@@ -430,117 +710,27 @@ tb_long_t tb_co_scheduler_io_wait(tb_co_scheduler_io_ref_t scheduler_io, tb_poll
     tb_coroutine_t* coroutine = tb_co_scheduler_running(scheduler_io->scheduler);
     tb_assert(coroutine);
 
-    // get the poller
-    tb_poller_ref_t poller = scheduler_io->poller;
-    tb_assert(poller);
-
     // trace
     tb_trace_d("coroutine(%p): wait events(%lu) with %ld ms for object(%p) ..", coroutine, events, timeout, object->ref.ptr);
 
-    // get and allocate a poller object data
-    tb_co_pollerdata_io_ref_t pollerdata = (tb_co_pollerdata_io_ref_t)tb_pollerdata_get(&scheduler_io->pollerdata, object);
-    if (!pollerdata)
-    {
-        tb_assert(scheduler_io->pollerdata_pool);
-        pollerdata = (tb_co_pollerdata_io_ref_t)tb_fixed_pool_malloc0(scheduler_io->pollerdata_pool);
-        tb_pollerdata_set(&scheduler_io->pollerdata, object, pollerdata);
-    }
-    tb_assert_and_check_return_val(pollerdata, -1);
-
-    // enable edge-trigger mode if be supported
-    if (tb_poller_support(poller, TB_POLLER_EVENT_CLEAR))
-        events |= TB_POLLER_EVENT_CLEAR;
-
-    // get the previous poller object events
-    tb_size_t events_wait = events;
-    if (pollerdata->poller_events_wait)
-    {
-        // return the cached events directly if the waiting events exists cache
-        tb_size_t events_prev_wait = pollerdata->poller_events_wait;
-        tb_size_t events_prev_save = pollerdata->poller_events_save;
-        if (events_prev_save && (events_prev_wait & events))
-        {
-            // check error?
-            if (events_prev_save & TB_POLLER_EVENT_ERROR)
-            {
-                pollerdata->poller_events_save = 0;
-                return -1;
-            }
-
-            // clear cache events
-            pollerdata->poller_events_save = (tb_uint16_t)(events_prev_save & ~events);
-
-            // return the cached events
-            return events_prev_save & events;
-        }
-
-        // modify the wait events and reserve the pending events in other coroutine
-        events_wait = events_prev_wait;
-        if ((events_wait & TB_POLLER_EVENT_RECV) && !pollerdata->co_recv) events_wait &= ~TB_POLLER_EVENT_RECV;
-        if ((events_wait & TB_POLLER_EVENT_SEND) && !pollerdata->co_send) events_wait &= ~TB_POLLER_EVENT_SEND;
-        events_wait |= events;
-
-        // modify poller object from poller for waiting events if the waiting events has been changed
-        if ((events_prev_wait & events_wait) != events_wait)
-        {
-            // trace
-            tb_trace_d("modify poller object: %p events: %lx", object->ref.ptr, events_wait);
-
-            // may be wait recv/send at same time
-            if (!tb_poller_modify(poller, object, events_wait | TB_POLLER_EVENT_NOEXTRA, tb_null))
-            {
-                // trace
-                tb_trace_e("failed to modify object(%p) to poller on coroutine(%p)!", object->ref.ptr, coroutine);
-                return -1;
-            }
-        }
-    }
-    else
-    {
-        // trace
-        tb_trace_d("insert poller object: %p events: %lx", object->ref.ptr, events_wait);
-
-        // insert poller object to poller for waiting events
-        if (!tb_poller_insert(poller, object, events_wait | TB_POLLER_EVENT_NOEXTRA, tb_null))
-        {
-            // trace
-            tb_trace_e("failed to insert object(%p) to poller on coroutine(%p)!", object->ref.ptr, coroutine);
-            return -1;
-        }
-    }
+    // insert the poller object to poller for waiting events
+    tb_co_pollerdata_io_ref_t pollerdata = tb_null;
+    tb_long_t ok = tb_co_scheduler_io_insert(scheduler_io, coroutine, object, events, &pollerdata);
+    tb_check_return_val(pollerdata, ok);
 
     // exists timeout?
-    tb_cpointer_t   task = tb_null;
-    tb_bool_t       is_ltimer = tb_false;
+    tb_cpointer_t task = tb_null;
     if (timeout >= 0)
     {
-        // high-precision interval?
-        if (timeout % 1000)
-        {
-            // init task for timer
-            task = tb_timer_task_init(scheduler_io->timer, timeout, tb_false, tb_co_scheduler_io_timeout, coroutine);
-            tb_assert_and_check_return_val(task, tb_false);
-        }
-        // low-precision interval?
-        else
-        {
-            // init task for ltimer (faster)
-            task = tb_ltimer_task_init(scheduler_io->ltimer, timeout, tb_false, tb_co_scheduler_io_timeout, coroutine);
-            tb_assert_and_check_return_val(task, tb_false);
-
-            // mark as low-precision timer
-            is_ltimer = tb_true;
-        }
+        // init task for timer
+        task = tb_htimer_task_init(scheduler_io->timer, timeout, tb_false, tb_co_scheduler_io_timeout, coroutine);
+        tb_assert_and_check_return_val(task, tb_false);
     }
 
     // save the timer task to coroutine
     coroutine->rs.wait.task         = task;
     coroutine->rs.wait.object       = *object;
-    coroutine->rs.wait.is_ltimer    = is_ltimer;
-
-    // save waiting events
-    pollerdata->poller_events_wait = (tb_uint16_t)events_wait;
-    pollerdata->poller_events_save = 0;
+    coroutine->rs.wait.select       = tb_null;
 
     // save the current coroutine
     if (events & TB_POLLER_EVENT_RECV) pollerdata->co_recv = coroutine;
@@ -583,33 +773,17 @@ tb_long_t tb_co_scheduler_io_wait_proc(tb_co_scheduler_io_ref_t scheduler_io, tb
     }
 
     // exists timeout?
-    tb_cpointer_t   task = tb_null;
-    tb_bool_t       is_ltimer = tb_false;
+    tb_cpointer_t task = tb_null;
     if (timeout >= 0)
     {
-        // high-precision interval?
-        if (timeout % 1000)
-        {
-            // init task for timer
-            task = tb_timer_task_init(scheduler_io->timer, timeout, tb_false, tb_co_scheduler_io_timeout, coroutine);
-            tb_assert_and_check_return_val(task, tb_false);
-        }
-        // low-precision interval?
-        else
-        {
-            // init task for ltimer (faster)
-            task = tb_ltimer_task_init(scheduler_io->ltimer, timeout, tb_false, tb_co_scheduler_io_timeout, coroutine);
-            tb_assert_and_check_return_val(task, tb_false);
-
-            // mark as low-precision timer
-            is_ltimer = tb_true;
-        }
+        // init task for timer
+        task = tb_htimer_task_init(scheduler_io->timer, timeout, tb_false, tb_co_scheduler_io_timeout, coroutine);
+        tb_assert_and_check_return_val(task, tb_false);
     }
 
     // save the timer task to coroutine
     coroutine->rs.wait.task           = task;
     coroutine->rs.wait.object         = *object;
-    coroutine->rs.wait.is_ltimer      = is_ltimer;
     coroutine->rs.wait.object_event   = 0;
     coroutine->rs.wait.object_pending = 0;
     coroutine->rs.wait.object_waiting = 1;
@@ -653,33 +827,17 @@ tb_long_t tb_co_scheduler_io_wait_fwatcher(tb_co_scheduler_io_ref_t scheduler_io
     }
 
     // exists timeout?
-    tb_cpointer_t   task = tb_null;
-    tb_bool_t       is_ltimer = tb_false;
+    tb_cpointer_t task = tb_null;
     if (timeout >= 0)
     {
-        // high-precision interval?
-        if (timeout % 1000)
-        {
-            // init task for timer
-            task = tb_timer_task_init(scheduler_io->timer, timeout, tb_false, tb_co_scheduler_io_timeout, coroutine);
-            tb_assert_and_check_return_val(task, tb_false);
-        }
-        // low-precision interval?
-        else
-        {
-            // init task for ltimer (faster)
-            task = tb_ltimer_task_init(scheduler_io->ltimer, timeout, tb_false, tb_co_scheduler_io_timeout, coroutine);
-            tb_assert_and_check_return_val(task, tb_false);
-
-            // mark as low-precision timer
-            is_ltimer = tb_true;
-        }
+        // init task for timer
+        task = tb_htimer_task_init(scheduler_io->timer, timeout, tb_false, tb_co_scheduler_io_timeout, coroutine);
+        tb_assert_and_check_return_val(task, tb_false);
     }
 
     // save the timer task to coroutine
     coroutine->rs.wait.task           = task;
     coroutine->rs.wait.object         = *object;
-    coroutine->rs.wait.is_ltimer      = is_ltimer;
     coroutine->rs.wait.object_event   = 0;
     coroutine->rs.wait.object_pending = 0;
     coroutine->rs.wait.object_waiting = 1;
@@ -689,6 +847,54 @@ tb_long_t tb_co_scheduler_io_wait_fwatcher(tb_co_scheduler_io_ref_t scheduler_io
     if (ok > 0 && pevent) *pevent = *((tb_fwatcher_event_t*)coroutine->rs.wait.object_event);
     return ok;
 }
+tb_long_t tb_co_scheduler_io_wait_task(tb_co_scheduler_io_ref_t scheduler_io, tb_coroutine_task_func_t func, tb_cpointer_t priv)
+{
+    // check
+    tb_assert(scheduler_io && scheduler_io->poller && scheduler_io->scheduler && func);
+
+    // get the current coroutine
+    tb_coroutine_t* coroutine = tb_co_scheduler_running(scheduler_io->scheduler);
+    tb_assert(coroutine);
+
+    // get the helper thread pool
+    tb_thread_pool_ref_t pool = tb_co_scheduler_io_pool();
+    tb_assert_and_check_return_val(pool, -1);
+
+    // trace
+    tb_trace_d("coroutine(%p): wait task(%p) ..", coroutine, func);
+
+    // init task in the stack of the current coroutine
+    tb_co_scheduler_io_task_t task;
+    task.scheduler_io   = scheduler_io;
+    task.coroutine      = coroutine;
+    task.func           = func;
+    task.priv           = priv;
+    task.result         = -1;
+
+    // clear waiting task and object, the blocking task has no timeout
+    coroutine->rs.wait.task = tb_null;
+    coroutine->rs.wait.object.type = TB_POLLER_OBJECT_NONE;
+
+    // post it to the helper thread pool
+    if (!tb_thread_pool_task_post(pool, "coroutine_task", tb_co_scheduler_io_task_done, tb_null, &task, tb_false))
+    {
+        // trace
+        tb_trace_e("failed to post task(%p) on coroutine(%p)!", func, coroutine);
+        return -1;
+    }
+    scheduler_io->tasks_pending++;
+
+    /* suspend the current coroutine and wait the task result
+     *
+     * @note the task will be finished only in the io loop, so it will not be resumed before suspending
+     */
+    tb_co_scheduler_suspend(scheduler_io->scheduler, tb_null);
+    return task.result;
+}
+tb_thread_pool_ref_t tb_co_scheduler_io_pool()
+{
+    return (tb_thread_pool_ref_t)tb_singleton_instance(TB_SINGLETON_TYPE_CO_TASK_POOL, tb_co_scheduler_io_pool_instance_init, tb_co_scheduler_io_pool_instance_exit, tb_co_scheduler_io_pool_instance_kill, tb_null);
+}
 tb_bool_t tb_co_scheduler_io_cancel(tb_co_scheduler_io_ref_t scheduler_io, tb_poller_object_ref_t object)
 {
     // check
@@ -748,6 +954,66 @@ tb_bool_t tb_co_scheduler_io_cancel(tb_co_scheduler_io_ref_t scheduler_io, tb_po
     // no this poller object
     return tb_false;
 }
+tb_long_t tb_co_scheduler_io_select_wait(tb_co_scheduler_io_ref_t scheduler_io, tb_co_select_t* select, tb_poller_object_ref_t object, tb_size_t events)
+{
+    // check
+    tb_assert(scheduler_io && scheduler_io->poller && select && select->coroutine && object && events);
+    tb_assert(object->type == TB_POLLER_OBJECT_SOCK || object->type == TB_POLLER_OBJECT_PIPE);
+
+    // trace
+    tb_trace_d("coroutine(%p): select events(%lu) for object(%p) ..", select->coroutine, events, object->ref.ptr);
+
+    // insert the poller object to poller for waiting events
+    tb_co_pollerdata_io_ref_t pollerdata = tb_null;
+    tb_long_t ok = tb_co_scheduler_io_insert(scheduler_io, select->coroutine, object, events, &pollerdata);
+    tb_check_return_val(pollerdata, ok);
+
+    // save the selecting coroutine
+    if (events & TB_POLLER_EVENT_RECV) pollerdata->co_recv = select->coroutine;
+    if (events & TB_POLLER_EVENT_SEND) pollerdata->co_send = select->coroutine;
+    return 0;
+}
+tb_bool_t tb_co_scheduler_io_select_timeout(tb_co_scheduler_io_ref_t scheduler_io, tb_co_select_t* select, tb_long_t timeout)
+{
+    // check
+    tb_assert(scheduler_io && select && select->coroutine && select->timeout >= 0 && timeout > 0);
+
+    // init timer task
+    tb_coroutine_t* coroutine = select->coroutine;
+    coroutine->rs.wait.task = tb_htimer_task_init(scheduler_io->timer, timeout, tb_false, tb_co_scheduler_io_select_timer, select);
+    return coroutine->rs.wait.task != tb_null;
+}
+tb_void_t tb_co_scheduler_io_select_leave(tb_co_scheduler_io_ref_t scheduler_io, tb_co_select_t* select)
+{
+    // check
+    tb_assert(scheduler_io && select && select->coroutine && select->cases);
+
+    // remove the timer task
+    tb_coroutine_t* coroutine = select->coroutine;
+    tb_cpointer_t task = coroutine->rs.wait.task;
+    if (task)
+    {
+        tb_htimer_task_exit(scheduler_io->timer, (tb_htimer_task_ref_t)task);
+        coroutine->rs.wait.task = tb_null;
+    }
+
+    // clear the selecting coroutine in the poller object data, the triggered events will be cached for the next waiting
+    tb_size_t i = 0;
+    tb_size_t n = select->count;
+    for (i = 0; i < n; i++)
+    {
+        tb_co_select_case_ref_t item = &select->cases[i];
+        if (item->type == TB_CO_SELECT_CASE_WAIT)
+        {
+            tb_co_pollerdata_io_ref_t pollerdata = (tb_co_pollerdata_io_ref_t)tb_pollerdata_get(&scheduler_io->pollerdata, &item->object);
+            if (pollerdata)
+            {
+                if (pollerdata->co_recv == coroutine) pollerdata->co_recv = tb_null;
+                if (pollerdata->co_send == coroutine) pollerdata->co_send = tb_null;
+            }
+        }
+    }
+}
 tb_co_scheduler_io_ref_t tb_co_scheduler_io_self()
 {
     // get the current scheduler
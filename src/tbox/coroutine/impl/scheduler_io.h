@@ -26,9 +26,14 @@
  * includes
  */
 #include "scheduler.h"
+#include "select.h"
 #include "../../memory/fixed_pool.h"
 #include "../../platform/poller.h"
+#include "../../platform/event.h"
+#include "../../platform/spinlock.h"
+#include "../../platform/thread_pool.h"
 #include "../../platform/impl/pollerdata.h"
+#include "../../container/single_list_entry.h"
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * extern
@@ -68,11 +73,8 @@ typedef struct __tb_co_scheduler_io_t
     // the poller
     tb_poller_ref_t     poller;
 
-    // the timer
-    tb_timer_ref_t      timer;
-
-    // the low-precision timer (faster)
-    tb_ltimer_ref_t     ltimer;
+    // the timer (hierarchical timing wheel)
+    tb_htimer_ref_t     timer;
 
     // the poller data
     tb_pollerdata_t     pollerdata;
@@ -80,6 +82,21 @@ typedef struct __tb_co_scheduler_io_t
     // the poller data pool
     tb_fixed_pool_ref_t pollerdata_pool;
 
+    // the lock of the finished blocking tasks
+    tb_spinlock_t       tasks_lock;
+
+    // the finished blocking tasks, posted from the helper thread pool
+    tb_single_list_entry_head_t tasks_done;
+
+    // the pending blocking tasks count
+    tb_size_t           tasks_pending;
+
+    // the event for waiting the pending blocking tasks when exiting
+    tb_event_ref_t      tasks_event;
+
+    // is exiting? notify the tasks event
+    tb_bool_t           tasks_exiting;
+
 }tb_co_scheduler_io_t, *tb_co_scheduler_io_ref_t;
 
 /* //////////////////////////////////////////////////////////////////////////////////////
@@ -158,6 +175,22 @@ tb_long_t                   tb_co_scheduler_io_wait_proc(tb_co_scheduler_io_ref_
  */
 tb_long_t                   tb_co_scheduler_io_wait_fwatcher(tb_co_scheduler_io_ref_t scheduler_io, tb_poller_object_ref_t object, tb_fwatcher_event_t* pevent, tb_long_t timeout);
 
+/*! wait the blocking task in the helper thread pool
+ *
+ * @param scheduler_io      the io scheduler
+ * @param func              the task function
+ * @param priv              the user private data as the argument of function
+ *
+ * @return                  the return value of the task function, -1: failed
+ */
+tb_long_t                   tb_co_scheduler_io_wait_task(tb_co_scheduler_io_ref_t scheduler_io, tb_coroutine_task_func_t func, tb_cpointer_t priv);
+
+/* get the helper thread pool for the blocking tasks of coroutine
+ *
+ * @return                  the thread pool
+ */
+tb_thread_pool_ref_t        tb_co_scheduler_io_pool(tb_noarg_t);
+
 /*! cancel io events for the given poller object
  *
  * @param scheduler_io      the io scheduler
@@ -167,6 +200,36 @@ tb_long_t                   tb_co_scheduler_io_wait_fwatcher(tb_co_scheduler_io_
  */
 tb_bool_t                   tb_co_scheduler_io_cancel(tb_co_scheduler_io_ref_t scheduler_io, tb_poller_object_ref_t object);
 
+/*! wait io events for select
+ *
+ * it will only register the selecting coroutine to the poller object and not suspend it
+ *
+ * @param scheduler_io      the io scheduler
+ * @param select            the select
+ * @param object            the poller object, socket or pipe
+ * @param events            the waited events
+ *
+ * @return                  > 0: the cached events, 0: waiting, -1: failed
+ */
+tb_long_t                   tb_co_scheduler_io_select_wait(tb_co_scheduler_io_ref_t scheduler_io, tb_co_select_t* select, tb_poller_object_ref_t object, tb_size_t events);
+
+/*! start the timeout timer for select
+ *
+ * @param scheduler_io      the io scheduler
+ * @param select            the select
+ * @param timeout           the timeout (ms)
+ *
+ * @return                  tb_true or tb_false
+ */
+tb_bool_t                   tb_co_scheduler_io_select_timeout(tb_co_scheduler_io_ref_t scheduler_io, tb_co_select_t* select, tb_long_t timeout);
+
+/*! leave select, cancel all waiting io events and the timeout timer
+ *
+ * @param scheduler_io      the io scheduler
+ * @param select            the select
+ */
+tb_void_t                   tb_co_scheduler_io_select_leave(tb_co_scheduler_io_ref_t scheduler_io, tb_co_select_t* select);
+
 /* get the current io scheduler
  *
  * @return                  the io scheduler
@@ -0,0 +1,127 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        select.h
+ * @ingroup     coroutine
+ *
+ */
+#ifndef TB_COROUTINE_IMPL_SELECT_H
+#define TB_COROUTINE_IMPL_SELECT_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+#include "coroutine.h"
+#include "../select.h"
+#include "../../container/list_entry.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the select type, it is placed in the stack of the selecting coroutine
+typedef struct __tb_co_select_t
+{
+    // the selecting coroutine
+    tb_coroutine_t*             coroutine;
+
+    // the cases
+    tb_co_select_case_t*        cases;
+
+    // the cases count
+    tb_size_t                   count;
+
+    // the ready case index, -1: not ready
+    tb_long_t                   ready;
+
+    // the timeout case index, -1: no timer
+    tb_long_t                   timeout;
+
+}tb_co_select_t;
+
+/* the channel waiter type, it is placed in the stack of the waiting coroutine
+ *
+ * the waiting coroutine may wait multiple channels at same time for select(),
+ * so we cannot use the coroutine entry for the waiting list directly.
+ */
+typedef struct __tb_co_channel_waiter_t
+{
+    // the list entry of the waiting send/recv list
+    tb_list_entry_t             entry;
+
+    // the waiting coroutine
+    tb_coroutine_t*             coroutine;
+
+    // the select, it is null if be not selecting
+    tb_co_select_t*             select;
+
+    // the case index of select
+    tb_size_t                   index;
+
+    // the sent data or the received data
+    tb_cpointer_t               data;
+
+    // is waiting send?
+    tb_uint8_t                  is_send : 1;
+
+    // is in the waiting list?
+    tb_uint8_t                  waiting : 1;
+
+    // has the data been passed directly? (no buffer)
+    tb_uint8_t                  passed  : 1;
+
+}tb_co_channel_waiter_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/* wake up the selecting coroutine with the given ready case
+ *
+ * @param select            the select
+ * @param index             the ready case index
+ *
+ * @return                  tb_true or tb_false (it has been woken up by other cases)
+ */
+tb_bool_t                   tb_co_select_wake(tb_co_select_t* select, tb_size_t index);
+
+/* wait the channel for select
+ *
+ * @param channel           the channel
+ * @param waiter            the waiter
+ */
+tb_void_t                   tb_co_channel_select_wait(tb_co_channel_ref_t channel, tb_co_channel_waiter_t* waiter);
+
+/* cancel the waiter of the channel for select
+ *
+ * @param channel           the channel
+ * @param waiter            the waiter
+ */
+tb_void_t                   tb_co_channel_select_cancel(tb_co_channel_ref_t channel, tb_co_channel_waiter_t* waiter);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
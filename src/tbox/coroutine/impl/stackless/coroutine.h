@@ -42,12 +42,9 @@ typedef struct __tb_lo_coroutine_rs_wait_t
     tb_poller_object_t          object;
 
 #ifndef TB_CONFIG_MICRO_ENABLE
-    // the timer task pointer for ltimer or timer
+    // the timer task pointer
     tb_cpointer_t               task;
 
-    // is ltimer?
-    tb_sint32_t                 is_ltimer     : 1;
-
     // the process status
     tb_long_t                   object_event;
 
@@ -56,6 +53,9 @@ typedef struct __tb_lo_coroutine_rs_wait_t
 
     // waiting process?
     tb_uint16_t                 object_waiting  : 1;
+
+    // the result of the blocking task
+    tb_long_t                   task_result;
 #endif
 
     // the waited result
@@ -32,20 +32,23 @@
 #include "scheduler_io.h"
 #include "coroutine.h"
 #include "../../stackless/coroutine.h"
+#ifndef TB_CONFIG_MICRO_ENABLE
+#   include "../scheduler_io.h"
+#endif
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * macros
  */
 
-// the ltimer grow
+// the timer grow
 #ifdef __tb_small__
-#   define TB_SCHEDULER_IO_LTIMER_GROW      (64)
+#   define TB_SCHEDULER_IO_TIMER_GROW       (64)
 #else
-#   define TB_SCHEDULER_IO_LTIMER_GROW      (4096)
+#   define TB_SCHEDULER_IO_TIMER_GROW       (4096)
 #endif
 
-// the timer grow
-#define TB_SCHEDULER_IO_TIMER_GROW          (TB_SCHEDULER_IO_LTIMER_GROW >> 4)
+// the timer tick (ms)
+#define TB_SCHEDULER_IO_TIMER_TICK          (1)
 
 // the poller data grow
 #ifdef __tb_small__
@@ -54,9 +57,99 @@
 #   define TB_SCHEDULER_IO_POLLERDATA_GROW    (4096)
 #endif
 
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+#ifndef TB_CONFIG_MICRO_ENABLE
+
+// the blocking task type, the stackless coroutine has not stack, so it will be allocated
+typedef struct __tb_lo_scheduler_io_task_t
+{
+    // the list entry for the finished tasks
+    tb_single_list_entry_t      entry;
+
+    // the io scheduler
+    tb_lo_scheduler_io_ref_t    scheduler_io;
+
+    // the waiting coroutine
+    tb_lo_coroutine_t*          coroutine;
+
+    // the task function
+    tb_lo_coroutine_task_func_t func;
+
+    // the user private data
+    tb_cpointer_t               priv;
+
+    // the result
+    tb_long_t                   result;
+
+}tb_lo_scheduler_io_task_t;
+#endif
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * private implementation
  */
+#ifndef TB_CONFIG_MICRO_ENABLE
+static tb_void_t tb_lo_scheduler_io_task_done(tb_thread_pool_worker_ref_t worker, tb_cpointer_t priv)
+{
+    // check
+    tb_lo_scheduler_io_task_t* task = (tb_lo_scheduler_io_task_t*)priv;
+    tb_assert_and_check_return(task && task->func && task->scheduler_io);
+
+    // do the blocking task in the worker thread
+    task->result = task->func(task->priv);
+
+    /* post it to the finished tasks and notify the io scheduler
+     *
+     * @note we need spak poller in the lock, because the io scheduler may be exited after we leave it
+     */
+    tb_lo_scheduler_io_ref_t scheduler_io = task->scheduler_io;
+    tb_spinlock_enter(&scheduler_io->tasks_lock);
+    tb_bool_t notify = !tb_single_list_entry_size(&scheduler_io->tasks_done);
+    tb_single_list_entry_insert_tail(&scheduler_io->tasks_done, &task->entry);
+    if (notify && scheduler_io->poller) tb_poller_spak(scheduler_io->poller);
+    if (scheduler_io->tasks_exiting) tb_event_post(scheduler_io->tasks_event);
+    tb_spinlock_leave(&scheduler_io->tasks_lock);
+}
+static tb_lo_scheduler_io_task_t* tb_lo_scheduler_io_task_pop(tb_lo_scheduler_io_ref_t scheduler_io)
+{
+    // pop the next finished task
+    tb_lo_scheduler_io_task_t* task = tb_null;
+    tb_spinlock_enter(&scheduler_io->tasks_lock);
+    if (tb_single_list_entry_size(&scheduler_io->tasks_done))
+    {
+        task = (tb_lo_scheduler_io_task_t*)tb_single_list_entry(&scheduler_io->tasks_done, tb_single_list_entry_head(&scheduler_io->tasks_done));
+        tb_single_list_entry_remove_head(&scheduler_io->tasks_done);
+    }
+    tb_spinlock_leave(&scheduler_io->tasks_lock);
+
+    // update the pending tasks count
+    if (task)
+    {
+        tb_assert(scheduler_io->tasks_pending);
+        scheduler_io->tasks_pending--;
+    }
+    return task;
+}
+static tb_void_t tb_lo_scheduler_io_task_spak(tb_lo_scheduler_io_ref_t scheduler_io)
+{
+    // no pending tasks?
+    tb_check_return(scheduler_io->tasks_pending);
+
+    // resume all coroutines of the finished tasks
+    tb_lo_scheduler_io_task_t* task = tb_null;
+    while ((task = tb_lo_scheduler_io_task_pop(scheduler_io)))
+    {
+        // trace
+        tb_trace_d("coroutine(%p): task finished, result: %ld", task->coroutine, task->result);
+
+        // resume the waiting coroutine
+        task->coroutine->rs.wait.task_result = task->result;
+        tb_lo_scheduler_resume(scheduler_io->scheduler, task->coroutine);
+        tb_free(task);
+    }
+}
+#endif
 static tb_void_t tb_lo_scheduler_io_resume(tb_lo_scheduler_t* scheduler, tb_lo_coroutine_t* coroutine, tb_size_t events)
 {
 #ifndef TB_CONFIG_MICRO_ENABLE
@@ -69,8 +162,7 @@ static tb_void_t tb_lo_scheduler_io_resume(tb_lo_scheduler_t* scheduler, tb_lo_c
         tb_assert(scheduler_io && scheduler_io->poller);
 
         // remove the timer task
-        if (coroutine->rs.wait.is_ltimer) tb_ltimer_task_exit(scheduler_io->ltimer, (tb_ltimer_task_ref_t)task);
-        else tb_timer_task_exit(scheduler_io->timer, (tb_timer_task_ref_t)task);
+        tb_htimer_task_exit(scheduler_io->timer, (tb_htimer_task_ref_t)task);
         coroutine->rs.wait.task = tb_null;
     }
 #endif
@@ -211,33 +303,21 @@ static tb_void_t tb_lo_scheduler_io_events(tb_poller_ref_t poller, tb_poller_obj
 static tb_bool_t tb_lo_scheduler_io_timer_spak(tb_lo_scheduler_io_ref_t scheduler_io)
 {
     // check
-    tb_assert(scheduler_io && scheduler_io->timer && scheduler_io->ltimer);
+    tb_assert(scheduler_io && scheduler_io->timer);
 
     // spak ctime
     tb_cache_time_spak();
 
     // spak timer
-    if (!tb_timer_spak(scheduler_io->timer)) return tb_false;
-
-    // spak ltimer
-    if (!tb_ltimer_spak(scheduler_io->ltimer)) return tb_false;
-
-    // pk
-    return tb_true;
+    return tb_htimer_spak(scheduler_io->timer);
 }
 static tb_long_t tb_lo_scheduler_io_timer_delay(tb_lo_scheduler_io_ref_t scheduler_io)
 {
     // check
-    tb_assert(scheduler_io && scheduler_io->timer && scheduler_io->ltimer);
-
-    // the delay
-    tb_size_t delay = tb_timer_delay(scheduler_io->timer);
-
-    // the ldelay
-    tb_size_t ldelay = tb_ltimer_delay(scheduler_io->ltimer);
+    tb_assert(scheduler_io && scheduler_io->timer);
 
     // return the timer delay
-    return tb_min(delay, ldelay);
+    return (tb_long_t)tb_htimer_delay(scheduler_io->timer);
 }
 #else
 static __tb_inline__ tb_long_t tb_lo_scheduler_io_timer_delay(tb_lo_scheduler_io_ref_t scheduler_io)
@@ -283,6 +363,9 @@ static tb_void_t tb_lo_scheduler_io_loop(tb_lo_coroutine_ref_t coroutine, tb_cpo
             if (tb_poller_wait(scheduler_io->poller, tb_lo_scheduler_io_events, tb_lo_scheduler_io_timer_delay(scheduler_io)) < 0) break;
 
 #ifndef TB_CONFIG_MICRO_ENABLE
+            // resume the coroutines of the finished blocking tasks
+            tb_lo_scheduler_io_task_spak(scheduler_io);
+
             // spak timer
             if (!tb_lo_scheduler_io_timer_spak(scheduler_io)) break;
 #endif
@@ -316,12 +399,8 @@ tb_lo_scheduler_io_ref_t tb_lo_scheduler_io_init(tb_lo_scheduler_t* scheduler)
 
 #ifndef TB_CONFIG_MICRO_ENABLE
         // init timer and using cache time
-        scheduler_io->timer = tb_timer_init(TB_SCHEDULER_IO_TIMER_GROW, tb_true);
+        scheduler_io->timer = tb_htimer_init(TB_SCHEDULER_IO_TIMER_GROW, TB_SCHEDULER_IO_TIMER_TICK, tb_true);
         tb_assert_and_check_break(scheduler_io->timer);
-
-        // init ltimer and using cache time
-        scheduler_io->ltimer = tb_ltimer_init(TB_SCHEDULER_IO_LTIMER_GROW, TB_LTIMER_TICK_S, tb_true);
-        tb_assert_and_check_break(scheduler_io->ltimer);
 #endif
 
         // init poller data pool
@@ -331,6 +410,14 @@ tb_lo_scheduler_io_ref_t tb_lo_scheduler_io_init(tb_lo_scheduler_t* scheduler)
         // init poller data
         tb_pollerdata_init(&scheduler_io->pollerdata);
 
+#ifndef TB_CONFIG_MICRO_ENABLE
+        // init the finished blocking tasks
+        if (!tb_spinlock_init(&scheduler_io->tasks_lock)) break;
+        tb_single_list_entry_init(&scheduler_io->tasks_done, tb_lo_scheduler_io_task_t, entry, tb_null);
+        scheduler_io->tasks_event = tb_event_init();
+        tb_assert_and_check_break(scheduler_io->tasks_event);
+#endif
+
         // start the io loop coroutine
         if (!tb_lo_coroutine_start((tb_lo_scheduler_ref_t)scheduler, tb_lo_scheduler_io_loop, scheduler_io, tb_null)) break;
 
@@ -355,6 +442,31 @@ tb_void_t tb_lo_scheduler_io_exit(tb_lo_scheduler_io_ref_t scheduler_io)
     // check
     tb_assert_and_check_return(scheduler_io);
 
+#ifndef TB_CONFIG_MICRO_ENABLE
+    // wait and free all pending blocking tasks, they will access this io scheduler
+    if (scheduler_io->tasks_pending)
+    {
+        // notify us if the pending tasks are finished
+        tb_spinlock_enter(&scheduler_io->tasks_lock);
+        scheduler_io->tasks_exiting = tb_true;
+        tb_spinlock_leave(&scheduler_io->tasks_lock);
+
+        // wait them
+        while (scheduler_io->tasks_pending)
+        {
+            tb_lo_scheduler_io_task_t* task = tb_lo_scheduler_io_task_pop(scheduler_io);
+            if (task) tb_free(task);
+            else tb_event_wait(scheduler_io->tasks_event, -1);
+        }
+    }
+
+    // exit the finished blocking tasks
+    tb_single_list_entry_exit(&scheduler_io->tasks_done);
+    tb_spinlock_exit(&scheduler_io->tasks_lock);
+    if (scheduler_io->tasks_event) tb_event_exit(scheduler_io->tasks_event);
+    scheduler_io->tasks_event = tb_null;
+#endif
+
     // exit poller data
     tb_pollerdata_exit(&scheduler_io->pollerdata);
 
@@ -368,12 +480,8 @@ tb_void_t tb_lo_scheduler_io_exit(tb_lo_scheduler_io_ref_t scheduler_io)
 
 #ifndef TB_CONFIG_MICRO_ENABLE
     // exit timer
-    if (scheduler_io->timer) tb_timer_exit(scheduler_io->timer);
+    if (scheduler_io->timer) tb_htimer_exit(scheduler_io->timer);
     scheduler_io->timer = tb_null;
-
-    // exit ltimer
-    if (scheduler_io->ltimer) tb_ltimer_exit(scheduler_io->ltimer);
-    scheduler_io->ltimer = tb_null;
 #endif
 
     // clear scheduler
@@ -407,10 +515,7 @@ tb_void_t tb_lo_scheduler_io_kill(tb_lo_scheduler_io_ref_t scheduler_io)
 
 #ifndef TB_CONFIG_MICRO_ENABLE
     // kill timer
-    if (scheduler_io->timer) tb_timer_kill(scheduler_io->timer);
-
-    // kill ltimer
-    if (scheduler_io->ltimer) tb_ltimer_kill(scheduler_io->ltimer);
+    if (scheduler_io->timer) tb_htimer_kill(scheduler_io->timer);
 #endif
 
     // kill poller
@@ -434,21 +539,7 @@ tb_void_t tb_lo_scheduler_io_sleep(tb_lo_scheduler_io_ref_t scheduler_io, tb_lon
     coroutine->rs.wait.object.type = TB_POLLER_OBJECT_NONE;
 
     // infinity?
-    if (interval > 0)
-    {
-        // high-precision interval?
-        if (interval % 1000)
-        {
-            // post task to timer
-            tb_timer_task_post(scheduler_io->timer, interval, tb_false, tb_lo_scheduler_io_timeout, coroutine);
-        }
-        // low-precision interval?
-        else
-        {
-            // post task to ltimer (faster)
-            tb_ltimer_task_post(scheduler_io->ltimer, interval, tb_false, tb_lo_scheduler_io_timeout, coroutine);
-        }
-    }
+    if (interval > 0) tb_htimer_task_post(scheduler_io->timer, interval, tb_false, tb_lo_scheduler_io_timeout, coroutine);
 #else
     // not impl
     tb_trace_noimpl();
@@ -548,32 +639,16 @@ tb_bool_t tb_lo_scheduler_io_wait(tb_lo_scheduler_io_ref_t scheduler_io, tb_poll
 
 #ifndef TB_CONFIG_MICRO_ENABLE
     // exists timeout?
-    tb_cpointer_t   task = tb_null;
-    tb_bool_t       is_ltimer = tb_false;
+    tb_cpointer_t task = tb_null;
     if (timeout >= 0)
     {
-        // high-precision interval?
-        if (timeout % 1000)
-        {
-            // init task for timer
-            task = tb_timer_task_init(scheduler_io->timer, timeout, tb_false, tb_lo_scheduler_io_timeout, coroutine);
-            tb_assert_and_check_return_val(task, tb_false);
-        }
-        // low-precision interval?
-        else
-        {
-            // init task for ltimer (faster)
-            task = tb_ltimer_task_init(scheduler_io->ltimer, timeout, tb_false, tb_lo_scheduler_io_timeout, coroutine);
-            tb_assert_and_check_return_val(task, tb_false);
-
-            // mark as low-precision timer
-            is_ltimer = tb_true;
-        }
+        // init task for timer
+        task = tb_htimer_task_init(scheduler_io->timer, timeout, tb_false, tb_lo_scheduler_io_timeout, coroutine);
+        tb_assert_and_check_return_val(task, tb_false);
     }
 
     // save the timer task to coroutine
     coroutine->rs.wait.task = task;
-    coroutine->rs.wait.is_ltimer = is_ltimer;
 #endif
     coroutine->rs.wait.object = *object;
     coroutine->rs.wait.result = 0;
@@ -625,33 +700,17 @@ tb_bool_t tb_lo_scheduler_io_wait_proc(tb_lo_scheduler_io_ref_t scheduler_io, tb
     }
 
     // exists timeout?
-    tb_cpointer_t   task = tb_null;
-    tb_bool_t       is_ltimer = tb_false;
+    tb_cpointer_t task = tb_null;
     if (timeout >= 0)
     {
-        // high-precision interval?
-        if (timeout % 1000)
-        {
-            // init task for timer
-            task = tb_timer_task_init(scheduler_io->timer, timeout, tb_false, tb_lo_scheduler_io_timeout, coroutine);
-            tb_assert_and_check_return_val(task, tb_false);
-        }
-        // low-precision interval?
-        else
-        {
-            // init task for ltimer (faster)
-            task = tb_ltimer_task_init(scheduler_io->ltimer, timeout, tb_false, tb_lo_scheduler_io_timeout, coroutine);
-            tb_assert_and_check_return_val(task, tb_false);
-
-            // mark as low-precision timer
-            is_ltimer = tb_true;
-        }
+        // init task for timer
+        task = tb_htimer_task_init(scheduler_io->timer, timeout, tb_false, tb_lo_scheduler_io_timeout, coroutine);
+        tb_assert_and_check_return_val(task, tb_false);
     }
 
     // save the timer task to coroutine
     coroutine->rs.wait.task           = task;
     coroutine->rs.wait.object         = *object;
-    coroutine->rs.wait.is_ltimer      = is_ltimer;
     coroutine->rs.wait.object_event   = 0;
     coroutine->rs.wait.object_pending = 0;
     coroutine->rs.wait.object_waiting = 1;
@@ -660,6 +719,55 @@ tb_bool_t tb_lo_scheduler_io_wait_proc(tb_lo_scheduler_io_ref_t scheduler_io, tb
     return tb_true;
 }
 #endif
+#ifndef TB_CONFIG_MICRO_ENABLE
+tb_bool_t tb_lo_scheduler_io_wait_task(tb_lo_scheduler_io_ref_t scheduler_io, tb_lo_coroutine_task_func_t func, tb_cpointer_t priv)
+{
+    // check
+    tb_assert(scheduler_io && scheduler_io->poller && scheduler_io->scheduler && func);
+
+    // get the current coroutine
+    tb_lo_coroutine_t* coroutine = tb_lo_scheduler_running(scheduler_io->scheduler);
+    tb_assert(coroutine);
+
+    // failed by default
+    coroutine->rs.wait.task_result = -1;
+
+    // get the helper thread pool, it is shared with the stackful coroutines
+    tb_thread_pool_ref_t pool = tb_co_scheduler_io_pool();
+    tb_assert_and_check_return_val(pool, tb_false);
+
+    // trace
+    tb_trace_d("coroutine(%p): wait task(%p) ..", coroutine, func);
+
+    // make task
+    tb_lo_scheduler_io_task_t* task = tb_malloc0_type(tb_lo_scheduler_io_task_t);
+    tb_assert_and_check_return_val(task, tb_false);
+
+    // init task
+    task->scheduler_io  = scheduler_io;
+    task->coroutine     = coroutine;
+    task->func          = func;
+    task->priv          = priv;
+    task->result        = -1;
+
+    // clear waiting task and object, the blocking task has no timeout
+    coroutine->rs.wait.task = tb_null;
+    coroutine->rs.wait.object.type = TB_POLLER_OBJECT_NONE;
+
+    // post it to the helper thread pool
+    if (!tb_thread_pool_task_post(pool, "coroutine_task", tb_lo_scheduler_io_task_done, tb_null, task, tb_false))
+    {
+        // trace
+        tb_trace_e("failed to post task(%p) on coroutine(%p)!", func, coroutine);
+        tb_free(task);
+        return tb_false;
+    }
+    scheduler_io->tasks_pending++;
+
+    // suspend the current coroutine
+    return tb_true;
+}
+#endif
 tb_bool_t tb_lo_scheduler_io_cancel(tb_lo_scheduler_io_ref_t scheduler_io, tb_poller_object_ref_t object)
 {
     // check
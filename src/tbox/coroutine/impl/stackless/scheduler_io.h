@@ -29,6 +29,11 @@
 #include "../../../memory/fixed_pool.h"
 #include "../../../platform/poller.h"
 #include "../../../platform/impl/pollerdata.h"
+#ifndef TB_CONFIG_MICRO_ENABLE
+#   include "../../../platform/event.h"
+#   include "../../../platform/spinlock.h"
+#   include "../../../container/single_list_entry.h"
+#endif
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * extern
@@ -69,11 +74,8 @@ typedef struct __tb_lo_scheduler_io_t
     tb_poller_ref_t     poller;
 
 #ifndef TB_CONFIG_MICRO_ENABLE
-    // the timer
-    tb_timer_ref_t      timer;
-
-    // the low-precision timer (faster)
-    tb_ltimer_ref_t     ltimer;
+    // the timer (hierarchical timing wheel)
+    tb_htimer_ref_t     timer;
 #endif
 
     // the poller data
@@ -82,6 +84,23 @@ typedef struct __tb_lo_scheduler_io_t
     // the poller data pool
     tb_fixed_pool_ref_t pollerdata_pool;
 
+#ifndef TB_CONFIG_MICRO_ENABLE
+    // the lock of the finished blocking tasks
+    tb_spinlock_t       tasks_lock;
+
+    // the finished blocking tasks, posted from the helper thread pool
+    tb_single_list_entry_head_t tasks_done;
+
+    // the pending blocking tasks count
+    tb_size_t           tasks_pending;
+
+    // the event for waiting the pending blocking tasks when exiting
+    tb_event_ref_t      tasks_event;
+
+    // is exiting? notify the tasks event
+    tb_bool_t           tasks_exiting;
+#endif
+
 }tb_lo_scheduler_io_t, *tb_lo_scheduler_io_ref_t;
 
 /* //////////////////////////////////////////////////////////////////////////////////////
@@ -146,6 +165,16 @@ tb_bool_t                   tb_lo_scheduler_io_wait(tb_lo_scheduler_io_ref_t sch
  */
 tb_bool_t                   tb_lo_scheduler_io_wait_proc(tb_lo_scheduler_io_ref_t scheduler_io, tb_poller_object_ref_t object, tb_long_t timeout);
 
+/* wait the blocking task in the helper thread pool
+ *
+ * @param scheduler_io      the io scheduler
+ * @param func              the task function
+ * @param priv              the user private data as the argument of function
+ *
+ * @return                  suspend coroutine if be tb_true
+ */
+tb_bool_t                   tb_lo_scheduler_io_wait_task(tb_lo_scheduler_io_ref_t scheduler_io, tb_lo_coroutine_task_func_t func, tb_cpointer_t priv);
+
 /*! cancel io events for the given poller
  *
  * @param scheduler_io      the io scheduler
@@ -31,6 +31,7 @@
  */
 #include "lock.h"
 #include "semaphore.h"
+#include "../utils/lock_profiler.h"
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * implementation
@@ -47,16 +48,42 @@ tb_void_t tb_co_lock_exit(tb_co_lock_ref_t self)
 }
 tb_void_t tb_co_lock_enter(tb_co_lock_ref_t self)
 {
+#ifdef TB_LOCK_PROFILER_ENABLE
+    // occupied?
+    if (tb_co_semaphore_wait((tb_co_semaphore_ref_t)self, 0) <= 0)
+    {
+        // occupied++
+        tb_lock_profiler_ref_t profiler = tb_lock_profiler();
+        tb_lock_profiler_occupied(profiler, (tb_pointer_t)self);
+
+        // wait it and profile the wait time
+        tb_hong_t ticks = tb_lock_profiler_ticks();
+        if (tb_co_semaphore_wait((tb_co_semaphore_ref_t)self, -1) > 0)
+            tb_lock_profiler_entered(profiler, (tb_pointer_t)self, tb_lock_profiler_ticks() - ticks);
+    }
+#else
     // enter lock
     tb_co_semaphore_wait((tb_co_semaphore_ref_t)self, -1);
+#endif
 }
 tb_bool_t tb_co_lock_enter_try(tb_co_lock_ref_t self)
 {
     // try to enter lock
-    return tb_co_semaphore_wait((tb_co_semaphore_ref_t)self, 0) > 0;
+    tb_bool_t ok = tb_co_semaphore_wait((tb_co_semaphore_ref_t)self, 0) > 0;
+
+#ifdef TB_LOCK_PROFILER_ENABLE
+    // occupied?
+    if (!ok) tb_lock_profiler_occupied(tb_lock_profiler(), (tb_pointer_t)self);
+#endif
+    return ok;
 }
 tb_void_t tb_co_lock_leave(tb_co_lock_ref_t self)
 {
+#ifdef TB_LOCK_PROFILER_ENABLE
+    // profile the hold time
+    tb_lock_profiler_leave((tb_pointer_t)self);
+#endif
+
     // leave lock
     tb_co_semaphore_post((tb_co_semaphore_ref_t)self, 1);
 }
@@ -0,0 +1,182 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        offload.c
+ * @ingroup     coroutine
+ *
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * trace
+ */
+#define TB_TRACE_MODULE_NAME            "offload"
+#define TB_TRACE_MODULE_DEBUG           (0)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "offload.h"
+#include "coroutine.h"
+#include "../platform/addrinfo.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the offloaded file io arguments type
+typedef struct __tb_co_offload_file_t
+{
+    // the file
+    tb_file_ref_t               file;
+
+    // the data
+    tb_byte_t*                  data;
+
+    // the size
+    tb_size_t                   size;
+
+    // the offset
+    tb_hize_t                   offset;
+
+}tb_co_offload_file_t;
+
+// the offloaded path arguments type
+typedef struct __tb_co_offload_path_t
+{
+    // the path
+    tb_char_t const*            path;
+
+    // the recursion level
+    tb_long_t                   recursion;
+
+    // is prefix recursion?
+    tb_bool_t                   prefix;
+
+    // the walk func
+    tb_directory_walk_func_t    func;
+
+    // the private data or file info
+    tb_cpointer_t               priv;
+
+}tb_co_offload_path_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static tb_long_t tb_co_offload_file_read(tb_cpointer_t priv)
+{
+    tb_co_offload_file_t* args = (tb_co_offload_file_t*)priv;
+    return tb_file_read(args->file, args->data, args->size);
+}
+static tb_long_t tb_co_offload_file_writ(tb_cpointer_t priv)
+{
+    tb_co_offload_file_t* args = (tb_co_offload_file_t*)priv;
+    return tb_file_writ(args->file, args->data, args->size);
+}
+static tb_long_t tb_co_offload_file_pread(tb_cpointer_t priv)
+{
+    tb_co_offload_file_t* args = (tb_co_offload_file_t*)priv;
+    return tb_file_pread(args->file, args->data, args->size, args->offset);
+}
+static tb_long_t tb_co_offload_file_pwrit(tb_cpointer_t priv)
+{
+    tb_co_offload_file_t* args = (tb_co_offload_file_t*)priv;
+    return tb_file_pwrit(args->file, args->data, args->size, args->offset);
+}
+static tb_long_t tb_co_offload_file_info(tb_cpointer_t priv)
+{
+    tb_co_offload_path_t* args = (tb_co_offload_path_t*)priv;
+    return tb_file_info(args->path, (tb_file_info_t*)args->priv);
+}
+static tb_long_t tb_co_offload_directory_walk(tb_cpointer_t priv)
+{
+    tb_co_offload_path_t* args = (tb_co_offload_path_t*)priv;
+    tb_directory_walk(args->path, args->recursion, args->prefix, args->func, args->priv);
+    return 0;
+}
+static tb_long_t tb_co_offload_addrinfo_addr(tb_cpointer_t priv)
+{
+    tb_co_offload_path_t* args = (tb_co_offload_path_t*)priv;
+    return tb_addrinfo_addr(args->path, (tb_ipaddr_ref_t)args->priv);
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+tb_long_t tb_co_file_read(tb_file_ref_t file, tb_byte_t* data, tb_size_t size)
+{
+    // check
+    tb_assert_and_check_return_val(file && data, -1);
+
+    // read it in the helper thread pool
+    tb_co_offload_file_t args = {file, data, size, 0};
+    return tb_coroutine_waittask(tb_co_offload_file_read, &args);
+}
+tb_long_t tb_co_file_writ(tb_file_ref_t file, tb_byte_t const* data, tb_size_t size)
+{
+    // check
+    tb_assert_and_check_return_val(file && data, -1);
+
+    // write it in the helper thread pool
+    tb_co_offload_file_t args = {file, (tb_byte_t*)data, size, 0};
+    return tb_coroutine_waittask(tb_co_offload_file_writ, &args);
+}
+tb_long_t tb_co_file_pread(tb_file_ref_t file, tb_byte_t* data, tb_size_t size, tb_hize_t offset)
+{
+    // check
+    tb_assert_and_check_return_val(file && data, -1);
+
+    // pread it in the helper thread pool
+    tb_co_offload_file_t args = {file, data, size, offset};
+    return tb_coroutine_waittask(tb_co_offload_file_pread, &args);
+}
+tb_long_t tb_co_file_pwrit(tb_file_ref_t file, tb_byte_t const* data, tb_size_t size, tb_hize_t offset)
+{
+    // check
+    tb_assert_and_check_return_val(file && data, -1);
+
+    // pwrite it in the helper thread pool
+    tb_co_offload_file_t args = {file, (tb_byte_t*)data, size, offset};
+    return tb_coroutine_waittask(tb_co_offload_file_pwrit, &args);
+}
+tb_bool_t tb_co_file_info(tb_char_t const* path, tb_file_info_t* info)
+{
+    // check
+    tb_assert_and_check_return_val(path, tb_false);
+
+    // get file info in the helper thread pool
+    tb_co_offload_path_t args = {path, 0, tb_false, tb_null, info};
+    return tb_coroutine_waittask(tb_co_offload_file_info, &args) > 0;
+}
+tb_void_t tb_co_directory_walk(tb_char_t const* path, tb_long_t recursion, tb_bool_t prefix, tb_directory_walk_func_t func, tb_cpointer_t priv)
+{
+    // check
+    tb_assert_and_check_return(path && func);
+
+    // walk it in the helper thread pool
+    tb_co_offload_path_t args = {path, recursion, prefix, func, priv};
+    tb_coroutine_waittask(tb_co_offload_directory_walk, &args);
+}
+tb_bool_t tb_co_addrinfo_addr(tb_char_t const* name, tb_ipaddr_ref_t addr)
+{
+    // check
+    tb_assert_and_check_return_val(name && addr, tb_false);
+
+    // get address in the helper thread pool
+    tb_co_offload_path_t args = {name, 0, tb_false, tb_null, addr};
+    return tb_coroutine_waittask(tb_co_offload_addrinfo_addr, &args) > 0;
+}
@@ -0,0 +1,122 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        offload.h
+ * @ingroup     coroutine
+ *
+ */
+#ifndef TB_COROUTINE_OFFLOAD_H
+#define TB_COROUTINE_OFFLOAD_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+#include "../platform/file.h"
+#include "../platform/directory.h"
+#include "../network/ipaddr.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/*! read the file data without blocking the scheduler thread
+ *
+ * the blocking operation will be offloaded to the helper thread pool and only the current coroutine will be suspended,
+ * it will call tb_file_read() directly if we are not in coroutine.
+ *
+ * @param file          the file
+ * @param data          the data
+ * @param size          the size
+ *
+ * @return              the real size or -1
+ */
+tb_long_t               tb_co_file_read(tb_file_ref_t file, tb_byte_t* data, tb_size_t size);
+
+/*! write the file data without blocking the scheduler thread
+ *
+ * @param file          the file
+ * @param data          the data
+ * @param size          the size
+ *
+ * @return              the real size or -1
+ */
+tb_long_t               tb_co_file_writ(tb_file_ref_t file, tb_byte_t const* data, tb_size_t size);
+
+/*! pread the file data without blocking the scheduler thread
+ *
+ * @param file          the file
+ * @param data          the data
+ * @param size          the size
+ * @param offset        the offset, the file offset will not be changed
+ *
+ * @return              the real size or -1
+ */
+tb_long_t               tb_co_file_pread(tb_file_ref_t file, tb_byte_t* data, tb_size_t size, tb_hize_t offset);
+
+/*! pwrite the file data without blocking the scheduler thread
+ *
+ * @param file          the file
+ * @param data          the data
+ * @param size          the size
+ * @param offset        the offset, the file offset will not be changed
+ *
+ * @return              the real size or -1
+ */
+tb_long_t               tb_co_file_pwrit(tb_file_ref_t file, tb_byte_t const* data, tb_size_t size, tb_hize_t offset);
+
+/*! get the file info without blocking the scheduler thread
+ *
+ * @param path          the file path
+ * @param info          the file info
+ *
+ * @return              tb_true or tb_false
+ */
+tb_bool_t               tb_co_file_info(tb_char_t const* path, tb_file_info_t* info);
+
+/*! walk the directory without blocking the scheduler thread
+ *
+ * @note the walk function will be called in the helper thread, so it cannot call the coroutine interfaces
+ *
+ * @param path          the directory path
+ * @param recursion     the recursion level, 0, 1, 2, .. or -1 (infinite)
+ * @param prefix        is prefix recursion? directory is the first item
+ * @param func          the callback func
+ * @param priv          the callback priv
+ */
+tb_void_t               tb_co_directory_walk(tb_char_t const* path, tb_long_t recursion, tb_bool_t prefix, tb_directory_walk_func_t func, tb_cpointer_t priv);
+
+/*! get the first dns address from the host name without blocking the scheduler thread
+ *
+ * @param name          the host name (cannot be null)
+ * @param addr          the ip address (we can fill some hint info first)
+ *
+ * @return              tb_true or tb_false
+ */
+tb_bool_t               tb_co_addrinfo_addr(tb_char_t const* name, tb_ipaddr_ref_t addr);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
@@ -0,0 +1,187 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        rwlock.c
+ * @ingroup     coroutine
+ *
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * trace
+ */
+#define TB_TRACE_MODULE_NAME            "rwlock"
+#define TB_TRACE_MODULE_DEBUG           (0)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "rwlock.h"
+#include "semaphore.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the coroutine rwlock type
+typedef struct __tb_co_rwlock_t
+{
+    // the readers semaphore
+    tb_co_semaphore_ref_t   readers_semaphore;
+
+    // the writers semaphore
+    tb_co_semaphore_ref_t   writers_semaphore;
+
+    // the active readers count
+    tb_size_t               readers;
+
+    // the waiting readers count
+    tb_size_t               readers_waiting;
+
+    // the waiting writers count
+    tb_size_t               writers_waiting;
+
+    // is writing?
+    tb_bool_t               writing;
+
+}tb_co_rwlock_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+tb_co_rwlock_ref_t tb_co_rwlock_init()
+{
+    // done
+    tb_bool_t       ok = tb_false;
+    tb_co_rwlock_t* rwlock = tb_null;
+    do
+    {
+        // make rwlock
+        rwlock = tb_malloc0_type(tb_co_rwlock_t);
+        tb_assert_and_check_break(rwlock);
+
+        // init semaphores
+        rwlock->readers_semaphore = tb_co_semaphore_init(0);
+        rwlock->writers_semaphore = tb_co_semaphore_init(0);
+        tb_assert_and_check_break(rwlock->readers_semaphore && rwlock->writers_semaphore);
+
+        // ok
+        ok = tb_true;
+
+    } while (0);
+
+    // failed?
+    if (!ok && rwlock)
+    {
+        tb_co_rwlock_exit((tb_co_rwlock_ref_t)rwlock);
+        rwlock = tb_null;
+    }
+    return (tb_co_rwlock_ref_t)rwlock;
+}
+tb_void_t tb_co_rwlock_exit(tb_co_rwlock_ref_t self)
+{
+    // check
+    tb_co_rwlock_t* rwlock = (tb_co_rwlock_t*)self;
+    tb_assert_and_check_return(rwlock);
+
+    // exit semaphores
+    if (rwlock->readers_semaphore) tb_co_semaphore_exit(rwlock->readers_semaphore);
+    if (rwlock->writers_semaphore) tb_co_semaphore_exit(rwlock->writers_semaphore);
+    rwlock->readers_semaphore = tb_null;
+    rwlock->writers_semaphore = tb_null;
+
+    // exit it
+    tb_free(rwlock);
+}
+tb_void_t tb_co_rwlock_enter_read(tb_co_rwlock_ref_t self)
+{
+    // check
+    tb_co_rwlock_t* rwlock = (tb_co_rwlock_t*)self;
+    tb_assert_and_check_return(rwlock);
+
+    // wait the current and waiting writers, the coroutines of one scheduler are not preemptive, so we need not any atomic operations
+    while (rwlock->writing || rwlock->writers_waiting)
+    {
+        rwlock->readers_waiting++;
+        tb_co_semaphore_wait(rwlock->readers_semaphore, -1);
+        rwlock->readers_waiting--;
+    }
+
+    // enter it
+    rwlock->readers++;
+}
+tb_bool_t tb_co_rwlock_enter_read_try(tb_co_rwlock_ref_t self)
+{
+    // check
+    tb_co_rwlock_t* rwlock = (tb_co_rwlock_t*)self;
+    tb_assert_and_check_return_val(rwlock, tb_false);
+
+    // try to enter it
+    tb_check_return_val(!rwlock->writing && !rwlock->writers_waiting, tb_false);
+    rwlock->readers++;
+    return tb_true;
+}
+tb_void_t tb_co_rwlock_leave_read(tb_co_rwlock_ref_t self)
+{
+    // check
+    tb_co_rwlock_t* rwlock = (tb_co_rwlock_t*)self;
+    tb_assert_and_check_return(rwlock && rwlock->readers);
+
+    // wake up one waiting writer if we are the last reader
+    if (!--rwlock->readers && rwlock->writers_waiting)
+        tb_co_semaphore_post(rwlock->writers_semaphore, 1);
+}
+tb_void_t tb_co_rwlock_enter_write(tb_co_rwlock_ref_t self)
+{
+    // check
+    tb_co_rwlock_t* rwlock = (tb_co_rwlock_t*)self;
+    tb_assert_and_check_return(rwlock);
+
+    // wait the current writer and readers
+    while (rwlock->writing || rwlock->readers)
+    {
+        rwlock->writers_waiting++;
+        tb_co_semaphore_wait(rwlock->writers_semaphore, -1);
+        rwlock->writers_waiting--;
+    }
+
+    // enter it
+    rwlock->writing = tb_true;
+}
+tb_bool_t tb_co_rwlock_enter_write_try(tb_co_rwlock_ref_t self)
+{
+    // check
+    tb_co_rwlock_t* rwlock = (tb_co_rwlock_t*)self;
+    tb_assert_and_check_return_val(rwlock, tb_false);
+
+    // try to enter it
+    tb_check_return_val(!rwlock->writing && !rwlock->readers, tb_false);
+    rwlock->writing = tb_true;
+    return tb_true;
+}
+tb_void_t tb_co_rwlock_leave_write(tb_co_rwlock_ref_t self)
+{
+    // check
+    tb_co_rwlock_t* rwlock = (tb_co_rwlock_t*)self;
+    tb_assert_and_check_return(rwlock && rwlock->writing);
+
+    // leave it
+    rwlock->writing = tb_false;
+
+    // wake up the next writer first, otherwise wake up all waiting readers
+    if (rwlock->writers_waiting) tb_co_semaphore_post(rwlock->writers_semaphore, 1);
+    else if (rwlock->readers_waiting) tb_co_semaphore_post(rwlock->readers_semaphore, rwlock->readers_waiting);
+}
@@ -31,6 +31,7 @@
  */
 #include "scheduler.h"
 #include "impl/impl.h"
+#include "../stream/stream.h"
 #include "../algorithm/algorithm.h"
 
 /* //////////////////////////////////////////////////////////////////////////////////////
@@ -155,6 +156,9 @@ tb_void_t tb_co_scheduler_exit(tb_co_scheduler_ref_t self)
     // exit suspend coroutines
     tb_list_entry_exit(&scheduler->coroutines_suspend);
 
+    // exit the switch trace
+    tb_co_scheduler_trace(self, 0);
+
     // exit the scheduler
     tb_free(scheduler);
 }
@@ -196,6 +200,10 @@ tb_void_t tb_co_scheduler_loop(tb_co_scheduler_ref_t self, tb_bool_t exclusive)
     tb_co_scheduler_io_need(scheduler);
 #endif
 
+    // init the loop time
+    scheduler->time_start   = tb_co_scheduler_clock();
+    scheduler->time_stop    = 0;
+
     // schedule all ready coroutines
     while (tb_list_entry_size(&scheduler->coroutines_ready))
     {
@@ -214,7 +222,8 @@ tb_void_t tb_co_scheduler_loop(tb_co_scheduler_ref_t self, tb_bool_t exclusive)
     }
 
     // stop it
-    scheduler->stopped = tb_true;
+    scheduler->stopped      = tb_true;
+    scheduler->time_stop    = tb_co_scheduler_clock();
 
 #ifdef __tb_thread_local__
     g_scheduler_self_ex = tb_null;
@@ -237,3 +246,101 @@ tb_co_scheduler_ref_t tb_co_scheduler_self()
     return (tb_co_scheduler_ref_t)(g_scheduler_self_ex? g_scheduler_self_ex : tb_thread_local_get(&g_scheduler_self));
 #endif
 }
+tb_bool_t tb_co_scheduler_stats(tb_co_scheduler_ref_t self, tb_co_scheduler_stats_ref_t stats)
+{
+    // check
+    tb_co_scheduler_t* scheduler = (tb_co_scheduler_t*)self;
+    tb_assert_and_check_return_val(scheduler && stats, tb_false);
+
+    // get the counters
+    *stats = scheduler->stats;
+    stats->ready    = tb_co_scheduler_ready_count(scheduler);
+    stats->suspend  = tb_co_scheduler_suspend_count(scheduler);
+
+    // compute the time spent in coroutines
+    tb_hong_t time_start = scheduler->time_start;
+    tb_hong_t time_stop = scheduler->time_stop;
+    tb_hong_t duration = time_start? (time_stop? time_stop : tb_co_scheduler_clock()) - time_start : 0;
+    stats->running_time = duration > stats->polling_time? duration - stats->polling_time : 0;
+    return tb_true;
+}
+tb_bool_t tb_co_scheduler_trace(tb_co_scheduler_ref_t self, tb_size_t maxn)
+{
+    // check
+    tb_co_scheduler_t* scheduler = (tb_co_scheduler_t*)self;
+    tb_assert_and_check_return_val(scheduler, tb_false);
+
+    // exit the previous trace
+    tb_co_scheduler_trace_t* trace = scheduler->trace;
+    if (trace)
+    {
+        scheduler->trace = tb_null;
+        if (trace->entries) tb_free(trace->entries);
+        tb_free(trace);
+    }
+
+    // disable it?
+    tb_check_return_val(maxn, tb_true);
+
+    // init trace
+    trace = tb_malloc0_type(tb_co_scheduler_trace_t);
+    tb_assert_and_check_return_val(trace, tb_false);
+
+    // init entries
+    trace->entries = tb_nalloc_type(maxn, tb_co_scheduler_trace_entry_t);
+    if (!trace->entries)
+    {
+        tb_free(trace);
+        return tb_false;
+    }
+    trace->maxn = maxn;
+
+    // enable it
+    scheduler->trace = trace;
+    return tb_true;
+}
+tb_bool_t tb_co_scheduler_trace_dump(tb_co_scheduler_ref_t self, tb_stream_ref_t stream)
+{
+    // check
+    tb_co_scheduler_t* scheduler = (tb_co_scheduler_t*)self;
+    tb_assert_and_check_return_val(scheduler && stream, tb_false);
+
+    // no trace?
+    tb_co_scheduler_trace_t* trace = scheduler->trace;
+    tb_check_return_val(trace, tb_false);
+
+    // dump the head
+    if (tb_stream_printf(stream, "{\"traceEvents\":[\n") < 0) return tb_false;
+
+    // dump all slices from the oldest switch event
+    tb_bool_t ok    = tb_true;
+    tb_size_t i     = 0;
+    tb_size_t size  = trace->size;
+    tb_size_t head  = (trace->tail + trace->maxn - size) % trace->maxn;
+    tb_hong_t end   = scheduler->time_stop? scheduler->time_stop : tb_co_scheduler_clock();
+    for (i = 0; i < size && ok; i++)
+    {
+        // get the switch event and the end time of this slice
+        tb_co_scheduler_trace_entry_t* entry = &trace->entries[(head + i) % trace->maxn];
+        tb_hong_t time_stop = i + 1 < size? trace->entries[(head + i + 1) % trace->maxn].time : end;
+
+        // get the slice name
+        tb_char_t name[64];
+        if (!entry->coroutine) tb_strlcpy(name, "poller", sizeof(name));
+        else if (entry->coroutine == (tb_cpointer_t)&scheduler->original) tb_strlcpy(name, "scheduler", sizeof(name));
+        else tb_snprintf(name, sizeof(name), "coroutine(%p)", entry->coroutine);
+
+        // dump this slice
+        ok = tb_stream_printf(stream, "%s{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%lld,\"dur\":%lld,\"pid\":1,\"tid\":%lu}\n"
+                                    , i? "," : ""
+                                    , name
+                                    , entry->coroutine? "coroutine" : "poller"
+                                    , entry->time
+                                    , time_stop > entry->time? time_stop - entry->time : 0
+                                    , (tb_size_t)scheduler) >= 0;
+    }
+
+    // dump the tail
+    if (ok) ok = tb_stream_printf(stream, "],\"displayTimeUnit\":\"ms\"}\n") >= 0;
+    return ok;
+}
@@ -39,6 +39,35 @@ __tb_extern_c_enter__
 /// the coroutine scheduler ref type
 typedef __tb_typeref__(co_scheduler);
 
+/// the coroutine scheduler statistics type
+typedef struct __tb_co_scheduler_stats_t
+{
+    /// the ready coroutines count
+    tb_size_t               ready;
+
+    /// the suspended coroutines count
+    tb_size_t               suspend;
+
+    /// the context switches count
+    tb_hize_t               switches;
+
+    /// the poller wakeups count
+    tb_hize_t               wakeups;
+
+    /// the triggered poller events count
+    tb_hize_t               events;
+
+    /// the fired timer tasks count
+    tb_hize_t               timers;
+
+    /// the time spent in coroutines (us)
+    tb_hong_t               running_time;
+
+    /// the time spent in poller (us)
+    tb_hong_t               polling_time;
+
+}tb_co_scheduler_stats_t, *tb_co_scheduler_stats_ref_t;
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * interfaces
  */
@@ -75,6 +104,44 @@ tb_void_t               tb_co_scheduler_loop(tb_co_scheduler_ref_t schedule, tb_
  */
 tb_co_scheduler_ref_t   tb_co_scheduler_self(tb_noarg_t);
 
+/*! get the runtime statistics of the scheduler
+ *
+ * the counters are accumulated since the scheduler was initialized,
+ * e.g. we can compute the context switches per second from the difference of two snapshots.
+ *
+ * @note it is approximate if be called in other threads,
+ * and it only covers the stackful scheduler, the stackless scheduler (tb_lo_scheduler_t) has no statistics
+ *
+ * @param scheduler     the scheduler
+ * @param stats         the statistics
+ *
+ * @return              tb_true or tb_false
+ */
+tb_bool_t               tb_co_scheduler_stats(tb_co_scheduler_ref_t scheduler, tb_co_scheduler_stats_ref_t stats);
+
+/*! enable or disable the switch trace of the scheduler
+ *
+ * it will record the latest switch events (timestamp and coroutine) into a ring buffer
+ *
+ * @param scheduler     the scheduler
+ * @param maxn          the maximum count of the recorded switch events, disable it if be zero
+ *
+ * @return              tb_true or tb_false
+ */
+tb_bool_t               tb_co_scheduler_trace(tb_co_scheduler_ref_t scheduler, tb_size_t maxn);
+
+/*! dump the recorded switch events as chrome trace json (chrome://tracing, perfetto)
+ *
+ * each event is a slice of the running coroutine or the poller,
+ * so we can find the coroutines which run too long without yielding.
+ *
+ * @param scheduler     the scheduler
+ * @param stream        the output stream
+ *
+ * @return              tb_true or tb_false
+ */
+tb_bool_t               tb_co_scheduler_trace_dump(tb_co_scheduler_ref_t scheduler, tb_stream_ref_t stream);
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * extern
  */
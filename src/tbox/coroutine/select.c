@@ -0,0 +1,293 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        select.c
+ * @ingroup     coroutine
+ *
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * trace
+ */
+#define TB_TRACE_MODULE_NAME            "select"
+#define TB_TRACE_MODULE_DEBUG           (0)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "select.h"
+#include "coroutine.h"
+#include "scheduler.h"
+#include "impl/impl.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the maximum count of the channel waiters in the stack
+#ifdef __tb_small__
+#   define TB_CO_SELECT_WAITERS_MAXN        (8)
+#else
+#   define TB_CO_SELECT_WAITERS_MAXN        (16)
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static tb_long_t tb_co_select_try(tb_co_select_case_t* cases, tb_size_t count, tb_size_t first)
+{
+    // check
+    tb_assert(cases && count && first < count);
+
+    // try the first case (the notified case) and other channel cases in order
+    tb_size_t k = 0;
+    for (k = 0; k < count; k++)
+    {
+        tb_size_t               i = k? (k <= first? k - 1 : k) : first;
+        tb_co_select_case_ref_t item = &cases[i];
+        switch (item->type)
+        {
+        case TB_CO_SELECT_CASE_RECV:
+            if (tb_co_channel_recv_try(item->channel, &item->data)) return (tb_long_t)i;
+            break;
+        case TB_CO_SELECT_CASE_SEND:
+            if (tb_co_channel_send_try(item->channel, item->data)) return (tb_long_t)i;
+            break;
+        default:
+            break;
+        }
+    }
+    return -1;
+}
+static tb_bool_t tb_co_select_wait(tb_co_select_t* select, tb_co_scheduler_io_ref_t scheduler_io, tb_co_channel_waiter_t* waiters)
+{
+    // check
+    tb_assert(select && select->coroutine && select->cases && waiters);
+
+    // init select
+    tb_coroutine_t* coroutine = select->coroutine;
+    select->ready   = -1;
+    select->timeout = -1;
+
+    // mark the current coroutine as selecting
+    coroutine->rs.wait.task         = tb_null;
+    coroutine->rs.wait.object.type  = TB_POLLER_OBJECT_NONE;
+    coroutine->rs.wait.select       = select;
+
+    // init waiters
+    tb_size_t i = 0;
+    tb_size_t n = select->count;
+    for (i = 0; i < n; i++)
+    {
+        waiters[i].waiting  = 0;
+        waiters[i].passed   = 0;
+    }
+
+    // register all cases
+    tb_bool_t   ok = tb_true;
+    tb_long_t   timeout = -1;
+    tb_long_t   index_default = -1;
+    for (i = 0; i < n && ok && select->ready < 0; i++)
+    {
+        tb_co_select_case_ref_t item = &select->cases[i];
+        switch (item->type)
+        {
+        case TB_CO_SELECT_CASE_RECV:
+        case TB_CO_SELECT_CASE_SEND:
+            {
+                // wait the channel
+                tb_co_channel_waiter_t* waiter = &waiters[i];
+                waiter->coroutine   = coroutine;
+                waiter->select      = select;
+                waiter->index       = i;
+                waiter->data        = item->type == TB_CO_SELECT_CASE_SEND? item->data : tb_null;
+                waiter->is_send     = item->type == TB_CO_SELECT_CASE_SEND? 1 : 0;
+                tb_co_channel_select_wait(item->channel, waiter);
+            }
+            break;
+        case TB_CO_SELECT_CASE_WAIT:
+            {
+                // wait the socket or pipe, it may be ready now if exists the cached events
+                tb_assert_and_check_break_state(scheduler_io, ok, tb_false);
+                tb_long_t events = tb_co_scheduler_io_select_wait(scheduler_io, select, &item->object, item->events);
+                if (events > 0)
+                {
+                    item->events = (tb_size_t)events;
+                    select->ready = (tb_long_t)i;
+                }
+                else if (events < 0) ok = tb_false;
+            }
+            break;
+        case TB_CO_SELECT_CASE_TIMEOUT:
+            {
+                // get the default case and the minimum timeout
+                if (!item->timeout)
+                {
+                    if (index_default < 0) index_default = (tb_long_t)i;
+                }
+                else if (item->timeout > 0 && (timeout < 0 || item->timeout < timeout))
+                {
+                    timeout = item->timeout;
+                    select->timeout = (tb_long_t)i;
+                }
+            }
+            break;
+        default:
+            break;
+        }
+    }
+
+    // no ready cases? select the default case
+    if (ok && select->ready < 0 && index_default >= 0)
+        select->ready = index_default;
+
+    // wait it
+    if (ok && select->ready < 0)
+    {
+        // start the timeout timer
+        if (timeout > 0)
+        {
+            tb_assert(scheduler_io);
+            ok = tb_co_scheduler_io_select_timeout(scheduler_io, select, timeout);
+        }
+
+        // suspend the current coroutine and wait the ready case
+        if (ok) tb_co_scheduler_suspend((tb_co_scheduler_t*)tb_coroutine_scheduler(coroutine), tb_null);
+    }
+
+    // cancel all waiting channels
+    for (i = 0; i < n; i++)
+    {
+        tb_co_select_case_ref_t item = &select->cases[i];
+        if (item->type == TB_CO_SELECT_CASE_RECV || item->type == TB_CO_SELECT_CASE_SEND)
+            tb_co_channel_select_cancel(item->channel, &waiters[i]);
+    }
+
+    // cancel all waiting io events and timer
+    if (scheduler_io) tb_co_scheduler_io_select_leave(scheduler_io, select);
+    coroutine->rs.wait.select = tb_null;
+
+    // ok?
+    return ok;
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+tb_bool_t tb_co_select_wake(tb_co_select_t* select, tb_size_t index)
+{
+    // check
+    tb_assert(select && select->coroutine && index < select->count);
+
+    // it has been woken up by other cases?
+    tb_check_return_val(select->ready < 0, tb_false);
+
+    // trace
+    tb_trace_d("coroutine(%p): case(%lu) is ready", select->coroutine, index);
+
+    // save the ready case and resume the selecting coroutine
+    select->ready = (tb_long_t)index;
+    tb_co_scheduler_resume((tb_co_scheduler_t*)tb_coroutine_scheduler(select->coroutine), select->coroutine, tb_null);
+    return tb_true;
+}
+tb_long_t tb_co_select(tb_co_select_case_t* cases, tb_size_t count)
+{
+    // check
+    tb_assert_and_check_return_val(cases && count, -1);
+
+    // get the current scheduler, select() must be called in coroutine
+    tb_co_scheduler_t* scheduler = (tb_co_scheduler_t*)tb_co_scheduler_self();
+    tb_assert_and_check_return_val(scheduler, -1);
+
+    // get the current coroutine
+    tb_coroutine_t* coroutine = tb_co_scheduler_running(scheduler);
+    tb_assert_and_check_return_val(coroutine, -1);
+
+    // need io scheduler?
+    tb_size_t i = 0;
+    tb_co_scheduler_io_ref_t scheduler_io = tb_null;
+    for (i = 0; i < count; i++)
+    {
+        tb_co_select_case_ref_t item = &cases[i];
+        if (item->type == TB_CO_SELECT_CASE_WAIT || (item->type == TB_CO_SELECT_CASE_TIMEOUT && item->timeout > 0))
+        {
+            scheduler_io = tb_co_scheduler_io_need(scheduler);
+            tb_assert_and_check_return_val(scheduler_io, -1);
+            break;
+        }
+    }
+
+    // init channel waiters, we use the stack directly if the cases count is small
+    tb_co_channel_waiter_t  waiters_stack[TB_CO_SELECT_WAITERS_MAXN];
+    tb_co_channel_waiter_t* waiters = count <= TB_CO_SELECT_WAITERS_MAXN? waiters_stack : tb_nalloc_type(count, tb_co_channel_waiter_t);
+    tb_assert_and_check_return_val(waiters, -1);
+
+    // init select
+    tb_co_select_t select;
+    select.coroutine    = coroutine;
+    select.cases        = cases;
+    select.count        = count;
+    select.ready        = -1;
+    select.timeout      = -1;
+
+    // select the first ready case
+    tb_long_t ready = -1;
+    tb_size_t first = 0;
+    while (!scheduler->stopped)
+    {
+        // try all channel cases first
+        ready = tb_co_select_try(cases, count, first);
+        tb_check_break(ready < 0);
+
+        // wait all cases
+        if (!tb_co_select_wait(&select, scheduler_io, waiters)) break;
+
+        // no ready case? the scheduler has been stopped
+        ready = select.ready;
+        tb_check_break(ready >= 0);
+
+        // get the ready case
+        tb_co_select_case_ref_t item = &cases[ready];
+        if (item->type == TB_CO_SELECT_CASE_RECV || item->type == TB_CO_SELECT_CASE_SEND)
+        {
+            // the data has been passed directly? (no buffer)
+            tb_co_channel_waiter_t* waiter = &waiters[ready];
+            if (waiter->passed)
+            {
+                if (item->type == TB_CO_SELECT_CASE_RECV) item->data = (tb_pointer_t)waiter->data;
+                break;
+            }
+
+            /* it is only notified by the buffered channel, we need try it again,
+             * and we need try this case first to avoid losing the notification for other waiting coroutines
+             */
+            first = (tb_size_t)ready;
+            ready = -1;
+        }
+        // the socket/pipe events or timeout
+        else break;
+    }
+
+    // exit channel waiters
+    if (waiters != waiters_stack) tb_free(waiters);
+
+    // trace
+    tb_trace_d("coroutine(%p): select case(%ld)", coroutine, ready);
+
+    // ok?
+    return ready;
+}
@@ -0,0 +1,185 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        select.h
+ * @ingroup     coroutine
+ *
+ */
+#ifndef TB_COROUTINE_SELECT_H
+#define TB_COROUTINE_SELECT_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+#include "channel.h"
+#include "../platform/poller.h"
+#include "../libc/string/string.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+/// the select case type enum
+typedef enum __tb_co_select_case_type_e
+{
+    TB_CO_SELECT_CASE_NONE      = 0
+,   TB_CO_SELECT_CASE_RECV      = 1 //!< recv data from channel
+,   TB_CO_SELECT_CASE_SEND      = 2 //!< send data into channel
+,   TB_CO_SELECT_CASE_WAIT      = 3 //!< wait events of the socket or pipe object
+,   TB_CO_SELECT_CASE_TIMEOUT   = 4 //!< timeout, it will be ready immediately if no other ready cases when the timeout is zero
+
+}tb_co_select_case_type_e;
+
+/// the select case type
+typedef struct __tb_co_select_case_t
+{
+    /// the case type
+    tb_size_t               type;
+
+    /// the channel for recv/send
+    tb_co_channel_ref_t     channel;
+
+    /// the sent data, or the received data if this case is ready
+    tb_pointer_t            data;
+
+    /// the socket or pipe object
+    tb_poller_object_t      object;
+
+    /// the waited events, or the triggered events if this case is ready
+    tb_size_t               events;
+
+    /// the timeout (ms)
+    tb_long_t               timeout;
+
+}tb_co_select_case_t, *tb_co_select_case_ref_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/*! select the first ready case and do it
+ *
+ * it will suspend the current coroutine until one of the given cases is ready,
+ * only the ready case will be done (e.g. recv or send data), and all other cases will be canceled.
+ *
+ * the cases will be checked in the given order, so the front case has the higher priority.
+ *
+ * @code
+    tb_co_select_case_t cases[3];
+    tb_co_select_case_recv(&cases[0], channel);
+    tb_co_select_case_wait_sock(&cases[1], sock, TB_POLLER_EVENT_RECV);
+    tb_co_select_case_timeout(&cases[2], 50);
+    switch (tb_co_select(cases, tb_arrayn(cases)))
+    {
+    case 0: // recv data: cases[0].data
+    case 1: // the socket is readable: cases[1].events
+    case 2: // timeout
+    default: // failed
+    }
+ * @endcode
+ *
+ * @param cases         the cases
+ * @param count         the cases count
+ *
+ * @return              the index of the ready case, -1: failed
+ */
+tb_long_t               tb_co_select(tb_co_select_case_t* cases, tb_size_t count);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * inline interfaces
+ */
+
+/*! init a case for recving data from channel
+ *
+ * @param item          the case
+ * @param channel       the channel
+ */
+static __tb_inline__ tb_void_t tb_co_select_case_recv(tb_co_select_case_ref_t item, tb_co_channel_ref_t channel)
+{
+    tb_memset_(item, 0, sizeof(tb_co_select_case_t));
+    item->type      = TB_CO_SELECT_CASE_RECV;
+    item->channel   = channel;
+}
+
+/*! init a case for sending data into channel
+ *
+ * @param item          the case
+ * @param channel       the channel
+ * @param data          the sent data
+ */
+static __tb_inline__ tb_void_t tb_co_select_case_send(tb_co_select_case_ref_t item, tb_co_channel_ref_t channel, tb_cpointer_t data)
+{
+    tb_memset_(item, 0, sizeof(tb_co_select_case_t));
+    item->type      = TB_CO_SELECT_CASE_SEND;
+    item->channel   = channel;
+    item->data      = (tb_pointer_t)data;
+}
+
+/*! init a case for waiting socket events
+ *
+ * @param item          the case
+ * @param sock          the socket
+ * @param events        the waited events, e.g. TB_POLLER_EVENT_RECV, TB_POLLER_EVENT_SEND
+ */
+static __tb_inline__ tb_void_t tb_co_select_case_wait_sock(tb_co_select_case_ref_t item, tb_socket_ref_t sock, tb_size_t events)
+{
+    tb_memset_(item, 0, sizeof(tb_co_select_case_t));
+    item->type          = TB_CO_SELECT_CASE_WAIT;
+    item->object.type   = TB_POLLER_OBJECT_SOCK;
+    item->object.ref.sock = sock;
+    item->events        = events;
+}
+
+/*! init a case for waiting pipe events
+ *
+ * @param item          the case
+ * @param pipe          the pipe file
+ * @param events        the waited events, e.g. TB_POLLER_EVENT_RECV, TB_POLLER_EVENT_SEND
+ */
+static __tb_inline__ tb_void_t tb_co_select_case_wait_pipe(tb_co_select_case_ref_t item, tb_pipe_file_ref_t pipe, tb_size_t events)
+{
+    tb_memset_(item, 0, sizeof(tb_co_select_case_t));
+    item->type          = TB_CO_SELECT_CASE_WAIT;
+    item->object.type   = TB_POLLER_OBJECT_PIPE;
+    item->object.ref.pipe = pipe;
+    item->events        = events;
+}
+
+/*! init a timeout case
+ *
+ * @param item          the case
+ * @param timeout       the timeout (ms), it will be ready immediately if no other ready cases when the timeout is zero
+ */
+static __tb_inline__ tb_void_t tb_co_select_case_timeout(tb_co_select_case_ref_t item, tb_long_t timeout)
+{
+    tb_memset_(item, 0, sizeof(tb_co_select_case_t));
+    item->type      = TB_CO_SELECT_CASE_TIMEOUT;
+    item->timeout   = timeout;
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
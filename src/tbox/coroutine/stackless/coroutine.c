@@ -178,6 +178,32 @@ tb_long_t tb_lo_coroutine_proc_status_(tb_lo_coroutine_ref_t self)
     // get process status
     return coroutine->rs.wait.object_event;
 }
+tb_bool_t tb_lo_coroutine_waittask_(tb_lo_coroutine_ref_t self, tb_lo_coroutine_task_func_t func, tb_cpointer_t priv)
+{
+    // check
+    tb_lo_coroutine_t* coroutine = (tb_lo_coroutine_t*)self;
+    tb_assert(coroutine && func);
+
+    // get scheduler
+    tb_lo_scheduler_t* scheduler = (tb_lo_scheduler_t*)coroutine->scheduler;
+    tb_assert(scheduler);
+
+    // init io scheduler first
+    coroutine->rs.wait.task_result = -1;
+    if (!tb_lo_scheduler_io_need(scheduler)) return tb_false;
+
+    // wait it
+    return tb_lo_scheduler_io_wait_task(scheduler->scheduler_io, func, priv);
+}
+tb_long_t tb_lo_coroutine_task_result_(tb_lo_coroutine_ref_t self)
+{
+    // check
+    tb_lo_coroutine_t* coroutine = (tb_lo_coroutine_t*)self;
+    tb_assert(coroutine);
+
+    // get the task result
+    return coroutine->rs.wait.task_result;
+}
 #endif
 tb_long_t tb_lo_coroutine_waitret_(tb_lo_coroutine_ref_t self)
 {
@@ -216,6 +216,22 @@ do \
     \
 } while(0)
 
+/*! run the blocking task in the helper thread pool and wait it
+ *
+ * only the current coroutine will be suspended, and we can get the return value of the task by tb_lo_coroutine_task_result()
+ *
+ * @note the priv data must be still valid after suspending, e.g. the user private data of coroutine, not the local variable
+ */
+#define tb_lo_coroutine_wait_task(func, priv) \
+do \
+{ \
+    if (tb_lo_coroutine_waittask_(tb_lo_coroutine_self(), func, priv)) \
+    { \
+        tb_lo_coroutine_suspend(); \
+    } \
+    \
+} while(0)
+
 /// wait until coroutine be true
 #define tb_lo_coroutine_wait_until(cond) \
 do \
@@ -233,6 +249,9 @@ do \
 /// get waited return result
 #define tb_lo_coroutine_wait_result()           tb_lo_coroutine_waitret_(tb_lo_coroutine_self())
 
+/// get the return value of the waited blocking task
+#define tb_lo_coroutine_task_result()           tb_lo_coroutine_task_result_(tb_lo_coroutine_self())
+
 /// get waited exited status of process
 #define tb_lo_coroutine_proc_status()           tb_lo_coroutine_proc_status_(tb_lo_coroutine_self())
 
@@ -350,6 +369,24 @@ tb_long_t               tb_lo_coroutine_waitret_(tb_lo_coroutine_ref_t coroutine
  */
 tb_long_t               tb_lo_coroutine_proc_status_(tb_lo_coroutine_ref_t coroutine);
 
+/* wait the blocking task in the helper thread pool
+ *
+ * @param coroutine     the coroutine
+ * @param func          the task function
+ * @param priv          the user private data as the argument of function
+ *
+ * @return              suspend coroutine if be tb_true
+ */
+tb_bool_t               tb_lo_coroutine_waittask_(tb_lo_coroutine_ref_t coroutine, tb_lo_coroutine_task_func_t func, tb_cpointer_t priv);
+
+/* get the return value of the waited blocking task
+ *
+ * @param coroutine     the coroutine
+ *
+ * @return              the return value of the task function, -1: failed
+ */
+tb_long_t               tb_lo_coroutine_task_result_(tb_lo_coroutine_ref_t coroutine);
+
 /* free the user private data for pass()
  *
  * @note only be a wrapper of free() for tb_lo_coroutine_pass()
@@ -49,5 +49,11 @@ typedef tb_void_t       (*tb_lo_coroutine_func_t)(tb_lo_coroutine_ref_t coroutin
  */
 typedef tb_void_t       (*tb_lo_coroutine_free_t)(tb_cpointer_t priv);
 
+/*! the blocking task function type, it will be called in the helper thread pool
+ *
+ * @param priv          the user private data from tb_lo_coroutine_wait_task(.., priv)
+ */
+typedef tb_long_t       (*tb_lo_coroutine_task_func_t)(tb_cpointer_t priv);
+
 
 #endif
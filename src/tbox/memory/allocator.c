@@ -42,6 +42,41 @@
 // the allocator
 __tb_extern_c__ tb_allocator_ref_t  g_allocator = tb_null;
 
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+
+/* adjust the allocated data to the aligned address
+ *
+ * we save the different bytes with two bytes before the aligned data,
+ * so we need allocate (size + align + 1) bytes and the alignment must be not larger than 32K
+ */
+static __tb_inline__ tb_size_t tb_allocator_align_diff(tb_byte_t const* data, tb_size_t align)
+{
+    // the different bytes, we need two bytes at least
+    tb_size_t diff = ((~(tb_size_t)data) & (align - 1)) + 1;
+    if (diff < 2) diff += align;
+    return diff;
+}
+static __tb_inline__ tb_byte_t* tb_allocator_align_adjust(tb_byte_t* data, tb_size_t align)
+{
+    // adjust the address
+    tb_size_t diff = tb_allocator_align_diff(data, align);
+    data += diff;
+
+    // check
+    tb_assert(!((tb_size_t)data & (align - 1)));
+
+    // save the different bytes
+    data[-1] = (tb_byte_t)diff;
+    data[-2] = (tb_byte_t)(diff >> 8);
+    return data;
+}
+static __tb_inline__ tb_byte_t* tb_allocator_align_origin(tb_byte_t* data)
+{
+    return data - (((tb_size_t)data[-2] << 8) | data[-1]);
+}
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * implementation
  */
@@ -356,27 +391,15 @@ tb_bool_t tb_allocator_large_free_(tb_allocator_ref_t allocator, tb_pointer_t da
 tb_pointer_t tb_allocator_align_malloc_(tb_allocator_ref_t allocator, tb_size_t size, tb_size_t align __tb_debug_decl__)
 {
     // check
-    tb_assertf(!(align & 3), "invalid alignment size: %lu", align);
-    tb_check_return_val(!(align & 3), tb_null);
+    tb_assertf(!(align & 3) && align <= 32768, "invalid alignment size: %lu", align);
+    tb_check_return_val(!(align & 3) && align <= 32768, tb_null);
 
     // malloc it
-    tb_byte_t* data = (tb_byte_t*)tb_allocator_malloc_(allocator, size + align __tb_debug_args__);
+    tb_byte_t* data = (tb_byte_t*)tb_allocator_malloc_(allocator, size + align + 1 __tb_debug_args__);
     tb_check_return_val(data, tb_null);
 
-    // the different bytes
-    tb_byte_t diff = (tb_byte_t)((~(tb_long_t)data) & (align - 1)) + 1;
-
-    // adjust the address
-    data += diff;
-
-    // check
-    tb_assert(!((tb_size_t)data & (align - 1)));
-
-    // save the different bytes
-    data[-1] = diff;
-
     // ok?
-    return (tb_pointer_t)data;
+    return (tb_pointer_t)tb_allocator_align_adjust(data, align);
 }
 tb_pointer_t tb_allocator_align_malloc0_(tb_allocator_ref_t allocator, tb_size_t size, tb_size_t align __tb_debug_decl__)
 {
@@ -409,49 +432,40 @@ tb_pointer_t tb_allocator_align_nalloc0_(tb_allocator_ref_t allocator, tb_size_t
 tb_pointer_t tb_allocator_align_ralloc_(tb_allocator_ref_t allocator, tb_pointer_t data, tb_size_t size, tb_size_t align __tb_debug_decl__)
 {
     // check align
-    tb_assertf(!(align & 3), "invalid alignment size: %lu", align);
-    tb_check_return_val(!(align & 3), tb_null);
+    tb_assertf(!(align & 3) && align <= 32768, "invalid alignment size: %lu", align);
+    tb_check_return_val(!(align & 3) && align <= 32768, tb_null);
 
     // ralloc?
-    tb_byte_t diff = 0;
     if (data)
     {
         // check address
         tb_assertf(!((tb_size_t)data & (align - 1)), "invalid address %p", data);
         tb_check_return_val(!((tb_size_t)data & (align - 1)), tb_null);
 
-        // the different bytes
-        diff = ((tb_byte_t*)data)[-1];
-
-        // adjust the address
-        data = (tb_byte_t*)data - diff;
+        // the old different bytes
+        tb_byte_t* base = tb_allocator_align_origin((tb_byte_t*)data);
+        tb_size_t  diff = (tb_byte_t*)data - base;
 
         // ralloc it
-        data = tb_allocator_ralloc_(allocator, data, size + align __tb_debug_args__);
+        data = tb_allocator_ralloc_(allocator, base, size + align + 1 __tb_debug_args__);
         tb_check_return_val(data, tb_null);
+
+        /* the new base address may have a different alignment offset, so we need move the payload to the new aligned address,
+         * the old different bytes are not larger than (align + 1), so the moved data is still in the new space
+         */
+        tb_size_t diff_new = tb_allocator_align_diff((tb_byte_t*)data, align);
+        if (diff_new != diff) tb_memmov_((tb_byte_t*)data + diff_new, (tb_byte_t*)data + diff, size);
     }
     // no data?
     else
     {
         // malloc it directly
-        data = tb_allocator_malloc_(allocator, size + align __tb_debug_args__);
+        data = tb_allocator_malloc_(allocator, size + align + 1 __tb_debug_args__);
         tb_check_return_val(data, tb_null);
     }
 
-    // the different bytes
-    diff = (tb_byte_t)((~(tb_long_t)data) & (align - 1)) + 1;
-
-    // adjust the address
-    data = (tb_byte_t*)data + diff;
-
-    // check
-    tb_assert(!((tb_size_t)data & (align - 1)));
-
-    // save the different bytes
-    ((tb_byte_t*)data)[-1] = diff;
-
     // ok?
-    return data;
+    return tb_allocator_align_adjust((tb_byte_t*)data, align);
 }
 tb_bool_t tb_allocator_align_free_(tb_allocator_ref_t allocator, tb_pointer_t data __tb_debug_decl__)
 {
@@ -459,14 +473,8 @@ tb_bool_t tb_allocator_align_free_(tb_allocator_ref_t allocator, tb_pointer_t da
     tb_assert_and_check_return_val(data, tb_false);
     tb_assert(!((tb_size_t)data & 3));
 
-    // the different bytes
-    tb_byte_t diff = ((tb_byte_t*)data)[-1];
-
-    // adjust the address
-    data = (tb_byte_t*)data - diff;
-
     // free it
-    return tb_allocator_free_(allocator, data __tb_debug_args__);
+    return tb_allocator_free_(allocator, tb_allocator_align_origin((tb_byte_t*)data) __tb_debug_args__);
 }
 tb_void_t tb_allocator_clear(tb_allocator_ref_t allocator)
 {
@@ -338,7 +338,7 @@ tb_bool_t               tb_allocator_large_free_(tb_allocator_ref_t allocator, t
  *
  * @param allocator     the allocator
  * @param size          the size
- * @param align         the alignment bytes
+ * @param align         the alignment bytes, it must be a multiple of 4 and not larger than 32K, e.g. the page size
  *
  * @return              the data address
  */
@@ -0,0 +1,437 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        buffer_chain.c
+ * @ingroup     memory
+ *
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * trace
+ */
+#define TB_TRACE_MODULE_NAME                "buffer_chain"
+#define TB_TRACE_MODULE_DEBUG               (0)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "buffer_chain.h"
+#include "../libc/libc.h"
+#include "../platform/atomic.h"
+#include "../container/list_entry.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the block size for merging the small copied data
+#ifdef __tb_small__
+#   define TB_BUFFER_CHAIN_BLOCK_SIZE       (1024)
+#else
+#   define TB_BUFFER_CHAIN_BLOCK_SIZE       (4096)
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the buffer chain block type
+typedef struct __tb_buffer_chain_block_t
+{
+    // the reference count
+    tb_atomic32_t               refn;
+
+    // the data, it is the inline data after this block if be copied, or it is the owned data
+    tb_byte_t*                  data;
+
+    // the used size
+    tb_size_t                   size;
+
+    // the data maxn
+    tb_size_t                   maxn;
+
+}tb_buffer_chain_block_t;
+
+// the buffer chain slice type
+typedef struct __tb_buffer_chain_slice_t
+{
+    // the list entry
+    tb_list_entry_t             entry;
+
+    // the block, it is null if the data is borrowed
+    tb_buffer_chain_block_t*    block;
+
+    // the data
+    tb_byte_t const*            data;
+
+    // the size
+    tb_size_t                   size;
+
+}tb_buffer_chain_slice_t;
+
+// the buffer chain type
+typedef struct __tb_buffer_chain_t
+{
+    // the slices
+    tb_list_entry_head_t        slices;
+
+    // the data size
+    tb_size_t                   size;
+
+}tb_buffer_chain_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static tb_buffer_chain_block_t* tb_buffer_chain_block_init(tb_byte_t* data, tb_size_t size, tb_size_t maxn)
+{
+    // make block, the inline data will be allocated after it if no the owned data
+    tb_buffer_chain_block_t* block = (tb_buffer_chain_block_t*)tb_malloc(sizeof(tb_buffer_chain_block_t) + (data? 0 : maxn));
+    tb_assert_and_check_return_val(block, tb_null);
+
+    // init block
+    tb_atomic32_init(&block->refn, 1);
+    block->data = data? data : (tb_byte_t*)&block[1];
+    block->size = size;
+    block->maxn = maxn;
+    return block;
+}
+static __tb_inline__ tb_void_t tb_buffer_chain_block_retain(tb_buffer_chain_block_t* block)
+{
+    if (block) tb_atomic32_fetch_and_add(&block->refn, 1);
+}
+static tb_void_t tb_buffer_chain_block_release(tb_buffer_chain_block_t* block)
+{
+    // the last reference? free it
+    if (block && tb_atomic32_fetch_and_sub(&block->refn, 1) == 1)
+    {
+        if (block->data != (tb_byte_t*)&block[1]) tb_free(block->data);
+        tb_free(block);
+    }
+}
+static tb_buffer_chain_slice_t* tb_buffer_chain_slice_init(tb_buffer_chain_block_t* block, tb_byte_t const* data, tb_size_t size)
+{
+    // make slice
+    tb_buffer_chain_slice_t* slice = tb_malloc0_type(tb_buffer_chain_slice_t);
+    tb_assert_and_check_return_val(slice, tb_null);
+
+    // init slice and retain the block
+    slice->block = block;
+    slice->data  = data;
+    slice->size  = size;
+    tb_buffer_chain_block_retain(block);
+    return slice;
+}
+static tb_void_t tb_buffer_chain_slice_exit(tb_buffer_chain_slice_t* slice)
+{
+    if (slice)
+    {
+        tb_buffer_chain_block_release(slice->block);
+        tb_free(slice);
+    }
+}
+static tb_bool_t tb_buffer_chain_insert(tb_buffer_chain_t* chain, tb_buffer_chain_block_t* block, tb_byte_t const* data, tb_size_t size, tb_bool_t head)
+{
+    // make slice
+    tb_buffer_chain_slice_t* slice = tb_buffer_chain_slice_init(block, data, size);
+    tb_check_return_val(slice, tb_false);
+
+    // insert it
+    if (head) tb_list_entry_insert_head(&chain->slices, &slice->entry);
+    else tb_list_entry_insert_tail(&chain->slices, &slice->entry);
+    chain->size += size;
+    return tb_true;
+}
+static tb_bool_t tb_buffer_chain_insert_copy(tb_buffer_chain_t* chain, tb_byte_t const* data, tb_size_t size, tb_bool_t head)
+{
+    // attempt to merge the small data into the tail block if only this slice uses it
+    if (!head && !tb_list_entry_is_null(&chain->slices))
+    {
+        tb_buffer_chain_slice_t*    slice = (tb_buffer_chain_slice_t*)tb_list_entry_last(&chain->slices);
+        tb_buffer_chain_block_t*    block = slice->block;
+        if (    block
+            &&  block->data == (tb_byte_t*)&block[1]
+            &&  slice->data + slice->size == block->data + block->size
+            &&  block->size + size <= block->maxn
+            &&  tb_atomic32_get(&block->refn) == 1)
+        {
+            tb_memcpy(block->data + block->size, data, size);
+            block->size += size;
+            slice->size += size;
+            chain->size += size;
+            return tb_true;
+        }
+    }
+
+    // make a new block
+    tb_buffer_chain_block_t* block = tb_buffer_chain_block_init(tb_null, size, tb_max(size, TB_BUFFER_CHAIN_BLOCK_SIZE));
+    tb_check_return_val(block, tb_false);
+
+    // copy data
+    tb_memcpy(block->data, data, size);
+
+    // insert it, the slice will retain the block
+    tb_bool_t ok = tb_buffer_chain_insert(chain, block, block->data, size, head);
+    tb_buffer_chain_block_release(block);
+    return ok;
+}
+static tb_bool_t tb_buffer_chain_insert_owned(tb_buffer_chain_t* chain, tb_byte_t* data, tb_size_t size, tb_bool_t head)
+{
+    // make block
+    tb_buffer_chain_block_t* block = tb_buffer_chain_block_init(data, size, size);
+    if (!block)
+    {
+        tb_free(data);
+        return tb_false;
+    }
+
+    // insert it, the slice will retain the block
+    tb_bool_t ok = tb_buffer_chain_insert(chain, block, data, size, head);
+    tb_buffer_chain_block_release(block);
+    return ok;
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+tb_buffer_chain_ref_t tb_buffer_chain_init()
+{
+    // make chain
+    tb_buffer_chain_t* chain = tb_malloc0_type(tb_buffer_chain_t);
+    tb_assert_and_check_return_val(chain, tb_null);
+
+    // init slices
+    tb_list_entry_init(&chain->slices, tb_buffer_chain_slice_t, entry, tb_null);
+    return (tb_buffer_chain_ref_t)chain;
+}
+tb_void_t tb_buffer_chain_exit(tb_buffer_chain_ref_t self)
+{
+    // check
+    tb_buffer_chain_t* chain = (tb_buffer_chain_t*)self;
+    tb_assert_and_check_return(chain);
+
+    // clear it
+    tb_buffer_chain_clear(self);
+
+    // exit slices
+    tb_list_entry_exit(&chain->slices);
+
+    // exit it
+    tb_free(chain);
+}
+tb_void_t tb_buffer_chain_clear(tb_buffer_chain_ref_t self)
+{
+    // check
+    tb_buffer_chain_t* chain = (tb_buffer_chain_t*)self;
+    tb_assert_and_check_return(chain);
+
+    // exit all slices
+    while (!tb_list_entry_is_null(&chain->slices))
+    {
+        tb_buffer_chain_slice_t* slice = (tb_buffer_chain_slice_t*)tb_list_entry_head(&chain->slices);
+        tb_list_entry_remove_head(&chain->slices);
+        tb_buffer_chain_slice_exit(slice);
+    }
+    chain->size = 0;
+}
+tb_size_t tb_buffer_chain_size(tb_buffer_chain_ref_t self)
+{
+    // check
+    tb_buffer_chain_t* chain = (tb_buffer_chain_t*)self;
+    tb_assert_and_check_return_val(chain, 0);
+
+    return chain->size;
+}
+tb_size_t tb_buffer_chain_count(tb_buffer_chain_ref_t self)
+{
+    // check
+    tb_buffer_chain_t* chain = (tb_buffer_chain_t*)self;
+    tb_assert_and_check_return_val(chain, 0);
+
+    return tb_list_entry_size(&chain->slices);
+}
+tb_bool_t tb_buffer_chain_append(tb_buffer_chain_ref_t self, tb_byte_t const* data, tb_size_t size)
+{
+    // check
+    tb_buffer_chain_t* chain = (tb_buffer_chain_t*)self;
+    tb_assert_and_check_return_val(chain && data, tb_false);
+    tb_check_return_val(size, tb_true);
+
+    // append it
+    return tb_buffer_chain_insert(chain, tb_null, data, size, tb_false);
+}
+tb_bool_t tb_buffer_chain_append_copy(tb_buffer_chain_ref_t self, tb_byte_t const* data, tb_size_t size)
+{
+    // check
+    tb_buffer_chain_t* chain = (tb_buffer_chain_t*)self;
+    tb_assert_and_check_return_val(chain && data, tb_false);
+    tb_check_return_val(size, tb_true);
+
+    // append it
+    return tb_buffer_chain_insert_copy(chain, data, size, tb_false);
+}
+tb_bool_t tb_buffer_chain_append_owned(tb_buffer_chain_ref_t self, tb_byte_t* data, tb_size_t size)
+{
+    // check
+    tb_buffer_chain_t* chain = (tb_buffer_chain_t*)self;
+    tb_assert_and_check_return_val(chain && data && size, tb_false);
+
+    // append it
+    return tb_buffer_chain_insert_owned(chain, data, size, tb_false);
+}
+tb_bool_t tb_buffer_chain_append_chain(tb_buffer_chain_ref_t self, tb_buffer_chain_ref_t other)
+{
+    // check
+    tb_buffer_chain_t* chain = (tb_buffer_chain_t*)self;
+    tb_buffer_chain_t* chain_other = (tb_buffer_chain_t*)other;
+    tb_assert_and_check_return_val(chain && chain_other && chain != chain_other, tb_false);
+
+    // append all slices and share their blocks
+    tb_list_entry_ref_t tail = tb_list_entry_tail(&chain_other->slices);
+    tb_list_entry_ref_t entry = tb_list_entry_head(&chain_other->slices);
+    for (; entry != tail; entry = tb_list_entry_next(entry))
+    {
+        tb_buffer_chain_slice_t* slice = (tb_buffer_chain_slice_t*)entry;
+        if (!tb_buffer_chain_insert(chain, slice->block, slice->data, slice->size, tb_false)) return tb_false;
+    }
+    return tb_true;
+}
+tb_bool_t tb_buffer_chain_prepend(tb_buffer_chain_ref_t self, tb_byte_t const* data, tb_size_t size)
+{
+    // check
+    tb_buffer_chain_t* chain = (tb_buffer_chain_t*)self;
+    tb_assert_and_check_return_val(chain && data, tb_false);
+    tb_check_return_val(size, tb_true);
+
+    // prepend it
+    return tb_buffer_chain_insert(chain, tb_null, data, size, tb_true);
+}
+tb_bool_t tb_buffer_chain_prepend_copy(tb_buffer_chain_ref_t self, tb_byte_t const* data, tb_size_t size)
+{
+    // check
+    tb_buffer_chain_t* chain = (tb_buffer_chain_t*)self;
+    tb_assert_and_check_return_val(chain && data, tb_false);
+    tb_check_return_val(size, tb_true);
+
+    // prepend it
+    return tb_buffer_chain_insert_copy(chain, data, size, tb_true);
+}
+tb_bool_t tb_buffer_chain_prepend_owned(tb_buffer_chain_ref_t self, tb_byte_t* data, tb_size_t size)
+{
+    // check
+    tb_buffer_chain_t* chain = (tb_buffer_chain_t*)self;
+    tb_assert_and_check_return_val(chain && data && size, tb_false);
+
+    // prepend it
+    return tb_buffer_chain_insert_owned(chain, data, size, tb_true);
+}
+tb_buffer_chain_ref_t tb_buffer_chain_split(tb_buffer_chain_ref_t self, tb_size_t offset)
+{
+    // check
+    tb_buffer_chain_t* chain = (tb_buffer_chain_t*)self;
+    tb_assert_and_check_return_val(chain, tb_null);
+
+    // init the new chain
+    tb_buffer_chain_t* chain_new = (tb_buffer_chain_t*)tb_buffer_chain_init();
+    tb_assert_and_check_return_val(chain_new, tb_null);
+
+    // find the slice at the offset
+    tb_size_t           size = 0;
+    tb_list_entry_ref_t tail = tb_list_entry_tail(&chain->slices);
+    tb_list_entry_ref_t entry = tb_list_entry_head(&chain->slices);
+    while (entry != tail && size + ((tb_buffer_chain_slice_t*)entry)->size <= offset)
+    {
+        size += ((tb_buffer_chain_slice_t*)entry)->size;
+        entry = tb_list_entry_next(entry);
+    }
+
+    // split the slice at the offset and share its block
+    if (entry != tail && offset > size)
+    {
+        tb_buffer_chain_slice_t*    slice = (tb_buffer_chain_slice_t*)entry;
+        tb_size_t                   left = offset - size;
+        if (!tb_buffer_chain_insert(chain_new, slice->block, slice->data + left, slice->size - left, tb_false))
+        {
+            tb_buffer_chain_exit((tb_buffer_chain_ref_t)chain_new);
+            return tb_null;
+        }
+        slice->size = left;
+        size += left;
+        entry = tb_list_entry_next(entry);
+    }
+
+    // move the next slices to the new chain
+    while (entry != tail)
+    {
+        tb_list_entry_ref_t next = tb_list_entry_next(entry);
+        tb_list_entry_remove(&chain->slices, entry);
+        tb_list_entry_insert_tail(&chain_new->slices, entry);
+        chain_new->size += ((tb_buffer_chain_slice_t*)entry)->size;
+        entry = next;
+    }
+
+    // update size
+    chain->size = size;
+    return (tb_buffer_chain_ref_t)chain_new;
+}
+tb_size_t tb_buffer_chain_skip(tb_buffer_chain_ref_t self, tb_size_t size)
+{
+    // check
+    tb_buffer_chain_t* chain = (tb_buffer_chain_t*)self;
+    tb_assert_and_check_return_val(chain, 0);
+
+    // skip the head slices
+    tb_size_t skip = 0;
+    while (skip < size && !tb_list_entry_is_null(&chain->slices))
+    {
+        tb_buffer_chain_slice_t* slice = (tb_buffer_chain_slice_t*)tb_list_entry_head(&chain->slices);
+        if (slice->size <= size - skip)
+        {
+            skip += slice->size;
+            tb_list_entry_remove_head(&chain->slices);
+            tb_buffer_chain_slice_exit(slice);
+        }
+        else
+        {
+            slice->data += size - skip;
+            slice->size -= size - skip;
+            skip = size;
+        }
+    }
+
+    // update size
+    chain->size -= skip;
+    return skip;
+}
+tb_size_t tb_buffer_chain_peek(tb_buffer_chain_ref_t self, tb_iovec_t* list, tb_size_t maxn)
+{
+    // check
+    tb_buffer_chain_t* chain = (tb_buffer_chain_t*)self;
+    tb_assert_and_check_return_val(chain && list, 0);
+
+    // peek the head slices
+    tb_size_t           count = 0;
+    tb_list_entry_ref_t tail = tb_list_entry_tail(&chain->slices);
+    tb_list_entry_ref_t entry = tb_list_entry_head(&chain->slices);
+    for (; entry != tail && count < maxn; entry = tb_list_entry_next(entry), count++)
+    {
+        tb_buffer_chain_slice_t* slice = (tb_buffer_chain_slice_t*)entry;
+        list[count].data = (tb_byte_t*)slice->data;
+        list[count].size = (tb_iovec_size_t)slice->size;
+    }
+    return count;
+}
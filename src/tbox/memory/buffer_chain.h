@@ -0,0 +1,200 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        buffer_chain.h
+ * @ingroup     memory
+ *
+ */
+#ifndef TB_MEMORY_BUFFER_CHAIN_H
+#define TB_MEMORY_BUFFER_CHAIN_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+#include "../platform/prefix.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+/*! the buffer chain ref type
+ *
+ * <pre>
+ *
+ * chain: [slice: borrowed] -> [slice: owned] -> [slice: copied] -> ...
+ *                                   |                 |
+ *                                 block             block <- [slice: the split chain]
+ *
+ * </pre>
+ *
+ * the chain is a list of slices, the owned and copied data are stored in the refcounted blocks,
+ * so split() and append_chain() will only share the blocks without copying data.
+ *
+ * @note the borrowed data will not be copied and freed, it need be valid until it is removed from all chains.
+ * the chain is not thread-safe, but the different chains with the shared blocks can be used in different threads.
+ */
+typedef __tb_typeref__(buffer_chain);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/*! init the buffer chain
+ *
+ * @return              the buffer chain
+ */
+tb_buffer_chain_ref_t   tb_buffer_chain_init(tb_noarg_t);
+
+/*! exit the buffer chain
+ *
+ * @param chain         the buffer chain
+ */
+tb_void_t               tb_buffer_chain_exit(tb_buffer_chain_ref_t chain);
+
+/*! clear the buffer chain
+ *
+ * @param chain         the buffer chain
+ */
+tb_void_t               tb_buffer_chain_clear(tb_buffer_chain_ref_t chain);
+
+/*! the data size of the buffer chain
+ *
+ * @param chain         the buffer chain
+ *
+ * @return              the data size
+ */
+tb_size_t               tb_buffer_chain_size(tb_buffer_chain_ref_t chain);
+
+/*! the slice count of the buffer chain
+ *
+ * @param chain         the buffer chain
+ *
+ * @return              the slice count
+ */
+tb_size_t               tb_buffer_chain_count(tb_buffer_chain_ref_t chain);
+
+/*! append the borrowed data without copying it
+ *
+ * @param chain         the buffer chain
+ * @param data          the data
+ * @param size          the size
+ *
+ * @return              tb_true or tb_false
+ */
+tb_bool_t               tb_buffer_chain_append(tb_buffer_chain_ref_t chain, tb_byte_t const* data, tb_size_t size);
+
+/*! append the copied data, the small data will be merged into the tail block
+ *
+ * @param chain         the buffer chain
+ * @param data          the data
+ * @param size          the size
+ *
+ * @return              tb_true or tb_false
+ */
+tb_bool_t               tb_buffer_chain_append_copy(tb_buffer_chain_ref_t chain, tb_byte_t const* data, tb_size_t size);
+
+/*! append the owned data, it will be freed by tb_free() if no chain uses it
+ *
+ * @param chain         the buffer chain
+ * @param data          the data from tb_malloc()
+ * @param size          the size
+ *
+ * @return              tb_true or tb_false, the data will be freed if failed
+ */
+tb_bool_t               tb_buffer_chain_append_owned(tb_buffer_chain_ref_t chain, tb_byte_t* data, tb_size_t size);
+
+/*! append all slices of the other chain and share their blocks
+ *
+ * @param chain         the buffer chain
+ * @param other         the other buffer chain, it will not be changed
+ *
+ * @return              tb_true or tb_false
+ */
+tb_bool_t               tb_buffer_chain_append_chain(tb_buffer_chain_ref_t chain, tb_buffer_chain_ref_t other);
+
+/*! prepend the borrowed data without copying it
+ *
+ * @param chain         the buffer chain
+ * @param data          the data
+ * @param size          the size
+ *
+ * @return              tb_true or tb_false
+ */
+tb_bool_t               tb_buffer_chain_prepend(tb_buffer_chain_ref_t chain, tb_byte_t const* data, tb_size_t size);
+
+/*! prepend the copied data
+ *
+ * @param chain         the buffer chain
+ * @param data          the data
+ * @param size          the size
+ *
+ * @return              tb_true or tb_false
+ */
+tb_bool_t               tb_buffer_chain_prepend_copy(tb_buffer_chain_ref_t chain, tb_byte_t const* data, tb_size_t size);
+
+/*! prepend the owned data, it will be freed by tb_free() if no chain uses it
+ *
+ * @param chain         the buffer chain
+ * @param data          the data from tb_malloc()
+ * @param size          the size
+ *
+ * @return              tb_true or tb_false, the data will be freed if failed
+ */
+tb_bool_t               tb_buffer_chain_prepend_owned(tb_buffer_chain_ref_t chain, tb_byte_t* data, tb_size_t size);
+
+/*! split the buffer chain at the given offset
+ *
+ * the data after the offset will be moved to the new chain, and the slice at the offset will share its block
+ *
+ * @param chain         the buffer chain
+ * @param offset        the offset
+ *
+ * @return              the new buffer chain with the data [offset, size)
+ */
+tb_buffer_chain_ref_t   tb_buffer_chain_split(tb_buffer_chain_ref_t chain, tb_size_t offset);
+
+/*! skip and remove the head data, e.g. after the data has been sent
+ *
+ * @param chain         the buffer chain
+ * @param size          the size
+ *
+ * @return              the skipped size
+ */
+tb_size_t               tb_buffer_chain_skip(tb_buffer_chain_ref_t chain, tb_size_t size);
+
+/*! peek the head slices to the iovec list for writev() and sendv()
+ *
+ * @param chain         the buffer chain
+ * @param list          the iovec list
+ * @param maxn          the iovec list maxn
+ *
+ * @return              the iovec count
+ */
+tb_size_t               tb_buffer_chain_peek(tb_buffer_chain_ref_t chain, tb_iovec_t* list, tb_size_t maxn);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
@@ -0,0 +1,357 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        epoch.c
+ * @ingroup     memory
+ *
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * trace
+ */
+#define TB_TRACE_MODULE_NAME            "epoch"
+#define TB_TRACE_MODULE_DEBUG           (0)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "epoch.h"
+#include "impl/retired.h"
+#include "../utils/singleton.h"
+#include "../platform/sched.h"
+#include "../platform/atomic.h"
+#include "../platform/thread_local.h"
+#if defined(TB_CONFIG_MODULE_HAVE_COROUTINE) \
+        && !defined(TB_CONFIG_MICRO_ENABLE)
+#   include "../coroutine/coroutine.h"
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the retired items count of each thread to trigger the reclamation
+#ifdef __tb_small__
+#   define TB_EPOCH_RETIRED_TRIGGER     (32)
+#else
+#   define TB_EPOCH_RETIRED_TRIGGER     (128)
+#endif
+
+// the limbo lists count, the data retired in epoch e can be freed in epoch e + 2
+#define TB_EPOCH_LIMBO_MAXN             (3)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the epoch thread record type
+typedef struct __tb_epoch_record_t
+{
+    /* the active epoch
+     *
+     * (epoch << 1) | 1: in the critical section
+     * 0:                not in the critical section
+     */
+    tb_atomic_t                     active;
+
+    // is used by a thread?
+    tb_atomic32_t                   used;
+
+    // the next record, it will not be changed after published
+    struct __tb_epoch_record_t*     next;
+
+    // the nested count of the critical section
+    tb_size_t                       nesting;
+
+    // the retired count since the last reclamation
+    tb_size_t                       retired;
+
+    // the limbo lists, the list tag is the retired epoch
+    tb_retired_list_t               limbo[TB_EPOCH_LIMBO_MAXN];
+
+}tb_epoch_record_t, *tb_epoch_record_ref_t;
+
+// the epoch type
+typedef struct __tb_epoch_t
+{
+    // the global epoch
+    tb_atomic_t                     epoch;
+
+    // the records list
+    tb_atomic_t                     records;
+
+}tb_epoch_t, *tb_epoch_ref_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * globals
+ */
+
+// the current thread record
+static tb_thread_local_t            g_epoch_self = TB_THREAD_LOCAL_INIT;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static tb_handle_t tb_epoch_instance_init(tb_cpointer_t* ppriv)
+{
+    return (tb_handle_t)tb_malloc0_type(tb_epoch_t);
+}
+static tb_void_t tb_epoch_instance_exit(tb_handle_t handle, tb_cpointer_t priv)
+{
+    // check
+    tb_epoch_ref_t epoch = (tb_epoch_ref_t)handle;
+    tb_assert_and_check_return(epoch);
+
+    // exit all records and free all retired data, no readers now
+    tb_epoch_record_ref_t record = (tb_epoch_record_ref_t)tb_atomic_get(&epoch->records);
+    while (record)
+    {
+        tb_epoch_record_ref_t next = record->next;
+        tb_size_t i = 0;
+        for (i = 0; i < TB_EPOCH_LIMBO_MAXN; i++)
+            tb_retired_list_exit(&record->limbo[i]);
+        tb_free(record);
+        record = next;
+    }
+
+    // exit it
+    tb_free(epoch);
+}
+static tb_epoch_ref_t tb_epoch_instance()
+{
+    return (tb_epoch_ref_t)tb_singleton_instance(TB_SINGLETON_TYPE_EPOCH, tb_epoch_instance_init, tb_epoch_instance_exit, tb_null, tb_null);
+}
+static tb_void_t tb_epoch_record_free(tb_cpointer_t priv)
+{
+    // release the record of the exited thread, the retired data will be freed by the next owner
+    tb_epoch_record_ref_t record = (tb_epoch_record_ref_t)priv;
+    if (record)
+    {
+        record->nesting = 0;
+        tb_atomic_set(&record->active, 0);
+        tb_atomic32_set_explicit(&record->used, 0, TB_ATOMIC_RELEASE);
+    }
+}
+static tb_epoch_record_ref_t tb_epoch_record(tb_epoch_ref_t epoch)
+{
+    // get the record of the current thread
+    if (!tb_thread_local_init(&g_epoch_self, tb_epoch_record_free)) return tb_null;
+    tb_epoch_record_ref_t record = (tb_epoch_record_ref_t)tb_thread_local_get(&g_epoch_self);
+    tb_check_return_val(!record, record);
+
+    // attempt to reuse a released record
+    for (record = (tb_epoch_record_ref_t)tb_atomic_get(&epoch->records); record; record = record->next)
+    {
+        tb_int32_t used = 0;
+        if (!tb_atomic32_get_explicit(&record->used, TB_ATOMIC_RELAXED) && tb_atomic32_compare_and_swap(&record->used, &used, 1))
+            break;
+    }
+
+    // no released record? make a new record and publish it
+    if (!record)
+    {
+        record = tb_malloc0_type(tb_epoch_record_t);
+        tb_assert_and_check_return_val(record, tb_null);
+
+        record->used = 1;
+        tb_long_t head = tb_atomic_get(&epoch->records);
+        do
+        {
+            record->next = (tb_epoch_record_ref_t)head;
+
+        } while (!tb_atomic_compare_and_swap(&epoch->records, &head, (tb_long_t)record));
+    }
+
+    // save it to the current thread
+    if (!tb_thread_local_set(&g_epoch_self, record))
+    {
+        tb_epoch_record_free(record);
+        return tb_null;
+    }
+    return record;
+}
+static tb_bool_t tb_epoch_advance(tb_epoch_ref_t epoch)
+{
+    // all active records have observed the current epoch?
+    tb_long_t current = tb_atomic_get(&epoch->epoch);
+    tb_epoch_record_ref_t record = (tb_epoch_record_ref_t)tb_atomic_get(&epoch->records);
+    for (; record; record = record->next)
+    {
+        tb_long_t active = tb_atomic_get(&record->active);
+        if ((active & 1) && (active >> 1) != current) return tb_false;
+    }
+
+    // advance it, it has been advanced by other threads if failed
+    tb_atomic_compare_and_swap(&epoch->epoch, &current, current + 1);
+    return tb_true;
+}
+static tb_size_t tb_epoch_record_reclaim(tb_epoch_record_ref_t record, tb_long_t current)
+{
+    // free the limbo lists which were retired two epochs ago at least
+    tb_size_t i = 0;
+    tb_size_t freed = 0;
+    for (i = 0; i < TB_EPOCH_LIMBO_MAXN; i++)
+    {
+        tb_retired_list_ref_t limbo = &record->limbo[i];
+        if (limbo->size && (tb_long_t)limbo->tag + 2 <= current)
+            freed += tb_retired_list_free(limbo);
+    }
+    return freed;
+}
+static tb_size_t tb_epoch_reclaim_orphans(tb_epoch_ref_t epoch, tb_long_t current)
+{
+    // reclaim the retired data of the records released by the exited threads
+    tb_size_t               freed = 0;
+    tb_epoch_record_ref_t   record = (tb_epoch_record_ref_t)tb_atomic_get(&epoch->records);
+    for (; record; record = record->next)
+    {
+        tb_int32_t used = 0;
+        if (!tb_atomic32_get_explicit(&record->used, TB_ATOMIC_RELAXED) && tb_atomic32_compare_and_swap(&record->used, &used, 1))
+        {
+            freed += tb_epoch_record_reclaim(record, current);
+            tb_atomic32_set_explicit(&record->used, 0, TB_ATOMIC_RELEASE);
+        }
+    }
+    return freed;
+}
+static tb_bool_t tb_epoch_record_pending(tb_epoch_record_ref_t record)
+{
+    tb_size_t i = 0;
+    for (i = 0; i < TB_EPOCH_LIMBO_MAXN; i++)
+    {
+        if (record->limbo[i].size) return tb_true;
+    }
+    return tb_false;
+}
+static tb_void_t tb_epoch_allocator_free(tb_pointer_t data, tb_cpointer_t priv)
+{
+    tb_allocator_free((tb_allocator_ref_t)priv, data);
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+tb_void_t tb_epoch_enter()
+{
+    // get the current record
+    tb_epoch_ref_t          epoch = tb_epoch_instance();
+    tb_epoch_record_ref_t   record = epoch? tb_epoch_record(epoch) : tb_null;
+    tb_assert_and_check_return(record);
+
+    // enter the outermost critical section
+    if (!record->nesting++)
+    {
+        /* announce the observed epoch, we use the full barrier here
+         * to ensure the shared data will be loaded after it has been announced
+         */
+        tb_long_t current = tb_atomic_get_explicit(&epoch->epoch, TB_ATOMIC_RELAXED);
+        tb_atomic_fetch_and_set(&record->active, (current << 1) | 1);
+    }
+}
+tb_void_t tb_epoch_leave()
+{
+    // get the current record
+    tb_epoch_record_ref_t record = (tb_epoch_record_ref_t)tb_thread_local_get(&g_epoch_self);
+    tb_assert_and_check_return(record && record->nesting);
+
+    // leave the outermost critical section
+    if (!--record->nesting)
+        tb_atomic_set_explicit(&record->active, 0, TB_ATOMIC_RELEASE);
+}
+tb_bool_t tb_epoch_retire(tb_allocator_ref_t allocator, tb_pointer_t data)
+{
+    return tb_epoch_retire_func(data, tb_epoch_allocator_free, allocator? allocator : tb_allocator());
+}
+tb_bool_t tb_epoch_retire_func(tb_pointer_t data, tb_epoch_free_func_t func, tb_cpointer_t priv)
+{
+    // check
+    tb_assert_and_check_return_val(data && func, tb_false);
+
+    // get the current record
+    tb_epoch_ref_t          epoch = tb_epoch_instance();
+    tb_epoch_record_ref_t   record = epoch? tb_epoch_record(epoch) : tb_null;
+    tb_assert_and_check_return_val(record, tb_false);
+
+    /* get the limbo list of the current epoch
+     *
+     * the old data in it was retired three epochs ago at least if the tag has been changed,
+     * so we can free them directly
+     */
+    tb_long_t               current = tb_atomic_get(&epoch->epoch);
+    tb_retired_list_ref_t   limbo = &record->limbo[current % TB_EPOCH_LIMBO_MAXN];
+    if (limbo->tag != (tb_size_t)current)
+    {
+        tb_retired_list_free(limbo);
+        limbo->tag = (tb_size_t)current;
+    }
+
+    // retire it
+    if (!tb_retired_list_push(limbo, data, func, priv)) return tb_false;
+
+    // reclaim the expired data if too many data have been retired
+    if (++record->retired >= TB_EPOCH_RETIRED_TRIGGER)
+    {
+        record->retired = 0;
+        if (tb_epoch_advance(epoch))
+            tb_epoch_record_reclaim(record, tb_atomic_get(&epoch->epoch));
+    }
+    return tb_true;
+}
+tb_size_t tb_epoch_reclaim()
+{
+    // get the current record
+    tb_epoch_ref_t          epoch = tb_epoch_instance();
+    tb_epoch_record_ref_t   record = epoch? tb_epoch_record(epoch) : tb_null;
+    tb_assert_and_check_return_val(record, 0);
+
+    // attempt to advance the global epoch
+    tb_epoch_advance(epoch);
+
+    // reclaim the expired data
+    tb_long_t current = tb_atomic_get(&epoch->epoch);
+    record->retired = 0;
+    return tb_epoch_record_reclaim(record, current) + tb_epoch_reclaim_orphans(epoch, current);
+}
+tb_void_t tb_epoch_synchronize()
+{
+    // get the current record
+    tb_epoch_ref_t          epoch = tb_epoch_instance();
+    tb_epoch_record_ref_t   record = epoch? tb_epoch_record(epoch) : tb_null;
+    tb_assert_and_check_return(record);
+
+    // we cannot wait ourself
+    tb_assert_and_check_return(!record->nesting);
+
+    // wait all readers and free all retired data
+    while (tb_epoch_record_pending(record))
+    {
+        // reclaim them
+        if (tb_epoch_advance(epoch))
+        {
+            tb_epoch_record_reclaim(record, tb_atomic_get(&epoch->epoch));
+            continue;
+        }
+
+        // some readers are still in the critical section, wait them
+#if defined(TB_CONFIG_MODULE_HAVE_COROUTINE) \
+        && !defined(TB_CONFIG_MICRO_ENABLE)
+        if (tb_coroutine_self() && tb_coroutine_yield()) continue;
+#endif
+        tb_sched_yield();
+    }
+    record->retired = 0;
+}
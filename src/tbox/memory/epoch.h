@@ -0,0 +1,111 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        epoch.h
+ * @ingroup     memory
+ *
+ */
+#ifndef TB_MEMORY_EPOCH_H
+#define TB_MEMORY_EPOCH_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+#include "allocator.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+/*! the epoch free function type
+ *
+ * @param data          the retired data
+ * @param priv          the user private data
+ */
+typedef tb_void_t       (*tb_epoch_free_func_t)(tb_pointer_t data, tb_cpointer_t priv);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/*! enter the epoch critical section
+ *
+ * the shared data loaded in the critical section will not be freed until we leave it,
+ * it can be nested and it is only a few atomic operations on the current thread record.
+ *
+ * @note it can also be used in coroutines, but all coroutines on the same thread share
+ * the thread record, so a suspended coroutine in the critical section will delay the reclamation
+ *
+ * @code
+    tb_epoch_enter();
+    node_t* node = (node_t*)tb_atomic_get(&list->head);
+    if (node) tb_trace_i("%lu", node->value);
+    tb_epoch_leave();
+ * @endcode
+ */
+tb_void_t               tb_epoch_enter(tb_noarg_t);
+
+/*! leave the epoch critical section
+ */
+tb_void_t               tb_epoch_leave(tb_noarg_t);
+
+/*! retire the unlinked data and free it to the given allocator after all readers have left
+ *
+ * @param allocator     the allocator, uses the default allocator if be null
+ * @param data          the data
+ *
+ * @return              tb_true or tb_false
+ */
+tb_bool_t               tb_epoch_retire(tb_allocator_ref_t allocator, tb_pointer_t data);
+
+/*! retire the unlinked data and free it by the given function after all readers have left
+ *
+ * @param data          the data
+ * @param func          the free function
+ * @param priv          the user private data of the free function
+ *
+ * @return              tb_true or tb_false
+ */
+tb_bool_t               tb_epoch_retire_func(tb_pointer_t data, tb_epoch_free_func_t func, tb_cpointer_t priv);
+
+/*! attempt to advance the global epoch and free the expired data
+ *
+ * @note it will be called automatically after retiring some data
+ *
+ * @return              the freed data count
+ */
+tb_size_t               tb_epoch_reclaim(tb_noarg_t);
+
+/*! wait for all readers and free all retired data of the current thread
+ *
+ * @note it cannot be called in the critical section
+ * and it will only suspend the current coroutine if be called in coroutine
+ */
+tb_void_t               tb_epoch_synchronize(tb_noarg_t);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
@@ -0,0 +1,311 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        hazard.c
+ * @ingroup     memory
+ *
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * trace
+ */
+#define TB_TRACE_MODULE_NAME            "hazard"
+#define TB_TRACE_MODULE_DEBUG           (0)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "hazard.h"
+#include "impl/retired.h"
+#include "../utils/singleton.h"
+#include "../platform/atomic.h"
+#include "../platform/thread_local.h"
+#include "../algorithm/sort.h"
+#include "../container/array_iterator.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the minimum retired items count of each thread to trigger the reclamation
+#ifdef __tb_small__
+#   define TB_HAZARD_RETIRED_TRIGGER    (32)
+#else
+#   define TB_HAZARD_RETIRED_TRIGGER    (128)
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the hazard thread record type
+typedef struct __tb_hazard_record_t
+{
+    // the hazard pointers
+    tb_atomic_t                     hazards[TB_HAZARD_MAXN];
+
+    // is used by a thread?
+    tb_atomic32_t                   used;
+
+    // the next record, it will not be changed after published
+    struct __tb_hazard_record_t*    next;
+
+    // the retired list
+    tb_retired_list_t               retired;
+
+}tb_hazard_record_t, *tb_hazard_record_ref_t;
+
+// the hazard type
+typedef struct __tb_hazard_t
+{
+    // the records list
+    tb_atomic_t                     records;
+
+    // the records count
+    tb_atomic_t                     count;
+
+}tb_hazard_t, *tb_hazard_ref_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * globals
+ */
+
+// the current thread record
+static tb_thread_local_t            g_hazard_self = TB_THREAD_LOCAL_INIT;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static tb_handle_t tb_hazard_instance_init(tb_cpointer_t* ppriv)
+{
+    return (tb_handle_t)tb_malloc0_type(tb_hazard_t);
+}
+static tb_void_t tb_hazard_instance_exit(tb_handle_t handle, tb_cpointer_t priv)
+{
+    // check
+    tb_hazard_ref_t hazard = (tb_hazard_ref_t)handle;
+    tb_assert_and_check_return(hazard);
+
+    // exit all records and free all retired data, no readers now
+    tb_hazard_record_ref_t record = (tb_hazard_record_ref_t)tb_atomic_get(&hazard->records);
+    while (record)
+    {
+        tb_hazard_record_ref_t next = record->next;
+        tb_retired_list_exit(&record->retired);
+        tb_free(record);
+        record = next;
+    }
+
+    // exit it
+    tb_free(hazard);
+}
+static tb_hazard_ref_t tb_hazard_instance()
+{
+    return (tb_hazard_ref_t)tb_singleton_instance(TB_SINGLETON_TYPE_HAZARD, tb_hazard_instance_init, tb_hazard_instance_exit, tb_null, tb_null);
+}
+static tb_void_t tb_hazard_record_free(tb_cpointer_t priv)
+{
+    // release the record of the exited thread, the retired data will be freed by the next owner
+    tb_hazard_record_ref_t record = (tb_hazard_record_ref_t)priv;
+    if (record)
+    {
+        tb_size_t i = 0;
+        for (i = 0; i < TB_HAZARD_MAXN; i++)
+            tb_atomic_set(&record->hazards[i], 0);
+        tb_atomic32_set_explicit(&record->used, 0, TB_ATOMIC_RELEASE);
+    }
+}
+static tb_hazard_record_ref_t tb_hazard_record(tb_hazard_ref_t hazard)
+{
+    // get the record of the current thread
+    if (!tb_thread_local_init(&g_hazard_self, tb_hazard_record_free)) return tb_null;
+    tb_hazard_record_ref_t record = (tb_hazard_record_ref_t)tb_thread_local_get(&g_hazard_self);
+    tb_check_return_val(!record, record);
+
+    // attempt to reuse a released record
+    for (record = (tb_hazard_record_ref_t)tb_atomic_get(&hazard->records); record; record = record->next)
+    {
+        tb_int32_t used = 0;
+        if (!tb_atomic32_get_explicit(&record->used, TB_ATOMIC_RELAXED) && tb_atomic32_compare_and_swap(&record->used, &used, 1))
+            break;
+    }
+
+    // no released record? make a new record and publish it
+    if (!record)
+    {
+        record = tb_malloc0_type(tb_hazard_record_t);
+        tb_assert_and_check_return_val(record, tb_null);
+
+        record->used = 1;
+        tb_long_t head = tb_atomic_get(&hazard->records);
+        do
+        {
+            record->next = (tb_hazard_record_ref_t)head;
+
+        } while (!tb_atomic_compare_and_swap(&hazard->records, &head, (tb_long_t)record));
+        tb_atomic_fetch_and_add(&hazard->count, 1);
+    }
+
+    // save it to the current thread
+    if (!tb_thread_local_set(&g_hazard_self, record))
+    {
+        tb_hazard_record_free(record);
+        return tb_null;
+    }
+    return record;
+}
+static tb_hazard_record_ref_t tb_hazard_record_self()
+{
+    tb_hazard_ref_t hazard = tb_hazard_instance();
+    return hazard? tb_hazard_record(hazard) : tb_null;
+}
+static tb_size_t tb_hazard_scan(tb_hazard_ref_t hazard, tb_hazard_record_ref_t self)
+{
+    /* count the hazards of the published records
+     *
+     * the records published after loading the head will not protect our retired data,
+     * because they will load the shared pointer after it has been unlinked
+     */
+    tb_size_t               i = 0;
+    tb_size_t               maxn = 0;
+    tb_hazard_record_ref_t  head = (tb_hazard_record_ref_t)tb_atomic_get(&hazard->records);
+    tb_hazard_record_ref_t  record = head;
+    for (; record; record = record->next) maxn += TB_HAZARD_MAXN;
+
+    // make the hazards snapshot
+    tb_size_t*  hazards = maxn? tb_nalloc_type(maxn, tb_size_t) : tb_null;
+    tb_assert_and_check_return_val(hazards, 0);
+
+    tb_size_t count = 0;
+    for (record = head; record; record = record->next)
+    {
+        for (i = 0; i < TB_HAZARD_MAXN; i++)
+        {
+            tb_size_t data = (tb_size_t)tb_atomic_get(&record->hazards[i]);
+            if (data) hazards[count++] = data;
+        }
+    }
+
+    // sort the hazards for the binary search
+    if (count > 1)
+    {
+        tb_array_iterator_t array_iterator;
+        tb_sort_all(tb_array_iterator_init_size(&array_iterator, hazards, count), tb_null);
+    }
+
+    // free the unprotected data of the current record and the released records
+    tb_size_t freed = tb_retired_list_free_unless(&self->retired, hazards, count);
+    for (record = head; record; record = record->next)
+    {
+        tb_int32_t used = 0;
+        if (record != self && !tb_atomic32_get_explicit(&record->used, TB_ATOMIC_RELAXED)
+            && tb_atomic32_compare_and_swap(&record->used, &used, 1))
+        {
+            if (record->retired.size) freed += tb_retired_list_free_unless(&record->retired, hazards, count);
+            tb_atomic32_set_explicit(&record->used, 0, TB_ATOMIC_RELEASE);
+        }
+    }
+
+    // exit the hazards snapshot
+    tb_free(hazards);
+    return freed;
+}
+static tb_void_t tb_hazard_allocator_free(tb_pointer_t data, tb_cpointer_t priv)
+{
+    tb_allocator_free((tb_allocator_ref_t)priv, data);
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+tb_pointer_t tb_hazard_protect(tb_size_t index, tb_atomic_t* pointer)
+{
+    // check
+    tb_assert_and_check_return_val(index < TB_HAZARD_MAXN && pointer, tb_null);
+
+    // get the current record
+    tb_hazard_record_ref_t record = tb_hazard_record_self();
+    tb_assert_and_check_return_val(record, tb_null);
+
+    // protect it and validate it is still reachable after it has been published
+    tb_long_t data = tb_atomic_get(pointer);
+    while (1)
+    {
+        tb_atomic_fetch_and_set(&record->hazards[index], data);
+        tb_long_t real = tb_atomic_get(pointer);
+        if (real == data) break;
+        data = real;
+    }
+    return (tb_pointer_t)data;
+}
+tb_void_t tb_hazard_set(tb_size_t index, tb_cpointer_t data)
+{
+    // check
+    tb_assert_and_check_return(index < TB_HAZARD_MAXN);
+
+    // get the current record
+    tb_hazard_record_ref_t record = tb_hazard_record_self();
+    tb_assert_and_check_return(record);
+
+    // protect it
+    tb_atomic_fetch_and_set(&record->hazards[index], (tb_long_t)data);
+}
+tb_void_t tb_hazard_clear(tb_size_t index)
+{
+    // check
+    tb_assert_and_check_return(index < TB_HAZARD_MAXN);
+
+    // get the current record
+    tb_hazard_record_ref_t record = (tb_hazard_record_ref_t)tb_thread_local_get(&g_hazard_self);
+    tb_check_return(record);
+
+    // clear it
+    tb_atomic_set_explicit(&record->hazards[index], 0, TB_ATOMIC_RELEASE);
+}
+tb_bool_t tb_hazard_retire(tb_allocator_ref_t allocator, tb_pointer_t data)
+{
+    return tb_hazard_retire_func(data, tb_hazard_allocator_free, allocator? allocator : tb_allocator());
+}
+tb_bool_t tb_hazard_retire_func(tb_pointer_t data, tb_hazard_free_func_t func, tb_cpointer_t priv)
+{
+    // check
+    tb_assert_and_check_return_val(data && func, tb_false);
+
+    // get the current record
+    tb_hazard_ref_t         hazard = tb_hazard_instance();
+    tb_hazard_record_ref_t  record = hazard? tb_hazard_record(hazard) : tb_null;
+    tb_assert_and_check_return_val(record, tb_false);
+
+    // retire it
+    if (!tb_retired_list_push(&record->retired, data, func, priv)) return tb_false;
+
+    // scan the hazards if the retired data is more than twice the hazards count
+    tb_size_t trigger = (tb_size_t)tb_atomic_get(&hazard->count) * TB_HAZARD_MAXN * 2;
+    if (record->retired.size >= tb_max(trigger, TB_HAZARD_RETIRED_TRIGGER))
+        tb_hazard_scan(hazard, record);
+    return tb_true;
+}
+tb_size_t tb_hazard_reclaim()
+{
+    // get the current record
+    tb_hazard_ref_t         hazard = tb_hazard_instance();
+    tb_hazard_record_ref_t  record = hazard? tb_hazard_record(hazard) : tb_null;
+    tb_assert_and_check_return_val(record, 0);
+
+    // scan the hazards
+    return tb_hazard_scan(hazard, record);
+}
@@ -0,0 +1,126 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        hazard.h
+ * @ingroup     memory
+ *
+ */
+#ifndef TB_MEMORY_HAZARD_H
+#define TB_MEMORY_HAZARD_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+#include "allocator.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+/// the hazard pointers count of each thread
+#define TB_HAZARD_MAXN          (4)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+/*! the hazard free function type
+ *
+ * @param data          the retired data
+ * @param priv          the user private data
+ */
+typedef tb_void_t       (*tb_hazard_free_func_t)(tb_pointer_t data, tb_cpointer_t priv);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/*! load and protect the shared pointer with the given hazard pointer of the current thread
+ *
+ * it bounds the unreclaimed memory unlike the epoch-based reclamation,
+ * but we need pay a full barrier for each protected pointer.
+ *
+ * @note the hazard pointers are shared by all coroutines on the same thread,
+ * so we need clear them before suspending the current coroutine
+ *
+ * @code
+    node_t* node = (node_t*)tb_hazard_protect(0, &list->head);
+    if (node) tb_trace_i("%lu", node->value);
+    tb_hazard_clear(0);
+ * @endcode
+ *
+ * @param index         the hazard pointer index, it must be less than TB_HAZARD_MAXN
+ * @param pointer       the shared atomic pointer
+ *
+ * @return              the protected pointer
+ */
+tb_pointer_t            tb_hazard_protect(tb_size_t index, tb_atomic_t* pointer);
+
+/*! protect the given data with the hazard pointer of the current thread
+ *
+ * @note the caller need validate the data is still reachable after protecting it
+ *
+ * @param index         the hazard pointer index, it must be less than TB_HAZARD_MAXN
+ * @param data          the data
+ */
+tb_void_t               tb_hazard_set(tb_size_t index, tb_cpointer_t data);
+
+/*! clear the hazard pointer of the current thread
+ *
+ * @param index         the hazard pointer index, it must be less than TB_HAZARD_MAXN
+ */
+tb_void_t               tb_hazard_clear(tb_size_t index);
+
+/*! retire the unlinked data and free it to the given allocator if it is not protected
+ *
+ * @param allocator     the allocator, uses the default allocator if be null
+ * @param data          the data
+ *
+ * @return              tb_true or tb_false
+ */
+tb_bool_t               tb_hazard_retire(tb_allocator_ref_t allocator, tb_pointer_t data);
+
+/*! retire the unlinked data and free it by the given function if it is not protected
+ *
+ * @param data          the data
+ * @param func          the free function
+ * @param priv          the user private data of the free function
+ *
+ * @return              tb_true or tb_false
+ */
+tb_bool_t               tb_hazard_retire_func(tb_pointer_t data, tb_hazard_free_func_t func, tb_cpointer_t priv);
+
+/*! scan all hazard pointers and free the unprotected retired data
+ *
+ * @note it will be called automatically after retiring some data
+ *
+ * @return              the freed data count
+ */
+tb_size_t               tb_hazard_reclaim(tb_noarg_t);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
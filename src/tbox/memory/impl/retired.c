@@ -0,0 +1,139 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        retired.c
+ *
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * trace
+ */
+#define TB_TRACE_MODULE_NAME            "retired"
+#define TB_TRACE_MODULE_DEBUG           (0)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "retired.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the items grow
+#ifdef __tb_small__
+#   define TB_RETIRED_LIST_GROW         (32)
+#else
+#   define TB_RETIRED_LIST_GROW         (128)
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static tb_bool_t tb_retired_list_is_protected(tb_size_t const* hazards, tb_size_t count, tb_size_t data)
+{
+    // binary search it
+    tb_size_t head = 0;
+    tb_size_t tail = count;
+    while (head < tail)
+    {
+        tb_size_t mid = head + ((tail - head) >> 1);
+        if (hazards[mid] < data) head = mid + 1;
+        else if (hazards[mid] > data) tail = mid;
+        else return tb_true;
+    }
+    return tb_false;
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+tb_void_t tb_retired_list_exit(tb_retired_list_ref_t list)
+{
+    // check
+    tb_assert_and_check_return(list);
+
+    // free all items
+    tb_retired_list_free(list);
+
+    // exit items
+    if (list->items) tb_free(list->items);
+    list->items = tb_null;
+    list->maxn  = 0;
+}
+tb_bool_t tb_retired_list_push(tb_retired_list_ref_t list, tb_pointer_t data, tb_retired_free_func_t func, tb_cpointer_t priv)
+{
+    // check
+    tb_assert_and_check_return_val(list && func, tb_false);
+
+    // grow items
+    if (list->size >= list->maxn)
+    {
+        tb_size_t           maxn = list->maxn + TB_RETIRED_LIST_GROW;
+        tb_retired_item_t*  items = (tb_retired_item_t*)tb_ralloc(list->items, maxn * sizeof(tb_retired_item_t));
+        tb_assert_and_check_return_val(items, tb_false);
+
+        // save items
+        list->items = items;
+        list->maxn  = maxn;
+    }
+
+    // push it
+    tb_retired_item_ref_t item = &list->items[list->size++];
+    item->data = data;
+    item->func = func;
+    item->priv = priv;
+    return tb_true;
+}
+tb_size_t tb_retired_list_free(tb_retired_list_ref_t list)
+{
+    // check
+    tb_assert_and_check_return_val(list, 0);
+
+    // free all items
+    tb_size_t i = 0;
+    tb_size_t size = list->size;
+    for (i = 0; i < size; i++)
+    {
+        tb_retired_item_ref_t item = &list->items[i];
+        item->func(item->data, item->priv);
+    }
+    list->size = 0;
+    return size;
+}
+tb_size_t tb_retired_list_free_unless(tb_retired_list_ref_t list, tb_size_t const* hazards, tb_size_t count)
+{
+    // check
+    tb_assert_and_check_return_val(list, 0);
+
+    // free all unprotected items and compact the others
+    tb_size_t i = 0;
+    tb_size_t kept = 0;
+    tb_size_t size = list->size;
+    for (i = 0; i < size; i++)
+    {
+        tb_retired_item_ref_t item = &list->items[i];
+        if (count && tb_retired_list_is_protected(hazards, count, (tb_size_t)item->data))
+        {
+            if (kept != i) list->items[kept] = *item;
+            kept++;
+        }
+        else item->func(item->data, item->priv);
+    }
+    list->size = kept;
+    return size - kept;
+}
@@ -0,0 +1,116 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        retired.h
+ *
+ */
+#ifndef TB_MEMORY_IMPL_RETIRED_H
+#define TB_MEMORY_IMPL_RETIRED_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the retired item free function type
+typedef tb_void_t       (*tb_retired_free_func_t)(tb_pointer_t data, tb_cpointer_t priv);
+
+// the retired item type
+typedef struct __tb_retired_item_t
+{
+    // the data
+    tb_pointer_t            data;
+
+    // the free function
+    tb_retired_free_func_t  func;
+
+    // the user private data of the free function
+    tb_cpointer_t           priv;
+
+}tb_retired_item_t, *tb_retired_item_ref_t;
+
+// the retired list type, it is only accessed by the owner thread
+typedef struct __tb_retired_list_t
+{
+    // the items
+    tb_retired_item_t*      items;
+
+    // the items count
+    tb_size_t               size;
+
+    // the items maxn
+    tb_size_t               maxn;
+
+    // the user tag, e.g. the retired epoch
+    tb_size_t               tag;
+
+}tb_retired_list_t, *tb_retired_list_ref_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/* exit the retired list and free all items
+ *
+ * @param list          the retired list
+ */
+tb_void_t               tb_retired_list_exit(tb_retired_list_ref_t list);
+
+/* push a retired item
+ *
+ * @param list          the retired list
+ * @param data          the data
+ * @param func          the free function
+ * @param priv          the user private data of the free function
+ *
+ * @return              tb_true or tb_false
+ */
+tb_bool_t               tb_retired_list_push(tb_retired_list_ref_t list, tb_pointer_t data, tb_retired_free_func_t func, tb_cpointer_t priv);
+
+/* free all items
+ *
+ * @param list          the retired list
+ *
+ * @return              the freed items count
+ */
+tb_size_t               tb_retired_list_free(tb_retired_list_ref_t list);
+
+/* free all items which are not in the sorted protected data list
+ *
+ * @param list          the retired list
+ * @param hazards       the sorted protected data list
+ * @param count         the protected data count
+ *
+ * @return              the freed items count
+ */
+tb_size_t               tb_retired_list_free_unless(tb_retired_list_ref_t list, tb_size_t const* hazards, tb_size_t count);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
@@ -26,7 +26,10 @@
  * includes
  */
 #include "prefix.h"
+#include "epoch.h"
 #include "buffer.h"
+#include "buffer_chain.h"
+#include "hazard.h"
 #include "allocator.h"
 #include "fixed_pool.h"
 #include "string_pool.h"
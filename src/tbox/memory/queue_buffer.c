@@ -26,6 +26,53 @@
 #include "memory.h"
 #include "../libc/libc.h"
 #include "../utils/utils.h"
+#include "../platform/virtual_memory.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static tb_byte_t* tb_queue_buffer_data_make(tb_queue_buffer_ref_t buffer, tb_size_t maxn)
+{
+    // make the mirrored data first
+    if (buffer->mirror)
+    {
+        tb_size_t  size = tb_virtual_memory_mirror_size(maxn);
+        tb_byte_t* data = size? (tb_byte_t*)tb_virtual_memory_mirror_malloc(size) : tb_null;
+        if (data)
+        {
+            buffer->maxn = size;
+            return data;
+        }
+
+        // failed? switch to the plain data
+        buffer->mirror = tb_false;
+    }
+
+    // make the plain data
+    buffer->maxn = maxn;
+    return tb_malloc_bytes(maxn);
+}
+static tb_void_t tb_queue_buffer_data_free(tb_queue_buffer_ref_t buffer)
+{
+    if (buffer->data)
+    {
+        if (buffer->mirror) tb_virtual_memory_mirror_free(buffer->data, buffer->maxn);
+        else tb_free(buffer->data);
+        buffer->data = tb_null;
+    }
+}
+static __tb_inline__ tb_void_t tb_queue_buffer_head_move(tb_queue_buffer_ref_t buffer, tb_size_t size)
+{
+    // update
+    buffer->head += size;
+    buffer->size -= size;
+
+    // null? reset head
+    if (!buffer->size) buffer->head = buffer->data;
+    // wrap around the head to the first view if be mirrored
+    else if (buffer->mirror && buffer->head >= buffer->data + buffer->maxn)
+        buffer->head -= buffer->maxn;
+}
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * implementation
@@ -40,15 +87,35 @@ tb_bool_t tb_queue_buffer_init(tb_queue_buffer_ref_t buffer, tb_size_t maxn)
     buffer->head = tb_null;
     buffer->size = 0;
     buffer->maxn = maxn;
+    buffer->mirror = tb_false;
 
     // ok
     return tb_true;
 }
+tb_bool_t tb_queue_buffer_mirror(tb_queue_buffer_ref_t buffer, tb_bool_t mirror)
+{
+    // check
+    tb_assert_and_check_return_val(buffer && !buffer->size, tb_false);
+
+    // not supported?
+    if (mirror && !tb_virtual_memory_mirror_size(1)) return tb_false;
+
+    // free the previous data, it will be made again when writing data
+    if (buffer->data && buffer->mirror != mirror)
+    {
+        tb_queue_buffer_data_free(buffer);
+        buffer->head = tb_null;
+    }
+
+    // save it
+    buffer->mirror = mirror;
+    return tb_true;
+}
 tb_void_t tb_queue_buffer_exit(tb_queue_buffer_ref_t buffer)
 {
     if (buffer)
     {
-        if (buffer->data) tb_free(buffer->data);
+        tb_queue_buffer_data_free(buffer);
         tb_memset(buffer, 0, sizeof(tb_queue_buffer_t));
     }
 }
@@ -130,8 +197,37 @@ tb_byte_t* tb_queue_buffer_resize(tb_queue_buffer_ref_t buffer, tb_size_t maxn)
     // check
     tb_assert_and_check_return_val(buffer && maxn && maxn >= buffer->size, tb_null);
 
+    // has mirrored data? grow it only
+    if (buffer->data && buffer->mirror)
+    {
+        // enough?
+        tb_check_return_val(maxn > buffer->maxn, buffer->data);
+
+        // make the new data
+        tb_byte_t* data_old = buffer->data;
+        tb_size_t  maxn_old = buffer->maxn;
+        tb_byte_t* data = tb_queue_buffer_data_make(buffer, maxn);
+        if (!data)
+        {
+            // restore the old data
+            buffer->mirror = tb_true;
+            buffer->maxn = maxn_old;
+            return tb_null;
+        }
+
+        // copy data to the new head, the data is contiguous in the mirrored views
+        if (buffer->size) tb_memcpy(data, buffer->head, buffer->size);
+
+        // free the old data
+        tb_virtual_memory_mirror_free(data_old, maxn_old);
+
+        // save data
+        buffer->data = data;
+        buffer->head = data;
+        return buffer->data;
+    }
     // has data?
-    if (buffer->data)
+    else if (buffer->data)
     {
         // move data to head
         if (buffer->head != buffer->data)
@@ -172,11 +268,7 @@ tb_long_t tb_queue_buffer_skip(tb_queue_buffer_ref_t buffer, tb_size_t size)
 
     // read data
     tb_long_t read = buffer->size > size? size : buffer->size;
-    buffer->head += read;
-    buffer->size -= read;
-
-    // null? reset head
-    if (!buffer->size) buffer->head = buffer->data;
+    tb_queue_buffer_head_move(buffer, read);
 
     // ok
     return read;
@@ -193,11 +285,7 @@ tb_long_t tb_queue_buffer_read(tb_queue_buffer_ref_t buffer, tb_byte_t* data, tb
     // read data
     tb_long_t read = buffer->size > size? size : buffer->size;
     tb_memcpy(data, buffer->head, read);
-    buffer->head += read;
-    buffer->size -= read;
-
-    // null? reset head
-    if (!buffer->size) buffer->head = buffer->data;
+    tb_queue_buffer_head_move(buffer, read);
 
     // ok
     return read;
@@ -211,7 +299,7 @@ tb_long_t tb_queue_buffer_writ(tb_queue_buffer_ref_t buffer, tb_byte_t const* da
     if (!buffer->data)
     {
         // make data
-        buffer->data = tb_malloc_bytes(buffer->maxn);
+        buffer->data = tb_queue_buffer_data_make(buffer, buffer->maxn);
         tb_assert_and_check_return_val(buffer->data, -1);
 
         // init it
@@ -224,9 +312,16 @@ tb_long_t tb_queue_buffer_writ(tb_queue_buffer_ref_t buffer, tb_byte_t const* da
     tb_size_t left = buffer->maxn - buffer->size;
     tb_check_return_val(left, 0);
 
-    // attempt to write data in tail directly if the tail space is enough
+    // attempt to write data in tail directly if the tail space is enough, the tail space is always enough if be mirrored
     tb_byte_t* tail = buffer->head + buffer->size;
-    if (buffer->data + buffer->maxn >= tail + size)
+    if (buffer->mirror)
+    {
+        tb_size_t writ = left > size? size : left;
+        tb_memcpy(tail, data, writ);
+        buffer->size += writ;
+        return (tb_long_t)writ;
+    }
+    else if (buffer->data + buffer->maxn >= tail + size)
     {
         tb_memcpy(tail, data, size);
         buffer->size += size;
@@ -269,11 +364,7 @@ tb_void_t tb_queue_buffer_pull_exit(tb_queue_buffer_ref_t buffer, tb_size_t size
     tb_assert_and_check_return(buffer && buffer->head && size <= buffer->size);
 
     // update
-    buffer->size -= size;
-    buffer->head += size;
-
-    // null? reset head
-    if (!buffer->size) buffer->head = buffer->data;
+    tb_queue_buffer_head_move(buffer, size);
 }
 tb_byte_t* tb_queue_buffer_push_init(tb_queue_buffer_ref_t buffer, tb_size_t* size)
 {
@@ -284,7 +375,7 @@ tb_byte_t* tb_queue_buffer_push_init(tb_queue_buffer_ref_t buffer, tb_size_t* si
     if (!buffer->data)
     {
         // make data
-        buffer->data = tb_malloc_bytes(buffer->maxn);
+        buffer->data = tb_queue_buffer_data_make(buffer, buffer->maxn);
         tb_assert_and_check_return_val(buffer->data, tb_null);
 
         // init
@@ -297,8 +388,8 @@ tb_byte_t* tb_queue_buffer_push_init(tb_queue_buffer_ref_t buffer, tb_size_t* si
     tb_size_t left = buffer->maxn - buffer->size;
     tb_check_return_val(left, tb_null);
 
-    // move data to head first, make sure there is enough write space
-    if (buffer->head != buffer->data)
+    // move data to head first, make sure there is enough write space, the mirrored buffer need not it
+    if (!buffer->mirror && buffer->head != buffer->data)
     {
         if (buffer->size) tb_memmov(buffer->data, buffer->head, buffer->size);
         buffer->head = buffer->data;
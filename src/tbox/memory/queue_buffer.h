@@ -51,6 +51,9 @@ typedef struct __tb_queue_buffer_t
     // the buffer maxn
     tb_size_t       maxn;
 
+    // is mirrored? the data pages are mapped twice back-to-back and the head will wrap around
+    tb_bool_t       mirror;
+
 }tb_queue_buffer_t, *tb_queue_buffer_ref_t;
 
 /* //////////////////////////////////////////////////////////////////////////////////////
@@ -66,6 +69,20 @@ typedef struct __tb_queue_buffer_t
  */
 tb_bool_t           tb_queue_buffer_init(tb_queue_buffer_ref_t buffer, tb_size_t maxn);
 
+/*! enable or disable the mirrored data for the empty buffer
+ *
+ * the mirrored buffer maps the same pages twice back-to-back by the virtual memory,
+ * so the readable and writable spans are always contiguous and we need not move data to head.
+ *
+ * @note the maxn will be aligned to the page size and it will only grow for the mirrored buffer
+ *
+ * @param buffer    the buffer
+ * @param mirror    is mirrored?
+ *
+ * @return          tb_true or tb_false if the mirrored memory is not supported
+ */
+tb_bool_t           tb_queue_buffer_mirror(tb_queue_buffer_ref_t buffer, tb_bool_t mirror);
+
 /*! exit buffer
  *
  * @param buffer    the buffer
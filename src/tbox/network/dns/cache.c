@@ -55,8 +55,14 @@ typedef struct __tb_dns_cache_t
     // the hash
     tb_hash_map_ref_t       hash;
 
+    /* the lock, the readers only update the item times atomically
+     *
+     * it is never freed, because get and set load it without g_lock and may still use it after exit
+     */
+    tb_rwlock_ref_t         lock;
+
     // the times
-    tb_hize_t               times;
+    tb_atomic64_t           times;
 
     // the expired
     tb_size_t               expired;
@@ -70,7 +76,7 @@ typedef struct __tb_dns_cache_addr_t
     tb_ipaddr_t             addr;
 
     // the time
-    tb_size_t               time;
+    tb_atomic_t             time;
 
 }tb_dns_cache_addr_t;
 
@@ -78,8 +84,8 @@ typedef struct __tb_dns_cache_addr_t
  * globals
  */
 
-// the lock
-static tb_spinlock_t        g_lock = TB_SPINLOCK_INIT;
+// the lock for init and exit
+static tb_futexlock_t       g_lock = TB_FUTEXLOCK_INIT;
 
 // the cache
 static tb_dns_cache_t       g_cache = {0};
@@ -111,8 +117,8 @@ static tb_bool_t tb_dns_cache_clear(tb_iterator_ref_t iterator, tb_cpointer_t it
         tb_trace_d("del: %s => %{ipaddr}, time: %u, size: %u", (tb_char_t const*)item->name, &caddr->addr, caddr->time, tb_hash_map_size(g_cache.hash));
 
         // update times
-        tb_assert(g_cache.times >= caddr->time);
-        g_cache.times -= caddr->time;
+        tb_assert(tb_atomic64_get(&g_cache.times) >= caddr->time);
+        tb_atomic64_fetch_and_sub(&g_cache.times, caddr->time);
     }
 
     // ok?
@@ -125,12 +131,16 @@ static tb_bool_t tb_dns_cache_clear(tb_iterator_ref_t iterator, tb_cpointer_t it
 tb_bool_t tb_dns_cache_init()
 {
     // enter
-    tb_spinlock_enter(&g_lock);
+    tb_futexlock_enter(&g_lock);
 
     // done
     tb_bool_t ok = tb_false;
     do
     {
+        // init lock, it will be reused after exit
+        if (!g_cache.lock) g_cache.lock = tb_rwlock_init();
+        tb_assert_and_check_break(g_cache.lock);
+
         // init hash
         if (!g_cache.hash) g_cache.hash = tb_hash_map_init(tb_align8(tb_isqrti(TB_DNS_CACHE_MAXN) + 1), tb_element_str(tb_false), tb_element_mem(sizeof(tb_dns_cache_addr_t), tb_null, tb_null));
         tb_assert_and_check_break(g_cache.hash);
@@ -141,7 +151,7 @@ tb_bool_t tb_dns_cache_init()
     } while (0);
 
     // leave
-    tb_spinlock_leave(&g_lock);
+    tb_futexlock_leave(&g_lock);
 
     // failed? exit it
     if (!ok) tb_dns_cache_exit();
@@ -152,20 +162,22 @@ tb_bool_t tb_dns_cache_init()
 tb_void_t tb_dns_cache_exit()
 {
     // enter
-    tb_spinlock_enter(&g_lock);
+    tb_futexlock_enter(&g_lock);
 
     // exit hash
+    if (g_cache.lock) tb_rwlock_enter_write(g_cache.lock);
     if (g_cache.hash) tb_hash_map_exit(g_cache.hash);
     g_cache.hash = tb_null;
+    if (g_cache.lock) tb_rwlock_leave_write(g_cache.lock);
 
     // exit times
-    g_cache.times = 0;
+    tb_atomic64_set(&g_cache.times, 0);
 
     // exit expired
     g_cache.expired = 0;
 
     // leave
-    tb_spinlock_leave(&g_lock);
+    tb_futexlock_leave(&g_lock);
 }
 tb_bool_t tb_dns_cache_get(tb_char_t const* name, tb_ipaddr_ref_t addr)
 {
@@ -192,14 +204,16 @@ tb_bool_t tb_dns_cache_get(tb_char_t const* name, tb_ipaddr_ref_t addr)
     tb_ipaddr_clear(addr);
 
     // enter
-    tb_spinlock_enter(&g_lock);
+    tb_rwlock_ref_t lock = g_cache.lock;
+    tb_check_return_val(lock, tb_false);
+    tb_rwlock_enter_read(lock);
 
     // done
     tb_bool_t ok = tb_false;
     do
     {
-        // check
-        tb_assert_and_check_break(g_cache.hash);
+        // check, it may have been exited
+        tb_check_break(g_cache.hash);
 
         // get the host address
         tb_dns_cache_addr_t* caddr = (tb_dns_cache_addr_t*)tb_hash_map_get(g_cache.hash, name);
@@ -208,11 +222,11 @@ tb_bool_t tb_dns_cache_get(tb_char_t const* name, tb_ipaddr_ref_t addr)
         // trace
         tb_trace_d("get: %s => %{ipaddr}, time: %u => %u, size: %u", name, &caddr->addr, caddr->time, tb_dns_cache_now(), tb_hash_map_size(g_cache.hash));
 
-        // update time
-        tb_assert_and_check_break(g_cache.times >= caddr->time);
-        g_cache.times -= caddr->time;
-        caddr->time = tb_dns_cache_now();
-        g_cache.times += caddr->time;
+        // update time, we only hold the read lock, so update it atomically
+        tb_long_t now = (tb_long_t)tb_dns_cache_now();
+        tb_long_t time = tb_atomic_get(&caddr->time);
+        if (time != now && tb_atomic_compare_and_swap(&caddr->time, &time, now))
+            tb_atomic64_fetch_and_add(&g_cache.times, now - time);
 
         // save address
         tb_ipaddr_copy(addr, &caddr->addr);
@@ -223,7 +237,7 @@ tb_bool_t tb_dns_cache_get(tb_char_t const* name, tb_ipaddr_ref_t addr)
     } while (0);
 
     // leave
-    tb_spinlock_leave(&g_lock);
+    tb_rwlock_leave_read(lock);
 
     // ok?
     return ok;
@@ -245,19 +259,21 @@ tb_void_t tb_dns_cache_set(tb_char_t const* name, tb_ipaddr_ref_t addr)
     tb_ipaddr_copy(&caddr.addr, addr);
 
     // enter
-    tb_spinlock_enter(&g_lock);
+    tb_rwlock_ref_t lock = g_cache.lock;
+    tb_check_return(lock);
+    tb_rwlock_enter_write(lock);
 
     // done
     do
     {
-        // check
-        tb_assert_and_check_break(g_cache.hash);
+        // check, it may have been exited
+        tb_check_break(g_cache.hash);
 
         // remove the expired items if full
         if (tb_hash_map_size(g_cache.hash) >= TB_DNS_CACHE_MAXN)
         {
             // the expired time
-            g_cache.expired = ((tb_size_t)(g_cache.times / tb_hash_map_size(g_cache.hash)) + 1);
+            g_cache.expired = ((tb_size_t)(tb_atomic64_get(&g_cache.times) / tb_hash_map_size(g_cache.hash)) + 1);
 
             // check
             tb_assert_and_check_break(g_cache.expired);
@@ -276,7 +292,7 @@ tb_void_t tb_dns_cache_set(tb_char_t const* name, tb_ipaddr_ref_t addr)
         tb_hash_map_insert(g_cache.hash, name, &caddr);
 
         // update times
-        g_cache.times += caddr.time;
+        tb_atomic64_fetch_and_add(&g_cache.times, caddr.time);
 
         // trace
         tb_trace_d("set: %s => %{ipaddr}, time: %u, size: %u", name, &caddr.addr, caddr.time, tb_hash_map_size(g_cache.hash));
@@ -284,5 +300,5 @@ tb_void_t tb_dns_cache_set(tb_char_t const* name, tb_ipaddr_ref_t addr)
     } while (0);
 
     // leave
-    tb_spinlock_leave(&g_lock);
+    tb_rwlock_leave_write(lock);
 }
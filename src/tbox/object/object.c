@@ -307,8 +307,11 @@ tb_object_ref_t tb_object_read_from_url(tb_char_t const* url)
     // init
     tb_object_ref_t object = tb_null;
 
-    // make stream
-    tb_stream_ref_t stream = tb_stream_init_from_url(url);
+    // make stream, we map the local file to read it without copying
+    tb_stream_ref_t stream = tb_null;
+    if (tb_url_protocol_probe(url) == TB_URL_PROTOCOL_FILE)
+        stream = tb_stream_init_from_mmap(url, TB_FILE_MMAP_ADVICE_SEQUENTIAL);
+    if (!stream) stream = tb_stream_init_from_url(url);
     tb_assert_and_check_return_val(stream, tb_null);
 
     // read object
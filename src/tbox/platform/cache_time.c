@@ -24,16 +24,111 @@
  * includes
  */
 #include "cache_time.h"
+#include "tsc.h"
 #include "time.h"
 #include "atomic.h"
+#include "thread.h"
+#include "seqlock.h"
 #include "../libc/libc.h"
+#include "../utils/singleton.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the update interval of the ticker, ms
+#define TB_CACHE_TIME_TICKER_INTERVAL       (1)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the cache time ticker type
+typedef struct __tb_cache_time_ticker_t
+{
+    // the ticker thread
+    tb_thread_ref_t         thread;
+
+    // is stopped?
+    tb_atomic32_t           stop;
+
+}tb_cache_time_ticker_t;
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * globals
  */
 
-// the cached time
+// the coarse monotonic ms-clock, it is only updated by the ticker
+static tb_atomic64_t    g_coarse = 0;
+
+#if TB_CPU_BIT64
+// the cached time, the atomic64 load is lock-free on 64bits platforms
 static tb_atomic64_t    g_time = 0;
+#else
+// the cached time, we use seqlock instead of atomic64 because it may be locked on some 32bits platforms
+static tb_hong_t        g_time = 0;
+
+// the cached time lock, the readers only retry if it has been changed
+static tb_seqlock_t     g_time_lock = TB_SEQLOCK_INIT;
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static tb_int_t tb_cache_time_ticker_loop(tb_cpointer_t priv)
+{
+    // update the cached clocks until it is stopped
+    tb_cache_time_ticker_t* ticker = (tb_cache_time_ticker_t*)priv;
+    while (!tb_atomic32_get(&ticker->stop))
+    {
+        tb_atomic64_set_explicit(&g_coarse, tb_tsc_clock() / 1000000, TB_ATOMIC_RELAXED);
+        tb_cache_time_spak();
+        tb_usleep(TB_CACHE_TIME_TICKER_INTERVAL * 1000);
+    }
+    return 0;
+}
+static tb_handle_t tb_cache_time_ticker_init(tb_cpointer_t* ppriv)
+{
+    // init ticker
+    tb_cache_time_ticker_t* ticker = tb_malloc0_type(tb_cache_time_ticker_t);
+    tb_assert_and_check_return_val(ticker, tb_null);
+
+    // update the cached clocks before the ticker thread is started
+    tb_atomic64_set(&g_coarse, tb_tsc_clock() / 1000000);
+    tb_cache_time_spak();
+
+    // start the ticker thread
+    ticker->thread = tb_thread_init(tb_null, tb_cache_time_ticker_loop, ticker, 0);
+    if (!ticker->thread)
+    {
+        tb_free(ticker);
+        return tb_null;
+    }
+    return (tb_handle_t)ticker;
+}
+static tb_void_t tb_cache_time_ticker_exit(tb_handle_t handle, tb_cpointer_t priv)
+{
+    // check
+    tb_cache_time_ticker_t* ticker = (tb_cache_time_ticker_t*)handle;
+    tb_assert_and_check_return(ticker);
+
+    // exit the ticker thread
+    if (ticker->thread)
+    {
+        tb_atomic32_set(&ticker->stop, 1);
+        if (!tb_thread_wait(ticker->thread, 5000, tb_null)) return ;
+        tb_thread_exit(ticker->thread);
+    }
+
+    // exit it
+    tb_free(ticker);
+}
+static tb_void_t tb_cache_time_ticker_kill(tb_handle_t handle, tb_cpointer_t priv)
+{
+    // stop it
+    tb_cache_time_ticker_t* ticker = (tb_cache_time_ticker_t*)handle;
+    if (ticker) tb_atomic32_set(&ticker->stop, 1);
+}
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * implementation
@@ -48,16 +143,35 @@ tb_hong_t tb_cache_time_spak()
     tb_hong_t val = ((tb_hong_t)tv.tv_sec * 1000 + tv.tv_usec / 1000);
 
     // save it
+#if TB_CPU_BIT64
     tb_atomic64_set(&g_time, val);
+#else
+    tb_seqlock_write_enter(&g_time_lock);
+    g_time = val;
+    tb_seqlock_write_leave(&g_time_lock);
+#endif
 
     // ok
     return val;
 }
 tb_hong_t tb_cache_time_mclock()
 {
+    // get the cached time
     tb_hong_t t;
-    if (!(t = (tb_hong_t)tb_atomic64_get(&g_time)))
-        t = tb_cache_time_spak();
+#if TB_CPU_BIT64
+    t = (tb_hong_t)tb_atomic64_get(&g_time);
+#else
+    tb_size_t seq;
+    do
+    {
+        seq = tb_seqlock_read_begin(&g_time_lock);
+        t = g_time;
+
+    } while (tb_seqlock_read_retry(&g_time_lock, seq));
+#endif
+
+    // not cached yet?
+    if (!t) t = tb_cache_time_spak();
     return t;
 }
 tb_hong_t tb_cache_time_sclock()
@@ -68,4 +182,14 @@ tb_time_t tb_cache_time()
 {
     return (tb_time_t)tb_cache_time_sclock();
 }
+tb_hong_t tb_cache_time_coarse()
+{
+    // get the coarse clock, it only need one atomic load after the ticker has been started
+    tb_hong_t t = tb_atomic64_get_explicit(&g_coarse, TB_ATOMIC_RELAXED);
+    tb_check_return_val(!t, t);
 
+    // start the ticker
+    if (!tb_singleton_instance(TB_SINGLETON_TYPE_CACHE_TIME, tb_cache_time_ticker_init, tb_cache_time_ticker_exit, tb_cache_time_ticker_kill, tb_null))
+        return tb_tsc_clock() / 1000000;
+    return tb_atomic64_get(&g_coarse);
+}
@@ -60,6 +60,17 @@ tb_hong_t           tb_cache_time_spak(tb_noarg_t);
  */
 tb_hong_t           tb_cache_time_mclock(tb_noarg_t);
 
+/*! the coarse monotonic ms-clock
+ *
+ * it is updated by the background ticker thread every ms, so we only need one atomic load
+ * and need not call tb_cache_time_spak(), the other cached clocks will also be updated by the ticker.
+ *
+ * @note the ticker thread will be started when it is called for the first time
+ *
+ * @return          the now ms-clock
+ */
+tb_hong_t           tb_cache_time_coarse(tb_noarg_t);
+
 /*! the cached s-clock
  *
  * lower accuracy and faster
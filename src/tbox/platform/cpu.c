@@ -24,6 +24,97 @@
  */
 #include "prefix.h"
 #include "cpu.h"
+#include "file.h"
+#include "thread.h"
+#include "../libc/libc.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * globals
+ */
+
+// the cpus of the numa nodes
+static tb_cpuset_t      g_numa_nodes[TB_CPU_NUMA_MAXN];
+
+// the numa nodes count
+static tb_size_t        g_numa_count = 0;
+
+// the numa nodes loading once
+static tb_atomic32_t    g_numa_once = 0;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+#ifdef TB_CONFIG_OS_LINUX
+static tb_bool_t tb_cpu_numa_list(tb_char_t const* path, tb_cpuset_ref_t cpuset)
+{
+    // read the list file, .e.g 0-3,8-11
+    tb_char_t       data[256];
+    tb_long_t       size = -1;
+    tb_file_ref_t   file = tb_file_init(path, TB_FILE_MODE_RO);
+    if (file)
+    {
+        size = tb_file_read(file, (tb_byte_t*)data, sizeof(data) - 1);
+        tb_file_exit(file);
+    }
+    tb_check_return_val(size > 0, tb_false);
+    data[size] = '\0';
+
+    // parse it
+    tb_char_t const* p = data;
+    TB_CPUSET_ZERO(cpuset);
+    while (tb_isdigit(*p))
+    {
+        // get the range
+        tb_size_t first = 0;
+        while (tb_isdigit(*p)) first = first * 10 + (*p++ - '0');
+        tb_size_t last = first;
+        if (*p == '-')
+        {
+            p++;
+            last = 0;
+            while (tb_isdigit(*p)) last = last * 10 + (*p++ - '0');
+        }
+
+        // save it
+        for (; first <= last && first < TB_CPUSET_SIZE; first++)
+            TB_CPUSET_SET(first, cpuset);
+
+        // the next range
+        if (*p == ',') p++;
+    }
+    return tb_true;
+}
+#endif
+static tb_bool_t tb_cpu_numa_load(tb_cpointer_t priv)
+{
+#ifdef TB_CONFIG_OS_LINUX
+    // load the cpus of all online nodes, the memory-only nodes will be ignored
+    tb_cpuset_t nodes;
+    if (tb_cpu_numa_list("/sys/devices/system/node/online", &nodes))
+    {
+        tb_size_t node = 0;
+        tb_char_t path[64];
+        for (node = 0; node < TB_CPUSET_SIZE && g_numa_count < TB_CPU_NUMA_MAXN; node++)
+        {
+            tb_check_continue(TB_CPUSET_ISSET(node, &nodes));
+            tb_snprintf(path, sizeof(path), "/sys/devices/system/node/node%lu/cpulist", node);
+            if (tb_cpu_numa_list(path, &g_numa_nodes[g_numa_count]) && !TB_CPUSET_EMPTY(&g_numa_nodes[g_numa_count]))
+                g_numa_count++;
+        }
+    }
+#endif
+
+    // no numa? all cpus are in one node
+    if (!g_numa_count)
+    {
+        tb_size_t cpu = 0;
+        tb_size_t ncpu = tb_min(tb_cpu_count(), TB_CPUSET_SIZE);
+        TB_CPUSET_ZERO(&g_numa_nodes[0]);
+        for (cpu = 0; cpu < ncpu; cpu++) TB_CPUSET_SET(cpu, &g_numa_nodes[0]);
+        g_numa_count = 1;
+    }
+    return tb_true;
+}
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * implementation
@@ -38,4 +129,17 @@ tb_size_t tb_cpu_count()
     return 1;
 }
 #endif
+tb_size_t tb_cpu_numa_count()
+{
+    tb_thread_once(&g_numa_once, tb_cpu_numa_load, tb_null);
+    return g_numa_count;
+}
+tb_bool_t tb_cpu_numa_cpuset(tb_size_t node, tb_cpuset_ref_t cpuset)
+{
+    // check
+    tb_assert_and_check_return_val(cpuset && node < tb_cpu_numa_count(), tb_false);
 
+    // get the cpus of this node
+    *cpuset = g_numa_nodes[node];
+    return tb_true;
+}
@@ -26,6 +26,7 @@
  * includes
  */
 #include "prefix.h"
+#include "sched.h"
 #if defined(TB_CONFIG_OS_WINDOWS) && defined(TB_COMPILER_IS_MSVC)
 #   include "windows/prefix.h"
 #   include <intrin.h>
@@ -68,6 +69,9 @@
 #   endif
 #endif
 
+/// the numa nodes maxn
+#define TB_CPU_NUMA_MAXN            (8)
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * extern
  */
@@ -83,6 +87,23 @@ __tb_extern_c_enter__
  */
 tb_size_t               tb_cpu_count(tb_noarg_t);
 
+/*! the numa nodes count
+ *
+ * @note only the nodes with cpus are counted, and it is 1 if numa is not supported
+ *
+ * @return              the numa nodes count
+ */
+tb_size_t               tb_cpu_numa_count(tb_noarg_t);
+
+/*! get the cpus of the given numa node
+ *
+ * @param node          the numa node index, it must be less than tb_cpu_numa_count()
+ * @param cpuset        the cpu set
+ *
+ * @return              tb_true or tb_false
+ */
+tb_bool_t               tb_cpu_numa_cpuset(tb_size_t node, tb_cpuset_ref_t cpuset);
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * extern
  */
@@ -34,6 +34,8 @@
  */
 #if defined(TB_CONFIG_OS_WINDOWS)
 #   include "windows/event.c"
+#elif defined(TB_CONFIG_OS_LINUX) || defined(TB_CONFIG_OS_ANDROID)
+#   include "linux/event.c"
 #else
 tb_event_ref_t tb_event_init()
 {
@@ -93,6 +93,21 @@ tb_long_t tb_file_pwritv(tb_file_ref_t file, tb_iovec_t const* list, tb_size_t s
     tb_trace_noimpl();
     return -1;
 }
+tb_byte_t const* tb_file_mmap(tb_file_ref_t file, tb_hize_t offset, tb_size_t size, tb_size_t advice)
+{
+    tb_trace_noimpl();
+    return tb_null;
+}
+tb_bool_t tb_file_munmap(tb_byte_t const* data, tb_size_t size)
+{
+    tb_trace_noimpl();
+    return tb_false;
+}
+tb_bool_t tb_file_advise(tb_file_ref_t file, tb_hize_t offset, tb_hize_t size, tb_size_t advice)
+{
+    tb_trace_noimpl();
+    return tb_false;
+}
 tb_bool_t tb_file_sync(tb_file_ref_t file)
 {
     tb_trace_noimpl();
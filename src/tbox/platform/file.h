@@ -36,8 +36,8 @@ __tb_extern_c_enter__
  * macros
  */
 
-/// the aligned size for direct mode
-#define TB_FILE_DIRECT_ASIZE            (512)
+/// the aligned size for direct mode, the logical block size of the most disks is 512 or 4096
+#define TB_FILE_DIRECT_ASIZE            (4096)
 
 /// the cached size for direct mode
 #ifdef __tb_small__
@@ -59,7 +59,7 @@ typedef enum __tb_file_mode_e
 ,   TB_FILE_MODE_CREAT      = 8     //!< create
 ,   TB_FILE_MODE_APPEND     = 16    //!< append
 ,   TB_FILE_MODE_TRUNC      = 32    //!< truncate
-,   TB_FILE_MODE_DIRECT     = 64    //!< direct, no cache, @note data & size must be aligned by TB_FILE_DIRECT_ASIZE
+,   TB_FILE_MODE_DIRECT     = 64    //!< direct, no cache, @note data, size & offset should be aligned by TB_FILE_DIRECT_ASIZE, the unaligned io will be copied by the aligned buffer on linux
 ,   TB_FILE_MODE_EXEC       = 128   //!< executable, only for tb_file_access, not supported when creating files, not supported on windows
 
 }tb_file_mode_e;
@@ -100,6 +100,15 @@ typedef enum __tb_file_flag_e
 
 }tb_file_flag_e;
 
+/// the file mmap advice
+typedef enum __tb_file_mmap_advice_e
+{
+    TB_FILE_MMAP_ADVICE_NONE        = 0 //!< no advice
+,   TB_FILE_MMAP_ADVICE_SEQUENTIAL  = 1 //!< the mapped data will be accessed sequentially, we can read ahead aggressively
+,   TB_FILE_MMAP_ADVICE_RANDOM      = 2 //!< the mapped data will be accessed randomly, we need not read ahead
+
+}tb_file_mmap_advice_e;
+
 /// the file info type
 typedef struct __tb_file_info_t
 {
@@ -236,6 +245,39 @@ tb_long_t               tb_file_preadv(tb_file_ref_t file, tb_iovec_t const* lis
  */
 tb_long_t               tb_file_pwritv(tb_file_ref_t file, tb_iovec_t const* list, tb_size_t size, tb_hize_t offset);
 
+/*! map the file data to the memory for reading
+ *
+ * @note the mapped data is read-only and it is still valid after the file has been exited
+ *
+ * @param file          the file
+ * @param offset        the file offset, it need not be aligned by the page size
+ * @param size          the mapped size
+ * @param advice        the access advice, e.g. TB_FILE_MMAP_ADVICE_SEQUENTIAL
+ *
+ * @return              the mapped data, failed: tb_null
+ */
+tb_byte_t const*        tb_file_mmap(tb_file_ref_t file, tb_hize_t offset, tb_size_t size, tb_size_t advice);
+
+/*! unmap the file data
+ *
+ * @param data          the mapped data of tb_file_mmap()
+ * @param size          the mapped size
+ *
+ * @return              tb_true or tb_false
+ */
+tb_bool_t               tb_file_munmap(tb_byte_t const* data, tb_size_t size);
+
+/*! advise the access pattern of the file data, it is only a hint for the kernel cache
+ *
+ * @param file          the file
+ * @param offset        the file offset
+ * @param size          the advised size, zero means up to the end of the file
+ * @param advice        the access advice, e.g. TB_FILE_MMAP_ADVICE_SEQUENTIAL
+ *
+ * @return              tb_true or tb_false
+ */
+tb_bool_t               tb_file_advise(tb_file_ref_t file, tb_hize_t offset, tb_hize_t size, tb_size_t advice);
+
 /*! seek the file offset
  *
  * @param file          the file
@@ -0,0 +1,57 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        futex.c
+ * @ingroup     platform
+ *
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "futex.h"
+#include "time.h"
+#include "sched.h"
+#include "atomic32.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+#if defined(TB_CONFIG_OS_LINUX) || defined(TB_CONFIG_OS_ANDROID)
+#   include "linux/futex.c"
+#else
+tb_long_t tb_futex_wait(tb_atomic32_t* futex, tb_int32_t value, tb_long_t timeout)
+{
+    // check
+    tb_assert_and_check_return_val(futex, -1);
+
+    // the value has been changed?
+    tb_check_return_val(tb_atomic32_get(futex) == value, 1);
+
+    // we only yield it and the caller will check the value again
+    if (timeout) tb_sched_yield();
+    return timeout? 1 : 0;
+}
+tb_size_t tb_futex_wake(tb_atomic32_t* futex, tb_size_t count)
+{
+    // check
+    tb_assert_and_check_return_val(futex, 0);
+
+    // the waiters are only yielded, so we need not wake up them
+    return 0;
+}
+#endif
@@ -0,0 +1,68 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        futex.h
+ * @ingroup     platform
+ *
+ */
+#ifndef TB_PLATFORM_FUTEX_H
+#define TB_PLATFORM_FUTEX_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/*! wait on the futex address if it is still equal to the given value
+ *
+ * it will be waked up by tb_futex_wake() and it may be waked up spuriously,
+ * so the caller need check the futex value again after returning.
+ *
+ * @note it only yields the current thread if the native futex is not supported
+ *
+ * @param futex     the futex address
+ * @param value     the expected value
+ * @param timeout   the timeout, infinity: -1
+ *
+ * @return          waked up or the value has been changed: 1, timeout or interrupted: 0, failed: -1
+ */
+tb_long_t           tb_futex_wait(tb_atomic32_t* futex, tb_int32_t value, tb_long_t timeout);
+
+/*! wake up the waiters of the futex address
+ *
+ * @param futex     the futex address
+ * @param count     the maximum count of the waked waiters, all waiters: -1
+ *
+ * @return          the waked waiters count
+ */
+tb_size_t           tb_futex_wake(tb_atomic32_t* futex, tb_size_t count);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
@@ -0,0 +1,222 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        futexlock.h
+ * @ingroup     platform
+ *
+ */
+#ifndef TB_PLATFORM_FUTEXLOCK_H
+#define TB_PLATFORM_FUTEXLOCK_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+#include "cpu.h"
+#include "futex.h"
+#include "atomic.h"
+#include "../utils/lock_profiler.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the initial value
+#define TB_FUTEXLOCK_INIT           (0)
+
+// the unlocked state
+#define TB_FUTEXLOCK_UNLOCKED       (0)
+
+// the locked state without waiters
+#define TB_FUTEXLOCK_LOCKED         (1)
+
+// the locked state with the parked waiters
+#define TB_FUTEXLOCK_PARKED         (2)
+
+// the maximum spinning pause count before parking the current thread
+#define TB_FUTEXLOCK_SPIN_MAXN      (128)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+/*! the adaptive futex lock type
+ *
+ * it spins shortly first and parks the current thread on the futex if the lock is still busy,
+ * so the waiting threads sleep in the kernel instead of yielding in a loop on long critical sections.
+ *
+ * it can be used anywhere tb_spinlock_t is used, but it only yields the thread like spinlock
+ * if the native futex is not supported.
+ */
+typedef tb_atomic32_t               tb_futexlock_t;
+
+/// the futex lock ref type
+typedef tb_futexlock_t*             tb_futexlock_ref_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/*! init futex lock
+ *
+ * @param lock      the lock
+ *
+ * @return          tb_true or tb_false
+ */
+static __tb_inline_force__ tb_bool_t tb_futexlock_init(tb_futexlock_ref_t lock)
+{
+    // check
+    tb_assert(lock);
+    tb_atomic32_set_explicit(lock, TB_FUTEXLOCK_UNLOCKED, TB_ATOMIC_RELAXED);
+    return tb_true;
+}
+
+/*! exit futex lock
+ *
+ * @param lock      the lock
+ */
+static __tb_inline_force__ tb_void_t tb_futexlock_exit(tb_futexlock_ref_t lock)
+{
+    // check
+    tb_assert(lock);
+    tb_atomic32_set_explicit(lock, TB_FUTEXLOCK_UNLOCKED, TB_ATOMIC_RELAXED);
+}
+
+/*! try to enter futex lock without the lock profiler
+ *
+ * @param lock      the lock
+ *
+ * @return          tb_true or tb_false
+ */
+static __tb_inline_force__ tb_bool_t tb_futexlock_enter_try_without_profiler(tb_futexlock_ref_t lock)
+{
+    // check
+    tb_assert(lock);
+
+    // try locking it
+    tb_int32_t unlocked = TB_FUTEXLOCK_UNLOCKED;
+    return tb_atomic32_compare_and_swap_explicit(lock, &unlocked, TB_FUTEXLOCK_LOCKED, TB_ATOMIC_ACQUIRE, TB_ATOMIC_RELAXED);
+}
+
+/*! enter futex lock without the lock profiler
+ *
+ * @param lock      the lock
+ */
+static __tb_inline_force__ tb_void_t tb_futexlock_enter_without_profiler(tb_futexlock_ref_t lock)
+{
+    // check
+    tb_assert(lock);
+
+    // lock it directly if there is no contention
+    if (tb_futexlock_enter_try_without_profiler(lock)) return ;
+
+#if defined(tb_cpu_pause) && !defined(TB_CONFIG_MICRO_ENABLE)
+    /* spin shortly first if the lock owner may be running on the other cpu,
+     * but we need not spin if there are other parked waiters already.
+     */
+    if (tb_cpu_count() > 1)
+    {
+        tb_size_t i, n;
+        for (n = 1; n <= TB_FUTEXLOCK_SPIN_MAXN; n <<= 1)
+        {
+            for (i = 0; i < n; i++)
+                tb_cpu_pause();
+
+            tb_int32_t state = tb_atomic32_get_explicit(lock, TB_ATOMIC_RELAXED);
+            if (state == TB_FUTEXLOCK_PARKED) break;
+            if (state == TB_FUTEXLOCK_UNLOCKED && tb_futexlock_enter_try_without_profiler(lock))
+                return ;
+        }
+    }
+#endif
+
+    /* park the current thread until the lock has been released
+     *
+     * we always mark it as parked after being waked up, because we do not know
+     * whether there are other waiters, so the owner will wake up one more waiter at most.
+     */
+    while (tb_atomic32_fetch_and_set_explicit(lock, TB_FUTEXLOCK_PARKED, TB_ATOMIC_ACQUIRE) != TB_FUTEXLOCK_UNLOCKED)
+        tb_futex_wait(lock, TB_FUTEXLOCK_PARKED, -1);
+}
+
+/*! enter futex lock
+ *
+ * @param lock      the lock
+ */
+static __tb_inline_force__ tb_void_t tb_futexlock_enter(tb_futexlock_ref_t lock)
+{
+#ifdef TB_LOCK_PROFILER_ENABLE
+    // occupied?
+    if (!tb_futexlock_enter_try_without_profiler(lock))
+    {
+        // occupied++
+        tb_lock_profiler_ref_t profiler = tb_lock_profiler();
+        tb_lock_profiler_occupied(profiler, (tb_pointer_t)lock);
+
+        // wait it and profile the wait time
+        tb_hong_t ticks = tb_lock_profiler_ticks();
+        tb_futexlock_enter_without_profiler(lock);
+        tb_lock_profiler_entered(profiler, (tb_pointer_t)lock, tb_lock_profiler_ticks() - ticks);
+    }
+#else
+    tb_futexlock_enter_without_profiler(lock);
+#endif
+}
+
+/*! try to enter futex lock
+ *
+ * @param lock      the lock
+ *
+ * @return          tb_true or tb_false
+ */
+static __tb_inline_force__ tb_bool_t tb_futexlock_enter_try(tb_futexlock_ref_t lock)
+{
+#ifndef TB_LOCK_PROFILER_ENABLE
+    // try locking it
+    return tb_futexlock_enter_try_without_profiler(lock);
+#else
+    // try locking it
+    tb_bool_t ok = tb_futexlock_enter_try_without_profiler(lock);
+
+    // occupied?
+    if (!ok) tb_lock_profiler_occupied(tb_lock_profiler(), (tb_pointer_t)lock);
+
+    // ok?
+    return ok;
+#endif
+}
+
+/*! leave futex lock
+ *
+ * @param lock      the lock
+ */
+static __tb_inline_force__ tb_void_t tb_futexlock_leave(tb_futexlock_ref_t lock)
+{
+    // check
+    tb_assert(lock);
+
+#ifdef TB_LOCK_PROFILER_ENABLE
+    // profile the contended hold time if it is sampled
+    tb_lock_profiler_leave((tb_pointer_t)lock);
+#endif
+
+    // unlock it and wake up one parked waiter
+    if (tb_atomic32_fetch_and_set_explicit(lock, TB_FUTEXLOCK_UNLOCKED, TB_ATOMIC_RELEASE) == TB_FUTEXLOCK_PARKED)
+        tb_futex_wake(lock, 1);
+}
+
+#endif
@@ -0,0 +1,499 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        future.c
+ * @ingroup     platform
+ *
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * trace
+ */
+#define TB_TRACE_MODULE_NAME                "future"
+#define TB_TRACE_MODULE_DEBUG               (0)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "future.h"
+#include "time.h"
+#include "atomic.h"
+#include "spinlock.h"
+#include "semaphore.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the future node type enum
+typedef enum __tb_future_node_type_e
+{
+    TB_FUTURE_NODE_TYPE_ASYNC       = 0     //!< run the async func
+,   TB_FUTURE_NODE_TYPE_THEN        = 1     //!< run the then func after the source future
+,   TB_FUTURE_NODE_TYPE_ALL         = 2     //!< finish the target future after all source futures
+,   TB_FUTURE_NODE_TYPE_ANY         = 3     //!< finish the target future after any one of source futures
+
+}tb_future_node_type_e;
+
+// the future node type, it is a continuation attached to the source future
+typedef struct __tb_future_node_t
+{
+    // the next node
+    struct __tb_future_node_t*      next;
+
+    // the node type
+    tb_uint16_t                     type;
+
+    // have been done?
+    tb_uint16_t                     done;
+
+    // the source index for when_any
+    tb_size_t                       index;
+
+    /* the source future of the then func
+     *
+     * it is referenced only after the node has been detached from the source future for running the then func,
+     * the attached node does not refer to it, otherwise they will refer to each other and
+     * will never be freed if the source future is not finished
+     */
+    struct __tb_future_t*           source;
+
+    // the target future, it is referenced by this node
+    struct __tb_future_t*           target;
+
+    // the async func
+    tb_future_async_func_t          async;
+
+    // the then func
+    tb_future_then_func_t           then;
+
+    // the private data
+    tb_cpointer_t                   priv;
+
+}tb_future_node_t;
+
+// the future type
+typedef struct __tb_future_t
+{
+    // the thread pool
+    tb_thread_pool_ref_t            pool;
+
+    // the lock
+    tb_spinlock_t                   lock;
+
+    // the reference count
+    tb_atomic32_t                   refn;
+
+    // the state
+    tb_atomic32_t                   state;
+
+    // the pending sources count for when_all and when_any
+    tb_atomic32_t                   pending;
+
+    // the value
+    tb_cpointer_t                   value;
+
+    // the waiters count
+    tb_size_t                       waiters;
+
+    // the semaphore for waiters, it will be inited lazily
+    tb_semaphore_ref_t              semaphore;
+
+    // the attached nodes
+    tb_future_node_t*               nodes;
+
+}tb_future_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * declaration
+ */
+static tb_bool_t tb_future_done(tb_future_t* future, tb_size_t state, tb_cpointer_t value);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static __tb_inline__ tb_future_t* tb_future_refer(tb_future_t* future)
+{
+    tb_atomic32_fetch_and_add(&future->refn, 1);
+    return future;
+}
+static tb_future_node_t* tb_future_node_init(tb_size_t type, tb_future_t* target)
+{
+    // make node
+    tb_future_node_t* node = tb_malloc0_type(tb_future_node_t);
+    tb_assert_and_check_return_val(node, tb_null);
+
+    // init node
+    node->type      = (tb_uint16_t)type;
+    node->target    = tb_future_refer(target);
+    return node;
+}
+static tb_void_t tb_future_node_exit(tb_future_node_t* node)
+{
+    // exit futures
+    if (node->source) tb_future_exit((tb_future_ref_t)node->source);
+    if (node->target) tb_future_exit((tb_future_ref_t)node->target);
+
+    // exit node
+    tb_free(node);
+}
+static tb_void_t tb_future_node_task_done(tb_thread_pool_worker_ref_t worker, tb_cpointer_t priv)
+{
+    // check
+    tb_future_node_t* node = (tb_future_node_t*)priv;
+    tb_assert_and_check_return(node);
+
+    // run the async or then func
+    node->done = 1;
+    tb_cpointer_t value = node->type == TB_FUTURE_NODE_TYPE_THEN? node->then(worker, (tb_future_ref_t)node->source, node->priv) : node->async(worker, node->priv);
+
+    // finish the target future, the continuations of it will be posted to the local deque of this worker
+    tb_future_done(node->target, TB_STATE_FINISHED, value);
+}
+static tb_void_t tb_future_node_task_exit(tb_thread_pool_worker_ref_t worker, tb_cpointer_t priv)
+{
+    // check
+    tb_future_node_t* node = (tb_future_node_t*)priv;
+    tb_assert_and_check_return(node);
+
+    // this task has been killed? cancel the target future
+    if (!node->done) tb_future_done(node->target, TB_STATE_KILLED, tb_null);
+
+    // exit node
+    tb_future_node_exit(node);
+}
+static tb_void_t tb_future_node_post(tb_future_node_t* node)
+{
+    // post the node task
+    if (!tb_thread_pool_task_post(node->target->pool, "future", tb_future_node_task_done, tb_future_node_task_exit, node, tb_false))
+    {
+        // the thread pool has been stopped or too many tasks? cancel the target future
+        tb_future_done(node->target, TB_STATE_KILLED, tb_null);
+        tb_future_node_exit(node);
+    }
+}
+static tb_void_t tb_future_node_done(tb_future_t* future, tb_future_node_t* node, tb_size_t state)
+{
+    // done it
+    switch (node->type)
+    {
+    case TB_FUTURE_NODE_TYPE_THEN:
+        {
+            // post the then func if the source future has been finished, it need refer to the source future now
+            if (state == TB_STATE_FINISHED)
+            {
+                node->source = tb_future_refer(future);
+                tb_future_node_post(node);
+                return ;
+            }
+
+            // cancel the target future
+            tb_future_done(node->target, TB_STATE_KILLED, tb_null);
+        }
+        break;
+    case TB_FUTURE_NODE_TYPE_ALL:
+        {
+            // cancel the target future if one of the sources has been canceled, otherwise finish it after all sources
+            if (state != TB_STATE_FINISHED) tb_future_done(node->target, TB_STATE_KILLED, tb_null);
+            else if (tb_atomic32_fetch_and_sub(&node->target->pending, 1) == 1)
+                tb_future_done(node->target, TB_STATE_FINISHED, tb_null);
+        }
+        break;
+    case TB_FUTURE_NODE_TYPE_ANY:
+        {
+            // finish the target future with the first finished source, cancel it only if all sources have been canceled
+            if (state == TB_STATE_FINISHED) tb_future_done(node->target, TB_STATE_FINISHED, (tb_cpointer_t)node->index);
+            else if (tb_atomic32_fetch_and_sub(&node->target->pending, 1) == 1)
+                tb_future_done(node->target, TB_STATE_KILLED, tb_null);
+        }
+        break;
+    default:
+        tb_assert(0);
+        break;
+    }
+
+    // exit node
+    tb_future_node_exit(node);
+}
+static tb_void_t tb_future_node_attach(tb_future_t* future, tb_future_node_t* node)
+{
+    // attach it if the future has been not finished
+    tb_spinlock_enter(&future->lock);
+    tb_size_t state = (tb_size_t)tb_atomic32_get(&future->state);
+    if (state == TB_STATE_WAITING)
+    {
+        node->next      = future->nodes;
+        future->nodes   = node;
+    }
+    tb_spinlock_leave(&future->lock);
+
+    // done it directly if the future has been finished
+    if (state != TB_STATE_WAITING) tb_future_node_done(future, node, state);
+}
+static tb_bool_t tb_future_done(tb_future_t* future, tb_size_t state, tb_cpointer_t value)
+{
+    // finish it
+    tb_spinlock_enter(&future->lock);
+    if (tb_atomic32_get(&future->state) != TB_STATE_WAITING)
+    {
+        tb_spinlock_leave(&future->lock);
+        return tb_false;
+    }
+    future->value = value;
+    tb_atomic32_set(&future->state, (tb_int32_t)state);
+    tb_future_node_t*   nodes = future->nodes;
+    tb_size_t           waiters = future->waiters;
+    future->nodes       = tb_null;
+    future->waiters     = 0;
+    tb_spinlock_leave(&future->lock);
+
+    // notify all waiters
+    if (waiters) tb_semaphore_post(future->semaphore, waiters);
+
+    // reverse nodes to done them in the attached order
+    tb_future_node_t* prev = tb_null;
+    while (nodes)
+    {
+        tb_future_node_t* next = nodes->next;
+        nodes->next = prev;
+        prev = nodes;
+        nodes = next;
+    }
+
+    // done all continuations
+    while (prev)
+    {
+        tb_future_node_t* next = prev->next;
+        tb_future_node_done(future, prev, state);
+        prev = next;
+    }
+    return tb_true;
+}
+static tb_future_ref_t tb_future_when(tb_size_t type, tb_future_ref_t const* futures, tb_size_t count)
+{
+    // check
+    tb_assert_and_check_return_val(futures && count && futures[0], tb_null);
+
+    // init the target future
+    tb_future_t* target = (tb_future_t*)tb_future_init(((tb_future_t*)futures[0])->pool);
+    tb_assert_and_check_return_val(target, tb_null);
+
+    // attach to all sources
+    tb_size_t i = 0;
+    tb_atomic32_set(&target->pending, (tb_int32_t)count);
+    for (i = 0; i < count; i++)
+    {
+        tb_future_t* source = (tb_future_t*)futures[i];
+        tb_assert_and_check_break(source);
+
+        // make node
+        tb_future_node_t* node = tb_future_node_init(type, target);
+        tb_assert_and_check_break(node);
+
+        // attach it
+        node->index = i;
+        tb_future_node_attach(source, node);
+    }
+
+    // failed? cancel it
+    if (i < count) tb_future_done(target, TB_STATE_KILLED, tb_null);
+    return (tb_future_ref_t)target;
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+tb_future_ref_t tb_future_init(tb_thread_pool_ref_t pool)
+{
+    // the thread pool
+    if (!pool) pool = tb_thread_pool();
+    tb_assert_and_check_return_val(pool, tb_null);
+
+    // make future
+    tb_future_t* future = tb_malloc0_type(tb_future_t);
+    tb_assert_and_check_return_val(future, tb_null);
+
+    // init future
+    future->pool = pool;
+    tb_spinlock_init(&future->lock);
+    tb_atomic32_init(&future->refn, 1);
+    tb_atomic32_init(&future->state, TB_STATE_WAITING);
+    tb_atomic32_init(&future->pending, 0);
+    return (tb_future_ref_t)future;
+}
+tb_void_t tb_future_exit(tb_future_ref_t self)
+{
+    // check
+    tb_future_t* future = (tb_future_t*)self;
+    tb_assert_and_check_return(future);
+
+    // refn--
+    tb_check_return(tb_atomic32_fetch_and_sub(&future->refn, 1) == 1);
+
+    /* it has been released before it is finished? it will never be finished (e.g. an unfinished promise),
+     * so we cancel it to exit all attached continuations and cancel their target futures
+     */
+    if (tb_atomic32_get(&future->state) == TB_STATE_WAITING)
+        tb_future_done(future, TB_STATE_KILLED, tb_null);
+    tb_assert(!future->nodes && !future->waiters);
+
+    // exit semaphore
+    if (future->semaphore) tb_semaphore_exit(future->semaphore);
+    future->semaphore = tb_null;
+
+    // exit lock
+    tb_spinlock_exit(&future->lock);
+
+    // exit it
+    tb_free(future);
+}
+tb_future_ref_t tb_future_async(tb_thread_pool_ref_t pool, tb_future_async_func_t func, tb_cpointer_t priv)
+{
+    // check
+    tb_assert_and_check_return_val(func, tb_null);
+
+    // init the target future
+    tb_future_t* target = (tb_future_t*)tb_future_init(pool);
+    tb_assert_and_check_return_val(target, tb_null);
+
+    // make node
+    tb_future_node_t* node = tb_future_node_init(TB_FUTURE_NODE_TYPE_ASYNC, target);
+    if (node)
+    {
+        // post it
+        node->async = func;
+        node->priv  = priv;
+        tb_future_node_post(node);
+    }
+    else tb_future_done(target, TB_STATE_KILLED, tb_null);
+    return (tb_future_ref_t)target;
+}
+tb_bool_t tb_future_set(tb_future_ref_t self, tb_cpointer_t value)
+{
+    // check
+    tb_future_t* future = (tb_future_t*)self;
+    tb_assert_and_check_return_val(future, tb_false);
+
+    // finish it
+    return tb_future_done(future, TB_STATE_FINISHED, value);
+}
+tb_bool_t tb_future_cancel(tb_future_ref_t self)
+{
+    // check
+    tb_future_t* future = (tb_future_t*)self;
+    tb_assert_and_check_return_val(future, tb_false);
+
+    // cancel it
+    return tb_future_done(future, TB_STATE_KILLED, tb_null);
+}
+tb_size_t tb_future_state(tb_future_ref_t self)
+{
+    // check
+    tb_future_t* future = (tb_future_t*)self;
+    tb_assert_and_check_return_val(future, TB_STATE_KILLED);
+
+    // get state
+    return (tb_size_t)tb_atomic32_get(&future->state);
+}
+tb_cpointer_t tb_future_get(tb_future_ref_t self)
+{
+    // check
+    tb_future_t* future = (tb_future_t*)self;
+    tb_assert_and_check_return_val(future, tb_null);
+
+    // get value
+    return tb_atomic32_get(&future->state) == TB_STATE_FINISHED? future->value : tb_null;
+}
+tb_long_t tb_future_wait(tb_future_ref_t self, tb_long_t timeout)
+{
+    // check
+    tb_future_t* future = (tb_future_t*)self;
+    tb_assert_and_check_return_val(future, -1);
+
+    // wait it
+    tb_long_t   ok = -1;
+    tb_hong_t   deadline = timeout >= 0? tb_mclock() + timeout : -1;
+    tb_spinlock_enter(&future->lock);
+    while (1)
+    {
+        // finished?
+        tb_size_t state = (tb_size_t)tb_atomic32_get(&future->state);
+        if (state != TB_STATE_WAITING)
+        {
+            ok = state == TB_STATE_FINISHED? 1 : -1;
+            break;
+        }
+
+        // timeout?
+        tb_long_t left = -1;
+        if (deadline >= 0)
+        {
+            left = (tb_long_t)(deadline - tb_mclock());
+            if (left <= 0)
+            {
+                ok = 0;
+                break;
+            }
+        }
+
+        // init semaphore
+        if (!future->semaphore) future->semaphore = tb_semaphore_init(0);
+        tb_assert_and_check_break(future->semaphore);
+
+        // wait semaphore
+        future->waiters++;
+        tb_spinlock_leave(&future->lock);
+        tb_long_t wait = tb_semaphore_wait(future->semaphore, left);
+        tb_spinlock_enter(&future->lock);
+
+        // we are not notified yet? remove this waiter
+        if (tb_atomic32_get(&future->state) == TB_STATE_WAITING) future->waiters--;
+        tb_assert_and_check_break(wait >= 0);
+    }
+    tb_spinlock_leave(&future->lock);
+    return ok;
+}
+tb_future_ref_t tb_future_then(tb_future_ref_t self, tb_future_then_func_t func, tb_cpointer_t priv)
+{
+    // check
+    tb_future_t* future = (tb_future_t*)self;
+    tb_assert_and_check_return_val(future && func, tb_null);
+
+    // init the target future
+    tb_future_t* target = (tb_future_t*)tb_future_init(future->pool);
+    tb_assert_and_check_return_val(target, tb_null);
+
+    // make node
+    tb_future_node_t* node = tb_future_node_init(TB_FUTURE_NODE_TYPE_THEN, target);
+    if (node)
+    {
+        // attach it
+        node->then  = func;
+        node->priv  = priv;
+        tb_future_node_attach(future, node);
+    }
+    else tb_future_done(target, TB_STATE_KILLED, tb_null);
+    return (tb_future_ref_t)target;
+}
+tb_future_ref_t tb_future_when_all(tb_future_ref_t const* futures, tb_size_t count)
+{
+    return tb_future_when(TB_FUTURE_NODE_TYPE_ALL, futures, count);
+}
+tb_future_ref_t tb_future_when_any(tb_future_ref_t const* futures, tb_size_t count)
+{
+    return tb_future_when(TB_FUTURE_NODE_TYPE_ANY, futures, count);
+}
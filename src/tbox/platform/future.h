@@ -0,0 +1,169 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        future.h
+ * @ingroup     platform
+ *
+ */
+#ifndef TB_PLATFORM_FUTURE_H
+#define TB_PLATFORM_FUTURE_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+#include "thread_pool.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+/// the future ref type
+typedef __tb_typeref__(future);
+
+/// the future async func type, returns the future value
+typedef tb_cpointer_t               (*tb_future_async_func_t)(tb_thread_pool_worker_ref_t worker, tb_cpointer_t priv);
+
+/// the future then func type, returns the value of the continued future
+typedef tb_cpointer_t               (*tb_future_then_func_t)(tb_thread_pool_worker_ref_t worker, tb_future_ref_t future, tb_cpointer_t priv);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/*! init an unfinished future (promise), it will be finished by tb_future_set() or tb_future_cancel()
+ *
+ * @param pool              the thread pool for running the continuations, using the default pool if be null
+ *
+ * @return                  the future
+ */
+tb_future_ref_t             tb_future_init(tb_thread_pool_ref_t pool);
+
+/*! exit the future reference
+ *
+ * the future is reference counted, it will be freed after it has been finished and
+ * all continuations referring to it have been done.
+ *
+ * the attached continuations do not refer to it, so it will be canceled
+ * if the last reference is released before it is finished, e.g. an unfinished promise.
+ *
+ * @param future            the future
+ */
+tb_void_t                   tb_future_exit(tb_future_ref_t future);
+
+/*! run the given func in the thread pool and get its value from the returned future
+ *
+ * @param pool              the thread pool, using the default pool if be null
+ * @param func              the async func
+ * @param priv              the private data
+ *
+ * @return                  the future, need call tb_future_exit() to release it
+ */
+tb_future_ref_t             tb_future_async(tb_thread_pool_ref_t pool, tb_future_async_func_t func, tb_cpointer_t priv);
+
+/*! finish the future with the given value and run all continuations
+ *
+ * @param future            the future
+ * @param value             the future value
+ *
+ * @return                  tb_true or tb_false if it has been finished
+ */
+tb_bool_t                   tb_future_set(tb_future_ref_t future, tb_cpointer_t value);
+
+/*! cancel the future, all continuations will be canceled too
+ *
+ * @param future            the future
+ *
+ * @return                  tb_true or tb_false if it has been finished
+ */
+tb_bool_t                   tb_future_cancel(tb_future_ref_t future);
+
+/*! the future state
+ *
+ * @param future            the future
+ *
+ * @return                  TB_STATE_WAITING, TB_STATE_FINISHED or TB_STATE_KILLED
+ */
+tb_size_t                   tb_future_state(tb_future_ref_t future);
+
+/*! get the future value
+ *
+ * @param future            the future
+ *
+ * @return                  the future value, tb_null if it has been not finished
+ */
+tb_cpointer_t               tb_future_get(tb_future_ref_t future);
+
+/*! wait the future
+ *
+ * it will block the current thread, so we should use tb_future_then() instead of it in the worker
+ *
+ * @param future            the future
+ * @param timeout           the timeout
+ *
+ * @return                  ok: 1, timeout: 0, canceled or error: -1
+ */
+tb_long_t                   tb_future_wait(tb_future_ref_t future, tb_long_t timeout);
+
+/*! run the given func after the future has been finished
+ *
+ * the continuation will be posted to the local deque of the worker which finishes the future,
+ * so it will usually be run on the same worker next to keep caches hot.
+ * and it will not be run and the returned future will be canceled if this future is canceled.
+ *
+ * @param future            the future
+ * @param func              the then func
+ * @param priv              the private data
+ *
+ * @return                  the future of the func value, need call tb_future_exit() to release it
+ */
+tb_future_ref_t             tb_future_then(tb_future_ref_t future, tb_future_then_func_t func, tb_cpointer_t priv);
+
+/*! get a future which will be finished after all given futures have been finished
+ *
+ * the returned future will be canceled if any one of the given futures is canceled
+ *
+ * @param futures           the futures
+ * @param count             the futures count
+ *
+ * @return                  the future, need call tb_future_exit() to release it
+ */
+tb_future_ref_t             tb_future_when_all(tb_future_ref_t const* futures, tb_size_t count);
+
+/*! get a future which will be finished after any one of the given futures has been finished
+ *
+ * the value of the returned future is the index of the first finished future,
+ * and it will be canceled only if all given futures are canceled
+ *
+ * @param futures           the futures
+ * @param count             the futures count
+ *
+ * @return                  the future, need call tb_future_exit() to release it
+ */
+tb_future_ref_t             tb_future_when_any(tb_future_ref_t const* futures, tb_size_t count);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
@@ -0,0 +1,829 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        htimer.c
+ * @ingroup     platform
+ *
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * trace
+ */
+#define TB_TRACE_MODULE_NAME                "htimer"
+#define TB_TRACE_MODULE_DEBUG               (0)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "platform.h"
+#include "../libc/libc.h"
+#include "../utils/bits.h"
+#include "../memory/memory.h"
+#include "../container/list_entry.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the root wheel bits
+#define TB_HTIMER_ROOT_BITS                 (8)
+
+// the root wheel size
+#define TB_HTIMER_ROOT_SIZE                 (1 << TB_HTIMER_ROOT_BITS)
+
+// the root wheel mask
+#define TB_HTIMER_ROOT_MASK                 (TB_HTIMER_ROOT_SIZE - 1)
+
+// the level wheel bits
+#define TB_HTIMER_LEVEL_BITS                (6)
+
+// the level wheel size
+#define TB_HTIMER_LEVEL_SIZE                (1 << TB_HTIMER_LEVEL_BITS)
+
+// the level wheel mask
+#define TB_HTIMER_LEVEL_MASK                (TB_HTIMER_LEVEL_SIZE - 1)
+
+// the level wheels count
+#define TB_HTIMER_LEVEL_MAXN                (4)
+
+// the maximum ticks of all wheels, the farther tasks will be cascaded again
+#define TB_HTIMER_TICKS_MAXN                ((tb_hong_t)1 << (TB_HTIMER_ROOT_BITS + TB_HTIMER_LEVEL_BITS * TB_HTIMER_LEVEL_MAXN))
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the timer task type
+typedef struct __tb_htimer_task_t
+{
+    // the list entry of the wheel slot or the expired list, it is not linked if entry.next is null
+    tb_list_entry_t             entry;
+
+    // the func
+    tb_htimer_task_func_t       func;
+
+    // the priv
+    tb_cpointer_t               priv;
+
+    // the when
+    tb_hong_t                   when;
+
+    // the expired ticks
+    tb_hong_t                   expires;
+
+    // the period
+    tb_uint32_t                 period  : 28;
+
+    // is repeat?
+    tb_uint32_t                 repeat  : 1;
+
+    // is killed?
+    tb_uint32_t                 killed  : 1;
+
+    // the refn, <= 2
+    tb_uint32_t                 refn    : 2;
+
+}tb_htimer_task_t;
+
+/*! the hierarchical timing wheel type
+ *
+ * <pre>
+ *
+ * root:   |-----|-----|-----|-----|-- ... --|     256 ticks, one slot per tick
+ *                  |
+ *                 jiffies
+ *
+ * level0: |-----|-----|-- ... --|                 64 slots, 256 ticks per slot
+ * level1: |-----|-----|-- ... --|                 64 slots, 256 * 64 ticks per slot
+ * level2: |-----|-----|-- ... --|                 64 slots, 256 * 64^2 ticks per slot
+ * level3: |-----|-----|-- ... --|                 64 slots, 256 * 64^3 ticks per slot
+ *
+ * the tasks in the higher level slot will be cascaded to the lower levels
+ * when the root wheel is wrapped around, and the task lists are doubly-linked,
+ * so the insertion and cancellation are O(1).
+ *
+ * </pre>
+ */
+typedef struct __tb_htimer_t
+{
+    // the grow
+    tb_uint16_t                 grow;
+
+    // is stoped?
+    tb_atomic_flag_t            stop;
+
+    // is worked?
+    tb_atomic32_t               work;
+
+    // cache time?
+    tb_bool_t                   ctime;
+
+    // the tick
+    tb_size_t                   tick;
+
+    // the base time of the ticks
+    tb_hong_t                   btime;
+
+    // the current ticks, all slots before it have been expired
+    tb_hong_t                   jiffies;
+
+    // the tasks count in the wheels and the expired list
+    tb_size_t                   count;
+
+    // the wakeup time of the loop, we need post event if the new task is earlier than it
+    tb_hong_t                   wake;
+
+    // the lock
+    tb_spinlock_t               lock;
+
+    // the pool
+    tb_fixed_pool_ref_t         pool;
+
+    // the event for tb_htimer_loop()
+    tb_event_ref_t              event;
+
+    // the expired tasks
+    tb_list_entry_t             expired;
+
+    // the root wheel
+    tb_list_entry_t             root[TB_HTIMER_ROOT_SIZE];
+
+    // the non-empty root slots bitmap, it may be not cleared after the task has been canceled
+    tb_uint32_t                 bitmap[TB_HTIMER_ROOT_SIZE >> 5];
+
+    // the level wheels
+    tb_list_entry_t             levels[TB_HTIMER_LEVEL_MAXN][TB_HTIMER_LEVEL_SIZE];
+
+}tb_htimer_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static __tb_inline__ tb_hong_t tb_htimer_now(tb_htimer_t* timer)
+{
+    // using the real time?
+    if (!timer->ctime)
+    {
+        // get the time
+        tb_timeval_t tv = {0};
+        if (tb_gettimeofday(&tv, tb_null)) return ((tb_hong_t)tv.tv_sec * 1000 + tv.tv_usec / 1000);
+    }
+
+    // using cached time
+    return tb_cache_time_mclock();
+}
+static __tb_inline__ tb_hong_t tb_htimer_ticks(tb_htimer_t* timer, tb_hong_t when, tb_bool_t round_up)
+{
+    // the ticks of the given time
+    tb_hong_t diff = when - timer->btime;
+    return diff > 0? (round_up? (diff + timer->tick - 1) : diff) / (tb_hong_t)timer->tick : 0;
+}
+static __tb_inline__ tb_void_t tb_htimer_slot_init(tb_list_entry_t* slot)
+{
+    slot->next = slot;
+    slot->prev = slot;
+}
+static __tb_inline__ tb_bool_t tb_htimer_slot_empty(tb_list_entry_t* slot)
+{
+    return slot->next == slot;
+}
+static __tb_inline__ tb_void_t tb_htimer_slot_insert(tb_list_entry_t* slot, tb_htimer_task_t* timer_task)
+{
+    tb_list_entry_t* entry = &timer_task->entry;
+    entry->next         = slot;
+    entry->prev         = slot->prev;
+    slot->prev->next    = entry;
+    slot->prev          = entry;
+}
+static __tb_inline__ tb_void_t tb_htimer_slot_remove(tb_htimer_task_t* timer_task)
+{
+    tb_list_entry_t* entry = &timer_task->entry;
+    entry->prev->next   = entry->next;
+    entry->next->prev   = entry->prev;
+    entry->next         = tb_null;
+    entry->prev         = tb_null;
+}
+static __tb_inline__ tb_void_t tb_htimer_slot_splice(tb_list_entry_t* slot, tb_list_entry_t* spliced)
+{
+    // empty?
+    tb_check_return(!tb_htimer_slot_empty(spliced));
+
+    // append all tasks of the spliced slot to the tail of the given slot
+    spliced->next->prev = slot->prev;
+    slot->prev->next    = spliced->next;
+    spliced->prev->next = slot;
+    slot->prev          = spliced->prev;
+    tb_htimer_slot_init(spliced);
+}
+static tb_size_t tb_htimer_root_next(tb_htimer_t* timer, tb_size_t index)
+{
+    // find the first non-empty slot from the given index
+    while (index < TB_HTIMER_ROOT_SIZE)
+    {
+        // the bits of this word from the given index
+        tb_size_t   word = index >> 5;
+        tb_uint32_t bits = timer->bitmap[word] & ~(((tb_uint32_t)1 << (index & 31)) - 1);
+        if (bits)
+        {
+            // found? we need check it again, because the canceled tasks do not clear the bitmap
+            index = (word << 5) + tb_bits_fb1_u32_le(bits);
+            if (!tb_htimer_slot_empty(&timer->root[index])) return index;
+
+            // clear this empty slot and find the next slot
+            timer->bitmap[word] &= ~((tb_uint32_t)1 << (index & 31));
+            index++;
+        }
+        else index = (word + 1) << 5;
+    }
+    return TB_HTIMER_ROOT_SIZE;
+}
+static tb_void_t tb_htimer_add_task(tb_htimer_t* timer, tb_htimer_task_t* timer_task)
+{
+    // check
+    tb_assert(timer && timer_task && !timer_task->entry.next);
+
+    // the expired ticks and the ticks difference
+    tb_hong_t expires = timer_task->expires;
+    tb_hong_t tdiff = expires - timer->jiffies;
+
+    // trace
+    tb_trace_d("add: when: %lld, expires: %lld, jiffies: %lld", timer_task->when, expires, timer->jiffies);
+
+    // add it to the root wheel if it will be expired soon
+    tb_list_entry_t* slot = tb_null;
+    if (tdiff < TB_HTIMER_ROOT_SIZE)
+    {
+        // it has been expired? add it to the current slot
+        tb_size_t index = (tb_size_t)((tdiff < 0? timer->jiffies : expires) & TB_HTIMER_ROOT_MASK);
+        timer->bitmap[index >> 5] |= ((tb_uint32_t)1 << (index & 31));
+        slot = &timer->root[index];
+    }
+    else
+    {
+        // it is too far? add it to the farthest slot first and it will be cascaded again
+        if (tdiff >= TB_HTIMER_TICKS_MAXN)
+        {
+            tdiff = TB_HTIMER_TICKS_MAXN - 1;
+            expires = timer->jiffies + tdiff;
+        }
+
+        // add it to the level wheel
+        tb_size_t level = 0;
+        tb_size_t shift = TB_HTIMER_ROOT_BITS;
+        while (level < TB_HTIMER_LEVEL_MAXN - 1 && tdiff >= ((tb_hong_t)1 << (shift + TB_HTIMER_LEVEL_BITS)))
+        {
+            level++;
+            shift += TB_HTIMER_LEVEL_BITS;
+        }
+        slot = &timer->levels[level][(expires >> shift) & TB_HTIMER_LEVEL_MASK];
+    }
+
+    // add task to the slot
+    tb_htimer_slot_insert(slot, timer_task);
+    timer->count++;
+}
+static tb_void_t tb_htimer_del_task(tb_htimer_t* timer, tb_htimer_task_t* timer_task)
+{
+    // check
+    tb_assert(timer && timer->count && timer_task && timer_task->entry.next);
+
+    // remove it from the wheel slot or the expired list
+    tb_htimer_slot_remove(timer_task);
+    timer->count--;
+}
+static tb_void_t tb_htimer_cascade(tb_htimer_t* timer, tb_list_entry_t* slot)
+{
+    // detach all tasks of this slot first, because we may re-add some tasks into this slot again
+    tb_list_entry_t list;
+    tb_htimer_slot_init(&list);
+    tb_htimer_slot_splice(&list, slot);
+
+    // re-add them to the lower wheels
+    while (!tb_htimer_slot_empty(&list))
+    {
+        tb_htimer_task_t* timer_task = (tb_htimer_task_t*)list.next;
+        tb_htimer_slot_remove(timer_task);
+        timer->count--;
+        tb_htimer_add_task(timer, timer_task);
+    }
+}
+static tb_void_t tb_htimer_expire(tb_htimer_t* timer, tb_hong_t ticks)
+{
+    // no tasks? move to the given ticks directly
+    if (!timer->count)
+    {
+        if (timer->jiffies <= ticks) timer->jiffies = ticks + 1;
+        return ;
+    }
+
+    // move all expired slots to the expired list
+    while (timer->jiffies <= ticks)
+    {
+        // cascade the level wheels if the root wheel is wrapped around
+        tb_size_t index = (tb_size_t)(timer->jiffies & TB_HTIMER_ROOT_MASK);
+        if (!index)
+        {
+            tb_size_t level = 0;
+            tb_size_t shift = TB_HTIMER_ROOT_BITS;
+            for (level = 0; level < TB_HTIMER_LEVEL_MAXN; level++, shift += TB_HTIMER_LEVEL_BITS)
+            {
+                tb_size_t slot = (tb_size_t)((timer->jiffies >> shift) & TB_HTIMER_LEVEL_MASK);
+                tb_htimer_cascade(timer, &timer->levels[level][slot]);
+                if (slot) break;
+            }
+        }
+
+        // find the next non-empty slot in the root wheel
+        tb_size_t next = tb_htimer_root_next(timer, index);
+        if (next == index)
+        {
+            // move this slot to the expired list
+            tb_htimer_slot_splice(&timer->expired, &timer->root[index]);
+            timer->bitmap[index >> 5] &= ~((tb_uint32_t)1 << (index & 31));
+            timer->jiffies++;
+        }
+        // skip all empty slots
+        else timer->jiffies = tb_min(timer->jiffies - index + next, ticks + 1);
+    }
+}
+
+static tb_htimer_task_t* tb_htimer_task_make(tb_htimer_t* timer, tb_hize_t when, tb_size_t period, tb_bool_t repeat, tb_htimer_task_func_t func, tb_cpointer_t priv, tb_size_t refn)
+{
+    // check
+    tb_assert_and_check_return_val(timer && timer->pool && func, tb_null);
+
+    // stoped?
+    tb_assert_and_check_return_val(!tb_atomic_flag_test_explicit(&timer->stop, TB_ATOMIC_RELAXED), tb_null);
+
+    // enter
+    tb_spinlock_enter(&timer->lock);
+
+    // make task
+    tb_event_ref_t      event = tb_null;
+    tb_htimer_task_t*   timer_task = (tb_htimer_task_t*)tb_fixed_pool_malloc0(timer->pool);
+    if (timer_task)
+    {
+        // no tasks? move the current ticks to now
+        if (!timer->count) tb_htimer_expire(timer, tb_htimer_ticks(timer, tb_htimer_now(timer), tb_false));
+
+        // init task
+        timer_task->refn      = refn;
+        timer_task->func      = func;
+        timer_task->priv      = priv;
+        timer_task->when      = when;
+        timer_task->expires   = tb_htimer_ticks(timer, when, tb_true);
+        timer_task->period    = period;
+        timer_task->repeat    = repeat? 1 : 0;
+
+        // add task
+        tb_htimer_add_task(timer, timer_task);
+
+        // need wake up the loop?
+        if ((tb_hong_t)when < timer->wake) event = timer->event;
+    }
+
+    // leave
+    tb_spinlock_leave(&timer->lock);
+
+    // post event if the new task is earlier than the wakeup time
+    if (event) tb_event_post(event);
+
+    // ok?
+    return timer_task;
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+tb_htimer_ref_t tb_htimer_init(tb_size_t grow, tb_size_t tick, tb_bool_t ctime)
+{
+    // check
+    tb_assert_and_check_return_val(tick, tb_null);
+
+    // done
+    tb_bool_t       ok = tb_false;
+    tb_htimer_t*    timer = tb_null;
+    do
+    {
+        // make timer
+        timer = tb_malloc0_type(tb_htimer_t);
+        tb_assert_and_check_break(timer);
+
+        // init timer
+        timer->grow     = (tb_uint16_t)tb_max(grow, 16);
+        timer->ctime    = ctime;
+        timer->tick     = tick;
+        timer->btime    = tb_htimer_now(timer);
+        timer->jiffies  = 0;
+        timer->count    = 0;
+        timer->wake     = 0;
+        tb_atomic_flag_clear_explicit(&timer->stop, TB_ATOMIC_RELAXED);
+        tb_atomic32_init(&timer->work, 0);
+
+        // init wheels
+        tb_size_t i = 0;
+        tb_size_t j = 0;
+        tb_htimer_slot_init(&timer->expired);
+        for (i = 0; i < TB_HTIMER_ROOT_SIZE; i++)
+            tb_htimer_slot_init(&timer->root[i]);
+        for (i = 0; i < TB_HTIMER_LEVEL_MAXN; i++)
+        {
+            for (j = 0; j < TB_HTIMER_LEVEL_SIZE; j++)
+                tb_htimer_slot_init(&timer->levels[i][j]);
+        }
+
+        // init lock
+        if (!tb_spinlock_init(&timer->lock)) break;
+
+        // init pool
+        timer->pool = tb_fixed_pool_init(tb_null, timer->grow, sizeof(tb_htimer_task_t), tb_null, tb_null, tb_null);
+        tb_assert_and_check_break(timer->pool);
+
+        // register lock profiler
+#ifdef TB_LOCK_PROFILER_ENABLE
+        tb_lock_profiler_register(tb_lock_profiler(), (tb_pointer_t)&timer->lock, TB_TRACE_MODULE_NAME);
+#endif
+
+        // ok
+        ok = tb_true;
+
+    } while (0);
+
+    // failed?
+    if (!ok)
+    {
+        // exit it
+        if (timer) tb_htimer_exit((tb_htimer_ref_t)timer);
+        timer = tb_null;
+    }
+
+    // ok?
+    return (tb_htimer_ref_t)timer;
+}
+tb_void_t tb_htimer_exit(tb_htimer_ref_t self)
+{
+    // check
+    tb_htimer_t* timer = (tb_htimer_t*)self;
+    tb_assert_and_check_return(timer);
+
+    // kill it first
+    tb_htimer_kill(self);
+
+    // wait loop exit
+    tb_size_t tryn = 10;
+    while (tb_atomic32_get_explicit(&timer->work, TB_ATOMIC_RELAXED) && tryn--) tb_msleep(500);
+
+    // warning
+    if (!tryn && tb_atomic32_get_explicit(&timer->work, TB_ATOMIC_RELAXED))
+    {
+        tb_trace_w("[htimer]: the loop has been not exited now!");
+    }
+
+    // enter
+    tb_spinlock_enter(&timer->lock);
+
+    // exit pool
+    if (timer->pool) tb_fixed_pool_exit(timer->pool);
+    timer->pool = tb_null;
+
+    // exit event
+    if (timer->event) tb_event_exit(timer->event);
+    timer->event = tb_null;
+
+    // leave
+    tb_spinlock_leave(&timer->lock);
+
+    // exit lock
+    tb_spinlock_exit(&timer->lock);
+
+    // exit it
+    tb_free(timer);
+}
+tb_void_t tb_htimer_kill(tb_htimer_ref_t self)
+{
+    // check
+    tb_htimer_t* timer = (tb_htimer_t*)self;
+    tb_assert_and_check_return(timer);
+
+    // stop it
+    if (!tb_atomic_flag_test_and_set_explicit(&timer->stop, TB_ATOMIC_RELAXED))
+    {
+        // get event
+        tb_spinlock_enter(&timer->lock);
+        tb_event_ref_t event = timer->event;
+        tb_spinlock_leave(&timer->lock);
+
+        // post event
+        if (event) tb_event_post(event);
+    }
+}
+tb_void_t tb_htimer_clear(tb_htimer_ref_t self)
+{
+    tb_htimer_t* timer = (tb_htimer_t*)self;
+    if (timer)
+    {
+        // enter
+        tb_spinlock_enter(&timer->lock);
+
+        // clear wheels
+        tb_size_t i = 0;
+        tb_size_t j = 0;
+        tb_htimer_slot_init(&timer->expired);
+        for (i = 0; i < TB_HTIMER_ROOT_SIZE; i++)
+            tb_htimer_slot_init(&timer->root[i]);
+        for (i = 0; i < TB_HTIMER_LEVEL_MAXN; i++)
+        {
+            for (j = 0; j < TB_HTIMER_LEVEL_SIZE; j++)
+                tb_htimer_slot_init(&timer->levels[i][j]);
+        }
+        tb_memset(timer->bitmap, 0, sizeof(timer->bitmap));
+        timer->count = 0;
+
+        // clear pool
+        if (timer->pool) tb_fixed_pool_clear(timer->pool);
+
+        // leave
+        tb_spinlock_leave(&timer->lock);
+    }
+}
+tb_size_t tb_htimer_delay(tb_htimer_ref_t self)
+{
+    // check
+    tb_htimer_t* timer = (tb_htimer_t*)self;
+    tb_assert_and_check_return_val(timer, -1);
+
+    // stoped?
+    tb_assert_and_check_return_val(!tb_atomic_flag_test_explicit(&timer->stop, TB_ATOMIC_RELAXED), -1);
+
+    // enter
+    tb_spinlock_enter(&timer->lock);
+
+    // done
+    tb_size_t delay = -1;
+    if (timer->count)
+    {
+        // exists expired tasks?
+        if (!tb_htimer_slot_empty(&timer->expired)) delay = 0;
+        else
+        {
+            /* get the ticks of the next non-empty root slot,
+             * or the next cascading ticks if all tasks are in the level wheels
+             */
+            tb_size_t index = (tb_size_t)(timer->jiffies & TB_HTIMER_ROOT_MASK);
+            tb_hong_t ticks = timer->jiffies - index + tb_htimer_root_next(timer, index);
+
+            // compute the delay
+            tb_hong_t when = timer->btime + ticks * timer->tick;
+            tb_hong_t now = tb_htimer_now(timer);
+            delay = when > now? (tb_size_t)(when - now) : 0;
+        }
+    }
+
+    // leave
+    tb_spinlock_leave(&timer->lock);
+
+    // ok?
+    return delay;
+}
+tb_bool_t tb_htimer_spak(tb_htimer_ref_t self)
+{
+    // check
+    tb_htimer_t* timer = (tb_htimer_t*)self;
+    tb_assert_and_check_return_val(timer && timer->pool, tb_false);
+
+    // stoped?
+    tb_check_return_val(!tb_atomic_flag_test_explicit(&timer->stop, TB_ATOMIC_RELAXED), tb_false);
+
+    // the now time
+    tb_hong_t now = tb_htimer_now(timer);
+
+    // enter
+    tb_spinlock_enter(&timer->lock);
+
+    // move all expired tasks to the expired list
+    tb_htimer_expire(timer, tb_htimer_ticks(timer, now, tb_false));
+
+    // done all expired tasks
+    while (!tb_htimer_slot_empty(&timer->expired))
+    {
+        // pop the expired task
+        tb_htimer_task_t* timer_task = (tb_htimer_task_t*)timer->expired.next;
+        tb_htimer_del_task(timer, timer_task);
+
+        // the task func
+        tb_htimer_task_func_t   func = timer_task->func;
+        tb_cpointer_t           priv = timer_task->priv;
+        tb_bool_t               killed = timer_task->killed? tb_true : tb_false;
+
+        // leave
+        tb_spinlock_leave(&timer->lock);
+
+        // trace
+        tb_trace_d("done: expired: when: %lld, period: %u, refn: %u, killed: %u", timer_task->when, timer_task->period, timer_task->refn, killed);
+
+        // done func, the task may be exited in it
+        if (func) func(killed, priv);
+
+        // enter
+        tb_spinlock_enter(&timer->lock);
+
+        // repeat?
+        if (timer_task->repeat)
+        {
+            // continue the task
+            timer_task->when    = now + timer_task->period;
+            timer_task->expires = tb_htimer_ticks(timer, timer_task->when, tb_true);
+            tb_htimer_add_task(timer, timer_task);
+        }
+        else
+        {
+            // refn--
+            if (timer_task->refn > 1) timer_task->refn--;
+            // remove it from pool directly
+            else tb_fixed_pool_free(timer->pool, timer_task);
+        }
+    }
+
+    // leave
+    tb_spinlock_leave(&timer->lock);
+
+    // ok
+    return tb_true;
+}
+tb_void_t tb_htimer_loop(tb_htimer_ref_t self)
+{
+    // check
+    tb_htimer_t* timer = (tb_htimer_t*)self;
+    tb_assert_and_check_return(timer);
+
+    // work++
+    tb_atomic32_fetch_and_add_explicit(&timer->work, 1, TB_ATOMIC_RELAXED);
+
+    // init event
+    tb_spinlock_enter(&timer->lock);
+    if (!timer->event) timer->event = tb_event_init();
+    tb_spinlock_leave(&timer->lock);
+
+    // loop
+    while (!tb_atomic_flag_test_explicit(&timer->stop, TB_ATOMIC_RELAXED))
+    {
+        // the delay
+        tb_size_t delay = tb_htimer_delay(self);
+        if (delay)
+        {
+            // get the event and save the wakeup time
+            tb_spinlock_enter(&timer->lock);
+            tb_event_ref_t event = timer->event;
+            timer->wake = delay != (tb_size_t)-1? tb_htimer_now(timer) + delay : TB_MAXS64;
+            tb_spinlock_leave(&timer->lock);
+            tb_check_break(event);
+
+            // wait some time
+            tb_long_t wait = tb_event_wait(event, delay);
+
+            // clear the wakeup time
+            tb_spinlock_enter(&timer->lock);
+            timer->wake = 0;
+            tb_spinlock_leave(&timer->lock);
+            tb_check_break(wait >= 0);
+        }
+
+        // spak ctime
+        if (timer->ctime) tb_cache_time_spak();
+
+        // spak it
+        if (!tb_htimer_spak(self)) break;
+    }
+
+    // work--
+    tb_atomic32_fetch_and_sub_explicit(&timer->work, 1, TB_ATOMIC_RELAXED);
+}
+tb_htimer_task_ref_t tb_htimer_task_init(tb_htimer_ref_t self, tb_size_t delay, tb_bool_t repeat, tb_htimer_task_func_t func, tb_cpointer_t priv)
+{
+    // check
+    tb_htimer_t* timer = (tb_htimer_t*)self;
+    tb_assert_and_check_return_val(timer && func, tb_null);
+
+    // add task
+    return tb_htimer_task_init_at(self, tb_htimer_now(timer) + delay, delay, repeat, func, priv);
+}
+tb_htimer_task_ref_t tb_htimer_task_init_at(tb_htimer_ref_t self, tb_hize_t when, tb_size_t period, tb_bool_t repeat, tb_htimer_task_func_t func, tb_cpointer_t priv)
+{
+    // make task, it need be removed manually
+    return (tb_htimer_task_ref_t)tb_htimer_task_make((tb_htimer_t*)self, when, period, repeat, func, priv, 2);
+}
+tb_htimer_task_ref_t tb_htimer_task_init_after(tb_htimer_ref_t self, tb_hize_t after, tb_size_t period, tb_bool_t repeat, tb_htimer_task_func_t func, tb_cpointer_t priv)
+{
+    // check
+    tb_htimer_t* timer = (tb_htimer_t*)self;
+    tb_assert_and_check_return_val(timer && func, tb_null);
+
+    // add task
+    return tb_htimer_task_init_at(self, tb_htimer_now(timer) + after, period, repeat, func, priv);
+}
+tb_void_t tb_htimer_task_post(tb_htimer_ref_t self, tb_size_t delay, tb_bool_t repeat, tb_htimer_task_func_t func, tb_cpointer_t priv)
+{
+    // check
+    tb_htimer_t* timer = (tb_htimer_t*)self;
+    tb_assert_and_check_return(timer && func);
+
+    // run task
+    tb_htimer_task_post_at(self, tb_htimer_now(timer) + delay, delay, repeat, func, priv);
+}
+tb_void_t tb_htimer_task_post_at(tb_htimer_ref_t self, tb_hize_t when, tb_size_t period, tb_bool_t repeat, tb_htimer_task_func_t func, tb_cpointer_t priv)
+{
+    // make task, it will be auto-removed after be expired
+    tb_htimer_task_make((tb_htimer_t*)self, when, period, repeat, func, priv, 1);
+}
+tb_void_t tb_htimer_task_post_after(tb_htimer_ref_t self, tb_hize_t after, tb_size_t period, tb_bool_t repeat, tb_htimer_task_func_t func, tb_cpointer_t priv)
+{
+    // check
+    tb_htimer_t* timer = (tb_htimer_t*)self;
+    tb_assert_and_check_return(timer && func);
+
+    // run task
+    tb_htimer_task_post_at(self, tb_htimer_now(timer) + after, period, repeat, func, priv);
+}
+tb_void_t tb_htimer_task_exit(tb_htimer_ref_t self, tb_htimer_task_ref_t task)
+{
+    // check
+    tb_htimer_t*        timer = (tb_htimer_t*)self;
+    tb_htimer_task_t*   timer_task = (tb_htimer_task_t*)task;
+    tb_assert_and_check_return(timer && timer->pool && timer_task);
+
+    // trace
+    tb_trace_d("exit: when: %lld, period: %u, refn: %u", timer_task->when, timer_task->period, timer_task->refn);
+
+    // enter
+    tb_spinlock_enter(&timer->lock);
+
+    // it is still in the wheels or the expired list? remove it directly
+    if (timer_task->entry.next)
+    {
+        tb_htimer_del_task(timer, timer_task);
+        tb_fixed_pool_free(timer->pool, timer_task);
+    }
+    // it is being done now? cancel it and it will be freed after calling func
+    else if (timer_task->refn > 1)
+    {
+        // refn--
+        timer_task->refn--;
+
+        // cancel task
+        timer_task->func      = tb_null;
+        timer_task->priv      = tb_null;
+        timer_task->repeat    = 0;
+    }
+    // remove it from pool directly if the task have been expired
+    else tb_fixed_pool_free(timer->pool, timer_task);
+
+    // leave
+    tb_spinlock_leave(&timer->lock);
+}
+tb_void_t tb_htimer_task_kill(tb_htimer_ref_t self, tb_htimer_task_ref_t task)
+{
+    // check
+    tb_htimer_t*        timer = (tb_htimer_t*)self;
+    tb_htimer_task_t*   timer_task = (tb_htimer_task_t*)task;
+    tb_assert_and_check_return(timer && timer->pool && timer_task);
+
+    // trace
+    tb_trace_d("kill: when: %lld, period: %u, refn: %u", timer_task->when, timer_task->period, timer_task->refn);
+
+    // enter
+    tb_spinlock_enter(&timer->lock);
+
+    // it is still waiting? expire it now
+    if (timer_task->entry.next)
+    {
+        // del the task first
+        tb_htimer_del_task(timer, timer_task);
+
+        // killed
+        timer_task->killed = 1;
+
+        // no repeat
+        timer_task->repeat = 0;
+
+        // re-add it to the expired list
+        tb_htimer_slot_insert(&timer->expired, timer_task);
+        timer->count++;
+    }
+
+    // leave
+    tb_spinlock_leave(&timer->lock);
+}
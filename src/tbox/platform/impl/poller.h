@@ -60,6 +60,12 @@ typedef struct __tb_poller_t
     // the supported events
     tb_uint16_t              supported_events;
 
+    // the busy-polling time (us), 0: disable
+    tb_size_t                busypoll;
+
+    // the batch events function of the current tb_poller_wait_batch()
+    tb_poller_events_func_t  batch_func;
+
 #ifndef TB_CONFIG_MICRO_ENABLE
     // the process poller
     tb_poller_process_ref_t  process_poller;
@@ -96,6 +102,16 @@ typedef struct __tb_poller_t
      */
     tb_long_t                (*wait)(struct __tb_poller_t* poller, tb_poller_event_func_t func, tb_long_t timeout);
 
+    /* wait events for all objects and pass them at once, optional
+     *
+     * @param poller         the poller
+     * @param func           the batch events function
+     * @param timeout        the timeout, infinity: -1
+     *
+     * @return               > 0: the events number, 0: timeout, -1: failed
+     */
+    tb_long_t                (*wait_batch)(struct __tb_poller_t* poller, tb_poller_events_func_t func, tb_long_t timeout);
+
     /* insert socket to poller
      *
      * @param poller         the poller
@@ -0,0 +1,126 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        event.c
+ * @ingroup     platform
+ *
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+#include "../futex.h"
+#include "../time.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the futex event type
+typedef struct __tb_event_futex_t
+{
+    // is signaled? the waiters wait on it if it is zero
+    tb_atomic32_t       signal;
+
+    // the waiters count, we need not wake up them if no one is waiting
+    tb_atomic32_t       waiters;
+
+}tb_event_futex_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static __tb_inline__ tb_bool_t tb_event_futex_take(tb_event_futex_t* event)
+{
+    // reset the signal automatically
+    tb_int32_t signal = 1;
+    return tb_atomic32_get(&event->signal)
+        && tb_atomic32_compare_and_swap_explicit(&event->signal, &signal, 0, TB_ATOMIC_ACQUIRE, TB_ATOMIC_RELAXED);
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+tb_event_ref_t tb_event_init()
+{
+    // make event
+    tb_event_futex_t* event = tb_malloc0_type(tb_event_futex_t);
+    tb_assert_and_check_return_val(event, tb_null);
+
+    // init it
+    tb_atomic32_init(&event->signal, 0);
+    tb_atomic32_init(&event->waiters, 0);
+    return (tb_event_ref_t)event;
+}
+tb_void_t tb_event_exit(tb_event_ref_t self)
+{
+    // check
+    tb_event_futex_t* event = (tb_event_futex_t*)self;
+    tb_assert_and_check_return(event);
+
+    // free it
+    tb_free(event);
+}
+tb_bool_t tb_event_post(tb_event_ref_t self)
+{
+    // check
+    tb_event_futex_t* event = (tb_event_futex_t*)self;
+    tb_assert_and_check_return_val(event, tb_false);
+
+    // signal it, we need not enter the kernel if it has been signaled or no one is waiting
+    if (!tb_atomic32_fetch_and_set(&event->signal, 1) && tb_atomic32_get(&event->waiters) > 0)
+        tb_futex_wake(&event->signal, 1);
+    return tb_true;
+}
+tb_long_t tb_event_wait(tb_event_ref_t self, tb_long_t timeout)
+{
+    // check
+    tb_event_futex_t* event = (tb_event_futex_t*)self;
+    tb_assert_and_check_return_val(event, -1);
+
+    // has signal?
+    if (tb_event_futex_take(event)) return 1;
+    tb_check_return_val(timeout, 0);
+
+    // wait it
+    tb_long_t ok = 0;
+    tb_hong_t time = timeout > 0? tb_mclock() + timeout : 0;
+    tb_atomic32_fetch_and_add(&event->waiters, 1);
+    while (1)
+    {
+        // has signal?
+        if (tb_event_futex_take(event))
+        {
+            ok = 1;
+            break;
+        }
+
+        // the left timeout
+        tb_long_t left = -1;
+        if (timeout > 0 && (left = (tb_long_t)(time - tb_mclock())) <= 0) break;
+
+        // wait it if it is still not signaled, we will check it again after being waked up or interrupted
+        if (tb_futex_wait(&event->signal, 0, left) < 0)
+        {
+            ok = -1;
+            break;
+        }
+    }
+    tb_atomic32_fetch_and_sub(&event->waiters, 1);
+    return ok;
+}
@@ -0,0 +1,65 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        futex.c
+ * @ingroup     platform
+ *
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <limits.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+tb_long_t tb_futex_wait(tb_atomic32_t* futex, tb_int32_t value, tb_long_t timeout)
+{
+    // check
+    tb_assert_and_check_return_val(futex, -1);
+
+    // init the relative timeout
+    struct timespec t = {0};
+    if (timeout > 0)
+    {
+        t.tv_sec    = timeout / 1000;
+        t.tv_nsec   = (timeout % 1000) * 1000000;
+    }
+
+    // wait it
+    if (!syscall(SYS_futex, (tb_pointer_t)futex, FUTEX_WAIT_PRIVATE, value, timeout >= 0? &t : tb_null, tb_null, 0)) return 1;
+
+    // the value has been changed? timeout or interrupted?
+    tb_int_t e = errno;
+    return e == EAGAIN? 1 : ((e == ETIMEDOUT || e == EINTR)? 0 : -1);
+}
+tb_size_t tb_futex_wake(tb_atomic32_t* futex, tb_size_t count)
+{
+    // check
+    tb_assert_and_check_return_val(futex, 0);
+
+    // wake it
+    tb_long_t ok = syscall(SYS_futex, (tb_pointer_t)futex, FUTEX_WAKE_PRIVATE, count > INT_MAX? INT_MAX : (tb_int_t)count, tb_null, tb_null, 0);
+    return ok > 0? (tb_size_t)ok : 0;
+}
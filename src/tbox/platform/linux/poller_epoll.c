@@ -22,10 +22,13 @@
  * includes
  */
 #include "prefix.h"
+#include "../cpu.h"
+#include "../tsc.h"
 #include <sys/epoll.h>
 #include <fcntl.h>
 #include <errno.h>
 #include <unistd.h>
+#include <sys/socket.h>
 #ifdef TB_CONFIG_POSIX_HAVE_GETRLIMIT
 #   include <sys/resource.h>
 #endif
@@ -55,6 +58,9 @@ typedef struct __tb_poller_epoll_t
     // the events count
     tb_size_t               events_count;
 
+    // the batch events for tb_poller_wait_batch(), it has the same count as the epoll events
+    tb_poller_event_t*      batch;
+
     // the socket data
     tb_pollerdata_t         pollerdata;
 
@@ -84,6 +90,143 @@ static tb_size_t tb_poller_epoll_maxfds()
     // ok?
     return maxfds;
 }
+static tb_void_t tb_poller_epoll_busypoll(tb_poller_epoll_ref_t poller, tb_poller_object_ref_t object)
+{
+#ifdef SO_BUSY_POLL
+    // enable busy-polling for the socket, it may need CAP_NET_ADMIN, so we ignore the failure
+    if (poller->base.busypoll && object->type == TB_POLLER_OBJECT_SOCK && object->ref.sock != poller->pair[1])
+    {
+        tb_int_t usec = (tb_int_t)tb_min(poller->base.busypoll, TB_MAXS32);
+        if (setsockopt(tb_sock2fd(object->ref.sock), SOL_SOCKET, SO_BUSY_POLL, (tb_char_t*)&usec, sizeof(usec)) < 0)
+            tb_trace_d("set SO_BUSY_POLL(%d) for socket(%p) failed, errno: %d", usec, object->ref.sock, errno);
+    }
+#endif
+}
+static tb_long_t tb_poller_epoll_wait_events(tb_poller_epoll_ref_t poller, tb_long_t timeout)
+{
+    // busy-polling? spin and poll events without blocking first
+    if (poller->base.busypoll && timeout)
+    {
+        // we use the monotonic cycle counter clock (ns), it is cheaper than the system clock
+        tb_hong_t start = tb_tsc_clock();
+        tb_hong_t stop = start + (tb_hong_t)poller->base.busypoll * 1000;
+        if (timeout > 0) stop = tb_min(stop, start + (tb_hong_t)timeout * 1000000);
+        do
+        {
+            tb_long_t events_count = epoll_wait(poller->epfd, poller->events, poller->events_count, 0);
+            if (events_count) return events_count;
+
+            // relax the cpu before polling it again
+#ifdef tb_cpu_pause
+            tb_cpu_pause();
+#endif
+
+        } while (tb_tsc_clock() < stop);
+
+        // compute the left timeout
+        if (timeout > 0)
+        {
+            tb_long_t elapsed = (tb_long_t)((tb_tsc_clock() - start) / 1000000);
+            timeout = timeout > elapsed? timeout - elapsed : 0;
+        }
+    }
+
+    // wait events
+    return epoll_wait(poller->epfd, poller->events, poller->events_count, timeout);
+}
+static tb_long_t tb_poller_epoll_wait_ready(tb_poller_epoll_ref_t poller, tb_bool_t batch, tb_long_t timeout)
+{
+    // init events
+    tb_size_t grow = tb_align8((poller->maxn >> 3) + 1);
+    if (!poller->events)
+    {
+        poller->events_count = grow;
+        poller->events = tb_nalloc_type(poller->events_count, struct epoll_event);
+        tb_assert_and_check_return_val(poller->events, -1);
+    }
+
+    // init batch events
+    if (batch && !poller->batch)
+    {
+        poller->batch = tb_nalloc_type(poller->events_count, tb_poller_event_t);
+        tb_assert_and_check_return_val(poller->batch, -1);
+    }
+
+    // wait events
+    tb_long_t events_count = tb_poller_epoll_wait_events(poller, timeout);
+
+    // timeout or interrupted?
+    if (!events_count || (events_count == -1 && errno == EINTR))
+        return 0;
+
+    // check error?
+    tb_assert_and_check_return_val(events_count >= 0 && events_count <= poller->events_count, -1);
+
+    // grow it if events is full, the ready events are kept
+    if (events_count == poller->events_count)
+    {
+        // grow size
+        poller->events_count += grow;
+        if (poller->events_count > poller->maxn) poller->events_count = poller->maxn;
+
+        // grow data
+        poller->events = (struct epoll_event*)tb_ralloc(poller->events, poller->events_count * sizeof(struct epoll_event));
+        tb_assert_and_check_return_val(poller->events, -1);
+
+        // grow batch events
+        if (poller->batch)
+        {
+            poller->batch = (tb_poller_event_t*)tb_ralloc(poller->batch, poller->events_count * sizeof(tb_poller_event_t));
+            tb_assert_and_check_return_val(poller->batch, -1);
+        }
+    }
+    tb_assert(events_count <= poller->events_count);
+
+    // limit
+    return tb_min(events_count, poller->maxn);
+}
+static tb_long_t tb_poller_epoll_event(tb_poller_epoll_ref_t poller, struct epoll_event* e, tb_poller_event_ref_t event)
+{
+    // the events for epoll
+    tb_size_t epoll_events = e->events;
+
+    // the socket
+    tb_long_t fd = e->data.fd;
+    event->object.ref.ptr = tb_fd2ptr(fd);
+    tb_assert(event->object.ref.ptr);
+
+    // spank socket events?
+    tb_socket_ref_t pair = poller->pair[1];
+    if (event->object.ref.sock == pair)
+    {
+        // read spak
+        tb_check_return_val(epoll_events & EPOLLIN, 0);
+        tb_char_t spak = '\0';
+        if (1 != tb_socket_recv(pair, (tb_byte_t*)&spak, 1)) return -1;
+
+        // killed? or continue it
+        return spak == 'k'? -1 : 0;
+    }
+
+    // init events
+    tb_size_t events = TB_POLLER_EVENT_NONE;
+    if (epoll_events & EPOLLIN) events |= TB_POLLER_EVENT_RECV;
+    if (epoll_events & EPOLLOUT) events |= TB_POLLER_EVENT_SEND;
+    if (epoll_events & (EPOLLHUP | EPOLLERR) && !(events & (TB_POLLER_EVENT_RECV | TB_POLLER_EVENT_SEND)))
+        events |= TB_POLLER_EVENT_RECV | TB_POLLER_EVENT_SEND;
+
+#ifdef EPOLLRDHUP
+    // connection closed for the edge trigger?
+    if (epoll_events & EPOLLRDHUP) events |= TB_POLLER_EVENT_EOF;
+#endif
+
+    // get the user private data
+    tb_cpointer_t priv = tb_pollerdata_get(&poller->pollerdata, &event->object);
+    event->object.type  = tb_poller_priv_get_object_type(priv);
+    event->events       = events;
+    event->priv         = tb_poller_priv_get_original(priv);
+    return 1;
+}
 static tb_void_t tb_poller_epoll_exit(tb_poller_t* self)
 {
     // check
@@ -101,6 +244,10 @@ static tb_void_t tb_poller_epoll_exit(tb_poller_t* self)
     poller->events          = tb_null;
     poller->events_count    = 0;
 
+    // exit batch events
+    if (poller->batch) tb_free(poller->batch);
+    poller->batch = tb_null;
+
     // close epfd
     if (poller->epfd > 0) close(poller->epfd);
     poller->epfd = 0;
@@ -171,6 +318,9 @@ static tb_bool_t tb_poller_epoll_insert(tb_poller_t* self, tb_poller_object_ref_
         return tb_false;
     }
 
+    // enable busy-polling for this socket
+    tb_poller_epoll_busypoll(poller, object);
+
     // ok
     return tb_true;
 }
@@ -243,91 +393,24 @@ static tb_long_t tb_poller_epoll_wait(tb_poller_t* self, tb_poller_event_func_t
     tb_poller_epoll_ref_t poller = (tb_poller_epoll_ref_t)self;
     tb_assert_and_check_return_val(poller && poller->epfd > 0 && poller->maxn && func, -1);
 
-    // init events
-    tb_size_t grow = tb_align8((poller->maxn >> 3) + 1);
-    if (!poller->events)
-    {
-        poller->events_count = grow;
-        poller->events = tb_nalloc_type(poller->events_count, struct epoll_event);
-        tb_assert_and_check_return_val(poller->events, -1);
-    }
-
     // wait events
-    tb_long_t events_count = epoll_wait(poller->epfd, poller->events, poller->events_count, timeout);
-
-    // timeout or interrupted?
-    if (!events_count || (events_count == -1 && errno == EINTR))
-        return 0;
-
-    // check error?
-    tb_assert_and_check_return_val(events_count >= 0 && events_count <= poller->events_count, -1);
-
-    // grow it if events is full
-    if (events_count == poller->events_count)
-    {
-        // grow size
-        poller->events_count += grow;
-        if (poller->events_count > poller->maxn) poller->events_count = poller->maxn;
-
-        // grow data
-        poller->events = (struct epoll_event*)tb_ralloc(poller->events, poller->events_count * sizeof(struct epoll_event));
-        tb_assert_and_check_return_val(poller->events, -1);
-    }
-    tb_assert(events_count <= poller->events_count);
-
-    // limit
-    events_count = tb_min(events_count, poller->maxn);
+    tb_long_t events_count = tb_poller_epoll_wait_ready(poller, tb_false, timeout);
+    tb_check_return_val(events_count > 0, events_count);
 
     // handle events
-    tb_size_t           i = 0;
+    tb_long_t           i = 0;
+    tb_long_t           ok = 0;
     tb_size_t           wait = 0;
-    struct epoll_event* e = tb_null;
-    tb_socket_ref_t     pair = poller->pair[1];
-    tb_poller_object_t  object;
+    tb_poller_event_t   event;
     for (i = 0; i < events_count; i++)
     {
-        // the epoll event
-        e = poller->events + i;
-
-        // the events for epoll
-        tb_size_t epoll_events = e->events;
-
-        // the socket
-        tb_long_t fd = e->data.fd;
-        object.ref.ptr = tb_fd2ptr(fd);
-        tb_assert(object.ref.ptr);
-
-        // spank socket events?
-        if (object.ref.sock == pair && (epoll_events & EPOLLIN))
-        {
-            // read spak
-            tb_char_t spak = '\0';
-            if (1 != tb_socket_recv(pair, (tb_byte_t*)&spak, 1)) return -1;
-
-            // killed?
-            if (spak == 'k') return -1;
-
-            // continue it
-            continue ;
-        }
-        tb_check_continue(object.ref.sock != pair);
-
-        // init events
-        tb_size_t events = TB_POLLER_EVENT_NONE;
-        if (epoll_events & EPOLLIN) events |= TB_POLLER_EVENT_RECV;
-        if (epoll_events & EPOLLOUT) events |= TB_POLLER_EVENT_SEND;
-        if (epoll_events & (EPOLLHUP | EPOLLERR) && !(events & (TB_POLLER_EVENT_RECV | TB_POLLER_EVENT_SEND)))
-            events |= TB_POLLER_EVENT_RECV | TB_POLLER_EVENT_SEND;
-
-#ifdef EPOLLRDHUP
-        // connection closed for the edge trigger?
-        if (epoll_events & EPOLLRDHUP) events |= TB_POLLER_EVENT_EOF;
-#endif
+        // get event, killed or spak?
+        ok = tb_poller_epoll_event(poller, poller->events + i, &event);
+        tb_check_return_val(ok >= 0, -1);
+        tb_check_continue(ok);
 
         // call event function
-        tb_cpointer_t priv = tb_pollerdata_get(&poller->pollerdata, &object);
-        object.type = tb_poller_priv_get_object_type(priv);
-        func((tb_poller_ref_t)self, &object, events, tb_poller_priv_get_original(priv));
+        func((tb_poller_ref_t)self, &event.object, event.events, event.priv);
 
         // update the events count
         wait++;
@@ -336,6 +419,32 @@ static tb_long_t tb_poller_epoll_wait(tb_poller_t* self, tb_poller_event_func_t
     // ok
     return wait;
 }
+static tb_long_t tb_poller_epoll_wait_batch(tb_poller_t* self, tb_poller_events_func_t func, tb_long_t timeout)
+{
+    // check
+    tb_poller_epoll_ref_t poller = (tb_poller_epoll_ref_t)self;
+    tb_assert_and_check_return_val(poller && poller->epfd > 0 && poller->maxn && func, -1);
+
+    // wait events
+    tb_long_t events_count = tb_poller_epoll_wait_ready(poller, tb_true, timeout);
+    tb_check_return_val(events_count > 0, events_count);
+
+    // fill the batch events from the epoll events
+    tb_long_t i = 0;
+    tb_long_t ok = 0;
+    tb_size_t wait = 0;
+    for (i = 0; i < events_count; i++)
+    {
+        // get event, killed or spak?
+        ok = tb_poller_epoll_event(poller, poller->events + i, poller->batch + wait);
+        tb_check_return_val(ok >= 0, -1);
+        if (ok) wait++;
+    }
+
+    // pass all events at once
+    if (wait) func((tb_poller_ref_t)self, poller->batch, wait);
+    return wait;
+}
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * implementation
@@ -357,6 +466,7 @@ tb_poller_t* tb_poller_epoll_init()
         poller->base.kill   = tb_poller_epoll_kill;
         poller->base.spak   = tb_poller_epoll_spak;
         poller->base.wait   = tb_poller_epoll_wait;
+        poller->base.wait_batch = tb_poller_epoll_wait_batch;
         poller->base.insert = tb_poller_epoll_insert;
         poller->base.remove = tb_poller_epoll_remove;
         poller->base.modify = tb_poller_epoll_modify;
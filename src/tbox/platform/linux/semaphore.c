@@ -0,0 +1,145 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        semaphore.c
+ * @ingroup     platform
+ *
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+#include "../futex.h"
+#include "../time.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the futex semaphore type
+typedef struct __tb_semaphore_futex_t
+{
+    // the semaphore value, the waiters wait on it if it is zero
+    tb_atomic32_t       value;
+
+    // the waiters count, we need not wake up them if no one is waiting
+    tb_atomic32_t       waiters;
+
+}tb_semaphore_futex_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static __tb_inline__ tb_bool_t tb_semaphore_futex_take(tb_semaphore_futex_t* semaphore)
+{
+    // semaphore-- if it is not zero
+    tb_int32_t value = tb_atomic32_get(&semaphore->value);
+    while (value > 0)
+    {
+        if (tb_atomic32_compare_and_swap_weak_explicit(&semaphore->value, &value, value - 1, TB_ATOMIC_ACQUIRE, TB_ATOMIC_RELAXED))
+            return tb_true;
+    }
+    return tb_false;
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+tb_semaphore_ref_t tb_semaphore_init(tb_size_t init)
+{
+    // check
+    tb_assert_and_check_return_val(init <= TB_MAXS32, tb_null);
+
+    // make semaphore
+    tb_semaphore_futex_t* semaphore = tb_malloc0_type(tb_semaphore_futex_t);
+    tb_assert_and_check_return_val(semaphore, tb_null);
+
+    // init it
+    tb_atomic32_init(&semaphore->value, (tb_int32_t)init);
+    tb_atomic32_init(&semaphore->waiters, 0);
+    return (tb_semaphore_ref_t)semaphore;
+}
+tb_void_t tb_semaphore_exit(tb_semaphore_ref_t self)
+{
+    // check
+    tb_semaphore_futex_t* semaphore = (tb_semaphore_futex_t*)self;
+    tb_assert_and_check_return(semaphore);
+
+    // free it
+    tb_free(semaphore);
+}
+tb_bool_t tb_semaphore_post(tb_semaphore_ref_t self, tb_size_t post)
+{
+    // check
+    tb_semaphore_futex_t* semaphore = (tb_semaphore_futex_t*)self;
+    tb_assert_and_check_return_val(semaphore && post && post <= TB_MAXS32, tb_false);
+
+    // semaphore += post
+    tb_atomic32_fetch_and_add(&semaphore->value, (tb_int32_t)post);
+
+    // wake up the post waiters at once, we need not enter the kernel if no one is waiting
+    if (tb_atomic32_get(&semaphore->waiters) > 0)
+        tb_futex_wake(&semaphore->value, post);
+    return tb_true;
+}
+tb_long_t tb_semaphore_value(tb_semaphore_ref_t self)
+{
+    // check
+    tb_semaphore_futex_t* semaphore = (tb_semaphore_futex_t*)self;
+    tb_assert_and_check_return_val(semaphore, -1);
+
+    // get value
+    return (tb_long_t)tb_atomic32_get(&semaphore->value);
+}
+tb_long_t tb_semaphore_wait(tb_semaphore_ref_t self, tb_long_t timeout)
+{
+    // check
+    tb_semaphore_futex_t* semaphore = (tb_semaphore_futex_t*)self;
+    tb_assert_and_check_return_val(semaphore, -1);
+
+    // has signal?
+    if (tb_semaphore_futex_take(semaphore)) return 1;
+    tb_check_return_val(timeout, 0);
+
+    // wait it
+    tb_long_t ok = 0;
+    tb_hong_t time = timeout > 0? tb_mclock() + timeout : 0;
+    tb_atomic32_fetch_and_add(&semaphore->waiters, 1);
+    while (1)
+    {
+        // has signal?
+        if (tb_semaphore_futex_take(semaphore))
+        {
+            ok = 1;
+            break;
+        }
+
+        // the left timeout
+        tb_long_t left = -1;
+        if (timeout > 0 && (left = (tb_long_t)(time - tb_mclock())) <= 0) break;
+
+        // wait it if the value is still zero, we will check it again after being waked up or interrupted
+        if (tb_futex_wait(&semaphore->value, 0, left) < 0)
+        {
+            ok = -1;
+            break;
+        }
+    }
+    tb_atomic32_fetch_and_sub(&semaphore->waiters, 1);
+    return ok;
+}
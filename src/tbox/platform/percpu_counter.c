@@ -0,0 +1,145 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        percpu_counter.c
+ * @ingroup     platform
+ *
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "percpu_counter.h"
+#include "thread.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the slots mask
+#define TB_PERCPU_COUNTER_SLOT_MASK         (TB_PERCPU_COUNTER_SLOT_MAXN - 1)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * globals
+ */
+
+// the next slot index for the new thread
+static tb_atomic32_t                        g_slot_next = 0;
+
+// the slot index of the current thread, index + 1
+#ifdef __tb_thread_local__
+static __tb_thread_local__ tb_size_t        g_slot_self = 0;
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static __tb_inline__ tb_percpu_counter_slot_t* tb_percpu_counter_slot(tb_percpu_counter_ref_t counter)
+{
+    /* we assign the slots to threads in turn, so the threads running on the different cpus
+     * will use the different slots if the threads count is not larger than the slots count.
+     */
+#ifdef __tb_thread_local__
+    if (!g_slot_self) g_slot_self = (tb_size_t)tb_atomic32_fetch_and_add_explicit(&g_slot_next, 1, TB_ATOMIC_RELAXED) + 1;
+    return &counter->slots[(g_slot_self - 1) & TB_PERCPU_COUNTER_SLOT_MASK];
+#else
+    tb_size_t self = tb_thread_self();
+    return &counter->slots[((self >> 4) ^ (self >> 12)) & TB_PERCPU_COUNTER_SLOT_MASK];
+#endif
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+tb_void_t tb_percpu_counter_init(tb_percpu_counter_ref_t counter, tb_hong_t value, tb_size_t batch)
+{
+    // check
+    tb_assert_and_check_return(counter);
+
+    // init it
+    tb_size_t i = 0;
+    tb_atomic64_init(&counter->count, value);
+    counter->batch = batch? (tb_long_t)batch : TB_PERCPU_COUNTER_BATCH;
+    for (i = 0; i < TB_PERCPU_COUNTER_SLOT_MAXN; i++)
+        tb_atomic_init(&counter->slots[i].value, 0);
+}
+tb_void_t tb_percpu_counter_exit(tb_percpu_counter_ref_t counter)
+{
+    // check
+    tb_assert_and_check_return(counter);
+
+    // clear it
+    tb_percpu_counter_set(counter, 0);
+}
+tb_void_t tb_percpu_counter_add(tb_percpu_counter_ref_t counter, tb_long_t value)
+{
+    // check
+    tb_assert(counter);
+
+    // add it to the slot of the current thread, it is uncontended in most cases
+    tb_percpu_counter_slot_t*   slot = tb_percpu_counter_slot(counter);
+    tb_long_t                   delta = tb_atomic_fetch_and_add_explicit(&slot->value, value, TB_ATOMIC_RELAXED) + value;
+    tb_check_return(delta >= counter->batch || delta <= -counter->batch);
+
+    /* fold the slot value to the global count
+     *
+     * tb_percpu_counter_sum() reads the global count before the slots,
+     * so we clear the negative slot value before decreasing the global count,
+     * and the sum will never be less than the real value if the counter is only decreasing.
+     */
+    if (delta > 0)
+    {
+        tb_atomic64_fetch_and_add_explicit(&counter->count, delta, TB_ATOMIC_RELAXED);
+        tb_atomic_fetch_and_sub_explicit(&slot->value, delta, TB_ATOMIC_RELEASE);
+    }
+    else
+    {
+        tb_atomic_fetch_and_sub_explicit(&slot->value, delta, TB_ATOMIC_RELEASE);
+        tb_atomic64_fetch_and_add_explicit(&counter->count, delta, TB_ATOMIC_RELEASE);
+    }
+}
+tb_hong_t tb_percpu_counter_get(tb_percpu_counter_ref_t counter)
+{
+    // check
+    tb_assert_and_check_return_val(counter, 0);
+
+    // only read the global count
+    return (tb_hong_t)tb_atomic64_get_explicit(&counter->count, TB_ATOMIC_RELAXED);
+}
+tb_hong_t tb_percpu_counter_sum(tb_percpu_counter_ref_t counter)
+{
+    // check
+    tb_assert_and_check_return_val(counter, 0);
+
+    // fold all slots
+    tb_size_t i = 0;
+    tb_hong_t sum = (tb_hong_t)tb_atomic64_get_explicit(&counter->count, TB_ATOMIC_ACQUIRE);
+    for (i = 0; i < TB_PERCPU_COUNTER_SLOT_MAXN; i++)
+        sum += tb_atomic_get_explicit(&counter->slots[i].value, TB_ATOMIC_ACQUIRE);
+    return sum;
+}
+tb_void_t tb_percpu_counter_set(tb_percpu_counter_ref_t counter, tb_hong_t value)
+{
+    // check
+    tb_assert_and_check_return(counter);
+
+    // reset all slots
+    tb_size_t i = 0;
+    for (i = 0; i < TB_PERCPU_COUNTER_SLOT_MAXN; i++)
+        tb_atomic_set_explicit(&counter->slots[i].value, 0, TB_ATOMIC_RELAXED);
+    tb_atomic64_set(&counter->count, value);
+}
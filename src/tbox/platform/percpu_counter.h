@@ -0,0 +1,150 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        percpu_counter.h
+ * @ingroup     platform
+ *
+ */
+#ifndef TB_PLATFORM_PERCPU_COUNTER_H
+#define TB_PLATFORM_PERCPU_COUNTER_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+#include "atomic.h"
+#include "atomic64.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+/// the slots maxn of the per-cpu counter, must be power of 2
+#ifdef __tb_small__
+#   define TB_PERCPU_COUNTER_SLOT_MAXN      (8)
+#else
+#   define TB_PERCPU_COUNTER_SLOT_MAXN      (64)
+#endif
+
+/// the default batch, the slot value will be folded to the global count if it reaches the batch
+#define TB_PERCPU_COUNTER_BATCH             (32)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+/// the per-cpu counter slot type, it is aligned to the cache line to avoid false sharing
+typedef struct __tb_percpu_counter_slot_t
+{
+    /// the value delta of this slot
+    tb_atomic_t                     value;
+
+    /// the padding
+    tb_byte_t                       padding[TB_L1_CACHE_BYTES - sizeof(tb_atomic_t)];
+
+}tb_percpu_counter_slot_t;
+
+/*! the per-cpu counter type
+ *
+ * the threads add the value to their own slot without bouncing the same cache line between cpus,
+ * and the slot value is folded to the global count only if it reaches the batch.
+ *
+ * so adding is cheap, tb_percpu_counter_get() returns the approximate value by reading the global count only,
+ * and tb_percpu_counter_sum() returns the exact value by folding all slots.
+ */
+typedef struct __tb_percpu_counter_t
+{
+    /// the global count
+    tb_atomic64_t                   count;
+
+    /// the batch
+    tb_long_t                       batch;
+
+    /// the padding to avoid the false sharing between the global count and the slots
+    tb_byte_t                       padding[TB_L1_CACHE_BYTES];
+
+    /// the slots
+    tb_percpu_counter_slot_t        slots[TB_PERCPU_COUNTER_SLOT_MAXN];
+
+}tb_percpu_counter_t, *tb_percpu_counter_ref_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/*! init the per-cpu counter
+ *
+ * @param counter       the counter
+ * @param value         the initial value
+ * @param batch         the batch, using the default batch if be zero
+ */
+tb_void_t               tb_percpu_counter_init(tb_percpu_counter_ref_t counter, tb_hong_t value, tb_size_t batch);
+
+/*! exit the per-cpu counter
+ *
+ * @param counter       the counter
+ */
+tb_void_t               tb_percpu_counter_exit(tb_percpu_counter_ref_t counter);
+
+/*! add the value to the slot of the current thread
+ *
+ * @param counter       the counter
+ * @param value         the added value, it can be negative
+ */
+tb_void_t               tb_percpu_counter_add(tb_percpu_counter_ref_t counter, tb_long_t value);
+
+/*! get the approximate value
+ *
+ * it only reads the global count, and the error is less than (batch * TB_PERCPU_COUNTER_SLOT_MAXN)
+ *
+ * @param counter       the counter
+ *
+ * @return              the approximate value
+ */
+tb_hong_t               tb_percpu_counter_get(tb_percpu_counter_ref_t counter);
+
+/*! get the exact value by folding all slots
+ *
+ * the result may be larger than the real value if the counter is being modified concurrently,
+ * but it is never less than the real value if the counter is only decreasing, e.g. waiting for all jobs to be finished.
+ *
+ * @param counter       the counter
+ *
+ * @return              the exact value
+ */
+tb_hong_t               tb_percpu_counter_sum(tb_percpu_counter_ref_t counter);
+
+/*! set the value
+ *
+ * @note it is not safe if the counter is being modified concurrently
+ *
+ * @param counter       the counter
+ * @param value         the value
+ */
+tb_void_t               tb_percpu_counter_set(tb_percpu_counter_ref_t counter, tb_hong_t value);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
@@ -128,3 +128,20 @@ tb_bool_t tb_pipe_file_bwrit(tb_pipe_file_ref_t file, tb_byte_t const* data, tb_
     }
     return writ == size;
 }
+#ifndef TB_PIPE_FILE_HAVE_SPLICE
+tb_long_t tb_pipe_file_splice_from_sock(tb_pipe_file_ref_t file, tb_socket_ref_t sock, tb_size_t size)
+{
+    tb_trace_noimpl();
+    return -1;
+}
+tb_long_t tb_pipe_file_splice_to_sock(tb_pipe_file_ref_t file, tb_socket_ref_t sock, tb_size_t size)
+{
+    tb_trace_noimpl();
+    return -1;
+}
+tb_long_t tb_pipe_file_splice_to_file(tb_pipe_file_ref_t file, tb_file_ref_t ofile, tb_hize_t offset, tb_size_t size)
+{
+    tb_trace_noimpl();
+    return -1;
+}
+#endif
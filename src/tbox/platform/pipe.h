@@ -28,6 +28,15 @@
 #include "prefix.h"
 #include "socket.h"
 
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// have splice? we can move data between the pipe and the socket or file in the kernel
+#if defined(TB_CONFIG_POSIX_HAVE_SPLICE) && !defined(TB_CONFIG_OS_WINDOWS)
+#   define TB_PIPE_FILE_HAVE_SPLICE
+#endif
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * extern
  */
@@ -153,6 +162,43 @@ tb_bool_t               tb_pipe_file_bread(tb_pipe_file_ref_t file, tb_byte_t* d
  */
 tb_bool_t               tb_pipe_file_bwrit(tb_pipe_file_ref_t file, tb_byte_t const* data, tb_size_t size);
 
+/*! splice the socket data to the pipe file without copying it to the user space (non-block)
+ *
+ * @note only be supported if TB_PIPE_FILE_HAVE_SPLICE is defined
+ *
+ * @param file          the writed pipe file
+ * @param sock          the socket
+ * @param size          the size
+ *
+ * @return              the real size, 0 if no data or -1 if failed or the socket has been closed
+ */
+tb_long_t               tb_pipe_file_splice_from_sock(tb_pipe_file_ref_t file, tb_socket_ref_t sock, tb_size_t size);
+
+/*! splice the pipe file data to the socket without copying it to the user space (non-block)
+ *
+ * @note only be supported if TB_PIPE_FILE_HAVE_SPLICE is defined
+ *
+ * @param file          the readed pipe file
+ * @param sock          the socket
+ * @param size          the size
+ *
+ * @return              the real size or -1
+ */
+tb_long_t               tb_pipe_file_splice_to_sock(tb_pipe_file_ref_t file, tb_socket_ref_t sock, tb_size_t size);
+
+/*! splice the pipe file data to the given offset of file without copying it to the user space
+ *
+ * @note only be supported if TB_PIPE_FILE_HAVE_SPLICE is defined, the file offset will not be changed
+ *
+ * @param file          the readed pipe file
+ * @param ofile         the output file
+ * @param offset        the offset of the output file
+ * @param size          the size
+ *
+ * @return              the real size or -1
+ */
+tb_long_t               tb_pipe_file_splice_to_file(tb_pipe_file_ref_t file, tb_file_ref_t ofile, tb_hize_t offset, tb_size_t size);
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * extern
  */
@@ -27,40 +27,49 @@
  */
 #include "prefix.h"
 #include "cpu.h"
+#include "tsc.h"
 #include "page.h"
 #include "path.h"
 #include "file.h"
 #include "time.h"
 #include "pipe.h"
 #include "mutex.h"
+#include "futex.h"
 #include "event.h"
 #include "timer.h"
 #include "print.h"
 #include "ltimer.h"
+#include "htimer.h"
 #include "socket.h"
 #include "thread.h"
 #include "atomic.h"
 #include "poller.h"
+#include "future.h"
+#include "rwlock.h"
 #include "context.h"
 #include "ifaddrs.h"
 #include "dynamic.h"
 #include "process.h"
 #include "stdfile.h"
+#include "seqlock.h"
 #include "fwatcher.h"
 #include "filelock.h"
 #include "syserror.h"
 #include "addrinfo.h"
 #include "spinlock.h"
+#include "futexlock.h"
 #include "hostname.h"
 #include "semaphore.h"
 #include "backtrace.h"
 #include "directory.h"
 #include "exception.h"
 #include "cache_time.h"
+#include "task_graph.h"
 #include "environment.h"
 #include "thread_pool.h"
 #include "thread_local.h"
 #include "native_memory.h"
+#include "percpu_counter.h"
 #include "virtual_memory.h"
 #ifdef TB_CONFIG_API_HAVE_DEPRECATED
 #   include "deprecated/deprecated.h"
@@ -79,6 +79,70 @@
 #   endif
 #endif
 
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static tb_void_t tb_poller_wait_batch_one(tb_poller_ref_t self, tb_poller_object_ref_t object, tb_long_t events, tb_cpointer_t priv)
+{
+    // check
+    tb_poller_t* poller = (tb_poller_t*)self;
+    tb_assert_and_check_return(poller && poller->batch_func && object);
+
+    // pass this event only, e.g. the process/fwatcher events or the poller without the native batch events
+    tb_poller_event_t event;
+    event.object    = *object;
+    event.events    = events;
+    event.priv      = priv;
+    poller->batch_func(self, &event, 1);
+}
+static tb_long_t tb_poller_wait_all(tb_poller_t* poller, tb_poller_event_func_t func, tb_bool_t batch, tb_long_t timeout)
+{
+#ifdef TB_POLLER_ENABLE_PROCESS
+    // prepare to wait the processes
+    if (poller->process_poller)
+    {
+        // prepare to wait processes
+        if (!tb_poller_process_wait_prepare(poller->process_poller))
+            return -1;
+    }
+#endif
+
+#ifdef TB_POLLER_ENABLE_FWATCHER
+    // prepare to wait the fwatchers
+    if (poller->fwatcher_poller)
+    {
+        // prepare to wait fwatchers
+        if (!tb_poller_fwatcher_wait_prepare(poller->fwatcher_poller))
+            return -1;
+    }
+#endif
+
+    // wait the poller objects, pass all events at once if the poller supports it
+    tb_long_t wait = (batch && poller->wait_batch)? poller->wait_batch(poller, poller->batch_func, timeout) : poller->wait(poller, func, timeout);
+    tb_check_return_val(wait >= 0, -1);
+
+#ifdef TB_POLLER_ENABLE_PROCESS
+    // poll all waited processes
+    if (poller->process_poller)
+    {
+        tb_long_t proc_wait = tb_poller_process_wait_poll(poller->process_poller, func);
+        tb_check_return_val(proc_wait >= 0, -1);
+        wait += proc_wait;
+    }
+#endif
+
+#ifdef TB_POLLER_ENABLE_FWATCHER
+    // poll all waited fwatchers
+    if (poller->fwatcher_poller)
+    {
+        tb_long_t fwatcher_wait = tb_poller_fwatcher_wait_poll(poller->fwatcher_poller, func);
+        tb_check_return_val(fwatcher_wait >= 0, -1);
+        wait += fwatcher_wait;
+    }
+#endif
+    return wait;
+}
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * implementation
  */
@@ -317,51 +381,31 @@ tb_long_t tb_poller_wait(tb_poller_ref_t self, tb_poller_event_func_t func, tb_l
     tb_poller_t* poller = (tb_poller_t*)self;
     tb_assert_and_check_return_val(poller && poller->wait && func, -1);
 
-#ifdef TB_POLLER_ENABLE_PROCESS
-    // prepare to wait the processes
-    if (poller->process_poller)
-    {
-        // prepare to wait processes
-        if (!tb_poller_process_wait_prepare(poller->process_poller))
-            return -1;
-    }
-#endif
-
-#ifdef TB_POLLER_ENABLE_FWATCHER
-    // prepare to wait the fwatchers
-    if (poller->fwatcher_poller)
-    {
-        // prepare to wait fwatchers
-        if (!tb_poller_fwatcher_wait_prepare(poller->fwatcher_poller))
-            return -1;
-    }
-#endif
-
-    // wait the poller objects
-    tb_long_t wait = poller->wait(poller, func, timeout);
-    tb_check_return_val(wait >= 0, -1);
-
-#ifdef TB_POLLER_ENABLE_PROCESS
-    // poll all waited processes
-    if (poller->process_poller)
-    {
-        tb_long_t proc_wait = tb_poller_process_wait_poll(poller->process_poller, func);
-        tb_check_return_val(proc_wait >= 0, -1);
-        wait += proc_wait;
-    }
-#endif
+    // wait all objects
+    return tb_poller_wait_all(poller, func, tb_false, timeout);
+}
+tb_long_t tb_poller_wait_batch(tb_poller_ref_t self, tb_poller_events_func_t func, tb_long_t timeout)
+{
+    // check
+    tb_poller_t* poller = (tb_poller_t*)self;
+    tb_assert_and_check_return_val(poller && poller->wait && func, -1);
 
-#ifdef TB_POLLER_ENABLE_FWATCHER
-    // poll all waited fwatchers
-    if (poller->fwatcher_poller)
-    {
-        tb_long_t fwatcher_wait = tb_poller_fwatcher_wait_poll(poller->fwatcher_poller, func);
-        tb_check_return_val(fwatcher_wait >= 0, -1);
-        wait += fwatcher_wait;
-    }
-#endif
+    // wait all objects and pass their events in batch
+    poller->batch_func = func;
+    tb_long_t wait = tb_poller_wait_all(poller, tb_poller_wait_batch_one, tb_true, timeout);
+    poller->batch_func = tb_null;
     return wait;
 }
+tb_bool_t tb_poller_busypoll(tb_poller_ref_t self, tb_size_t usec)
+{
+    // check
+    tb_poller_t* poller = (tb_poller_t*)self;
+    tb_assert_and_check_return_val(poller, tb_false);
+
+    // save the busy-polling time
+    poller->busypoll = usec;
+    return tb_true;
+}
 tb_void_t tb_poller_attach(tb_poller_ref_t self)
 {
     // check
@@ -120,6 +120,28 @@ typedef struct __tb_poller_object_t
  */
 typedef tb_void_t   (*tb_poller_event_func_t)(tb_poller_ref_t poller, tb_poller_object_ref_t object, tb_long_t events, tb_cpointer_t priv);
 
+/// the poller event type for tb_poller_wait_batch()
+typedef struct __tb_poller_event_t
+{
+    /// the poller object
+    tb_poller_object_t      object;
+
+    /// the poller events or process status
+    tb_long_t               events;
+
+    /// the user private data for this object
+    tb_cpointer_t           priv;
+
+}tb_poller_event_t, *tb_poller_event_ref_t;
+
+/*! the poller events func type, all triggered events will be passed at once
+ *
+ * @param poller    the poller
+ * @param events    the triggered events
+ * @param count     the events count
+ */
+typedef tb_void_t   (*tb_poller_events_func_t)(tb_poller_ref_t poller, tb_poller_event_ref_t events, tb_size_t count);
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * interfaces
  */
@@ -216,6 +238,37 @@ tb_bool_t           tb_poller_modify(tb_poller_ref_t poller, tb_poller_object_re
  */
 tb_long_t           tb_poller_wait(tb_poller_ref_t poller, tb_poller_event_func_t func, tb_long_t timeout);
 
+/*! wait all sockets and pass all triggered events to the given function at once
+ *
+ * the events array is owned by the poller and it will be reused in the next waiting,
+ * so we can prefetch the private data of all events first and handle them in batch.
+ *
+ * @note the epoll poller fills the events array from the array of epoll_wait() directly,
+ * the other pollers and the process/fwatcher events are passed one by one (count: 1) now.
+ *
+ * @param poller    the poller
+ * @param func      the batch events function
+ * @param timeout   the timeout, infinity: -1
+ *
+ * @return          > 0: the events number, 0: timeout or interrupted, -1: failed
+ */
+tb_long_t           tb_poller_wait_batch(tb_poller_ref_t poller, tb_poller_events_func_t func, tb_long_t timeout);
+
+/*! enable busy-polling for reducing the wakeup latency
+ *
+ * tb_poller_wait() will spin and poll events without blocking for the given time first,
+ * and it will block and wait events only if no events are triggered in this time.
+ *
+ * it will also set SO_BUSY_POLL to the sockets inserted after calling it if be supported (only for epoll now),
+ * and it will be ignored if the poller does not support busy-polling.
+ *
+ * @param poller    the poller
+ * @param usec      the busy-polling time (us), 0: disable it
+ *
+ * @return          tb_true or tb_false
+ */
+tb_bool_t           tb_poller_busypoll(tb_poller_ref_t poller, tb_size_t usec);
+
 /*! attach the poller to the current thread (only for windows/iocp now)
  *
  * @param poller    the poller
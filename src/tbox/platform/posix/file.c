@@ -40,6 +40,129 @@
 #ifdef TB_CONFIG_POSIX_HAVE_SENDFILE
 #   include <sys/sendfile.h>
 #endif
+#ifdef TB_CONFIG_POSIX_HAVE_MMAP
+#   include "../page.h"
+#   include <sys/mman.h>
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// we can copy the unaligned data of the direct file by the aligned buffer
+#if defined(TB_CONFIG_OS_LINUX) && defined(O_DIRECT) && !defined(TB_CONFIG_MICRO_ENABLE)
+#   define TB_FILE_HAVE_DIRECT
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+#ifdef TB_FILE_HAVE_DIRECT
+static __tb_inline__ tb_long_t tb_file_pread_impl(tb_int_t fd, tb_byte_t* data, tb_size_t size, tb_hize_t offset)
+{
+#ifdef TB_CONFIG_POSIX_HAVE_PREAD64
+    return pread64(fd, data, (size_t)size, offset);
+#else
+    return pread(fd, data, (size_t)size, offset);
+#endif
+}
+static __tb_inline__ tb_long_t tb_file_pwrit_impl(tb_int_t fd, tb_byte_t const* data, tb_size_t size, tb_hize_t offset)
+{
+#ifdef TB_CONFIG_POSIX_HAVE_PWRITE64
+    return pwrite64(fd, data, (size_t)size, offset);
+#else
+    return pwrite(fd, data, (size_t)size, offset);
+#endif
+}
+static tb_bool_t tb_file_direct_able(tb_int_t fd)
+{
+    // the unaligned data, size or offset is rejected by the direct file?
+    tb_check_return_val(errno == EINVAL, tb_false);
+
+    // is direct file? we cannot copy it for the append mode, because the written offset will be ignored
+    tb_int_t flags = fcntl(fd, F_GETFL);
+    return flags >= 0 && (flags & O_DIRECT) && !(flags & O_APPEND);
+}
+static tb_long_t tb_file_direct_pread(tb_int_t fd, tb_byte_t* data, tb_size_t size, tb_hize_t offset)
+{
+    // we read it at most one cache size once
+    size = tb_min(size, TB_FILE_DIRECT_CSIZE);
+
+    // the aligned range
+    tb_hize_t head = offset & ~((tb_hize_t)TB_FILE_DIRECT_ASIZE - 1);
+    tb_hize_t tail = tb_align_u64(offset + size, TB_FILE_DIRECT_ASIZE);
+    tb_size_t need = (tb_size_t)(tail - head);
+
+    // make the aligned buffer
+    tb_byte_t* buff = (tb_byte_t*)tb_align_malloc(need, TB_FILE_DIRECT_ASIZE);
+    tb_assert_and_check_return_val(buff, -1);
+
+    // read the aligned range and copy the needed data, the range may be truncated at the end of file
+    tb_long_t real = tb_file_pread_impl(fd, buff, need, head);
+    if (real >= 0)
+    {
+        tb_size_t skip = (tb_size_t)(offset - head);
+        real = real > skip? tb_min(real - skip, size) : 0;
+        if (real) tb_memcpy(data, buff + skip, real);
+    }
+
+    // exit buffer
+    tb_align_free(buff);
+    return real;
+}
+static tb_long_t tb_file_direct_pwrit(tb_int_t fd, tb_byte_t const* data, tb_size_t size, tb_hize_t offset)
+{
+    /* we writ it at most one cache size once and end it at the aligned boundary,
+     * so only the last piece of the data has the unaligned tail block
+     */
+    size = tb_min(size, TB_FILE_DIRECT_CSIZE - (tb_size_t)(offset & (TB_FILE_DIRECT_ASIZE - 1)));
+
+    // the aligned range
+    tb_hize_t head = offset & ~((tb_hize_t)TB_FILE_DIRECT_ASIZE - 1);
+    tb_hize_t tail = tb_align_u64(offset + size, TB_FILE_DIRECT_ASIZE);
+    tb_size_t need = (tb_size_t)(tail - head);
+
+    // the file size
+    struct stat st = {0};
+    if (fstat(fd, &st)) return -1;
+    tb_hize_t fsize = st.st_size > 0? (tb_hize_t)st.st_size : 0;
+
+    // make the aligned buffer, the padding data after the end of file is zero
+    tb_byte_t* buff = (tb_byte_t*)tb_align_malloc0(need, TB_FILE_DIRECT_ASIZE);
+    tb_assert_and_check_return_val(buff, -1);
+
+    // done
+    tb_long_t ok = -1;
+    do
+    {
+        // read the unaligned head and tail blocks first
+        if (offset > head && head < fsize)
+        {
+            if (tb_file_pread_impl(fd, buff, TB_FILE_DIRECT_ASIZE, head) < 0) break;
+        }
+        if (offset + size < tail && tail - TB_FILE_DIRECT_ASIZE < fsize && !(offset > head && tail - TB_FILE_DIRECT_ASIZE == head))
+        {
+            if (tb_file_pread_impl(fd, buff + need - TB_FILE_DIRECT_ASIZE, TB_FILE_DIRECT_ASIZE, tail - TB_FILE_DIRECT_ASIZE) < 0) break;
+        }
+
+        // writ the whole aligned range
+        tb_memcpy(buff + (tb_size_t)(offset - head), data, size);
+        if (tb_file_pwrit_impl(fd, buff, need, head) != (tb_long_t)need) break;
+
+        // remove the padding data after the end of file
+        tb_hize_t end = tb_max(fsize, offset + size);
+        if (tail > end && ftruncate(fd, (off_t)end)) break;
+
+        // ok
+        ok = size;
+
+    } while (0);
+
+    // exit buffer
+    tb_align_free(buff);
+    return ok;
+}
+#endif
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * implementation
@@ -65,8 +188,19 @@ tb_file_ref_t tb_file_init(tb_char_t const* path, tb_size_t mode)
     if (mode & TB_FILE_MODE_TRUNC) flags |= O_TRUNC;
 
     // dma mode, no cache
-#if defined(TB_CONFIG_OS_LINUX) && defined(O_DIRECT)
-    if (mode & TB_FILE_MODE_DIRECT) flags |= O_DIRECT;
+#ifdef TB_FILE_HAVE_DIRECT
+    tb_size_t wflags = 0;
+    if (mode & TB_FILE_MODE_DIRECT)
+    {
+        flags |= O_DIRECT;
+
+        // we need read the unaligned head and tail blocks before writing them, so open the write-only file as read-write
+        if ((flags & O_ACCMODE) == O_WRONLY && !(flags & O_APPEND))
+        {
+            wflags = flags;
+            flags = (flags & ~O_ACCMODE) | O_RDWR;
+        }
+    }
 #endif
 
     // noblock
@@ -93,8 +227,25 @@ tb_file_ref_t tb_file_init(tb_char_t const* path, tb_size_t mode)
         else errno = errno_bak;
 #endif
     }
+#ifdef TB_FILE_HAVE_DIRECT
+    // the file is not readable? we open it as write-only, only the aligned data can be written
+    if (fd < 0 && wflags && errno == EACCES)
+    {
+        flags = wflags;
+        fd = open(path, flags, modes);
+    }
+
+    // the file system does not support the direct mode? we open it with the page cache
+    if (fd < 0 && (flags & O_DIRECT) && errno == EINVAL)
+        fd = open(path, flags & ~O_DIRECT, modes);
+#endif
     tb_check_return_val(fd >= 0, tb_null);
 
+#if !defined(TB_FILE_HAVE_DIRECT) && defined(F_NOCACHE)
+    // disable the page cache for the direct mode, e.g. macOS
+    if (mode & TB_FILE_MODE_DIRECT) fcntl(fd, F_NOCACHE, 1);
+#endif
+
     // trace
     tb_trace_d("open: %p", tb_fd2file(fd));
 
@@ -128,7 +279,18 @@ tb_long_t tb_file_read(tb_file_ref_t file, tb_byte_t* data, tb_size_t size)
     tb_assert_and_check_return_val(file && data, -1);
 
     // read it
-    return read(tb_file2fd(file), data, size);
+    tb_long_t real = read(tb_file2fd(file), data, size);
+
+#ifdef TB_FILE_HAVE_DIRECT
+    // read the unaligned data of the direct file
+    if (real < 0 && size && tb_file_direct_able(tb_file2fd(file)))
+    {
+        tb_hong_t offset = lseek(tb_file2fd(file), 0, SEEK_CUR);
+        if (offset >= 0) real = tb_file_direct_pread(tb_file2fd(file), data, size, offset);
+        if (real > 0 && lseek(tb_file2fd(file), offset + real, SEEK_SET) < 0) real = -1;
+    }
+#endif
+    return real;
 }
 tb_long_t tb_file_writ(tb_file_ref_t file, tb_byte_t const* data, tb_size_t size)
 {
@@ -136,7 +298,18 @@ tb_long_t tb_file_writ(tb_file_ref_t file, tb_byte_t const* data, tb_size_t size
     tb_assert_and_check_return_val(file && data, -1);
 
     // writ it
-    return write(tb_file2fd(file), data, size);
+    tb_long_t real = write(tb_file2fd(file), data, size);
+
+#ifdef TB_FILE_HAVE_DIRECT
+    // writ the unaligned data of the direct file
+    if (real < 0 && size && tb_file_direct_able(tb_file2fd(file)))
+    {
+        tb_hong_t offset = lseek(tb_file2fd(file), 0, SEEK_CUR);
+        if (offset >= 0) real = tb_file_direct_pwrit(tb_file2fd(file), data, size, offset);
+        if (real > 0 && lseek(tb_file2fd(file), offset + real, SEEK_SET) < 0) real = -1;
+    }
+#endif
+    return real;
 }
 tb_bool_t tb_file_sync(tb_file_ref_t file)
 {
@@ -251,7 +424,14 @@ tb_long_t tb_file_pread(tb_file_ref_t file, tb_byte_t* data, tb_size_t size, tb_
     tb_assert_and_check_return_val(file, -1);
 
     // read it
-#ifdef TB_CONFIG_POSIX_HAVE_PREAD64
+#ifdef TB_FILE_HAVE_DIRECT
+    tb_long_t real = tb_file_pread_impl(tb_file2fd(file), data, size, offset);
+
+    // read the unaligned data of the direct file
+    if (real < 0 && size && tb_file_direct_able(tb_file2fd(file)))
+        real = tb_file_direct_pread(tb_file2fd(file), data, size, offset);
+    return real;
+#elif defined(TB_CONFIG_POSIX_HAVE_PREAD64)
     return pread64(tb_file2fd(file), data, (size_t)size, offset);
 #else
     return pread(tb_file2fd(file), data, (size_t)size, offset);
@@ -263,7 +443,14 @@ tb_long_t tb_file_pwrit(tb_file_ref_t file, tb_byte_t const* data, tb_size_t siz
     tb_assert_and_check_return_val(file, -1);
 
     // writ it
-#ifdef TB_CONFIG_POSIX_HAVE_PWRITE64
+#ifdef TB_FILE_HAVE_DIRECT
+    tb_long_t real = tb_file_pwrit_impl(tb_file2fd(file), data, size, offset);
+
+    // writ the unaligned data of the direct file
+    if (real < 0 && size && tb_file_direct_able(tb_file2fd(file)))
+        real = tb_file_direct_pwrit(tb_file2fd(file), data, size, offset);
+    return real;
+#elif defined(TB_CONFIG_POSIX_HAVE_PWRITE64)
     return pwrite64(tb_file2fd(file), data, (size_t)size, offset);
 #else
     return pwrite(tb_file2fd(file), data, (size_t)size, offset);
@@ -403,6 +590,72 @@ tb_long_t tb_file_pwritv(tb_file_ref_t file, tb_iovec_t const* list, tb_size_t s
     return real;
 #endif
 }
+#ifdef TB_CONFIG_POSIX_HAVE_MMAP
+tb_byte_t const* tb_file_mmap(tb_file_ref_t file, tb_hize_t offset, tb_size_t size, tb_size_t advice)
+{
+    // check
+    tb_assert_and_check_return_val(file && size, tb_null);
+
+    // the offset of mmap() must be aligned by the page size
+    tb_size_t pagesize = tb_page_size();
+    tb_assert_and_check_return_val(pagesize, tb_null);
+    tb_size_t adjust = (tb_size_t)(offset & (pagesize - 1));
+
+    // map it
+    tb_byte_t* base = (tb_byte_t*)mmap(tb_null, size + adjust, PROT_READ, MAP_SHARED, tb_file2fd(file), (off_t)(offset - adjust));
+    tb_check_return_val(base != (tb_byte_t*)MAP_FAILED, tb_null);
+
+#ifdef TB_CONFIG_POSIX_HAVE_MADVISE
+    // advise it, it is only a hint
+    if (advice == TB_FILE_MMAP_ADVICE_SEQUENTIAL) madvise(base, size + adjust, MADV_SEQUENTIAL);
+    else if (advice == TB_FILE_MMAP_ADVICE_RANDOM) madvise(base, size + adjust, MADV_RANDOM);
+#endif
+
+    // ok
+    return base + adjust;
+}
+tb_bool_t tb_file_munmap(tb_byte_t const* data, tb_size_t size)
+{
+    // check
+    tb_assert_and_check_return_val(data && size, tb_false);
+
+    // get the page aligned base address
+    tb_size_t   pagesize = tb_page_size();
+    tb_assert_and_check_return_val(pagesize, tb_false);
+    tb_byte_t*  base = (tb_byte_t*)((tb_size_t)data & ~(pagesize - 1));
+
+    // unmap it
+    return !munmap(base, size + (data - base));
+}
+#else
+tb_byte_t const* tb_file_mmap(tb_file_ref_t file, tb_hize_t offset, tb_size_t size, tb_size_t advice)
+{
+    tb_trace_noimpl();
+    return tb_null;
+}
+tb_bool_t tb_file_munmap(tb_byte_t const* data, tb_size_t size)
+{
+    tb_trace_noimpl();
+    return tb_false;
+}
+#endif
+tb_bool_t tb_file_advise(tb_file_ref_t file, tb_hize_t offset, tb_hize_t size, tb_size_t advice)
+{
+    // check
+    tb_assert_and_check_return_val(file, tb_false);
+
+#ifdef TB_CONFIG_POSIX_HAVE_POSIX_FADVISE
+    // the advice
+    tb_int_t flag = POSIX_FADV_NORMAL;
+    if (advice == TB_FILE_MMAP_ADVICE_SEQUENTIAL) flag = POSIX_FADV_SEQUENTIAL;
+    else if (advice == TB_FILE_MMAP_ADVICE_RANDOM) flag = POSIX_FADV_RANDOM;
+
+    // advise it
+    return !posix_fadvise(tb_file2fd(file), (off_t)offset, (off_t)size, flag);
+#else
+    return tb_false;
+#endif
+}
 tb_bool_t tb_file_copy(tb_char_t const* path, tb_char_t const* dest, tb_size_t flags)
 {
     // check
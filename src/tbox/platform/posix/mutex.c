@@ -94,13 +94,19 @@ tb_void_t tb_mutex_exit(tb_mutex_ref_t mutex)
 }
 tb_bool_t tb_mutex_enter(tb_mutex_ref_t mutex)
 {
-    // try to enter for profiler
 #ifdef TB_LOCK_PROFILER_ENABLE
+    // try to enter for profiler
     if (tb_mutex_enter_try(mutex)) return tb_true;
-#endif
 
+    // wait it and profile the wait time
+    tb_hong_t ticks = tb_lock_profiler_ticks();
+    tb_bool_t ok = tb_mutex_enter_without_profiler(mutex);
+    if (ok) tb_lock_profiler_entered(tb_lock_profiler(), (tb_handle_t)mutex, tb_lock_profiler_ticks() - ticks);
+    return ok;
+#else
     // enter
     return tb_mutex_enter_without_profiler(mutex);
+#endif
 }
 tb_bool_t tb_mutex_enter_try(tb_mutex_ref_t mutex)
 {
@@ -120,6 +126,11 @@ tb_bool_t tb_mutex_leave(tb_mutex_ref_t mutex)
     // check, @note we cannot use asset/trace because them will use mutex
     tb_check_return_val(mutex, tb_false);
 
+#ifdef TB_LOCK_PROFILER_ENABLE
+    // profile the hold time
+    tb_lock_profiler_leave((tb_handle_t)mutex);
+#endif
+
     // leave
     return pthread_mutex_unlock((pthread_mutex_t*)mutex) == 0;
 }
@@ -265,3 +265,53 @@ tb_long_t tb_pipe_file_wait(tb_pipe_file_ref_t file, tb_size_t events, tb_long_t
     // we use poll/select to wait pipe/fd events
     return tb_socket_wait_impl((tb_socket_ref_t)file, events, timeout);
 }
+#ifdef TB_PIPE_FILE_HAVE_SPLICE
+static tb_long_t tb_pipe_file_splice(tb_int_t ifd, tb_int_t ofd, loff_t* offset, tb_size_t size)
+{
+    // splice it, SPLICE_F_MOVE is only a hint
+    tb_long_t real = splice(ifd, tb_null, ofd, offset, size, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+
+    // trace
+    tb_trace_d("splice: %d => %d, %lu => %ld, errno: %d", ifd, ofd, size, real, errno);
+
+    // ok?
+    if (real > 0) return real;
+
+    // end? the size is not zero and the pipe always has writer, so it only means that the socket has been closed
+    if (!real) return -1;
+
+    // continue?
+    if (errno == EINTR || errno == EAGAIN) return 0;
+
+    // error
+    return -1;
+}
+tb_long_t tb_pipe_file_splice_from_sock(tb_pipe_file_ref_t file, tb_socket_ref_t sock, tb_size_t size)
+{
+    // check
+    tb_assert_and_check_return_val(file && sock, -1);
+    tb_check_return_val(size, 0);
+
+    // splice it
+    return tb_pipe_file_splice(tb_sock2fd(sock), tb_pipefile2fd(file), tb_null, size);
+}
+tb_long_t tb_pipe_file_splice_to_sock(tb_pipe_file_ref_t file, tb_socket_ref_t sock, tb_size_t size)
+{
+    // check
+    tb_assert_and_check_return_val(file && sock, -1);
+    tb_check_return_val(size, 0);
+
+    // splice it
+    return tb_pipe_file_splice(tb_pipefile2fd(file), tb_sock2fd(sock), tb_null, size);
+}
+tb_long_t tb_pipe_file_splice_to_file(tb_pipe_file_ref_t file, tb_file_ref_t ofile, tb_hize_t offset, tb_size_t size)
+{
+    // check
+    tb_assert_and_check_return_val(file && ofile, -1);
+    tb_check_return_val(size, 0);
+
+    // splice it
+    loff_t seek = (loff_t)offset;
+    return tb_pipe_file_splice(tb_pipefile2fd(file), tb_file2fd(ofile), &seek, size);
+}
+#endif
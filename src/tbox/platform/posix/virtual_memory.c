@@ -24,8 +24,12 @@
  */
 #include "prefix.h"
 #include "../virtual_memory.h"
+#include "../page.h"
 #include "../../memory/impl/prefix.h"
 #include <sys/mman.h>
+#ifdef TB_CONFIG_POSIX_HAVE_MEMFD_CREATE
+#   include <unistd.h>
+#endif
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * macros
@@ -88,3 +92,65 @@ tb_bool_t tb_virtual_memory_free(tb_pointer_t data)
     return tb_true;
 }
 
+#ifdef TB_CONFIG_POSIX_HAVE_MEMFD_CREATE
+tb_size_t tb_virtual_memory_mirror_size(tb_size_t size)
+{
+    tb_size_t pagesize = tb_page_size();
+    tb_assert_and_check_return_val(pagesize, 0);
+    return tb_align(size, pagesize);
+}
+tb_pointer_t tb_virtual_memory_mirror_malloc(tb_size_t size)
+{
+    // check
+    tb_size_t pagesize = tb_page_size();
+    tb_assert_and_check_return_val(pagesize && size && size == tb_virtual_memory_mirror_size(size), tb_null);
+
+    // done
+    tb_int_t    fd = -1;
+    tb_byte_t*  base = MAP_FAILED;
+    tb_bool_t   ok = tb_false;
+    do
+    {
+        // make an anonymous memory file as the physical pages
+        fd = memfd_create("tbox_mirror", MFD_CLOEXEC);
+        tb_check_break(fd >= 0);
+        if (ftruncate(fd, (off_t)size) != 0) break;
+
+        /* reserve the address space of the double size and a readable leading page
+         *
+         * @note tb_pool_data_size() will read the data head before the data address when checking memory in debug mode
+         */
+        base = (tb_byte_t*)mmap(tb_null, pagesize + (size << 1), PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        tb_check_break(base != MAP_FAILED);
+
+        // map the same pages twice back-to-back
+        tb_byte_t* data = base + pagesize;
+        if (mmap(data, size, PROT_READ | PROT_WRITE, MAP_FIXED | MAP_SHARED, fd, 0) != data) break;
+        if (mmap(data + size, size, PROT_READ | PROT_WRITE, MAP_FIXED | MAP_SHARED, fd, 0) != data + size) break;
+
+        // ok
+        ok = tb_true;
+
+    } while (0);
+
+    // the mappings will keep the pages alive
+    if (fd >= 0) close(fd);
+
+    // failed?
+    if (!ok)
+    {
+        if (base != MAP_FAILED) munmap(base, pagesize + (size << 1));
+        return tb_null;
+    }
+    return base + pagesize;
+}
+tb_bool_t tb_virtual_memory_mirror_free(tb_pointer_t data, tb_size_t size)
+{
+    // check
+    tb_size_t pagesize = tb_page_size();
+    tb_assert_and_check_return_val(pagesize && size, tb_false);
+
+    // free it
+    return data? munmap((tb_byte_t*)data - pagesize, pagesize + (size << 1)) == 0 : tb_true;
+}
+#endif
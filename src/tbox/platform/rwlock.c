@@ -0,0 +1,346 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        rwlock.c
+ * @ingroup     platform
+ *
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * trace
+ */
+#define TB_TRACE_MODULE_NAME                "rwlock"
+#define TB_TRACE_MODULE_DEBUG               (0)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "rwlock.h"
+#include "cpu.h"
+#include "futex.h"
+#include "atomic.h"
+#include "thread.h"
+#include "futexlock.h"
+#include "native_memory.h"
+#include "thread_local.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the reader slots maxn
+#ifdef __tb_small__
+#   define TB_RWLOCK_SLOT_MAXN          (8)
+#else
+#   define TB_RWLOCK_SLOT_MAXN          (64)
+#endif
+
+// the maximum spinning count before waiting on the futex
+#define TB_RWLOCK_SPIN_MAXN             (128)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the reader slot type, it is aligned to the cache line to avoid false sharing
+typedef struct __tb_rwlock_slot_t
+{
+    // the readers count
+    tb_atomic32_t                       readers;
+
+    // the padding
+    tb_byte_t                           padding[TB_L1_CACHE_BYTES - sizeof(tb_atomic32_t)];
+
+}tb_rwlock_slot_t;
+
+// the rwlock type
+typedef struct __tb_rwlock_t
+{
+    // the writers lock, it is the first member to use the same address of the rwlock for the lock profiler
+    tb_futexlock_t                      lock;
+
+    // is writing? the readers will wait on it
+    tb_atomic32_t                       writer;
+
+    // the slots mask
+    tb_size_t                           mask;
+
+    // the reader slots
+    tb_rwlock_slot_t*                   slots;
+
+}tb_rwlock_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * globals
+ */
+
+// the next slot index for the new thread
+static tb_atomic32_t                    g_slot_next = 0;
+
+// the slot index of the current thread, index + 1
+#ifdef __tb_thread_local__
+static __tb_thread_local__ tb_size_t    g_slot_self = 0;
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static __tb_inline__ tb_rwlock_slot_t* tb_rwlock_slot(tb_rwlock_t* rwlock)
+{
+    /* we assign the reader slots to threads in turn, so the threads running on the different cpus
+     * will use the different slots if the threads count is not larger than the cpu count.
+     */
+#ifdef __tb_thread_local__
+    if (!g_slot_self) g_slot_self = (tb_size_t)tb_atomic32_fetch_and_add_explicit(&g_slot_next, 1, TB_ATOMIC_RELAXED) + 1;
+    return &rwlock->slots[(g_slot_self - 1) & rwlock->mask];
+#else
+    tb_size_t self = tb_thread_self();
+    return &rwlock->slots[((self >> 4) ^ (self >> 12)) & rwlock->mask];
+#endif
+}
+static __tb_inline__ tb_void_t tb_rwlock_slot_leave(tb_rwlock_t* rwlock, tb_rwlock_slot_t* slot)
+{
+    // wake up the waiting writer if we are the last reader of this slot
+    if (tb_atomic32_fetch_and_sub(&slot->readers, 1) == 1 && tb_atomic32_get(&rwlock->writer))
+        tb_futex_wake(&slot->readers, 1);
+}
+static tb_void_t tb_rwlock_wait_writer(tb_rwlock_t* rwlock)
+{
+    // spin shortly first
+    tb_size_t spin = tb_cpu_count() > 1? TB_RWLOCK_SPIN_MAXN : 0;
+    while (tb_atomic32_get(&rwlock->writer))
+    {
+        if (spin)
+        {
+#ifdef tb_cpu_pause
+            tb_cpu_pause();
+#endif
+            spin--;
+        }
+        else tb_futex_wait(&rwlock->writer, 1, -1);
+    }
+}
+static tb_bool_t tb_rwlock_wait_readers(tb_rwlock_t* rwlock)
+{
+    // wait all readers of all slots
+    tb_bool_t waited = tb_false;
+    tb_size_t i = 0;
+    tb_size_t n = rwlock->mask + 1;
+    tb_size_t spin = tb_cpu_count() > 1? TB_RWLOCK_SPIN_MAXN : 0;
+    for (i = 0; i < n; i++)
+    {
+        tb_int32_t readers;
+        tb_rwlock_slot_t* slot = &rwlock->slots[i];
+        while ((readers = tb_atomic32_get(&slot->readers)))
+        {
+            if (spin)
+            {
+#ifdef tb_cpu_pause
+                tb_cpu_pause();
+#endif
+                spin--;
+            }
+            else tb_futex_wait(&slot->readers, readers, -1);
+            waited = tb_true;
+        }
+    }
+    return waited;
+}
+static tb_void_t tb_rwlock_writer_leave(tb_rwlock_t* rwlock)
+{
+    // wake up all waiting readers
+    tb_atomic32_set(&rwlock->writer, 0);
+    tb_futex_wake(&rwlock->writer, (tb_size_t)-1);
+
+    // leave the writers lock
+    tb_futexlock_leave(&rwlock->lock);
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+tb_rwlock_ref_t tb_rwlock_init()
+{
+    // the slots count, it is the power of 2 and not less than the cpu count
+    tb_size_t count = 1;
+    tb_size_t ncpu = tb_cpu_count();
+    while (count < ncpu && count < TB_RWLOCK_SLOT_MAXN) count <<= 1;
+
+    // make rwlock with the aligned slots
+    tb_rwlock_t* rwlock = (tb_rwlock_t*)tb_native_memory_malloc0(sizeof(tb_rwlock_t) + (count + 1) * sizeof(tb_rwlock_slot_t));
+    tb_assert_and_check_return_val(rwlock, tb_null);
+
+    // init rwlock
+    tb_futexlock_init(&rwlock->lock);
+    tb_atomic32_init(&rwlock->writer, 0);
+    rwlock->mask    = count - 1;
+    rwlock->slots   = (tb_rwlock_slot_t*)tb_align((tb_size_t)(rwlock + 1), TB_L1_CACHE_BYTES);
+    return (tb_rwlock_ref_t)rwlock;
+}
+tb_void_t tb_rwlock_exit(tb_rwlock_ref_t self)
+{
+    // check
+    tb_rwlock_t* rwlock = (tb_rwlock_t*)self;
+    tb_assert_and_check_return(rwlock);
+
+    // exit lock
+    tb_futexlock_exit(&rwlock->lock);
+
+    // exit it
+    tb_native_memory_free((tb_pointer_t)rwlock);
+}
+tb_void_t tb_rwlock_enter_read(tb_rwlock_ref_t self)
+{
+    // check
+    tb_rwlock_t* rwlock = (tb_rwlock_t*)self;
+    tb_assert_and_check_return(rwlock);
+
+    // enter it
+#ifdef TB_LOCK_PROFILER_ENABLE
+    tb_hong_t ticks = 0;
+#endif
+    tb_rwlock_slot_t* slot = tb_rwlock_slot(rwlock);
+    while (1)
+    {
+        // no writer? we have entered it
+        tb_atomic32_fetch_and_add(&slot->readers, 1);
+        if (!tb_atomic32_get(&rwlock->writer)) break;
+
+        // back off for the writer
+        tb_rwlock_slot_leave(rwlock, slot);
+
+#ifdef TB_LOCK_PROFILER_ENABLE
+        // occupied
+        if (!ticks)
+        {
+            tb_lock_profiler_occupied(tb_lock_profiler(), (tb_pointer_t)rwlock);
+            ticks = tb_lock_profiler_ticks();
+        }
+#endif
+
+        // wait the writer
+        tb_rwlock_wait_writer(rwlock);
+    }
+
+#ifdef TB_LOCK_PROFILER_ENABLE
+    // profile the wait time
+    if (ticks) tb_lock_profiler_entered(tb_lock_profiler(), (tb_pointer_t)rwlock, tb_lock_profiler_ticks() - ticks);
+#endif
+}
+tb_bool_t tb_rwlock_enter_read_try(tb_rwlock_ref_t self)
+{
+    // check
+    tb_rwlock_t* rwlock = (tb_rwlock_t*)self;
+    tb_assert_and_check_return_val(rwlock, tb_false);
+
+    // no writer? we have entered it
+    tb_rwlock_slot_t* slot = tb_rwlock_slot(rwlock);
+    tb_atomic32_fetch_and_add(&slot->readers, 1);
+    if (!tb_atomic32_get(&rwlock->writer)) return tb_true;
+
+    // back off for the writer
+    tb_rwlock_slot_leave(rwlock, slot);
+
+#ifdef TB_LOCK_PROFILER_ENABLE
+    // occupied
+    tb_lock_profiler_occupied(tb_lock_profiler(), (tb_pointer_t)rwlock);
+#endif
+    return tb_false;
+}
+tb_void_t tb_rwlock_leave_read(tb_rwlock_ref_t self)
+{
+    // check
+    tb_rwlock_t* rwlock = (tb_rwlock_t*)self;
+    tb_assert_and_check_return(rwlock);
+
+#ifdef TB_LOCK_PROFILER_ENABLE
+    // profile the hold time
+    tb_lock_profiler_leave((tb_pointer_t)rwlock);
+#endif
+
+    // leave it
+    tb_rwlock_slot_leave(rwlock, tb_rwlock_slot(rwlock));
+}
+tb_void_t tb_rwlock_enter_write(tb_rwlock_ref_t self)
+{
+    // check
+    tb_rwlock_t* rwlock = (tb_rwlock_t*)self;
+    tb_assert_and_check_return(rwlock);
+
+    // enter the writers lock
+#ifdef TB_LOCK_PROFILER_ENABLE
+    tb_hong_t ticks = tb_lock_profiler_ticks();
+    tb_bool_t occupied = tb_false;
+#endif
+    if (!tb_futexlock_enter_try_without_profiler(&rwlock->lock))
+    {
+#ifdef TB_LOCK_PROFILER_ENABLE
+        tb_lock_profiler_occupied(tb_lock_profiler(), (tb_pointer_t)rwlock);
+        occupied = tb_true;
+#endif
+        tb_futexlock_enter_without_profiler(&rwlock->lock);
+    }
+
+    // block the new readers and wait the current readers
+    tb_atomic32_set(&rwlock->writer, 1);
+#ifdef TB_LOCK_PROFILER_ENABLE
+    if (tb_rwlock_wait_readers(rwlock)) occupied = tb_true;
+
+    // profile the wait time
+    if (occupied) tb_lock_profiler_entered(tb_lock_profiler(), (tb_pointer_t)rwlock, tb_lock_profiler_ticks() - ticks);
+#else
+    tb_rwlock_wait_readers(rwlock);
+#endif
+}
+tb_bool_t tb_rwlock_enter_write_try(tb_rwlock_ref_t self)
+{
+    // check
+    tb_rwlock_t* rwlock = (tb_rwlock_t*)self;
+    tb_assert_and_check_return_val(rwlock, tb_false);
+
+    // try to enter the writers lock
+    tb_bool_t ok = tb_false;
+    if (tb_futexlock_enter_try_without_profiler(&rwlock->lock))
+    {
+        // block the new readers
+        tb_atomic32_set(&rwlock->writer, 1);
+
+        // no readers?
+        tb_size_t i = 0;
+        tb_size_t n = rwlock->mask + 1;
+        for (i = 0; i < n && !tb_atomic32_get(&rwlock->slots[i].readers); i++) ;
+        ok = i == n;
+
+        // failed? leave it
+        if (!ok) tb_rwlock_writer_leave(rwlock);
+    }
+
+#ifdef TB_LOCK_PROFILER_ENABLE
+    // occupied
+    if (!ok) tb_lock_profiler_occupied(tb_lock_profiler(), (tb_pointer_t)rwlock);
+#endif
+    return ok;
+}
+tb_void_t tb_rwlock_leave_write(tb_rwlock_ref_t self)
+{
+    // check
+    tb_rwlock_t* rwlock = (tb_rwlock_t*)self;
+    tb_assert_and_check_return(rwlock);
+
+    // leave it
+    tb_rwlock_writer_leave(rwlock);
+}
@@ -0,0 +1,109 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        rwlock.h
+ * @ingroup     platform
+ *
+ */
+#ifndef TB_PLATFORM_RWLOCK_H
+#define TB_PLATFORM_RWLOCK_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+/// the rwlock ref type
+typedef __tb_typeref__(rwlock);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/*! init the reader-writer lock
+ *
+ * it is a "big reader" lock with the per-cpu reader counters, so the readers do not share
+ * the same cache line and the read side scales well, but the write side is more expensive.
+ * it prefers the writers and it is not recursive, so it is suitable for the read-mostly shared state.
+ *
+ * @note it is allocated from the native memory, so it can be kept after tb_exit() for the global state.
+ *
+ * @return          the rwlock
+ */
+tb_rwlock_ref_t     tb_rwlock_init(tb_noarg_t);
+
+/*! exit the rwlock
+ *
+ * @param lock      the rwlock
+ */
+tb_void_t           tb_rwlock_exit(tb_rwlock_ref_t lock);
+
+/*! enter the rwlock for reading
+ *
+ * @param lock      the rwlock
+ */
+tb_void_t           tb_rwlock_enter_read(tb_rwlock_ref_t lock);
+
+/*! try to enter the rwlock for reading
+ *
+ * @param lock      the rwlock
+ *
+ * @return          tb_true or tb_false
+ */
+tb_bool_t           tb_rwlock_enter_read_try(tb_rwlock_ref_t lock);
+
+/*! leave the rwlock for reading
+ *
+ * @param lock      the rwlock
+ */
+tb_void_t           tb_rwlock_leave_read(tb_rwlock_ref_t lock);
+
+/*! enter the rwlock for writing
+ *
+ * @param lock      the rwlock
+ */
+tb_void_t           tb_rwlock_enter_write(tb_rwlock_ref_t lock);
+
+/*! try to enter the rwlock for writing
+ *
+ * @param lock      the rwlock
+ *
+ * @return          tb_true or tb_false
+ */
+tb_bool_t           tb_rwlock_enter_write_try(tb_rwlock_ref_t lock);
+
+/*! leave the rwlock for writing
+ *
+ * @param lock      the rwlock
+ */
+tb_void_t           tb_rwlock_leave_write(tb_rwlock_ref_t lock);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
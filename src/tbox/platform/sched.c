@@ -30,6 +30,9 @@
  * includes
  */
 #include "sched.h"
+#if !defined(TB_CONFIG_OS_WINDOWS) && defined(TB_CONFIG_POSIX_HAVE_SCHED_GETCPU)
+#   include <sched.h>
+#endif
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * implementation
@@ -52,4 +55,11 @@ tb_bool_t tb_sched_getaffinity(tb_size_t pid, tb_cpuset_ref_t cpuset)
     return tb_false;
 }
 #endif
-
+tb_long_t tb_sched_getcpu()
+{
+#if !defined(TB_CONFIG_OS_WINDOWS) && defined(TB_CONFIG_POSIX_HAVE_SCHED_GETCPU)
+    return (tb_long_t)sched_getcpu();
+#else
+    return -1;
+#endif
+}
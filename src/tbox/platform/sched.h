@@ -99,6 +99,12 @@ tb_bool_t           tb_sched_setaffinity(tb_size_t pid, tb_cpuset_ref_t cpuset);
  */
 tb_bool_t           tb_sched_getaffinity(tb_size_t pid, tb_cpuset_ref_t cpuset);
 
+/*! get the cpu index of the current thread
+ *
+ * @return          the cpu index, -1 if it is not supported
+ */
+tb_long_t           tb_sched_getcpu(tb_noarg_t);
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * implementation
  */
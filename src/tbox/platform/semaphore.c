@@ -32,6 +32,8 @@
  */
 #if defined(TB_CONFIG_OS_WINDOWS)
 #   include "windows/semaphore.c"
+#elif defined(TB_CONFIG_OS_LINUX) || defined(TB_CONFIG_OS_ANDROID)
+#   include "linux/semaphore.c"
 #elif defined(TB_CONFIG_OS_MACOSX) || defined(TB_CONFIG_OS_IOS)
 #   include "mach/semaphore.c"
 #elif defined(TB_CONFIG_POSIX_HAVE_SEM_INIT)
@@ -0,0 +1,193 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        seqlock.h
+ * @ingroup     platform
+ *
+ */
+#ifndef TB_PLATFORM_SEQLOCK_H
+#define TB_PLATFORM_SEQLOCK_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+#include "cpu.h"
+#include "sched.h"
+#include "atomic.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the initial value
+#define TB_SEQLOCK_INIT             (0)
+
+// the maximum spinning count before yielding the current thread
+#define TB_SEQLOCK_SPIN_MAXN        (64)
+
+// the read barrier, the data reads only need be done before the next sequence load
+#if defined(__ATOMIC_ACQUIRE) && !defined(TB_CONFIG_MICRO_ENABLE)
+#   define tb_seqlock_read_barrier()  __atomic_thread_fence(__ATOMIC_ACQUIRE)
+#else
+#   define tb_seqlock_read_barrier()  tb_memory_barrier()
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+/*! the sequence lock type
+ *
+ * it is suitable for the small POD snapshots which are read frequently and written rarely,
+ * the readers never write the shared cache line and only retry if a writer has changed it.
+ *
+ * @code
+    tb_size_t seq;
+    do
+    {
+        seq = tb_seqlock_read_begin(&lock);
+        snapshot = data;
+
+    } while (tb_seqlock_read_retry(&lock, seq));
+ * @endcode
+ *
+ * @note the writers must not be blocked or yielded (e.g. coroutine switching) before leaving it.
+ */
+typedef tb_atomic32_t               tb_seqlock_t;
+
+/// the sequence lock ref type
+typedef tb_seqlock_t*               tb_seqlock_ref_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/*! init sequence lock
+ *
+ * @param lock      the lock
+ *
+ * @return          tb_true or tb_false
+ */
+static __tb_inline_force__ tb_bool_t tb_seqlock_init(tb_seqlock_ref_t lock)
+{
+    // check
+    tb_assert(lock);
+    tb_atomic32_set_explicit(lock, TB_SEQLOCK_INIT, TB_ATOMIC_RELAXED);
+    return tb_true;
+}
+
+/*! exit sequence lock
+ *
+ * @param lock      the lock
+ */
+static __tb_inline_force__ tb_void_t tb_seqlock_exit(tb_seqlock_ref_t lock)
+{
+    // check
+    tb_assert(lock);
+}
+
+/*! pause the current thread for waiting the writer
+ *
+ * @param spin      the spinning count
+ */
+static __tb_inline_force__ tb_void_t tb_seqlock_pause(tb_size_t* spin)
+{
+#if defined(tb_cpu_pause) && !defined(TB_CONFIG_MICRO_ENABLE)
+    if (*spin < TB_SEQLOCK_SPIN_MAXN && tb_cpu_count() > 1)
+    {
+        (*spin)++;
+        tb_cpu_pause();
+        return ;
+    }
+#endif
+    tb_sched_yield();
+}
+
+/*! begin to read the shared data
+ *
+ * @param lock      the lock
+ *
+ * @return          the sequence for tb_seqlock_read_retry()
+ */
+static __tb_inline_force__ tb_size_t tb_seqlock_read_begin(tb_seqlock_ref_t lock)
+{
+    // check
+    tb_assert(lock);
+
+    // wait the writer
+    tb_int32_t  seq;
+    tb_size_t   spin = 0;
+    while ((seq = tb_atomic32_get_explicit(lock, TB_ATOMIC_ACQUIRE)) & 1)
+        tb_seqlock_pause(&spin);
+    return (tb_size_t)(tb_uint32_t)seq;
+}
+
+/*! need read the shared data again? it has been changed by the writer
+ *
+ * @param lock      the lock
+ * @param seq       the sequence from tb_seqlock_read_begin()
+ *
+ * @return          tb_true or tb_false
+ */
+static __tb_inline_force__ tb_bool_t tb_seqlock_read_retry(tb_seqlock_ref_t lock, tb_size_t seq)
+{
+    // check
+    tb_assert(lock);
+
+    // the data reads must be done before checking the sequence
+    tb_seqlock_read_barrier();
+    return (tb_size_t)(tb_uint32_t)tb_atomic32_get_explicit(lock, TB_ATOMIC_RELAXED) != seq;
+}
+
+/*! enter sequence lock for writing, the multiple writers are serialized
+ *
+ * @param lock      the lock
+ */
+static __tb_inline_force__ tb_void_t tb_seqlock_write_enter(tb_seqlock_ref_t lock)
+{
+    // check
+    tb_assert(lock);
+
+    // make the sequence odd
+    tb_size_t spin = 0;
+    while (1)
+    {
+        tb_int32_t seq = tb_atomic32_get_explicit(lock, TB_ATOMIC_RELAXED);
+        if (!(seq & 1) && tb_atomic32_compare_and_swap_explicit(lock, &seq, seq + 1, TB_ATOMIC_ACQUIRE, TB_ATOMIC_RELAXED))
+            break;
+        tb_seqlock_pause(&spin);
+    }
+
+    // the data writes must be done after the sequence has been odd
+    tb_memory_barrier();
+}
+
+/*! leave sequence lock for writing
+ *
+ * @param lock      the lock
+ */
+static __tb_inline_force__ tb_void_t tb_seqlock_write_leave(tb_seqlock_ref_t lock)
+{
+    // check
+    tb_assert(lock);
+
+    // make the sequence even
+    tb_atomic32_fetch_and_add_explicit(lock, 1, TB_ATOMIC_RELEASE);
+}
+
+#endif
@@ -67,20 +67,15 @@ static __tb_inline_force__ tb_void_t tb_spinlock_exit(tb_spinlock_ref_t lock)
     tb_atomic_flag_clear_explicit(lock, TB_ATOMIC_RELAXED);
 }
 
-/*! enter spinlock
+/*! enter spinlock without the lock profiler
  *
  * @param lock      the lock
  */
-static __tb_inline_force__ tb_void_t tb_spinlock_enter(tb_spinlock_ref_t lock)
+static __tb_inline_force__ tb_void_t tb_spinlock_enter_without_profiler(tb_spinlock_ref_t lock)
 {
     // check
     tb_assert(lock);
 
-    // init occupied
-#ifdef TB_LOCK_PROFILER_ENABLE
-    tb_bool_t occupied = tb_false;
-#endif
-
     // get cpu count
 #if defined(tb_cpu_pause) && !defined(TB_CONFIG_MICRO_ENABLE)
     tb_size_t ncpu = tb_cpu_count();
@@ -96,21 +91,6 @@ static __tb_inline_force__ tb_void_t tb_spinlock_enter(tb_spinlock_ref_t lock)
         if (!tb_atomic_flag_test_noatomic(lock) && !tb_atomic_flag_test_and_set(lock))
             return ;
 
-#ifdef TB_LOCK_PROFILER_ENABLE
-        // occupied
-        if (!occupied)
-        {
-            // occupied++
-            occupied = tb_true;
-            tb_lock_profiler_occupied(tb_lock_profiler(), (tb_pointer_t)lock);
-
-            // dump backtrace
-#if 0//def __tb_debug__
-            tb_backtrace_dump("spinlock", tb_null, 10);
-#endif
-        }
-#endif
-
 #if defined(tb_cpu_pause) && !defined(TB_CONFIG_MICRO_ENABLE)
         if (ncpu > 1)
         {
@@ -142,40 +122,31 @@ static __tb_inline_force__ tb_void_t tb_spinlock_enter(tb_spinlock_ref_t lock)
     }
 }
 
-/*! enter spinlock without the lock profiler
+/*! enter spinlock
  *
  * @param lock      the lock
  */
-static __tb_inline_force__ tb_void_t tb_spinlock_enter_without_profiler(tb_spinlock_ref_t lock)
+static __tb_inline_force__ tb_void_t tb_spinlock_enter(tb_spinlock_ref_t lock)
 {
     // check
     tb_assert(lock);
 
-    // lock it
-#if defined(tb_cpu_pause) && !defined(TB_CONFIG_MICRO_ENABLE)
-    tb_size_t ncpu = tb_cpu_count();
-#endif
-    while (1)
+#ifdef TB_LOCK_PROFILER_ENABLE
+    // occupied?
+    if (tb_atomic_flag_test_noatomic(lock) || tb_atomic_flag_test_and_set(lock))
     {
-        if (!tb_atomic_flag_test_noatomic(lock) && !tb_atomic_flag_test_and_set(lock))
-            return ;
-
-#if defined(tb_cpu_pause) && !defined(TB_CONFIG_MICRO_ENABLE)
-        if (ncpu > 1)
-        {
-            tb_size_t i, n;
-            for (n = 1; n < 2048; n <<= 1)
-            {
-                for (i = 0; i < n; i++)
-                    tb_cpu_pause();
-
-                if (!tb_atomic_flag_test_noatomic(lock) && !tb_atomic_flag_test_and_set(lock))
-                    return ;
-            }
-        }
-#endif
-        tb_sched_yield();
+        // occupied++
+        tb_lock_profiler_ref_t profiler = tb_lock_profiler();
+        tb_lock_profiler_occupied(profiler, (tb_pointer_t)lock);
+
+        // wait it and profile the wait time
+        tb_hong_t ticks = tb_lock_profiler_ticks();
+        tb_spinlock_enter_without_profiler(lock);
+        tb_lock_profiler_entered(profiler, (tb_pointer_t)lock, tb_lock_profiler_ticks() - ticks);
     }
+#else
+    tb_spinlock_enter_without_profiler(lock);
+#endif
 }
 
 /*! try to enter spinlock
@@ -228,6 +199,11 @@ static __tb_inline_force__ tb_void_t tb_spinlock_leave(tb_spinlock_ref_t lock)
     // check
     tb_assert(lock);
 
+#ifdef TB_LOCK_PROFILER_ENABLE
+    // profile the contended hold time if it is sampled
+    tb_lock_profiler_leave((tb_pointer_t)lock);
+#endif
+
     // leave
     tb_atomic_flag_clear(lock);
 }
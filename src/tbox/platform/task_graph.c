@@ -0,0 +1,421 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        task_graph.c
+ * @ingroup     platform
+ *
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * trace
+ */
+#define TB_TRACE_MODULE_NAME                "task_graph"
+#define TB_TRACE_MODULE_DEBUG               (0)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "task_graph.h"
+#include "atomic.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the nodes grow
+#ifdef __tb_small__
+#   define TB_TASK_GRAPH_NODES_GROW         (16)
+#else
+#   define TB_TASK_GRAPH_NODES_GROW         (64)
+#endif
+
+// the successors grow
+#define TB_TASK_GRAPH_SUCCS_GROW            (4)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the task graph node type
+typedef struct __tb_task_graph_node_t
+{
+    // the graph
+    struct __tb_task_graph_t*       graph;
+
+    // the task name
+    tb_char_t const*                name;
+
+    // the task done func
+    tb_thread_pool_task_done_func_t done;
+
+    // the task private data
+    tb_cpointer_t                   priv;
+
+    // the successors
+    struct __tb_task_graph_node_t** succs;
+
+    // the successors count
+    tb_size_t                       succs_size;
+
+    // the successors maxn
+    tb_size_t                       succs_maxn;
+
+    // the dependencies count
+    tb_size_t                       indegree;
+
+    // the pending dependencies count of the current running
+    tb_atomic32_t                   pending;
+
+    // the next ready node in the local stack
+    struct __tb_task_graph_node_t*  ready;
+
+    // the task has been called?
+    tb_bool_t                       called;
+
+}tb_task_graph_node_t;
+
+// the task graph type
+typedef struct __tb_task_graph_t
+{
+    // the thread pool
+    tb_thread_pool_ref_t            pool;
+
+    // the nodes
+    tb_task_graph_node_t**          nodes;
+
+    // the nodes count
+    tb_size_t                       nodes_size;
+
+    // the nodes maxn
+    tb_size_t                       nodes_maxn;
+
+    // the remaining nodes count of the current running
+    tb_atomic_t                     remaining;
+
+    // has been canceled?
+    tb_atomic32_t                   canceled;
+
+    // the future of the current running
+    tb_future_ref_t                 future;
+
+}tb_task_graph_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static tb_void_t tb_task_graph_node_task_done(tb_thread_pool_worker_ref_t worker, tb_cpointer_t priv);
+static tb_void_t tb_task_graph_node_task_exit(tb_thread_pool_worker_ref_t worker, tb_cpointer_t priv);
+static __tb_inline__ tb_bool_t tb_task_graph_is_running(tb_task_graph_t* graph)
+{
+    return graph->future && tb_future_state(graph->future) == TB_STATE_WAITING;
+}
+static tb_bool_t tb_task_graph_node_post(tb_task_graph_t* graph, tb_task_graph_node_t* node)
+{
+    return tb_thread_pool_task_post(graph->pool, node->name, tb_task_graph_node_task_done, tb_task_graph_node_task_exit, node, tb_false);
+}
+static tb_void_t tb_task_graph_node_done(tb_thread_pool_worker_ref_t worker, tb_task_graph_node_t* node)
+{
+    // run this node and all ready successors
+    tb_task_graph_t*        graph = node->graph;
+    tb_task_graph_node_t*   stack = node;
+    node->ready = tb_null;
+    while (stack)
+    {
+        // pop the ready node
+        node  = stack;
+        stack = node->ready;
+
+        // done it if the graph has been not canceled
+        if (!tb_atomic32_get(&graph->canceled)) node->done(worker, node->priv);
+
+        /* update the successors
+         *
+         * we run the first ready successor directly on this worker to keep caches hot,
+         * and post the others to the local deque of this worker.
+         *
+         * the ready successors of the canceled graph are only skipped here.
+         */
+        tb_size_t               i = 0;
+        tb_task_graph_node_t*   next = tb_null;
+        for (i = 0; i < node->succs_size; i++)
+        {
+            tb_task_graph_node_t* succ = node->succs[i];
+            if (tb_atomic32_fetch_and_sub(&succ->pending, 1) == 1)
+            {
+                if (!next) next = succ;
+                else if (tb_atomic32_get(&graph->canceled) || !tb_task_graph_node_post(graph, succ))
+                {
+                    tb_atomic32_set(&graph->canceled, 1);
+                    succ->ready = stack;
+                    stack = succ;
+                }
+            }
+        }
+        if (next)
+        {
+            next->ready = stack;
+            stack = next;
+        }
+
+        // all nodes have been done? finish the graph
+        if (tb_atomic_fetch_and_sub(&graph->remaining, 1) == 1)
+        {
+            // the graph may be exited after finishing the future, so we cannot access it again
+            tb_assert(!stack);
+            if (tb_atomic32_get(&graph->canceled)) tb_future_cancel(graph->future);
+            else tb_future_set(graph->future, tb_null);
+            break;
+        }
+    }
+}
+static tb_void_t tb_task_graph_node_task_done(tb_thread_pool_worker_ref_t worker, tb_cpointer_t priv)
+{
+    // check
+    tb_task_graph_node_t* node = (tb_task_graph_node_t*)priv;
+    tb_assert_and_check_return(node);
+
+    // done it
+    node->called = tb_true;
+    tb_task_graph_node_done(worker, node);
+}
+static tb_void_t tb_task_graph_node_task_exit(tb_thread_pool_worker_ref_t worker, tb_cpointer_t priv)
+{
+    // check
+    tb_task_graph_node_t* node = (tb_task_graph_node_t*)priv;
+    tb_assert_and_check_return(node);
+
+    // this task has been killed? cancel the graph and skip the remaining nodes
+    if (!node->called)
+    {
+        tb_atomic32_set(&node->graph->canceled, 1);
+        tb_task_graph_node_done(worker, node);
+    }
+}
+static tb_bool_t tb_task_graph_check(tb_task_graph_t* graph)
+{
+    // no nodes?
+    tb_check_return_val(graph->nodes_size, tb_true);
+
+    // make the nodes queue
+    tb_task_graph_node_t** queue = tb_nalloc_type(graph->nodes_size, tb_task_graph_node_t*);
+    tb_assert_and_check_return_val(queue, tb_false);
+
+    // push all root nodes
+    tb_size_t i = 0;
+    tb_size_t head = 0;
+    tb_size_t tail = 0;
+    for (i = 0; i < graph->nodes_size; i++)
+    {
+        tb_task_graph_node_t* node = graph->nodes[i];
+        tb_atomic32_set_explicit(&node->pending, (tb_int32_t)node->indegree, TB_ATOMIC_RELAXED);
+        if (!node->indegree) queue[tail++] = node;
+    }
+
+    // visit all nodes in the topological order
+    while (head < tail)
+    {
+        tb_task_graph_node_t* node = queue[head++];
+        for (i = 0; i < node->succs_size; i++)
+        {
+            tb_task_graph_node_t* succ = node->succs[i];
+            if (tb_atomic32_fetch_and_sub_explicit(&succ->pending, 1, TB_ATOMIC_RELAXED) == 1)
+                queue[tail++] = succ;
+        }
+    }
+    tb_free(queue);
+
+    // all nodes have been visited? otherwise, it has a cycle
+    return tail == graph->nodes_size;
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+tb_task_graph_ref_t tb_task_graph_init(tb_thread_pool_ref_t pool)
+{
+    // the thread pool
+    if (!pool) pool = tb_thread_pool();
+    tb_assert_and_check_return_val(pool, tb_null);
+
+    // make graph
+    tb_task_graph_t* graph = tb_malloc0_type(tb_task_graph_t);
+    tb_assert_and_check_return_val(graph, tb_null);
+
+    // init graph
+    graph->pool = pool;
+    tb_atomic_init(&graph->remaining, 0);
+    tb_atomic32_init(&graph->canceled, 0);
+    return (tb_task_graph_ref_t)graph;
+}
+tb_void_t tb_task_graph_exit(tb_task_graph_ref_t self)
+{
+    // check
+    tb_task_graph_t* graph = (tb_task_graph_t*)self;
+    tb_assert_and_check_return(graph);
+
+    // it must be not running
+    tb_assert(!tb_task_graph_is_running(graph));
+
+    // exit nodes
+    tb_size_t i = 0;
+    for (i = 0; i < graph->nodes_size; i++)
+    {
+        tb_task_graph_node_t* node = graph->nodes[i];
+        if (node->succs) tb_free(node->succs);
+        tb_free(node);
+    }
+    if (graph->nodes) tb_free(graph->nodes);
+    graph->nodes = tb_null;
+
+    // exit future
+    if (graph->future) tb_future_exit(graph->future);
+    graph->future = tb_null;
+
+    // exit it
+    tb_free(graph);
+}
+tb_task_graph_node_ref_t tb_task_graph_node(tb_task_graph_ref_t self, tb_char_t const* name, tb_thread_pool_task_done_func_t done, tb_cpointer_t priv)
+{
+    // check
+    tb_task_graph_t* graph = (tb_task_graph_t*)self;
+    tb_assert_and_check_return_val(graph && done && !tb_task_graph_is_running(graph), tb_null);
+
+    // grow nodes
+    if (graph->nodes_size >= graph->nodes_maxn)
+    {
+        tb_size_t               maxn = graph->nodes_maxn + TB_TASK_GRAPH_NODES_GROW;
+        tb_task_graph_node_t**  nodes = tb_ralloc_type(graph->nodes, maxn, tb_task_graph_node_t*);
+        tb_assert_and_check_return_val(nodes, tb_null);
+        graph->nodes        = nodes;
+        graph->nodes_maxn   = maxn;
+    }
+
+    // make node
+    tb_task_graph_node_t* node = tb_malloc0_type(tb_task_graph_node_t);
+    tb_assert_and_check_return_val(node, tb_null);
+
+    // init node
+    node->graph = graph;
+    node->name  = name;
+    node->done  = done;
+    node->priv  = priv;
+    tb_atomic32_init(&node->pending, 0);
+
+    // save node
+    graph->nodes[graph->nodes_size++] = node;
+    return (tb_task_graph_node_ref_t)node;
+}
+tb_bool_t tb_task_graph_depend(tb_task_graph_ref_t self, tb_task_graph_node_ref_t node_ref, tb_task_graph_node_ref_t dependency_ref)
+{
+    // check
+    tb_task_graph_t*        graph = (tb_task_graph_t*)self;
+    tb_task_graph_node_t*   node = (tb_task_graph_node_t*)node_ref;
+    tb_task_graph_node_t*   dependency = (tb_task_graph_node_t*)dependency_ref;
+    tb_assert_and_check_return_val(graph && node && dependency && node != dependency, tb_false);
+    tb_assert_and_check_return_val(node->graph == graph && dependency->graph == graph && !tb_task_graph_is_running(graph), tb_false);
+
+    // grow successors
+    if (dependency->succs_size >= dependency->succs_maxn)
+    {
+        tb_size_t               maxn = dependency->succs_maxn + TB_TASK_GRAPH_SUCCS_GROW;
+        tb_task_graph_node_t**  succs = tb_ralloc_type(dependency->succs, maxn, tb_task_graph_node_t*);
+        tb_assert_and_check_return_val(succs, tb_false);
+        dependency->succs       = succs;
+        dependency->succs_maxn  = maxn;
+    }
+
+    // add this node to the successors of the dependent node
+    dependency->succs[dependency->succs_size++] = node;
+    node->indegree++;
+    return tb_true;
+}
+tb_bool_t tb_task_graph_run(tb_task_graph_ref_t self)
+{
+    // check
+    tb_task_graph_t* graph = (tb_task_graph_t*)self;
+    tb_assert_and_check_return_val(graph && !tb_task_graph_is_running(graph), tb_false);
+
+    // has a cycle?
+    if (!tb_task_graph_check(graph))
+    {
+        tb_trace_e("the task graph has a cycle!");
+        return tb_false;
+    }
+
+    // init a new future
+    if (graph->future) tb_future_exit(graph->future);
+    graph->future = tb_future_init(graph->pool);
+    tb_assert_and_check_return_val(graph->future, tb_false);
+
+    // no nodes? finish it directly
+    if (!graph->nodes_size)
+    {
+        tb_future_set(graph->future, tb_null);
+        return tb_true;
+    }
+
+    // reset all nodes
+    tb_size_t i = 0;
+    for (i = 0; i < graph->nodes_size; i++)
+    {
+        tb_task_graph_node_t* node = graph->nodes[i];
+        node->called = tb_false;
+        tb_atomic32_set_explicit(&node->pending, (tb_int32_t)node->indegree, TB_ATOMIC_RELAXED);
+    }
+    tb_atomic32_set(&graph->canceled, 0);
+    tb_atomic_set(&graph->remaining, graph->nodes_size);
+
+    // count the root nodes
+    tb_size_t roots = 0;
+    for (i = 0; i < graph->nodes_size; i++)
+    {
+        if (!graph->nodes[i]->indegree) roots++;
+    }
+
+    // post all root nodes, the graph may be finished and exited after the last root node has been posted
+    for (i = 0; i < graph->nodes_size && roots; i++)
+    {
+        tb_task_graph_node_t* node = graph->nodes[i];
+        tb_check_continue(!node->indegree);
+
+        // skip it directly if the graph has been canceled, otherwise post it
+        roots--;
+        if (tb_atomic32_get(&graph->canceled) || !tb_task_graph_node_post(graph, node))
+        {
+            tb_atomic32_set(&graph->canceled, 1);
+            tb_task_graph_node_done(tb_null, node);
+        }
+    }
+    return tb_true;
+}
+tb_long_t tb_task_graph_wait(tb_task_graph_ref_t self, tb_long_t timeout)
+{
+    // check
+    tb_task_graph_t* graph = (tb_task_graph_t*)self;
+    tb_assert_and_check_return_val(graph && graph->future, -1);
+
+    // wait it
+    return tb_future_wait(graph->future, timeout);
+}
+tb_future_ref_t tb_task_graph_future(tb_task_graph_ref_t self)
+{
+    // check
+    tb_task_graph_t* graph = (tb_task_graph_t*)self;
+    tb_assert_and_check_return_val(graph, tb_null);
+
+    return graph->future;
+}
@@ -0,0 +1,136 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        task_graph.h
+ * @ingroup     platform
+ *
+ */
+#ifndef TB_PLATFORM_TASK_GRAPH_H
+#define TB_PLATFORM_TASK_GRAPH_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+#include "future.h"
+#include "thread_pool.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+/// the task graph ref type
+typedef __tb_typeref__(task_graph);
+
+/// the task graph node ref type
+typedef __tb_typeref__(task_graph_node);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/*! init the task graph, it is a dependency graph executor on the thread pool
+ *
+ * @code
+    tb_task_graph_ref_t graph = tb_task_graph_init(tb_null);
+    if (graph)
+    {
+        tb_task_graph_node_ref_t parse     = tb_task_graph_node(graph, "parse", parse_done, priv);
+        tb_task_graph_node_ref_t transform = tb_task_graph_node(graph, "transform", transform_done, priv);
+        tb_task_graph_node_ref_t compress  = tb_task_graph_node(graph, "compress", compress_done, priv);
+        tb_task_graph_depend(graph, transform, parse);
+        tb_task_graph_depend(graph, compress, transform);
+        if (tb_task_graph_run(graph)) tb_task_graph_wait(graph, -1);
+        tb_task_graph_exit(graph);
+    }
+ * @endcode
+ *
+ * @param pool              the thread pool, using the default pool if be null
+ *
+ * @return                  the task graph
+ */
+tb_task_graph_ref_t         tb_task_graph_init(tb_thread_pool_ref_t pool);
+
+/*! exit the task graph, it must be not running
+ *
+ * @param graph             the task graph
+ */
+tb_void_t                   tb_task_graph_exit(tb_task_graph_ref_t graph);
+
+/*! add a task node to the graph
+ *
+ * @param graph             the task graph
+ * @param name              the task name, optional
+ * @param done              the task done func
+ * @param priv              the task private data
+ *
+ * @return                  the task node
+ */
+tb_task_graph_node_ref_t    tb_task_graph_node(tb_task_graph_ref_t graph, tb_char_t const* name, tb_thread_pool_task_done_func_t done, tb_cpointer_t priv);
+
+/*! the given node will be run after the dependent node has been done
+ *
+ * @param graph             the task graph
+ * @param node              the task node
+ * @param dependency        the dependent task node
+ *
+ * @return                  tb_true or tb_false
+ */
+tb_bool_t                   tb_task_graph_depend(tb_task_graph_ref_t graph, tb_task_graph_node_ref_t node, tb_task_graph_node_ref_t dependency);
+
+/*! run all task nodes of the graph
+ *
+ * the root nodes will be posted to the thread pool, and the first ready successor of the done node
+ * will be run on the same worker directly to keep caches hot, the other ready successors will be
+ * posted to the local deque of this worker.
+ *
+ * @param graph             the task graph
+ *
+ * @return                  tb_true or tb_false if it is running or has a cycle
+ */
+tb_bool_t                   tb_task_graph_run(tb_task_graph_ref_t graph);
+
+/*! wait the task graph
+ *
+ * @param graph             the task graph
+ * @param timeout           the timeout
+ *
+ * @return                  ok: 1, timeout: 0, canceled or error: -1
+ */
+tb_long_t                   tb_task_graph_wait(tb_task_graph_ref_t graph, tb_long_t timeout);
+
+/*! the future of the current running, it can be continued with tb_future_then() or tb_future_when_all()
+ *
+ * @note it is owned by the graph and it will be released after the next running or exiting the graph
+ *
+ * @param graph             the task graph
+ *
+ * @return                  the future, tb_null if the graph has been not run
+ */
+tb_future_ref_t             tb_task_graph_future(tb_task_graph_ref_t graph);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
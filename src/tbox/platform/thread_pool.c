@@ -53,27 +53,39 @@
 #   define TB_THREAD_POOL_JOBS_POOL_GROW        (512)
 #endif
 
-// the working jobs grow
+// the jobs waiting maxn
 #ifdef __tb_small__
-#   define TB_THREAD_POOL_JOBS_WORKING_GROW     (32)
+#   define TB_THREAD_POOL_JOBS_WAITING_MAXN     (1 << 16)
 #else
-#   define TB_THREAD_POOL_JOBS_WORKING_GROW     (64)
+#   define TB_THREAD_POOL_JOBS_WAITING_MAXN     (1 << 20)
 #endif
 
-// the jobs waiting maxn
+// the cached free jobs maxn of each worker
 #ifdef __tb_small__
-#   define TB_THREAD_POOL_JOBS_WAITING_MAXN     (1 << 16)
+#   define TB_THREAD_POOL_JOBS_CACHE_MAXN       (32)
 #else
-#   define TB_THREAD_POOL_JOBS_WAITING_MAXN     (1 << 20)
+#   define TB_THREAD_POOL_JOBS_CACHE_MAXN       (128)
 #endif
 
-// the pull jobs time maxn
+// the deque size of each worker, must be power of 2
 #ifdef __tb_small__
-#   define TB_THREAD_POOL_JOBS_PULL_TIME_MAXN   (10000)
+#   define TB_THREAD_POOL_DEQUE_SIZE            (1024)
 #else
-#   define TB_THREAD_POOL_JOBS_PULL_TIME_MAXN   (20000)
+#   define TB_THREAD_POOL_DEQUE_SIZE            (4096)
 #endif
 
+// the deque mask
+#define TB_THREAD_POOL_DEQUE_MASK               (TB_THREAD_POOL_DEQUE_SIZE - 1)
+
+// the shards count of the injection queue, must be power of 2
+#define TB_THREAD_POOL_SHARD_MAXN               (8)
+
+// the shard mask
+#define TB_THREAD_POOL_SHARD_MASK               (TB_THREAD_POOL_SHARD_MAXN - 1)
+
+// the maximum count of the jobs pulled from the injection queue at once
+#define TB_THREAD_POOL_SHARD_PULL_MAXN          (32)
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * types
  */
@@ -97,21 +109,100 @@ typedef struct __tb_thread_pool_job_t
      */
     tb_atomic32_t                       state;
 
-    // the entry
+    // the worker group
+    struct __tb_thread_pool_group_t*    group;
+
+    // the entry of the injection queue
     tb_list_entry_t                     entry;
 
 }tb_thread_pool_job_t;
 
-// the thread pool job stats type
-typedef struct __tb_thread_pool_job_stats_t
+/* the work-stealing deque (chase-lev) of the worker
+ *
+ * <pre>
+ *
+ *          steal <-  top                    bottom  <-> push/pop (owner)
+ *                     |                       |
+ * jobs:   |-----|-----|-----|-----|-----|-----|-----|-----|
+ *
+ * </pre>
+ *
+ * only the owner worker can push and pop jobs at the bottom (lifo),
+ * and the other idle workers steal jobs from the top (fifo) without lock.
+ */
+typedef struct __tb_thread_pool_deque_t
 {
-    // the done count
-    tb_size_t                           done_count;
+    // the top, it is modified by the stealers
+    tb_atomic_t                         top;
+
+    // the padding to avoid the false sharing between top and bottom
+    tb_byte_t                           padding[TB_L1_CACHE_BYTES];
 
-    // the done total time
-    tb_hize_t                           total_time;
+    // the bottom, it is only modified by the owner
+    tb_atomic_t                         bottom;
+
+    // the jobs
+    tb_atomic_t                         jobs[TB_THREAD_POOL_DEQUE_SIZE];
+
+}tb_thread_pool_deque_t;
+
+// the injection queue shard type
+typedef struct __tb_thread_pool_shard_t
+{
+    // the lock
+    tb_futexlock_t                      lock;
+
+    // the jobs count of this shard, we can check it without lock
+    tb_atomic_t                         size;
+
+    // the urgent jobs
+    tb_list_entry_head_t                jobs_urgent;
+
+    // the waiting jobs
+    tb_list_entry_head_t                jobs_waiting;
+
+}tb_thread_pool_shard_t;
+
+// the thread pool worker group type
+typedef struct __tb_thread_pool_group_t
+{
+    // the group name
+    tb_char_t                           name[32];
 
-}tb_thread_pool_job_stats_t;
+    // the group index
+    tb_size_t                           index;
+
+    // the cpu set of the workers, no affinity if it is empty
+    tb_cpuset_t                         cpuset;
+
+    // the first worker index in the worker list
+    tb_size_t                           worker_base;
+
+    // the worker maxn
+    tb_size_t                           worker_maxn;
+
+    // the worker size
+    tb_atomic_t                         worker_size;
+
+    // the idle workers count
+    tb_atomic_t                         idle;
+
+    // the semaphore
+    tb_semaphore_ref_t                  semaphore;
+
+    // the alive jobs count of this group
+    tb_percpu_counter_t                 jobs_count;
+
+    // the urgent jobs count in the injection queue
+    tb_atomic_t                         jobs_urgent;
+
+    // the next shard for posting jobs from the external threads
+    tb_atomic_t                         shard_next;
+
+    // the injection queue shards
+    tb_thread_pool_shard_t              shards[TB_THREAD_POOL_SHARD_MAXN];
+
+}tb_thread_pool_group_t;
 
 // the thread pool worker priv type
 typedef struct __tb_thread_pool_worker_priv_t
@@ -133,17 +224,23 @@ typedef struct __tb_thread_pool_worker_t
     // the thread pool
     tb_thread_pool_ref_t                pool;
 
+    // the worker group
+    tb_thread_pool_group_t*             group;
+
     // the loop
     tb_thread_ref_t                     loop;
 
-    // the jobs
-    tb_vector_ref_t                     jobs;
+    // the deque
+    tb_thread_pool_deque_t*             deque;
 
-    // the pull time
-    tb_size_t                           pull;
+    // the random seed for choosing the victim worker
+    tb_uint32_t                         seed;
 
-    // the stats
-    tb_hash_map_ref_t                   stats;
+    // the cached free jobs count
+    tb_size_t                           cache_size;
+
+    // the cached free jobs, we can reuse them without the pool lock
+    tb_thread_pool_job_t*               cache[TB_THREAD_POOL_JOBS_CACHE_MAXN];
 
     // is stoped?
     tb_atomic_flag_t                    bstoped;
@@ -159,38 +256,53 @@ typedef struct __tb_thread_pool_impl_t
     // the thread stack size
     tb_size_t                           stack;
 
-    // the worker maxn
+    // the worker maxn of all groups
     tb_size_t                           worker_maxn;
 
-    // the lock
-    tb_spinlock_t                       lock;
+    // the lock for the jobs pool and the workers
+    tb_futexlock_t                      lock;
 
     // the jobs pool
     tb_fixed_pool_ref_t                 jobs_pool;
 
-    // the urgent jobs
-    tb_list_entry_head_t                jobs_urgent;
+    // the alive jobs count
+    tb_percpu_counter_t                 jobs_count;
 
-    // the waiting jobs
-    tb_list_entry_head_t                jobs_waiting;
+    // is stoped
+    tb_atomic_flag_t                    bstoped;
 
-    // the pending jobs
-    tb_list_entry_head_t                jobs_pending;
+    /* the worker groups
+     *
+     * the first numa_count groups are the default groups (one group per numa node in numa mode),
+     * and the next groups are the named groups
+     */
+    tb_thread_pool_group_t              groups[TB_THREAD_POOL_GROUP_MAXN];
 
-    // is stoped
-    tb_bool_t                           bstoped;
+    // the worker groups count
+    tb_size_t                           group_count;
 
-    // the semaphore
-    tb_semaphore_ref_t                  semaphore;
+    // the default groups count
+    tb_size_t                           numa_count;
 
-    // the worker size
-    tb_size_t                           worker_size;
+    // the next default group for posting jobs from the unknown cpu
+    tb_atomic_t                         numa_next;
 
     // the worker list
     tb_thread_pool_worker_t             worker_list[TB_THREAD_POOL_WORKER_MAXN];
 
 }tb_thread_pool_impl_t;
 
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * globals
+ */
+
+// the current worker
+#ifdef __tb_thread_local__
+static __tb_thread_local__ tb_thread_pool_worker_t* g_worker_self = tb_null;
+#else
+static tb_thread_local_t                            g_worker_self = TB_THREAD_LOCAL_INIT;
+#endif
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * instance implementation
  */
@@ -216,365 +328,614 @@ static tb_void_t tb_thread_pool_instance_kill(tb_handle_t pool, tb_cpointer_t pr
 }
 
 /* //////////////////////////////////////////////////////////////////////////////////////
- * worker implementation
+ * deque implementation
  */
-static tb_bool_t tb_thread_pool_worker_walk_pull(tb_iterator_ref_t iterator, tb_cpointer_t item, tb_cpointer_t value, tb_bool_t* is_break)
+static tb_bool_t tb_thread_pool_deque_push(tb_thread_pool_deque_t* deque, tb_thread_pool_job_t* job)
 {
-    // the worker pull
-    tb_thread_pool_worker_t* worker = (tb_thread_pool_worker_t*)value;
-    tb_assert(worker && worker->jobs && worker->stats && is_break);
-
     // full?
-    if (worker->pull >= TB_THREAD_POOL_JOBS_PULL_TIME_MAXN)
+    tb_long_t b = tb_atomic_get_explicit(&deque->bottom, TB_ATOMIC_RELAXED);
+    tb_long_t t = tb_atomic_get_explicit(&deque->top, TB_ATOMIC_ACQUIRE);
+    tb_check_return_val(b - t < TB_THREAD_POOL_DEQUE_SIZE, tb_false);
+
+    // push it to the bottom
+    tb_atomic_set_explicit(&deque->jobs[b & TB_THREAD_POOL_DEQUE_MASK], (tb_long_t)job, TB_ATOMIC_RELAXED);
+    tb_atomic_set_explicit(&deque->bottom, b + 1, TB_ATOMIC_RELEASE);
+    return tb_true;
+}
+static tb_thread_pool_job_t* tb_thread_pool_deque_pop(tb_thread_pool_deque_t* deque)
+{
+    // reserve the bottom job first
+    tb_long_t b = tb_atomic_get_explicit(&deque->bottom, TB_ATOMIC_RELAXED) - 1;
+    tb_atomic_set_explicit(&deque->bottom, b, TB_ATOMIC_RELAXED);
+    tb_memory_barrier();
+    tb_long_t t = tb_atomic_get_explicit(&deque->top, TB_ATOMIC_RELAXED);
+
+    // empty?
+    tb_thread_pool_job_t* job = tb_null;
+    if (t <= b)
     {
-        // break it
-        *is_break = tb_true;
-        return tb_false;
+        // get the bottom job
+        job = (tb_thread_pool_job_t*)tb_atomic_get_explicit(&deque->jobs[b & TB_THREAD_POOL_DEQUE_MASK], TB_ATOMIC_RELAXED);
+
+        // it's the last job? we need race with the stealers
+        if (t == b)
+        {
+            if (!tb_atomic_compare_and_swap_explicit(&deque->top, &t, t + 1, TB_ATOMIC_SEQ_CST, TB_ATOMIC_RELAXED))
+                job = tb_null;
+            tb_atomic_set_explicit(&deque->bottom, b + 1, TB_ATOMIC_RELAXED);
+        }
     }
+    else tb_atomic_set_explicit(&deque->bottom, b + 1, TB_ATOMIC_RELAXED);
+    return job;
+}
+static tb_thread_pool_job_t* tb_thread_pool_deque_steal(tb_thread_pool_deque_t* deque)
+{
+    // empty?
+    tb_long_t t = tb_atomic_get_explicit(&deque->top, TB_ATOMIC_ACQUIRE);
+    tb_memory_barrier();
+    tb_long_t b = tb_atomic_get_explicit(&deque->bottom, TB_ATOMIC_ACQUIRE);
+    tb_check_return_val(t < b, tb_null);
+
+    // steal the top job, it may be failed if other workers have stolen it
+    tb_thread_pool_job_t* job = (tb_thread_pool_job_t*)tb_atomic_get_explicit(&deque->jobs[t & TB_THREAD_POOL_DEQUE_MASK], TB_ATOMIC_RELAXED);
+    return tb_atomic_compare_and_swap_explicit(&deque->top, &t, t + 1, TB_ATOMIC_SEQ_CST, TB_ATOMIC_RELAXED)? job : tb_null;
+}
+static __tb_inline__ tb_size_t tb_thread_pool_deque_size(tb_thread_pool_deque_t* deque)
+{
+    tb_long_t size = tb_atomic_get(&deque->bottom) - tb_atomic_get(&deque->top);
+    return size > 0? (tb_size_t)size : 0;
+}
 
-    // the job
-    tb_thread_pool_job_t* job = (tb_thread_pool_job_t*)item;
-    tb_assert(job);
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * group implementation
+ */
+static tb_thread_pool_group_t* tb_thread_pool_group_get(tb_thread_pool_impl_t* impl, tb_thread_pool_worker_t* worker, tb_size_t group)
+{
+    // the named group?
+    if (group != TB_THREAD_POOL_GROUP_DEFAULT)
+    {
+        tb_size_t index = impl->numa_count + group - 1;
+        return index < impl->group_count? &impl->groups[index] : tb_null;
+    }
 
-    // the pool
-    tb_thread_pool_impl_t* impl = (tb_thread_pool_impl_t*)worker->pool;
-    tb_assert(impl);
+    // only one default group?
+    if (impl->numa_count == 1) return &impl->groups[0];
 
-    // append the job to the pending jobs
-    tb_list_entry_insert_tail(&impl->jobs_pending, &job->entry);
+    // the default group of the current worker
+    if (worker && worker->group->index < impl->numa_count) return worker->group;
 
-    // append the job to the working jobs
-    tb_vector_insert_tail(worker->jobs, job);
+    // the default group of the current numa node
+    tb_size_t i = 0;
+    tb_long_t cpu = tb_sched_getcpu();
+    if (cpu >= 0 && cpu < TB_CPUSET_SIZE)
+    {
+        for (i = 0; i < impl->numa_count; i++)
+        {
+            if (TB_CPUSET_ISSET(cpu, &impl->groups[i].cpuset))
+                return &impl->groups[i];
+        }
+    }
 
-    // computate the job average time
-    tb_size_t average_time = 200;
-    if (tb_hash_map_size(worker->stats))
+    // unknown cpu? we distribute jobs to all default groups
+    return &impl->groups[(tb_size_t)tb_atomic_fetch_and_add(&impl->numa_next, 1) % impl->numa_count];
+}
+static tb_bool_t tb_thread_pool_group_init(tb_thread_pool_impl_t* impl, tb_char_t const* name, tb_size_t worker_maxn, tb_cpuset_ref_t cpuset)
+{
+    // check
+    tb_assert_and_check_return_val(impl->group_count < TB_THREAD_POOL_GROUP_MAXN, tb_false);
+
+    // no more workers?
+    tb_size_t worker_base = impl->worker_maxn;
+    tb_assert_and_check_return_val(worker_base < TB_THREAD_POOL_WORKER_MAXN, tb_false);
+
+    // init group
+    tb_thread_pool_group_t* group = &impl->groups[impl->group_count];
+    tb_strlcpy(group->name, name, sizeof(group->name));
+    group->index        = impl->group_count;
+    group->worker_base  = worker_base;
+    group->worker_maxn  = tb_min(tb_max(worker_maxn, 1), TB_THREAD_POOL_WORKER_MAXN - worker_base);
+    if (cpuset) group->cpuset = *cpuset;
+    else TB_CPUSET_ZERO(&group->cpuset);
+    tb_atomic_init(&group->worker_size, 0);
+    tb_atomic_init(&group->idle, 0);
+    tb_percpu_counter_init(&group->jobs_count, 0, 0);
+    tb_atomic_init(&group->jobs_urgent, 0);
+    tb_atomic_init(&group->shard_next, 0);
+    impl->worker_maxn += group->worker_maxn;
+
+    // we need exit this group if the remaining initialization failed
+    impl->group_count++;
+
+    // init the injection queue shards
+    tb_size_t i = 0;
+    for (i = 0; i < TB_THREAD_POOL_SHARD_MAXN; i++)
     {
-        tb_thread_pool_job_stats_t* stats = (tb_thread_pool_job_stats_t*)tb_hash_map_get(worker->stats, job->task.done);
-        if (stats && stats->done_count) average_time = (tb_size_t)(stats->total_time / stats->done_count);
+        tb_thread_pool_shard_t* shard = &group->shards[i];
+        if (!tb_futexlock_init(&shard->lock)) return tb_false;
+        tb_atomic_init(&shard->size, 0);
+        tb_list_entry_init(&shard->jobs_urgent, tb_thread_pool_job_t, entry, tb_null);
+        tb_list_entry_init(&shard->jobs_waiting, tb_thread_pool_job_t, entry, tb_null);
+
+        // register lock profiler
+#ifdef TB_LOCK_PROFILER_ENABLE
+        tb_lock_profiler_register(tb_lock_profiler(), (tb_pointer_t)&shard->lock, TB_TRACE_MODULE_NAME);
+#endif
     }
 
-    // update the pull time
-    worker->pull += average_time;
+    // init semaphore
+    group->semaphore = tb_semaphore_init(0);
+    tb_assert_and_check_return_val(group->semaphore, tb_false);
 
     // trace
-    tb_trace_d("worker[%lu]: pull: task[%p:%s] from %s", worker->id, job->task.done, job->task.name, iterator == tb_list_entry_itor(&impl->jobs_waiting)? "waiting" : "urgent");
+    tb_trace_d("group[%s]: init: workers: %lu, cpus: %d", group->name, group->worker_maxn, TB_CPUSET_COUNT(&group->cpuset));
 
-    // remove the job from the waiting or urgent jobs
+    // ok
     return tb_true;
 }
-static tb_bool_t tb_thread_pool_worker_walk_pull_and_clean(tb_iterator_ref_t iterator, tb_cpointer_t item, tb_cpointer_t value)
+static tb_void_t tb_thread_pool_group_exit(tb_thread_pool_group_t* group)
 {
-    // the worker pull
-    tb_thread_pool_worker_t* worker = (tb_thread_pool_worker_t*)value;
-    tb_assert(worker && worker->jobs && worker->stats);
+    // exit the injection queue shards
+    tb_size_t i = 0;
+    for (i = 0; i < TB_THREAD_POOL_SHARD_MAXN; i++)
+    {
+        tb_thread_pool_shard_t* shard = &group->shards[i];
+        tb_list_entry_exit(&shard->jobs_urgent);
+        tb_list_entry_exit(&shard->jobs_waiting);
+        tb_futexlock_exit(&shard->lock);
+    }
 
-    // the job
-    tb_thread_pool_job_t* job = (tb_thread_pool_job_t*)item;
-    tb_assert(job);
+    // exit semaphore
+    if (group->semaphore) tb_semaphore_exit(group->semaphore);
+    group->semaphore = tb_null;
 
-    // the job state
-    tb_size_t state = tb_atomic32_get(&job->state);
+    // exit the jobs count
+    tb_percpu_counter_exit(&group->jobs_count);
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * jobs implementation
+ */
+static tb_size_t tb_thread_pool_jobs_alloc(tb_thread_pool_impl_t* impl, tb_thread_pool_worker_t* worker, tb_thread_pool_task_t const* list, tb_size_t size, tb_size_t refn, tb_thread_pool_job_t** jobs)
+{
+    // too many jobs? we need not the exact jobs count here
+    tb_long_t jobs_count = (tb_long_t)tb_percpu_counter_get(&impl->jobs_count);
+    tb_check_return_val(jobs_count + 1 < TB_THREAD_POOL_JOBS_WAITING_MAXN, 0);
+    if (size > (tb_size_t)(TB_THREAD_POOL_JOBS_WAITING_MAXN - jobs_count - 1))
+        size = (tb_size_t)(TB_THREAD_POOL_JOBS_WAITING_MAXN - jobs_count - 1);
 
-    // waiting and non-full? pull it
-    tb_bool_t ok = tb_false;
-    if (state == TB_STATE_WAITING && worker->pull < TB_THREAD_POOL_JOBS_PULL_TIME_MAXN)
+    // get the worker groups of all tasks first, we only post the tasks before the invalid group
+    tb_size_t i = 0;
+    tb_thread_pool_group_t* groups[TB_THREAD_POOL_SHARD_PULL_MAXN];
+    tb_assert_and_check_return_val(size <= tb_arrayn(groups), 0);
+    for (i = 0; i < size; i++)
     {
-        // append the job to the working jobs
-        tb_vector_insert_tail(worker->jobs, job);
+        groups[i] = tb_thread_pool_group_get(impl, worker, list[i].group);
+        tb_assertf_and_check_break(groups[i], "invalid thread pool group: %lu", list[i].group);
+    }
+    size = i;
 
-        // computate the job average time
-        tb_size_t average_time = 200;
-        if (tb_hash_map_size(worker->stats))
-        {
-            tb_thread_pool_job_stats_t* stats = (tb_thread_pool_job_stats_t*)tb_hash_map_get(worker->stats, job->task.done);
-            if (stats && stats->done_count) average_time = (tb_size_t)(stats->total_time / stats->done_count);
-        }
+    // reuse the cached jobs of the current worker first
+    tb_size_t count = 0;
+    while (worker && worker->cache_size && count < size)
+        jobs[count++] = worker->cache[--worker->cache_size];
 
-        // update the pull time
-        worker->pull += average_time;
+    // make the remaining jobs
+    if (count < size)
+    {
+        tb_futexlock_enter(&impl->lock);
+        while (count < size && (jobs[count] = (tb_thread_pool_job_t*)tb_fixed_pool_malloc(impl->jobs_pool))) count++;
+        tb_futexlock_leave(&impl->lock);
+    }
 
-        // trace
-        tb_trace_d("worker[%lu]: pull: task[%p:%s] from pending", worker->id, job->task.done, job->task.name);
+    // init jobs
+    for (i = 0; i < count; i++)
+    {
+        tb_thread_pool_job_t* job = jobs[i];
+        tb_assert(list[i].done);
+        job->task = list[i];
+        job->group = groups[i];
+        tb_atomic32_set(&job->refn, (tb_int32_t)refn);
+        tb_atomic32_set(&job->state, TB_STATE_WAITING);
+        tb_percpu_counter_add(&job->group->jobs_count, 1);
     }
-    // finished or killed? remove it
-    else if (state == TB_STATE_FINISHED || state == TB_STATE_KILLED)
+
+    // update the jobs count
+    if (count) tb_percpu_counter_add(&impl->jobs_count, count);
+    return count;
+}
+static tb_void_t tb_thread_pool_jobs_free(tb_thread_pool_impl_t* impl, tb_thread_pool_worker_t* worker, tb_thread_pool_job_t* job)
+{
+    // update the jobs count of the group
+    tb_percpu_counter_add(&job->group->jobs_count, -1);
+
+    // cache it to the current worker first
+    if (worker && worker->cache_size < tb_arrayn(worker->cache)) worker->cache[worker->cache_size++] = job;
+    else
     {
-        // trace
-        tb_trace_d("worker[%lu]: remove: task[%p:%s] from pending", worker->id, job->task.done, job->task.name);
+        // free it to the jobs pool, we also free the half of the cached jobs at once if the cache is full
+        tb_futexlock_enter(&impl->lock);
+        tb_fixed_pool_free(impl->jobs_pool, job);
+        if (worker)
+        {
+            while (worker->cache_size > (tb_arrayn(worker->cache) >> 1))
+                tb_fixed_pool_free(impl->jobs_pool, worker->cache[--worker->cache_size]);
+        }
+        tb_futexlock_leave(&impl->lock);
+    }
 
-        // exit the job
-        if (job->task.exit) job->task.exit((tb_thread_pool_worker_ref_t)worker, job->task.priv);
+    // update the jobs count
+    tb_percpu_counter_add(&impl->jobs_count, -1);
+}
+static tb_void_t tb_thread_pool_jobs_exit(tb_thread_pool_impl_t* impl, tb_thread_pool_worker_t* worker, tb_thread_pool_job_t* job)
+{
+    // refn--, free it if no one refers to it
+    if (tb_atomic32_fetch_and_sub(&job->refn, 1) == 1)
+        tb_thread_pool_jobs_free(impl, worker, job);
+}
+static tb_void_t tb_thread_pool_jobs_inject(tb_thread_pool_worker_t* worker, tb_thread_pool_job_t** jobs, tb_size_t count)
+{
+    // the shard of the jobs group, we use the shard of the current worker first
+    tb_thread_pool_group_t* group = jobs[0]->group;
+    tb_size_t               index = worker && worker->group == group? worker->id : (tb_size_t)tb_atomic_fetch_and_add(&group->shard_next, 1);
+    tb_thread_pool_shard_t* shard = &group->shards[index & TB_THREAD_POOL_SHARD_MASK];
 
-        // remove it from the waiting or urgent jobs
-        ok = tb_true;
+    // enter
+    tb_futexlock_enter(&shard->lock);
 
-        // refn--
-        if (job->refn > 1) job->refn--;
-        // remove it from pool directly
-        else
+    // append jobs to the urgent or waiting jobs
+    tb_size_t i = 0;
+    tb_size_t urgent = 0;
+    for (i = 0; i < count; i++)
+    {
+        tb_thread_pool_job_t* job = jobs[i];
+        tb_assert(job->group == group);
+        if (job->task.urgent)
         {
-            // the pool
-            tb_thread_pool_impl_t* impl = (tb_thread_pool_impl_t*)worker->pool;
-            tb_assert(impl);
-
-            // remove it from the jobs pool
-            tb_fixed_pool_free(impl->jobs_pool, job);
+            tb_list_entry_insert_tail(&shard->jobs_urgent, &job->entry);
+            urgent++;
         }
+        else tb_list_entry_insert_tail(&shard->jobs_waiting, &job->entry);
     }
+    if (urgent) tb_atomic_fetch_and_add(&group->jobs_urgent, urgent);
+    tb_atomic_fetch_and_add(&shard->size, count);
 
-    // remove it?
-    return ok;
+    // leave
+    tb_futexlock_leave(&shard->lock);
 }
-static tb_bool_t tb_thread_pool_worker_walk_clean(tb_iterator_ref_t iterator, tb_cpointer_t item, tb_cpointer_t value)
+static tb_void_t tb_thread_pool_jobs_post(tb_thread_pool_worker_t* worker, tb_thread_pool_job_t* job)
 {
-    // the worker pull
-    tb_thread_pool_worker_t* worker = (tb_thread_pool_worker_t*)value;
-    tb_assert(worker && worker->jobs);
+    // push the non-urgent job to the local deque if we are in the worker thread of the same group
+    if (worker && worker->group == job->group && !job->task.urgent && tb_thread_pool_deque_push(worker->deque, job))
+    {
+        // we need notify the idle workers to steal it
+        tb_memory_barrier();
+        return ;
+    }
 
-    // the job
+    // post it to the injection queue
+    tb_thread_pool_jobs_inject(worker, &job, 1);
+}
+static tb_bool_t tb_thread_pool_jobs_walk_kill_all(tb_pointer_t item, tb_cpointer_t priv)
+{
+    // check
     tb_thread_pool_job_t* job = (tb_thread_pool_job_t*)item;
-    tb_assert(job);
-
-    // the job state
-    tb_size_t state = tb_atomic32_get(&job->state);
+    tb_assert_and_check_return_val(job, tb_false);
 
-    // finished or killed? remove it
-    tb_bool_t ok = tb_false;
-    if (state == TB_STATE_FINISHED || state == TB_STATE_KILLED)
-    {
-        // trace
-        tb_trace_d("worker[%lu]: remove: task[%p:%s] from pending", worker->id, job->task.done, job->task.name);
+    // kill it if be waiting
+    tb_atomic32_fetch_and_cmpset(&job->state, TB_STATE_WAITING, TB_STATE_KILLING);
 
-        // exit the job
-        if (job->task.exit) job->task.exit((tb_thread_pool_worker_ref_t)worker, job->task.priv);
+    // ok
+    return tb_true;
+}
+#ifdef __tb_debug__
+static tb_bool_t tb_thread_pool_jobs_walk_dump_all(tb_pointer_t item, tb_cpointer_t priv)
+{
+    // check
+    tb_thread_pool_job_t* job = (tb_thread_pool_job_t*)item;
+    tb_assert_and_check_return_val(job, tb_false);
 
-        // remove it from the pending jobs
-        ok = tb_true;
+    // trace, the cached free jobs are dumped too
+    tb_trace_i("    task[%p:%s]: refn: %ld, state: %s", job->task.done, job->task.name, (tb_long_t)tb_atomic32_get(&job->refn), tb_state_cstr(tb_atomic32_get(&job->state)));
 
-        // refn--
-        if (job->refn > 1) job->refn--;
-        // remove it from pool directly
-        else
-        {
-            // the pool
-            tb_thread_pool_impl_t* impl = (tb_thread_pool_impl_t*)worker->pool;
-            tb_assert(impl);
+    // ok
+    return tb_true;
+}
+#endif
 
-            // remove it from the jobs pool
-            tb_fixed_pool_free(impl->jobs_pool, job);
-        }
-    }
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * worker implementation
+ */
+static __tb_inline__ tb_thread_pool_worker_t* tb_thread_pool_worker_self(tb_thread_pool_impl_t* impl)
+{
+    // get the worker of the current thread
+#ifdef __tb_thread_local__
+    tb_thread_pool_worker_t* worker = g_worker_self;
+#else
+    tb_thread_pool_worker_t* worker = (tb_thread_pool_worker_t*)tb_thread_local_get(&g_worker_self);
+#endif
 
-    // remove it?
-    return ok;
+    // is the worker of this pool?
+    return worker && worker->pool == (tb_thread_pool_ref_t)impl? worker : tb_null;
 }
-static tb_void_t tb_thread_pool_worker_post(tb_thread_pool_impl_t* impl, tb_size_t post)
+static tb_void_t tb_thread_pool_worker_post(tb_thread_pool_group_t* group, tb_size_t post)
 {
     // check
-    tb_assert_and_check_return(impl && impl->semaphore);
+    tb_assert_and_check_return(group && group->semaphore);
+
+    // no idle workers?
+    tb_long_t idle = tb_atomic_get(&group->idle);
+    tb_check_return(idle > 0);
 
     // the semaphore value
-    tb_long_t value = tb_semaphore_value(impl->semaphore);
+    tb_long_t value = tb_semaphore_value(group->semaphore);
 
     // post wait
+    if ((tb_size_t)idle < post) post = (tb_size_t)idle;
     if (value >= 0 && (tb_size_t)value < post)
-        tb_semaphore_post(impl->semaphore, post - value);
+        tb_semaphore_post(group->semaphore, post - value);
 }
-static tb_int_t tb_thread_pool_worker_loop(tb_cpointer_t priv)
+static tb_int_t tb_thread_pool_worker_loop(tb_cpointer_t priv);
+static tb_void_t tb_thread_pool_worker_spawn(tb_thread_pool_impl_t* impl, tb_thread_pool_group_t* group)
 {
-    // the worker
-    tb_thread_pool_worker_t* worker = (tb_thread_pool_worker_t*)priv;
+    // need more workers?
+    tb_size_t worker_size = (tb_size_t)tb_atomic_get(&group->worker_size);
+    tb_check_return(worker_size < group->worker_maxn);
 
-    // trace
-    tb_trace_d("worker[%lu]: init", worker? worker->id : -1);
+    // we need more workers than the alive jobs?
+    tb_hong_t jobs_count = tb_percpu_counter_sum(&group->jobs_count);
+    tb_check_return(jobs_count > (tb_hong_t)worker_size);
 
-    // done
-    do
-    {
-        // check
-        tb_assert_and_check_break(worker && !worker->jobs && !worker->stats);
+    // enter
+    tb_futexlock_enter(&impl->lock);
 
-        // the pool
-        tb_thread_pool_impl_t* impl = (tb_thread_pool_impl_t*)worker->pool;
-        tb_assert_and_check_break(impl && impl->semaphore);
+    // init them if the workers have been not inited
+    tb_size_t i = (tb_size_t)tb_atomic_get(&group->worker_size);
+    tb_size_t n = tb_min((tb_size_t)jobs_count, group->worker_maxn);
+    if (!tb_atomic_flag_test(&impl->bstoped))
+    {
+        for (; i < n; i++)
+        {
+            // the worker
+            tb_size_t                   id = group->worker_base + i;
+            tb_thread_pool_worker_t*    worker = &impl->worker_list[id];
+
+            // clear worker
+            tb_memset(worker, 0, sizeof(tb_thread_pool_worker_t));
+
+            // init worker
+            tb_atomic_flag_clear_explicit(&worker->bstoped, TB_ATOMIC_RELAXED);
+            worker->id          = id;
+            worker->pool        = (tb_thread_pool_ref_t)impl;
+            worker->group       = group;
+            worker->seed        = (tb_uint32_t)(id + 1) * 2654435761u;
+            worker->deque       = tb_malloc0_type(tb_thread_pool_deque_t);
+            tb_assert_and_check_break(worker->deque);
+
+            // init loop
+            worker->loop        = tb_thread_init(__tb_lstring__("thread_pool"), tb_thread_pool_worker_loop, worker, impl->stack);
+            if (!worker->loop)
+            {
+                tb_free(worker->deque);
+                worker->deque = tb_null;
+                break;
+            }
+        }
 
-        // wait some time for leaving the lock
-        tb_msleep((worker->id + 1) * 20);
+        // update the worker size
+        tb_atomic_set(&group->worker_size, i);
+    }
 
-        // init jobs
-        worker->jobs = tb_vector_init(TB_THREAD_POOL_JOBS_WORKING_GROW, tb_element_ptr(tb_null, tb_null));
-        tb_assert_and_check_break(worker->jobs);
+    // leave
+    tb_futexlock_leave(&impl->lock);
+}
+static tb_thread_pool_job_t* tb_thread_pool_worker_pull(tb_thread_pool_worker_t* worker, tb_thread_pool_group_t* group, tb_bool_t urgent)
+{
+    // pull jobs from all shards of the given group, we use the shard of the current worker first
+    tb_size_t i = 0;
+    tb_thread_pool_job_t* job = tb_null;
+    for (i = 0; i < TB_THREAD_POOL_SHARD_MAXN && !job; i++)
+    {
+        // empty shard?
+        tb_thread_pool_shard_t* shard = &group->shards[(worker->id + i) & TB_THREAD_POOL_SHARD_MASK];
+        if (tb_atomic_get(&shard->size) <= 0) continue;
 
-        // init stats
-        worker->stats = tb_hash_map_init(TB_HASH_MAP_BUCKET_SIZE_MICRO, tb_element_ptr(tb_null, tb_null), tb_element_mem(sizeof(tb_thread_pool_job_stats_t), tb_null, tb_null));
-        tb_assert_and_check_break(worker->stats);
+        // enter
+        tb_futexlock_enter(&shard->lock);
 
-        // loop
-        while (1)
+        // pull the first job
+        tb_list_entry_head_ref_t jobs = urgent? &shard->jobs_urgent : &shard->jobs_waiting;
+        if (tb_list_entry_size(jobs))
         {
-            // pull jobs if be idle
-            if (!tb_vector_size(worker->jobs))
+            job = (tb_thread_pool_job_t*)tb_list_entry(jobs, tb_list_entry_head(jobs));
+            tb_list_entry_remove_head(jobs);
+
+            // move more waiting jobs of our group to the local deque, so other workers can steal them
+            tb_size_t count = 1;
+            if (!urgent)
             {
-                // enter
-                tb_spinlock_enter(&impl->lock);
+                while (group == worker->group && count < TB_THREAD_POOL_SHARD_PULL_MAXN && tb_list_entry_size(jobs))
+                {
+                    tb_thread_pool_job_t* next = (tb_thread_pool_job_t*)tb_list_entry(jobs, tb_list_entry_head(jobs));
+                    if (!tb_thread_pool_deque_push(worker->deque, next)) break;
+                    tb_list_entry_remove_head(jobs);
+                    count++;
+                }
+            }
+            else tb_atomic_fetch_and_sub(&group->jobs_urgent, 1);
+            tb_atomic_fetch_and_sub(&shard->size, count);
+        }
 
-                // init the pull time
-                worker->pull = 0;
+        // leave
+        tb_futexlock_leave(&shard->lock);
+    }
+    return job;
+}
+static tb_thread_pool_job_t* tb_thread_pool_worker_steal(tb_thread_pool_impl_t* impl, tb_thread_pool_worker_t* worker, tb_thread_pool_group_t* group)
+{
+    // no other workers?
+    tb_size_t worker_size = (tb_size_t)tb_atomic_get(&group->worker_size);
+    tb_check_return_val(worker_size > (group == worker->group? 1 : 0), tb_null);
 
-                // pull from the urgent jobs
-                if (tb_list_entry_size(&impl->jobs_urgent))
-                {
-                    // trace
-                    tb_trace_d("worker[%lu]: try pulling from urgent: %lu", worker->id, tb_list_entry_size(&impl->jobs_urgent));
+    // choose a random victim first
+    worker->seed ^= worker->seed << 13;
+    worker->seed ^= worker->seed >> 17;
+    worker->seed ^= worker->seed << 5;
 
-                    // pull it
-                    tb_remove_if_until(tb_list_entry_itor(&impl->jobs_urgent), tb_thread_pool_worker_walk_pull, worker);
-                }
+    // steal job from the victim workers of the given group
+    tb_size_t i = 0;
+    tb_size_t start = worker->seed % worker_size;
+    tb_thread_pool_job_t* job = tb_null;
+    for (i = 0; i < worker_size && !job; i++)
+    {
+        tb_thread_pool_worker_t* victim = &impl->worker_list[group->worker_base + (start + i) % worker_size];
+        if (victim != worker && victim->deque) job = tb_thread_pool_deque_steal(victim->deque);
+    }
+    return job;
+}
+static tb_thread_pool_job_t* tb_thread_pool_worker_next(tb_thread_pool_impl_t* impl, tb_thread_pool_worker_t* worker)
+{
+    // pull the urgent jobs first
+    tb_thread_pool_group_t* group = worker->group;
+    tb_thread_pool_job_t*   job = tb_null;
+    if (tb_atomic_get(&group->jobs_urgent) > 0) job = tb_thread_pool_worker_pull(worker, group, tb_true);
 
-                // pull from the waiting jobs
-                if (tb_list_entry_size(&impl->jobs_waiting))
-                {
-                    // trace
-                    tb_trace_d("worker[%lu]: try pulling from waiting: %lu", worker->id, tb_list_entry_size(&impl->jobs_waiting));
+    // pop job from the local deque
+    if (!job) job = tb_thread_pool_deque_pop(worker->deque);
 
-                    // pull it
-                    tb_remove_if_until(tb_list_entry_itor(&impl->jobs_waiting), tb_thread_pool_worker_walk_pull, worker);
-                }
+    // pull jobs from the injection queue
+    if (!job) job = tb_thread_pool_worker_pull(worker, group, tb_false);
 
-                // pull from the pending jobs and clean some finished and killed jobs
-                if (tb_list_entry_size(&impl->jobs_pending))
-                {
-                    // trace
-                    tb_trace_d("worker[%lu]: try pulling from pending: %lu", worker->id, tb_list_entry_size(&impl->jobs_pending));
+    // steal job from other workers
+    if (!job) job = tb_thread_pool_worker_steal(impl, worker, group);
 
-                    // no jobs? try to pull from the pending jobs
-                    if (!tb_vector_size(worker->jobs))
-                        tb_remove_if(tb_list_entry_itor(&impl->jobs_pending), tb_thread_pool_worker_walk_pull_and_clean, worker);
-                    // clean some finished and killed jobs
-                    else tb_remove_if(tb_list_entry_itor(&impl->jobs_pending), tb_thread_pool_worker_walk_clean, worker);
-                }
+    // we are idle now, help the default groups of the other numa nodes
+    if (!job && group->index < impl->numa_count)
+    {
+        tb_size_t i = 1;
+        for (i = 1; i < impl->numa_count && !job; i++)
+        {
+            tb_thread_pool_group_t* remote = &impl->groups[(group->index + i) % impl->numa_count];
+            if (tb_percpu_counter_sum(&remote->jobs_count) <= 0) continue;
+            job = tb_thread_pool_worker_pull(worker, remote, tb_false);
+            if (!job) job = tb_thread_pool_worker_steal(impl, worker, remote);
+        }
+    }
+    return job;
+}
+static tb_void_t tb_thread_pool_worker_done(tb_thread_pool_impl_t* impl, tb_thread_pool_worker_t* worker, tb_thread_pool_job_t* job)
+{
+    // check
+    tb_assert(job && job->task.done);
 
-                // leave
-                tb_spinlock_leave(&impl->lock);
+    // the job is waiting? work it
+    tb_int32_t state = TB_STATE_WAITING;
+    if (tb_atomic32_compare_and_swap(&job->state, &state, TB_STATE_WORKING))
+    {
+        // done the job
+        job->task.done((tb_thread_pool_worker_ref_t)worker, job->task.priv);
 
-                // idle? wait it
-                if (!tb_vector_size(worker->jobs))
-                {
-                    // killed?
-                    tb_check_break(!tb_atomic_flag_test_explicit(&worker->bstoped, TB_ATOMIC_RELAXED));
+        // update the job state
+        tb_atomic32_set(&job->state, TB_STATE_FINISHED);
+    }
+    // the job is killing? work it
+    else if (state == TB_STATE_KILLING)
+    {
+        // update the job state
+        tb_atomic32_set(&job->state, TB_STATE_KILLED);
+    }
 
-                    // trace
-                    tb_trace_d("worker[%lu]: wait: ..", worker->id);
+    // exit the job
+    if (job->task.exit) job->task.exit((tb_thread_pool_worker_ref_t)worker, job->task.priv);
+    tb_thread_pool_jobs_exit(impl, worker, job);
+}
+static tb_int_t tb_thread_pool_worker_loop(tb_cpointer_t priv)
+{
+    // the worker
+    tb_thread_pool_worker_t* worker = (tb_thread_pool_worker_t*)priv;
 
-                    // wait some time
-                    tb_long_t wait = tb_semaphore_wait(impl->semaphore, -1);
-                    tb_assert_and_check_break(wait > 0);
+    // trace
+    tb_trace_d("worker[%lu]: init", worker? worker->id : -1);
 
-                    // trace
-                    tb_trace_d("worker[%lu]: wait: ok", worker->id);
+    // done
+    do
+    {
+        // check
+        tb_assert_and_check_break(worker && worker->deque && worker->group);
 
-                    // continue it
-                    continue;
-                }
-                else
-                {
-#ifdef TB_TRACE_DEBUG
-                    // update the jobs urgent size
-                    tb_size_t jobs_urgent_size = tb_list_entry_size(&impl->jobs_urgent);
+        // the pool
+        tb_thread_pool_impl_t* impl = (tb_thread_pool_impl_t*)worker->pool;
+        tb_assert_and_check_break(impl);
 
-                    // update the jobs waiting size
-                    tb_size_t jobs_waiting_size = tb_list_entry_size(&impl->jobs_waiting);
+        // the group
+        tb_thread_pool_group_t* group = worker->group;
+        tb_assert_and_check_break(group->semaphore);
 
-                    // update the jobs pending size
-                    tb_size_t jobs_pending_size = tb_list_entry_size(&impl->jobs_pending);
+        // pin it to the cpus of the group
+        if (!TB_CPUSET_EMPTY(&group->cpuset) && !tb_thread_setaffinity(tb_null, &group->cpuset))
+        {
+            // trace
+            tb_trace_w("worker[%lu]: set affinity failed for group(%s)!", worker->id, group->name);
+        }
 
-                    // trace
-                    tb_trace_d("worker[%lu]: pull: jobs: %lu, time: %lu ms, waiting: %lu, pending: %lu, urgent: %lu", worker->id, tb_vector_size(worker->jobs), worker->pull, jobs_waiting_size, jobs_pending_size, jobs_urgent_size);
+        // save the current worker
+#ifdef __tb_thread_local__
+        g_worker_self = worker;
+#else
+        if (tb_thread_local_init(&g_worker_self, tb_null))
+            tb_thread_local_set(&g_worker_self, worker);
 #endif
-                }
-            }
 
-            // done jobs
-            tb_for_all (tb_thread_pool_job_t*, job, worker->jobs)
+        // loop
+        while (1)
+        {
+            // get the next job
+            tb_thread_pool_job_t* job = tb_thread_pool_worker_next(impl, worker);
+            if (job)
             {
-                // check
-                tb_assert_and_check_continue(job && job->task.done);
+                tb_thread_pool_worker_done(impl, worker, job);
+                continue;
+            }
 
-                // the job is waiting? work it
-                tb_int32_t state = TB_STATE_WAITING;
-                if (tb_atomic32_compare_and_swap(&job->state, &state, TB_STATE_WORKING))
+            // idle now, we need try getting the next job again to avoid losing the new posted jobs
+            tb_long_t wait = 0;
+            tb_atomic_fetch_and_add(&group->idle, 1);
+            if (!(job = tb_thread_pool_worker_next(impl, worker)))
+            {
+                // killed?
+                if (tb_atomic_flag_test_explicit(&worker->bstoped, TB_ATOMIC_RELAXED))
                 {
-                    // trace
-                    tb_trace_d("worker[%lu]: done: task[%p:%s]: ..", worker->id, job->task.done, job->task.name);
-
-                    // init the time
-                    tb_hong_t time = tb_cache_time_spak();
-
-                    // done the job
-                    job->task.done((tb_thread_pool_worker_ref_t)worker, job->task.priv);
-
-                    // computate the time
-                    time = tb_cache_time_spak() - time;
-
-                    // exists? update time and count
-                    tb_size_t               itor;
-                    tb_hash_map_item_ref_t  item = tb_null;
-                    if (    ((itor = tb_hash_map_find(worker->stats, job->task.done)) != tb_iterator_tail(worker->stats))
-                        &&  (item = (tb_hash_map_item_ref_t)tb_iterator_item(worker->stats, itor)))
-                    {
-                        // the stats
-                        tb_thread_pool_job_stats_t* stats = (tb_thread_pool_job_stats_t*)item->data;
-                        tb_assert_and_check_break(stats);
-
-                        // update the done count
-                        stats->done_count++;
-
-                        // update the total time
-                        stats->total_time += time;
-                    }
-
-                    // no item? add it
-                    if (!item)
-                    {
-                        // init stats
-                        tb_thread_pool_job_stats_t stats = {0};
-                        stats.done_count = 1;
-                        stats.total_time = time;
-
-                        // add stats
-                        tb_hash_map_insert(worker->stats, job->task.done, &stats);
-                    }
-
-#ifdef TB_TRACE_DEBUG
-                    tb_size_t done_count = 0;
-                    tb_hize_t total_time = 0;
-                    tb_thread_pool_job_stats_t* stats = (tb_thread_pool_job_stats_t*)tb_hash_map_get(worker->stats, job->task.done);
-                    if (stats)
-                    {
-                        done_count = stats->done_count;
-                        total_time = stats->total_time;
-                    }
+                    tb_atomic_fetch_and_sub(&group->idle, 1);
+                    break;
+                }
 
-                    // trace
-                    tb_trace_d("worker[%lu]: done: task[%p:%s]: time: %lld ms, average: %lld ms, count: %lu", worker->id, job->task.done, job->task.name, time, (total_time / (tb_hize_t)done_count), done_count);
-#endif
+                // trace
+                tb_trace_d("worker[%lu]: wait: ..", worker->id);
 
-                    // update the job state
-                    tb_atomic32_set(&job->state, TB_STATE_FINISHED);
-                }
-                // the job is killing? work it
-                else if (state == TB_STATE_KILLING)
-                {
-                    // update the job state
-                    tb_atomic32_set(&job->state, TB_STATE_KILLED);
-                }
+                // wait some time
+                wait = tb_semaphore_wait(group->semaphore, -1);
+
+                // trace
+                tb_trace_d("worker[%lu]: wait: ok", worker->id);
             }
+            tb_atomic_fetch_and_sub(&group->idle, 1);
+            tb_assert_and_check_break(wait >= 0);
 
-            // clear jobs
-            tb_vector_clear(worker->jobs);
+            // done the job
+            if (job) tb_thread_pool_worker_done(impl, worker, job);
         }
 
+        // clear the current worker
+#ifdef __tb_thread_local__
+        g_worker_self = tb_null;
+#else
+        tb_thread_local_set(&g_worker_self, tb_null);
+#endif
+
+        // free all cached jobs
+        tb_futexlock_enter(&impl->lock);
+        while (worker->cache_size) tb_fixed_pool_free(impl->jobs_pool, worker->cache[--worker->cache_size]);
+        tb_futexlock_leave(&impl->lock);
+
     } while (0);
 
     // exit worker
@@ -601,148 +962,12 @@ static tb_int_t tb_thread_pool_worker_loop(tb_cpointer_t priv)
             priv->exit = tb_null;
             priv->priv = tb_null;
         }
-
-        // exit stats
-        if (worker->stats) tb_hash_map_exit(worker->stats);
-        worker->stats = tb_null;
-
-        // exit jobs
-        if (worker->jobs) tb_vector_exit(worker->jobs);
-        worker->jobs = tb_null;
     }
 
     // exit
     return 0;
 }
 
-/* //////////////////////////////////////////////////////////////////////////////////////
- * jobs implementation
- */
-static tb_bool_t tb_thread_pool_jobs_walk_kill_all(tb_pointer_t item, tb_cpointer_t priv)
-{
-    // check
-    tb_thread_pool_job_t* job = (tb_thread_pool_job_t*)item;
-    tb_assert_and_check_return_val(job, tb_false);
-
-    // trace
-    tb_trace_d("task[%p:%s]: kill: ..", job->task.done, job->task.name);
-
-    // kill it if be waiting
-    tb_atomic32_fetch_and_cmpset(&job->state, TB_STATE_WAITING, TB_STATE_KILLING);
-
-    // ok
-    return tb_true;
-}
-#ifdef __tb_debug__
-static tb_bool_t tb_thread_pool_jobs_walk_dump_all(tb_pointer_t item, tb_cpointer_t priv)
-{
-    // check
-    tb_thread_pool_job_t* job = (tb_thread_pool_job_t*)item;
-    tb_assert_and_check_return_val(job, tb_false);
-
-    // the state string
-    static tb_char_t const* s_state_cstr[] =
-    {
-        "waiting"
-    ,   "working"
-    ,   "killed"
-    ,   "finished"
-    };
-    tb_assert_and_check_return_val(job->state < tb_arrayn(s_state_cstr), tb_false);
-
-    // trace
-    tb_trace_d("    task[%p:%s]: refn: %lu, state: %s", job->task.done, job->task.name, job->refn, s_state_cstr[job->state]);
-
-    // ok
-    return tb_true;
-}
-#endif
-static tb_thread_pool_job_t* tb_thread_pool_jobs_post_task(tb_thread_pool_impl_t* impl, tb_thread_pool_task_t const* task, tb_size_t* post_size)
-{
-    // check
-    tb_assert_and_check_return_val(impl && task && task->done && post_size, tb_null);
-
-    // done
-    tb_bool_t               ok = tb_false;
-    tb_thread_pool_job_t*   job = tb_null;
-    do
-    {
-        // check
-        tb_assert_and_check_break(tb_list_entry_size(&impl->jobs_waiting) + tb_list_entry_size(&impl->jobs_urgent) + 1 < TB_THREAD_POOL_JOBS_WAITING_MAXN);
-
-        // make job
-        job = (tb_thread_pool_job_t*)tb_fixed_pool_malloc0(impl->jobs_pool);
-        tb_assert_and_check_break(job);
-
-        // init job
-        tb_atomic32_init(&job->refn, 1);
-        tb_atomic32_init(&job->state, TB_STATE_WAITING);
-        job->task   = *task;
-
-        // non-urgent job?
-        if (!task->urgent)
-        {
-            // post to the waiting jobs
-            tb_list_entry_insert_tail(&impl->jobs_waiting, &job->entry);
-        }
-        else
-        {
-            // post to the urgent jobs
-            tb_list_entry_insert_tail(&impl->jobs_urgent, &job->entry);
-        }
-
-        // the waiting jobs count
-        tb_size_t jobs_waiting_count = tb_list_entry_size(&impl->jobs_waiting) + tb_list_entry_size(&impl->jobs_urgent);
-        tb_assert_and_check_break(jobs_waiting_count);
-
-        // update the post size
-        if (*post_size < impl->worker_size) (*post_size)++;
-
-        // trace
-        tb_trace_d("task[%p:%s]: post: %lu: ..", task->done, task->name, *post_size);
-
-        // init them if the workers have been not inited
-        if (impl->worker_size < jobs_waiting_count)
-        {
-            tb_size_t i = impl->worker_size;
-            tb_size_t n = tb_min(jobs_waiting_count, impl->worker_maxn);
-            for (; i < n; i++)
-            {
-                // the worker
-                tb_thread_pool_worker_t* worker = &impl->worker_list[i];
-
-                // clear worker
-                tb_memset(worker, 0, sizeof(tb_thread_pool_worker_t));
-
-                // init worker
-                tb_atomic_flag_clear_explicit(&worker->bstoped, TB_ATOMIC_RELAXED);
-                worker->id          = i;
-                worker->pool        = (tb_thread_pool_ref_t)impl;
-                worker->loop        = tb_thread_init(__tb_lstring__("thread_pool"), tb_thread_pool_worker_loop, worker, impl->stack);
-                tb_assert_and_check_continue(worker->loop);
-            }
-
-            // update the worker size
-            impl->worker_size = i;
-        }
-
-        // ok
-        ok = tb_true;
-
-    } while (0);
-
-    // failed?
-    if (!ok)
-    {
-        // exit it
-        tb_fixed_pool_free(impl->jobs_pool, job);
-        job = tb_null;
-    }
-
-    // ok?
-    return job;
-}
-
 /* //////////////////////////////////////////////////////////////////////////////////////
  * implementation
  */
@@ -752,6 +977,17 @@ tb_thread_pool_ref_t tb_thread_pool()
 }
 tb_thread_pool_ref_t tb_thread_pool_init(tb_size_t worker_maxn, tb_size_t stack)
 {
+    // init it with the default option
+    tb_thread_pool_option_t option = {0};
+    option.worker_maxn  = worker_maxn;
+    option.stack        = stack;
+    return tb_thread_pool_init_ext(&option);
+}
+tb_thread_pool_ref_t tb_thread_pool_init_ext(tb_thread_pool_option_t const* option)
+{
+    // check
+    tb_assert_and_check_return_val(option && (!option->groups_count || option->groups), tb_null);
+
     // done
     tb_bool_t               ok = tb_false;
     tb_thread_pool_impl_t*  impl = tb_null;
@@ -762,35 +998,66 @@ tb_thread_pool_ref_t tb_thread_pool_init(tb_size_t worker_maxn, tb_size_t stack)
         tb_assert_and_check_break(impl);
 
         // init lock
-        if (!tb_spinlock_init(&impl->lock)) break;
+        if (!tb_futexlock_init(&impl->lock)) break;
 
         // computate the default worker maxn if be zero
+        tb_size_t worker_maxn = option->worker_maxn;
         if (!worker_maxn) worker_maxn = tb_cpu_count() << 2;
         tb_assert_and_check_break(worker_maxn);
 
         // init thread stack
-        impl->stack         = stack;
+        impl->stack         = option->stack;
 
         // init workers
-        impl->worker_size   = 0;
-        impl->worker_maxn   = worker_maxn;
+        impl->worker_maxn   = 0;
+        tb_atomic_init(&impl->numa_next, 0);
+        tb_atomic_flag_clear_explicit(&impl->bstoped, TB_ATOMIC_RELAXED);
 
         // init jobs pool
         impl->jobs_pool     = tb_fixed_pool_init(tb_null, TB_THREAD_POOL_JOBS_POOL_GROW, sizeof(tb_thread_pool_job_t), tb_null, tb_null, tb_null);
         tb_assert_and_check_break(impl->jobs_pool);
+        tb_percpu_counter_init(&impl->jobs_count, 0, 0);
+
+        // init the default groups, one group per numa node in numa mode
+        tb_size_t   i = 0;
+        tb_cpuset_t cpuset_all = option->cpuset;
+        tb_assert_and_check_break(option->groups_count < TB_THREAD_POOL_GROUP_MAXN);
+        impl->numa_count = option->numa? tb_min(tb_cpu_numa_count(), TB_THREAD_POOL_GROUP_MAXN - option->groups_count) : 1;
+        if (!impl->numa_count) impl->numa_count = 1;
+        if (impl->numa_count > 1)
+        {
+            tb_char_t name[32];
+            for (i = 0; i < impl->numa_count; i++)
+            {
+                // pin the workers to the cpus of this node, we use all cpus of this node if they are not in the given cpu set
+                tb_cpuset_t node;
+                tb_cpuset_t cpuset;
+                if (!tb_cpu_numa_cpuset(i, &node)) break;
+                if (!TB_CPUSET_EMPTY(&cpuset_all)) TB_CPUSET_AND(&cpuset, &node, &cpuset_all);
+                else cpuset = node;
+                if (TB_CPUSET_EMPTY(&cpuset)) cpuset = node;
+
+                // init group
+                tb_snprintf(name, sizeof(name), "node%lu", i);
+                if (!tb_thread_pool_group_init(impl, name, tb_max(worker_maxn / impl->numa_count, 1), &cpuset)) break;
+            }
+            tb_assert_and_check_break(i == impl->numa_count);
+        }
+        else if (!tb_thread_pool_group_init(impl, "default", worker_maxn, &cpuset_all)) break;
 
-        // init jobs urgent
-        tb_list_entry_init(&impl->jobs_urgent, tb_thread_pool_job_t, entry, tb_null);
-
-        // init jobs waiting
-        tb_list_entry_init(&impl->jobs_waiting, tb_thread_pool_job_t, entry, tb_null);
-
-        // init jobs pending
-        tb_list_entry_init(&impl->jobs_pending, tb_thread_pool_job_t, entry, tb_null);
-
-        // init semaphore
-        impl->semaphore = tb_semaphore_init(0);
-        tb_assert_and_check_break(impl->semaphore);
+        // init the named groups
+        for (i = 0; i < option->groups_count; i++)
+        {
+            tb_thread_pool_group_option_t const* group = &option->groups[i];
+            tb_assert_and_check_break(group->name);
+
+            // the default worker count is the cpu count of this group
+            tb_size_t   group_maxn = group->worker_maxn;
+            tb_cpuset_t group_cpuset = group->cpuset;
+            if (!group_maxn) group_maxn = !TB_CPUSET_EMPTY(&group_cpuset)? (tb_size_t)TB_CPUSET_COUNT(&group_cpuset) : tb_cpu_count();
+            if (!tb_thread_pool_group_init(impl, group->name, group_maxn, &group_cpuset)) break;
+        }
+        tb_assert_and_check_break(i == option->groups_count);
 
         // register lock profiler
 #ifdef TB_LOCK_PROFILER_ENABLE
@@ -833,59 +1100,62 @@ tb_bool_t tb_thread_pool_exit(tb_thread_pool_ref_t pool)
         return tb_false;
     }
 
-    /* exit all workers
-     * need not lock it because the worker size will not be increase d
+    /* exit all workers and groups
+     * need not lock it because the worker size will not be increased after killing
      */
     tb_size_t i = 0;
-    tb_size_t n = impl->worker_size;
-    for (i = 0; i < n; i++)
+    tb_size_t j = 0;
+    for (j = 0; j < impl->group_count; j++)
     {
-        // the worker
-        tb_thread_pool_worker_t* worker = &impl->worker_list[i];
-
-        // exit loop
-        if (worker->loop)
+        tb_thread_pool_group_t* group = &impl->groups[j];
+        tb_size_t               n = (tb_size_t)tb_atomic_get(&group->worker_size);
+        for (i = 0; i < n; i++)
         {
-            // wait it
-            tb_long_t wait = 0;
-            if ((wait = tb_thread_wait(worker->loop, 5000, tb_null)) <= 0)
+            // the worker
+            tb_thread_pool_worker_t* worker = &impl->worker_list[group->worker_base + i];
+
+            // exit loop
+            if (worker->loop)
             {
-                // trace
-                tb_trace_e("worker[%lu]: wait failed: %ld!", i, wait);
+                // wait it
+                tb_long_t wait = 0;
+                if ((wait = tb_thread_wait(worker->loop, 5000, tb_null)) <= 0)
+                {
+                    // trace
+                    tb_trace_e("worker[%lu]: wait failed: %ld!", worker->id, wait);
+                }
+
+                // exit it
+                tb_thread_exit(worker->loop);
+                worker->loop = tb_null;
             }
 
-            // exit it
-            tb_thread_exit(worker->loop);
-            worker->loop = tb_null;
+            // exit deque
+            if (worker->deque) tb_free(worker->deque);
+            worker->deque = tb_null;
         }
+        tb_atomic_set(&group->worker_size, 0);
+
+        // exit group
+        tb_thread_pool_group_exit(group);
     }
-    impl->worker_size = 0;
+    impl->group_count = 0;
 
     // enter
-    tb_spinlock_enter(&impl->lock);
-
-    // exit pending jobs
-    tb_list_entry_exit(&impl->jobs_pending);
-
-    // exit waiting jobs
-    tb_list_entry_exit(&impl->jobs_waiting);
-
-    // exit urgent jobs
-    tb_list_entry_exit(&impl->jobs_urgent);
+    tb_futexlock_enter(&impl->lock);
 
     // exit jobs pool
     if (impl->jobs_pool) tb_fixed_pool_exit(impl->jobs_pool);
     impl->jobs_pool = tb_null;
 
     // leave
-    tb_spinlock_leave(&impl->lock);
+    tb_futexlock_leave(&impl->lock);
 
     // exit lock
-    tb_spinlock_exit(&impl->lock);
+    tb_futexlock_exit(&impl->lock);
 
-    // exit semaphore
-    if (impl->semaphore) tb_semaphore_exit(impl->semaphore);
-    impl->semaphore = tb_null;
+    // exit the jobs count
+    tb_percpu_counter_exit(&impl->jobs_count);
 
     // exit it
     tb_free(impl);
@@ -903,35 +1173,44 @@ tb_void_t tb_thread_pool_kill(tb_thread_pool_ref_t pool)
     tb_assert_and_check_return(impl);
 
     // enter
-    tb_spinlock_enter(&impl->lock);
+    tb_futexlock_enter(&impl->lock);
 
     // kill it
-    tb_size_t post = 0;
-    if (!impl->bstoped)
+    tb_bool_t killed = tb_false;
+    if (!tb_atomic_flag_test_and_set(&impl->bstoped))
     {
         // trace
         tb_trace_d("kill: ..");
 
-        // stoped
-        impl->bstoped = tb_true;
-
         // kill all workers
         tb_size_t i = 0;
-        tb_size_t n = impl->worker_size;
-        for (i = 0; i < n; i++) tb_atomic_flag_test_and_set_explicit(&impl->worker_list[i].bstoped, TB_ATOMIC_RELAXED);
+        tb_size_t j = 0;
+        for (j = 0; j < impl->group_count; j++)
+        {
+            tb_thread_pool_group_t* group = &impl->groups[j];
+            tb_size_t               n = (tb_size_t)tb_atomic_get(&group->worker_size);
+            for (i = 0; i < n; i++) tb_atomic_flag_test_and_set_explicit(&impl->worker_list[group->worker_base + i].bstoped, TB_ATOMIC_RELAXED);
+        }
 
         // kill all jobs
         if (impl->jobs_pool) tb_fixed_pool_walk(impl->jobs_pool, tb_thread_pool_jobs_walk_kill_all, tb_null);
-
-        // post it
-        post = impl->worker_size;
+        killed = tb_true;
     }
 
     // leave
-    tb_spinlock_leave(&impl->lock);
+    tb_futexlock_leave(&impl->lock);
 
-    // post the workers
-    if (post) tb_thread_pool_worker_post(impl, post);
+    // wake up all workers
+    if (killed)
+    {
+        tb_size_t j = 0;
+        for (j = 0; j < impl->group_count; j++)
+        {
+            tb_thread_pool_group_t* group = &impl->groups[j];
+            tb_size_t               post = (tb_size_t)tb_atomic_get(&group->worker_size);
+            if (post && group->semaphore) tb_semaphore_post(group->semaphore, post);
+        }
+    }
 }
 tb_size_t tb_thread_pool_worker_size(tb_thread_pool_ref_t pool)
 {
@@ -939,17 +1218,30 @@ tb_size_t tb_thread_pool_worker_size(tb_thread_pool_ref_t pool)
     tb_thread_pool_impl_t* impl = (tb_thread_pool_impl_t*)pool;
     tb_assert_and_check_return_val(impl, 0);
 
-    // enter
-    tb_spinlock_enter(&impl->lock);
-
-    // the worker size
-    tb_size_t worker_size = impl->worker_size;
+    // the worker size of all groups
+    tb_size_t i = 0;
+    tb_size_t size = 0;
+    for (i = 0; i < impl->group_count; i++)
+        size += (tb_size_t)tb_atomic_get(&impl->groups[i].worker_size);
+    return size;
+}
+tb_size_t tb_thread_pool_group(tb_thread_pool_ref_t pool, tb_char_t const* name)
+{
+    // check
+    tb_thread_pool_impl_t* impl = (tb_thread_pool_impl_t*)pool;
+    tb_assert_and_check_return_val(impl && name, TB_THREAD_POOL_GROUP_DEFAULT);
 
-    // leave
-    tb_spinlock_leave(&impl->lock);
+    // find the named group
+    tb_size_t i = 0;
+    for (i = impl->numa_count; i < impl->group_count; i++)
+    {
+        if (!tb_strcmp(impl->groups[i].name, name))
+            return i - impl->numa_count + 1;
+    }
 
-    // ok?
-    return worker_size;
+    // trace
+    tb_trace_w("group(%s): not found, use the default group!", name);
+    return TB_THREAD_POOL_GROUP_DEFAULT;
 }
 tb_void_t tb_thread_pool_worker_setp(tb_thread_pool_worker_ref_t worker, tb_size_t index, tb_thread_pool_priv_exit_func_t exit, tb_cpointer_t priv)
 {
@@ -976,62 +1268,31 @@ tb_size_t tb_thread_pool_task_size(tb_thread_pool_ref_t pool)
     tb_thread_pool_impl_t* impl = (tb_thread_pool_impl_t*)pool;
     tb_assert_and_check_return_val(impl, 0);
 
-    // enter
-    tb_spinlock_enter(&impl->lock);
-
     // the task size
-    tb_size_t task_size = impl->jobs_pool? tb_fixed_pool_size(impl->jobs_pool) : 0;
-
-    // leave
-    tb_spinlock_leave(&impl->lock);
-
-    // ok?
-    return task_size;
+    tb_hong_t size = tb_percpu_counter_sum(&impl->jobs_count);
+    return size > 0? (tb_size_t)size : 0;
 }
 tb_bool_t tb_thread_pool_task_post(tb_thread_pool_ref_t pool, tb_char_t const* name, tb_thread_pool_task_done_func_t done, tb_thread_pool_task_exit_func_t exit, tb_cpointer_t priv, tb_bool_t urgent)
+{
+    return tb_thread_pool_task_post_group(pool, TB_THREAD_POOL_GROUP_DEFAULT, name, done, exit, priv, urgent);
+}
+tb_bool_t tb_thread_pool_task_post_group(tb_thread_pool_ref_t pool, tb_size_t group, tb_char_t const* name, tb_thread_pool_task_done_func_t done, tb_thread_pool_task_exit_func_t exit, tb_cpointer_t priv, tb_bool_t urgent)
 {
     // check
     tb_thread_pool_impl_t* impl = (tb_thread_pool_impl_t*)pool;
     tb_assert_and_check_return_val(impl && done, tb_false);
 
-    // init the post size
-    tb_size_t post_size = 0;
-
-    // enter
-    tb_spinlock_enter(&impl->lock);
-
-    // done
-    tb_bool_t ok = tb_false;
-    do
-    {
-        // stoped?
-        tb_check_break(!impl->bstoped);
-
-        // init task
-        tb_thread_pool_task_t task = {0};
-        task.name       = name;
-        task.done       = done;
-        task.exit       = exit;
-        task.priv       = priv;
-        task.urgent     = urgent;
-
-        // post task
-        tb_thread_pool_job_t* job = tb_thread_pool_jobs_post_task(impl, &task, &post_size);
-        tb_assert_and_check_break(job);
-
-        // ok
-        ok = tb_true;
-
-    } while (0);
-
-    // leave
-    tb_spinlock_leave(&impl->lock);
-
-    // post the workers
-    if (ok && post_size) tb_thread_pool_worker_post(impl, post_size);
-
-    // ok?
-    return ok;
+    // init task
+    tb_thread_pool_task_t task = {0};
+    task.name       = name;
+    task.done       = done;
+    task.exit       = exit;
+    task.priv       = priv;
+    task.urgent     = urgent;
+    task.group      = group;
+
+    // post task
+    return tb_thread_pool_task_post_list(pool, &task, 1) == 1;
 }
 tb_size_t tb_thread_pool_task_post_list(tb_thread_pool_ref_t pool, tb_thread_pool_task_t const* list, tb_size_t size)
 {
@@ -1039,31 +1300,51 @@ tb_size_t tb_thread_pool_task_post_list(tb_thread_pool_ref_t pool, tb_thread_poo
     tb_thread_pool_impl_t* impl = (tb_thread_pool_impl_t*)pool;
     tb_assert_and_check_return_val(impl && list, 0);
 
-    // init the post size
-    tb_size_t post_size = 0;
+    // stoped?
+    tb_check_return_val(!tb_atomic_flag_test(&impl->bstoped), 0);
 
-    // enter
-    tb_spinlock_enter(&impl->lock);
-
-    // done
-    tb_size_t ok = 0;
-    if (!impl->bstoped)
+    // post all tasks
+    tb_size_t                   i = 0;
+    tb_size_t                   ok = 0;
+    tb_size_t                   posted[TB_THREAD_POOL_GROUP_MAXN] = {0};
+    tb_thread_pool_job_t*       jobs[TB_THREAD_POOL_SHARD_PULL_MAXN];
+    tb_thread_pool_worker_t*    worker = tb_thread_pool_worker_self(impl);
+    while (ok < size)
     {
-        for (ok = 0; ok < size; ok++)
+        // make jobs
+        tb_size_t count = tb_thread_pool_jobs_alloc(impl, worker, list + ok, tb_min(size - ok, tb_arrayn(jobs)), 1, jobs);
+        tb_check_break(count);
+
+        // post to the local deque if we are in the worker thread, otherwise post to the injection queue of their groups
+        if (worker)
         {
-            // post task
-            tb_thread_pool_job_t* job = tb_thread_pool_jobs_post_task(impl, &list[ok], &post_size);
-            tb_assert_and_check_break(job);
+            for (i = 0; i < count; i++) tb_thread_pool_jobs_post(worker, jobs[i]);
         }
+        else
+        {
+            tb_size_t first = 0;
+            for (i = 1; i <= count; i++)
+            {
+                if (i == count || jobs[i]->group != jobs[first]->group)
+                {
+                    tb_thread_pool_jobs_inject(tb_null, jobs + first, i - first);
+                    first = i;
+                }
+            }
+        }
+        for (i = 0; i < count; i++) posted[jobs[i]->group->index]++;
+        ok += count;
     }
 
-    // leave
-    tb_spinlock_leave(&impl->lock);
-
-    // post the workers
-    if (ok && post_size) tb_thread_pool_worker_post(impl, post_size);
-
-    // ok?
+    // init workers and notify them
+    for (i = 0; i < impl->group_count; i++)
+    {
+        if (posted[i])
+        {
+            tb_thread_pool_worker_spawn(impl, &impl->groups[i]);
+            tb_thread_pool_worker_post(&impl->groups[i], posted[i]);
+        }
+    }
     return ok;
 }
 tb_thread_pool_task_ref_t tb_thread_pool_task_init(tb_thread_pool_ref_t pool, tb_char_t const* name, tb_thread_pool_task_done_func_t done, tb_thread_pool_task_exit_func_t exit, tb_cpointer_t priv, tb_bool_t urgent)
@@ -1072,49 +1353,30 @@ tb_thread_pool_task_ref_t tb_thread_pool_task_init(tb_thread_pool_ref_t pool, tb
     tb_thread_pool_impl_t* impl = (tb_thread_pool_impl_t*)pool;
     tb_assert_and_check_return_val(impl && done, tb_null);
 
-    // init the post size
-    tb_size_t post_size = 0;
-
-    // enter
-    tb_spinlock_enter(&impl->lock);
-
-    // done
-    tb_bool_t               ok = tb_false;
-    tb_thread_pool_job_t*   job = tb_null;
-    do
-    {
-        // stoped?
-        tb_check_break(!impl->bstoped);
-
-        // init task
-        tb_thread_pool_task_t task = {0};
-        task.name       = name;
-        task.done       = done;
-        task.exit       = exit;
-        task.priv       = priv;
-        task.urgent     = urgent;
+    // stoped?
+    tb_check_return_val(!tb_atomic_flag_test(&impl->bstoped), tb_null);
 
-        // post task
-        job = tb_thread_pool_jobs_post_task(impl, &task, &post_size);
-        tb_assert_and_check_break(job);
+    // init task
+    tb_thread_pool_task_t task = {0};
+    task.name       = name;
+    task.done       = done;
+    task.exit       = exit;
+    task.priv       = priv;
+    task.urgent     = urgent;
 
-        // refn++
-        job->refn++;
+    // make job, it is referenced by the worker and the caller
+    tb_thread_pool_job_t*       job = tb_null;
+    tb_thread_pool_worker_t*    worker = tb_thread_pool_worker_self(impl);
+    tb_check_return_val(tb_thread_pool_jobs_alloc(impl, worker, &task, 1, 2, &job), tb_null);
 
-        // ok
-        ok = tb_true;
-
-    } while (0);
+    // post job
+    tb_thread_pool_jobs_post(worker, job);
 
-    // leave
-    tb_spinlock_leave(&impl->lock);
-
-    // post the workers
-    if (ok && post_size) tb_thread_pool_worker_post(impl, post_size);
-    // failed?
-    else if (!ok) job = tb_null;
+    // init workers and notify them
+    tb_thread_pool_worker_spawn(impl, job->group);
+    tb_thread_pool_worker_post(job->group, 1);
 
-    // ok?
+    // ok
     return (tb_thread_pool_task_ref_t)job;
 }
 tb_void_t tb_thread_pool_task_kill(tb_thread_pool_ref_t pool, tb_thread_pool_task_ref_t task)
@@ -1136,14 +1398,14 @@ tb_void_t tb_thread_pool_task_kill_all(tb_thread_pool_ref_t pool)
     tb_assert_and_check_return(impl);
 
     // enter
-    tb_spinlock_enter(&impl->lock);
+    tb_futexlock_enter(&impl->lock);
 
     // kill all jobs
-    if (!impl->bstoped && impl->jobs_pool)
+    if (!tb_atomic_flag_test(&impl->bstoped) && impl->jobs_pool)
         tb_fixed_pool_walk(impl->jobs_pool, tb_thread_pool_jobs_walk_kill_all, tb_null);
 
     // leave
-    tb_spinlock_leave(&impl->lock);
+    tb_futexlock_leave(&impl->lock);
 }
 tb_long_t tb_thread_pool_task_wait(tb_thread_pool_ref_t pool, tb_thread_pool_task_ref_t task, tb_long_t timeout)
 {
@@ -1179,28 +1441,11 @@ tb_long_t tb_thread_pool_task_wait_all(tb_thread_pool_ref_t pool, tb_long_t time
     tb_hong_t time = tb_cache_time_spak();
     while ((timeout < 0 || tb_cache_time_spak() < time + timeout))
     {
-        // enter
-        tb_spinlock_enter(&impl->lock);
-
         // the jobs count
-        size = impl->jobs_pool? tb_fixed_pool_size(impl->jobs_pool) : 0;
+        size = (tb_size_t)tb_max(tb_percpu_counter_sum(&impl->jobs_count), 0);
 
         // trace
-        tb_trace_d("wait: jobs: %lu, waiting: %lu, pending: %lu, urgent: %lu: .."
-                    , size
-                    , tb_list_entry_size(&impl->jobs_waiting)
-                    , tb_list_entry_size(&impl->jobs_pending)
-                    , tb_list_entry_size(&impl->jobs_urgent));
-
-#if 0
-        tb_for_all_if (tb_thread_pool_job_t*, job, tb_list_entry_itor(&impl->jobs_pending), job)
-        {
-            tb_trace_d("wait: job: %s from pending", tb_state_cstr(tb_atomic32_get(&job->state)));
-        }
-#endif
-
-        // leave
-        tb_spinlock_leave(&impl->lock);
+        tb_trace_d("wait: jobs: %lu: ..", size);
 
         // ok?
         tb_check_break(size);
@@ -1222,16 +1467,8 @@ tb_void_t tb_thread_pool_task_exit(tb_thread_pool_ref_t pool, tb_thread_pool_tas
     // kill it first
     tb_thread_pool_task_kill(pool, task);
 
-    // enter
-    tb_spinlock_enter(&impl->lock);
-
-    // refn--
-    if (job->refn > 1) job->refn--;
-    // remove it from pool directly
-    else tb_fixed_pool_free(impl->jobs_pool, job);
-
-    // leave
-    tb_spinlock_leave(&impl->lock);
+    // refn--, the job will be freed if it has been finished or killed
+    tb_thread_pool_jobs_exit(impl, tb_thread_pool_worker_self(impl), job);
 }
 #ifdef __tb_debug__
 tb_void_t tb_thread_pool_dump(tb_thread_pool_ref_t pool)
@@ -1241,42 +1478,55 @@ tb_void_t tb_thread_pool_dump(tb_thread_pool_ref_t pool)
     tb_assert_and_check_return(impl);
 
     // enter
-    tb_spinlock_enter(&impl->lock);
+    tb_futexlock_enter(&impl->lock);
 
-    // dump workers
-    if (impl->worker_size)
+    // dump groups
+    tb_size_t i = 0;
+    tb_size_t j = 0;
+    tb_size_t worker_size = 0;
+    for (j = 0; j < impl->group_count; j++)
     {
+        // the group
+        tb_thread_pool_group_t* group = &impl->groups[j];
+
+        // no workers?
+        tb_size_t n = (tb_size_t)tb_atomic_get(&group->worker_size);
+        tb_check_continue(n);
+
         // trace
         tb_trace_i("");
-        tb_trace_i("workers: size: %lu, maxn: %lu", impl->worker_size, impl->worker_maxn);
+        tb_trace_i("group[%s]: workers: size: %lu, maxn: %lu, idle: %ld, cpus: %d, jobs: %ld, urgent: %ld", group->name, n, group->worker_maxn
+            , (tb_long_t)tb_atomic_get(&group->idle), TB_CPUSET_COUNT(&group->cpuset), (tb_long_t)tb_percpu_counter_sum(&group->jobs_count), (tb_long_t)tb_atomic_get(&group->jobs_urgent));
 
         // walk
-        tb_size_t i = 0;
-        for (i = 0; i < impl->worker_size; i++)
+        for (i = 0; i < n; i++)
         {
             // the worker
-            tb_thread_pool_worker_t* worker = &impl->worker_list[i];
-            tb_assert_and_check_break(worker);
+            tb_thread_pool_worker_t* worker = &impl->worker_list[group->worker_base + i];
 
             // dump worker
-            tb_trace_i("    worker: id: %lu, stoped: %ld", worker->id, (tb_long_t)tb_atomic_flag_test_explicit(&worker->bstoped, TB_ATOMIC_RELAXED));
+            tb_trace_i("    worker: id: %lu, stoped: %ld, deque: %lu, cache: %lu", worker->id, (tb_long_t)tb_atomic_flag_test_explicit(&worker->bstoped, TB_ATOMIC_RELAXED)
+                , worker->deque? tb_thread_pool_deque_size(worker->deque) : 0, worker->cache_size);
         }
 
+        // dump shards
+        for (i = 0; i < TB_THREAD_POOL_SHARD_MAXN; i++)
+            tb_trace_i("    shard[%lu]: jobs: %ld", i, (tb_long_t)tb_atomic_get(&group->shards[i].size));
+        worker_size += n;
+    }
+
+    // dump all jobs
+    if (worker_size && impl->jobs_pool)
+    {
         // trace
         tb_trace_i("");
+        tb_trace_i("jobs: size: %ld", (tb_long_t)tb_percpu_counter_sum(&impl->jobs_count));
 
-        // dump all jobs
-        if (impl->jobs_pool)
-        {
-            // trace
-            tb_trace_i("jobs: size: %lu", tb_fixed_pool_size(impl->jobs_pool));
-
-            // dump jobs
-            tb_fixed_pool_walk(impl->jobs_pool, tb_thread_pool_jobs_walk_dump_all, tb_null);
-        }
+        // dump jobs
+        tb_fixed_pool_walk(impl->jobs_pool, tb_thread_pool_jobs_walk_dump_all, tb_null);
     }
 
     // leave
-    tb_spinlock_leave(&impl->lock);
+    tb_futexlock_leave(&impl->lock);
 }
 #endif
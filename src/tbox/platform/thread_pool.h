@@ -26,6 +26,7 @@
  * includes
  */
 #include "prefix.h"
+#include "sched.h"
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * extern
@@ -43,6 +44,16 @@ __tb_extern_c_enter__
 #   define TB_THREAD_POOL_WORKER_PRIV_MAXN      (32)
 #endif
 
+/// the thread pool worker groups maximum count, including the numa node groups
+#ifdef __tb_small__
+#   define TB_THREAD_POOL_GROUP_MAXN            (4)
+#else
+#   define TB_THREAD_POOL_GROUP_MAXN            (16)
+#endif
+
+/// the default worker group, it will be the group of the poster's numa node in numa mode
+#define TB_THREAD_POOL_GROUP_DEFAULT            (0)
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * types
  */
@@ -83,8 +94,51 @@ typedef struct __tb_thread_pool_task_t
     /// is urgent task?
     tb_bool_t                           urgent;
 
+    /// the worker group, TB_THREAD_POOL_GROUP_DEFAULT or the named group from tb_thread_pool_group()
+    tb_size_t                           group;
+
 }tb_thread_pool_task_t;
 
+/// the thread pool worker group option type
+typedef struct __tb_thread_pool_group_option_t
+{
+    /// the group name
+    tb_char_t const*                    name;
+
+    /// the worker max count of this group
+    tb_size_t                           worker_maxn;
+
+    /// the cpu set, the workers will be pinned to these cpus if it is not empty
+    tb_cpuset_t                         cpuset;
+
+}tb_thread_pool_group_option_t;
+
+/// the thread pool option type
+typedef struct __tb_thread_pool_option_t
+{
+    /// the worker max count of the default group, using the default count if be zero
+    tb_size_t                           worker_maxn;
+
+    /// the thread stack, using the default stack size if be zero
+    tb_size_t                           stack;
+
+    /// the cpu set of the default group, the workers will be pinned to these cpus if it is not empty
+    tb_cpuset_t                         cpuset;
+
+    /*! split the default group to one group per numa node
+     *
+     * the workers will be pinned to the cpus of their node, and they will steal the jobs of the other nodes only if they are idle.
+     */
+    tb_bool_t                           numa;
+
+    /// the named worker groups, the latency-critical and batch tasks can run on the separate cpus
+    tb_thread_pool_group_option_t const* groups;
+
+    /// the named worker groups count
+    tb_size_t                           groups_count;
+
+}tb_thread_pool_option_t;
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * interfaces
  */
@@ -104,6 +158,33 @@ tb_thread_pool_ref_t        tb_thread_pool(tb_noarg_t);
  */
 tb_thread_pool_ref_t        tb_thread_pool_init(tb_size_t worker_maxn, tb_size_t stack);
 
+/*! init thread pool with the given option
+ *
+ * @code
+    tb_thread_pool_group_option_t groups[1] = {{0}};
+    groups[0].name          = "latency";
+    groups[0].worker_maxn   = 2;
+    TB_CPUSET_SET(0, &groups[0].cpuset);
+    TB_CPUSET_SET(1, &groups[0].cpuset);
+
+    tb_thread_pool_option_t option = {0};
+    option.numa             = tb_true;
+    option.groups           = groups;
+    option.groups_count     = tb_arrayn(groups);
+    tb_thread_pool_ref_t pool = tb_thread_pool_init_ext(&option);
+    if (pool)
+    {
+        tb_thread_pool_task_post_group(pool, tb_thread_pool_group(pool, "latency"), "task", done, tb_null, priv, tb_false);
+        tb_thread_pool_exit(pool);
+    }
+ * @endcode
+ *
+ * @param option            the thread pool option
+ *
+ * @return                  the thread pool
+ */
+tb_thread_pool_ref_t        tb_thread_pool_init_ext(tb_thread_pool_option_t const* option);
+
 /*! exit thread pool
  *
  * @param pool              the thread pool
@@ -126,6 +207,15 @@ tb_void_t                   tb_thread_pool_kill(tb_thread_pool_ref_t pool);
  */
 tb_size_t                   tb_thread_pool_worker_size(tb_thread_pool_ref_t pool);
 
+/*! get the named worker group
+ *
+ * @param pool              the thread pool
+ * @param name              the group name
+ *
+ * @return                  the group, TB_THREAD_POOL_GROUP_DEFAULT if not found
+ */
+tb_size_t                   tb_thread_pool_group(tb_thread_pool_ref_t pool, tb_char_t const* name);
+
 /*! set the worker private data
  *
  * @param worker            the thread pool worker
@@ -165,6 +255,20 @@ tb_size_t                   tb_thread_pool_task_size(tb_thread_pool_ref_t pool);
  */
 tb_bool_t                   tb_thread_pool_task_post(tb_thread_pool_ref_t pool, tb_char_t const* name, tb_thread_pool_task_done_func_t done, tb_thread_pool_task_exit_func_t exit, tb_cpointer_t priv, tb_bool_t urgent);
 
+/*! post one task to the given worker group
+ *
+ * @param pool              the thread pool
+ * @param group             the worker group
+ * @param name              the task name, optional
+ * @param done              the task done func
+ * @param exit              the task exit func, optional
+ * @param priv              the task private data
+ * @param urgent            is urgent task?
+ *
+ * @return                  tb_true or tb_false
+ */
+tb_bool_t                   tb_thread_pool_task_post_group(tb_thread_pool_ref_t pool, tb_size_t group, tb_char_t const* name, tb_thread_pool_task_done_func_t done, tb_thread_pool_task_exit_func_t exit, tb_cpointer_t priv, tb_bool_t urgent);
+
 /*! post task list
  *
  * @param pool              the thread pool
@@ -0,0 +1,216 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        tsc.c
+ * @ingroup     platform
+ *
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * trace
+ */
+#define TB_TRACE_MODULE_NAME            "tsc"
+#define TB_TRACE_MODULE_DEBUG           (0)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "tsc.h"
+#include "time.h"
+#include "atomic.h"
+#include "thread.h"
+#if defined(TB_CONFIG_OS_WINDOWS)
+#   include "windows/prefix.h"
+#elif defined(TB_CONFIG_POSIX_HAVE_CLOCK_GETTIME)
+#   include <time.h>
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the calibration time, ns
+#define TB_TSC_CALIBRATE_TIME       (10000000)
+
+// the calibrated state of tb_thread_once()
+#define TB_TSC_CALIBRATED           (2)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the tsc type
+typedef struct __tb_tsc_t
+{
+    // is invariant? we only use the counter for tb_tsc_clock() if it is invariant
+    tb_bool_t               invariant;
+
+    // the frequency
+    tb_hong_t               frequency;
+
+    // the multiplier and shift for converting ticks to ns, ns = (ticks * mult) >> shift
+    tb_uint64_t             mult;
+    tb_size_t               shift;
+
+    // the base ticks and clock
+    tb_hong_t               base_ticks;
+    tb_hong_t               base_clock;
+
+}tb_tsc_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * globals
+ */
+
+// the tsc
+static tb_tsc_t             g_tsc;
+
+// the calibration once
+static tb_atomic32_t        g_tsc_once = 0;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static tb_hong_t tb_tsc_system_clock()
+{
+#if defined(TB_CONFIG_OS_WINDOWS)
+    LARGE_INTEGER f = {{0}};
+    LARGE_INTEGER t = {{0}};
+    if (!QueryPerformanceFrequency(&f) || !f.QuadPart || !QueryPerformanceCounter(&t)) return tb_uclock() * 1000;
+    return (t.QuadPart / f.QuadPart) * 1000000000 + ((t.QuadPart % f.QuadPart) * 1000000000) / f.QuadPart;
+#elif defined(TB_CONFIG_POSIX_HAVE_CLOCK_GETTIME) && defined(CLOCK_MONOTONIC)
+    // it does not enter the kernel if the vDSO is supported
+    struct timespec ts = {0};
+    if (clock_gettime(CLOCK_MONOTONIC, &ts)) return tb_uclock() * 1000;
+    return (tb_hong_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+#else
+    return tb_uclock() * 1000;
+#endif
+}
+#if defined(TB_TSC_HAVE_COUNTER) && (defined(TB_ARCH_x86) || defined(TB_ARCH_x64))
+static tb_void_t tb_tsc_cpuid(tb_uint32_t leaf, tb_uint32_t regs[4])
+{
+    __tb_asm__ __tb_volatile__ ("cpuid" : "=a" (regs[0]), "=b" (regs[1]), "=c" (regs[2]), "=d" (regs[3]) : "a" (leaf), "c" (0));
+}
+#endif
+static tb_bool_t tb_tsc_detect_invariant()
+{
+#if defined(TB_TSC_HAVE_COUNTER) && (defined(TB_ARCH_x86) || defined(TB_ARCH_x64))
+    // cpuid.80000007h:edx[8] is the invariant tsc bit
+    tb_uint32_t regs[4] = {0};
+    tb_tsc_cpuid(0x80000000, regs);
+    if (regs[0] < 0x80000007) return tb_false;
+    tb_tsc_cpuid(0x80000007, regs);
+    return (regs[3] & (1 << 8))? tb_true : tb_false;
+#elif defined(TB_TSC_HAVE_COUNTER)
+    // the generic timer of arm64 always runs at a constant rate
+    return tb_true;
+#else
+    return tb_false;
+#endif
+}
+static tb_hong_t tb_tsc_detect_frequency()
+{
+#if defined(TB_TSC_HAVE_COUNTER) && (defined(TB_ARCH_x86) || defined(TB_ARCH_x64))
+    // get the tsc frequency from cpuid.15h if the crystal clock frequency is enumerated
+    tb_uint32_t regs[4] = {0};
+    tb_tsc_cpuid(0, regs);
+    if (regs[0] >= 0x15)
+    {
+        tb_tsc_cpuid(0x15, regs);
+        if (regs[0] && regs[1] && regs[2])
+            return (tb_hong_t)(((tb_uint64_t)regs[2] * regs[1]) / regs[0]);
+    }
+
+    // calibrate it with the system clock
+    tb_hong_t clock0 = tb_tsc_system_clock();
+    tb_hong_t ticks0 = tb_tsc_ticks();
+    tb_hong_t clock1 = clock0;
+    tb_hong_t ticks1 = ticks0;
+    do
+    {
+        clock1 = tb_tsc_system_clock();
+        ticks1 = tb_tsc_ticks();
+
+    } while (clock1 - clock0 < TB_TSC_CALIBRATE_TIME);
+    return ((ticks1 - ticks0) * 1000000000) / (clock1 - clock0);
+#elif defined(TB_TSC_HAVE_COUNTER)
+    tb_uint64_t frequency;
+    __tb_asm__ __tb_volatile__ ("mrs %0, cntfrq_el0" : "=r" (frequency));
+    return (tb_hong_t)frequency;
+#else
+    // it is the ns-clock
+    return 1000000000;
+#endif
+}
+static tb_bool_t tb_tsc_calibrate(tb_cpointer_t priv)
+{
+    // detect the counter
+    tb_tsc_t* tsc = &g_tsc;
+    tsc->frequency = tb_tsc_detect_frequency();
+    tsc->invariant = tsc->frequency > 0 && tb_tsc_detect_invariant();
+    if (tsc->frequency <= 0) tsc->frequency = 1000000000;
+
+    // compute the multiplier and shift, the multiplier need be less than 2^32 to avoid overflow
+    tsc->shift = 32;
+    while (tsc->shift && ((tb_uint64_t)1000000000 << tsc->shift) / (tb_uint64_t)tsc->frequency >= ((tb_uint64_t)1 << 32))
+        tsc->shift--;
+    tsc->mult = ((tb_uint64_t)1000000000 << tsc->shift) / (tb_uint64_t)tsc->frequency;
+
+    // init the base ticks and clock
+    tsc->base_clock = tb_tsc_system_clock();
+    tsc->base_ticks = tb_tsc_ticks();
+
+    // trace
+    tb_trace_d("frequency: %lld, invariant: %d, mult: %llu, shift: %lu", tsc->frequency, tsc->invariant, tsc->mult, tsc->shift);
+    return tb_true;
+}
+static __tb_inline__ tb_tsc_t const* tb_tsc()
+{
+    // calibrate it for the first time
+    if (tb_atomic32_get_explicit(&g_tsc_once, TB_ATOMIC_ACQUIRE) != TB_TSC_CALIBRATED)
+        tb_thread_once(&g_tsc_once, tb_tsc_calibrate, tb_null);
+    return &g_tsc;
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+tb_hong_t tb_tsc_clock()
+{
+#ifdef TB_TSC_HAVE_COUNTER
+    tb_tsc_t const* tsc = tb_tsc();
+    if (tsc->invariant) return tsc->base_clock + tb_tsc_ticks_to_ns(tb_tsc_ticks() - tsc->base_ticks);
+#endif
+    return tb_tsc_system_clock();
+}
+tb_hong_t tb_tsc_ticks_to_ns(tb_hong_t ticks)
+{
+    // split ticks to avoid overflow, (ticks * mult) >> shift = ((hi * mult) << (32 - shift)) + ((lo * mult) >> shift)
+    tb_tsc_t const* tsc = tb_tsc();
+    tb_uint64_t     t = (tb_uint64_t)(ticks < 0? -ticks : ticks);
+    tb_uint64_t     ns = (((t >> 32) * tsc->mult) << (32 - tsc->shift)) + (((t & 0xffffffff) * tsc->mult) >> tsc->shift);
+    return ticks < 0? -(tb_hong_t)ns : (tb_hong_t)ns;
+}
+tb_hong_t tb_tsc_frequency()
+{
+    return tb_tsc()->frequency;
+}
+tb_bool_t tb_tsc_invariant()
+{
+    return tb_tsc()->invariant;
+}
@@ -0,0 +1,108 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        tsc.h
+ * @ingroup     platform
+ *
+ */
+#ifndef TB_PLATFORM_TSC_H
+#define TB_PLATFORM_TSC_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// have the cpu cycle counter?
+#if (defined(TB_ARCH_x86) || defined(TB_ARCH_x64) || defined(TB_ARCH_ARM64)) && defined(TB_ASSEMBLER_IS_GAS)
+#   define TB_TSC_HAVE_COUNTER
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/*! the monotonic ns-clock
+ *
+ * it uses the calibrated cpu cycle counter if it is invariant,
+ * otherwise it uses the monotonic clock of the system (vDSO on linux)
+ *
+ * @return              the now ns-clock
+ */
+tb_hong_t               tb_tsc_clock(tb_noarg_t);
+
+/*! convert the counter ticks to ns
+ *
+ * @param ticks         the ticks of tb_tsc_ticks()
+ *
+ * @return              the ns
+ */
+tb_hong_t               tb_tsc_ticks_to_ns(tb_hong_t ticks);
+
+/*! the frequency of the counter
+ *
+ * @return              the ticks per second
+ */
+tb_hong_t               tb_tsc_frequency(tb_noarg_t);
+
+/*! is the counter invariant?
+ *
+ * the invariant counter runs at a constant rate in all ACPI P-, C- and T-states
+ *
+ * @return              tb_true or tb_false
+ */
+tb_bool_t               tb_tsc_invariant(tb_noarg_t);
+
+/*! the raw ticks of the cpu cycle counter
+ *
+ * it only costs a few cycles and it is used to measure the short intervals,
+ * we need call tb_tsc_ticks_to_ns() to convert the ticks difference to ns.
+ *
+ * @note it is tb_tsc_clock() if the cpu cycle counter is not supported
+ *
+ * @return              the ticks
+ */
+static __tb_inline_force__ tb_hong_t tb_tsc_ticks()
+{
+#if defined(TB_TSC_HAVE_COUNTER) && (defined(TB_ARCH_x86) || defined(TB_ARCH_x64))
+    tb_uint32_t lo, hi;
+    __tb_asm__ __tb_volatile__ ("rdtsc" : "=a" (lo), "=d" (hi));
+    return (tb_hong_t)(((tb_uint64_t)hi << 32) | lo);
+#elif defined(TB_TSC_HAVE_COUNTER)
+    tb_uint64_t ticks;
+    __tb_asm__ __tb_volatile__ ("isb\n mrs %0, cntvct_el0" : "=r" (ticks) :: "memory");
+    return (tb_hong_t)ticks;
+#else
+    return tb_tsc_clock();
+#endif
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
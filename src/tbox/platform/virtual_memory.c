@@ -47,3 +47,20 @@ tb_bool_t tb_virtual_memory_free(tb_pointer_t data)
 }
 #endif
 
+#if !defined(TB_CONFIG_OS_WINDOWS) && !(defined(TB_CONFIG_POSIX_HAVE_MMAP) && defined(TB_CONFIG_POSIX_HAVE_MEMFD_CREATE))
+tb_size_t tb_virtual_memory_mirror_size(tb_size_t size)
+{
+    return 0;
+}
+tb_pointer_t tb_virtual_memory_mirror_malloc(tb_size_t size)
+{
+    tb_trace_noimpl();
+    return tb_null;
+}
+tb_bool_t tb_virtual_memory_mirror_free(tb_pointer_t data, tb_size_t size)
+{
+    tb_trace_noimpl();
+    return tb_false;
+}
+#endif
+
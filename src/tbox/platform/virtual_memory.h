@@ -68,6 +68,34 @@ tb_pointer_t            tb_virtual_memory_ralloc(tb_pointer_t data, tb_size_t si
  */
 tb_bool_t               tb_virtual_memory_free(tb_pointer_t data);
 
+/*! get the aligned size of the mirrored virtual memory
+ *
+ * @param size          the size
+ *
+ * @return              the size aligned to the page or allocation granularity, 0 if mirror is not supported
+ */
+tb_size_t               tb_virtual_memory_mirror_size(tb_size_t size);
+
+/*! malloc the mirrored virtual memory
+ *
+ * the same physical pages are mapped twice back-to-back,
+ * so [data, data + size) and [data + size, data + size * 2) always see the same bytes.
+ *
+ * @param size          the size, must be aligned by tb_virtual_memory_mirror_size()
+ *
+ * @return              the data address of the size * 2 bytes, tb_null if failed
+ */
+tb_pointer_t            tb_virtual_memory_mirror_malloc(tb_size_t size);
+
+/*! free the mirrored virtual memory
+ *
+ * @param data          the data address
+ * @param size          the size
+ *
+ * @return              tb_true or tb_false
+ */
+tb_bool_t               tb_virtual_memory_mirror_free(tb_pointer_t data, tb_size_t size);
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * extern
  */
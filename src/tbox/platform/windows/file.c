@@ -344,6 +344,46 @@ tb_long_t tb_file_pwritv(tb_file_ref_t file, tb_iovec_t const* list, tb_size_t s
     // ok
     return real;
 }
+tb_byte_t const* tb_file_mmap(tb_file_ref_t file, tb_hize_t offset, tb_size_t size, tb_size_t advice)
+{
+    // check
+    tb_assert_and_check_return_val(file && size, tb_null);
+
+    // the offset of view must be aligned by the allocation granularity
+    SYSTEM_INFO info = {0};
+    GetSystemInfo(&info);
+    tb_assert_and_check_return_val(info.dwAllocationGranularity, tb_null);
+    tb_size_t adjust = (tb_size_t)(offset % info.dwAllocationGranularity);
+    tb_hize_t start = offset - adjust;
+
+    // map it, the view will hold the file mapping after closing it
+    HANDLE mapping = CreateFileMappingW((HANDLE)file, tb_null, PAGE_READONLY, 0, 0, tb_null);
+    tb_check_return_val(mapping, tb_null);
+    tb_byte_t* base = (tb_byte_t*)MapViewOfFile(mapping, FILE_MAP_READ, (DWORD)(start >> 32), (DWORD)start, (SIZE_T)(size + adjust));
+    CloseHandle(mapping);
+
+    // ok?
+    return base? base + adjust : tb_null;
+}
+tb_bool_t tb_file_munmap(tb_byte_t const* data, tb_size_t size)
+{
+    // check
+    tb_assert_and_check_return_val(data && size, tb_false);
+
+    // get the base address of view
+    SYSTEM_INFO info = {0};
+    GetSystemInfo(&info);
+    tb_assert_and_check_return_val(info.dwAllocationGranularity, tb_false);
+    tb_byte_t const* base = data - ((tb_size_t)data % info.dwAllocationGranularity);
+
+    // unmap it
+    return UnmapViewOfFile(base)? tb_true : tb_false;
+}
+tb_bool_t tb_file_advise(tb_file_ref_t file, tb_hize_t offset, tb_hize_t size, tb_size_t advice)
+{
+    // the sequential scan hint can only be passed to CreateFile on windows
+    return tb_false;
+}
 tb_bool_t tb_file_sync(tb_file_ref_t file)
 {
     // check
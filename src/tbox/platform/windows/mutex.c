@@ -75,11 +75,18 @@ tb_void_t tb_mutex_exit(tb_mutex_ref_t mutex)
 }
 tb_bool_t tb_mutex_enter(tb_mutex_ref_t mutex)
 {
-    // try to enter for profiler
 #ifdef TB_LOCK_PROFILER_ENABLE
+    // try to enter for profiler
     if (tb_mutex_enter_try(mutex)) return tb_true;
-#endif
+
+    // wait it and profile the wait time
+    tb_hong_t ticks = tb_lock_profiler_ticks();
+    tb_bool_t ok = tb_mutex_enter_without_profiler(mutex);
+    if (ok) tb_lock_profiler_entered(tb_lock_profiler(), (tb_handle_t)mutex, tb_lock_profiler_ticks() - ticks);
+    return ok;
+#else
     return tb_mutex_enter_without_profiler(mutex);
+#endif
 }
 tb_bool_t tb_mutex_enter_try(tb_mutex_ref_t mutex)
 {
@@ -96,6 +103,11 @@ tb_bool_t tb_mutex_enter_try(tb_mutex_ref_t mutex)
 }
 tb_bool_t tb_mutex_leave(tb_mutex_ref_t mutex)
 {
-    if (mutex) return ReleaseMutex((HANDLE)mutex)? tb_true : tb_false;
-    return tb_false;
+    tb_check_return_val(mutex, tb_false);
+
+#ifdef TB_LOCK_PROFILER_ENABLE
+    // profile the hold time
+    tb_lock_profiler_leave((tb_handle_t)mutex);
+#endif
+    return ReleaseMutex((HANDLE)mutex)? tb_true : tb_false;
 }
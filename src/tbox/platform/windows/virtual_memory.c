@@ -80,3 +80,76 @@ tb_bool_t tb_virtual_memory_free(tb_pointer_t data)
     return tb_true;
 }
 
+static tb_size_t tb_virtual_memory_mirror_granularity()
+{
+    // the views must be aligned to the allocation granularity
+    SYSTEM_INFO info = {0};
+    GetSystemInfo(&info);
+    return info.dwAllocationGranularity;
+}
+tb_size_t tb_virtual_memory_mirror_size(tb_size_t size)
+{
+    tb_size_t granularity = tb_virtual_memory_mirror_granularity();
+    tb_assert_and_check_return_val(granularity, 0);
+    return tb_align(size, granularity);
+}
+tb_pointer_t tb_virtual_memory_mirror_malloc(tb_size_t size)
+{
+    // check
+    tb_size_t granularity = tb_virtual_memory_mirror_granularity();
+    tb_assert_and_check_return_val(granularity && size && size == tb_align(size, granularity), tb_null);
+
+    // make an anonymous file mapping as the physical pages
+    tb_uint64_t maxn = (tb_uint64_t)size;
+    HANDLE      mapping = CreateFileMappingW(INVALID_HANDLE_VALUE, tb_null, PAGE_READWRITE, (DWORD)(maxn >> 32), (DWORD)maxn, tb_null);
+    tb_assert_and_check_return_val(mapping, tb_null);
+
+    /* find a free address range of the double size and map the same pages twice back-to-back
+     *
+     * we also commit a readable leading block, because tb_pool_data_size() will read the data head
+     * before the data address when checking memory in debug mode
+     *
+     * @note other threads may take this range after we release it, so we need retry it
+     */
+    tb_byte_t*  data = tb_null;
+    tb_size_t   tryn = 8;
+    while (tryn-- && !data)
+    {
+        // reserve and release the address range
+        tb_byte_t* base = (tb_byte_t*)VirtualAlloc(tb_null, granularity + (size << 1), MEM_RESERVE, PAGE_NOACCESS);
+        tb_assert_and_check_break(base);
+        VirtualFree(base, 0, MEM_RELEASE);
+
+        // commit the leading block
+        if (VirtualAlloc(base, granularity, MEM_RESERVE | MEM_COMMIT, PAGE_READONLY) != base) continue;
+
+        // map the two views
+        tb_byte_t* view = base + granularity;
+        if (MapViewOfFileEx(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size, view) == view)
+        {
+            if (MapViewOfFileEx(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size, view + size) == view + size)
+                data = view;
+            else UnmapViewOfFile(view);
+        }
+
+        // failed? free the leading block
+        if (!data) VirtualFree(base, 0, MEM_RELEASE);
+    }
+
+    // the views will keep the mapping alive
+    CloseHandle(mapping);
+    return data;
+}
+tb_bool_t tb_virtual_memory_mirror_free(tb_pointer_t data, tb_size_t size)
+{
+    // check
+    tb_size_t granularity = tb_virtual_memory_mirror_granularity();
+    tb_assert_and_check_return_val(granularity && size, tb_false);
+    tb_check_return_val(data, tb_true);
+
+    // unmap the two views and free the leading block
+    tb_bool_t ok = UnmapViewOfFile((tb_byte_t*)data + size)? tb_true : tb_false;
+    if (!UnmapViewOfFile(data)) ok = tb_false;
+    if (!VirtualFree((tb_byte_t*)data - granularity, 0, MEM_RELEASE)) ok = tb_false;
+    return ok;
+}
@@ -280,6 +280,45 @@ tb_long_t tb_filter_spak(tb_filter_ref_t self, tb_byte_t const* data, tb_size_t
     // ok?
     return osize;
 }
+tb_long_t tb_filter_peek(tb_filter_ref_t self, tb_byte_t const* data, tb_size_t size, tb_size_t* phead)
+{
+    // check
+    tb_filter_t* filter = (tb_filter_t*)self;
+    tb_assert_and_check_return_val(filter && data && phead, -1);
+
+    // init head
+    *phead = 0;
+
+    // not supported?
+    tb_check_return_val(filter->peek && filter->skip, -1);
+
+    // check, cannot be mixed with spak
+    tb_assert_and_check_return_val(!tb_buffer_size(&filter->idata) && tb_queue_buffer_null(&filter->odata), -1);
+
+    // peek it
+    tb_long_t real = filter->peek(filter, data, size, phead);
+
+    // save the input offset
+    filter->offset += *phead;
+
+    // ok?
+    return real;
+}
+tb_bool_t tb_filter_skip(tb_filter_ref_t self, tb_size_t size)
+{
+    // check
+    tb_filter_t* filter = (tb_filter_t*)self;
+    tb_assert_and_check_return_val(filter && filter->skip, tb_false);
+
+    // skip it
+    tb_bool_t ok = filter->skip(filter, size);
+
+    // save the input offset
+    if (ok) filter->offset += size;
+
+    // ok?
+    return ok;
+}
 tb_bool_t tb_filter_push(tb_filter_ref_t self, tb_byte_t const* data, tb_size_t size)
 {
     // check
@@ -63,6 +63,8 @@ typedef enum __tb_filter_ctrl_e
 ,   TB_FILTER_CTRL_ZIP_GET_ACTION        = TB_FILTER_CTRL(TB_FILTER_TYPE_ZIP, 2)
 ,   TB_FILTER_CTRL_ZIP_SET_ALGO          = TB_FILTER_CTRL(TB_FILTER_TYPE_ZIP, 3)
 ,   TB_FILTER_CTRL_ZIP_SET_ACTION        = TB_FILTER_CTRL(TB_FILTER_TYPE_ZIP, 4)
+,   TB_FILTER_CTRL_ZIP_GET_PARALLEL      = TB_FILTER_CTRL(TB_FILTER_TYPE_ZIP, 5)
+,   TB_FILTER_CTRL_ZIP_SET_PARALLEL      = TB_FILTER_CTRL(TB_FILTER_TYPE_ZIP, 6)    //!< deflate gzip blocks in parallel with the given block size (>= 32K), disabled if be zero, only the finished blocks will be written for flushing
 
 ,   TB_FILTER_CTRL_CHARSET_GET_FTYPE     = TB_FILTER_CTRL(TB_FILTER_TYPE_CHARSET, 1)
 ,   TB_FILTER_CTRL_CHARSET_GET_TTYPE     = TB_FILTER_CTRL(TB_FILTER_TYPE_CHARSET, 2)
@@ -177,6 +179,45 @@ tb_bool_t               tb_filter_push(tb_filter_ref_t filter, tb_byte_t const*
  */
 tb_long_t               tb_filter_spak(tb_filter_ref_t filter, tb_byte_t const* data, tb_size_t size, tb_byte_t const** pdata, tb_size_t need, tb_long_t sync);
 
+/*! peek the filtered data from the input data directly without copying, only for the chunked filter now
+ *
+ * it parses the framing data at the head of the input data and the filtered data is at data + *phead,
+ * the caller need consume *phead bytes of the input data and call tb_filter_skip() for the used filtered data.
+ *
+ * @code
+ * tb_size_t head = 0;
+ * tb_long_t real = tb_filter_peek(filter, data, size, &head);
+ * if (real > 0)
+ * {
+ *     // use the data: data + head, real
+ *     // ...
+ *
+ *     // skip it
+ *     tb_filter_skip(filter, real);
+ * }
+ * // consume the input data: head + real
+ * @endcode
+ *
+ * @note it cannot be mixed with tb_filter_spak()
+ *
+ * @param filter        the filter
+ * @param data          the input data
+ * @param size          the input size
+ * @param phead         the parsed framing size at the head of the input data
+ *
+ * @return              > 0: the filtered size at data + *phead, 0: need more data, -1: end or not supported
+ */
+tb_long_t               tb_filter_peek(tb_filter_ref_t filter, tb_byte_t const* data, tb_size_t size, tb_size_t* phead);
+
+/*! skip the peeked data
+ *
+ * @param filter        the filter
+ * @param size          the skipped size, must be not larger than the peeked size
+ *
+ * @return              tb_true or tb_false
+ */
+tb_bool_t               tb_filter_skip(tb_filter_ref_t filter, tb_size_t size);
+
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * extern
@@ -66,6 +66,18 @@ typedef struct __tb_filter_t
     // the spak
     tb_long_t           (*spak)(struct __tb_filter_t* filter, tb_static_stream_ref_t istream, tb_static_stream_ref_t ostream, tb_long_t sync);
 
+    /* the peek, optional
+     *
+     * parse the framing data at the head of the input data and return the filtered data
+     * at data + *phead directly without copying, e.g. the chunk data of the chunked filter
+     *
+     * @return the filtered data size at data + *phead, 0: need more data, -1: end
+     */
+    tb_long_t           (*peek)(struct __tb_filter_t* filter, tb_byte_t const* data, tb_size_t size, tb_size_t* phead);
+
+    // the skip for the peeked data, optional
+    tb_bool_t           (*skip)(struct __tb_filter_t* filter, tb_size_t size);
+
     // the ctrl
     tb_bool_t           (*ctrl)(struct __tb_filter_t* filter, tb_size_t ctrl, tb_va_list_t args);
 
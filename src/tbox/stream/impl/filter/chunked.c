@@ -33,20 +33,34 @@
  * types
  */
 
+// the chunked state enum
+typedef enum __tb_filter_chunked_state_e
+{
+    TB_FILTER_CHUNKED_STATE_HEAD    = 0     //!< parsing the chunk size or the tail of the previous chunk
+,   TB_FILTER_CHUNKED_STATE_EXTN    = 1     //!< skipping the chunk extension until the line end
+,   TB_FILTER_CHUNKED_STATE_DATA    = 2     //!< reading the chunk data
+,   TB_FILTER_CHUNKED_STATE_TRAIL   = 3     //!< skipping the trailer lines after the last chunk
+,   TB_FILTER_CHUNKED_STATE_END     = 4     //!< end
+
+}tb_filter_chunked_state_e;
+
 // the chunked filter type
 typedef struct __tb_filter_chunked_t
 {
     // the filter base
     tb_filter_t     base;
 
+    // the state
+    tb_size_t                   state;
+
     // the chunked size
     tb_size_t                   size;
 
     // the chunked read
     tb_size_t                   read;
 
-    // the cache line
-    tb_string_t                 line;
+    // the size of the current line, not including '\r'
+    tb_size_t                   line;
 
 }tb_filter_chunked_t;
 
@@ -59,6 +73,125 @@ static __tb_inline__ tb_filter_chunked_t* tb_filter_chunked_cast(tb_filter_t* fi
     tb_assert_and_check_return_val(filter && filter->type == TB_FILTER_TYPE_CHUNKED, tb_null);
     return (tb_filter_chunked_t*)filter;
 }
+static __tb_inline__ tb_void_t tb_filter_chunked_reset(tb_filter_chunked_t* cfilter)
+{
+    cfilter->state  = TB_FILTER_CHUNKED_STATE_HEAD;
+    cfilter->size   = 0;
+    cfilter->read   = 0;
+    cfilter->line   = 0;
+}
+/* parse the chunk framing until the chunk data or the end
+ *
+ * the head line may be split into several input data, so we save the parsed state
+ * instead of caching the line data, and the data of the chunk will not be touched here.
+ *
+ * @return the parsed framing size, -1: invalid
+ */
+static tb_long_t tb_filter_chunked_head(tb_filter_chunked_t* cfilter, tb_byte_t const* data, tb_size_t size)
+{
+    // done
+    tb_byte_t const* p = data;
+    tb_byte_t const* e = data + size;
+    while (p < e)
+    {
+        // the line is ended?
+        tb_bool_t       lend = tb_false;
+        switch (cfilter->state)
+        {
+        case TB_FILTER_CHUNKED_STATE_HEAD:
+            {
+                // parse the hex size
+                tb_size_t ch = 0;
+                tb_size_t nb = 0;
+                while (p < e)
+                {
+                    ch = *p;
+                    if (ch >= '0' && ch <= '9') nb = ch - '0';
+                    else if ((ch | 0x20) >= 'a' && (ch | 0x20) <= 'f') nb = (ch | 0x20) - 'a' + 10;
+                    else break;
+
+                    // check overflow
+                    tb_assert_and_check_return_val(!(cfilter->size >> (TB_CPU_BITSIZE - 4)), -1);
+
+                    // append it
+                    cfilter->size = (cfilter->size << 4) | nb;
+                    cfilter->line++;
+                    p++;
+                }
+                tb_check_break(p < e);
+
+                // the line end or the chunk extension, e.g. "ea5;name=value\r\n"
+                p++;
+                if (ch == '\n') lend = tb_true;
+                else cfilter->state = TB_FILTER_CHUNKED_STATE_EXTN;
+            }
+            break;
+        case TB_FILTER_CHUNKED_STATE_EXTN:
+            {
+                // find the line end
+                while (p < e && *p != '\n') p++;
+                tb_check_break(p < e);
+
+                // skip '\n'
+                p++;
+                lend = tb_true;
+            }
+            break;
+        case TB_FILTER_CHUNKED_STATE_TRAIL:
+            {
+                // skip the trailer lines until the empty line
+                while (p < e && cfilter->state == TB_FILTER_CHUNKED_STATE_TRAIL)
+                {
+                    tb_byte_t ch = *p++;
+                    if (ch == '\n')
+                    {
+                        if (!cfilter->line) cfilter->state = TB_FILTER_CHUNKED_STATE_END;
+                        cfilter->line = 0;
+                    }
+                    else if (ch != '\r') cfilter->line++;
+                }
+            }
+            break;
+        default:
+            // the chunk data or end
+            return p - data;
+        }
+
+        // the head line is ended?
+        if (lend)
+        {
+            // trace
+            tb_trace_d("[%p]: line: %lu, size: %lu", cfilter, cfilter->line, cfilter->size);
+
+            // is the tail of the previous chunk? only "\r\n"
+            if (!cfilter->line) cfilter->state = TB_FILTER_CHUNKED_STATE_HEAD;
+            // is the last chunk? "0\r\n"
+            else if (!cfilter->size)
+            {
+                // trace
+                tb_trace_d("[%p]: eof", cfilter);
+
+                // is eof
+                cfilter->base.beof = tb_true;
+
+                // skip the trailer
+                cfilter->state = TB_FILTER_CHUNKED_STATE_TRAIL;
+            }
+            // read the chunk data
+            else
+            {
+                cfilter->state  = TB_FILTER_CHUNKED_STATE_DATA;
+                cfilter->read   = 0;
+            }
+
+            // clear line
+            cfilter->line = 0;
+        }
+    }
+
+    // ok
+    return p - data;
+}
 /* chunked_data
  *
  *   head     data   tail
@@ -77,124 +210,47 @@ static tb_long_t tb_filter_chunked_spak(tb_filter_t* filter, tb_static_stream_re
     tb_byte_t const*    ip = tb_static_stream_pos(istream);
     tb_byte_t const*    ie = tb_static_stream_end(istream);
 
-    // trace
-    tb_trace_d("[%p]: isize: %lu, beof: %d", cfilter, tb_static_stream_size(istream), filter->beof);
-
-    // find the eof: '\r\n 0\r\n\r\n'
-    if (    !filter->beof
-        &&  ip + 6 < ie
-        &&  ie[-7] == '\r'
-        &&  ie[-6] == '\n'
-        &&  ie[-5] == '0'
-        &&  ie[-4] == '\r'
-        &&  ie[-3] == '\n'
-        &&  ie[-2] == '\r'
-        &&  ie[-1] == '\n')
-    {
-        // is eof
-        filter->beof = tb_true;
-    }
-
     // the odata
     tb_byte_t*          op = (tb_byte_t*)tb_static_stream_pos(ostream);
     tb_byte_t*          oe = (tb_byte_t*)tb_static_stream_end(ostream);
     tb_byte_t*          ob = op;
 
-    // parse chunked head and chunked tail
-    if (!cfilter->size || cfilter->read >= cfilter->size)
+    // trace
+    tb_trace_d("[%p]: isize: %lu, beof: %d", cfilter, tb_static_stream_size(istream), filter->beof);
+
+    // done
+    while (ip < ie && op < oe)
     {
-        // walk
-        while (ip < ie)
+        // read chunked data
+        if (cfilter->state == TB_FILTER_CHUNKED_STATE_DATA)
         {
-            // the charactor
-            tb_char_t ch = *ip++;
-
-            // trace
-            tb_trace_d("[%p]: character: %x", cfilter, ch);
-
             // check
-            tb_assert_and_check_return_val(ch, -1);
+            tb_assert_and_check_return_val(cfilter->read < cfilter->size, -1);
 
-            // append char to line
-            if (ch != '\n') tb_string_chrcat(&cfilter->line, ch);
-            // is line end?
-            else
-            {
-                // check
-                tb_char_t const*    pb = tb_string_cstr(&cfilter->line);
-                tb_size_t           pn = tb_string_size(&cfilter->line);
-                tb_assert_and_check_return_val(pb, -1);
-
-                // trace
-                tb_trace_d("[%p]: line: %s", cfilter, tb_string_cstr(&cfilter->line));
+            // copy data
+            tb_size_t size = tb_min3(ie - ip, oe - op, cfilter->size - cfilter->read);
+            tb_memcpy(op, ip, size);
+            ip += size;
+            op += size;
 
-                // strip '\r' if exists
-                if (pb[pn - 1] == '\r') tb_string_strip(&cfilter->line, pn - 1);
-
-                // is chunked tail? only "\r\n"
-                if (!tb_string_size(&cfilter->line))
-                {
-                    // reset size
-                    cfilter->read = 0;
-                    cfilter->size = 0;
-
-                    // trace
-                    tb_trace_d("[%p]: tail", cfilter);
-
-                    // continue
-                    continue ;
-                }
-                // is chunked head? parse size
-                else
-                {
-                    // parse size
-                    cfilter->size = tb_s16tou32(pb);
-
-                    // trace
-                    tb_trace_d("[%p]: size: %lu", cfilter, cfilter->size);
-
-                    // clear data
-                    tb_string_clear(&cfilter->line);
-
-                    // is eof? "0\r\n\r\n"
-                    if (!cfilter->size)
-                    {
-                        // trace
-                        tb_trace_d("[%p]: eof", cfilter);
-
-                        // is eof
-                        filter->beof = tb_true;
-
-                        // continue to spak the end data
-                        continue ;
-                    }
-
-                    // ok
-                    break;
-                }
-            }
+            // update read, the chunk is finished? parse the next chunk
+            cfilter->read += size;
+            if (cfilter->read == cfilter->size) tb_filter_chunked_reset(cfilter);
+        }
+        // end? discard the left data
+        else if (cfilter->state == TB_FILTER_CHUNKED_STATE_END) ip = ie;
+        // parse chunked head and chunked tail
+        else
+        {
+            tb_long_t head = tb_filter_chunked_head(cfilter, ip, ie - ip);
+            tb_assert_and_check_return_val(head >= 0, -1);
+            ip += head;
         }
-    }
-
-    // check
-    tb_assert_and_check_return_val(cfilter->read <= cfilter->size, -1);
-
-    // read chunked data
-    tb_size_t size = tb_min3(ie - ip, oe - op, cfilter->size - cfilter->read);
-    if (size)
-    {
-        // copy data
-        tb_memcpy((tb_byte_t*)op, ip, size);
-        ip += size;
-        op += size;
-
-        // update read
-        cfilter->read += size;
     }
 
     // update stream
     tb_static_stream_goto(istream, (tb_byte_t*)ip);
-    tb_static_stream_goto(ostream, (tb_byte_t*)op);
+    tb_static_stream_goto(ostream, op);
 
     // trace
     tb_trace_d("[%p]: read: %lu, size: %lu, beof: %u, ileft: %lu", cfilter, cfilter->read, cfilter->size, filter->beof, tb_static_stream_left(istream));
@@ -202,29 +258,49 @@ static tb_long_t tb_filter_chunked_spak(tb_filter_t* filter, tb_static_stream_re
     // ok
     return (op - ob);
 }
-static tb_void_t tb_filter_chunked_clos(tb_filter_t* filter)
+static tb_long_t tb_filter_chunked_peek(tb_filter_t* filter, tb_byte_t const* data, tb_size_t size, tb_size_t* phead)
 {
     // check
     tb_filter_chunked_t* cfilter = tb_filter_chunked_cast(filter);
-    tb_assert_and_check_return(cfilter);
+    tb_assert_and_check_return_val(cfilter && data && phead, -1);
 
-    // clear size
-    cfilter->size = 0;
+    // parse chunked head and chunked tail
+    tb_long_t head = tb_filter_chunked_head(cfilter, data, size);
+    tb_assert_and_check_return_val(head >= 0, -1);
+
+    // save the head size
+    *phead = head;
 
-    // clear read
-    cfilter->read = 0;
+    // end?
+    tb_check_return_val(cfilter->state < TB_FILTER_CHUNKED_STATE_TRAIL, -1);
 
-    // clear line
-    tb_string_clear(&cfilter->line);
+    // the chunked data size at data + head
+    return cfilter->state == TB_FILTER_CHUNKED_STATE_DATA? tb_min(size - head, cfilter->size - cfilter->read) : 0;
 }
-static tb_void_t tb_filter_chunked_exit(tb_filter_t* filter)
+static tb_bool_t tb_filter_chunked_skip(tb_filter_t* filter, tb_size_t size)
+{
+    // check
+    tb_filter_chunked_t* cfilter = tb_filter_chunked_cast(filter);
+    tb_assert_and_check_return_val(cfilter, tb_false);
+
+    // check
+    tb_assert_and_check_return_val(cfilter->state == TB_FILTER_CHUNKED_STATE_DATA && size <= cfilter->size - cfilter->read, tb_false);
+
+    // update read, the chunk is finished? parse the next chunk
+    cfilter->read += size;
+    if (cfilter->read == cfilter->size) tb_filter_chunked_reset(cfilter);
+
+    // ok
+    return tb_true;
+}
+static tb_void_t tb_filter_chunked_clos(tb_filter_t* filter)
 {
     // check
     tb_filter_chunked_t* cfilter = tb_filter_chunked_cast(filter);
     tb_assert_and_check_return(cfilter);
 
-    // exit line
-    tb_string_exit(&cfilter->line);
+    // reset state
+    tb_filter_chunked_reset(cfilter);
 }
 
 /* //////////////////////////////////////////////////////////////////////////////////////
@@ -251,11 +327,9 @@ tb_filter_ref_t tb_filter_init_from_chunked(tb_bool_t dechunked)
         // init filter
         if (!tb_filter_init((tb_filter_t*)filter, TB_FILTER_TYPE_CHUNKED)) break;
         filter->base.spak = tb_filter_chunked_spak;
+        filter->base.peek = tb_filter_chunked_peek;
+        filter->base.skip = tb_filter_chunked_skip;
         filter->base.clos = tb_filter_chunked_clos;
-        filter->base.exit = tb_filter_chunked_exit;
-
-        // init line
-        if (!tb_string_init(&filter->line)) break;
 
         // ok
         ok = tb_true;
@@ -23,12 +23,80 @@
  * includes
  */
 #include "prefix.h"
+#include "../work.h"
 #include "../../../zip/zip.h"
+#ifdef TB_CONFIG_PACKAGE_HAVE_ZLIB
+#   include <zlib.h>
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the dictionary size for priming the parallel block, the deflate window size
+#define TB_FILTER_ZIP_PARALLEL_DICT     (32768)
+
+// the maximum count of the parallel blocks in flight
+#ifdef __tb_small__
+#   define TB_FILTER_ZIP_PARALLEL_MAXN  (8)
+#else
+#   define TB_FILTER_ZIP_PARALLEL_MAXN  (32)
+#endif
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * types
  */
 
+#ifdef TB_CONFIG_PACKAGE_HAVE_ZLIB
+/* the parallel deflate block type
+ *
+ * data: |-- dictionary: the tail of the previous block --|-- input: size --|
+ *       0                                           TB_FILTER_ZIP_PARALLEL_DICT
+ */
+typedef struct __tb_filter_zip_block_t
+{
+    // the data, the dictionary is stored at the end of the dictionary area
+    tb_byte_t*                  data;
+
+    // the dictionary size
+    tb_size_t                   dict;
+
+    // the input size
+    tb_size_t                   size;
+
+    // the output data
+    tb_byte_t*                  odata;
+
+    // the output maxn
+    tb_size_t                   omaxn;
+
+    // the output size
+    tb_size_t                   osize;
+
+    // the output position which has been written
+    tb_size_t                   opos;
+
+    // the crc32 of the input
+    tb_uint32_t                 crc;
+
+    // is the last block?
+    tb_bool_t                   last;
+
+    // is ok?
+    tb_bool_t                   ok;
+
+    // the posted work, the block is free if it is not pending
+    tb_stream_work_t            work;
+
+    // the raw deflate stream
+    z_stream                    zstream;
+
+    // the deflate stream has been initialized?
+    tb_bool_t                   zinit;
+
+}tb_filter_zip_block_t;
+#endif
+
 // the zip filter type
 typedef struct __tb_filter_zip_t
 {
@@ -44,6 +112,50 @@ typedef struct __tb_filter_zip_t
     // the zip
     tb_zip_ref_t                zip;
 
+    // the block size of the parallel deflate, disabled if be zero
+    tb_size_t                   parallel;
+
+#ifdef TB_CONFIG_PACKAGE_HAVE_ZLIB
+    // the parallel blocks
+    tb_filter_zip_block_t*      blocks;
+
+    // the parallel blocks maxn
+    tb_size_t                   blocks_maxn;
+
+    // the head block index which will be written first
+    tb_size_t                   blocks_head;
+
+    // the posted blocks count
+    tb_size_t                   blocks_size;
+
+    // the input size of the filling block
+    tb_size_t                   fill;
+
+    // the first block has been posted?
+    tb_bool_t                   started;
+
+    // the last block has been posted?
+    tb_bool_t                   posted;
+
+    // the combined crc32
+    tb_uint32_t                 crc;
+
+    // the total input size
+    tb_uint32_t                 isize;
+
+    // the gzip header or trailer which will be written
+    tb_byte_t                   extra[10];
+
+    // the extra size
+    tb_size_t                   extra_size;
+
+    // the extra position which has been written
+    tb_size_t                   extra_pos;
+
+    // all data has been written?
+    tb_bool_t                   finished;
+#endif
+
 }tb_filter_zip_t;
 
 /* //////////////////////////////////////////////////////////////////////////////////////
@@ -55,12 +167,285 @@ static __tb_inline__ tb_filter_zip_t* tb_filter_zip_cast(tb_filter_t* filter)
     tb_assert_and_check_return_val(filter && filter->type == TB_FILTER_TYPE_ZIP, tb_null);
     return (tb_filter_zip_t*)filter;
 }
+#ifdef TB_CONFIG_PACKAGE_HAVE_ZLIB
+static tb_void_t tb_filter_zip_block_done(tb_thread_pool_worker_ref_t worker, tb_cpointer_t priv)
+{
+    // check
+    tb_filter_zip_block_t* block = (tb_filter_zip_block_t*)priv;
+    tb_assert_and_check_return(block && block->data && block->odata);
+
+    // the input
+    tb_byte_t* data = block->data + TB_FILTER_ZIP_PARALLEL_DICT;
+
+    // compute the crc32 of the input
+    block->crc = (tb_uint32_t)crc32(0, (Bytef const*)data, (uInt)block->size);
+
+    // reset the deflate stream and prime it with the tail of the previous block
+    block->ok = tb_false;
+    if (    deflateReset(&block->zstream) == Z_OK
+        &&  (!block->dict || deflateSetDictionary(&block->zstream, (Bytef const*)(data - block->dict), (uInt)block->dict) == Z_OK))
+    {
+        // deflate it, only the last block is finished and the others are aligned to the byte boundary
+        block->zstream.next_in      = (Bytef*)data;
+        block->zstream.avail_in     = (uInt)block->size;
+        block->zstream.next_out     = (Bytef*)block->odata;
+        block->zstream.avail_out    = (uInt)block->omaxn;
+        tb_int_t r = deflate(&block->zstream, block->last? Z_FINISH : Z_SYNC_FLUSH);
+
+        // ok?
+        block->osize    = block->omaxn - block->zstream.avail_out;
+        block->ok       = block->last? r == Z_STREAM_END : (r == Z_OK && !block->zstream.avail_in && block->zstream.avail_out);
+    }
+
+}
+static tb_void_t tb_filter_zip_parallel_exit(tb_filter_zip_t* zfilter)
+{
+    // exit blocks
+    if (zfilter->blocks)
+    {
+        tb_size_t i = 0;
+        for (i = 0; i < zfilter->blocks_maxn; i++)
+        {
+            // exit work, it will wait it first, the worker may be using this block now
+            tb_filter_zip_block_t* block = &zfilter->blocks[i];
+            tb_stream_work_exit(&block->work);
+
+            // exit data
+            if (block->zinit) deflateEnd(&block->zstream);
+            if (block->data) tb_free(block->data);
+            if (block->odata) tb_free(block->odata);
+        }
+        tb_free(zfilter->blocks);
+        zfilter->blocks = tb_null;
+    }
+}
+static tb_bool_t tb_filter_zip_parallel_init(tb_filter_zip_t* zfilter)
+{
+    // check
+    tb_assert_and_check_return_val(zfilter && zfilter->parallel && !zfilter->blocks, tb_false);
+
+    // done
+    tb_bool_t ok = tb_false;
+    do
+    {
+        // keep two blocks per cpu in flight at most
+        zfilter->blocks_maxn = tb_min(tb_max(tb_cpu_count() << 1, 2), TB_FILTER_ZIP_PARALLEL_MAXN);
+        zfilter->blocks = tb_nalloc0_type(zfilter->blocks_maxn, tb_filter_zip_block_t);
+        tb_assert_and_check_break(zfilter->blocks);
+
+        // init blocks
+        tb_size_t i = 0;
+        for (i = 0; i < zfilter->blocks_maxn; i++)
+        {
+            // init the raw deflate stream
+            tb_filter_zip_block_t* block = &zfilter->blocks[i];
+            if (deflateInit2(&block->zstream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) break;
+            block->zinit = tb_true;
+
+            // make data, the sync flush marker may need more space than the bound
+            block->omaxn    = (tb_size_t)deflateBound(&block->zstream, (uLong)zfilter->parallel) + 16;
+            block->data     = tb_malloc_bytes(TB_FILTER_ZIP_PARALLEL_DICT + zfilter->parallel);
+            block->odata    = tb_malloc_bytes(block->omaxn);
+            tb_assert_and_check_break(block->data && block->odata);
+
+            // init work
+            if (!tb_stream_work_init(&block->work)) break;
+        }
+        tb_check_break(i == zfilter->blocks_maxn);
+
+        // init the gzip header: magic, deflate, no flags, no mtime, no extra flags, unknown os
+        static tb_byte_t const header[10] = {0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff};
+        tb_memcpy(zfilter->extra, header, sizeof(header));
+        zfilter->extra_size = sizeof(header);
+        zfilter->extra_pos  = 0;
+
+        // init state
+        zfilter->blocks_head    = 0;
+        zfilter->blocks_size    = 0;
+        zfilter->fill           = 0;
+        zfilter->started        = tb_false;
+        zfilter->posted         = tb_false;
+        zfilter->finished       = tb_false;
+        zfilter->crc            = 0;
+        zfilter->isize          = 0;
+
+        // ok
+        ok = tb_true;
+
+    } while (0);
+
+    // failed?
+    if (!ok) tb_filter_zip_parallel_exit(zfilter);
+    return ok;
+}
+static tb_bool_t tb_filter_zip_parallel_post(tb_filter_zip_t* zfilter, tb_bool_t last)
+{
+    // the pool
+    tb_thread_pool_ref_t pool = tb_thread_pool();
+    tb_assert_and_check_return_val(pool, tb_false);
+
+    // the filling block
+    tb_size_t               index = (zfilter->blocks_head + zfilter->blocks_size) % zfilter->blocks_maxn;
+    tb_filter_zip_block_t*  block = &zfilter->blocks[index];
+
+    /* copy the tail of the previous block as dictionary
+     *
+     * the previous block is only read by its worker and it will not be refilled before this block,
+     * and its dictionary is placed just before its input, so the tail is always contiguous
+     */
+    block->dict = 0;
+    if (zfilter->started)
+    {
+        tb_filter_zip_block_t* prev = &zfilter->blocks[(index + zfilter->blocks_maxn - 1) % zfilter->blocks_maxn];
+        block->dict = tb_min(prev->dict + prev->size, TB_FILTER_ZIP_PARALLEL_DICT);
+        tb_memcpy(block->data + TB_FILTER_ZIP_PARALLEL_DICT - block->dict, prev->data + TB_FILTER_ZIP_PARALLEL_DICT + prev->size - block->dict, block->dict);
+    }
+
+    // init block
+    block->size     = zfilter->fill;
+    block->last     = last;
+    block->ok       = tb_false;
+    block->osize    = 0;
+    block->opos     = 0;
+
+    // post it
+    if (!tb_stream_work_post(pool, &block->work, "zip_block", tb_filter_zip_block_done, block)) return tb_false;
+
+    // update state
+    zfilter->blocks_size++;
+    zfilter->fill = 0;
+    zfilter->started = tb_true;
+    if (last) zfilter->posted = tb_true;
+    return tb_true;
+}
+static tb_long_t tb_filter_zip_parallel_spak(tb_filter_zip_t* zfilter, tb_static_stream_ref_t istream, tb_static_stream_ref_t ostream, tb_long_t sync)
+{
+    // the output
+    tb_byte_t*  op = ostream->p;
+    tb_byte_t*  oe = ostream->e;
+    tb_assert_and_check_return_val(op && oe, -1);
+
+    // done
+    tb_bool_t failed = tb_false;
+    while (ostream->p < oe)
+    {
+        // write the header or trailer first
+        if (zfilter->extra_pos < zfilter->extra_size)
+        {
+            tb_size_t size = tb_min(zfilter->extra_size - zfilter->extra_pos, (tb_size_t)(oe - ostream->p));
+            tb_memcpy(ostream->p, zfilter->extra + zfilter->extra_pos, size);
+            zfilter->extra_pos += size;
+            ostream->p += size;
+            continue;
+        }
+
+        // end?
+        tb_check_break(!zfilter->finished);
+
+        // write the finished head block in order
+        tb_filter_zip_block_t* head = zfilter->blocks_size? &zfilter->blocks[zfilter->blocks_head] : tb_null;
+        if (head && tb_stream_work_wait(&head->work, 0) > 0)
+        {
+            // failed?
+            if (!head->ok)
+            {
+                failed = tb_true;
+                break;
+            }
+
+            // write it
+            tb_size_t size = tb_min(head->osize - head->opos, (tb_size_t)(oe - ostream->p));
+            tb_memcpy(ostream->p, head->odata + head->opos, size);
+            head->opos += size;
+            ostream->p += size;
+
+            // all output of this block has been written? combine its crc32
+            if (head->opos == head->osize)
+            {
+                zfilter->crc    = (tb_uint32_t)crc32_combine(zfilter->crc, head->crc, (z_off_t)head->size);
+                zfilter->isize += (tb_uint32_t)head->size;
+                zfilter->blocks_head = (zfilter->blocks_head + 1) % zfilter->blocks_maxn;
+                zfilter->blocks_size--;
+
+                // the last block? write the trailer: crc32 and input size modulo 2^32
+                if (head->last)
+                {
+                    tb_bits_set_u32_le(zfilter->extra, zfilter->crc);
+                    tb_bits_set_u32_le(zfilter->extra + 4, zfilter->isize);
+                    zfilter->extra_size = 8;
+                    zfilter->extra_pos  = 0;
+                    zfilter->finished   = tb_true;
+                }
+            }
+            continue;
+        }
+
+        // fill the next block if it is free
+        tb_size_t left = tb_static_stream_left(istream);
+        if (!zfilter->posted && zfilter->blocks_size < zfilter->blocks_maxn)
+        {
+            // the filling block, it has been written and finished
+            tb_filter_zip_block_t* block = &zfilter->blocks[(zfilter->blocks_head + zfilter->blocks_size) % zfilter->blocks_maxn];
+
+            // fill input
+            if (left)
+            {
+                tb_size_t size = tb_min(left, zfilter->parallel - zfilter->fill);
+                tb_memcpy(block->data + TB_FILTER_ZIP_PARALLEL_DICT + zfilter->fill, istream->p, size);
+                zfilter->fill += size;
+                istream->p += size;
+                left -= size;
+            }
+
+            /* post it if be full or finish it
+             *
+             * @note we do not post the partial block for flushing, the filter stream flushes it after every reading
+             * and all blocks will be deflated one by one, so only the finished blocks will be written for flushing.
+             */
+            if (zfilter->fill == zfilter->parallel || (!left && sync < 0))
+            {
+                if (!tb_filter_zip_parallel_post(zfilter, !left && sync < 0))
+                {
+                    failed = tb_true;
+                    break;
+                }
+                continue;
+            }
+        }
+
+        // wait the head block if the blocks are full or finish all blocks
+        if (head && (left || sync < 0))
+        {
+            tb_stream_work_wait(&head->work, -1);
+            continue;
+        }
+
+        // need more input
+        break;
+    }
+
+    // failed?
+    tb_assert_and_check_return_val(!failed, -1);
+
+    // the output size
+    tb_long_t osize = ostream->p - op;
+
+    // end?
+    return (!osize && zfilter->finished && zfilter->extra_pos == zfilter->extra_size)? -1 : osize;
+}
+#endif
 static tb_bool_t tb_filter_zip_open(tb_filter_t* filter)
 {
     // check
     tb_filter_zip_t* zfilter = tb_filter_zip_cast(filter);
     tb_assert_and_check_return_val(zfilter && !zfilter->zip, tb_false);
 
+#ifdef TB_CONFIG_PACKAGE_HAVE_ZLIB
+    // deflate gzip blocks in parallel?
+    if (zfilter->parallel && zfilter->algo == TB_ZIP_ALGO_GZIP && zfilter->action == TB_ZIP_ACTION_DEFLATE && tb_thread_pool())
+        return tb_filter_zip_parallel_init(zfilter);
+#endif
+
     // init zip
     zfilter->zip = tb_zip_init(zfilter->algo, zfilter->action);
     tb_assert_and_check_return_val(zfilter->zip, tb_false);
@@ -74,6 +459,11 @@ static tb_void_t tb_filter_zip_clos(tb_filter_t* filter)
     tb_filter_zip_t* zfilter = tb_filter_zip_cast(filter);
     tb_assert_and_check_return(zfilter);
 
+#ifdef TB_CONFIG_PACKAGE_HAVE_ZLIB
+    // exit the parallel blocks
+    tb_filter_zip_parallel_exit(zfilter);
+#endif
+
     // exit zip
     if (zfilter->zip) tb_zip_exit(zfilter->zip);
     zfilter->zip = tb_null;
@@ -82,7 +472,13 @@ static tb_long_t tb_filter_zip_spak(tb_filter_t* filter, tb_static_stream_ref_t
 {
     // check
     tb_filter_zip_t* zfilter = tb_filter_zip_cast(filter);
-    tb_assert_and_check_return_val(zfilter && zfilter->zip && istream && ostream, -1);
+    tb_assert_and_check_return_val(zfilter && istream && ostream, -1);
+
+#ifdef TB_CONFIG_PACKAGE_HAVE_ZLIB
+    // deflate gzip blocks in parallel?
+    if (zfilter->blocks) return tb_filter_zip_parallel_spak(zfilter, istream, ostream, sync);
+#endif
+    tb_assert_and_check_return_val(zfilter->zip, -1);
 
     // spak it
     return tb_zip_spak(zfilter->zip, istream, ostream, sync);
@@ -93,6 +489,11 @@ static tb_void_t tb_filter_zip_exit(tb_filter_t* filter)
     tb_filter_zip_t* zfilter = tb_filter_zip_cast(filter);
     tb_assert_and_check_return(zfilter);
 
+#ifdef TB_CONFIG_PACKAGE_HAVE_ZLIB
+    // exit the parallel blocks
+    tb_filter_zip_parallel_exit(zfilter);
+#endif
+
     // exit zip
     if (zfilter->zip) tb_zip_exit(zfilter->zip);
     zfilter->zip = tb_null;
@@ -143,6 +544,28 @@ static tb_bool_t tb_filter_zip_ctrl(tb_filter_t* filter, tb_size_t ctrl, tb_va_l
             // set action
             zfilter->action = (tb_size_t)tb_va_arg(args, tb_size_t);
 
+            // ok
+            return tb_true;
+        }
+    case TB_FILTER_CTRL_ZIP_GET_PARALLEL:
+        {
+            // the pparallel
+            tb_size_t* pparallel = (tb_size_t*)tb_va_arg(args, tb_size_t*);
+            tb_assert_and_check_break(pparallel);
+
+            // get the parallel block size
+            *pparallel = zfilter->parallel;
+
+            // ok
+            return tb_true;
+        }
+    case TB_FILTER_CTRL_ZIP_SET_PARALLEL:
+        {
+            // set the parallel block size, it must be larger than the dictionary size
+            tb_size_t parallel = (tb_size_t)tb_va_arg(args, tb_size_t);
+            tb_assert_and_check_break(!parallel || parallel >= TB_FILTER_ZIP_PARALLEL_DICT);
+            zfilter->parallel = parallel;
+
             // ok
             return tb_true;
         }
@@ -94,6 +94,12 @@ typedef struct __tb_stream_t
     // writ
     tb_long_t           (*writ)(tb_stream_ref_t stream, tb_byte_t const* data, tb_size_t size);
 
+    // peek the data directly without copying it to the cache, optional, e.g. for the memory stream
+    tb_long_t           (*peek)(tb_stream_ref_t stream, tb_byte_t** data, tb_size_t size);
+
+    // writ the iovec list by one call, optional, e.g. writev() for the file and sendv() for the socket
+    tb_long_t           (*writv)(tb_stream_ref_t stream, tb_iovec_t const* list, tb_size_t size);
+
     // seek
     tb_bool_t           (*seek)(tb_stream_ref_t stream, tb_hize_t offset);
 
@@ -23,6 +23,7 @@
  * includes
  */
 #include "prefix.h"
+#include "../stream.h"
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * types
@@ -43,6 +44,9 @@ typedef struct __tb_stream_data_t
     // the data is referenced?
     tb_bool_t               bref;
 
+    // the data is mapped from file?
+    tb_bool_t               bmmap;
+
 }tb_stream_data_t;
 
 /* //////////////////////////////////////////////////////////////////////////////////////
@@ -56,6 +60,22 @@ static __tb_inline__ tb_stream_data_t* tb_stream_data_cast(tb_stream_ref_t strea
     // ok?
     return (tb_stream_data_t*)stream;
 }
+static tb_void_t tb_stream_data_free(tb_stream_data_t* stream_data)
+{
+    // free or unmap data
+    if (stream_data->data)
+    {
+        if (stream_data->bmmap) tb_file_munmap(stream_data->data, stream_data->size);
+        else if (!stream_data->bref) tb_free(stream_data->data);
+    }
+
+    // clear data
+    stream_data->data   = tb_null;
+    stream_data->size   = 0;
+    stream_data->head   = tb_null;
+    stream_data->bref   = tb_false;
+    stream_data->bmmap  = tb_false;
+}
 static tb_bool_t tb_stream_data_open(tb_stream_ref_t stream)
 {
     // check
@@ -90,9 +110,7 @@ static tb_void_t tb_stream_data_exit(tb_stream_ref_t stream)
     stream_data->head = tb_null;
 
     // exit data
-    if (stream_data->data && !stream_data->bref) tb_free(stream_data->data);
-    stream_data->data = tb_null;
-    stream_data->size = 0;
+    tb_stream_data_free(stream_data);
 }
 static tb_long_t tb_stream_data_read(tb_stream_ref_t stream, tb_byte_t* data, tb_size_t size)
 {
@@ -119,6 +137,19 @@ static tb_long_t tb_stream_data_read(tb_stream_ref_t stream, tb_byte_t* data, tb
     // ok?
     return (tb_long_t)(size);
 }
+static tb_long_t tb_stream_data_peek(tb_stream_ref_t stream, tb_byte_t** data, tb_size_t size)
+{
+    // check
+    tb_stream_data_t* stream_data = tb_stream_data_cast(stream);
+    tb_assert_and_check_return_val(stream_data && stream_data->data && stream_data->head && data, -1);
+
+    // the left
+    tb_size_t left = stream_data->data + stream_data->size - stream_data->head;
+
+    // peek data from the head directly
+    *data = stream_data->head;
+    return (tb_long_t)tb_min(size, left);
+}
 static tb_long_t tb_stream_data_writ(tb_stream_ref_t stream, tb_byte_t const* data, tb_size_t size)
 {
     // check
@@ -129,6 +160,9 @@ static tb_long_t tb_stream_data_writ(tb_stream_ref_t stream, tb_byte_t const* da
     tb_check_return_val(data, -1);
     tb_check_return_val(size, 0);
 
+    // the mapped data is read-only
+    tb_assert_and_check_return_val(!stream_data->bmmap, -1);
+
     // the left
     tb_size_t left = stream_data->data + stream_data->size - stream_data->head;
 
@@ -196,7 +230,7 @@ static tb_bool_t tb_stream_data_ctrl(tb_stream_ref_t stream, tb_size_t ctrl, tb_
     case TB_STREAM_CTRL_DATA_SET_DATA:
         {
             // exit data first if exists
-            if (stream_data->data && !stream_data->bref) tb_free(stream_data->data);
+            tb_stream_data_free(stream_data);
 
             // save data
             stream_data->data = (tb_byte_t*)tb_va_arg(args, tb_byte_t*);
@@ -235,7 +269,7 @@ static tb_bool_t tb_stream_data_ctrl(tb_stream_ref_t stream, tb_size_t ctrl, tb_
             tb_assert_and_check_return_val(size, tb_false);
 
             // exit data first if exists
-            if (stream_data->data && !stream_data->bref) tb_free(stream_data->data);
+            tb_stream_data_free(stream_data);
 
             // save data
             stream_data->data = data;
@@ -258,19 +292,24 @@ static tb_bool_t tb_stream_data_ctrl(tb_stream_ref_t stream, tb_size_t ctrl, tb_
  */
 tb_stream_ref_t tb_stream_init_data()
 {
-    return tb_stream_init(  TB_STREAM_TYPE_DATA
-                        ,   sizeof(tb_stream_data_t)
-                        ,   0
-                        ,   tb_stream_data_open
-                        ,   tb_stream_data_clos
-                        ,   tb_stream_data_exit
-                        ,   tb_stream_data_ctrl
-                        ,   tb_stream_data_wait
-                        ,   tb_stream_data_read
-                        ,   tb_stream_data_writ
-                        ,   tb_stream_data_seek
-                        ,   tb_null
-                        ,   tb_null);
+    // init stream
+    tb_stream_ref_t stream = tb_stream_init(    TB_STREAM_TYPE_DATA
+                                            ,   sizeof(tb_stream_data_t)
+                                            ,   0
+                                            ,   tb_stream_data_open
+                                            ,   tb_stream_data_clos
+                                            ,   tb_stream_data_exit
+                                            ,   tb_stream_data_ctrl
+                                            ,   tb_stream_data_wait
+                                            ,   tb_stream_data_read
+                                            ,   tb_stream_data_writ
+                                            ,   tb_stream_data_seek
+                                            ,   tb_null
+                                            ,   tb_null);
+
+    // we can peek data without the cache
+    if (stream) tb_stream_cast(stream)->peek = tb_stream_data_peek;
+    return stream;
 }
 tb_stream_ref_t tb_stream_init_from_data(tb_byte_t const* data, tb_size_t size)
 {
@@ -305,3 +344,57 @@ tb_stream_ref_t tb_stream_init_from_data(tb_byte_t const* data, tb_size_t size)
     // ok
     return stream;
 }
+tb_stream_ref_t tb_stream_init_from_mmap(tb_char_t const* path, tb_size_t advice)
+{
+    // check
+    tb_assert_and_check_return_val(path, tb_null);
+
+    // done
+    tb_bool_t           ok = tb_false;
+    tb_file_ref_t       file = tb_null;
+    tb_stream_ref_t     stream = tb_null;
+    do
+    {
+        // init stream
+        stream = tb_stream_init_data();
+        tb_assert_and_check_break(stream);
+
+        // init file
+        file = tb_file_init(path, TB_FILE_MODE_RO);
+        tb_check_break(file);
+
+        // the file size, the empty file cannot be mapped
+        tb_hize_t size = tb_file_size(file);
+        tb_check_break(size && (tb_size_t)size == size);
+
+        // map the whole file
+        tb_byte_t const* data = tb_file_mmap(file, 0, (tb_size_t)size, advice);
+        tb_check_break(data);
+
+        // save data
+        tb_stream_data_t* stream_data = tb_stream_data_cast(stream);
+        tb_assert_and_check_break(stream_data);
+        stream_data->data   = (tb_byte_t*)data;
+        stream_data->size   = (tb_size_t)size;
+        stream_data->bmmap  = tb_true;
+
+        // ok
+        ok = tb_true;
+
+    } while (0);
+
+    // exit file, the mapped data is still valid
+    if (file) tb_file_exit(file);
+    file = tb_null;
+
+    // failed?
+    if (!ok)
+    {
+        // exit it
+        if (stream) tb_stream_exit(stream);
+        stream = tb_null;
+    }
+
+    // ok
+    return stream;
+}
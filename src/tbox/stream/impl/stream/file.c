@@ -23,6 +23,8 @@
  * includes
  */
 #include "prefix.h"
+#include "../stream.h"
+#include "../work.h"
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * macros
@@ -31,10 +33,49 @@
 // the file cache maxn
 #define TB_STREAM_FILE_CACHE_MAXN             TB_FILE_DIRECT_CSIZE
 
+// the block size of the read-ahead and write-behind
+#define TB_STREAM_FILE_ASYNC_BSIZE            (1 << 18)
+
+// the maximum count of the read-ahead and write-behind blocks in flight
+#ifdef __tb_small__
+#   define TB_STREAM_FILE_ASYNC_MAXN          (8)
+#else
+#   define TB_STREAM_FILE_ASYNC_MAXN          (32)
+#endif
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * types
  */
 
+// the read-ahead or write-behind block type
+typedef struct __tb_stream_file_block_t
+{
+    // the file handle
+    tb_file_ref_t               file;
+
+    // the block data
+    tb_byte_t*                  data;
+
+    // the data size which has been read or will be written
+    tb_size_t                   size;
+
+    // the data position which has been read by the stream
+    tb_size_t                   pos;
+
+    // the file offset of this block
+    tb_hize_t                   offset;
+
+    // is writing?
+    tb_bool_t                   writing;
+
+    // is ok?
+    tb_bool_t                   ok;
+
+    // the posted work, the block is free if it is not pending
+    tb_stream_work_t            work;
+
+}tb_stream_file_block_t;
+
 // the file stream type
 typedef struct __tb_stream_file_t
 {
@@ -53,6 +94,30 @@ typedef struct __tb_stream_file_t
     // is stream file?
     tb_bool_t           bstream;
 
+    // the read-ahead blocks count, disabled if be zero
+    tb_size_t           readahead;
+
+    // the write-behind blocks count, disabled if be zero
+    tb_size_t           writebehind;
+
+    // the read-ahead or write-behind blocks
+    tb_stream_file_block_t* blocks;
+
+    // the blocks maxn
+    tb_size_t           blocks_maxn;
+
+    // the head block index which will be read or retired first
+    tb_size_t           blocks_head;
+
+    // the posted blocks count
+    tb_size_t           blocks_size;
+
+    // the file offset of the next posted block
+    tb_hize_t           blocks_offset;
+
+    // the data size of the filling block for writing
+    tb_size_t           fill;
+
 }tb_stream_file_t;
 
 /* //////////////////////////////////////////////////////////////////////////////////////
@@ -66,6 +131,179 @@ static __tb_inline__ tb_stream_file_t* tb_stream_file_cast(tb_stream_ref_t strea
     // ok?
     return (tb_stream_file_t*)stream;
 }
+static tb_void_t tb_stream_file_block_done(tb_thread_pool_worker_ref_t worker, tb_cpointer_t priv)
+{
+    // check
+    tb_stream_file_block_t* block = (tb_stream_file_block_t*)priv;
+    tb_assert_and_check_return(block && block->file && block->data);
+
+    // writ the whole block
+    block->ok = tb_false;
+    if (block->writing)
+    {
+        tb_size_t writ = 0;
+        while (writ < block->size)
+        {
+            tb_long_t real = tb_file_pwrit(block->file, block->data + writ, block->size - writ, block->offset + writ);
+            tb_check_break(real > 0);
+            writ += real;
+        }
+        block->ok = writ == block->size;
+    }
+    // read the whole block until the end of file
+    else
+    {
+        tb_size_t read = 0;
+        tb_long_t real = 0;
+        while (read < TB_STREAM_FILE_ASYNC_BSIZE)
+        {
+            real = tb_file_pread(block->file, block->data + read, TB_STREAM_FILE_ASYNC_BSIZE - read, block->offset + read);
+            tb_check_break(real > 0);
+            read += real;
+        }
+        block->size = read;
+        block->ok   = real >= 0;
+    }
+}
+static __tb_inline__ tb_void_t tb_stream_file_block_wait(tb_stream_file_block_t* block)
+{
+    // wait it until it is finished or killed
+    tb_stream_work_wait(&block->work, -1);
+}
+static tb_void_t tb_stream_file_block_post(tb_stream_file_t* stream_file, tb_stream_file_block_t* block, tb_size_t size)
+{
+    // init block
+    block->size     = size;
+    block->pos      = 0;
+    block->offset   = stream_file->blocks_offset;
+    block->ok       = tb_false;
+
+    // post it, we do it directly if the thread pool is busy or exited
+    tb_thread_pool_ref_t pool = tb_thread_pool();
+    if (!pool || !tb_stream_work_post(pool, &block->work, "file_block", tb_stream_file_block_done, block))
+        tb_stream_file_block_done(tb_null, block);
+
+    // update state
+    stream_file->blocks_offset += block->writing? size : TB_STREAM_FILE_ASYNC_BSIZE;
+    stream_file->blocks_size++;
+}
+static tb_void_t tb_stream_file_async_post(tb_stream_file_t* stream_file, tb_hize_t offset)
+{
+    // post all read-ahead blocks from the aligned offset for the direct mode
+    stream_file->blocks_head    = 0;
+    stream_file->blocks_size    = 0;
+    stream_file->blocks_offset  = offset & ~((tb_hize_t)TB_FILE_DIRECT_ASIZE - 1);
+    while (stream_file->blocks_size < stream_file->blocks_maxn)
+        tb_stream_file_block_post(stream_file, &stream_file->blocks[stream_file->blocks_size], 0);
+
+    // skip the data before the given offset, the worker does not access the read position
+    stream_file->blocks[0].pos = (tb_size_t)(offset - stream_file->blocks[0].offset);
+}
+static tb_bool_t tb_stream_file_async_retire(tb_stream_file_t* stream_file, tb_bool_t wait)
+{
+    // retire the finished written blocks in order
+    tb_bool_t ok = tb_true;
+    while (stream_file->blocks_size)
+    {
+        // the head block
+        tb_stream_file_block_t* block = &stream_file->blocks[stream_file->blocks_head];
+        tb_check_break(tb_stream_work_wait(&block->work, wait? -1 : 0) > 0);
+
+        // failed?
+        if (!block->ok) ok = tb_false;
+
+        // retire it
+        stream_file->blocks_head = (stream_file->blocks_head + 1) % stream_file->blocks_maxn;
+        stream_file->blocks_size--;
+    }
+    return ok;
+}
+static tb_bool_t tb_stream_file_async_flush(tb_stream_file_t* stream_file)
+{
+    // check
+    tb_assert_and_check_return_val(stream_file && stream_file->blocks, tb_false);
+
+    // post the filling block
+    if (stream_file->fill)
+    {
+        tb_size_t index = (stream_file->blocks_head + stream_file->blocks_size) % stream_file->blocks_maxn;
+        tb_stream_file_block_post(stream_file, &stream_file->blocks[index], stream_file->fill);
+        stream_file->fill = 0;
+    }
+
+    // wait and retire all blocks
+    return tb_stream_file_async_retire(stream_file, tb_true);
+}
+static tb_void_t tb_stream_file_async_exit(tb_stream_file_t* stream_file)
+{
+    // exit blocks
+    if (stream_file->blocks)
+    {
+        tb_size_t i = 0;
+        for (i = 0; i < stream_file->blocks_maxn; i++)
+        {
+            // exit work, it will wait it first, the worker may be using this block now
+            tb_stream_file_block_t* block = &stream_file->blocks[i];
+            tb_stream_work_exit(&block->work);
+
+            // exit data
+            if (block->data) tb_align_free(block->data);
+        }
+        tb_free(stream_file->blocks);
+        stream_file->blocks = tb_null;
+    }
+
+    // clear state
+    stream_file->blocks_maxn    = 0;
+    stream_file->blocks_head    = 0;
+    stream_file->blocks_size    = 0;
+    stream_file->fill           = 0;
+}
+static tb_bool_t tb_stream_file_async_init(tb_stream_file_t* stream_file, tb_size_t count, tb_bool_t writing)
+{
+    // check
+    tb_assert_and_check_return_val(stream_file && stream_file->file && count && !stream_file->blocks, tb_false);
+
+    // done
+    tb_bool_t ok = tb_false;
+    do
+    {
+        // init blocks
+        stream_file->blocks_maxn = tb_min(count, TB_STREAM_FILE_ASYNC_MAXN);
+        stream_file->blocks = tb_nalloc0_type(stream_file->blocks_maxn, tb_stream_file_block_t);
+        tb_assert_and_check_break(stream_file->blocks);
+
+        // init blocks
+        tb_size_t i = 0;
+        for (i = 0; i < stream_file->blocks_maxn; i++)
+        {
+            // make data, it is aligned for the direct mode
+            tb_stream_file_block_t* block = &stream_file->blocks[i];
+            block->data = (tb_byte_t*)tb_align_malloc(TB_STREAM_FILE_ASYNC_BSIZE, TB_FILE_DIRECT_ASIZE);
+            tb_assert_and_check_break(block->data);
+
+            // init block
+            block->file         = stream_file->file;
+            block->writing      = writing;
+            if (!tb_stream_work_init(&block->work)) break;
+        }
+        tb_check_break(i == stream_file->blocks_maxn);
+
+        // init state
+        stream_file->blocks_head    = 0;
+        stream_file->blocks_size    = 0;
+        stream_file->blocks_offset  = 0;
+        stream_file->fill           = 0;
+
+        // ok
+        ok = tb_true;
+
+    } while (0);
+
+    // failed?
+    if (!ok) tb_stream_file_async_exit(stream_file);
+    return ok;
+}
 static tb_bool_t tb_stream_file_open(tb_stream_ref_t stream)
 {
     // check
@@ -93,6 +331,26 @@ static tb_bool_t tb_stream_file_open(tb_stream_ref_t stream)
     // init offset
     stream_file->offset = 0;
 
+    /* init the read-ahead for the read-only file
+     *
+     * the direct file always uses one block at least, so we can read and write it with the aligned blocks
+     */
+    tb_size_t mode = stream_file->mode;
+    tb_size_t direct = (mode & TB_FILE_MODE_DIRECT)? 1 : 0;
+    tb_size_t readahead = tb_max(stream_file->readahead, direct);
+    tb_size_t writebehind = tb_max(stream_file->writebehind, direct);
+    if (readahead && !stream_file->bstream && (mode & TB_FILE_MODE_RO) && !(mode & (TB_FILE_MODE_WO | TB_FILE_MODE_RW)))
+    {
+        if (tb_stream_file_async_init(stream_file, readahead, tb_false))
+        {
+            if (!direct) tb_file_advise(stream_file->file, 0, 0, TB_FILE_MMAP_ADVICE_SEQUENTIAL);
+            tb_stream_file_async_post(stream_file, 0);
+        }
+    }
+    // init the write-behind for the write-only file
+    else if (writebehind && !stream_file->bstream && (mode & TB_FILE_MODE_WO) && !(mode & (TB_FILE_MODE_RO | TB_FILE_MODE_RW | TB_FILE_MODE_APPEND)))
+        tb_stream_file_async_init(stream_file, writebehind, tb_true);
+
     // ok
     return tb_true;
 }
@@ -102,6 +360,14 @@ static tb_bool_t tb_stream_file_clos(tb_stream_ref_t stream)
     tb_stream_file_t* stream_file = tb_stream_file_cast(stream);
     tb_assert_and_check_return_val(stream_file, tb_false);
 
+    // flush the write-behind blocks and exit all blocks
+    tb_bool_t ok = tb_true;
+    if (stream_file->blocks)
+    {
+        if (stream_file->blocks->writing) ok = tb_stream_file_async_flush(stream_file);
+        tb_stream_file_async_exit(stream_file);
+    }
+
     // exit file
     if (stream_file->file && !tb_file_exit(stream_file->file)) return tb_false;
     stream_file->file = tb_null;
@@ -109,8 +375,8 @@ static tb_bool_t tb_stream_file_clos(tb_stream_ref_t stream)
     // clear offset
     stream_file->offset = 0;
 
-    // ok
-    return tb_true;
+    // ok?
+    return ok;
 }
 static tb_long_t tb_stream_file_read(tb_stream_ref_t stream, tb_byte_t* data, tb_size_t size)
 {
@@ -122,6 +388,33 @@ static tb_long_t tb_stream_file_read(tb_stream_ref_t stream, tb_byte_t* data, tb
     tb_check_return_val(data, -1);
     tb_check_return_val(size, 0);
 
+    // read it from the read-ahead blocks
+    if (stream_file->blocks)
+    {
+        // wait the head block
+        tb_stream_file_block_t* block = &stream_file->blocks[stream_file->blocks_head];
+        tb_stream_file_block_wait(block);
+        tb_check_return_val(block->ok, -1);
+
+        // end?
+        tb_check_return_val(block->pos < block->size, 0);
+
+        // copy data
+        tb_size_t read = tb_min(size, block->size - block->pos);
+        tb_memcpy(data, block->data + block->pos, read);
+        block->pos += read;
+        stream_file->offset += read;
+
+        // read the next block into it if all data has been read, the short block is the last block
+        if (block->pos == TB_STREAM_FILE_ASYNC_BSIZE)
+        {
+            stream_file->blocks_size--;
+            tb_stream_file_block_post(stream_file, block, 0);
+            stream_file->blocks_head = (stream_file->blocks_head + 1) % stream_file->blocks_maxn;
+        }
+        return read;
+    }
+
     // read
     stream_file->read = tb_file_read(stream_file->file, data, size);
     if (stream_file->read > 0)
@@ -142,12 +435,85 @@ static tb_long_t tb_stream_file_writ(tb_stream_ref_t stream, tb_byte_t const* da
     // not support for stream file
     tb_assert_and_check_return_val(!stream_file->bstream, -1);
 
+    // writ it to the write-behind blocks
+    if (stream_file->blocks)
+    {
+        // retire the finished blocks, we need wait the head block if all blocks are in flight
+        if (!tb_stream_file_async_retire(stream_file, tb_false)) return -1;
+        if (stream_file->blocks_size == stream_file->blocks_maxn)
+        {
+            tb_stream_file_block_wait(&stream_file->blocks[stream_file->blocks_head]);
+            if (!tb_stream_file_async_retire(stream_file, tb_false)) return -1;
+        }
+
+        /* fill the free block after the posted blocks
+         *
+         * the block starting at an unaligned offset after seeking or syncing is ended at the aligned boundary,
+         * so the concurrent blocks never share the same aligned page for the direct mode
+         */
+        tb_size_t               index = (stream_file->blocks_head + stream_file->blocks_size) % stream_file->blocks_maxn;
+        tb_stream_file_block_t* block = &stream_file->blocks[index];
+        tb_size_t               maxn = TB_STREAM_FILE_ASYNC_BSIZE - (tb_size_t)(stream_file->blocks_offset & (TB_FILE_DIRECT_ASIZE - 1));
+        tb_size_t               writ = tb_min(size, maxn - stream_file->fill);
+        tb_memcpy(block->data + stream_file->fill, data, writ);
+        stream_file->fill += writ;
+        stream_file->offset += writ;
+
+        // post it if be full
+        if (stream_file->fill == maxn)
+        {
+            tb_stream_file_block_post(stream_file, block, stream_file->fill);
+            stream_file->fill = 0;
+        }
+        return writ;
+    }
+
     // writ
     tb_long_t writ = tb_file_writ(stream_file->file, data, size);
     if (writ > 0)
         stream_file->offset += writ;
     return writ;
 }
+static tb_long_t tb_stream_file_writv(tb_stream_ref_t stream, tb_iovec_t const* list, tb_size_t size)
+{
+    // check
+    tb_stream_file_t* stream_file = tb_stream_file_cast(stream);
+    tb_assert_and_check_return_val(stream_file && stream_file->file && list, -1);
+
+    // check
+    tb_check_return_val(size, 0);
+
+    // not support for stream file
+    tb_assert_and_check_return_val(!stream_file->bstream, -1);
+
+    // writ them to the write-behind blocks one by one
+    if (stream_file->blocks)
+    {
+        tb_size_t i = 0;
+        tb_long_t writ = 0;
+        for (i = 0; i < size; i++)
+        {
+            // writ this iovec
+            tb_byte_t const*    data = (tb_byte_t const*)list[i].data;
+            tb_size_t           need = list[i].size;
+            while (need)
+            {
+                tb_long_t real = tb_stream_file_writ(stream, data, need);
+                if (real < 0) return writ? writ : -1;
+                data += real;
+                need -= real;
+                writ += real;
+            }
+        }
+        return writ;
+    }
+
+    // writ
+    tb_long_t writ = tb_file_writv(stream_file->file, list, size);
+    if (writ > 0)
+        stream_file->offset += writ;
+    return writ;
+}
 static tb_bool_t tb_stream_file_sync(tb_stream_ref_t stream, tb_bool_t bclosing)
 {
     // check
@@ -157,6 +523,9 @@ static tb_bool_t tb_stream_file_sync(tb_stream_ref_t stream, tb_bool_t bclosing)
     // not support for stream file
     tb_assert_and_check_return_val(!stream_file->bstream, -1);
 
+    // flush the write-behind blocks first
+    if (stream_file->blocks && stream_file->blocks->writing && !tb_stream_file_async_flush(stream_file)) return tb_false;
+
     // sync
     return tb_file_sync(stream_file->file);
 }
@@ -169,6 +538,35 @@ static tb_bool_t tb_stream_file_seek(tb_stream_ref_t stream, tb_hize_t offset)
     // is stream file?
     tb_check_return_val(!stream_file->bstream, tb_false);
 
+    // seek the read-ahead or write-behind blocks
+    if (stream_file->blocks)
+    {
+        // flush all written data before seeking
+        if (stream_file->blocks->writing)
+        {
+            if (!tb_stream_file_async_flush(stream_file)) return tb_false;
+            stream_file->blocks_offset = offset;
+        }
+        else
+        {
+            // seek in the head block?
+            tb_stream_file_block_t* block = &stream_file->blocks[stream_file->blocks_head];
+            tb_stream_file_block_wait(block);
+            if (block->ok && offset >= block->offset && offset < block->offset + block->size)
+                block->pos = (tb_size_t)(offset - block->offset);
+            else
+            {
+                // wait all blocks and read ahead from the new offset
+                tb_size_t i = 0;
+                for (i = 0; i < stream_file->blocks_maxn; i++)
+                    tb_stream_file_block_wait(&stream_file->blocks[i]);
+                tb_stream_file_async_post(stream_file, offset);
+            }
+        }
+        stream_file->offset = offset;
+        return tb_true;
+    }
+
     // seek
     if (tb_file_seek(stream_file->file, offset, TB_FILE_SEEK_BEG) == offset)
     {
@@ -263,10 +661,37 @@ static tb_bool_t tb_stream_file_ctrl(tb_stream_ref_t stream, tb_size_t ctrl, tb_
             tb_file_ref_t* pfile = (tb_file_ref_t*)tb_va_arg(args, tb_file_ref_t*);
             tb_assert_and_check_return_val(pfile, tb_false);
 
+            /* the file will be accessed directly, e.g. zero copy, so we stop the read-ahead or write-behind
+             * and keep the file offset same as the stream offset
+             */
+            if (stream_file->blocks)
+            {
+                tb_bool_t ok = !stream_file->blocks->writing || tb_stream_file_async_flush(stream_file);
+                tb_stream_file_async_exit(stream_file);
+                tb_check_return_val(ok, tb_false);
+                if (tb_file_seek(stream_file->file, stream_file->offset, TB_FILE_SEEK_BEG) != stream_file->offset) return tb_false;
+            }
+
             // get file
             *pfile = stream_file->file;
             return tb_true;
         }
+    case TB_STREAM_CTRL_FILE_SET_READAHEAD:
+        {
+            // only set it before opening
+            tb_assert_and_check_return_val(!stream_file->file, tb_false);
+            tb_size_t count = (tb_size_t)tb_va_arg(args, tb_size_t);
+            stream_file->readahead = tb_min(count, TB_STREAM_FILE_ASYNC_MAXN);
+            return tb_true;
+        }
+    case TB_STREAM_CTRL_FILE_SET_WRITEBEHIND:
+        {
+            // only set it before opening
+            tb_assert_and_check_return_val(!stream_file->file, tb_false);
+            tb_size_t count = (tb_size_t)tb_va_arg(args, tb_size_t);
+            stream_file->writebehind = tb_min(count, TB_STREAM_FILE_ASYNC_MAXN);
+            return tb_true;
+        }
     default:
         break;
     }
@@ -294,14 +719,19 @@ tb_stream_ref_t tb_stream_init_file()
                                             ,   tb_null);
     tb_assert_and_check_return_val(stream, tb_null);
 
+    // we can writ the iovec list by one call
+    tb_stream_cast(stream)->writv = tb_stream_file_writv;
+
     // init the file stream
     tb_stream_file_t* stream_file = tb_stream_file_cast(stream);
     if (stream_file)
     {
         // init it
-        stream_file->mode      = TB_FILE_MODE_RO;
-        stream_file->bstream   = tb_false;
-        stream_file->read      = 0;
+        stream_file->mode        = TB_FILE_MODE_RO;
+        stream_file->bstream     = tb_false;
+        stream_file->read        = 0;
+        stream_file->readahead   = 0;
+        stream_file->writebehind = 0;
     }
 
     // ok?
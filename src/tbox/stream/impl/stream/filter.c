@@ -23,6 +23,8 @@
  * includes
  */
 #include "prefix.h"
+#include "../stream.h"
+#include "../filter.h"
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * types
@@ -69,6 +71,67 @@ static __tb_inline__ tb_stream_filter_t* tb_stream_filter_cast(tb_stream_ref_t s
     // ok?
     return (tb_stream_filter_t*)stream;
 }
+/* peek the filtered data from the cache of the stream directly, e.g. the chunked data
+ *
+ * stream: ea5\r\n ..........\r\n e65\r\n..............\r\n 0\r\n\r\n
+ *                |          |
+ *              data  -----> size
+ */
+static tb_long_t tb_stream_filter_peek(tb_stream_ref_t stream, tb_byte_t** data, tb_size_t size)
+{
+    // check
+    tb_stream_filter_t* stream_filter = tb_stream_filter_cast(stream);
+    tb_assert_and_check_return_val(stream_filter && stream_filter->stream && stream_filter->filter && data && size, -1);
+
+    // save mode: read
+    if (!stream_filter->mode) stream_filter->mode = 1;
+
+    // check mode
+    tb_assert_and_check_return_val(stream_filter->mode == 1, -1);
+
+    // done
+    tb_long_t real = -1;
+    while (!tb_filter_beof(stream_filter->filter))
+    {
+        // peek the input data
+        tb_byte_t*  idata = tb_null;
+        tb_long_t   isize = tb_stream_peek(stream_filter->stream, &idata, size);
+        if (isize > 0)
+        {
+            // clear wait
+            stream_filter->wait = tb_false;
+
+            // peek the filtered data
+            tb_size_t head = 0;
+            real = tb_filter_peek(stream_filter->filter, idata, isize, &head);
+
+            // skip the parsed framing data
+            if (head && !tb_stream_skip(stream_filter->stream, head)) real = -1;
+
+            // ok? using the input data directly
+            if (real > 0) *data = idata + head;
+
+            // continue to peek the next framing data if only the framing data is parsed
+            tb_check_continue(real || !head);
+        }
+        // eof? the file stream will return 0 if it has been read to the end
+        else real = (isize < 0 || stream_filter->wait || stream_filter->beof)? -1 : 0;
+        break;
+    }
+
+    // eof?
+    if (real < 0) stream_filter->beof = tb_true;
+
+    // save last
+    stream_filter->last = real;
+
+    // ok?
+    return real;
+}
+static tb_bool_t tb_stream_filter_skip(tb_stream_filter_t* stream_filter, tb_size_t size)
+{
+    return tb_filter_skip(stream_filter->filter, size) && tb_stream_skip(stream_filter->stream, size);
+}
 static tb_bool_t tb_stream_filter_open(tb_stream_ref_t stream)
 {
     // check
@@ -94,6 +157,9 @@ static tb_bool_t tb_stream_filter_open(tb_stream_ref_t stream)
     // open filter
     if (stream_filter->filter && !tb_filter_open(stream_filter->filter)) return tb_false;
 
+    // the filter data can be peeked from the stream directly? e.g. the chunked data
+    tb_stream_cast(stream)->peek = (stream_filter->filter && ((tb_filter_t*)stream_filter->filter)->peek)? tb_stream_filter_peek : tb_null;
+
     // open stream
     return !tb_stream_is_opened(stream_filter->stream)? tb_stream_open(stream_filter->stream) : tb_true;
 }
@@ -181,6 +247,19 @@ static tb_long_t tb_stream_filter_read(tb_stream_ref_t stream, tb_byte_t* data,
     tb_assert_and_check_return_val(stream_filter && stream_filter->stream && data, -1);
     tb_check_return_val(size, 0);
 
+    // peek the filtered data directly and copy it only once?
+    if (tb_stream_cast(stream)->peek)
+    {
+        tb_byte_t*  pdata = tb_null;
+        tb_long_t   real = tb_stream_filter_peek(stream, &pdata, size);
+        if (real > 0)
+        {
+            tb_memcpy(data, pdata, real);
+            if (!tb_stream_filter_skip(stream_filter, real)) real = -1;
+        }
+        return real;
+    }
+
     // read
     tb_long_t real = tb_stream_read(stream_filter->stream, data, size);
 
@@ -326,8 +405,10 @@ static tb_long_t tb_stream_filter_wait(tb_stream_ref_t stream, tb_size_t wait, t
             // wait
             ok = tb_stream_wait(stream_filter->stream, wait, timeout);
 
-            // eof?
-            if (!ok)
+            /* eof? the file stream will return -1 if it has been read to the end,
+             * but the other streams return -1 only if it has been failed, e.g. the socket error
+             */
+            if (!ok || (ok < 0 && tb_stream_type(stream_filter->stream) == TB_STREAM_TYPE_FILE))
             {
                 // wait ok and continue to read or writ
                 ok = wait;
@@ -353,6 +434,57 @@ static tb_long_t tb_stream_filter_wait(tb_stream_ref_t stream, tb_size_t wait, t
     // ok?
     return ok;
 }
+static tb_bool_t tb_stream_filter_seek(tb_stream_ref_t stream, tb_hize_t offset)
+{
+    // check
+    tb_stream_filter_t* stream_filter = tb_stream_filter_cast(stream);
+    tb_assert_and_check_return_val(stream_filter && stream_filter->stream, tb_false);
+
+    /* only skip the peeked data forward, otherwise we will seek it by reading data
+     *
+     * @note the filtered data after the current offset may have been read to the cache of the stream,
+     * and it will be cleared after seeking, so we skip the left data after it
+     */
+    tb_stream_t*    impl = tb_stream_cast(stream);
+    tb_hize_t       curt = tb_stream_offset(stream) + tb_queue_buffer_size(&impl->cache);
+    tb_check_return_val(impl->peek && stream_filter->mode >= 0 && offset >= curt, tb_false);
+
+    // skip it
+    tb_hize_t left = offset - curt;
+    while (left && !tb_stream_is_killed(stream))
+    {
+        // peek data
+        tb_byte_t*  data = tb_null;
+        tb_size_t   need = (tb_size_t)tb_min(left, TB_STREAM_BLOCK_MAXN);
+        tb_long_t   real = tb_stream_filter_peek(stream, &data, need);
+
+        // skip data
+        if (real > 0)
+        {
+            if (!tb_stream_filter_skip(stream_filter, real)) break;
+            left -= real;
+        }
+        // no data? wait it
+        else if (!real)
+        {
+            real = tb_stream_filter_wait(stream, TB_STREAM_WAIT_READ, tb_stream_timeout(stream));
+            tb_check_break(real > 0);
+        }
+        else break;
+    }
+
+    /* failed? the skipped data has been discarded, so we update the offset to the skipped position
+     * and clear the cache before it, the reading will be continued from here
+     */
+    if (left && offset - left > curt)
+    {
+        impl->offset = offset - left;
+        tb_queue_buffer_clear(&impl->cache);
+    }
+
+    // ok?
+    return !left;
+}
 static tb_bool_t tb_stream_filter_ctrl(tb_stream_ref_t stream, tb_size_t ctrl, tb_va_list_t args)
 {
     // check
@@ -435,7 +567,7 @@ tb_stream_ref_t tb_stream_init_filter()
                         ,   tb_stream_filter_wait
                         ,   tb_stream_filter_read
                         ,   tb_stream_filter_writ
-                        ,   tb_null
+                        ,   tb_stream_filter_seek
                         ,   tb_stream_filter_sync
                         ,   tb_stream_filter_kill);
 }
@@ -29,6 +29,7 @@
  * includes
  */
 #include "prefix.h"
+#include "../stream.h"
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * macros
@@ -635,6 +636,40 @@ static tb_long_t tb_stream_sock_writ(tb_stream_ref_t stream, tb_byte_t const* da
     // ok?
     return real;
 }
+static tb_long_t tb_stream_sock_writv(tb_stream_ref_t stream, tb_iovec_t const* list, tb_size_t size)
+{
+    // check
+    tb_stream_sock_t* stream_sock = tb_stream_sock_cast(stream);
+    tb_assert_and_check_return_val(stream_sock && stream_sock->sock && list, -1);
+
+    // check
+    tb_check_return_val(size, 0);
+
+    // only send the first data for ssl and udp, the non-blocking writ can return the partial size
+    if (stream_sock->type != TB_SOCKET_TYPE_TCP || tb_url_ssl(tb_stream_url(stream)))
+        return tb_stream_sock_writ(stream, list[0].data, list[0].size);
+
+    // clear read
+    stream_sock->read = 0;
+
+    // send data
+    tb_long_t real = tb_socket_sendv(stream_sock->sock, list, size);
+
+    // trace
+    tb_trace_d("sock(%p): writv: %ld", stream_sock->sock, real);
+
+    // failed or closed?
+    tb_check_return_val(real >= 0, -1);
+
+    // peer closed?
+    if (!real && stream_sock->wait > 0 && (stream_sock->wait & TB_SOCKET_EVENT_SEND)) return -1;
+
+    // clear wait
+    if (real > 0) stream_sock->wait = 0;
+
+    // ok?
+    return real;
+}
 static tb_long_t tb_stream_sock_wait(tb_stream_ref_t stream, tb_size_t wait, tb_long_t timeout)
 {
     // check
@@ -741,6 +776,9 @@ tb_stream_ref_t tb_stream_init_sock()
                                             ,   tb_stream_sock_kill);
     tb_assert_and_check_return_val(stream, tb_null);
 
+    // we can writ the iovec list by one call
+    tb_stream_cast(stream)->writv = tb_stream_sock_writv;
+
     // init the sock stream
     tb_stream_sock_t* stream_sock = tb_stream_sock_cast(stream);
     if (stream_sock)
@@ -821,6 +859,9 @@ tb_stream_ref_t tb_stream_init_from_sock_ref(tb_socket_ref_t sock, tb_size_t typ
                                 ,   tb_stream_sock_kill);
         tb_assert_and_check_break(stream);
 
+        // we can writ the iovec list by one call
+        tb_stream_cast(stream)->writv = tb_stream_sock_writv;
+
         // ctrl stream
         if (!tb_stream_ctrl(stream, TB_STREAM_CTRL_SET_HOST, "fd")) break;
         if (!tb_stream_ctrl(stream, TB_STREAM_CTRL_SET_PORT, (tb_uint16_t)tb_sock2fd(sock))) break;
@@ -0,0 +1,169 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        work.h
+ *
+ */
+#ifndef TB_STREAM_IMPL_WORK_H
+#define TB_STREAM_IMPL_WORK_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+#include "../../platform/semaphore.h"
+#include "../../platform/thread_pool.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+/* the stream work type
+ *
+ * it is a posted thread pool task with its own completion, the owner can post it again after waiting it,
+ * e.g. the read-ahead blocks of the file stream and the deflate blocks of the zip filter.
+ */
+typedef struct __tb_stream_work_t
+{
+    // the done func
+    tb_thread_pool_task_done_func_t     done;
+
+    // the user private data
+    tb_cpointer_t                       priv;
+
+    // the semaphore for notifying the completion
+    tb_semaphore_ref_t                  semaphore;
+
+    // is pending? it is only accessed by the owner
+    tb_bool_t                           pending;
+
+}tb_stream_work_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static __tb_inline__ tb_void_t tb_stream_work_done(tb_thread_pool_worker_ref_t worker, tb_cpointer_t priv)
+{
+    // check
+    tb_stream_work_t* work = (tb_stream_work_t*)priv;
+    tb_assert_and_check_return(work && work->done);
+
+    // done it
+    work->done(worker, work->priv);
+}
+static __tb_inline__ tb_void_t tb_stream_work_notify(tb_thread_pool_worker_ref_t worker, tb_cpointer_t priv)
+{
+    // check
+    tb_stream_work_t* work = (tb_stream_work_t*)priv;
+    tb_assert_and_check_return(work);
+
+    /* finished or killed, notify the owner
+     *
+     * @note the work may be freed or posted again after posting the semaphore, so it must be the last access
+     */
+    tb_semaphore_post(work->semaphore, 1);
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * inline implementation
+ */
+
+/* init the work
+ *
+ * @param work              the work
+ *
+ * @return                  tb_true or tb_false
+ */
+static __tb_inline__ tb_bool_t tb_stream_work_init(tb_stream_work_t* work)
+{
+    // check
+    tb_assert_and_check_return_val(work, tb_false);
+
+    // init it
+    tb_memset(work, 0, sizeof(tb_stream_work_t));
+    work->semaphore = tb_semaphore_init(0);
+    return work->semaphore? tb_true : tb_false;
+}
+
+/* wait the work until it is finished or killed
+ *
+ * it blocks on the semaphore of this work, and it returns ok at once if the work is not pending
+ *
+ * @param work              the work
+ * @param timeout           the timeout, it only checks it if be zero, infinity: -1
+ *
+ * @return                  ok: 1, timeout: 0, error: -1
+ */
+static __tb_inline__ tb_long_t tb_stream_work_wait(tb_stream_work_t* work, tb_long_t timeout)
+{
+    // check
+    tb_assert_and_check_return_val(work, -1);
+
+    // not pending?
+    tb_check_return_val(work->pending, 1);
+
+    // wait the completion, only this work posts its semaphore and the worker does not access it after posting
+    tb_long_t ok = tb_semaphore_wait(work->semaphore, timeout);
+    if (ok > 0) work->pending = tb_false;
+    return ok;
+}
+
+/* exit the work, it will wait the pending work first
+ *
+ * @param work              the work
+ */
+static __tb_inline__ tb_void_t tb_stream_work_exit(tb_stream_work_t* work)
+{
+    // check
+    tb_assert_and_check_return(work);
+
+    // wait it first, the worker may be using it now
+    tb_stream_work_wait(work, -1);
+
+    // exit semaphore
+    if (work->semaphore) tb_semaphore_exit(work->semaphore);
+    work->semaphore = tb_null;
+}
+
+/* post the work
+ *
+ * the previous posted work need be waited before posting it again
+ *
+ * @param pool              the thread pool
+ * @param work              the work
+ * @param name              the work name
+ * @param done              the done func, it will not be called if the work is killed
+ * @param priv              the user private data
+ *
+ * @return                  tb_true or tb_false, it is not pending if failed, e.g. the thread pool is busy or exited
+ */
+static __tb_inline__ tb_bool_t tb_stream_work_post(tb_thread_pool_ref_t pool, tb_stream_work_t* work, tb_char_t const* name, tb_thread_pool_task_done_func_t done, tb_cpointer_t priv)
+{
+    // check
+    tb_assert_and_check_return_val(pool && work && work->semaphore && done && !work->pending, tb_false);
+
+    // init it
+    work->done = done;
+    work->priv = priv;
+
+    // post it
+    tb_check_return_val(tb_thread_pool_task_post(pool, name, tb_stream_work_done, tb_stream_work_notify, work, tb_false), tb_false);
+    work->pending = tb_true;
+    return tb_true;
+}
+
+#endif
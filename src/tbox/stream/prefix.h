@@ -98,6 +98,7 @@ typedef enum __tb_stream_ctrl_e
 ,   TB_STREAM_CTRL_SET_PATH                 = TB_STREAM_CTRL(TB_STREAM_TYPE_NONE, 14)
 ,   TB_STREAM_CTRL_SET_SSL                  = TB_STREAM_CTRL(TB_STREAM_TYPE_NONE, 15)
 ,   TB_STREAM_CTRL_SET_TIMEOUT              = TB_STREAM_CTRL(TB_STREAM_TYPE_NONE, 16)
+,   TB_STREAM_CTRL_SET_CACHE_MIRROR         = TB_STREAM_CTRL(TB_STREAM_TYPE_NONE, 17)
 
     // the stream for data
 ,   TB_STREAM_CTRL_DATA_SET_DATA            = TB_STREAM_CTRL(TB_STREAM_TYPE_DATA, 1)
@@ -107,6 +108,8 @@ typedef enum __tb_stream_ctrl_e
 ,   TB_STREAM_CTRL_FILE_SET_MODE            = TB_STREAM_CTRL(TB_STREAM_TYPE_FILE, 2)
 ,   TB_STREAM_CTRL_FILE_AS_STREAM           = TB_STREAM_CTRL(TB_STREAM_TYPE_FILE, 3)
 ,   TB_STREAM_CTRL_FILE_GET_FILE            = TB_STREAM_CTRL(TB_STREAM_TYPE_FILE, 4)
+,   TB_STREAM_CTRL_FILE_SET_READAHEAD       = TB_STREAM_CTRL(TB_STREAM_TYPE_FILE, 5)
+,   TB_STREAM_CTRL_FILE_SET_WRITEBEHIND     = TB_STREAM_CTRL(TB_STREAM_TYPE_FILE, 6)
 
     // the stream for sock
 ,   TB_STREAM_CTRL_SOCK_GET_TYPE            = TB_STREAM_CTRL(TB_STREAM_TYPE_SOCK, 1)
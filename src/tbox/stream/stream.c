@@ -38,6 +38,90 @@
 #include "../string/string.h"
 #include "../platform/platform.h"
 
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the iovec maxn for writing the buffer chain
+#ifdef __tb_small__
+#   define TB_STREAM_IOVEC_MAXN         (8)
+#else
+#   define TB_STREAM_IOVEC_MAXN         (32)
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static tb_bool_t tb_stream_sync_cache(tb_stream_ref_t self)
+{
+    // check
+    tb_stream_t* stream = tb_stream_cast(self);
+    tb_assert_and_check_return_val(stream && stream->writ && stream->wait && tb_stream_is_opened(self), tb_false);
+
+    // stoped?
+    tb_assert_and_check_return_val((TB_STATE_OPENED == tb_atomic32_get(&stream->istate)), tb_false);
+
+    // cached? sync cache first
+    if (tb_queue_buffer_maxn(&stream->cache))
+    {
+        // have data?
+        if (!tb_queue_buffer_null(&stream->cache))
+        {
+            // check: must be writed cache
+            tb_assert_and_check_return_val(stream->bwrited, tb_false);
+
+            // enter cache for pull
+            tb_size_t   size = 0;
+            tb_byte_t*  head = tb_queue_buffer_pull_init(&stream->cache, &size);
+            tb_assert_and_check_return_val(head && size, tb_false);
+
+            // writ cache data to self
+            tb_size_t   writ = 0;
+            while (writ < size && (TB_STATE_OPENED == tb_atomic32_get(&stream->istate)))
+            {
+                // writ
+                tb_long_t real = stream->writ(self, head + writ, size - writ);
+
+                // ok?
+                if (real > 0)
+                {
+                    // save writ
+                    writ += real;
+                }
+                // no data?
+                else if (!real)
+                {
+                    // wait
+                    real = stream->wait(self, TB_STREAM_WAIT_WRIT, tb_stream_timeout(self));
+
+                    // ok?
+                    tb_check_break(real > 0);
+                }
+                // error or end?
+                else break;
+            }
+
+            // leave cache for pull
+            tb_queue_buffer_pull_exit(&stream->cache, writ);
+
+            // cache be not cleared?
+            if (!tb_queue_buffer_null(&stream->cache))
+            {
+                // killed? save state
+                if (!stream->state && (TB_STATE_KILLING == tb_atomic32_get(&stream->istate)))
+                    stream->state = TB_STATE_KILLED;
+
+                // failed
+                return tb_false;
+            }
+        }
+        else stream->bwrited = 1;
+    }
+
+    // ok
+    return tb_true;
+}
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * implementation
  */
@@ -546,6 +630,16 @@ tb_bool_t tb_stream_ctrl_with_args(tb_stream_ref_t self, tb_size_t ctrl, tb_va_l
             ok = tb_true;
         }
         break;
+    case TB_STREAM_CTRL_SET_CACHE_MIRROR:
+        {
+            // check
+            tb_assert_and_check_return_val(tb_stream_is_closed(self), tb_false);
+
+            // enable or disable the mirrored cache, the readable and writable spans of the cache will be always contiguous
+            tb_bool_t mirror = (tb_bool_t)tb_va_arg(args, tb_bool_t);
+            ok = tb_queue_buffer_mirror(&stream->cache, mirror);
+        }
+        break;
     case TB_STREAM_CTRL_GET_TIMEOUT:
         {
             // get timeout
@@ -678,6 +772,19 @@ tb_bool_t tb_stream_need(tb_stream_ref_t self, tb_byte_t** data, tb_size_t size)
     // check the cache mode, must be read cache
     tb_assert_and_check_return_val(!stream->bwrited, tb_false);
 
+    // peek it directly without the cache?
+    if (stream->peek && tb_queue_buffer_null(&stream->cache))
+    {
+        // ok?
+        tb_long_t real = stream->peek(self, data, size);
+        tb_check_return_val(real < (tb_long_t)size, tb_true);
+
+        // end?
+        tb_check_return_val(real >= 0, tb_false);
+
+        // not enough? e.g. the chunk boundary of the chunked filter stream, we fill the cache
+    }
+
     // not enough? grow the cache first
     if (tb_queue_buffer_maxn(&stream->cache) < size) tb_queue_buffer_resize(&stream->cache, size);
 
@@ -765,6 +872,10 @@ tb_long_t tb_stream_peek(tb_stream_ref_t self, tb_byte_t** data, tb_size_t size)
     // check the cache mode, must be read cache
     tb_assert_and_check_return_val(!stream->bwrited, -1);
 
+    // peek it directly without the cache?
+    if (stream->peek && tb_queue_buffer_null(&stream->cache))
+        return stream->peek(self, data, size);
+
     // not enough? grow the cache first
     if (tb_queue_buffer_maxn(&stream->cache) < size) tb_queue_buffer_resize(&stream->cache, size);
 
@@ -950,6 +1061,68 @@ tb_long_t tb_stream_writ(tb_stream_ref_t self, tb_byte_t const* data, tb_size_t
 //  tb_trace_d("writ: %d", writ);
     return writ;
 }
+tb_long_t tb_stream_writv(tb_stream_ref_t self, tb_iovec_t const* list, tb_size_t size)
+{
+    // check
+    tb_stream_t* stream = tb_stream_cast(self);
+    tb_assert_and_check_return_val(list, -1);
+
+    // no size?
+    tb_check_return_val(size, 0);
+
+    // check self
+    tb_assert_and_check_return_val(stream && tb_stream_is_opened(self) && stream->writ, -1);
+
+    // not supported? writ them one by one
+    if (!stream->writv)
+    {
+        tb_size_t i = 0;
+        tb_long_t writ = 0;
+        for (i = 0; i < size; i++)
+        {
+            // writ it
+            tb_long_t real = tb_stream_writ(self, list[i].data, list[i].size);
+            if (real < 0) return writ? writ : -1;
+
+            // save writ
+            writ += real;
+
+            // not finished? wait it
+            tb_check_break(real == (tb_long_t)list[i].size);
+        }
+        return writ;
+    }
+
+    // check the cache mode, must be writ cache if the cache is not null
+    tb_assert_and_check_return_val(stream->bwrited || tb_queue_buffer_null(&stream->cache), -1);
+
+    // have writed cache? writ it first to keep the data order
+    if (!tb_queue_buffer_null(&stream->cache))
+    {
+        // enter cache for pull
+        tb_size_t   pull = 0;
+        tb_byte_t*  head = tb_queue_buffer_pull_init(&stream->cache, &pull);
+        tb_assert_and_check_return_val(head && pull, -1);
+
+        // pull data to self from cache
+        tb_long_t   real = stream->writ(self, head, pull);
+        tb_check_return_val(real >= 0, -1);
+
+        // leave cache for pull
+        tb_queue_buffer_pull_exit(&stream->cache, real);
+
+        // the cache is not cleared? wait it
+        tb_check_return_val(tb_queue_buffer_null(&stream->cache), 0);
+    }
+
+    // writ the iovec list directly
+    tb_long_t writ = stream->writv(self, list, size);
+    tb_check_return_val(writ >= 0, -1);
+
+    // update offset
+    stream->offset += writ;
+    return writ;
+}
 tb_bool_t tb_stream_bread(tb_stream_ref_t self, tb_byte_t* data, tb_size_t size)
 {
     // check
@@ -1024,71 +1197,50 @@ tb_bool_t tb_stream_bwrit(tb_stream_ref_t self, tb_byte_t const* data, tb_size_t
     // ok?
     return (writ == size? tb_true : tb_false);
 }
-tb_bool_t tb_stream_sync(tb_stream_ref_t self, tb_bool_t bclosing)
+tb_bool_t tb_stream_bwrit_chain(tb_stream_ref_t self, tb_buffer_chain_ref_t chain)
 {
     // check
     tb_stream_t* stream = tb_stream_cast(self);
-    tb_assert_and_check_return_val(stream && stream->writ && stream->wait && tb_stream_is_opened(self), tb_false);
+    tb_assert_and_check_return_val(stream && chain, tb_false);
 
-    // stoped?
-    tb_assert_and_check_return_val((TB_STATE_OPENED == tb_atomic32_get(&stream->istate)), tb_false);
+    // writ the cached data first
+    if (!tb_stream_sync_cache(self)) return tb_false;
 
-    // cached? sync cache first
-    if (tb_queue_buffer_maxn(&stream->cache))
+    // writ the slices by writv
+    tb_iovec_t list[TB_STREAM_IOVEC_MAXN];
+    while (tb_buffer_chain_size(chain) && (TB_STATE_OPENED == tb_atomic32_get(&stream->istate)))
     {
-        // have data?
-        if (!tb_queue_buffer_null(&stream->cache))
+        // writ data
+        tb_size_t count = tb_buffer_chain_peek(chain, list, tb_arrayn(list));
+        tb_long_t real = tb_stream_writv(self, list, count);
+        if (real > 0) tb_buffer_chain_skip(chain, real);
+        else if (!real)
         {
-            // check: must be writed cache
-            tb_assert_and_check_return_val(stream->bwrited, tb_false);
-
-            // enter cache for pull
-            tb_size_t   size = 0;
-            tb_byte_t*  head = tb_queue_buffer_pull_init(&stream->cache, &size);
-            tb_assert_and_check_return_val(head && size, tb_false);
-
-            // writ cache data to self
-            tb_size_t   writ = 0;
-            while (writ < size && (TB_STATE_OPENED == tb_atomic32_get(&stream->istate)))
-            {
-                // writ
-                tb_long_t real = stream->writ(self, head + writ, size - writ);
-
-                // ok?
-                if (real > 0)
-                {
-                    // save writ
-                    writ += real;
-                }
-                // no data?
-                else if (!real)
-                {
-                    // wait
-                    real = stream->wait(self, TB_STREAM_WAIT_WRIT, tb_stream_timeout(self));
+            // wait
+            real = tb_stream_wait(self, TB_STREAM_WAIT_WRIT, tb_stream_timeout(self));
+            tb_check_break(real > 0);
 
-                    // ok?
-                    tb_check_break(real > 0);
-                }
-                // error or end?
-                else break;
-            }
+            // has writ?
+            tb_assert_and_check_break(real & TB_STREAM_WAIT_WRIT);
+        }
+        else break;
+    }
 
-            // leave cache for pull
-            tb_queue_buffer_pull_exit(&stream->cache, writ);
+    // killed? save state
+    if (tb_buffer_chain_size(chain) && !stream->state && (TB_STATE_KILLING == tb_atomic32_get(&stream->istate)))
+        stream->state = TB_STATE_KILLED;
 
-            // cache be not cleared?
-            if (!tb_queue_buffer_null(&stream->cache))
-            {
-                // killed? save state
-                if (!stream->state && (TB_STATE_KILLING == tb_atomic32_get(&stream->istate)))
-                    stream->state = TB_STATE_KILLED;
+    // ok?
+    return tb_buffer_chain_size(chain)? tb_false : tb_true;
+}
+tb_bool_t tb_stream_sync(tb_stream_ref_t self, tb_bool_t bclosing)
+{
+    // check
+    tb_stream_t* stream = tb_stream_cast(self);
+    tb_assert_and_check_return_val(stream, tb_false);
 
-                // failed
-                return tb_false;
-            }
-        }
-        else stream->bwrited = 1;
-    }
+    // sync cache first
+    if (!tb_stream_sync_cache(self)) return tb_false;
 
     // sync
     return stream->sync? stream->sync(self, bclosing) : tb_true;
@@ -1168,9 +1320,9 @@ tb_bool_t tb_stream_seek(tb_stream_ref_t self, tb_hize_t offset)
         // try to read and seek
         if (!ok && offset > curt)
         {
-            // read some data for updating offset
+            // read some data for updating offset, the offset may have been moved forward by the failed seek
             tb_byte_t data[TB_STREAM_BLOCK_MAXN];
-            while (tb_stream_offset(self) != offset)
+            while ((curt = tb_stream_offset(self)) < offset)
             {
                 tb_size_t need = (tb_size_t)tb_min(offset - curt, TB_STREAM_BLOCK_MAXN);
                 if (!tb_stream_bread(self, data, need)) return tb_false;
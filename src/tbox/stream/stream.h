@@ -329,6 +329,18 @@ tb_stream_ref_t         tb_stream_init_from_data(tb_byte_t const* data, tb_size_
  */
 tb_stream_ref_t         tb_stream_init_from_file(tb_char_t const* path, tb_size_t mode);
 
+/*! init stream from the memory mapped file
+ *
+ * it is a read-only data stream over the mapped file,
+ * so tb_stream_need() and tb_stream_peek() will return the mapped data without copying.
+ *
+ * @param path          the file path, the empty file is not supported
+ * @param advice        the access advice, e.g. TB_FILE_MMAP_ADVICE_SEQUENTIAL
+ *
+ * @return              the stream
+ */
+tb_stream_ref_t         tb_stream_init_from_mmap(tb_char_t const* path, tb_size_t advice);
+
 /*! init stream from sock
  *
  * @param host          the host
@@ -606,6 +618,18 @@ tb_long_t               tb_stream_read(tb_stream_ref_t stream, tb_byte_t* data,
  */
 tb_long_t               tb_stream_writ(tb_stream_ref_t stream, tb_byte_t const* data, tb_size_t size);
 
+/*! writ the iovec list, non-blocking
+ *
+ * it will writ them by writev() or sendv() with one call if the stream supports it
+ *
+ * @param stream        the stream
+ * @param list          the iovec list
+ * @param size          the iovec list size
+ *
+ * @return              the real size or -1
+ */
+tb_long_t               tb_stream_writv(tb_stream_ref_t stream, tb_iovec_t const* list, tb_size_t size);
+
 /*! block read
  *
  * @code
@@ -650,6 +674,15 @@ tb_bool_t               tb_stream_bread(tb_stream_ref_t stream, tb_byte_t* data,
  */
 tb_bool_t               tb_stream_bwrit(tb_stream_ref_t stream, tb_byte_t const* data, tb_size_t size);
 
+/*! block writ the buffer chain by writv
+ *
+ * @param stream        the stream
+ * @param chain         the buffer chain, the writed data will be removed from it
+ *
+ * @return              tb_true or tb_false
+ */
+tb_bool_t               tb_stream_bwrit_chain(tb_stream_ref_t stream, tb_buffer_chain_ref_t chain);
+
 /*! sync stream
  *
  * @param stream        the stream
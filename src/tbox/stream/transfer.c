@@ -31,118 +31,406 @@
  */
 #include "stream.h"
 #include "transfer.h"
+#include "impl/stream.h"
 #include "../network/network.h"
 #include "../platform/platform.h"
 
 /* //////////////////////////////////////////////////////////////////////////////////////
- * interfaces
+ * macros
  */
-tb_hong_t tb_transfer(tb_stream_ref_t istream, tb_stream_ref_t ostream, tb_size_t lrate, tb_transfer_func_t func, tb_cpointer_t priv)
+
+// the block size of zero-copy transfer, it is the default pipe capacity of linux
+#ifdef __tb_small__
+#   define TB_TRANSFER_ZCOPY_MAXN           (16384)
+#else
+#   define TB_TRANSFER_ZCOPY_MAXN           (65536)
+#endif
+
+// have sendfile? we can send file data to socket in the kernel
+#if defined(TB_CONFIG_POSIX_HAVE_SENDFILE) || defined(TB_CONFIG_OS_MACOSX) || defined(TB_CONFIG_OS_IOS)
+#   define TB_TRANSFER_HAVE_SENDFILE
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the transfer type
+typedef struct __tb_transfer_t
 {
-    // check
-    tb_assert_and_check_return_val(ostream && istream, -1);
+    // the istream
+    tb_stream_ref_t         istream;
 
-    // open it first if istream have been not opened
-    if (tb_stream_is_closed(istream) && !tb_stream_open(istream)) return -1;
+    // the ostream
+    tb_stream_ref_t         ostream;
 
-    // open it first if ostream have been not opened
-    if (tb_stream_is_closed(ostream) && !tb_stream_open(ostream)) return -1;
+    // the limit rate
+    tb_size_t               lrate;
 
-    // done func
-    if (func) func(TB_STATE_OK, tb_stream_offset(istream), tb_stream_size(istream), 0, 0, priv);
+    // the func
+    tb_transfer_func_t      func;
 
-    // writ data
-    tb_byte_t data[TB_STREAM_BLOCK_MAXN];
-    tb_hize_t writ = 0;
-    tb_hize_t left = tb_stream_left(istream);
-    tb_hong_t base = tb_cache_time_spak();
-    tb_hong_t base1s = base;
-    tb_hong_t time = 0;
-    tb_size_t crate = 0;
+    // the func private data
+    tb_cpointer_t           priv;
+
+    // the writed size
+    tb_hize_t               writ;
+
+    // the writed size in 1s
+    tb_size_t               writ1s;
+
+    // the current rate
+    tb_size_t               crate;
+
+    // the base time
+    tb_hong_t               base;
+
+    // the base time for 1s
+    tb_hong_t               base1s;
+
+}tb_transfer_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static tb_void_t tb_transfer_save(tb_transfer_t* transfer, tb_size_t real)
+{
+    // save writ
+    transfer->writ += real;
+
+    // has func or limit rate?
+    tb_check_return(transfer->func || transfer->lrate);
+
+    // the time
     tb_long_t delay = 0;
-    tb_size_t writ1s = 0;
-    do
+    tb_hong_t time = tb_cache_time_spak();
+
+    // < 1s?
+    if (time < transfer->base1s + 1000)
+    {
+        // save writ1s
+        transfer->writ1s += real;
+
+        // save current rate if < 1s from base
+        if (time < transfer->base + 1000) transfer->crate = transfer->writ1s;
+
+        // compute the delay for limit rate
+        if (transfer->lrate) delay = transfer->writ1s >= transfer->lrate? (tb_size_t)(transfer->base1s + 1000 - time) : 0;
+    }
+    else
     {
-        // the need
-        tb_size_t need = lrate? tb_min(lrate, TB_STREAM_BLOCK_MAXN) : TB_STREAM_BLOCK_MAXN;
+        // save current rate
+        transfer->crate = transfer->writ1s;
+
+        // update base1s
+        transfer->base1s = time;
+
+        // reset writ1s
+        transfer->writ1s = 0;
+
+        // done func
+        if (transfer->func) transfer->func(TB_STATE_OK, tb_stream_offset(transfer->istream), tb_stream_size(transfer->istream), transfer->writ, transfer->crate, transfer->priv);
+    }
+
+    // wait some time for limit rate
+    if (delay) tb_msleep(delay);
+}
+static __tb_inline__ tb_size_t tb_transfer_need(tb_transfer_t* transfer, tb_hize_t left, tb_size_t maxn)
+{
+    // the need size for the limit rate
+    tb_size_t need = transfer->lrate? tb_min(transfer->lrate, maxn) : maxn;
 
+    // limit to the left size
+    return (tb_size_t)tb_min(left - transfer->writ, need);
+}
+static tb_void_t tb_transfer_copy(tb_transfer_t* transfer, tb_hize_t left)
+{
+    // done
+    tb_byte_t data[TB_STREAM_BLOCK_MAXN];
+    do
+    {
         // read data
-        tb_long_t real = tb_stream_read(istream, data, need);
+        tb_long_t real = tb_stream_read(transfer->istream, data, tb_transfer_need(transfer, left, TB_STREAM_BLOCK_MAXN));
         if (real > 0)
         {
             // writ data
-            if (!tb_stream_bwrit(ostream, data, real)) break;
+            if (!tb_stream_bwrit(transfer->ostream, data, real)) break;
 
             // save writ
-            writ += real;
+            tb_transfer_save(transfer, real);
+        }
+        else if (!real)
+        {
+            // wait
+            tb_long_t wait = tb_stream_wait(transfer->istream, TB_STREAM_WAIT_READ, tb_stream_timeout(transfer->istream));
+            tb_check_break(wait > 0);
 
-            // has func or limit rate?
-            if (func || lrate)
-            {
-                // the time
-                time = tb_cache_time_spak();
+            // has writ?
+            tb_assert_and_check_break(wait & TB_STREAM_WAIT_READ);
+        }
+        else break;
 
-                // < 1s?
-                if (time < base1s + 1000)
-                {
-                    // save writ1s
-                    writ1s += real;
+        // is end?
+        if (transfer->writ >= left) break;
 
-                    // save current rate if < 1s from base
-                    if (time < base + 1000) crate = writ1s;
+    } while(1);
+}
+static tb_socket_ref_t tb_transfer_sock(tb_stream_ref_t self)
+{
+    // is sock stream?
+    tb_check_return_val(tb_stream_type(self) == TB_STREAM_TYPE_SOCK, tb_null);
 
-                    // compute the delay for limit rate
-                    if (lrate) delay = writ1s >= lrate? (tb_size_t)(base1s + 1000 - time) : 0;
-                }
-                else
-                {
-                    // save current rate
-                    crate = writ1s;
+    // only for the tcp socket without ssl
+    tb_size_t type = TB_SOCKET_TYPE_NONE;
+    if (tb_url_ssl(tb_stream_url(self))) return tb_null;
+    if (!tb_stream_ctrl(self, TB_STREAM_CTRL_SOCK_GET_TYPE, &type) || type != TB_SOCKET_TYPE_TCP) return tb_null;
 
-                    // update base1s
-                    base1s = time;
+    // get socket
+    tb_socket_ref_t sock = tb_null;
+    return tb_stream_ctrl(self, TB_STREAM_CTRL_SOCK_GET_SOCK, &sock)? sock : tb_null;
+}
+static tb_file_ref_t tb_transfer_file(tb_stream_ref_t self)
+{
+    // is file stream?
+    tb_check_return_val(tb_stream_type(self) == TB_STREAM_TYPE_FILE, tb_null);
 
-                    // reset writ1s
-                    writ1s = 0;
+    // the appended file does not support the positional io of splice, so we need copy it
+    tb_size_t mode = 0;
+    if (tb_stream_ctrl(self, TB_STREAM_CTRL_FILE_GET_MODE, &mode) && (mode & TB_FILE_MODE_APPEND)) return tb_null;
 
-                    // reset delay
-                    delay = 0;
+    // get file
+    tb_file_ref_t file = tb_null;
+    return tb_stream_ctrl(self, TB_STREAM_CTRL_FILE_GET_FILE, &file)? file : tb_null;
+}
+static tb_bool_t tb_transfer_zcopy_able(tb_transfer_t* transfer)
+{
+    // the istream must have not cached data, we will read it from the file or socket directly
+    tb_stream_t* istream = tb_stream_cast(transfer->istream);
+    tb_assert_and_check_return_val(istream, tb_false);
+    tb_check_return_val(!tb_queue_buffer_maxn(&istream->cache) || tb_queue_buffer_null(&istream->cache), tb_false);
+
+    // sync the writed cache of the ostream first
+    tb_stream_t* ostream = tb_stream_cast(transfer->ostream);
+    tb_assert_and_check_return_val(ostream, tb_false);
+    if (tb_queue_buffer_maxn(&ostream->cache) && !tb_queue_buffer_null(&ostream->cache))
+    {
+        tb_check_return_val(ostream->bwrited && tb_stream_sync(transfer->ostream, tb_false), tb_false);
+    }
 
-                    // done func
-                    if (func) func(TB_STATE_OK, tb_stream_offset(istream), tb_stream_size(istream), writ, crate, priv);
-                }
+    // ok
+    return tb_true;
+}
+static __tb_inline__ tb_void_t tb_transfer_zcopy_done(tb_stream_ref_t self, tb_size_t size)
+{
+    // check
+    tb_stream_t* stream = tb_stream_cast(self);
+    tb_assert_and_check_return(stream);
 
-                // wait some time for limit rate
-                if (delay) tb_msleep(delay);
-            }
+    // we use the positional io for file, so we need update the file offset
+    if (stream->type == TB_STREAM_TYPE_FILE && stream->seek) stream->seek(self, stream->offset + size);
+
+    // update offset
+    stream->offset += size;
+}
+#ifdef TB_TRANSFER_HAVE_SENDFILE
+static tb_bool_t tb_transfer_sendf(tb_transfer_t* transfer, tb_file_ref_t ifile, tb_socket_ref_t osock, tb_hize_t left)
+{
+    // done
+    tb_long_t wait = 0;
+    while (transfer->writ < left && !tb_stream_is_killed(transfer->istream) && !tb_stream_is_killed(transfer->ostream))
+    {
+        // send file data to socket
+        tb_hong_t real = tb_socket_sendf(osock, ifile, tb_stream_offset(transfer->istream), tb_transfer_need(transfer, left, TB_TRANSFER_ZCOPY_MAXN));
+        if (real > 0)
+        {
+            // update offset
+            tb_transfer_zcopy_done(transfer->istream, (tb_size_t)real);
+            tb_transfer_zcopy_done(transfer->ostream, (tb_size_t)real);
+
+            // save writ
+            tb_transfer_save(transfer, (tb_size_t)real);
+            wait = 0;
         }
+        // no data? wait it
         else if (!real)
         {
-            // wait
-            tb_long_t wait = tb_stream_wait(istream, TB_STREAM_WAIT_READ, tb_stream_timeout(istream));
+            /* sendfile also returns 0 at the end of file, so we check it if nothing has been sent after waiting,
+             * e.g. the file has been truncated, otherwise it is only a spurious wakeup and we wait it again
+             */
+            if (wait > 0 && tb_stream_offset(transfer->istream) >= tb_file_size(ifile)) break;
+            wait = tb_stream_wait(transfer->ostream, TB_STREAM_WAIT_WRIT, tb_stream_timeout(transfer->ostream));
             tb_check_break(wait > 0);
+        }
+        // failed? we need copy it if nothing has been sent, e.g. the file is a pipe stream
+        else return !transfer->writ? tb_false : tb_true;
+    }
 
-            // has writ?
-            tb_assert_and_check_break(wait & TB_STREAM_WAIT_READ);
+    // ok
+    return tb_true;
+}
+#endif
+#ifdef TB_PIPE_FILE_HAVE_SPLICE
+static tb_bool_t tb_transfer_splice_drain(tb_transfer_t* transfer, tb_pipe_file_ref_t pipe, tb_size_t size)
+{
+    // write the pipe data to the ostream by copying
+    tb_byte_t data[TB_STREAM_BLOCK_MAXN];
+    while (size)
+    {
+        // read data from the pipe
+        tb_size_t need = tb_min(size, sizeof(data));
+        if (!tb_pipe_file_bread(pipe, data, need)) return tb_false;
+
+        // writ data
+        if (!tb_stream_bwrit(transfer->ostream, data, need)) return tb_false;
+
+        // update offset, the ostream offset has been updated by writing
+        tb_transfer_zcopy_done(transfer->istream, need);
+
+        // save writ
+        tb_transfer_save(transfer, need);
+        size -= need;
+    }
+    return tb_true;
+}
+static tb_bool_t tb_transfer_splice(tb_transfer_t* transfer, tb_socket_ref_t isock, tb_file_ref_t ofile, tb_socket_ref_t osock, tb_hize_t left)
+{
+    // init pipe
+    tb_pipe_file_ref_t pipe[2] = {tb_null};
+    if (!tb_pipe_file_init_pair(pipe, tb_null, 0)) return tb_false;
+
+    // done
+    tb_bool_t ok = tb_true;
+    tb_size_t size = 0;
+    while ((size || transfer->writ < left) && !tb_stream_is_killed(transfer->istream) && !tb_stream_is_killed(transfer->ostream))
+    {
+        // splice socket data to the pipe if the pipe has been drained
+        if (!size)
+        {
+            tb_long_t real = tb_pipe_file_splice_from_sock(pipe[1], isock, tb_transfer_need(transfer, left, TB_TRANSFER_ZCOPY_MAXN));
+            if (real > 0) size = real;
+            // no data? wait it, the closed socket will return -1, so we need not check the spurious wakeup
+            else if (!real)
+            {
+                tb_long_t wait = tb_stream_wait(transfer->istream, TB_STREAM_WAIT_READ, tb_stream_timeout(transfer->istream));
+                tb_check_break(wait > 0);
+            }
+            // closed or failed? we need copy it if nothing has been received
+            else
+            {
+                if (!transfer->writ) ok = tb_false;
+                break;
+            }
         }
-        else break;
+        // splice the pipe data to file or socket
+        else
+        {
+            tb_long_t real = ofile? tb_pipe_file_splice_to_file(pipe[0], ofile, tb_stream_offset(transfer->ostream), size) : tb_pipe_file_splice_to_sock(pipe[0], osock, size);
+            if (real > 0)
+            {
+                // update offset
+                tb_transfer_zcopy_done(transfer->istream, real);
+                tb_transfer_zcopy_done(transfer->ostream, real);
 
-        // is end?
-        if (writ >= left) break;
+                // save writ
+                tb_transfer_save(transfer, real);
+                size -= real;
+            }
+            // no data? wait it, only the socket may be blocked
+            else if (!real && osock)
+            {
+                tb_long_t wait = tb_stream_wait(transfer->ostream, TB_STREAM_WAIT_WRIT, tb_stream_timeout(transfer->ostream));
+                tb_check_break(wait > 0);
+            }
+            else break;
+        }
+    }
 
-    } while(1);
+    /* the spliced data in pipe has been not written? e.g. the output file does not support splice,
+     * we write them by copying instead of dropping them, and copy the left data if ok
+     */
+    if (size && !tb_stream_is_killed(transfer->istream) && !tb_stream_is_killed(transfer->ostream))
+        ok = !tb_transfer_splice_drain(transfer, pipe[0], size);
+
+    // exit pipe
+    tb_pipe_file_exit(pipe[0]);
+    tb_pipe_file_exit(pipe[1]);
+    return ok;
+}
+#endif
+static tb_bool_t tb_transfer_zcopy(tb_transfer_t* transfer, tb_hize_t left)
+{
+    // the input and output object
+    tb_socket_ref_t isock = tb_transfer_sock(transfer->istream);
+    tb_socket_ref_t osock = tb_transfer_sock(transfer->ostream);
+
+    /* only get the file if the other side is socket, e.g. file => file is not supported,
+     * because getting the file will stop the read-ahead or write-behind of the file stream
+     */
+    tb_file_ref_t   ifile = (!isock && osock)? tb_transfer_file(transfer->istream) : tb_null;
+    tb_file_ref_t   ofile = (!osock && isock)? tb_transfer_file(transfer->ostream) : tb_null;
+
+    // file => sock, sock => file or sock => sock?
+    tb_check_return_val((ifile && osock) || (isock && (ofile || osock)), tb_false);
+    tb_check_return_val(tb_transfer_zcopy_able(transfer), tb_false);
+
+    // trace
+    tb_trace_d("zcopy: %s => %s, left: %llu", ifile? "file" : "sock", ofile? "file" : "sock", left);
+
+    // transfer it
+    tb_bool_t ok = tb_false;
+#ifdef TB_TRANSFER_HAVE_SENDFILE
+    if (ifile) ok = tb_transfer_sendf(transfer, ifile, osock, left);
+#endif
+#ifdef TB_PIPE_FILE_HAVE_SPLICE
+    if (isock) ok = tb_transfer_splice(transfer, isock, ofile, osock, left);
+#endif
+    return ok;
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+tb_hong_t tb_transfer(tb_stream_ref_t istream, tb_stream_ref_t ostream, tb_size_t lrate, tb_transfer_func_t func, tb_cpointer_t priv)
+{
+    // check
+    tb_assert_and_check_return_val(ostream && istream, -1);
+
+    // open it first if istream have been not opened
+    if (tb_stream_is_closed(istream) && !tb_stream_open(istream)) return -1;
+
+    // open it first if ostream have been not opened
+    if (tb_stream_is_closed(ostream) && !tb_stream_open(ostream)) return -1;
+
+    // done func
+    if (func) func(TB_STATE_OK, tb_stream_offset(istream), tb_stream_size(istream), 0, 0, priv);
+
+    // init transfer
+    tb_transfer_t transfer;
+    tb_memset(&transfer, 0, sizeof(tb_transfer_t));
+    transfer.istream    = istream;
+    transfer.ostream    = ostream;
+    transfer.lrate      = lrate;
+    transfer.func       = func;
+    transfer.priv       = priv;
+    transfer.base       = tb_cache_time_spak();
+    transfer.base1s     = transfer.base;
+
+    // writ data, we attempt to transfer it in the kernel first for file => sock, sock => file and sock => sock
+    tb_hize_t left = tb_stream_left(istream);
+    if (left && !tb_transfer_zcopy(&transfer, left)) tb_transfer_copy(&transfer, left);
 
     // sync the ostream
     if (!tb_stream_sync(ostream, tb_true)) return -1;
 
     // has func?
+    tb_hize_t writ = transfer.writ;
     if (func)
     {
         // the time
-        time = tb_cache_time_spak();
+        tb_hong_t time = tb_cache_time_spak();
 
         // compute the total rate
-        tb_size_t trate = (writ && (time > base))? (tb_size_t)((writ * 1000) / (time - base)) : (tb_size_t)writ;
+        tb_size_t trate = (writ && (time > transfer.base))? (tb_size_t)((writ * 1000) / (time - transfer.base)) : (tb_size_t)writ;
 
         // done func
         func(TB_STATE_CLOSED, tb_stream_offset(istream), tb_stream_size(istream), writ, trate, priv);
@@ -31,6 +31,8 @@
  */
 #include "lock_profiler.h"
 #include "singleton.h"
+#include "bits.h"
+#include "../libc/libc.h"
 #include "../platform/platform.h"
 
 /* //////////////////////////////////////////////////////////////////////////////////////
@@ -44,10 +46,40 @@
 #   define TB_LOCK_PROFILER_MAXN            (512)
 #endif
 
+// the sampled stacks maxn
+#ifdef __tb_small__
+#   define TB_LOCK_PROFILER_STACK_MAXN      (256)
+#else
+#   define TB_LOCK_PROFILER_STACK_MAXN      (1024)
+#endif
+
+// the frames maxn of each sampled stack
+#define TB_LOCK_PROFILER_FRAME_MAXN         (16)
+
+// the probe count of the hash table
+#define TB_LOCK_PROFILER_PROBE_MAXN         (16)
+
+// the histogram buckets count, the bucket i contains the ticks in [2^(i - 1), 2^i)
+#define TB_LOCK_PROFILER_HIST_MAXN          (48)
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * types
  */
 
+// the lock profiler histogram type
+typedef struct __tb_lock_profiler_hist_t
+{
+    // the samples count
+    tb_atomic32_t                   count;
+
+    // the total ticks
+    tb_atomic64_t                   ticks;
+
+    // the buckets
+    tb_atomic32_t                   buckets[TB_LOCK_PROFILER_HIST_MAXN];
+
+}tb_lock_profiler_hist_t;
+
 // the lock profiler item type
 typedef struct __tb_lock_profiler_item_t
 {
@@ -60,16 +92,71 @@ typedef struct __tb_lock_profiler_item_t
     // the lock name
     tb_atomic_t                     name;
 
+    // the wait time histogram
+    tb_lock_profiler_hist_t         wait;
+
+    /* the contended hold time histogram
+     *
+     * it only measures the hold times of the sampled contended acquisitions,
+     * so the uncontended fast path of the locks is not slowed down
+     */
+    tb_lock_profiler_hist_t         contended_hold;
+
 }tb_lock_profiler_item_t;
 
+// the lock profiler sampled stack type
+typedef struct __tb_lock_profiler_stack_t
+{
+    // the lock address, it will be published after the frames have been saved
+    tb_atomic_t                     lock;
+
+    // the frames hash
+    tb_size_t                       hash;
+
+    // the frames count
+    tb_size_t                       nframe;
+
+    // the frames
+    tb_pointer_t                    frames[TB_LOCK_PROFILER_FRAME_MAXN];
+
+    // the sampled count
+    tb_atomic32_t                   count;
+
+    // the total wait ticks
+    tb_atomic64_t                   wait;
+
+}tb_lock_profiler_stack_t;
+
 // the lock profiler type
 typedef struct __tb_lock_profiler_t
 {
     // the list
     tb_lock_profiler_item_t         list[TB_LOCK_PROFILER_MAXN];
 
+    // the sampled stacks
+    tb_lock_profiler_stack_t        stacks[TB_LOCK_PROFILER_STACK_MAXN];
+
+    // the stacks lock
+    tb_spinlock_t                   lock;
+
+    // the sampling rate
+    tb_atomic_t                     rate;
+
+    // the contentions count for sampling
+    tb_atomic_t                     contentions;
+
 }tb_lock_profiler_t;
 
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * globals
+ */
+
+// the sampled contended lock and the start ticks for the contended hold time of the current thread
+#ifdef __tb_thread_local__
+static __tb_thread_local__ tb_pointer_t     g_contended_lock = tb_null;
+static __tb_thread_local__ tb_hong_t        g_contended_ticks = 0;
+#endif
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * instance implementation
  */
@@ -83,6 +170,134 @@ static tb_void_t tb_lock_profiler_instance_exit(tb_handle_t handle, tb_cpointer_
     tb_lock_profiler_exit((tb_lock_profiler_ref_t)handle);
 }
 
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static tb_lock_profiler_item_t* tb_lock_profiler_item(tb_lock_profiler_t* profiler, tb_pointer_t lock, tb_bool_t create)
+{
+    // the lock address
+    tb_size_t addr = (tb_size_t)lock;
+
+    // compile the hash value
+    addr ^= (addr >> 8) ^ (addr >> 16);
+
+    // walk
+    tb_size_t i = 0;
+    for (i = 0; i < TB_LOCK_PROFILER_PROBE_MAXN; i++, addr++)
+    {
+        // the item
+        tb_lock_profiler_item_t* item = &profiler->list[addr & (TB_LOCK_PROFILER_MAXN - 1)];
+
+        // is this lock?
+        tb_long_t zero = 0;
+        if (lock == (tb_pointer_t)tb_atomic_get(&item->lock)) return item;
+        else if (create && tb_atomic_compare_and_swap(&item->lock, &zero, (tb_long_t)lock)) return item;
+        else if (create && lock == (tb_pointer_t)zero) return item;
+    }
+    return tb_null;
+}
+static tb_void_t tb_lock_profiler_hist_add(tb_lock_profiler_hist_t* hist, tb_hong_t ticks)
+{
+    // get the bucket index, it is the bit length of the ticks
+    tb_size_t index = ticks > 0? 64 - tb_bits_cl0_u64_be((tb_uint64_t)ticks) : 0;
+    if (index >= TB_LOCK_PROFILER_HIST_MAXN) index = TB_LOCK_PROFILER_HIST_MAXN - 1;
+
+    // add it
+    tb_atomic32_fetch_and_add_explicit(&hist->buckets[index], 1, TB_ATOMIC_RELAXED);
+    tb_atomic32_fetch_and_add_explicit(&hist->count, 1, TB_ATOMIC_RELAXED);
+    tb_atomic64_fetch_and_add_explicit(&hist->ticks, ticks > 0? ticks : 0, TB_ATOMIC_RELAXED);
+}
+static tb_void_t tb_lock_profiler_hist_dump(tb_char_t const* name, tb_lock_profiler_hist_t* hist)
+{
+    // no samples?
+    tb_size_t count = tb_atomic32_get(&hist->count);
+    tb_check_return(count);
+
+    // dump the percentiles
+    tb_size_t i = 0;
+    tb_size_t sum = 0;
+    tb_hong_t p50 = 0;
+    tb_hong_t p99 = 0;
+    tb_hong_t max = 0;
+    for (i = 0; i < TB_LOCK_PROFILER_HIST_MAXN; i++)
+    {
+        tb_size_t n = tb_atomic32_get(&hist->buckets[i]);
+        tb_check_continue(n);
+
+        tb_hong_t upper = tb_tsc_ticks_to_ns((tb_hong_t)1 << i);
+        sum += n;
+        if (!p50 && sum * 2 >= count) p50 = upper;
+        if (!p99 && sum * 100 >= count * 99) p99 = upper;
+        max = upper;
+    }
+    tb_trace_i("    %s: count: %lu, avg: %lld ns, p50: < %lld ns, p99: < %lld ns, max: < %lld ns", name, count
+        , tb_tsc_ticks_to_ns(tb_atomic64_get(&hist->ticks)) / count, p50, p99, max);
+
+    // dump the buckets
+    tb_char_t   line[256];
+    tb_size_t   size = 0;
+    for (i = 0; i < TB_LOCK_PROFILER_HIST_MAXN && size < sizeof(line) - 32; i++)
+    {
+        tb_size_t n = tb_atomic32_get(&hist->buckets[i]);
+        if (n) size += tb_snprintf(line + size, sizeof(line) - size, " <%lldns:%lu", tb_tsc_ticks_to_ns((tb_hong_t)1 << i), n);
+    }
+    line[size] = '\0';
+    tb_trace_i("    %s:%s", name, line);
+}
+static tb_void_t tb_lock_profiler_stack_save(tb_lock_profiler_t* profiler, tb_pointer_t lock, tb_hong_t wait)
+{
+    // get the backtrace frames, skip this function and tb_lock_profiler_entered
+    tb_pointer_t frames[TB_LOCK_PROFILER_FRAME_MAXN];
+    tb_size_t    nframe = tb_backtrace_frames(frames, TB_LOCK_PROFILER_FRAME_MAXN, 3);
+    tb_check_return(nframe);
+
+    // compute the hash value of the lock and frames
+    tb_size_t i = 0;
+    tb_size_t hash = (tb_size_t)lock;
+    for (i = 0; i < nframe; i++) hash = (hash * 31) ^ (tb_size_t)frames[i];
+
+    // find or save this stack
+    tb_size_t index = hash;
+    for (i = 0; i < TB_LOCK_PROFILER_PROBE_MAXN; i++, index++)
+    {
+        tb_lock_profiler_stack_t* stack = &profiler->stacks[index & (TB_LOCK_PROFILER_STACK_MAXN - 1)];
+
+        // empty? save it
+        if (!tb_atomic_get(&stack->lock))
+        {
+            tb_bool_t saved = tb_false;
+            tb_spinlock_enter_without_profiler(&profiler->lock);
+            if (!tb_atomic_get(&stack->lock))
+            {
+                stack->hash = hash;
+                stack->nframe = nframe;
+                tb_memcpy_(stack->frames, frames, nframe * sizeof(tb_pointer_t));
+                tb_atomic_set(&stack->lock, (tb_long_t)lock);
+                saved = tb_true;
+            }
+            tb_spinlock_leave(&profiler->lock);
+            if (!saved && (tb_pointer_t)tb_atomic_get(&stack->lock) != lock) continue;
+        }
+
+        // is this stack?
+        if ((tb_pointer_t)tb_atomic_get(&stack->lock) == lock && stack->hash == hash && stack->nframe == nframe
+            && !tb_memcmp_(stack->frames, frames, nframe * sizeof(tb_pointer_t)))
+        {
+            tb_atomic32_fetch_and_add_explicit(&stack->count, 1, TB_ATOMIC_RELAXED);
+            tb_atomic64_fetch_and_add_explicit(&stack->wait, wait, TB_ATOMIC_RELAXED);
+            break;
+        }
+    }
+}
+static tb_size_t tb_lock_profiler_symbol_copy(tb_char_t* data, tb_size_t maxn, tb_char_t const* name)
+{
+    // copy the symbol name and escape the separators of the collapsed stacks
+    tb_size_t size = 0;
+    for (; name && *name && size < maxn; name++, size++)
+        data[size] = (*name == ';' || *name == ' ')? '_' : *name;
+    return size;
+}
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * implementation
  */
@@ -92,11 +307,23 @@ tb_lock_profiler_ref_t tb_lock_profiler()
 }
 tb_lock_profiler_ref_t tb_lock_profiler_init()
 {
-    return (tb_lock_profiler_ref_t)tb_native_memory_malloc0(sizeof(tb_lock_profiler_t));
+    // init profiler
+    tb_lock_profiler_t* profiler = (tb_lock_profiler_t*)tb_native_memory_malloc0(sizeof(tb_lock_profiler_t));
+    tb_assert_and_check_return_val(profiler, tb_null);
+
+    // init it
+    tb_spinlock_init(&profiler->lock);
+    tb_atomic_init(&profiler->rate, TB_LOCK_PROFILER_SAMPLE_RATE);
+    return (tb_lock_profiler_ref_t)profiler;
 }
 tb_void_t tb_lock_profiler_exit(tb_lock_profiler_ref_t self)
 {
-    if (self) tb_native_memory_free((tb_pointer_t)self);
+    tb_lock_profiler_t* profiler = (tb_lock_profiler_t*)self;
+    if (profiler)
+    {
+        tb_spinlock_exit(&profiler->lock);
+        tb_native_memory_free((tb_pointer_t)profiler);
+    }
 }
 tb_void_t tb_lock_profiler_dump(tb_lock_profiler_ref_t self)
 {
@@ -120,50 +347,90 @@ tb_void_t tb_lock_profiler_dump(tb_lock_profiler_ref_t self)
         if ((lock = (tb_pointer_t)tb_atomic_get(&item->lock)))
         {
             // dump lock
-            tb_trace_i("lock: %p, name: %s, occupied: %d", lock, (tb_char_t const*)tb_atomic_get(&item->name), tb_atomic32_get(&item->size));
+            tb_char_t const* name = (tb_char_t const*)tb_atomic_get(&item->name);
+            tb_trace_i("lock: %p, name: %s, occupied: %d", lock, name? name : "anonymous", tb_atomic32_get(&item->size));
+
+            // dump histograms
+            tb_lock_profiler_hist_dump("wait", &item->wait);
+            tb_lock_profiler_hist_dump("contended hold", &item->contended_hold);
         }
     }
 }
-tb_void_t tb_lock_profiler_register(tb_lock_profiler_ref_t self, tb_pointer_t lock, tb_char_t const* name)
+tb_bool_t tb_lock_profiler_dump_stacks(tb_lock_profiler_ref_t self, tb_char_t const* path)
 {
     // check
     tb_lock_profiler_t* profiler = (tb_lock_profiler_t*)self;
-    tb_assert_and_check_return(profiler && lock);
-
-    // trace
-    tb_trace_d("register: lock: %p, name: %s: ..", lock, name);
+    tb_assert_and_check_return_val(profiler && path, tb_false);
 
-    // the lock address
-    tb_size_t addr = (tb_size_t)lock;
+    // init file
+    tb_file_ref_t file = tb_file_init(path, TB_FILE_MODE_WO | TB_FILE_MODE_CREAT | TB_FILE_MODE_TRUNC);
+    tb_assert_and_check_return_val(file, tb_false);
 
-    // compile the hash value
-    addr ^= (addr >> 8) ^ (addr >> 16);
-
-    // walk
-    tb_size_t i = 0;
-    for (i = 0; i < 16; i++, addr++)
+    // walk the sampled stacks
+    tb_size_t   i = 0;
+    tb_bool_t   ok = tb_true;
+    tb_char_t   line[4096];
+    for (i = 0; i < TB_LOCK_PROFILER_STACK_MAXN && ok; i++)
     {
-        // the item
-        tb_lock_profiler_item_t* item = &profiler->list[addr & (TB_LOCK_PROFILER_MAXN - 1)];
+        // the stack
+        tb_lock_profiler_stack_t*   stack = &profiler->stacks[i];
+        tb_pointer_t                lock = (tb_pointer_t)tb_atomic_get(&stack->lock);
+        tb_check_continue(lock);
 
-        // try to register the lock
-        tb_long_t zero = 0;
-        if (tb_atomic_compare_and_swap(&item->lock, &zero, (tb_long_t)lock))
+        // the lock name is the root frame
+        tb_size_t                   size = 0;
+        tb_size_t                   maxn = sizeof(line) - 64;
+        tb_lock_profiler_item_t*    item = tb_lock_profiler_item(profiler, lock, tb_false);
+        tb_char_t const*            name = item? (tb_char_t const*)tb_atomic_get(&item->name) : tb_null;
+        if (name) size = tb_lock_profiler_symbol_copy(line, maxn, name);
+        else size = tb_snprintf(line, maxn, "lock_%p", lock);
+
+        // append the frames from the outermost frame
+        tb_handle_t symbols = tb_backtrace_symbols_init(stack->frames, stack->nframe);
+        tb_size_t   j = stack->nframe;
+        while (j-- && size + 1 < maxn)
         {
-            // init name
-            tb_atomic_set(&item->name, (tb_long_t)name);
-            tb_atomic32_init(&item->size, 0);
+            tb_char_t const* symbol = symbols? tb_backtrace_symbols_name(symbols, stack->frames, stack->nframe, j) : tb_null;
+            line[size++] = ';';
+            if (symbol) size += tb_lock_profiler_symbol_copy(line + size, maxn - size, symbol);
+            else size += tb_snprintf(line + size, maxn - size, "%p", stack->frames[j]);
+        }
+        if (symbols) tb_backtrace_symbols_exit(symbols);
 
-            // trace
-            tb_trace_d("register: lock: %p, name: %s, index: %lu: ok", lock, name, addr & (TB_LOCK_PROFILER_MAXN - 1));
+        // append the total wait time
+        tb_hong_t wait = tb_tsc_ticks_to_ns(tb_atomic64_get(&stack->wait));
+        size += tb_snprintf(line + size, sizeof(line) - size, " %lld\n", wait > 0? wait : 1);
 
-            // ok
-            break;
-        }
+        // write it
+        ok = tb_file_writ(file, (tb_byte_t const*)line, size) == (tb_long_t)size;
     }
 
-    // full?
-    if (i == 16)
+    // exit file
+    tb_file_exit(file);
+    return ok;
+}
+tb_void_t tb_lock_profiler_sample(tb_lock_profiler_ref_t self, tb_size_t rate)
+{
+    // check
+    tb_lock_profiler_t* profiler = (tb_lock_profiler_t*)self;
+    tb_assert_and_check_return(profiler);
+
+    // set the sampling rate
+    tb_atomic_set(&profiler->rate, rate);
+}
+tb_void_t tb_lock_profiler_register(tb_lock_profiler_ref_t self, tb_pointer_t lock, tb_char_t const* name)
+{
+    // check
+    tb_lock_profiler_t* profiler = (tb_lock_profiler_t*)self;
+    tb_assert_and_check_return(profiler && lock);
+
+    // trace
+    tb_trace_d("register: lock: %p, name: %s: ..", lock, name);
+
+    // register it, it may have been registered as the anonymous lock after it was occupied
+    tb_lock_profiler_item_t* item = tb_lock_profiler_item(profiler, lock, tb_true);
+    if (item) tb_atomic_set(&item->name, (tb_long_t)name);
+    else
     {
         // trace
         tb_trace_w("register: lock: %p, name: %s: no", lock, name);
@@ -175,28 +442,45 @@ tb_void_t tb_lock_profiler_occupied(tb_lock_profiler_ref_t self, tb_pointer_t lo
     tb_lock_profiler_t* profiler = (tb_lock_profiler_t*)self;
     tb_check_return(profiler && lock);
 
-    // the lock address
-    tb_size_t addr = (tb_size_t)lock;
+    // occupied++
+    tb_lock_profiler_item_t* item = tb_lock_profiler_item(profiler, lock, tb_true);
+    if (item) tb_atomic32_fetch_and_add(&item->size, 1);
+}
+tb_void_t tb_lock_profiler_entered(tb_lock_profiler_ref_t self, tb_pointer_t lock, tb_hong_t wait)
+{
+    // check
+    tb_lock_profiler_t* profiler = (tb_lock_profiler_t*)self;
+    tb_check_return(profiler && lock);
 
-    // compile the hash value
-    addr ^= (addr >> 8) ^ (addr >> 16);
+    // add the wait time
+    tb_lock_profiler_item_t* item = tb_lock_profiler_item(profiler, lock, tb_true);
+    tb_check_return(item);
+    tb_lock_profiler_hist_add(&item->wait, wait);
 
-    // walk
-    tb_size_t i = 0;
-    for (i = 0; i < 16; i++, addr++)
+    // sample this contention?
+    tb_size_t rate = (tb_size_t)tb_atomic_get_explicit(&profiler->rate, TB_ATOMIC_RELAXED);
+    if (rate && !((tb_size_t)tb_atomic_fetch_and_add_explicit(&profiler->contentions, 1, TB_ATOMIC_RELAXED) % rate))
     {
-        // the item
-        tb_lock_profiler_item_t* item = &profiler->list[addr & (TB_LOCK_PROFILER_MAXN - 1)];
+        // save the contention backtrace
+        tb_lock_profiler_stack_save(profiler, lock, wait);
 
-        // is this lock?
-        if (lock == (tb_pointer_t)tb_atomic_get(&item->lock))
-        {
-            // occupied++
-            tb_atomic32_fetch_and_add(&item->size, 1);
-
-            // ok
-            break;
-        }
+        // start to measure the contended hold time
+#ifdef __tb_thread_local__
+        g_contended_lock = lock;
+        g_contended_ticks = tb_lock_profiler_ticks();
+#endif
     }
 }
+tb_void_t tb_lock_profiler_leave(tb_pointer_t lock)
+{
+#ifdef __tb_thread_local__
+    // is the sampled contended lock?
+    tb_check_return(lock && g_contended_lock == lock);
+    g_contended_lock = tb_null;
 
+    // add the contended hold time
+    tb_lock_profiler_t*         profiler = (tb_lock_profiler_t*)tb_lock_profiler();
+    tb_lock_profiler_item_t*    item = profiler? tb_lock_profiler_item(profiler, lock, tb_false) : tb_null;
+    if (item) tb_lock_profiler_hist_add(&item->contended_hold, tb_lock_profiler_ticks() - g_contended_ticks);
+#endif
+}
@@ -26,6 +26,7 @@
  * includes
  */
 #include "prefix.h"
+#include "../platform/tsc.h"
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * extern
@@ -36,12 +37,19 @@ __tb_extern_c_enter__
  * macros
  */
 
-// enable lock profiler
+// enable lock profiler, it is enabled for the debug mode or `--lock_profiler=y`
 #undef TB_LOCK_PROFILER_ENABLE
-#if defined(__tb_debug__) && !defined(TB_CONFIG_MICRO_ENABLE)
+#if (defined(__tb_debug__) || defined(TB_CONFIG_LOCK_PROFILER_ENABLE)) && !defined(TB_CONFIG_MICRO_ENABLE)
 #   define TB_LOCK_PROFILER_ENABLE
 #endif
 
+/// the default sampling rate of the contention backtraces and contended hold times
+#ifdef __tb_debug__
+#   define TB_LOCK_PROFILER_SAMPLE_RATE     (16)
+#else
+#   define TB_LOCK_PROFILER_SAMPLE_RATE     (256)
+#endif
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * types
  */
@@ -53,6 +61,15 @@ typedef __tb_typeref__(lock_profiler);
  * interfaces
  */
 
+/*! get the lock profiler ticks
+ *
+ * @return              the ticks of the cpu cycle counter
+ */
+static __tb_inline_force__ tb_hong_t tb_lock_profiler_ticks()
+{
+    return tb_tsc_ticks();
+}
+
 /*! the lock profiler instance
  *
  * @return              the lock profiler
@@ -74,11 +91,36 @@ tb_lock_profiler_ref_t  tb_lock_profiler_init(tb_noarg_t);
 tb_void_t               tb_lock_profiler_exit(tb_lock_profiler_ref_t profiler);
 
 /*! dump lock profiler
+ *
+ * dump the occupied count, the wait and contended hold time histograms of all locks
+ *
+ * the contended hold time is only measured for the sampled contended acquisitions,
+ * it is not the hold time of all acquisitions
  *
  * @param profiler      the lock profiler
  */
 tb_void_t               tb_lock_profiler_dump(tb_lock_profiler_ref_t profiler);
 
+/*! dump the sampled contention backtraces as the collapsed stacks
+ *
+ * each line is "lock;frame;...;frame wait_ns" and we can pass it to flamegraph.pl directly
+ *
+ * @param profiler      the lock profiler
+ * @param path          the output file path
+ *
+ * @return              tb_true or tb_false
+ */
+tb_bool_t               tb_lock_profiler_dump_stacks(tb_lock_profiler_ref_t profiler, tb_char_t const* path);
+
+/*! set the sampling rate
+ *
+ * we capture the backtrace and contended hold time of one in every rate contentions, disable it if rate is zero
+ *
+ * @param profiler      the lock profiler
+ * @param rate          the sampling rate, TB_LOCK_PROFILER_SAMPLE_RATE by default
+ */
+tb_void_t               tb_lock_profiler_sample(tb_lock_profiler_ref_t profiler, tb_size_t rate);
+
 /*! register the lock to the lock profiler
  *
  * @param profiler      the lock profiler
@@ -88,12 +130,31 @@ tb_void_t               tb_lock_profiler_dump(tb_lock_profiler_ref_t profiler);
 tb_void_t               tb_lock_profiler_register(tb_lock_profiler_ref_t profiler, tb_pointer_t lock, tb_char_t const* name);
 
 /*! the lock be occupied
+ *
+ * @note the unregistered lock will be registered automatically
  *
  * @param profiler      the lock profiler
  * @param lock          the lock address
  */
 tb_void_t               tb_lock_profiler_occupied(tb_lock_profiler_ref_t profiler, tb_pointer_t lock);
 
+/*! the occupied lock has been entered after waiting
+ *
+ * @param profiler      the lock profiler
+ * @param lock          the lock address
+ * @param wait          the wait ticks
+ */
+tb_void_t               tb_lock_profiler_entered(tb_lock_profiler_ref_t profiler, tb_pointer_t lock, tb_hong_t wait);
+
+/*! the lock will be left, we need call it before unlocking it
+ *
+ * @note it only checks the sampled contended lock of the current thread on the hot path,
+ * so it uses the lock profiler instance directly
+ *
+ * @param lock          the lock address
+ */
+tb_void_t               tb_lock_profiler_leave(tb_pointer_t lock);
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * extern
  */
@@ -32,6 +32,19 @@
  */
 __tb_extern_c_enter__
 
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+/// the max count of the user defined singleton types
+#if defined(TB_CONFIG_MICRO_ENABLE)
+#   define TB_SINGLETON_USER_MAXN                   (2)
+#elif defined(__tb_small__)
+#   define TB_SINGLETON_USER_MAXN                   (8)
+#else
+#   define TB_SINGLETON_USER_MAXN                   (64)
+#endif
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * types
  */
@@ -97,15 +110,33 @@ typedef enum __tb_singleton_type_e
     /// the user defined type
 ,   TB_SINGLETON_TYPE_USER                  = 16
 
+    /* the internal types are appended after the user defined types
+     *
+     * we cannot change the value of TB_SINGLETON_TYPE_USER and the range of the user defined types,
+     * because the user singletons are always defined as TB_SINGLETON_TYPE_USER + n.
+     *
+     * @note each new internal type is appended after the last one, the existing values must not be changed
+     */
+
+    /// the helper thread pool type for the blocking tasks of coroutine
+,   TB_SINGLETON_TYPE_CO_TASK_POOL          = TB_SINGLETON_TYPE_USER + TB_SINGLETON_USER_MAXN
+
+    /// the epoch-based reclamation type
+,   TB_SINGLETON_TYPE_EPOCH                 = TB_SINGLETON_TYPE_CO_TASK_POOL + 1
+
+    /// the hazard pointers type
+,   TB_SINGLETON_TYPE_HAZARD                = TB_SINGLETON_TYPE_EPOCH + 1
+
+    /// the cache time ticker type
+,   TB_SINGLETON_TYPE_CACHE_TIME            = TB_SINGLETON_TYPE_HAZARD + 1
+
 #endif
 
     /// the max count of the singleton type
 #if defined(TB_CONFIG_MICRO_ENABLE)
-,   TB_SINGLETON_TYPE_MAXN                  = TB_SINGLETON_TYPE_USER + 2
-#elif defined(__tb_small__)
-,   TB_SINGLETON_TYPE_MAXN                  = TB_SINGLETON_TYPE_USER + 8
+,   TB_SINGLETON_TYPE_MAXN                  = TB_SINGLETON_TYPE_USER + TB_SINGLETON_USER_MAXN
 #else
-,   TB_SINGLETON_TYPE_MAXN                  = TB_SINGLETON_TYPE_USER + 64
+,   TB_SINGLETON_TYPE_MAXN                  = TB_SINGLETON_TYPE_CACHE_TIME + 1
 #endif
 
 }tb_singleton_type_e;
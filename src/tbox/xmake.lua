@@ -47,7 +47,7 @@ target("tbox")
     end
 
     -- add options
-    add_options("info", "float", "wchar", "exception", "force-utf8", "deprecated")
+    add_options("info", "float", "wchar", "exception", "force-utf8", "deprecated", "lock-profiler")
 
     -- add modules
     add_options("xml", "zip", "hash", "regex", "coroutine", "object", "charset", "database")
@@ -87,28 +87,35 @@ target "tbox"
     add_files "platform/event.c"
     add_files "platform/file.c"
     add_files "platform/filelock.c"
+    add_files "platform/future.c"
+    add_files "platform/futex.c"
     add_files "platform/fwatcher.c"
     add_files "platform/hostname.c"
+    add_files "platform/htimer.c"
     add_files "platform/ifaddrs.c"
     add_files "platform/ltimer.c"
     add_files "platform/mutex.c"
     add_files "platform/native_memory.c"
     add_files "platform/page.c"
     add_files "platform/path.c"
+    add_files "platform/percpu_counter.c"
     add_files "platform/pipe.c"
     add_files "platform/poller.c"
     add_files "platform/print.c"
     add_files "platform/process.c"
+    add_files "platform/rwlock.c"
     add_files "platform/sched.c"
     add_files "platform/semaphore.c"
     add_files "platform/socket.c"
     add_files "platform/stdfile.c"
     add_files "platform/syserror.c"
+    add_files "platform/task_graph.c"
     add_files "platform/thread.c"
     add_files "platform/thread_local.c"
     add_files "platform/thread_pool.c"
     add_files "platform/time.c"
     add_files "platform/timer.c"
+    add_files "platform/tsc.c"
     add_files "platform/virtual_memory.c"
     add_files "platform/impl/platform.c"
     add_files "platform/impl/pollerdata.c"
@@ -234,6 +241,7 @@ target "tbox"
     # add the source files for the zip module
     if has_config "zip"; then
         add_files "zip/zip.c"
+        add_files "zip/lz4.c"
         add_files "stream/impl/filter/zip.c"
     fi
 
@@ -65,6 +65,9 @@ static tb_long_t tb_zip_gzip_spak_deflate(tb_zip_ref_t zip, tb_static_stream_ref
 
     // deflate
     tb_int_t r = deflate(&gzip->zstream, sync > 0? Z_SYNC_FLUSH : (sync < 0? Z_FINISH : Z_NO_FLUSH));
+
+    // no progress for flushing it again? it is not fatal
+    tb_check_return_val(r != Z_BUF_ERROR || sync <= 0, 0);
     tb_assertf_and_check_return_val(r == Z_OK || r == Z_STREAM_END, -1, "sync: %ld, error: %d", sync, r);
     tb_trace_d("deflate: %u => %u, sync: %ld", (tb_size_t)(ie - ip), (tb_size_t)((tb_byte_t*)gzip->zstream.next_out - op), sync);
 
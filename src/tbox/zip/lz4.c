@@ -0,0 +1,1081 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        lz4.c
+ * @ingroup     zip
+ *
+ */
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * trace
+ */
+#define TB_TRACE_MODULE_NAME                "lz4"
+#define TB_TRACE_MODULE_DEBUG               (0)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "lz4.h"
+#include "../utils/bits.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the frame magic
+#define TB_ZIP_LZ4_MAGIC                (0x184d2204)
+
+// the skippable frame magic, 0x184d2a50 - 0x184d2a5f
+#define TB_ZIP_LZ4_MAGIC_SKIP           (0x184d2a50)
+
+// the frame flags
+#define TB_ZIP_LZ4_FLAG_VERSION         (0x40)
+#define TB_ZIP_LZ4_FLAG_BLOCK_INDEP     (0x20)
+#define TB_ZIP_LZ4_FLAG_BLOCK_CHECKSUM  (0x10)
+#define TB_ZIP_LZ4_FLAG_CONTENT_SIZE    (0x08)
+#define TB_ZIP_LZ4_FLAG_CONTENT_CHECKSUM (0x04)
+#define TB_ZIP_LZ4_FLAG_DICTID          (0x01)
+
+// the uncompressed block flag of the block size
+#define TB_ZIP_LZ4_BLOCK_RAW            (0x80000000)
+
+// the block maxn for deflating, 64K
+#define TB_ZIP_LZ4_BLOCK_MAXN           (65536)
+
+// the block bound
+#define TB_ZIP_LZ4_BLOCK_BOUND(n)       ((n) + ((n) / 255) + 16)
+
+// the match distance maxn and the history size of the linked blocks
+#define TB_ZIP_LZ4_DISTANCE_MAXN        (65535)
+#define TB_ZIP_LZ4_HISTORY              (65536)
+
+// the minimum match length
+#define TB_ZIP_LZ4_MINMATCH             (4)
+
+// the last literals must be at least 5 bytes
+#define TB_ZIP_LZ4_LASTLITERALS         (5)
+
+// the last match must start at least 12 bytes before the end of block
+#define TB_ZIP_LZ4_MFLIMIT              (12)
+
+// the hash bits of the fast and high compressors
+#define TB_ZIP_LZ4_HASH_BITS            (12)
+#define TB_ZIP_LZ4_HC_HASH_BITS         (15)
+
+// the match attempts of the high compressor
+#ifdef __tb_small__
+#   define TB_ZIP_LZ4_HC_ATTEMPTS       (32)
+#else
+#   define TB_ZIP_LZ4_HC_ATTEMPTS       (128)
+#endif
+
+// the xxh32 primes
+#define TB_ZIP_LZ4_XXH32_P1             (2654435761U)
+#define TB_ZIP_LZ4_XXH32_P2             (2246822519U)
+#define TB_ZIP_LZ4_XXH32_P3             (3266489917U)
+#define TB_ZIP_LZ4_XXH32_P4             (668265263U)
+#define TB_ZIP_LZ4_XXH32_P5             (374761393U)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the frame state type
+typedef enum __tb_zip_lz4_state_e
+{
+    TB_ZIP_LZ4_STATE_MAGIC          = 0     //!< read or write the frame magic and descriptor
+,   TB_ZIP_LZ4_STATE_HEADER         = 1     //!< read the frame descriptor
+,   TB_ZIP_LZ4_STATE_SKIP           = 2     //!< skip the skippable frame
+,   TB_ZIP_LZ4_STATE_BLOCK_SIZE     = 3     //!< read the block size
+,   TB_ZIP_LZ4_STATE_BLOCK_DATA     = 4     //!< read or write the block data
+,   TB_ZIP_LZ4_STATE_CHECKSUM       = 5     //!< read or write the end mark and the content checksum
+,   TB_ZIP_LZ4_STATE_END            = 6     //!< end
+
+}tb_zip_lz4_state_e;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * xxh32
+ */
+static __tb_inline__ tb_uint32_t tb_zip_lz4_xxh32_rotl(tb_uint32_t x, tb_size_t r)
+{
+    return (x << r) | (x >> (32 - r));
+}
+static __tb_inline__ tb_uint32_t tb_zip_lz4_xxh32_round(tb_uint32_t acc, tb_uint32_t input)
+{
+    acc += input * TB_ZIP_LZ4_XXH32_P2;
+    acc  = tb_zip_lz4_xxh32_rotl(acc, 13);
+    return acc * TB_ZIP_LZ4_XXH32_P1;
+}
+static tb_void_t tb_zip_lz4_xxh32_init(tb_zip_lz4_xxh32_t* xxh32)
+{
+    tb_memset(xxh32, 0, sizeof(tb_zip_lz4_xxh32_t));
+    xxh32->v[0] = TB_ZIP_LZ4_XXH32_P1 + TB_ZIP_LZ4_XXH32_P2;
+    xxh32->v[1] = TB_ZIP_LZ4_XXH32_P2;
+    xxh32->v[2] = 0;
+    xxh32->v[3] = 0 - TB_ZIP_LZ4_XXH32_P1;
+}
+static tb_void_t tb_zip_lz4_xxh32_spak(tb_zip_lz4_xxh32_t* xxh32, tb_byte_t const* data, tb_size_t size)
+{
+    // update the total size
+    xxh32->total += (tb_uint32_t)size;
+    if (size >= 16 || xxh32->total >= 16) xxh32->large = tb_true;
+
+    // cache it if the data is too small
+    if (xxh32->mem_size + size < 16)
+    {
+        if (size) tb_memcpy(xxh32->mem + xxh32->mem_size, data, size);
+        xxh32->mem_size += size;
+        return ;
+    }
+
+    // done the left data first
+    tb_byte_t const* p = data;
+    tb_byte_t const* e = data + size;
+    if (xxh32->mem_size)
+    {
+        tb_size_t fill = 16 - xxh32->mem_size;
+        tb_memcpy(xxh32->mem + xxh32->mem_size, p, fill);
+        xxh32->v[0] = tb_zip_lz4_xxh32_round(xxh32->v[0], tb_bits_get_u32_le(xxh32->mem));
+        xxh32->v[1] = tb_zip_lz4_xxh32_round(xxh32->v[1], tb_bits_get_u32_le(xxh32->mem + 4));
+        xxh32->v[2] = tb_zip_lz4_xxh32_round(xxh32->v[2], tb_bits_get_u32_le(xxh32->mem + 8));
+        xxh32->v[3] = tb_zip_lz4_xxh32_round(xxh32->v[3], tb_bits_get_u32_le(xxh32->mem + 12));
+        xxh32->mem_size = 0;
+        p += fill;
+    }
+
+    // done the stripes
+    if (p + 16 <= e)
+    {
+        tb_uint32_t v0 = xxh32->v[0];
+        tb_uint32_t v1 = xxh32->v[1];
+        tb_uint32_t v2 = xxh32->v[2];
+        tb_uint32_t v3 = xxh32->v[3];
+        do
+        {
+            v0 = tb_zip_lz4_xxh32_round(v0, tb_bits_get_u32_le(p));
+            v1 = tb_zip_lz4_xxh32_round(v1, tb_bits_get_u32_le(p + 4));
+            v2 = tb_zip_lz4_xxh32_round(v2, tb_bits_get_u32_le(p + 8));
+            v3 = tb_zip_lz4_xxh32_round(v3, tb_bits_get_u32_le(p + 12));
+            p += 16;
+
+        } while (p + 16 <= e);
+        xxh32->v[0] = v0;
+        xxh32->v[1] = v1;
+        xxh32->v[2] = v2;
+        xxh32->v[3] = v3;
+    }
+
+    // cache the left data
+    if (p < e)
+    {
+        xxh32->mem_size = e - p;
+        tb_memcpy(xxh32->mem, p, xxh32->mem_size);
+    }
+}
+static tb_uint32_t tb_zip_lz4_xxh32_done(tb_zip_lz4_xxh32_t* xxh32)
+{
+    // merge the accumulators
+    tb_uint32_t h = 0;
+    if (xxh32->large)
+    {
+        h = tb_zip_lz4_xxh32_rotl(xxh32->v[0], 1) + tb_zip_lz4_xxh32_rotl(xxh32->v[1], 7)
+        +   tb_zip_lz4_xxh32_rotl(xxh32->v[2], 12) + tb_zip_lz4_xxh32_rotl(xxh32->v[3], 18);
+    }
+    else h = xxh32->v[2] + TB_ZIP_LZ4_XXH32_P5;
+    h += xxh32->total;
+
+    // done the left data
+    tb_byte_t const* p = xxh32->mem;
+    tb_byte_t const* e = xxh32->mem + xxh32->mem_size;
+    for (; p + 4 <= e; p += 4)
+    {
+        h += tb_bits_get_u32_le(p) * TB_ZIP_LZ4_XXH32_P3;
+        h  = tb_zip_lz4_xxh32_rotl(h, 17) * TB_ZIP_LZ4_XXH32_P4;
+    }
+    for (; p < e; p++)
+    {
+        h += (*p) * TB_ZIP_LZ4_XXH32_P5;
+        h  = tb_zip_lz4_xxh32_rotl(h, 11) * TB_ZIP_LZ4_XXH32_P1;
+    }
+
+    // avalanche
+    h ^= h >> 15;
+    h *= TB_ZIP_LZ4_XXH32_P2;
+    h ^= h >> 13;
+    h *= TB_ZIP_LZ4_XXH32_P3;
+    h ^= h >> 16;
+    return h;
+}
+static tb_uint32_t tb_zip_lz4_xxh32(tb_byte_t const* data, tb_size_t size)
+{
+    tb_zip_lz4_xxh32_t xxh32;
+    tb_zip_lz4_xxh32_init(&xxh32);
+    tb_zip_lz4_xxh32_spak(&xxh32, data, size);
+    return tb_zip_lz4_xxh32_done(&xxh32);
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * block
+ */
+static __tb_inline__ tb_size_t tb_zip_lz4_hash(tb_byte_t const* p, tb_size_t bits)
+{
+    return (tb_size_t)((tb_bits_get_u32_le(p) * TB_ZIP_LZ4_XXH32_P1) >> (32 - bits));
+}
+static __tb_inline__ tb_size_t tb_zip_lz4_count(tb_byte_t const* p, tb_byte_t const* ref, tb_byte_t const* e)
+{
+    // compare 8 bytes at once
+    tb_byte_t const* b = p;
+    while (p + 8 <= e)
+    {
+        tb_uint64_t diff = tb_bits_get_u64_ne(p) ^ tb_bits_get_u64_ne(ref);
+        if (diff)
+        {
+#ifdef TB_WORDS_BIGENDIAN
+            return (p - b) + (tb_bits_cl0_u64_be(diff) >> 3);
+#else
+            return (p - b) + (tb_bits_cl0_u64_le(diff) >> 3);
+#endif
+        }
+        p += 8;
+        ref += 8;
+    }
+
+    // compare the left bytes
+    while (p < e && *p == *ref) p++, ref++;
+    return p - b;
+}
+static __tb_inline__ tb_byte_t* tb_zip_lz4_put_length(tb_byte_t* op, tb_size_t size)
+{
+    for (; size >= 255; size -= 255) *op++ = 255;
+    *op++ = (tb_byte_t)size;
+    return op;
+}
+static __tb_inline__ tb_byte_t* tb_zip_lz4_put_sequence(tb_byte_t* op, tb_byte_t const* literals, tb_size_t size, tb_size_t offset, tb_size_t match)
+{
+    // put the token and the literals length
+    tb_byte_t* token = op++;
+    if (size >= 15)
+    {
+        *token = 15 << 4;
+        op = tb_zip_lz4_put_length(op, size - 15);
+    }
+    else *token = (tb_byte_t)(size << 4);
+
+    // put the literals
+    if (size) tb_memcpy(op, literals, size);
+    op += size;
+
+    // the last literals? no match
+    tb_check_return_val(match, op);
+
+    // put the offset
+    tb_bits_set_u16_le(op, (tb_uint16_t)offset);
+    op += 2;
+
+    // put the match length
+    match -= TB_ZIP_LZ4_MINMATCH;
+    if (match >= 15)
+    {
+        *token |= 15;
+        op = tb_zip_lz4_put_length(op, match - 15);
+    }
+    else *token |= (tb_byte_t)match;
+    return op;
+}
+/* compress block with the single probe hash table, like the lz4 fast compressor
+ *
+ * the output must be large enough: TB_ZIP_LZ4_BLOCK_BOUND(size)
+ */
+static tb_size_t tb_zip_lz4_block_deflate_fast(tb_zip_lz4_t* lz4, tb_byte_t const* data, tb_size_t size, tb_byte_t* odata)
+{
+    // init
+    tb_byte_t const*    ip = data;
+    tb_byte_t const*    ie = data + size;
+    tb_byte_t const*    anchor = data;
+    tb_byte_t*          op = odata;
+    tb_uint32_t*        table = lz4->table;
+
+    // too small? only literals
+    if (size > TB_ZIP_LZ4_MFLIMIT)
+    {
+        // init the hash table
+        tb_memset(table, 0, sizeof(tb_uint32_t) << TB_ZIP_LZ4_HASH_BITS);
+
+        // the limits
+        tb_byte_t const* mflimit    = ie - TB_ZIP_LZ4_MFLIMIT;
+        tb_byte_t const* matchlimit = ie - TB_ZIP_LZ4_LASTLITERALS;
+
+        // done
+        table[tb_zip_lz4_hash(ip, TB_ZIP_LZ4_HASH_BITS)] = 0;
+        ip++;
+        while (1)
+        {
+            // find a match, skip faster if no match has been found for a long time
+            tb_byte_t const*    ref = tb_null;
+            tb_byte_t const*    next = ip;
+            tb_size_t           step = 1;
+            tb_size_t           search = 1 << 6;
+            do
+            {
+                tb_size_t hash = tb_zip_lz4_hash(next, TB_ZIP_LZ4_HASH_BITS);
+                ip      = next;
+                next   += step;
+                step    = search++ >> 6;
+                if (next > mflimit) goto last;
+
+                ref = data + table[hash];
+                table[hash] = (tb_uint32_t)(ip - data);
+
+            } while (ref + TB_ZIP_LZ4_DISTANCE_MAXN < ip || tb_bits_get_u32_ne(ref) != tb_bits_get_u32_ne(ip));
+
+            // extend the match backward
+            while (ip > anchor && ref > data && ip[-1] == ref[-1]) ip--, ref--;
+
+            // put the sequence
+            tb_size_t match = TB_ZIP_LZ4_MINMATCH + tb_zip_lz4_count(ip + TB_ZIP_LZ4_MINMATCH, ref + TB_ZIP_LZ4_MINMATCH, matchlimit);
+            op = tb_zip_lz4_put_sequence(op, anchor, ip - anchor, ip - ref, match);
+
+            // next
+            ip += match;
+            anchor = ip;
+            if (ip > mflimit) break;
+
+            // fill the hash table for the skipped position
+            table[tb_zip_lz4_hash(ip - 2, TB_ZIP_LZ4_HASH_BITS)] = (tb_uint32_t)(ip - 2 - data);
+        }
+    }
+
+last:
+    // put the last literals
+    op = tb_zip_lz4_put_sequence(op, anchor, ie - anchor, 0, 0);
+    return op - odata;
+}
+static __tb_inline__ tb_void_t tb_zip_lz4_hc_insert(tb_zip_lz4_t* lz4, tb_byte_t const* data, tb_size_t pos)
+{
+    // the previous position with the same hash, it is stored as pos + 1 and zero is none
+    tb_size_t   hash = tb_zip_lz4_hash(data + pos, TB_ZIP_LZ4_HC_HASH_BITS);
+    tb_size_t   prev = lz4->table[hash];
+    tb_size_t   delta = prev? pos + 1 - prev : 0;
+
+    // link it
+    lz4->chain[pos & 0xffff] = (tb_uint16_t)(delta <= TB_ZIP_LZ4_DISTANCE_MAXN? delta : 0);
+    lz4->table[hash] = (tb_uint32_t)(pos + 1);
+}
+static __tb_inline__ tb_size_t tb_zip_lz4_hc_find(tb_zip_lz4_t* lz4, tb_byte_t const* data, tb_byte_t const* ip, tb_byte_t const* matchlimit, tb_size_t* pinsert, tb_byte_t const** pref)
+{
+    // insert all positions before it
+    tb_size_t pos = ip - data;
+    while (*pinsert < pos) tb_zip_lz4_hc_insert(lz4, data, (*pinsert)++);
+
+    // find the longest match in the hash chain
+    tb_size_t   best = 0;
+    tb_size_t   attempts = TB_ZIP_LZ4_HC_ATTEMPTS;
+    tb_size_t   limit = matchlimit - ip;
+    tb_size_t   cand = lz4->table[tb_zip_lz4_hash(ip, TB_ZIP_LZ4_HC_HASH_BITS)];
+    if (cand && pos + 1 - cand <= TB_ZIP_LZ4_DISTANCE_MAXN)
+    {
+        cand--;
+        while (attempts--)
+        {
+            // check the byte after the best match first
+            tb_byte_t const* ref = data + cand;
+            if (ref[best] == ip[best] && tb_bits_get_u32_ne(ref) == tb_bits_get_u32_ne(ip))
+            {
+                tb_size_t size = TB_ZIP_LZ4_MINMATCH + tb_zip_lz4_count(ip + TB_ZIP_LZ4_MINMATCH, ref + TB_ZIP_LZ4_MINMATCH, matchlimit);
+                if (size > best)
+                {
+                    best = size;
+                    *pref = ref;
+                    if (size == limit) break;
+                }
+            }
+
+            // the next candidate
+            tb_size_t delta = lz4->chain[cand & 0xffff];
+            if (!delta || delta > cand || pos - (cand - delta) > TB_ZIP_LZ4_DISTANCE_MAXN) break;
+            cand -= delta;
+        }
+    }
+    return best;
+}
+/* compress block with the hash chain and the lazy matching
+ *
+ * the output must be large enough: TB_ZIP_LZ4_BLOCK_BOUND(size)
+ */
+static tb_size_t tb_zip_lz4_block_deflate_high(tb_zip_lz4_t* lz4, tb_byte_t const* data, tb_size_t size, tb_byte_t* odata)
+{
+    // init
+    tb_byte_t const*    ip = data;
+    tb_byte_t const*    ie = data + size;
+    tb_byte_t const*    anchor = data;
+    tb_byte_t*          op = odata;
+
+    // too small? only literals
+    if (size > TB_ZIP_LZ4_MFLIMIT)
+    {
+        // init the hash chain heads
+        tb_memset(lz4->table, 0, sizeof(tb_uint32_t) << TB_ZIP_LZ4_HC_HASH_BITS);
+
+        // the limits
+        tb_byte_t const* mflimit    = ie - TB_ZIP_LZ4_MFLIMIT;
+        tb_byte_t const* matchlimit = ie - TB_ZIP_LZ4_LASTLITERALS;
+
+        // done
+        tb_size_t insert = 0;
+        while (ip <= mflimit)
+        {
+            // find the longest match
+            tb_byte_t const*    ref = tb_null;
+            tb_size_t           match = tb_zip_lz4_hc_find(lz4, data, ip, matchlimit, &insert, &ref);
+            if (match < TB_ZIP_LZ4_MINMATCH)
+            {
+                ip++;
+                continue;
+            }
+
+            // lazy matching, use the next position if it has the longer match
+            while (ip + 1 <= mflimit)
+            {
+                tb_byte_t const*    ref2 = tb_null;
+                tb_size_t           match2 = tb_zip_lz4_hc_find(lz4, data, ip + 1, matchlimit, &insert, &ref2);
+                if (match2 <= match) break;
+                ip++;
+                ref = ref2;
+                match = match2;
+            }
+
+            // put the sequence
+            op = tb_zip_lz4_put_sequence(op, anchor, ip - anchor, ip - ref, match);
+            ip += match;
+            anchor = ip;
+        }
+    }
+
+    // put the last literals
+    op = tb_zip_lz4_put_sequence(op, anchor, ie - anchor, 0, 0);
+    return op - odata;
+}
+/* decompress block
+ *
+ * @param data      the block data
+ * @param size      the block size
+ * @param low       the lowest position of the match reference, the history data of the linked blocks is before odata
+ * @param odata     the output data
+ * @param omaxn     the output maxn
+ *
+ * @return          the output size, -1: failed
+ */
+static tb_long_t tb_zip_lz4_block_inflate(tb_byte_t const* data, tb_size_t size, tb_byte_t const* low, tb_byte_t* odata, tb_size_t omaxn)
+{
+    // init
+    tb_byte_t const*    ip = data;
+    tb_byte_t const*    ie = data + size;
+    tb_byte_t*          op = odata;
+    tb_byte_t*          oe = odata + omaxn;
+    while (ip < ie)
+    {
+        // get the literals length
+        tb_size_t token = *ip++;
+        tb_size_t count = token >> 4;
+        if (count == 15)
+        {
+            tb_size_t n = 0;
+            do
+            {
+                tb_check_return_val(ip < ie, -1);
+                n = *ip++;
+                count += n;
+
+            } while (n == 255);
+        }
+
+        // copy the literals
+        tb_check_return_val(count <= (tb_size_t)(ie - ip) && count <= (tb_size_t)(oe - op), -1);
+        if (count) tb_memcpy(op, ip, count);
+        ip += count;
+        op += count;
+
+        // end? the last sequence has only literals
+        if (ip == ie) break;
+
+        // get the offset
+        tb_check_return_val(ie - ip >= 2, -1);
+        tb_size_t offset = tb_bits_get_u16_le(ip);
+        ip += 2;
+        tb_check_return_val(offset && offset <= (tb_size_t)(op - low), -1);
+
+        // get the match length
+        count = token & 15;
+        if (count == 15)
+        {
+            tb_size_t n = 0;
+            do
+            {
+                tb_check_return_val(ip < ie, -1);
+                n = *ip++;
+                count += n;
+
+            } while (n == 255);
+        }
+        count += TB_ZIP_LZ4_MINMATCH;
+        tb_check_return_val(count <= (tb_size_t)(oe - op), -1);
+
+        // copy the match, copy 8 bytes at once if it does not overlap the output
+        tb_byte_t const* ref = op - offset;
+        if (offset >= 8 && count + 8 <= (tb_size_t)(oe - op))
+        {
+            tb_byte_t* e = op + count;
+            do
+            {
+                tb_bits_set_u64_ne(op, tb_bits_get_u64_ne(ref));
+                op += 8;
+                ref += 8;
+
+            } while (op < e);
+            op = e;
+        }
+        else
+        {
+            while (count--) *op++ = *ref++;
+        }
+    }
+
+    // ok
+    return op - odata;
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+static __tb_inline__ tb_zip_lz4_t* tb_zip_lz4_cast(tb_zip_ref_t zip)
+{
+    // check
+    tb_assert_and_check_return_val(zip && (zip->algo == TB_ZIP_ALGO_LZ4 || zip->algo == TB_ZIP_ALGO_LZ4HC), tb_null);
+
+    // cast it
+    return (tb_zip_lz4_t*)zip;
+}
+static tb_void_t tb_zip_lz4_drain(tb_zip_lz4_t* lz4, tb_byte_t* obase, tb_static_stream_ref_t ost)
+{
+    // write the left output data
+    tb_size_t size = tb_min(lz4->osize - lz4->opos, (tb_size_t)(ost->e - ost->p));
+    if (size)
+    {
+        tb_memcpy(ost->p, obase + lz4->opos, size);
+        lz4->opos += size;
+        ost->p += size;
+    }
+}
+static tb_size_t tb_zip_lz4_deflate_block(tb_zip_lz4_t* lz4, tb_byte_t const* data, tb_size_t size, tb_byte_t* odata)
+{
+    // update the content checksum
+    tb_zip_lz4_xxh32_spak(&lz4->xxh32, data, size);
+
+    // compress it
+    tb_size_t osize = lz4->high? tb_zip_lz4_block_deflate_high(lz4, data, size, odata + 4) : tb_zip_lz4_block_deflate_fast(lz4, data, size, odata + 4);
+
+    // store the uncompressed data if it is not smaller
+    if (osize >= size)
+    {
+        tb_memcpy(odata + 4, data, size);
+        tb_bits_set_u32_le(odata, (tb_uint32_t)size | TB_ZIP_LZ4_BLOCK_RAW);
+        osize = size;
+    }
+    else tb_bits_set_u32_le(odata, (tb_uint32_t)osize);
+
+    // trace
+    tb_trace_d("deflate: block: %lu => %lu", size, osize);
+
+    // ok
+    return osize + 4;
+}
+static tb_long_t tb_zip_lz4_spak_deflate(tb_zip_ref_t zip, tb_static_stream_ref_t ist, tb_static_stream_ref_t ost, tb_long_t sync)
+{
+    // check
+    tb_zip_lz4_t* lz4 = tb_zip_lz4_cast(zip);
+    tb_assert_and_check_return_val(lz4 && ist && ost, -1);
+
+    // the output stream
+    tb_byte_t* op = ost->p;
+    tb_byte_t* oe = ost->e;
+    tb_assert_and_check_return_val(op && oe, -1);
+
+    // done
+    while (1)
+    {
+        // write the left output data first
+        tb_zip_lz4_drain(lz4, lz4->odata, ost);
+        if (lz4->opos < lz4->osize) break;
+
+        // end?
+        if (lz4->state == TB_ZIP_LZ4_STATE_END) break;
+
+        // write the magic and the frame descriptor
+        if (lz4->state == TB_ZIP_LZ4_STATE_MAGIC)
+        {
+            tb_byte_t* p = lz4->odata;
+            tb_bits_set_u32_le(p, TB_ZIP_LZ4_MAGIC);
+            p[4] = lz4->flags;
+            p[5] = 4 << 4;
+            p[6] = (tb_byte_t)(tb_zip_lz4_xxh32(p + 4, 2) >> 8);
+            lz4->opos   = 0;
+            lz4->osize  = 7;
+            lz4->state  = TB_ZIP_LZ4_STATE_BLOCK_DATA;
+            continue;
+        }
+
+        // write the end mark and the content checksum
+        if (lz4->state == TB_ZIP_LZ4_STATE_CHECKSUM)
+        {
+            tb_bits_set_u32_le(lz4->odata, 0);
+            tb_bits_set_u32_le(lz4->odata + 4, tb_zip_lz4_xxh32_done(&lz4->xxh32));
+            lz4->opos   = 0;
+            lz4->osize  = 8;
+            lz4->state  = TB_ZIP_LZ4_STATE_END;
+            continue;
+        }
+
+        // compress the input data directly if it is enough for the whole block
+        tb_size_t left = tb_static_stream_left(ist);
+        if (!lz4->isize && left >= lz4->block_maxn)
+        {
+            // compress it to the output stream directly if the space is enough
+            tb_size_t oleft = oe - ost->p;
+            if (oleft >= lz4->omaxn) ost->p += tb_zip_lz4_deflate_block(lz4, ist->p, lz4->block_maxn, ost->p);
+            else
+            {
+                lz4->opos   = 0;
+                lz4->osize  = tb_zip_lz4_deflate_block(lz4, ist->p, lz4->block_maxn, lz4->odata);
+            }
+            ist->p += lz4->block_maxn;
+            continue;
+        }
+
+        // cache the input data
+        if (left)
+        {
+            tb_size_t size = tb_min(left, lz4->block_maxn - lz4->isize);
+            tb_memcpy(lz4->idata + lz4->isize, ist->p, size);
+            lz4->isize += size;
+            ist->p += size;
+            left -= size;
+        }
+
+        // compress the cached block if it is full, or flush or finish it
+        if (lz4->isize == lz4->block_maxn || (!left && sync && lz4->isize))
+        {
+            lz4->opos   = 0;
+            lz4->osize  = tb_zip_lz4_deflate_block(lz4, lz4->idata, lz4->isize, lz4->odata);
+            lz4->isize  = 0;
+            continue;
+        }
+
+        // finish it?
+        if (!left && sync < 0)
+        {
+            lz4->state = TB_ZIP_LZ4_STATE_CHECKSUM;
+            continue;
+        }
+
+        // need more input data
+        break;
+    }
+
+    // end?
+    tb_check_return_val(lz4->state != TB_ZIP_LZ4_STATE_END || lz4->opos < lz4->osize || ost->p > op, -1);
+
+    // ok?
+    return (ost->p - op);
+}
+static tb_byte_t const* tb_zip_lz4_need(tb_zip_lz4_t* lz4, tb_static_stream_ref_t ist, tb_size_t need)
+{
+    // check
+    tb_assert_and_check_return_val(need <= lz4->imaxn, tb_null);
+
+    // get the input data directly if it is enough
+    tb_size_t left = tb_static_stream_left(ist);
+    if (!lz4->isize && left >= need)
+    {
+        tb_byte_t const* data = ist->p;
+        ist->p += need;
+        return data;
+    }
+
+    // cache the input data
+    tb_size_t size = tb_min(left, need - lz4->isize);
+    if (size)
+    {
+        tb_memcpy(lz4->idata + lz4->isize, ist->p, size);
+        lz4->isize += size;
+        ist->p += size;
+    }
+
+    // enough?
+    tb_check_return_val(lz4->isize == need, tb_null);
+    lz4->isize = 0;
+    return lz4->idata;
+}
+static tb_bool_t tb_zip_lz4_inflate_header(tb_zip_lz4_t* lz4, tb_byte_t const* data, tb_size_t size)
+{
+    // check the version and the checksum of the descriptor
+    tb_byte_t flags = data[0];
+    tb_assert_and_check_return_val((flags & 0xc0) == TB_ZIP_LZ4_FLAG_VERSION, tb_false);
+    tb_assert_and_check_return_val(data[size - 1] == (tb_byte_t)(tb_zip_lz4_xxh32(data, size - 1) >> 8), tb_false);
+
+    // the block maxn: 64K, 256K, 1M, 4M
+    tb_size_t bsize = (data[1] >> 4) & 0x7;
+    tb_assert_and_check_return_val(bsize >= 4, tb_false);
+    tb_size_t block_maxn = (tb_size_t)1 << (bsize * 2 + 8);
+
+    // grow the buffers for the larger block
+    if (block_maxn > lz4->block_maxn)
+    {
+        lz4->imaxn = block_maxn + 4;
+        lz4->idata = (tb_byte_t*)tb_ralloc(lz4->idata, lz4->imaxn);
+        tb_assert_and_check_return_val(lz4->idata, tb_false);
+
+        lz4->omaxn = block_maxn;
+        lz4->odata = (tb_byte_t*)tb_ralloc(lz4->odata, TB_ZIP_LZ4_HISTORY + lz4->omaxn);
+        tb_assert_and_check_return_val(lz4->odata, tb_false);
+    }
+
+    // init the frame
+    lz4->flags      = flags;
+    lz4->block_maxn = block_maxn;
+    lz4->hsize      = 0;
+    tb_zip_lz4_xxh32_init(&lz4->xxh32);
+    return tb_true;
+}
+static tb_long_t tb_zip_lz4_spak_inflate(tb_zip_ref_t zip, tb_static_stream_ref_t ist, tb_static_stream_ref_t ost, tb_long_t sync)
+{
+    // check
+    tb_zip_lz4_t* lz4 = tb_zip_lz4_cast(zip);
+    tb_assert_and_check_return_val(lz4 && ist && ost, -1);
+
+    // the output stream
+    tb_byte_t* op = ost->p;
+    tb_byte_t* oe = ost->e;
+    tb_assert_and_check_return_val(op && oe, -1);
+
+    // done
+    tb_bool_t failed = tb_false;
+    while (!failed)
+    {
+        /* the output data, the history data of the linked blocks is stored before it,
+         * we need get it for each block, because the output buffer may be reallocated after parsing the frame header
+         */
+        tb_byte_t* obase = lz4->odata + TB_ZIP_LZ4_HISTORY;
+
+        // write the left output data first
+        tb_zip_lz4_drain(lz4, obase, ost);
+        if (lz4->opos < lz4->osize) break;
+
+        // end?
+        if (lz4->state == TB_ZIP_LZ4_STATE_END) break;
+
+        // need input data
+        tb_check_break(ist->p && ist->p < ist->e);
+        switch (lz4->state)
+        {
+        case TB_ZIP_LZ4_STATE_MAGIC:
+            {
+                // get the magic and the flags
+                tb_byte_t const* data = tb_zip_lz4_need(lz4, ist, 6);
+                tb_check_break(data);
+
+                // skippable frame? skip it
+                tb_uint32_t magic = tb_bits_get_u32_le(data);
+                if ((magic & 0xfffffff0) == TB_ZIP_LZ4_MAGIC_SKIP)
+                {
+                    lz4->skip = (tb_size_t)tb_bits_get_u16_le(data + 4);
+                    lz4->ineed = 2;
+                    lz4->state = TB_ZIP_LZ4_STATE_SKIP;
+                    break;
+                }
+
+                // check the magic
+                if (magic != TB_ZIP_LZ4_MAGIC)
+                {
+                    tb_trace_e("invalid magic: %x", magic);
+                    failed = tb_true;
+                    break;
+                }
+
+                // the header size: flags, block size, content size, dictionary id and checksum
+                lz4->ineed  = 3 + ((data[4] & TB_ZIP_LZ4_FLAG_CONTENT_SIZE)? 8 : 0) + ((data[4] & TB_ZIP_LZ4_FLAG_DICTID)? 4 : 0);
+                lz4->idata[0] = data[4];
+                lz4->idata[1] = data[5];
+                lz4->isize  = 2;
+                lz4->state  = TB_ZIP_LZ4_STATE_HEADER;
+            }
+            break;
+        case TB_ZIP_LZ4_STATE_HEADER:
+            {
+                // get the frame descriptor
+                tb_byte_t const* data = tb_zip_lz4_need(lz4, ist, lz4->ineed);
+                tb_check_break(data);
+
+                // the preset dictionary is not supported
+                if (data[0] & TB_ZIP_LZ4_FLAG_DICTID)
+                {
+                    tb_trace_e("the dictionary is not supported!");
+                    failed = tb_true;
+                    break;
+                }
+
+                // init the frame
+                if (!tb_zip_lz4_inflate_header(lz4, data, lz4->ineed))
+                {
+                    failed = tb_true;
+                    break;
+                }
+                lz4->state = TB_ZIP_LZ4_STATE_BLOCK_SIZE;
+            }
+            break;
+        case TB_ZIP_LZ4_STATE_SKIP:
+            {
+                // get the high 16 bits of the skipped size first
+                if (lz4->ineed)
+                {
+                    tb_byte_t const* data = tb_zip_lz4_need(lz4, ist, lz4->ineed);
+                    tb_check_break(data);
+                    lz4->skip |= (tb_size_t)tb_bits_get_u16_le(data) << 16;
+                    lz4->ineed = 0;
+                }
+
+                // skip data
+                tb_size_t size = tb_min(lz4->skip, tb_static_stream_left(ist));
+                ist->p += size;
+                lz4->skip -= size;
+                if (!lz4->skip) lz4->state = TB_ZIP_LZ4_STATE_MAGIC;
+            }
+            break;
+        case TB_ZIP_LZ4_STATE_BLOCK_SIZE:
+            {
+                // get the block size
+                tb_byte_t const* data = tb_zip_lz4_need(lz4, ist, 4);
+                tb_check_break(data);
+
+                // the end mark?
+                tb_uint32_t size = tb_bits_get_u32_le(data);
+                if (!size)
+                {
+                    if (lz4->flags & TB_ZIP_LZ4_FLAG_CONTENT_CHECKSUM) lz4->state = TB_ZIP_LZ4_STATE_CHECKSUM;
+                    else lz4->state = TB_ZIP_LZ4_STATE_END;
+                    break;
+                }
+
+                // check the block size
+                lz4->ineed = size;
+                if ((lz4->ineed & ~TB_ZIP_LZ4_BLOCK_RAW) > lz4->block_maxn)
+                {
+                    tb_trace_e("invalid block size: %x", size);
+                    failed = tb_true;
+                    break;
+                }
+                lz4->state = TB_ZIP_LZ4_STATE_BLOCK_DATA;
+            }
+            break;
+        case TB_ZIP_LZ4_STATE_BLOCK_DATA:
+            {
+                // get the block data and checksum
+                tb_bool_t   raw = (lz4->ineed & TB_ZIP_LZ4_BLOCK_RAW)? tb_true : tb_false;
+                tb_size_t   size = lz4->ineed & ~TB_ZIP_LZ4_BLOCK_RAW;
+                tb_size_t   need = size + ((lz4->flags & TB_ZIP_LZ4_FLAG_BLOCK_CHECKSUM)? 4 : 0);
+                tb_byte_t const* data = tb_zip_lz4_need(lz4, ist, need);
+                tb_check_break(data);
+
+                // check the block checksum
+                if ((lz4->flags & TB_ZIP_LZ4_FLAG_BLOCK_CHECKSUM) && tb_bits_get_u32_le(data + size) != tb_zip_lz4_xxh32(data, size))
+                {
+                    tb_trace_e("invalid block checksum!");
+                    failed = tb_true;
+                    break;
+                }
+
+                // decompress it to the output stream directly if the blocks are independent and the space is enough
+                tb_bool_t   linked = (lz4->flags & TB_ZIP_LZ4_FLAG_BLOCK_INDEP)? tb_false : tb_true;
+                tb_byte_t*  odata = (!linked && (tb_size_t)(oe - ost->p) >= lz4->block_maxn)? ost->p : obase;
+                tb_long_t   osize = size;
+                if (raw) tb_memcpy(odata, data, size);
+                else osize = tb_zip_lz4_block_inflate(data, size, odata - (linked? lz4->hsize : 0), odata, lz4->block_maxn);
+                if (osize < 0)
+                {
+                    tb_trace_e("invalid block data!");
+                    failed = tb_true;
+                    break;
+                }
+
+                // trace
+                tb_trace_d("inflate: block: %lu => %ld, raw: %d, linked: %d", size, osize, raw, linked);
+
+                // update the content checksum
+                if (lz4->flags & TB_ZIP_LZ4_FLAG_CONTENT_CHECKSUM)
+                    tb_zip_lz4_xxh32_spak(&lz4->xxh32, odata, osize);
+
+                // write it
+                if (odata == ost->p) ost->p += osize;
+                else
+                {
+                    lz4->opos   = 0;
+                    lz4->osize  = osize;
+                }
+
+                // save the last 64K output data as the history data of the next block
+                if (linked)
+                {
+                    tb_size_t hsize = tb_min(lz4->hsize + osize, TB_ZIP_LZ4_HISTORY);
+                    tb_memmov(obase - hsize, obase + osize - hsize, hsize);
+                    lz4->hsize = hsize;
+                }
+                lz4->state = TB_ZIP_LZ4_STATE_BLOCK_SIZE;
+            }
+            break;
+        case TB_ZIP_LZ4_STATE_CHECKSUM:
+            {
+                // check the content checksum
+                tb_byte_t const* data = tb_zip_lz4_need(lz4, ist, 4);
+                tb_check_break(data);
+                if (tb_bits_get_u32_le(data) != tb_zip_lz4_xxh32_done(&lz4->xxh32))
+                {
+                    tb_trace_e("invalid content checksum!");
+                    failed = tb_true;
+                    break;
+                }
+                lz4->state = TB_ZIP_LZ4_STATE_END;
+            }
+            break;
+        default:
+            failed = tb_true;
+            break;
+        }
+
+        // need more input data?
+        if (!failed && ist->p == ist->e && lz4->opos == lz4->osize && lz4->state != TB_ZIP_LZ4_STATE_END) break;
+    }
+
+    // failed?
+    tb_assert_and_check_return_val(!failed, -1);
+
+    // end?
+    tb_check_return_val(lz4->state != TB_ZIP_LZ4_STATE_END || lz4->opos < lz4->osize || ost->p > op, -1);
+
+    // ok?
+    return (ost->p - op);
+}
+static tb_zip_ref_t tb_zip_lz4_init_impl(tb_size_t action, tb_bool_t high)
+{
+    // done
+    tb_bool_t       ok = tb_false;
+    tb_zip_lz4_t*   zip = tb_null;
+    do
+    {
+        // make zip
+        zip = tb_malloc0_type(tb_zip_lz4_t);
+        tb_assert_and_check_break(zip);
+
+        // init algo
+        zip->base.algo  = high? TB_ZIP_ALGO_LZ4HC : TB_ZIP_ALGO_LZ4;
+        zip->high       = high;
+        zip->state      = TB_ZIP_LZ4_STATE_MAGIC;
+        zip->block_maxn = TB_ZIP_LZ4_BLOCK_MAXN;
+
+        // init the content checksum
+        tb_zip_lz4_xxh32_init(&zip->xxh32);
+
+        // init spak
+        if (action == TB_ZIP_ACTION_INFLATE)
+        {
+            // make the input data for the block and the output data with the history data
+            zip->base.spak  = tb_zip_lz4_spak_inflate;
+            zip->imaxn      = zip->block_maxn + 4;
+            zip->omaxn      = zip->block_maxn;
+            zip->idata      = tb_malloc_bytes(zip->imaxn);
+            zip->odata      = tb_malloc_bytes(TB_ZIP_LZ4_HISTORY + zip->omaxn);
+            tb_assert_and_check_break(zip->idata && zip->odata);
+        }
+        else if (action == TB_ZIP_ACTION_DEFLATE)
+        {
+            // make the input data for the block and the output data with the block size
+            zip->base.spak  = tb_zip_lz4_spak_deflate;
+            zip->flags      = TB_ZIP_LZ4_FLAG_VERSION | TB_ZIP_LZ4_FLAG_BLOCK_INDEP | TB_ZIP_LZ4_FLAG_CONTENT_CHECKSUM;
+            zip->imaxn      = zip->block_maxn;
+            zip->omaxn      = TB_ZIP_LZ4_BLOCK_BOUND(zip->block_maxn) + 4;
+            zip->idata      = tb_malloc_bytes(zip->imaxn);
+            zip->odata      = tb_malloc_bytes(zip->omaxn);
+            tb_assert_and_check_break(zip->idata && zip->odata);
+
+            // make the hash table or the hash chain
+            if (high)
+            {
+                zip->table = tb_nalloc_type(1 << TB_ZIP_LZ4_HC_HASH_BITS, tb_uint32_t);
+                zip->chain = tb_nalloc_type(TB_ZIP_LZ4_HISTORY, tb_uint16_t);
+                tb_assert_and_check_break(zip->table && zip->chain);
+            }
+            else
+            {
+                zip->table = tb_nalloc_type(1 << TB_ZIP_LZ4_HASH_BITS, tb_uint32_t);
+                tb_assert_and_check_break(zip->table);
+            }
+        }
+        else break;
+
+        // init action
+        zip->base.action = (tb_uint16_t)action;
+
+        // ok
+        ok = tb_true;
+
+    } while (0);
+
+    // failed?
+    if (!ok)
+    {
+        // exit it
+        if (zip) tb_zip_lz4_exit((tb_zip_ref_t)zip);
+        zip = tb_null;
+    }
+
+    // ok?
+    return (tb_zip_ref_t)zip;
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+tb_zip_ref_t tb_zip_lz4_init(tb_size_t action)
+{
+    return tb_zip_lz4_init_impl(action, tb_false);
+}
+tb_zip_ref_t tb_zip_lz4hc_init(tb_size_t action)
+{
+    return tb_zip_lz4_init_impl(action, tb_true);
+}
+tb_void_t tb_zip_lz4_exit(tb_zip_ref_t zip)
+{
+    // check
+    tb_zip_lz4_t* lz4 = tb_zip_lz4_cast(zip);
+    tb_assert_and_check_return(lz4);
+
+    // exit data
+    if (lz4->idata) tb_free(lz4->idata);
+    if (lz4->odata) tb_free(lz4->odata);
+    if (lz4->table) tb_free(lz4->table);
+    if (lz4->chain) tb_free(lz4->chain);
+
+    // free it
+    tb_free(lz4);
+}
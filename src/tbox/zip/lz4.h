@@ -0,0 +1,154 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        lz4.h
+ * @ingroup     zip
+ *
+ */
+#ifndef TB_ZIP_LZ4_H
+#define TB_ZIP_LZ4_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the lz4 xxh32 checksum type
+typedef struct __tb_zip_lz4_xxh32_t
+{
+    // the accumulators
+    tb_uint32_t     v[4];
+
+    // the total size
+    tb_uint32_t     total;
+
+    // is large? total >= 16
+    tb_bool_t       large;
+
+    // the left data
+    tb_byte_t       mem[16];
+
+    // the left size
+    tb_size_t       mem_size;
+
+}tb_zip_lz4_xxh32_t;
+
+/* the lz4 zip type
+ *
+ * the data is stored in the lz4 frame format, so it can be decompressed by the lz4 tool,
+ * we only write the independent 64K blocks with the content checksum for deflating,
+ * and we can inflate the linked or independent blocks with all block sizes.
+ */
+typedef struct __tb_zip_lz4_t
+{
+    // the zip base
+    tb_zip_t                base;
+
+    // the high compression mode?
+    tb_bool_t               high;
+
+    // the frame state
+    tb_size_t               state;
+
+    // the frame flags
+    tb_byte_t               flags;
+
+    // the block maxn
+    tb_size_t               block_maxn;
+
+    // the input data for deflating the block or the block data for inflating
+    tb_byte_t*              idata;
+
+    // the input maxn
+    tb_size_t               imaxn;
+
+    // the input size
+    tb_size_t               isize;
+
+    // the input need for inflating
+    tb_size_t               ineed;
+
+    // the output data, the history data of the linked blocks is stored before it
+    tb_byte_t*              odata;
+
+    // the output maxn
+    tb_size_t               omaxn;
+
+    // the output position which has been written
+    tb_size_t               opos;
+
+    // the output size
+    tb_size_t               osize;
+
+    // the history size of the linked blocks
+    tb_size_t               hsize;
+
+    // the skipped size of the skippable frame
+    tb_size_t               skip;
+
+    // the hash table of the fast compressor or the hash chain heads of the high compressor
+    tb_uint32_t*            table;
+
+    // the hash chain of the high compressor
+    tb_uint16_t*            chain;
+
+    // the content checksum
+    tb_zip_lz4_xxh32_t      xxh32;
+
+}tb_zip_lz4_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/* init lz4
+ *
+ * @param action    the action
+ *
+ * @return          the zip
+ */
+tb_zip_ref_t        tb_zip_lz4_init(tb_size_t action);
+
+/* init lz4 with the high compression mode, it will compress slower and smaller for deflating
+ *
+ * @param action    the action
+ *
+ * @return          the zip
+ */
+tb_zip_ref_t        tb_zip_lz4hc_init(tb_size_t action);
+
+/* exit lz4
+ *
+ * @param zip       the zip
+ */
+tb_void_t           tb_zip_lz4_exit(tb_zip_ref_t zip);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
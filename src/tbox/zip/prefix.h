@@ -48,6 +48,8 @@ typedef enum __tb_zip_algo_t
 ,   TB_ZIP_ALGO_ZLIBRAW     = 1     //!< zlib: raw inflate & deflate
 ,   TB_ZIP_ALGO_ZLIB        = 2     //!< zlib
 ,   TB_ZIP_ALGO_GZIP        = 3     //!< gnu zip
+,   TB_ZIP_ALGO_LZ4         = 4     //!< lz4: the fast compression, the lz4 frame format
+,   TB_ZIP_ALGO_LZ4HC       = 5     //!< lz4: the high compression, the lz4 frame format
 
 }tb_zip_algo_t;
 
@@ -26,6 +26,7 @@
 #include "gzip.h"
 #include "zlib.h"
 #include "zlibraw.h"
+#include "lz4.h"
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * interfaces
@@ -46,6 +47,8 @@ tb_zip_ref_t tb_zip_init(tb_size_t algo, tb_size_t action)
     ,   tb_null
     ,   tb_null
 #endif
+    ,   tb_zip_lz4_init
+    ,   tb_zip_lz4hc_init
     };
     tb_assert_and_check_return_val(algo < tb_arrayn(s_init) && s_init[algo], tb_null);
 
@@ -70,6 +73,8 @@ tb_void_t tb_zip_exit(tb_zip_ref_t zip)
     ,   tb_null
     ,   tb_null
 #endif
+    ,   tb_zip_lz4_exit
+    ,   tb_zip_lz4_exit
     };
     tb_assert_and_check_return(zip->algo < tb_arrayn(s_exit) && s_exit[zip->algo]);
 
@@ -72,6 +72,15 @@ option("exception")
     set_configvar("TB_CONFIG_EXCEPTION_ENABLE", 1)
 option_end()
 
+-- option: lock-profiler
+option("lock-profiler")
+    set_default(false)
+    set_showmenu(true)
+    set_category("option")
+    set_description("Enable the lock profiler for the release mode.")
+    set_configvar("TB_CONFIG_LOCK_PROFILER_ENABLE", 1)
+option_end()
+
 -- option: deprecated
 option("deprecated")
     set_default(false)
@@ -272,13 +281,14 @@ function check_interfaces()
         check_module_cfuncs("posix", "ifaddrs.h",                        "getifaddrs")
         check_module_cfuncs("posix", "semaphore.h",                      "sem_init")
         check_module_cfuncs("posix", "unistd.h",                         "getpagesize", "sysconf")
-        check_module_cfuncs("posix", "sched.h",                          "sched_yield", "sched_setaffinity") -- need _GNU_SOURCE
+        check_module_cfuncs("posix", "sched.h",                          "sched_yield", "sched_setaffinity", "sched_getcpu") -- need _GNU_SOURCE
         check_module_cfuncs("posix", "regex.h",                          "regcomp", "regexec")
         check_module_cfuncs("posix", "sys/uio.h",                        "readv", "writev", "preadv", "pwritev")
         check_module_cfuncs("posix", "unistd.h",                         "pread64", "pwrite64")
         check_module_cfuncs("posix", "unistd.h",                         "fdatasync")
         check_module_cfuncs("posix", "copyfile.h",                       "copyfile")
         check_module_cfuncs("posix", "sys/sendfile.h",                   "sendfile")
+        check_module_cfuncs("posix", "fcntl.h",                          "splice")
         check_module_cfuncs("posix", "sys/epoll.h",                      "epoll_create", "epoll_wait")
         check_module_cfuncs("posix", "spawn.h",                          "posix_spawnp", "posix_spawn_file_actions_addchdir_np")
         check_module_cfuncs("posix", "unistd.h",                         "execvp", "execvpe", "fork", "vfork")
@@ -286,11 +296,12 @@ function check_interfaces()
         check_module_cfuncs("posix", "unistd.h",                         "getdtablesize")
         check_module_cfuncs("posix", "sys/resource.h",                   "getrlimit")
         check_module_cfuncs("posix", "netdb.h",                          "getaddrinfo", "getnameinfo", "gethostbyname", "gethostbyaddr")
-        check_module_cfuncs("posix", "fcntl.h",                          "fcntl")
+        check_module_cfuncs("posix", "fcntl.h",                          "fcntl", "posix_fadvise")
         check_module_cfuncs("posix", "unistd.h",                         "pipe", "pipe2")
         check_module_cfuncs("posix", "sys/stat.h",                       "mkfifo")
-        check_module_cfuncs("posix", "sys/mman.h",                       "mmap")
+        check_module_cfuncs("posix", "sys/mman.h",                       "mmap", "madvise", "memfd_create")
         check_module_cfuncs("posix", "sys/stat.h",                       "futimens", "utimensat")
+        check_module_cfuncs("posix", "time.h",                           "clock_gettime")
     end
 
     -- add the interfaces for windows/msvc
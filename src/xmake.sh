@@ -52,6 +52,7 @@ option "float"      "Enable or disable the float type" true
 option "info"       "Enable or disable to get some info, .e.g version .." true
 option "exception"  "Enable or disable the exception." false
 option "deprecated" "Enable or disable the deprecated interfaces." false
+option "lock_profiler" "Enable the lock profiler for the release mode." false
 option "force_utf8" "Forcely regard all tb_char* as utf-8." false
 
 option "wchar"
@@ -84,6 +85,10 @@ basic_options() {
         set_configvar "TB_CONFIG_API_HAVE_DEPRECATED" 1
     fi
 
+    if has_config "lock_profiler"; then
+        set_configvar "TB_CONFIG_LOCK_PROFILER_ENABLE" 1
+    fi
+
     if has_config "force_utf8"; then
         set_configvar "TB_CONFIG_FORCE_UTF8" 1
     fi
@@ -249,13 +254,14 @@ check_interfaces() {
     check_module_cfuncs "posix" "ifaddrs.h"                        "getifaddrs"
     check_module_cfuncs "posix" "semaphore.h"                      "sem_init"
     check_module_cfuncs "posix" "unistd.h"                         "getpagesize" "sysconf"
-    check_module_cfuncs "posix" "sched.h"                          "sched_yield" "sched_setaffinity" # need _GNU_SOURCE
+    check_module_cfuncs "posix" "sched.h"                          "sched_yield" "sched_setaffinity" "sched_getcpu" # need _GNU_SOURCE
     check_module_cfuncs "posix" "regex.h"                          "regcomp" "regexec"
     check_module_cfuncs "posix" "sys/uio.h"                        "readv" "writev" "preadv" "pwritev"
     check_module_cfuncs "posix" "unistd.h"                         "pread64" "pwrite64"
     check_module_cfuncs "posix" "unistd.h"                         "fdatasync"
     check_module_cfuncs "posix" "copyfile.h"                       "copyfile"
     check_module_cfuncs "posix" "sys/sendfile.h"                   "sendfile"
+    check_module_cfuncs "posix" "fcntl.h"                          "splice"
     check_module_cfuncs "posix" "sys/epoll.h"                      "epoll_create" "epoll_wait"
     check_module_cfuncs "posix" "spawn.h"                          "posix_spawnp" "posix_spawn_file_actions_addchdir_np"
     check_module_cfuncs "posix" "unistd.h"                         "execvp" "execvpe" "fork" "vfork"
@@ -263,11 +269,12 @@ check_interfaces() {
     check_module_cfuncs "posix" "unistd.h"                         "getdtablesize"
     check_module_cfuncs "posix" "sys/resource.h"                   "getrlimit"
     check_module_cfuncs "posix" "netdb.h"                          "getaddrinfo" "getnameinfo" "gethostbyname" "gethostbyaddr"
-    check_module_cfuncs "posix" "fcntl.h"                          "fcntl"
+    check_module_cfuncs "posix" "fcntl.h"                          "fcntl" "posix_fadvise"
     check_module_cfuncs "posix" "unistd.h"                         "pipe" "pipe2"
     check_module_cfuncs "posix" "sys/stat.h"                       "mkfifo"
-    check_module_cfuncs "posix" "sys/mman.h"                       "mmap"
+    check_module_cfuncs "posix" "sys/mman.h"                       "mmap" "madvise" "memfd_create"
     check_module_cfuncs "posix" "sys/stat.h"                       "futimens" "utimensat"
+    check_module_cfuncs "posix" "time.h"                           "clock_gettime"
 
     # add the interfaces for bsd
     check_module_cfuncs "bsd" "sys/file.h fcntl.h" "flock"